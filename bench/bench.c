@@ -0,0 +1,446 @@
+/*
+ * Benchmark suite of TinySpline. Times the core operations over a grid of
+ * degrees, dimensions, and numbers of control points and prints the results
+ * in CSV format to stdout (one line per operation and configuration, see
+ * harness.h):
+ *
+ *     operation,degree,dimension,control_points,iterations,ns_per_op,ns_mad
+ *
+ * Usage:
+ *
+ *     tinyspline_bench [min_seconds [filter [repetitions]]]
+ *
+ * min_seconds is the minimum CPU time spent per repetition (default: 0.05).
+ * If filter is given, only operations whose name contains filter are timed.
+ * ns_per_op is the median of the repetitions (default: 1).
+ */
+#include "tinyspline.h"
+#include "harness.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_KNOTS 1000 /**< Number of knots for eval_all and sample. */
+
+/**
+ * The state shared by all operations of a configuration. The inputs are set
+ * up once so that the operations time the library only.
+ */
+struct fixture {
+	size_t deg, dim, n_ctrlp;
+	tsBSpline spline;  /**< The spline to benchmark. */
+	tsBSpline other;   /**< Spline of a different degree (align). */
+	tsBSpline start;   /**< Aligned with `end` (morph). */
+	tsBSpline end;     /**< Aligned with `start` (morph). */
+	tsBSpline morph;   /**< Reused output of ts_bspline_morph. */
+	tsAlignmentPlan plan; /**< Of `spline` and `other` (align_plan). */
+	tsBSpline aligned[2]; /**< Reused outputs of align_plan. */
+	tsDeBoorNet net;   /**< Reused output of eval_deboornet. */
+	tsMonotoneIndex index; /**< Of the first component of `spline`. */
+	tsProjector projector; /**< Of `spline`. */
+	tsArcLength arc_length; /**< Of `spline`. */
+	tsReal *points;    /**< n_ctrlp points to interpolate. */
+	tsReal *midpoints; /**< Midpoints of the knot spans (refine_knots). */
+	tsReal us[NUM_KNOTS]; /**< Knots for eval_all. */
+	char *json;        /**< `spline` in JSON format. */
+	size_t iteration;  /**< Current iteration. */
+	tsStatus status;
+};
+
+typedef void (*operation)(struct fixture *);
+
+/* Aborts if an operation failed (the results would be meaningless). */
+void check(tsError err, const tsStatus *status)
+{
+	if (err) {
+		fprintf(stderr, "error: %s\n", status->message);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/* Returns a deterministic sequence of numbers in [-1, 1]. */
+tsReal noise(size_t i)
+{
+	return (tsReal) ((i * 7919) % 2001) / (tsReal) 1000.0 - 1;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* Operations                                                                  *
+*                                                                             *
+******************************************************************************/
+void op_eval(struct fixture *f)
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal u = f->us[f->iteration % NUM_KNOTS];
+	check(ts_bspline_eval(&f->spline, u, &net, &f->status), &f->status);
+	ts_deboornet_free(&net);
+}
+
+/* Unlike eval, reuses the net and, thus, times the De Boor net evaluation
+ * (ts_int_bspline_eval_woa) without allocating memory. */
+void op_eval_deboornet(struct fixture *f)
+{
+	tsReal u = f->us[f->iteration % NUM_KNOTS];
+	check(ts_bspline_eval_into(&f->spline, u, &f->net, &f->status),
+		&f->status);
+}
+
+void op_eval_derivs(struct fixture *f)
+{
+	tsReal derivs[3 * 4]; /* point, first, and second derivative */
+	tsReal u = f->us[f->iteration % NUM_KNOTS];
+	check(ts_bspline_eval_derivs(&f->spline, u, 2, derivs, &f->status),
+		&f->status);
+}
+
+void op_eval_all(struct fixture *f)
+{
+	tsReal *points = NULL;
+	check(ts_bspline_eval_all(&f->spline, f->us, NUM_KNOTS, &points,
+		&f->status), &f->status);
+	free(points);
+}
+
+void op_sample(struct fixture *f)
+{
+	tsReal *points = NULL;
+	size_t num;
+	check(ts_bspline_sample(&f->spline, NUM_KNOTS, &points, &num,
+		&f->status), &f->status);
+	free(points);
+}
+
+void op_bisect(struct fixture *f)
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	/* The first component of the control points is ascending. */
+	tsReal value = (tsReal) (f->iteration % f->n_ctrlp);
+	check(ts_bspline_bisect(&f->spline, value, (tsReal) 0.01, 0, 0, 1, 50,
+		&net, &f->status), &f->status);
+	ts_deboornet_free(&net);
+}
+
+void op_solve(struct fixture *f)
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal value = (tsReal) (f->iteration % f->n_ctrlp);
+	check(ts_bspline_solve(&f->spline, value, (tsReal) 0.01, 0, 0, 1, 50,
+		&net, &f->status), &f->status);
+	ts_deboornet_free(&net);
+}
+
+void op_monotone_index(struct fixture *f)
+{
+	tsReal u;
+	tsReal value = (tsReal) (f->iteration % f->n_ctrlp);
+	check(ts_monotone_index_solve(&f->index, value, (tsReal) 0.01, 0, 50,
+		&u, &f->status), &f->status);
+}
+
+void op_project(struct fixture *f)
+{
+	tsReal u;
+	const tsReal *point = f->points +
+		(f->iteration % f->n_ctrlp) * f->dim;
+	check(ts_projector_project(&f->projector, point, &u, NULL,
+		&f->status), &f->status);
+}
+
+void op_arc_length(struct fixture *f)
+{
+	tsReal u;
+	tsReal length = ts_arc_length_length(&f->arc_length) *
+		(tsReal) (f->iteration % NUM_KNOTS) / NUM_KNOTS;
+	check(ts_arc_length_u_at(&f->arc_length, length, &u, &f->status),
+		&f->status);
+}
+
+void op_derive(struct fixture *f)
+{
+	tsBSpline deriv = ts_bspline_init();
+	check(ts_bspline_derive(&f->spline, 1, TS_CONTROL_POINT_EPSILON,
+		&deriv, &f->status), &f->status);
+	ts_bspline_free(&deriv);
+}
+
+void op_insert_knot(struct fixture *f)
+{
+	tsBSpline result = ts_bspline_init();
+	size_t k;
+	check(ts_bspline_insert_knot(&f->spline, f->us[NUM_KNOTS / 3], 1,
+		&result, &k, &f->status), &f->status);
+	ts_bspline_free(&result);
+}
+
+void op_refine_knots(struct fixture *f)
+{
+	tsBSpline result = ts_bspline_init();
+	check(ts_bspline_refine_knots(&f->spline, f->midpoints,
+		f->n_ctrlp - f->deg, &result, &f->status), &f->status);
+	ts_bspline_free(&result);
+}
+
+void op_remove_knots(struct fixture *f)
+{
+	tsBSpline result = ts_bspline_init();
+	check(ts_bspline_remove_knots(&f->spline, TS_CONTROL_POINT_EPSILON,
+		&result, &f->status), &f->status);
+	ts_bspline_free(&result);
+}
+
+void op_to_beziers(struct fixture *f)
+{
+	tsBSpline beziers = ts_bspline_init();
+	check(ts_bspline_to_beziers(&f->spline, &beziers, &f->status),
+		&f->status);
+	ts_bspline_free(&beziers);
+}
+
+void op_elevate_degree(struct fixture *f)
+{
+	tsBSpline elevated = ts_bspline_init();
+	check(ts_bspline_elevate_degree(&f->spline, 1,
+		TS_CONTROL_POINT_EPSILON, &elevated, &f->status), &f->status);
+	ts_bspline_free(&elevated);
+}
+
+void op_align(struct fixture *f)
+{
+	tsBSpline s1 = ts_bspline_init(), s2 = ts_bspline_init();
+	check(ts_bspline_align(&f->spline, &f->other,
+		TS_CONTROL_POINT_EPSILON, &s1, &s2, &f->status), &f->status);
+	ts_bspline_free(&s1);
+	ts_bspline_free(&s2);
+}
+
+void op_align_plan(struct fixture *f)
+{
+	check(ts_alignment_plan_apply(&f->plan, &f->spline, &f->other,
+		f->aligned, f->aligned + 1, &f->status), &f->status);
+}
+
+void op_morph(struct fixture *f)
+{
+	tsReal t = (tsReal) (f->iteration % 101) / 100;
+	check(ts_bspline_morph(&f->start, &f->end, t,
+		TS_CONTROL_POINT_EPSILON, &f->morph, &f->status), &f->status);
+}
+
+void op_interpolate_cubic_natural(struct fixture *f)
+{
+	tsBSpline spline = ts_bspline_init();
+	check(ts_bspline_interpolate_cubic_natural(f->points, f->n_ctrlp,
+		f->dim, &spline, &f->status), &f->status);
+	ts_bspline_free(&spline);
+}
+
+void op_interpolate_catmull_rom(struct fixture *f)
+{
+	tsBSpline spline = ts_bspline_init();
+	check(ts_bspline_interpolate_catmull_rom(f->points, f->n_ctrlp,
+		f->dim, (tsReal) 0.5, NULL, NULL, TS_CONTROL_POINT_EPSILON,
+		&spline, &f->status), &f->status);
+	ts_bspline_free(&spline);
+}
+
+void op_save_json(struct fixture *f)
+{
+	char *json = NULL;
+	check(ts_bspline_to_json(&f->spline, &json, &f->status), &f->status);
+	free(json);
+}
+
+void op_load_json(struct fixture *f)
+{
+	tsBSpline spline = ts_bspline_init();
+	check(ts_bspline_parse_json(f->json, &spline, &f->status),
+		&f->status);
+	ts_bspline_free(&spline);
+}
+
+struct benchmark {
+	const char *name;
+	operation op;
+	int interpolation; /**< Ignores the degree (always cubic). */
+};
+
+const struct benchmark BENCHMARKS[] = {
+	{ "eval", op_eval, 0 },
+	{ "eval_deboornet", op_eval_deboornet, 0 },
+	{ "eval_derivs", op_eval_derivs, 0 },
+	{ "eval_all", op_eval_all, 0 },
+	{ "sample", op_sample, 0 },
+	{ "bisect", op_bisect, 0 },
+	{ "solve", op_solve, 0 },
+	{ "monotone_index", op_monotone_index, 0 },
+	{ "project", op_project, 0 },
+	{ "arc_length", op_arc_length, 0 },
+	{ "derive", op_derive, 0 },
+	{ "insert_knot", op_insert_knot, 0 },
+	{ "refine_knots", op_refine_knots, 0 },
+	{ "remove_knots", op_remove_knots, 0 },
+	{ "to_beziers", op_to_beziers, 0 },
+	{ "elevate_degree", op_elevate_degree, 0 },
+	{ "align", op_align, 0 },
+	{ "align_plan", op_align_plan, 0 },
+	{ "morph", op_morph, 0 },
+	{ "interpolate_cubic_natural", op_interpolate_cubic_natural, 1 },
+	{ "interpolate_catmull_rom", op_interpolate_catmull_rom, 1 },
+	{ "save_json", op_save_json, 0 },
+	{ "load_json", op_load_json, 0 }
+};
+
+
+
+/******************************************************************************
+*                                                                             *
+* Driver                                                                      *
+*                                                                             *
+******************************************************************************/
+void fixture_setup(struct fixture *f, size_t deg, size_t dim, size_t n_ctrlp)
+{
+	tsReal *ctrlp = NULL, min, max;
+	size_t i;
+	memset(f, 0, sizeof(struct fixture));
+	f->deg = deg;
+	f->dim = dim;
+	f->n_ctrlp = n_ctrlp;
+	f->spline = ts_bspline_init();
+	f->other = ts_bspline_init();
+	f->start = ts_bspline_init();
+	f->end = ts_bspline_init();
+	f->morph = ts_bspline_init();
+	f->plan = ts_alignment_plan_init();
+	f->aligned[0] = ts_bspline_init();
+	f->aligned[1] = ts_bspline_init();
+	f->net = ts_deboornet_init();
+	f->index = ts_monotone_index_init();
+	f->projector = ts_projector_init();
+	f->arc_length = ts_arc_length_init();
+
+	f->points = (tsReal *) malloc(n_ctrlp * dim * sizeof(tsReal));
+	f->midpoints = (tsReal *) malloc(n_ctrlp * sizeof(tsReal));
+	if (!f->points || !f->midpoints) {
+		fprintf(stderr, "error: out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+	for (i = 0; i < n_ctrlp * dim; i++) {
+		/* The first component is ascending (bisect, solve, and
+		 * monotone_index). */
+		f->points[i] = i % dim == 0 ? (tsReal) (i / dim) : noise(i);
+	}
+	check(ts_bspline_new(n_ctrlp, dim, deg, TS_CLAMPED, &f->spline,
+		&f->status), &f->status);
+	check(ts_bspline_set_control_points(&f->spline, f->points,
+		&f->status), &f->status);
+	check(ts_bspline_new(n_ctrlp, dim, deg > 1 ? deg - 1 : deg + 1,
+		TS_CLAMPED, &f->other, &f->status), &f->status);
+	check(ts_bspline_control_points(&f->other, &ctrlp, &f->status),
+		&f->status);
+	for (i = 0; i < n_ctrlp * dim; i++)
+		ctrlp[i] = noise(i + 1);
+	check(ts_bspline_set_control_points(&f->other, ctrlp, &f->status),
+		&f->status);
+	free(ctrlp);
+	check(ts_bspline_align(&f->spline, &f->other,
+		TS_CONTROL_POINT_EPSILON, &f->start, &f->end, &f->status),
+		&f->status);
+	check(ts_alignment_plan_new(&f->spline, &f->other,
+		TS_CONTROL_POINT_EPSILON, &f->plan, &f->status), &f->status);
+
+	check(ts_monotone_index_new(&f->spline, 0, 1, 0, &f->index,
+		&f->status), &f->status);
+	check(ts_projector_new(&f->spline, &f->projector, &f->status),
+		&f->status);
+	check(ts_arc_length_new(&f->spline, 0, &f->arc_length, &f->status),
+		&f->status);
+
+	ts_bspline_domain(&f->spline, &min, &max);
+	for (i = 0; i < n_ctrlp - deg; i++) {
+		f->midpoints[i] = min + (max - min) *
+			((tsReal) i + (tsReal) 0.5) / (n_ctrlp - deg);
+	}
+	for (i = 0; i < NUM_KNOTS; i++) {
+		f->us[i] = min + (max - min) *
+			(tsReal) ((i * 617) % NUM_KNOTS) / (NUM_KNOTS - 1);
+	}
+	check(ts_bspline_to_json(&f->spline, &f->json, &f->status),
+		&f->status);
+}
+
+void fixture_teardown(struct fixture *f)
+{
+	ts_bspline_free(&f->spline);
+	ts_bspline_free(&f->other);
+	ts_bspline_free(&f->start);
+	ts_bspline_free(&f->end);
+	ts_bspline_free(&f->morph);
+	ts_alignment_plan_free(&f->plan);
+	ts_bspline_free(&f->aligned[0]);
+	ts_bspline_free(&f->aligned[1]);
+	ts_deboornet_free(&f->net);
+	ts_monotone_index_free(&f->index);
+	ts_projector_free(&f->projector);
+	ts_arc_length_free(&f->arc_length);
+	free(f->points);
+	free(f->midpoints);
+	free(f->json);
+}
+
+/* The data passed to invoke. */
+struct invocation {
+	const struct benchmark *bench;
+	struct fixture *fixture;
+};
+
+void invoke(void *data, unsigned long iteration)
+{
+	struct invocation *inv = (struct invocation *) data;
+	inv->fixture->iteration = iteration;
+	inv->bench->op(inv->fixture);
+}
+
+int main(int argc, char **argv)
+{
+	const size_t degrees[4] = { 1, 2, 3, 5 };
+	const size_t dimensions[3] = { 2, 3, 4 };
+	const size_t num_ctrlp[3] = { 16, 128, 1024 };
+	const size_t num_benchmarks = sizeof(BENCHMARKS) /
+		sizeof(struct benchmark);
+	struct harness_config config;
+	struct invocation inv;
+	struct fixture f;
+	size_t d, m, n, b;
+
+	harness_init(argc, argv, &config);
+	harness_calibrate(&config, "calibration");
+	inv.fixture = &f;
+	for (d = 0; d < 4; d++) {
+		for (m = 0; m < 3; m++) {
+			for (n = 0; n < 3; n++) {
+				fixture_setup(&f, degrees[d], dimensions[m],
+					num_ctrlp[n]);
+				for (b = 0; b < num_benchmarks; b++) {
+					if (!harness_selected(&config,
+						BENCHMARKS[b].name))
+						continue;
+					/* The interpolators do not depend on
+					 * the degree. */
+					if (BENCHMARKS[b].interpolation &&
+						degrees[d] != 3)
+						continue;
+					inv.bench = BENCHMARKS + b;
+					harness_run(&config, inv.bench->name,
+						inv.bench->interpolation
+						? 3 : f.deg, f.dim, f.n_ctrlp,
+						invoke, &inv);
+				}
+				fixture_teardown(&f);
+			}
+		}
+	}
+	return 0;
+}
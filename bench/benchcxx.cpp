@@ -0,0 +1,151 @@
+/*
+ * Benchmark suite of the C++ wrapper of TinySpline. Times the operations of
+ * tinyspline::BSpline corresponding to selected operations of bench.c. The
+ * names of the operations are prefixed with `cxx_', so that both suites can
+ * be stored in the same file and tinyspline_bench_compare is able to report
+ * the overhead of the wrapper (cxx_<operation> vs. <operation>). Usage and
+ * output format are the same as the ones of tinyspline_bench:
+ *
+ *     tinysplinecxx_bench [min_seconds [filter [repetitions]]]
+ */
+#include "tinysplinecxx.h"
+#include "harness.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+using tinyspline::BSpline;
+using tinyspline::real;
+
+const size_t NUM_KNOTS = 1000; /* Same as in bench.c. */
+
+/* Mirrors the fixture of bench.c. */
+struct Fixture {
+	size_t deg, dim, n_ctrlp;
+	BSpline spline;
+	std::vector<real> us;
+	std::string json;
+};
+
+typedef void (*Operation)(Fixture &, unsigned long);
+
+real noise(size_t i)
+{
+	return (real) ((i * 7919) % 2001) / (real) 1000.0 - 1;
+}
+
+void opEval(Fixture &f, unsigned long i)
+{
+	f.spline.eval(f.us[i % NUM_KNOTS]).result();
+}
+
+void opEvalAll(Fixture &f, unsigned long)
+{
+	f.spline.evalAll(f.us);
+}
+
+void opSample(Fixture &f, unsigned long)
+{
+	f.spline.sample(NUM_KNOTS);
+}
+
+void opDerive(Fixture &f, unsigned long)
+{
+	f.spline.derive(1);
+}
+
+void opToBeziers(Fixture &f, unsigned long)
+{
+	f.spline.toBeziers();
+}
+
+void opSaveJson(Fixture &f, unsigned long)
+{
+	f.spline.toJson();
+}
+
+void opLoadJson(Fixture &f, unsigned long)
+{
+	BSpline::parseJson(f.json);
+}
+
+struct Benchmark {
+	const char *name;
+	Operation op;
+};
+
+const Benchmark BENCHMARKS[] = {
+	{ "cxx_eval", opEval },
+	{ "cxx_eval_all", opEvalAll },
+	{ "cxx_sample", opSample },
+	{ "cxx_derive", opDerive },
+	{ "cxx_to_beziers", opToBeziers },
+	{ "cxx_save_json", opSaveJson },
+	{ "cxx_load_json", opLoadJson }
+};
+
+void setup(Fixture &f, size_t deg, size_t dim, size_t n_ctrlp)
+{
+	f.deg = deg;
+	f.dim = dim;
+	f.n_ctrlp = n_ctrlp;
+	f.spline = BSpline(n_ctrlp, dim, deg, TS_CLAMPED);
+	std::vector<real> points(n_ctrlp * dim);
+	for (size_t i = 0; i < points.size(); i++)
+		points[i] = i % dim == 0 ? (real) (i / dim) : noise(i);
+	f.spline.setControlPoints(points);
+	real min = f.spline.domain().min();
+	real max = f.spline.domain().max();
+	f.us.resize(NUM_KNOTS);
+	for (size_t i = 0; i < NUM_KNOTS; i++) {
+		f.us[i] = min + (max - min) *
+			(real) ((i * 617) % NUM_KNOTS) / (NUM_KNOTS - 1);
+	}
+	f.json = f.spline.toJson();
+}
+
+/* The data passed to invoke. */
+struct Invocation {
+	const Benchmark *bench;
+	Fixture *fixture;
+};
+
+void invoke(void *data, unsigned long iteration)
+{
+	Invocation *inv = static_cast<Invocation *>(data);
+	inv->bench->op(*inv->fixture, iteration);
+}
+}
+
+int main(int argc, char **argv)
+{
+	const size_t degrees[4] = { 1, 2, 3, 5 };
+	const size_t dimensions[3] = { 2, 3, 4 };
+	const size_t numCtrlp[3] = { 16, 128, 1024 };
+	const size_t numBenchmarks = sizeof(BENCHMARKS) / sizeof(Benchmark);
+	harness_config config;
+	Invocation inv;
+	Fixture f;
+
+	harness_init(argc, argv, &config);
+	harness_calibrate(&config, "cxx_calibration");
+	inv.fixture = &f;
+	for (size_t d = 0; d < 4; d++) {
+		for (size_t m = 0; m < 3; m++) {
+			for (size_t n = 0; n < 3; n++) {
+				setup(f, degrees[d], dimensions[m],
+					numCtrlp[n]);
+				for (size_t b = 0; b < numBenchmarks; b++) {
+					if (!harness_selected(&config,
+						BENCHMARKS[b].name))
+						continue;
+					inv.bench = BENCHMARKS + b;
+					harness_run(&config, inv.bench->name,
+						f.deg, f.dim, f.n_ctrlp,
+						invoke, &inv);
+				}
+			}
+		}
+	}
+	return 0;
+}
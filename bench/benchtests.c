@@ -0,0 +1,65 @@
+/*
+ * Times the unit tests of the C library (test/c) and prints the results in
+ * CSV format to stdout (see harness.h). Each test case is reported as an
+ * operation named `test_<name>' (with degree, dimension, and control_points
+ * 0), so that tinyspline_bench_compare tracks the timings of the tests like
+ * the timings of the other suites. Unlike the core operations, the tests
+ * cover the error paths and edge cases of the library, too.
+ *
+ * Usage:
+ *
+ *     tinyspline_bench_tests [min_seconds [filter [repetitions]]]
+ *
+ * See bench.c for the arguments. Aborts if a test fails (the results would
+ * be meaningless).
+ */
+#include <testutils.h>
+#include "harness.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PREFIX "test_"
+
+/* Defined in test/c/suites.c. */
+CuSuite* get_all_suites();
+
+void run_test(void *data, unsigned long iteration)
+{
+	CuTest *tc = (CuTest *) data;
+	(void) iteration;
+	tc->failed = 0;
+	tc->ran = 0;
+	tc->message = NULL;
+	CuTestRun(tc);
+	if (tc->failed) {
+		fprintf(stderr, "error: %s failed: %s\n", tc->name,
+			tc->message ? tc->message : "");
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	char name[sizeof(TEST_PREFIX) + 64];
+	struct harness_config config;
+	CuSuite *suite;
+	CuTest *tc;
+	int i;
+
+	harness_init(argc, argv, &config);
+	harness_calibrate(&config, TEST_PREFIX "calibration");
+	suite = get_all_suites();
+	for (i = 0; i < suite->count; i++) {
+		tc = suite->list[i];
+		if (strlen(tc->name) >= sizeof(name) - sizeof(TEST_PREFIX))
+			continue;
+		strcpy(name, TEST_PREFIX);
+		strcat(name, tc->name);
+		if (!harness_selected(&config, name))
+			continue;
+		harness_run(&config, name, 0, 0, 0, run_test, tc);
+	}
+	CuSuiteDelete(suite);
+	return 0;
+}
@@ -0,0 +1,311 @@
+/*
+ * Compares two runs of the benchmark suites (tinyspline_bench,
+ * tinysplinecxx_bench, and tinyspline_bench_tests) and prints a report in
+ * CSV format to stdout. An operation (in a configuration) is considered to
+ * be a regression if it became slower by more than `threshold' (relative to
+ * the baseline) and if the slowdown is significant, that is, greater than
+ * `sigmas' times the standard deviation of the difference, which is
+ * estimated from the median absolute deviations (ns_mad) of both runs. A
+ * file may contain the output of several runs of a suite (separate
+ * processes), in which case the median of the runs is compared and the
+ * deviation between the runs is taken into account as well. To compensate
+ * for differences in the speed of the machine (e.g., due to frequency
+ * scaling or other processes), the timings of the current run are normalized
+ * with the calibration workload of each suite (see harness_calibrate)
+ * beforehand. Afterwards, the overhead of the C++ wrapper is reported for
+ * each operation timed by the C and the C++ suite.
+ *
+ * Usage:
+ *
+ *     tinyspline_bench_compare baseline current [threshold [sigmas]]
+ *
+ * threshold defaults to 0.1 (10%), sigmas to 3. Returns 1 if at least one
+ * regression was found and 2 if a file cannot be read.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NAME_LEN 63
+
+/* Maximum number of runs of a suite stored in a file. Further runs are
+ * ignored. */
+#define MAX_RUNS 16
+
+/* Scales the MAD of normally distributed values to their standard
+ * deviation. */
+#define MAD_TO_SIGMA 1.4826
+
+/* Prefix of the operations of tinysplinecxx_bench. */
+#define CXX_PREFIX "cxx_"
+
+/* Prefix of the operations of tinyspline_bench_tests (the unit tests). */
+#define TEST_PREFIX "test_"
+
+/* Names of the calibration workloads of the suites. */
+#define CALIBRATION "calibration"
+#define CXX_CALIBRATION CXX_PREFIX CALIBRATION
+#define TEST_CALIBRATION TEST_PREFIX CALIBRATION
+
+/* A line of the output of a benchmark suite. */
+struct entry {
+	char name[MAX_NAME_LEN + 1];
+	unsigned long deg, dim, n_ctrlp;
+	double ns;  /**< Median time per operation. */
+	double mad; /**< Median absolute deviation of `ns`. 0 if missing. */
+	double runs[MAX_RUNS]; /**< `ns` of each run. */
+	size_t num_runs;
+	int matched; /**< Whether the entry has a counterpart. */
+};
+
+struct run {
+	struct entry *entries;
+	size_t num;
+};
+
+/* Returns the entry of `run` with the given name and configuration or
+ * NULL. */
+struct entry * find(const struct run *run, const char *name,
+	const struct entry *config)
+{
+	size_t i;
+	struct entry *e;
+	for (i = 0; i < run->num; i++) {
+		e = run->entries + i;
+		if (e->deg == config->deg && e->dim == config->dim &&
+			e->n_ctrlp == config->n_ctrlp &&
+			strcmp(e->name, name) == 0)
+			return e;
+	}
+	return NULL;
+}
+
+/* Sorts the `num` values of `values` in ascending order and returns their
+ * median. */
+double median(double *values, size_t num)
+{
+	size_t i, j;
+	double v;
+	for (i = 1; i < num; i++) {
+		v = values[i];
+		for (j = i; j > 0 && values[j - 1] > v; j--)
+			values[j] = values[j - 1];
+		values[j] = v;
+	}
+	return num % 2 ? values[num / 2]
+		: (values[num / 2 - 1] + values[num / 2]) / 2;
+}
+
+/* Merges the runs of each entry: `ns` becomes the median of the runs and
+ * `mad` the greater of the deviation within a run and the deviation between
+ * the runs. */
+void merge_runs(struct run *run)
+{
+	double devs[MAX_RUNS];
+	struct entry *e;
+	size_t i, r;
+	for (i = 0; i < run->num; i++) {
+		e = run->entries + i;
+		if (e->num_runs < 2)
+			continue;
+		e->ns = median(e->runs, e->num_runs);
+		for (r = 0; r < e->num_runs; r++) {
+			devs[r] = e->runs[r] > e->ns ? e->runs[r] - e->ns
+				: e->ns - e->runs[r];
+		}
+		devs[0] = median(devs, e->num_runs);
+		if (devs[0] > e->mad)
+			e->mad = devs[0];
+	}
+}
+
+/* Reads the benchmark results stored in `path`. Skips the CSV headers (the
+ * output of several suites may be concatenated), comments, and lines that
+ * cannot be parsed. Returns 0 on error. */
+int load(const char *path, struct run *run)
+{
+	char line[256];
+	struct entry e, *grown, *prev;
+	size_t cap = 0;
+	unsigned long iterations;
+	int n;
+	FILE *file = fopen(path, "r");
+	run->entries = NULL;
+	run->num = 0;
+	if (!file) {
+		fprintf(stderr, "error: cannot open '%s'\n", path);
+		return 0;
+	}
+	while (fgets(line, sizeof(line), file)) {
+		memset(&e, 0, sizeof(e));
+		n = sscanf(line, "%63[^,],%lu,%lu,%lu,%lu,%lf,%lf", e.name,
+			&e.deg, &e.dim, &e.n_ctrlp, &iterations, &e.ns,
+			&e.mad);
+		if (n < 6)
+			continue;
+		/* Another run of the same operation and configuration. */
+		prev = find(run, e.name, &e);
+		if (prev) {
+			if (prev->num_runs < MAX_RUNS)
+				prev->runs[prev->num_runs++] = e.ns;
+			if (e.mad > prev->mad)
+				prev->mad = e.mad;
+			continue;
+		}
+		e.runs[0] = e.ns;
+		e.num_runs = 1;
+		if (run->num == cap) {
+			cap = cap ? cap * 2 : 256;
+			grown = (struct entry *) realloc(run->entries,
+				cap * sizeof(struct entry));
+			if (!grown) {
+				fprintf(stderr, "error: out of memory\n");
+				fclose(file);
+				return 0;
+			}
+			run->entries = grown;
+		}
+		run->entries[run->num++] = e;
+	}
+	fclose(file);
+	merge_runs(run);
+	return 1;
+}
+
+/* Returns 1 if `e` is a calibration workload. */
+int is_calibration(const struct entry *e)
+{
+	return strcmp(e->name, CALIBRATION) == 0 ||
+		strcmp(e->name, CXX_CALIBRATION) == 0 ||
+		strcmp(e->name, TEST_CALIBRATION) == 0;
+}
+
+/* Returns the factor that normalizes the timings of the current run to the
+ * speed of the machine during the baseline run, i.e., the ratio of the
+ * timings of the calibration workload `name`. Returns 1 if one of the runs
+ * has no calibration. */
+double speed_factor(const struct run *baseline, const struct run *current,
+	const char *name)
+{
+	struct entry config, *base, *cur;
+	memset(&config, 0, sizeof(config));
+	base = find(baseline, name, &config);
+	cur = find(current, name, &config);
+	if (!base || !cur || base->ns <= 0 || cur->ns <= 0)
+		return 1;
+	return base->ns / cur->ns;
+}
+
+int main(int argc, char **argv)
+{
+	struct run baseline, current;
+	double threshold = 0.1, sigmas = 3, factor, factor_cxx, factor_test;
+	double f, ns, mad;
+	double diff, noise;
+	size_t i, regressions = 0, improvements = 0, compared = 0;
+	size_t missing = 0, added = 0;
+	struct entry *cur, *base, *c;
+	const char *status;
+
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s baseline current "
+			"[threshold [sigmas]]\n", argv[0]);
+		return 2;
+	}
+	if (argc > 3)
+		threshold = atof(argv[3]);
+	if (argc > 4)
+		sigmas = atof(argv[4]);
+	current.entries = NULL;
+	if (!load(argv[1], &baseline) || !load(argv[2], &current)) {
+		free(baseline.entries);
+		free(current.entries);
+		return 2;
+	}
+
+	factor = speed_factor(&baseline, &current, CALIBRATION);
+	factor_cxx = speed_factor(&baseline, &current, CXX_CALIBRATION);
+	factor_test = speed_factor(&baseline, &current, TEST_CALIBRATION);
+	printf("# threshold: %.1f%%, sigmas: %.1f\n", threshold * 100,
+		sigmas);
+	printf("# current_ns is normalized by %.3f (C), %.3f (C++), and "
+		"%.3f (tests)\n", factor, factor_cxx, factor_test);
+	printf("operation,degree,dimension,control_points,baseline_ns,"
+		"current_ns,change_percent,status\n");
+	for (i = 0; i < current.num; i++) {
+		cur = current.entries + i;
+		base = find(&baseline, cur->name, cur);
+		if (base)
+			base->matched = 1;
+		if (is_calibration(cur))
+			continue;
+		if (strncmp(cur->name, CXX_PREFIX, strlen(CXX_PREFIX)) == 0)
+			f = factor_cxx;
+		else if (strncmp(cur->name, TEST_PREFIX,
+			strlen(TEST_PREFIX)) == 0)
+			f = factor_test;
+		else
+			f = factor;
+		ns = cur->ns * f;
+		mad = cur->mad * f;
+		if (!base) {
+			added++;
+			printf("%s,%lu,%lu,%lu,,%.1f,,new\n", cur->name,
+				cur->deg, cur->dim, cur->n_ctrlp, ns);
+			continue;
+		}
+		compared++;
+		diff = ns - base->ns;
+		noise = sigmas * MAD_TO_SIGMA *
+			sqrt(base->mad * base->mad + mad * mad);
+		if (diff > threshold * base->ns && diff > noise) {
+			status = "REGRESSION";
+			regressions++;
+		} else if (-diff > threshold * base->ns && -diff > noise) {
+			status = "faster";
+			improvements++;
+		} else if (diff > threshold * base->ns) {
+			/* Within the noise of the measurements. */
+			status = "slower";
+		} else {
+			status = "ok";
+		}
+		printf("%s,%lu,%lu,%lu,%.1f,%.1f,%+.1f,%s\n", cur->name,
+			cur->deg, cur->dim, cur->n_ctrlp, base->ns, ns,
+			base->ns > 0 ? diff / base->ns * 100 : 0.0, status);
+	}
+	for (i = 0; i < baseline.num; i++) {
+		base = baseline.entries + i;
+		if (base->matched || is_calibration(base))
+			continue;
+		missing++;
+		printf("%s,%lu,%lu,%lu,%.1f,,,missing\n", base->name,
+			base->deg, base->dim, base->n_ctrlp, base->ns);
+	}
+
+	printf("\n# C++ wrapper overhead (current run)\n");
+	printf("operation,degree,dimension,control_points,c_ns,cxx_ns,"
+		"overhead_ns,overhead_percent\n");
+	for (i = 0; i < current.num; i++) {
+		cur = current.entries + i;
+		if (strncmp(cur->name, CXX_PREFIX, strlen(CXX_PREFIX)) != 0 ||
+			is_calibration(cur))
+			continue;
+		c = find(&current, cur->name + strlen(CXX_PREFIX), cur);
+		if (!c)
+			continue;
+		printf("%s,%lu,%lu,%lu,%.1f,%.1f,%.1f,%+.1f\n", c->name,
+			cur->deg, cur->dim, cur->n_ctrlp, c->ns, cur->ns,
+			cur->ns - c->ns,
+			c->ns > 0 ? (cur->ns - c->ns) / c->ns * 100 : 0.0);
+	}
+
+	printf("\n# %lu compared, %lu regressions, %lu faster, %lu new, "
+		"%lu missing\n", (unsigned long) compared,
+		(unsigned long) regressions, (unsigned long) improvements,
+		(unsigned long) added, (unsigned long) missing);
+	free(baseline.entries);
+	free(current.entries);
+	return regressions > 0 ? 1 : 0;
+}
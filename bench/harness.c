@@ -0,0 +1,100 @@
+#include "harness.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+void harness_init(int argc, char **argv, struct harness_config *config)
+{
+	config->min_seconds = 0.05;
+	config->filter = NULL;
+	config->repetitions = 1;
+	if (argc > 1)
+		config->min_seconds = atof(argv[1]);
+	if (argc > 2 && argv[2][0] != '\0')
+		config->filter = argv[2];
+	if (argc > 3)
+		config->repetitions = (size_t) atol(argv[3]);
+	if (config->repetitions < 1)
+		config->repetitions = 1;
+	if (config->repetitions > HARNESS_MAX_REPETITIONS)
+		config->repetitions = HARNESS_MAX_REPETITIONS;
+	printf("operation,degree,dimension,control_points,iterations,"
+		"ns_per_op,ns_mad\n");
+}
+
+int harness_selected(const struct harness_config *config, const char *name)
+{
+	return !config->filter || strstr(name, config->filter) != NULL;
+}
+
+/* Sorts the `num' values of `values' in ascending order and returns their
+ * median. */
+double median(double *values, size_t num)
+{
+	size_t i, j;
+	double v;
+	for (i = 1; i < num; i++) {
+		v = values[i];
+		for (j = i; j > 0 && values[j - 1] > v; j--)
+			values[j] = values[j - 1];
+		values[j] = v;
+	}
+	return num % 2 ? values[num / 2]
+		: (values[num / 2 - 1] + values[num / 2]) / 2;
+}
+
+/* Returns the CPU time (in seconds) of `num' iterations of `op'. */
+double measure(harness_operation op, void *data, unsigned long num)
+{
+	unsigned long i;
+	clock_t begin = clock();
+	for (i = 0; i < num; i++)
+		op(data, i);
+	return (double) (clock() - begin) / CLOCKS_PER_SEC;
+}
+
+/* The workload of harness_calibrate: a dependency chain of floating point
+ * operations, the result of which is stored in `data' so that it cannot be
+ * optimized away. */
+void workload(void *data, unsigned long iteration)
+{
+	double x = (double) iteration, y = 0;
+	int i;
+	for (i = 0; i < 1000; i++)
+		y = y * 0.5 + x;
+	*(volatile double *) data = y;
+}
+
+void harness_calibrate(const struct harness_config *config, const char *name)
+{
+	double result;
+	harness_run(config, name, 0, 0, 0, workload, &result);
+}
+
+void harness_run(const struct harness_config *config, const char *name,
+	size_t deg, size_t dim, size_t n_ctrlp, harness_operation op,
+	void *data)
+{
+	double ns[HARNESS_MAX_REPETITIONS], seconds, med;
+	unsigned long num = 1;
+	size_t r;
+
+	/* The calibration yields the first repetition. */
+	for (;;) {
+		seconds = measure(op, data, num);
+		if (seconds >= config->min_seconds || num >= 1UL << 30)
+			break;
+		num *= 2;
+	}
+	ns[0] = seconds / (double) num * 1e9;
+	for (r = 1; r < config->repetitions; r++)
+		ns[r] = measure(op, data, num) / (double) num * 1e9;
+	med = median(ns, config->repetitions);
+	for (r = 0; r < config->repetitions; r++)
+		ns[r] = ns[r] > med ? ns[r] - med : med - ns[r];
+	printf("%s,%lu,%lu,%lu,%lu,%.1f,%.1f\n", name, (unsigned long) deg,
+		(unsigned long) dim, (unsigned long) n_ctrlp, num, med,
+		median(ns, config->repetitions));
+	fflush(stdout);
+}
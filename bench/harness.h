@@ -0,0 +1,65 @@
+/*
+ * Driver shared by the benchmark suites of the C library (bench.c) and the
+ * C++ wrapper (benchcxx.cpp). Times an operation repeatedly and prints the
+ * median and the median absolute deviation (MAD) of the repetitions in CSV
+ * format:
+ *
+ *     operation,degree,dimension,control_points,iterations,ns_per_op,ns_mad
+ *
+ * The results of different runs are compared by tinyspline_bench_compare
+ * (see compare.c).
+ */
+#ifndef TINYSPLINE_BENCH_HARNESS_H
+#define TINYSPLINE_BENCH_HARNESS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HARNESS_MAX_REPETITIONS 64
+
+/**
+ * The command line arguments of a benchmark suite:
+ *
+ *     <suite> [min_seconds [filter [repetitions]]]
+ *
+ * min_seconds is the minimum CPU time spent per repetition (default: 0.05).
+ * If filter is given (and not empty), only operations whose name contains
+ * filter are timed. Each configuration of an operation is timed repetitions
+ * times (default: 1, max: HARNESS_MAX_REPETITIONS).
+ */
+struct harness_config {
+	double min_seconds;
+	const char *filter; /**< NULL if all operations are timed. */
+	size_t repetitions;
+};
+
+typedef void (*harness_operation)(void *data, unsigned long iteration);
+
+/* Parses the command line arguments and prints the CSV header. */
+void harness_init(int argc, char **argv, struct harness_config *config);
+
+/* Returns whether the operation `name' passes the filter of `config'. */
+int harness_selected(const struct harness_config *config, const char *name);
+
+/* Times a fixed workload that does not depend on TinySpline and prints the
+ * result as operation `name' (with degree, dimension, and control_points
+ * 0). Since the CPU time of the workload reflects the speed of the machine
+ * at the time of the run, tinyspline_bench_compare uses it to normalize the
+ * timings of different runs. */
+void harness_calibrate(const struct harness_config *config, const char *name);
+
+/* Times `op' (doubling the number of iterations until a repetition takes at
+ * least `min_seconds' of CPU time), repeats the measurement, and prints the
+ * result. `op' is called with `data' and the index of the iteration. */
+void harness_run(const struct harness_config *config, const char *name,
+	size_t deg, size_t dim, size_t n_ctrlp, harness_operation op,
+	void *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TINYSPLINE_BENCH_HARNESS_H */
@@ -0,0 +1,63 @@
+###############################################################################
+### Runs the benchmark suites and either stores the results as baseline
+### (MODE=baseline) or compares them with the baseline (MODE=check). In the
+### latter case, the report of tinyspline_bench_compare is written to REPORT
+### and the script fails if a regression was found. Invoked by the targets
+### 'benchmarks_baseline' and 'benchmarks_check' with:
+#
+# MODE         baseline or check.
+# SUITES       The benchmark executables (list).
+# COMPARE      The tinyspline_bench_compare executable.
+# BASELINE     The file storing the baseline.
+# CURRENT      The file storing the results of this run (MODE=check).
+# REPORT       The file storing the report (MODE=check).
+# MIN_SECONDS  Passed to the benchmark executables.
+# FILTER       Passed to the benchmark executables (may be empty).
+# REPETITIONS  Passed to the benchmark executables.
+# RUNS         Number of times each suite is run (in a separate process).
+# THRESHOLD    Passed to tinyspline_bench_compare.
+# SIGMAS       Passed to tinyspline_bench_compare.
+###############################################################################
+if(MODE STREQUAL "check" AND NOT EXISTS "${BASELINE}")
+	message(FATAL_ERROR "No baseline found at ${BASELINE}. "
+		"Run the 'benchmarks_baseline' target first.")
+endif()
+
+# Timings may differ between processes (e.g., due to the memory layout), so
+# each suite is run several times. tinyspline_bench_compare merges the runs.
+set(results "")
+foreach(run RANGE 1 ${RUNS})
+	foreach(suite ${SUITES})
+		execute_process(
+			COMMAND "${suite}" "${MIN_SECONDS}" "${FILTER}"
+				"${REPETITIONS}"
+			OUTPUT_VARIABLE output
+			RESULT_VARIABLE result
+		)
+		if(NOT result EQUAL 0)
+			message(FATAL_ERROR "${suite} failed: ${result}")
+		endif()
+		string(APPEND results "${output}")
+	endforeach()
+endforeach()
+
+if(MODE STREQUAL "baseline")
+	file(WRITE "${BASELINE}" "${results}")
+	message(STATUS "Stored baseline in ${BASELINE}")
+	return()
+endif()
+
+file(WRITE "${CURRENT}" "${results}")
+execute_process(
+	COMMAND "${COMPARE}" "${BASELINE}" "${CURRENT}"
+		"${THRESHOLD}" "${SIGMAS}"
+	OUTPUT_VARIABLE report
+	RESULT_VARIABLE result
+)
+file(WRITE "${REPORT}" "${report}")
+message("${report}")
+if(result EQUAL 1)
+	message(FATAL_ERROR "Performance regressions found (see ${REPORT})")
+elseif(NOT result EQUAL 0)
+	message(FATAL_ERROR "${COMPARE} failed: ${result}")
+endif()
@@ -109,10 +109,9 @@ void tear_down()
 void display(void)
 {
 	size_t i;
-	tsDeBoorNet net;
 	tsReal *ctrlp;
 	tsReal *knots;
-	tsReal *result;
+	tsReal result[3];
 	
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	
@@ -141,21 +140,18 @@ void display(void)
 		 glVertex3fv(&ctrlp[i * ts_bspline_dimension(&spline)]);
 	glEnd();
 	
-	/* eval spline */
-	ts_bspline_eval(&spline, u, &net, NULL);
-	ts_deboornet_result(&net, &result, NULL);
+	/* eval spline (divides by the weight) */
+	ts_bspline_eval_rational_point(&spline, u, result, NULL);
 	
 	/* draw evaluation */
 	glColor3f(0.0, 0.0, 1.0);
 	glPointSize(5.0);
 	glBegin(GL_POINTS);
-		glVertex4fv(result);
+		glVertex3fv(result);
 	glEnd();
 	
-	ts_deboornet_free(&net);
 	free(ctrlp);
 	free(knots);
-	free(result);
 	
 	u += 0.001f;
 	if (u > 1.f) {
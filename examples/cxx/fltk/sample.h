@@ -30,7 +30,8 @@ public:
 		// Draw spline.
 		fl_color(FL_BLACK);
 		fl_begin_line();
-		std::vector<tinyspline::real> pts = spline.sample(m_num);
+		// Rasterizing lines does not require exact points.
+		std::vector<tinyspline::real> pts = spline.sampleFast(m_num);
 		for (size_t i = 0; i < pts.size() / 2; i++)
 			fl_vertex(pts[i * 2], pts[i * 2 + 1]);
 		fl_end_line();
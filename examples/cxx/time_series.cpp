@@ -38,7 +38,7 @@ int main(int argc, char **argv)
 	tinyspline::BSpline spline = tinyspline::BSpline::
 		interpolateCubicNatural(points, 4);
 
-	tinyspline::DeBoorNet net = spline.bisect(1850);
+	tinyspline::DeBoorNet net = spline.solve(1850);
 	std::vector<tinyspline::real> result = net.result();
 	std::cout << "t = " << result[0] << ", p = (" << result[1] << ", "
 			<< result[2] << ", " << result[3] << ")" << std::endl;
@@ -100,6 +100,12 @@
 %ignore tinyspline::DeBoorNet::data;
 %ignore tsBSpline;
 %ignore tinyspline::BSpline::data;
+%ignore tsBSplineView;
+%ignore tsSamplingPlan;
+%ignore tsCompiledSpline;
+%ignore tsArchive;
+%ignore tsAllocator;
+%ignore tsMorphism;
 
 // Rename exported enums and enum values.
 %rename(BSplineType) tsBSplineType;
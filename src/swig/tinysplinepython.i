@@ -24,18 +24,111 @@
 	delete $1;
 }
 
-// Map Python list to std::vector<tinyspline::real>.
-%typemap(in) std::vector<tinyspline::real> * (int size, PyObject *data) %{
-	size = PyList_Size($input);
-	$1 = new std::vector<tinyspline::real>();
-	$1->reserve(size);
-	for (int i = 0; i < size; i++) {
-		data = PyList_GetItem($input, i);
-		$1->push_back(PyFloat_AsDouble(data));
+// Objects implementing the buffer protocol (e.g., NumPy arrays, array.array,
+// and memoryview) are accepted if they are C-contiguous and store values of
+// type tinyspline::real (format 'd', or 'f' if TINYSPLINE_FLOAT_PRECISION is
+// enabled). Their shape is ignored, i.e., a NumPy array of shape (n, dim) is
+// treated as a flat sequence of n * dim values.
+%{
+	static int tinyspline_python_get_buffer(PyObject *obj,
+		Py_buffer *view, int writable)
+	{
+		const char expected =
+			sizeof(tinyspline::real) == sizeof(double) ? 'd' : 'f';
+		const char *format;
+		int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+		if (writable)
+			flags |= PyBUF_WRITABLE;
+		if (PyObject_GetBuffer(obj, view, flags) != 0)
+			return 0;
+		format = view->format ? view->format : "B";
+		if (*format == '@' || *format == '=')
+			format++;
+		if (view->itemsize != (Py_ssize_t) sizeof(tinyspline::real) ||
+				format[0] != expected || format[1] != '\0') {
+			PyBuffer_Release(view);
+			view->obj = NULL;
+			PyErr_Format(PyExc_TypeError,
+				"buffer must store values of type '%c'",
+				expected);
+			return 0;
+		}
+		return 1;
+	}
+%}
+
+// Map Python list (or buffer) to std::vector<tinyspline::real>. Buffers are
+// copied in bulk.
+%typemap(in) std::vector<tinyspline::real> * (int size, PyObject *data,
+	Py_buffer view) %{
+	if (PyObject_CheckBuffer($input)) {
+		if (!tinyspline_python_get_buffer($input, &view, 0))
+			SWIG_fail;
+		const tinyspline::real *values =
+			static_cast<const tinyspline::real *>(view.buf);
+		$1 = new std::vector<tinyspline::real>(values,
+			values + view.len / sizeof(tinyspline::real));
+		PyBuffer_Release(&view);
+	} else {
+		size = PyList_Size($input);
+		$1 = new std::vector<tinyspline::real>();
+		$1->reserve(size);
+		for (int i = 0; i < size; i++) {
+			data = PyList_GetItem($input, i);
+			$1->push_back(PyFloat_AsDouble(data));
+		}
 	}
 %}
+%typemap(typecheck, precedence=SWIG_TYPECHECK_DOUBLE_ARRAY)
+	std::vector<tinyspline::real> * %{
+	$1 = PyList_Check($input) || PyObject_CheckBuffer($input);
+%}
 %typemap(freearg) std::vector<tinyspline::real> * {
 	delete $1;
 }
 
+// Map buffers to the raw pointer variants of BSpline::evalAllInto and
+// BSpline::sampleInto. No data is copied: the knots are read from, and the
+// points are written to, the memory of the given buffers. The variants taking
+// std::vector<tinyspline::real> references are not usable from Python.
+%ignore tinyspline::BSpline::evalAllInto(const std::vector<tinyspline::real> *,
+	std::vector<tinyspline::real> &) const;
+%ignore tinyspline::BSpline::sampleInto(std::vector<tinyspline::real> &,
+	size_t) const;
+%ignore tinyspline::BSpline::sampleInto(std::vector<tinyspline::real> &)
+	const;
+%typemap(arginit) (const tinyspline::real *us, size_t num) %{
+	view$argnum.obj = NULL;
+%}
+%typemap(in) (const tinyspline::real *us, size_t num) (Py_buffer view) %{
+	if (!tinyspline_python_get_buffer($input, &view, 0))
+		SWIG_fail;
+	$1 = static_cast<const tinyspline::real *>(view.buf);
+	$2 = view.len / sizeof(tinyspline::real);
+%}
+%typemap(freearg) (const tinyspline::real *us, size_t num) %{
+	if (view$argnum.obj)
+		PyBuffer_Release(&view$argnum);
+%}
+%typemap(arginit) (tinyspline::real *points, size_t capacity) %{
+	view$argnum.obj = NULL;
+%}
+%typemap(in) (tinyspline::real *points, size_t capacity) (Py_buffer view) %{
+	if (!tinyspline_python_get_buffer($input, &view, 1))
+		SWIG_fail;
+	$1 = static_cast<tinyspline::real *>(view.buf);
+	$2 = view.len / sizeof(tinyspline::real);
+%}
+%typemap(freearg) (tinyspline::real *points, size_t capacity) %{
+	if (view$argnum.obj)
+		PyBuffer_Release(&view$argnum);
+%}
+// Required to dispatch the overloads generated for the default argument of
+// BSpline::sampleInto.
+%typemap(typecheck, precedence=SWIG_TYPECHECK_DOUBLE_ARRAY)
+	(const tinyspline::real *us, size_t num),
+	(tinyspline::real *points, size_t capacity) %{
+	$1 = PyObject_CheckBuffer($input);
+%}
+
 %include "tinyspline.i"
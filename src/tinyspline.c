@@ -1,11 +1,46 @@
 #include "tinyspline.h"
 #include "parson.h" /* serialization */
 
-#include <stdlib.h> /* malloc, free */
+#include <stdlib.h> /* malloc, free, getenv */
 #include <math.h>   /* fabs, sqrt */
 #include <string.h> /* memcpy, memmove, strcmp */
 #include <stdio.h>  /* FILE, fopen */
 #include <stdarg.h> /* varargs */
+#include <limits.h> /* LONG_MAX, CHAR_BIT */
+#include <float.h>  /* FLT_DIG, DBL_DIG */
+#ifdef TINYSPLINE_ENABLE_STATS
+#include <time.h>   /* clock */
+#endif
+#ifdef TINYSPLINE_ENABLE_OPENCL
+#define CL_TARGET_OPENCL_VERSION 120
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+#endif
+/* SIMD instruction sets used by ts_int_bspline_eval_lanes_f and
+ * ts_int_bspline_eval_lanes_d. SSE2 and NEON are part of the baseline of
+ * x86-64 and AArch64, respectively. AVX is compiled with GCC and Clang only
+ * (which support the target attribute) and is used if the CPU running the
+ * program supports it. 32-bit ARM provides NEON for float lanes only. */
+#ifndef TINYSPLINE_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TS_INT_SIMD_SSE
+#include <emmintrin.h> /* SSE2 */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TS_INT_SIMD_AVX
+#include <immintrin.h> /* AVX */
+#endif
+#elif defined(__ARM_NEON)
+#define TS_INT_SIMD_NEON
+#ifdef __aarch64__
+#define TS_INT_SIMD_NEON_F64
+#endif
+#include <arm_neon.h>
+#endif
+#endif
 
 /* Suppress some useless MSVC warnings. */
 #ifdef _MSC_VER
@@ -24,7 +59,135 @@
 
 #define INIT_OUT_BSPLINE(in, out)              \
 	if ((in) != (out))                     \
-		ts_int_bspline_init(out);
+		ts_int_bspline_init(out);      \
+	else                                   \
+		ts_int_bspline_drop_cache(out);
+
+/**
+ * Number of tsReal values that are allocated on the stack by functions
+ * requiring a small (temporary) workspace, e.g., to evaluate a spline. If a
+ * workspace exceeds this limit, it is allocated on the heap.
+ */
+#define TS_INT_STACK_BUFFER_LEN 512
+
+/**
+ * Number of knots that are evaluated together by ts_int_bspline_eval_lanes.
+ * Fits the vector registers of common SIMD instruction sets (e.g., AVX) in
+ * single and double precision.
+ */
+#define TS_INT_NUM_LANES 8
+
+/**
+ * Default number of knots that are evaluated by a single task of
+ * ts_bspline_eval_all_parallel and ts_bspline_sample_parallel. Large enough
+ * to amortize the scheduling overhead of common thread pools.
+ */
+#define TS_INT_GRAIN_SIZE 4096
+
+/**
+ * Maximum order of the splines that are evaluated on a device (cf. tsGpu).
+ * Bounds the size of the private arrays of the OpenCL kernel.
+ */
+#define TS_INT_GPU_MAX_ORDER 32
+
+/**
+ * Maximum number of points computed by ts_bspline_sample_fast with forward
+ * differences before the differences are recomputed from exact points.
+ * Limits the accumulation of rounding errors, which grows polynomially with
+ * the number of steps (the exponent being the degree of the spline).
+ */
+#ifdef TINYSPLINE_FLOAT_PRECISION
+#define TS_INT_FORWARD_DIFF_STEPS 8
+#else
+#define TS_INT_FORWARD_DIFF_STEPS 32
+#endif
+
+/**
+ * Number of significant decimal digits that survive a round trip through
+ * tsReal. Any tsReal can be restored (with strtod) from at most
+ * TS_INT_REAL_DIG + 3 significant digits. The JSON writer uses exponential
+ * notation like %g with a precision of (at least) this many digits.
+ */
+#ifdef TINYSPLINE_FLOAT_PRECISION
+#define TS_INT_REAL_DIG FLT_DIG
+#else
+#define TS_INT_REAL_DIG DBL_DIG
+#endif
+
+/**
+ * Smallest positive normalized tsReal. Subnormal values have less than
+ * TS_INT_REAL_DIG significant decimal digits.
+ */
+#ifdef TINYSPLINE_FLOAT_PRECISION
+#define TS_INT_REAL_MIN FLT_MIN
+#else
+#define TS_INT_REAL_MIN DBL_MIN
+#endif
+
+/**
+ * Number of bits of the significand of tsReal.
+ */
+#ifdef TINYSPLINE_FLOAT_PRECISION
+#define TS_INT_REAL_MANT_DIG FLT_MANT_DIG
+#else
+#define TS_INT_REAL_MANT_DIG DBL_MANT_DIG
+#endif
+
+/**
+ * Defined if unsigned long has (at least) 64 bits, which is required by the
+ * shortest digit generation of the JSON writer (cf. ts_int_json_grisu). C89
+ * has no other 64-bit integer type. On other targets (e.g., 32-bit and
+ * LLP64), the writer searches for the shortest digits with sprintf and
+ * strtod.
+ */
+#if ULONG_MAX / 4294967295UL > 4294967295UL
+#define TS_INT_JSON_GRISU
+#endif
+
+/**
+ * Maximum number of times ts_bspline_sample_adaptive subdivides a Bezier
+ * segment, i.e., a segment is approximated by at most 2^16 line segments.
+ */
+#define TS_INT_MAX_SUBDIVISIONS 16
+
+/**
+ * Maximum number of Newton iterations ts_projector_project executes to
+ * refine the closest point of a Bezier segment.
+ */
+#define TS_INT_PROJECTOR_MAX_ITER 8
+
+/**
+ * Maximum number of Newton iterations ts_arc_length_u_at executes to find
+ * the knot at a given arc length within an integration step.
+ */
+#define TS_INT_ARC_LENGTH_MAX_ITER 8
+
+/**
+ * Maximum number of factors of the LU decomposition of the tridiagonal system
+ * solved by ts_int_cubic_natural_solve. The factors converge to 2 - sqrt(3)
+ * by a factor of about 0.07 per row, that is, they become constant (in terms
+ * of tsReal) after less than 20 rows.
+ */
+#define TS_INT_CUBIC_NATURAL_NUM_FACTORS 64
+
+/**
+ * Magic number, version, and size (in bytes) of the header of the binary
+ * format (cf. ts_bspline_to_binary). The size of the header is a multiple of
+ * the size of float and double so that the control points and knots
+ * following the header are properly aligned.
+ */
+#define TS_INT_BINARY_MAGIC "TSBS"
+#define TS_INT_BINARY_VERSION 1
+#define TS_INT_BINARY_HEADER_LEN 40
+
+/**
+ * Magic number, version, and size (in bytes) of the header and index entries
+ * of archives (cf. ts_archive_open).
+ */
+#define TS_INT_ARCHIVE_MAGIC "TSBA"
+#define TS_INT_ARCHIVE_VERSION 1
+#define TS_INT_ARCHIVE_HEADER_LEN 16
+#define TS_INT_ARCHIVE_ENTRY_LEN 24
 
 
 
@@ -44,6 +207,37 @@ struct tsBSplineImpl
 	size_t n_knots; /**< Number of knots (n_ctrlp + deg + 1). */
 };
 
+/**
+ * Stores the derivatives cached by ts_bspline_cached_derivative. The struct
+ * is followed by the derivatives (tsBSpline[num]), the i'th of which is the
+ * (i+1)'th derivative of the spline owning the cache.
+ */
+struct tsBSplineCache
+{
+	tsReal epsilon; /**< Passed to ts_bspline_derive. */
+	size_t num; /**< Number of cached derivatives. */
+};
+
+/**
+ * Precedes the state (struct tsBSplineImpl) of each spline allocated by
+ * TinySpline and stores the capacity of the allocation, i.e., the number of
+ * control point and knot values the state is able to store without being
+ * reallocated (cf. ::ts_bspline_reserve), the cached derivatives of the
+ * spline (cf. ::ts_bspline_cached_derivative). The state of a view (cf.
+ * ::ts_bspline_view_binary) is read-only and has no header. The union keeps
+ * the state and the values following the state properly aligned.
+ */
+union tsBSplineHeader
+{
+	struct
+	{
+		size_t cap; /**< Number of tsReal values the state is able
+		             *   to store. */
+		struct tsBSplineCache *cache; /**< NULL if empty. */
+	} h;
+	tsReal align; /**< Aligns the values following the state. */
+};
+
 /**
  * Stores the private data of a ::tsDeBoorNet.
  */
@@ -55,6 +249,234 @@ struct tsDeBoorNetImpl
 	size_t h; /**< Number of insertions required to obtain result. */
 	size_t dim; /**< Dimension of points. (2D => x, y) */
 	size_t n_points; /** Number of points in 'points'. */
+	size_t cap; /**< Number of tsReal values 'points' is able to store. */
+};
+
+/**
+ * Stores the private data of a ::tsSamplingPlan. The struct is followed by
+ * the index of the first affected control point of each knot value
+ * (size_t[n_points]), the knots of the spline the plan was created with
+ * (tsReal[n_knots]), and the weights of each knot value
+ * (tsReal[n_points * (deg + 1)]).
+ */
+struct tsSamplingPlanImpl
+{
+	size_t deg; /**< Degree of the basis functions. */
+	size_t n_knots; /**< Number of knots. */
+	size_t n_points; /**< Number of knot values (i.e., points). */
+};
+
+/**
+ * Stores the private data of a ::tsCompiledSpline. The struct is followed by
+ * the breakpoints of the spans (tsReal[n_spans + 1]), the inverse widths of
+ * the spans (tsReal[n_spans]), the power basis coefficients of the spans
+ * (tsReal[n_spans * (deg + 1) * dim]), and the control points
+ * (tsReal[n_ctrlp * dim]) and knots (tsReal[n_knots]) of the compiled spline
+ * (cf. ts_compiled_spline_check). The coefficients of a span are sorted by
+ * the power of the local parameter t = (u - breakpoint) * inverse width,
+ * which is in [0, 1].
+ */
+struct tsCompiledSplineImpl
+{
+	size_t deg; /**< Degree of the polynomials. */
+	size_t dim; /**< Dimension of the points. */
+	size_t n_spans; /**< Number of spans. */
+	size_t n_samples; /**< Default number of points of
+	                   *   ts_compiled_spline_sample. */
+	size_t n_ctrlp; /**< Number of control points of the source. */
+	size_t n_knots; /**< Number of knots of the source. */
+};
+
+/**
+ * Stores the private data of a ::tsSplinePool. The struct is followed by the
+ * control points of all splines in SoA form
+ * (tsReal[n_ctrlp * dim * n_splines]) and the knots of each spline. The knots
+ * of a spline are preceded by a struct tsBSplineImpl whose dimension is 0,
+ * which allows to pass them (wrapped by a ::tsBSpline) to the functions
+ * computing the basis functions of a spline (cf. ts_int_bspline_eval_basis).
+ * The control points and the knots of each spline are padded such that all
+ * structs tsBSplineImpl are properly aligned (cf. ts_int_sof_aligned).
+ */
+struct tsSplinePoolImpl
+{
+	size_t deg; /**< Degree of the splines. */
+	size_t dim; /**< Dimension of the control points. */
+	size_t n_ctrlp; /**< Number of control points per spline. */
+	size_t n_knots; /**< Number of knots per spline. */
+	size_t n_splines; /**< Number of splines. */
+	size_t shared; /**< Whether all splines share the same knots. */
+};
+
+/**
+ * Stores the private data of a ::tsGpu. The OpenCL handles are NULL if no
+ * device is used.
+ */
+struct tsGpuImpl
+{
+#ifdef TINYSPLINE_ENABLE_OPENCL
+	cl_context context; /**< Context of the device. */
+	cl_command_queue queue; /**< Command queue of the device. */
+	cl_program program; /**< Program built from ts_int_gpu_source. */
+	cl_kernel kernel; /**< Kernel `ts_eval' of the program. */
+#endif
+	int device; /**< Whether a device is used. */
+};
+
+/**
+ * Stores the private data of a ::tsBSplineSurface. The struct is followed by
+ * the control points (tsReal[n_ctrlp_u * n_ctrlp_v * dim]) and the knots of
+ * direction u and v. Like the knots of a ::tsSplinePool, the knots of a
+ * direction are preceded by a struct tsBSplineImpl whose dimension is 0 (cf.
+ * ts_int_bspline_surface_access_basis). The control points and the knots of
+ * direction u are padded such that both structs tsBSplineImpl are properly
+ * aligned (cf. ts_int_sof_aligned).
+ */
+struct tsBSplineSurfaceImpl
+{
+	size_t deg_u; /**< Degree in direction u. */
+	size_t deg_v; /**< Degree in direction v. */
+	size_t dim; /**< Dimension of the control points. */
+	size_t n_ctrlp_u; /**< Number of control points in direction u. */
+	size_t n_ctrlp_v; /**< Number of control points in direction v. */
+};
+
+/**
+ * Stores the private data of a ::tsMonotoneIndex. The struct is followed by
+ * the indexed component (a struct tsBSplineImpl of dimension 1 followed by
+ * its control points and knots), the knots of the samples
+ * (tsReal[n_samples]), the values of the samples (tsReal[n_samples]), and the
+ * index of the first sample of each bucket (size_t[n_buckets]), which is
+ * preceded by padding (cf. ts_int_monotone_index_sof_samples). The control
+ * points of the component and the sample values are multiplied with `sign',
+ * i.e., they are always ascending.
+ */
+struct tsMonotoneIndexImpl
+{
+	size_t n_samples; /**< Number of samples. */
+	size_t n_buckets; /**< Number of buckets. */
+	tsReal sign; /**< 1 if the component is ascending, -1 otherwise. */
+	tsReal scale; /**< Maps a value to its bucket. */
+};
+
+/**
+ * A node of the bounding volume hierarchy of a ::tsProjector. A node
+ * contains the Bezier segments [first, last]. Leaves contain exactly one
+ * segment and have no children.
+ */
+struct tsProjectorNode
+{
+	size_t first; /**< Index of the first segment. */
+	size_t last; /**< Index of the last segment (inclusive). */
+	size_t left; /**< Index of the left child. */
+	size_t right; /**< Index of the right child. */
+};
+
+/**
+ * Stores the private data of a ::tsProjector. The struct is followed by the
+ * nodes of the hierarchy (struct tsProjectorNode[n_nodes], the root comes
+ * first), the knots bounding the segments (tsReal[n_segments + 1]), the
+ * control points of the segments (tsReal[n_segments * order * dim]), and
+ * the bounding box of each node (tsReal[n_nodes * 2 * dim], the minimum
+ * followed by the maximum).
+ */
+struct tsProjectorImpl
+{
+	size_t dim; /**< Dimension of the control points. */
+	size_t order; /**< Order of the segments. */
+	size_t n_segments; /**< Number of Bezier segments. */
+	size_t n_nodes; /**< Number of nodes. */
+};
+
+/**
+ * Stores the private data of a ::tsArcLength. The struct is followed by the
+ * knots bounding the Bezier segments of the spline (tsReal[n_segments + 1]),
+ * the control points of the segments (tsReal[n_segments * order * dim]), the
+ * control points of the derivatives of the segments with respect to t
+ * (tsReal[n_segments * (order - 1) * dim]), and the arc length at the start
+ * of each integration step followed by the total length
+ * (tsReal[n_segments * n_steps + 1]).
+ */
+struct tsArcLengthImpl
+{
+	size_t dim; /**< Dimension of the control points. */
+	size_t order; /**< Order of the segments. */
+	size_t n_segments; /**< Number of Bezier segments. */
+	size_t n_steps; /**< Number of integration steps per segment. */
+};
+
+/**
+ * Stores the private data of a ::tsCatmullRomFitter. The struct is followed
+ * by the first control point of the Catmull-Rom sequence (tsReal[dim]) and
+ * the last (up to) four accepted points, the oldest first (tsReal[4 * dim]).
+ * The finished segments are stored in a separate buffer that grows
+ * geometrically.
+ */
+struct tsCatmullRomFitterImpl
+{
+	size_t dim; /**< Dimension of the points. */
+	tsReal alpha; /**< Knot parameterization, trimmed to [0, 1]. */
+	tsReal epsilon; /**< Distance of "same" points, sign removed. */
+	int has_first; /**< Whether the first control point is set. */
+	size_t n_points; /**< Number of accepted points. */
+	size_t n_finished; /**< Number of finished segments not taken yet. */
+	size_t cap; /**< Number of segments \p segments is able to store. */
+	tsReal *segments; /**< Control points of the finished segments. */
+};
+
+/**
+ * Stores the private data of a ::tsAlignmentPlan. The struct is followed by
+ * the index of the first affected control point of each aligned control point
+ * of both splines (size_t[2 * n_ctrlp]), the offsets of the weights of each
+ * aligned control point of both splines (size_t[2 * (n_ctrlp + 1)]), the
+ * knots of the splines the plan was created with
+ * (tsReal[n_knots[0] + n_knots[1]]), the knots of the aligned splines
+ * (tsReal[2 * (n_ctrlp + deg + 1)]), and the weights of both splines
+ * (tsReal[n_weights[0] + n_weights[1]]).
+ */
+struct tsAlignmentPlanImpl
+{
+	size_t deg; /**< Degree of the aligned splines. */
+	size_t n_ctrlp; /**< Number of control points of the aligned splines. */
+	size_t degs[2]; /**< Degree of the splines the plan was created with. */
+	size_t n_knots[2]; /**< Number of knots of these splines. */
+	size_t n_weights[2]; /**< Number of weights of both splines. */
+};
+
+/**
+ * Stores the private data of a ::tsMorphism.
+ */
+struct tsMorphismImpl
+{
+	tsBSpline start; /**< The start spline, aligned with `end'. */
+	tsBSpline end; /**< The end spline, aligned with `start'. */
+	tsReal epsilon; /**< Passed to ts_bspline_align. */
+	tsAlignmentPlan plan; /**< Created by ts_morphism_update. */
+};
+
+/**
+ * An entry of the index of a ::tsArchive.
+ */
+struct tsArchiveEntry
+{
+	size_t id; /**< Id of the spline. */
+	size_t offset; /**< File offset of the binary data of the spline. */
+	size_t size; /**< Number of bytes of the binary data. */
+};
+
+/**
+ * Stores the private data of a ::tsArchive. In contrast to the other data
+ * types, the state is not a single block of memory because the index of an
+ * archive grows with each appended spline.
+ */
+struct tsArchiveImpl
+{
+	FILE *file; /**< The archive file. */
+	struct tsArchiveEntry *entries; /**< The index (in memory). */
+	size_t n_entries; /**< Number of entries. */
+	size_t cap; /**< Capacity of `entries`. */
+	size_t end; /**< File offset of the next appended spline. */
+	int sorted; /**< Whether `entries` is sorted by id. */
+	int dirty; /**< Whether the index must be written. */
 };
 
 
@@ -64,6 +486,153 @@ struct tsDeBoorNetImpl
 * :: Forward Declarations & Internal Utility Functions                        *
 *                                                                             *
 ******************************************************************************/
+void *ts_int_std_allocate(void *data, size_t size)
+{
+	(void) data;
+	return malloc(size);
+}
+
+void *ts_int_std_reallocate(void *data, void *ptr, size_t size)
+{
+	(void) data;
+	return realloc(ptr, size);
+}
+
+void ts_int_std_deallocate(void *data, void *ptr)
+{
+	(void) data;
+	free(ptr);
+}
+
+/**
+ * The allocator used by all functions of TinySpline (including parson).
+ */
+tsAllocator ts_int_allocator = {
+	ts_int_std_allocate,
+	ts_int_std_reallocate,
+	ts_int_std_deallocate,
+	NULL
+};
+
+#ifdef TINYSPLINE_ENABLE_STATS
+/**
+ * The statistics of all functions (cf. ::ts_stats_snapshot).
+ */
+tsStats ts_int_stats;
+
+/**
+ * The number of active calls of each group of functions. Only the outermost
+ * call of a group is recorded.
+ */
+size_t ts_int_stats_depth[TS_STATS_NUM_FUNCTIONS];
+
+/**
+ * The callbacks of the statistics (cf. ::ts_set_stats_hooks).
+ */
+tsStatsHooks ts_int_stats_hooks = { NULL, NULL, NULL, NULL };
+
+/**
+ * The state of a recorded call (cf. ts_int_stats_begin and
+ * ts_int_stats_end).
+ */
+struct ts_int_stats_scope
+{
+	tsStatsFunction function;
+	const char *name;     /**< Name of the called function. */
+	double begin;         /**< Time at which the call began. */
+	size_t bytes;         /**< ts_int_stats.bytes at that time. */
+	size_t knot_searches; /**< ts_int_stats.knot_searches at that time. */
+};
+
+double ts_int_stats_clock()
+{
+	if (ts_int_stats_hooks.clock)
+		return ts_int_stats_hooks.clock(ts_int_stats_hooks.data);
+	return (double) clock() / CLOCKS_PER_SEC;
+}
+
+void ts_int_stats_begin(tsStatsFunction function, const char *name,
+	struct ts_int_stats_scope *scope)
+{
+	scope->function = function;
+	scope->name = name;
+	if (ts_int_stats_depth[function]++ > 0)
+		return;
+	if (ts_int_stats_hooks.begin)
+		ts_int_stats_hooks.begin(ts_int_stats_hooks.data, name);
+	scope->bytes = ts_int_stats.bytes;
+	scope->knot_searches = ts_int_stats.knot_searches;
+	scope->begin = ts_int_stats_clock();
+}
+
+void ts_int_stats_end(const struct ts_int_stats_scope *scope)
+{
+	tsStatsCounters *counters = ts_int_stats.functions + scope->function;
+	if (--ts_int_stats_depth[scope->function] > 0)
+		return;
+	counters->seconds += ts_int_stats_clock() - scope->begin;
+	counters->calls++;
+	counters->bytes += ts_int_stats.bytes - scope->bytes;
+	counters->knot_searches += ts_int_stats.knot_searches -
+		scope->knot_searches;
+	if (ts_int_stats_hooks.end)
+		ts_int_stats_hooks.end(ts_int_stats_hooks.data, scope->name);
+}
+
+/* Adds `num' to the field `field' of ts_int_stats. */
+#define TS_INT_STATS_ADD(field, num) ts_int_stats.field += (num);
+
+/* Records the call `call' of the function `name' of the group `function'
+ * (without prefix TS_STATS_) and returns its error code. */
+#define TS_INT_STATS_CALL(function, name, call)                 \
+{                                                               \
+	struct ts_int_stats_scope scope;                        \
+	tsError err;                                            \
+	ts_int_stats_begin(TS_STATS_ ## function, name, &scope); \
+	err = (call);                                           \
+	ts_int_stats_end(&scope);                               \
+	return err;                                             \
+}
+
+/* The name of the uninstrumented version of the function `name'. */
+#define TS_INT_STATS_IMPL(name) ts_int_stats_ ## name
+#else
+#define TS_INT_STATS_ADD(field, num)
+#define TS_INT_STATS_IMPL(name) name
+#endif
+
+void *ts_int_malloc(size_t size)
+{
+	TS_INT_STATS_ADD(bytes, size)
+	TS_INT_STATS_ADD(allocations, 1)
+	return ts_int_allocator.allocate(ts_int_allocator.data, size);
+}
+
+void *ts_int_realloc(void *ptr, size_t size)
+{
+	TS_INT_STATS_ADD(bytes, size)
+	TS_INT_STATS_ADD(allocations, 1)
+	return ts_int_allocator.reallocate(ts_int_allocator.data, ptr, size);
+}
+
+void ts_int_free(void *ptr)
+{
+	ts_int_allocator.deallocate(ts_int_allocator.data, ptr);
+}
+
+/**
+ * Rounds \p size (in bytes) up to a multiple of sizeof(size_t), so that a
+ * struct tsBSplineImpl (or any other struct of size_t values) located \p size
+ * bytes after a properly aligned address is properly aligned as well. This
+ * is required if a struct follows a sequence of tsReal values, which, in
+ * builds with float precision, need not end at such an address.
+ */
+size_t ts_int_sof_aligned(size_t size)
+{
+	const size_t sof_size_t = sizeof(size_t);
+	return (size + sof_size_t - 1) / sof_size_t * sof_size_t;
+}
+
 void ts_int_bspline_init(tsBSpline *_spline_)
 {
 	_spline_->pImpl = NULL;
@@ -76,6 +645,82 @@ size_t ts_int_bspline_sof_state(const tsBSpline *spline)
 		ts_bspline_sof_knots(spline);
 }
 
+union tsBSplineHeader *ts_int_bspline_header(const tsBSpline *spline)
+{
+	return ((union tsBSplineHeader *) spline->pImpl) - 1;
+}
+
+size_t ts_int_bspline_capacity(const tsBSpline *spline)
+{
+	return ts_int_bspline_header(spline)->h.cap;
+}
+
+/**
+ * Allocates the state of \p spline such that it is able to store \p cap
+ * control point and knot values. The members of the state are not
+ * initialized.
+ */
+tsError ts_int_bspline_alloc(size_t cap, tsBSpline *spline, tsStatus *status)
+{
+	union tsBSplineHeader *header = (union tsBSplineHeader *)
+		ts_int_malloc(sizeof(union tsBSplineHeader) +
+			sizeof(struct tsBSplineImpl) + cap * sizeof(tsReal));
+	ts_int_bspline_init(spline);
+	if (!header)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	header->h.cap = cap;
+	header->h.cache = NULL;
+	spline->pImpl = (struct tsBSplineImpl *) (header + 1);
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Changes the capacity of the state of \p spline to \p cap control point
+ * and knot values. The values are kept, but the state is not validated, i.e.,
+ * \p cap must not be less than the number of values in use. If reallocation
+ * fails, \p spline is not modified.
+ */
+tsError ts_int_bspline_realloc(tsBSpline *spline, size_t cap,
+	tsStatus *status)
+{
+	union tsBSplineHeader *header = (union tsBSplineHeader *)
+		ts_int_realloc(ts_int_bspline_header(spline),
+			sizeof(union tsBSplineHeader) +
+			sizeof(struct tsBSplineImpl) + cap * sizeof(tsReal));
+	if (!header)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	header->h.cap = cap;
+	spline->pImpl = (struct tsBSplineImpl *) (header + 1);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsBSpline * ts_int_bspline_cache_access_derivs(
+	const struct tsBSplineCache *cache)
+{
+	return (tsBSpline *) (& cache[1]);
+}
+
+/**
+ * Frees the cached derivatives of \p spline (if any). Must be called by all
+ * functions modifying the control points or knots of an existing spline.
+ */
+void ts_int_bspline_drop_cache(tsBSpline *spline)
+{
+	union tsBSplineHeader *header;
+	tsBSpline *derivs;
+	size_t i;
+	if (!spline->pImpl)
+		return;
+	header = ts_int_bspline_header(spline);
+	if (!header->h.cache)
+		return;
+	derivs = ts_int_bspline_cache_access_derivs(header->h.cache);
+	for (i = 0; i < header->h.cache->num; i++)
+		ts_bspline_free(derivs + i);
+	ts_int_free(header->h.cache);
+	header->h.cache = NULL;
+}
+
 tsReal * ts_int_bspline_access_ctrlp(const tsBSpline *spline)
 {
 	return (tsReal *) (& spline->pImpl[1]);
@@ -121,9 +766,9 @@ void ts_int_deboornet_init(tsDeBoorNet *_deBoorNet_)
 
 size_t ts_int_deboornet_sof_state(const tsDeBoorNet *net)
 {
+	/* The result is always a subset of the points. */
 	return sizeof(struct tsDeBoorNetImpl) +
-		ts_deboornet_sof_points(net) +
-		ts_deboornet_sof_result(net);
+		ts_deboornet_sof_points(net);
 }
 
 tsReal * ts_int_deboornet_access_points(const tsDeBoorNet *net)
@@ -145,51 +790,516 @@ tsReal * ts_int_deboornet_access_result(const tsDeBoorNet *net)
 
 
 
-/******************************************************************************
-*                                                                             *
-* :: Field Access Functions                                                   *
-*                                                                             *
-******************************************************************************/
-size_t ts_bspline_degree(const tsBSpline *spline)
+void ts_int_alignment_plan_init(tsAlignmentPlan *_plan_)
 {
-	return spline->pImpl->deg;
+	_plan_->pImpl = NULL;
 }
 
-size_t ts_bspline_order(const tsBSpline *spline)
+/**
+ * Returns the offset (in bytes) of the knots of a plan storing \p n_ctrlp
+ * aligned control points. Rounded up so that the knots are properly aligned.
+ */
+size_t ts_int_alignment_plan_sof_indices(size_t n_ctrlp)
 {
-	return ts_bspline_degree(spline) + 1;
+	const size_t sof_real = sizeof(tsReal);
+	const size_t size = sizeof(struct tsAlignmentPlanImpl) +
+		(4 * n_ctrlp + 2) * sizeof(size_t);
+	return (size + sof_real - 1) / sof_real * sof_real;
 }
 
-size_t ts_bspline_dimension(const tsBSpline *spline)
+size_t ts_int_alignment_plan_sof_state(const struct tsAlignmentPlanImpl *impl)
 {
-	return spline->pImpl->dim;
+	return ts_int_alignment_plan_sof_indices(impl->n_ctrlp) +
+		(impl->n_knots[0] + impl->n_knots[1] +
+		2 * (impl->n_ctrlp + impl->deg + 1) +
+		impl->n_weights[0] + impl->n_weights[1]) * sizeof(tsReal);
 }
 
-size_t ts_bspline_len_control_points(const tsBSpline *spline)
+size_t * ts_int_alignment_plan_access_firsts(const tsAlignmentPlan *plan,
+	size_t side)
 {
-	return ts_bspline_num_control_points(spline) *
-		ts_bspline_dimension(spline);
+	return (size_t *) (& plan->pImpl[1]) + side * plan->pImpl->n_ctrlp;
 }
 
-size_t ts_bspline_num_control_points(const tsBSpline *spline)
+size_t * ts_int_alignment_plan_access_offsets(const tsAlignmentPlan *plan,
+	size_t side)
 {
-	return spline->pImpl->n_ctrlp;
+	return (size_t *) (& plan->pImpl[1]) + 2 * plan->pImpl->n_ctrlp +
+		side * (plan->pImpl->n_ctrlp + 1);
 }
 
-size_t ts_bspline_sof_control_points(const tsBSpline *spline)
+tsReal * ts_int_alignment_plan_access_knots(const tsAlignmentPlan *plan,
+	size_t side)
 {
-	return ts_bspline_len_control_points(spline) * sizeof(tsReal);
+	return (tsReal *) ((char *) plan->pImpl +
+		ts_int_alignment_plan_sof_indices(plan->pImpl->n_ctrlp)) +
+		(side ? plan->pImpl->n_knots[0] : 0);
 }
 
-tsError ts_bspline_control_points(const tsBSpline *spline, tsReal **ctrlp,
-	tsStatus *status)
+tsReal * ts_int_alignment_plan_access_aligned(const tsAlignmentPlan *plan,
+	size_t side)
 {
-	const size_t size = ts_bspline_sof_control_points(spline);
-	*ctrlp = (tsReal*) malloc(size);
-	if (!*ctrlp)
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
-	memcpy(*ctrlp, ts_int_bspline_access_ctrlp(spline), size);
-	TS_RETURN_SUCCESS(status)
+	const struct tsAlignmentPlanImpl *impl = plan->pImpl;
+	return ts_int_alignment_plan_access_knots(plan, 0) +
+		impl->n_knots[0] + impl->n_knots[1] +
+		side * (impl->n_ctrlp + impl->deg + 1);
+}
+
+tsReal * ts_int_alignment_plan_access_weights(const tsAlignmentPlan *plan,
+	size_t side)
+{
+	const struct tsAlignmentPlanImpl *impl = plan->pImpl;
+	return ts_int_alignment_plan_access_aligned(plan, 0) +
+		2 * (impl->n_ctrlp + impl->deg + 1) +
+		(side ? impl->n_weights[0] : 0);
+}
+
+void ts_int_morphism_init(tsMorphism *_morphism_)
+{
+	_morphism_->pImpl = NULL;
+}
+
+void ts_int_sampling_plan_init(tsSamplingPlan *_plan_)
+{
+	_plan_->pImpl = NULL;
+}
+
+/**
+ * Returns the offset (in bytes) of the knots of a plan storing \p n_points
+ * knot values. Rounded up so that the knots are properly aligned.
+ */
+size_t ts_int_sampling_plan_sof_firsts(size_t n_points)
+{
+	const size_t sof_real = sizeof(tsReal);
+	const size_t size = sizeof(struct tsSamplingPlanImpl) +
+		n_points * sizeof(size_t);
+	return (size + sof_real - 1) / sof_real * sof_real;
+}
+
+size_t ts_int_sampling_plan_sof_state(const tsSamplingPlan *plan)
+{
+	const struct tsSamplingPlanImpl *impl = plan->pImpl;
+	return ts_int_sampling_plan_sof_firsts(impl->n_points) +
+		(impl->n_knots + impl->n_points * (impl->deg + 1)) *
+		sizeof(tsReal);
+}
+
+size_t * ts_int_sampling_plan_access_firsts(const tsSamplingPlan *plan)
+{
+	return (size_t *) (& plan->pImpl[1]);
+}
+
+tsReal * ts_int_sampling_plan_access_knots(const tsSamplingPlan *plan)
+{
+	return (tsReal *) ((char *) plan->pImpl +
+		ts_int_sampling_plan_sof_firsts(plan->pImpl->n_points));
+}
+
+tsReal * ts_int_sampling_plan_access_weights(const tsSamplingPlan *plan)
+{
+	return ts_int_sampling_plan_access_knots(plan) +
+		plan->pImpl->n_knots;
+}
+
+void ts_int_compiled_spline_init(tsCompiledSpline *_compiled_)
+{
+	_compiled_->pImpl = NULL;
+}
+
+size_t ts_int_compiled_spline_sof_state(
+	const struct tsCompiledSplineImpl *impl)
+{
+	return sizeof(struct tsCompiledSplineImpl) +
+		(2 * impl->n_spans + 1 +
+		impl->n_spans * (impl->deg + 1) * impl->dim +
+		impl->n_ctrlp * impl->dim + impl->n_knots) * sizeof(tsReal);
+}
+
+tsReal * ts_int_compiled_spline_access_breaks(
+	const tsCompiledSpline *compiled)
+{
+	return (tsReal *) (& compiled->pImpl[1]);
+}
+
+tsReal * ts_int_compiled_spline_access_scales(
+	const tsCompiledSpline *compiled)
+{
+	return ts_int_compiled_spline_access_breaks(compiled) +
+		compiled->pImpl->n_spans + 1;
+}
+
+tsReal * ts_int_compiled_spline_access_coeffs(
+	const tsCompiledSpline *compiled)
+{
+	return ts_int_compiled_spline_access_scales(compiled) +
+		compiled->pImpl->n_spans;
+}
+
+tsReal * ts_int_compiled_spline_access_ctrlp(
+	const tsCompiledSpline *compiled)
+{
+	const struct tsCompiledSplineImpl *impl = compiled->pImpl;
+	return ts_int_compiled_spline_access_coeffs(compiled) +
+		impl->n_spans * (impl->deg + 1) * impl->dim;
+}
+
+tsReal * ts_int_compiled_spline_access_knots(
+	const tsCompiledSpline *compiled)
+{
+	return ts_int_compiled_spline_access_ctrlp(compiled) +
+		compiled->pImpl->n_ctrlp * compiled->pImpl->dim;
+}
+
+void ts_int_monotone_index_init(tsMonotoneIndex *_index_)
+{
+	_index_->pImpl = NULL;
+}
+
+size_t ts_int_monotone_index_sof_component(size_t n_ctrlp, size_t n_knots)
+{
+	return sizeof(struct tsBSplineImpl) +
+		(n_ctrlp + n_knots) * sizeof(tsReal);
+}
+
+/**
+ * Returns the size (in bytes) of the component and the samples of an index.
+ * Rounded up so that the subsequent buckets are properly aligned.
+ */
+size_t ts_int_monotone_index_sof_samples(size_t n_ctrlp, size_t n_knots,
+	size_t n_samples)
+{
+	return ts_int_sof_aligned(
+		ts_int_monotone_index_sof_component(n_ctrlp, n_knots) +
+		n_samples * 2 * sizeof(tsReal));
+}
+
+size_t ts_int_monotone_index_sof_state(const tsMonotoneIndex *index)
+{
+	const struct tsBSplineImpl *component =
+		(const struct tsBSplineImpl *) (& index->pImpl[1]);
+	return sizeof(struct tsMonotoneIndexImpl) +
+		ts_int_monotone_index_sof_samples(component->n_ctrlp,
+			component->n_knots, index->pImpl->n_samples) +
+		index->pImpl->n_buckets * sizeof(size_t);
+}
+
+/**
+ * Sets up \p component such that it can be passed to the functions that do
+ * not access the header of a spline (cf. union tsBSplineHeader).
+ * \p component must not be freed.
+ */
+void ts_int_monotone_index_access_component(const tsMonotoneIndex *index,
+	tsBSpline *component)
+{
+	component->pImpl = (struct tsBSplineImpl *) (& index->pImpl[1]);
+}
+
+tsReal * ts_int_monotone_index_access_us(const tsMonotoneIndex *index)
+{
+	tsBSpline component;
+	ts_int_monotone_index_access_component(index, &component);
+	return (tsReal *) ((char *) component.pImpl +
+		ts_int_monotone_index_sof_component(
+			component.pImpl->n_ctrlp, component.pImpl->n_knots));
+}
+
+tsReal * ts_int_monotone_index_access_fs(const tsMonotoneIndex *index)
+{
+	return ts_int_monotone_index_access_us(index) +
+		index->pImpl->n_samples;
+}
+
+size_t * ts_int_monotone_index_access_buckets(const tsMonotoneIndex *index)
+{
+	tsBSpline component;
+	ts_int_monotone_index_access_component(index, &component);
+	return (size_t *) ((char *) component.pImpl +
+		ts_int_monotone_index_sof_samples(component.pImpl->n_ctrlp,
+			component.pImpl->n_knots, index->pImpl->n_samples));
+}
+
+void ts_int_projector_init(tsProjector *_projector_)
+{
+	_projector_->pImpl = NULL;
+}
+
+size_t ts_int_projector_sof_state(size_t dim, size_t order,
+	size_t n_segments)
+{
+	const size_t n_nodes = 2 * n_segments - 1;
+	return sizeof(struct tsProjectorImpl) +
+		n_nodes * sizeof(struct tsProjectorNode) +
+		(n_segments + 1 + n_segments * order * dim +
+			n_nodes * 2 * dim) * sizeof(tsReal);
+}
+
+struct tsProjectorNode * ts_int_projector_access_nodes(
+	const tsProjector *projector)
+{
+	return (struct tsProjectorNode *) (& projector->pImpl[1]);
+}
+
+tsReal * ts_int_projector_access_bounds(const tsProjector *projector)
+{
+	return (tsReal *) (ts_int_projector_access_nodes(projector) +
+		projector->pImpl->n_nodes);
+}
+
+tsReal * ts_int_projector_access_ctrlp(const tsProjector *projector)
+{
+	return ts_int_projector_access_bounds(projector) +
+		projector->pImpl->n_segments + 1;
+}
+
+tsReal * ts_int_projector_access_boxes(const tsProjector *projector)
+{
+	const struct tsProjectorImpl *impl = projector->pImpl;
+	return ts_int_projector_access_ctrlp(projector) +
+		impl->n_segments * impl->order * impl->dim;
+}
+
+void ts_int_arc_length_init(tsArcLength *_table_)
+{
+	_table_->pImpl = NULL;
+}
+
+size_t ts_int_arc_length_sof_state(size_t dim, size_t order,
+	size_t n_segments, size_t n_steps)
+{
+	return sizeof(struct tsArcLengthImpl) +
+		(n_segments + 1 + n_segments * order * dim +
+			n_segments * (order - 1) * dim +
+			n_segments * n_steps + 1) * sizeof(tsReal);
+}
+
+tsReal * ts_int_arc_length_access_bounds(const tsArcLength *table)
+{
+	return (tsReal *) (& table->pImpl[1]);
+}
+
+tsReal * ts_int_arc_length_access_ctrlp(const tsArcLength *table)
+{
+	return ts_int_arc_length_access_bounds(table) +
+		table->pImpl->n_segments + 1;
+}
+
+tsReal * ts_int_arc_length_access_derivs(const tsArcLength *table)
+{
+	const struct tsArcLengthImpl *impl = table->pImpl;
+	return ts_int_arc_length_access_ctrlp(table) +
+		impl->n_segments * impl->order * impl->dim;
+}
+
+tsReal * ts_int_arc_length_access_lengths(const tsArcLength *table)
+{
+	const struct tsArcLengthImpl *impl = table->pImpl;
+	return ts_int_arc_length_access_derivs(table) +
+		impl->n_segments * (impl->order - 1) * impl->dim;
+}
+
+void ts_int_catmull_rom_fitter_init(tsCatmullRomFitter *_fitter_)
+{
+	_fitter_->pImpl = NULL;
+}
+
+size_t ts_int_catmull_rom_fitter_sof_state(size_t dim)
+{
+	return sizeof(struct tsCatmullRomFitterImpl) +
+		5 * dim * sizeof(tsReal);
+}
+
+tsReal * ts_int_catmull_rom_fitter_access_first(
+	const tsCatmullRomFitter *fitter)
+{
+	return (tsReal *) (& fitter->pImpl[1]);
+}
+
+tsReal * ts_int_catmull_rom_fitter_access_window(
+	const tsCatmullRomFitter *fitter)
+{
+	return ts_int_catmull_rom_fitter_access_first(fitter) +
+		fitter->pImpl->dim;
+}
+
+void ts_int_spline_pool_init(tsSplinePool *_pool_)
+{
+	_pool_->pImpl = NULL;
+}
+
+/**
+ * Returns the size (in bytes) of the control points of a pool. Rounded up so
+ * that the struct tsBSplineImpl preceding the knots of the first spline is
+ * properly aligned.
+ */
+size_t ts_int_spline_pool_sof_ctrlp(const struct tsSplinePoolImpl *impl)
+{
+	return ts_int_sof_aligned(impl->n_ctrlp * impl->dim *
+		impl->n_splines * sizeof(tsReal));
+}
+
+/**
+ * Returns the size (in bytes) of the knots of a spline of a pool, including
+ * the preceding struct tsBSplineImpl. Rounded up so that the struct
+ * tsBSplineImpl of the next spline is properly aligned.
+ */
+size_t ts_int_spline_pool_sof_knots(const struct tsSplinePoolImpl *impl)
+{
+	return ts_int_sof_aligned(sizeof(struct tsBSplineImpl) +
+		impl->n_knots * sizeof(tsReal));
+}
+
+size_t ts_int_spline_pool_sof_state(const struct tsSplinePoolImpl *impl)
+{
+	return sizeof(struct tsSplinePoolImpl) +
+		ts_int_spline_pool_sof_ctrlp(impl) +
+		impl->n_splines * ts_int_spline_pool_sof_knots(impl);
+}
+
+tsReal * ts_int_spline_pool_access_ctrlp(const tsSplinePool *pool)
+{
+	return (tsReal *) (& pool->pImpl[1]);
+}
+
+/**
+ * Sets up \p basis such that it can be passed to the functions that read the
+ * degree and knots of a spline only (e.g., ts_bspline_domain and
+ * ts_int_bspline_eval_basis). \p basis must not be freed.
+ */
+void ts_int_spline_pool_access_basis(const tsSplinePool *pool, size_t index,
+	tsBSpline *basis)
+{
+	const struct tsSplinePoolImpl *impl = pool->pImpl;
+	char *knots = (char *) ts_int_spline_pool_access_ctrlp(pool) +
+		ts_int_spline_pool_sof_ctrlp(impl);
+	basis->pImpl = (struct tsBSplineImpl *) (knots +
+		index * ts_int_spline_pool_sof_knots(impl));
+}
+
+void ts_int_bspline_surface_init(tsBSplineSurface *_surface_)
+{
+	_surface_->pImpl = NULL;
+}
+
+/**
+ * Returns the size (in bytes) of the control points of a surface. Rounded up
+ * so that the struct tsBSplineImpl preceding the knots of direction u is
+ * properly aligned.
+ */
+size_t ts_int_bspline_surface_sof_ctrlp(
+	const struct tsBSplineSurfaceImpl *impl)
+{
+	return ts_int_sof_aligned(impl->n_ctrlp_u * impl->n_ctrlp_v *
+		impl->dim * sizeof(tsReal));
+}
+
+/**
+ * Returns the size (in bytes) of the knots of direction u of a surface,
+ * including the preceding struct tsBSplineImpl. Rounded up so that the
+ * struct tsBSplineImpl of direction v is properly aligned.
+ */
+size_t ts_int_bspline_surface_sof_knots_u(
+	const struct tsBSplineSurfaceImpl *impl)
+{
+	return ts_int_sof_aligned(sizeof(struct tsBSplineImpl) +
+		(impl->n_ctrlp_u + impl->deg_u + 1) * sizeof(tsReal));
+}
+
+size_t ts_int_bspline_surface_sof_state(
+	const struct tsBSplineSurfaceImpl *impl)
+{
+	return sizeof(struct tsBSplineSurfaceImpl) +
+		ts_int_bspline_surface_sof_ctrlp(impl) +
+		ts_int_bspline_surface_sof_knots_u(impl) +
+		sizeof(struct tsBSplineImpl) +
+		(impl->n_ctrlp_v + impl->deg_v + 1) * sizeof(tsReal);
+}
+
+tsReal * ts_int_bspline_surface_access_ctrlp(
+	const tsBSplineSurface *surface)
+{
+	return (tsReal *) (& surface->pImpl[1]);
+}
+
+/**
+ * Sets up \p basis such that it can be passed to the functions that read the
+ * degree and knots of a spline only (cf. ts_int_spline_pool_access_basis).
+ * \p dir is 0 for direction u and 1 for direction v. \p basis must not be
+ * freed.
+ */
+void ts_int_bspline_surface_access_basis(const tsBSplineSurface *surface,
+	int dir, tsBSpline *basis)
+{
+	const struct tsBSplineSurfaceImpl *impl = surface->pImpl;
+	char *knots = (char *) ts_int_bspline_surface_access_ctrlp(surface) +
+		ts_int_bspline_surface_sof_ctrlp(impl);
+	if (dir)
+		knots += ts_int_bspline_surface_sof_knots_u(impl);
+	basis->pImpl = (struct tsBSplineImpl *) knots;
+}
+
+/* Defined in the query functions. */
+tsError ts_int_bspline_eval_basis(const tsBSpline *spline, tsReal u,
+	size_t *cursor, size_t *fst, tsReal *weights, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Field Access Functions                                                   *
+*                                                                             *
+******************************************************************************/
+size_t ts_bspline_degree(const tsBSpline *spline)
+{
+	return spline->pImpl->deg;
+}
+
+size_t ts_bspline_order(const tsBSpline *spline)
+{
+	return ts_bspline_degree(spline) + 1;
+}
+
+size_t ts_bspline_dimension(const tsBSpline *spline)
+{
+	return spline->pImpl->dim;
+}
+
+size_t ts_bspline_len_control_points(const tsBSpline *spline)
+{
+	return ts_bspline_num_control_points(spline) *
+		ts_bspline_dimension(spline);
+}
+
+size_t ts_bspline_num_control_points(const tsBSpline *spline)
+{
+	return spline->pImpl->n_ctrlp;
+}
+
+size_t ts_bspline_sof_control_points(const tsBSpline *spline)
+{
+	return ts_bspline_len_control_points(spline) * sizeof(tsReal);
+}
+
+size_t ts_bspline_capacity(const tsBSpline *spline)
+{
+	/* Each control point requires dim values and a knot. */
+	return (ts_int_bspline_capacity(spline) - ts_bspline_order(spline)) /
+		(ts_bspline_dimension(spline) + 1);
+}
+
+tsError ts_bspline_control_points(const tsBSpline *spline, tsReal **ctrlp,
+	tsStatus *status)
+{
+	const size_t size = ts_bspline_sof_control_points(spline);
+	*ctrlp = (tsReal*) ts_int_malloc(size);
+	if (!*ctrlp)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(*ctrlp, ts_int_bspline_access_ctrlp(spline), size);
+	TS_RETURN_SUCCESS(status)
+}
+
+const tsReal *ts_bspline_control_points_ptr(const tsBSpline *spline)
+{
+	return ts_int_bspline_access_ctrlp(spline);
 }
 
 tsError ts_bspline_control_point_at(const tsBSpline *spline, size_t index,
@@ -202,7 +1312,7 @@ tsError ts_bspline_control_point_at(const tsBSpline *spline, size_t index,
 		TS_CALL(try, err, ts_int_bspline_access_ctrlp_at(
 			spline, index, &from, status))
 		size = ts_bspline_dimension(spline) * sizeof(tsReal);
-		*ctrlp = (tsReal*) malloc(size);
+		*ctrlp = (tsReal*) ts_int_malloc(size);
 		if (!*ctrlp) {
 			TS_THROW_0(try, err, status, TS_MALLOC,
 				"out of memory")
@@ -217,6 +1327,7 @@ tsError ts_bspline_set_control_points(tsBSpline *spline, const tsReal *ctrlp,
 	tsStatus *status)
 {
 	const size_t size = ts_bspline_sof_control_points(spline);
+	ts_int_bspline_drop_cache(spline);
 	memmove(ts_int_bspline_access_ctrlp(spline), ctrlp, size);
 	TS_RETURN_SUCCESS(status)
 }
@@ -231,6 +1342,7 @@ tsError ts_bspline_set_control_point_at(tsBSpline *spline, size_t index,
 		TS_CALL(try, err, ts_int_bspline_access_ctrlp_at(
 			spline, index, &to, status))
 		size = ts_bspline_dimension(spline) * sizeof(tsReal);
+		ts_int_bspline_drop_cache(spline);
 		memcpy(to, ctrlp, size);
 	TS_END_TRY_RETURN(err)
 }
@@ -249,23 +1361,32 @@ tsError ts_bspline_knots(const tsBSpline *spline, tsReal **knots,
 	tsStatus *status)
 {
 	const size_t size = ts_bspline_sof_knots(spline);
-	*knots = (tsReal*) malloc(size);
+	*knots = (tsReal*) ts_int_malloc(size);
 	if (!*knots)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	memcpy(*knots, ts_int_bspline_access_knots(spline), size);
 	TS_RETURN_SUCCESS(status)
 }
 
+const tsReal *ts_bspline_knots_ptr(const tsBSpline *spline)
+{
+	return ts_int_bspline_access_knots(spline);
+}
+
 tsError ts_bspline_knot_at(const tsBSpline *spline, size_t index, tsReal *knot,
 	tsStatus *status)
 {
 	return ts_int_bspline_access_knot_at(spline, index, knot, status);
 }
 
-tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
-	tsStatus *status)
+/**
+ * Checks whether \p knots is a valid knot vector for \p spline, that is,
+ * \p knots is not decreasing and the multiplicity of each knot is less than
+ * or equal to the order of \p spline.
+ */
+tsError ts_int_bspline_check_knots(const tsBSpline *spline,
+	const tsReal *knots, tsStatus *status)
 {
-	const size_t size = ts_bspline_sof_knots(spline);
 	const size_t num_knots = ts_bspline_num_knots(spline);
 	const size_t order = ts_bspline_order(spline);
 	size_t idx, mult;
@@ -281,7 +1402,7 @@ tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
 				"decreasing knot vector at index: %lu",
 				(unsigned long) idx)
 		} else {
-			mult = 0;
+			mult = 1;
 		}
 		if (mult > order) {
 			TS_RETURN_3(status, TS_MULTIPLICITY,
@@ -291,6 +1412,16 @@ tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
 		}
 		lst_knot = knot;
 	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
+	tsStatus *status)
+{
+	const size_t size = ts_bspline_sof_knots(spline);
+	tsError err;
+	TS_CALL_ROE(err, ts_int_bspline_check_knots(spline, knots, status))
+	ts_int_bspline_drop_cache(spline);
 	memmove(ts_int_bspline_access_knots(spline), knots, size);
 	TS_RETURN_SUCCESS(status)
 }
@@ -318,7 +1449,7 @@ tsError TINYSPLINE_API ts_bspline_set_knots_varargs(tsBSpline *spline,
 			spline, values, status))
 	TS_FINALLY
 		if (values)
-			free(values);
+			ts_int_free(values);
 	TS_END_TRY_RETURN(err)
 }
 
@@ -392,13 +1523,18 @@ tsError ts_deboornet_points(const tsDeBoorNet *net, tsReal **points,
 	tsStatus *status)
 {
 	const size_t size = ts_deboornet_sof_points(net);
-	*points = (tsReal*) malloc(size);
+	*points = (tsReal*) ts_int_malloc(size);
 	if (!*points)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	memcpy(*points, ts_int_deboornet_access_points(net), size);
 	TS_RETURN_SUCCESS(status)
 }
 
+const tsReal *ts_deboornet_points_ptr(const tsDeBoorNet *net)
+{
+	return ts_int_deboornet_access_points(net);
+}
+
 size_t ts_deboornet_len_result(const tsDeBoorNet *net)
 {
 	return ts_deboornet_num_result(net) * ts_deboornet_dimension(net);
@@ -418,13 +1554,18 @@ tsError ts_deboornet_result(const tsDeBoorNet *net, tsReal **result,
 	tsStatus *status)
 {
 	const size_t size = ts_deboornet_sof_result(net);
-	*result = (tsReal*) malloc(size);
+	*result = (tsReal*) ts_int_malloc(size);
 	if (!*result)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	memcpy(*result, ts_int_deboornet_access_result(net), size);
 	TS_RETURN_SUCCESS(status)
 }
 
+const tsReal *ts_deboornet_result_ptr(const tsDeBoorNet *net)
+{
+	return ts_int_deboornet_access_result(net);
+}
+
 
 
 /******************************************************************************
@@ -492,12 +1633,6 @@ tsError ts_bspline_new(size_t num_control_points, size_t dimension,
 	const size_t order = degree + 1;
 	const size_t num_knots = num_control_points + order;
 	const size_t len_ctrlp = num_control_points * dimension;
-
-	const size_t sof_real = sizeof(tsReal);
-	const size_t sof_impl = sizeof(struct tsBSplineImpl);
-	const size_t sof_ctrlp_vec = len_ctrlp * sof_real;
-	const size_t sof_knots_vec = num_knots * sof_real;
-	const size_t sof_spline = sof_impl + sof_ctrlp_vec + sof_knots_vec;
 	tsError err;
 
 	ts_int_bspline_init(spline);
@@ -507,8 +1642,9 @@ tsError ts_bspline_new(size_t num_control_points, size_t dimension,
 	}
 	if (num_knots > TS_MAX_NUM_KNOTS) {
 		TS_RETURN_2(status, TS_NUM_KNOTS,
-			"unsupported number of knots: %lu > %i",
-			(unsigned long) num_knots, TS_MAX_NUM_KNOTS)
+			"unsupported number of knots: %lu > %lu",
+			(unsigned long) num_knots,
+			(unsigned long) TS_MAX_NUM_KNOTS)
 	}
 	if (degree >= num_control_points) {
 		TS_RETURN_2(status, TS_DEG_GE_NCTRLP,
@@ -517,10 +1653,8 @@ tsError ts_bspline_new(size_t num_control_points, size_t dimension,
 			(unsigned long) num_control_points)
 	}
 
-	spline->pImpl = (struct tsBSplineImpl *) malloc(sof_spline);
-	if (!spline->pImpl)
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
-
+	TS_CALL_ROE(err, ts_int_bspline_alloc(
+		len_ctrlp + num_knots, spline, status))
 	spline->pImpl->deg = degree;
 	spline->pImpl->dim = dimension;
 	spline->pImpl->n_ctrlp = num_control_points;
@@ -565,15 +1699,13 @@ tsError TINYSPLINE_API ts_bspline_new_with_control_points(
 tsError ts_bspline_copy(const tsBSpline *src, tsBSpline *dest,
 	tsStatus *status)
 {
-	size_t size;
+	const size_t len = ts_bspline_len_control_points(src) +
+		ts_bspline_num_knots(src);
+	tsError err;
 	if (src == dest)
 		TS_RETURN_SUCCESS(status)
-	ts_int_bspline_init(dest);
-	size = ts_int_bspline_sof_state(src);
-	dest->pImpl = (struct tsBSplineImpl *) malloc(size);
-	if (!dest->pImpl)
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
-	memcpy(dest->pImpl, src->pImpl, size);
+	TS_CALL_ROE(err, ts_int_bspline_alloc(len, dest, status))
+	memcpy(dest->pImpl, src->pImpl, ts_int_bspline_sof_state(src));
 	TS_RETURN_SUCCESS(status)
 }
 
@@ -587,11 +1719,36 @@ void ts_bspline_move(tsBSpline *src, tsBSpline *dest)
 
 void ts_bspline_free(tsBSpline *spline)
 {
+	ts_int_bspline_drop_cache(spline);
 	if (spline->pImpl)
-		free(spline->pImpl);
+		ts_int_free(ts_int_bspline_header(spline));
 	ts_int_bspline_init(spline);
 }
 
+tsError ts_bspline_reserve(tsBSpline *spline, size_t num_control_points,
+	tsStatus *status)
+{
+	const size_t num_knots = num_control_points +
+		ts_bspline_order(spline);
+	if (num_control_points <= ts_bspline_capacity(spline))
+		TS_RETURN_SUCCESS(status)
+	if (num_knots > TS_MAX_NUM_KNOTS) {
+		TS_RETURN_2(status, TS_NUM_KNOTS,
+			"unsupported number of knots: %lu > %lu",
+			(unsigned long) num_knots,
+			(unsigned long) TS_MAX_NUM_KNOTS)
+	}
+	return ts_int_bspline_realloc(spline, num_control_points *
+		ts_bspline_dimension(spline) + num_knots, status);
+}
+
+tsError ts_bspline_shrink_to_fit(tsBSpline *spline, tsStatus *status)
+{
+	return ts_int_bspline_realloc(spline,
+		ts_bspline_len_control_points(spline) +
+		ts_bspline_num_knots(spline), status);
+}
+
 /* ------------------------------------------------------------------------- */
 
 tsDeBoorNet ts_deboornet_init()
@@ -601,22 +1758,27 @@ tsDeBoorNet ts_deboornet_init()
 	return net;
 }
 
+size_t ts_int_deboornet_num_points_max(const tsBSpline *spline)
+{
+	const size_t order = ts_bspline_order(spline);
+	const size_t num_points = order * (order+1) / 2;
+	/* Handle case order == 1 which generates too few points. */
+	return num_points < 2 ? 2 : num_points;
+}
+
 tsError ts_int_deboornet_new(const tsBSpline *spline, tsDeBoorNet *net,
 	tsStatus *status)
 {
 	const size_t dim = ts_bspline_dimension(spline);
 	const size_t deg = ts_bspline_degree(spline);
-	const size_t order = ts_bspline_order(spline);
-	const size_t num_points = (size_t)(order * (order+1) * 0.5f);
-	/* Handle case order == 1 which generates too few points. */
-	const size_t fixed_num_points = num_points < 2 ? 2 : num_points;
+	const size_t fixed_num_points = ts_int_deboornet_num_points_max(spline);
 
 	const size_t sof_real = sizeof(tsReal);
 	const size_t sof_impl = sizeof(struct tsDeBoorNetImpl);
 	const size_t sof_points_vec = fixed_num_points * dim * sof_real;
-	const size_t sof_net = sof_impl * sof_points_vec;
+	const size_t sof_net = sof_impl + sof_points_vec;
 
-	net->pImpl = (struct tsDeBoorNetImpl *) malloc(sof_net);
+	net->pImpl = (struct tsDeBoorNetImpl *) ts_int_malloc(sof_net);
 	if (!net->pImpl)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 
@@ -626,13 +1788,14 @@ tsError ts_int_deboornet_new(const tsBSpline *spline, tsDeBoorNet *net,
 	net->pImpl->h = deg;
 	net->pImpl->dim = dim;
 	net->pImpl->n_points = fixed_num_points;
+	net->pImpl->cap = fixed_num_points * dim;
 	TS_RETURN_SUCCESS(status)
 }
 
 void ts_deboornet_free(tsDeBoorNet *net)
 {
 	if (net->pImpl)
-		free(net->pImpl);
+		ts_int_free(net->pImpl);
 	ts_int_deboornet_init(net);
 }
 
@@ -643,11 +1806,14 @@ tsError ts_deboornet_copy(const tsDeBoorNet *src, tsDeBoorNet *dest,
 	if (src == dest)
 		TS_RETURN_SUCCESS(status)
 	ts_int_deboornet_init(dest);
+	if (!src->pImpl)
+		TS_RETURN_SUCCESS(status)
 	size = ts_int_deboornet_sof_state(src);
-	dest->pImpl = (struct tsDeBoorNetImpl *) malloc(size);
+	dest->pImpl = (struct tsDeBoorNetImpl *) ts_int_malloc(size);
 	if (!dest->pImpl)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	memcpy(dest->pImpl, src->pImpl, size);
+	dest->pImpl->cap = ts_deboornet_len_points(dest);
 	TS_RETURN_SUCCESS(status)
 }
 
@@ -666,72 +1832,81 @@ void ts_deboornet_move(tsDeBoorNet *src, tsDeBoorNet *dest)
 * :: Interpolation and Approximation Functions                                *
 *                                                                             *
 ******************************************************************************/
-tsError ts_int_thomas_algorithm(const tsReal *a, const tsReal *b,
-	const tsReal *c, size_t num, size_t dim, tsReal *d, tsStatus *status)
+/**
+ * Computes the factors of the LU decomposition of the tridiagonal system
+ * [1 4 1] solved by ts_int_cubic_natural_solve and returns the number of
+ * factors stored in \p factors. The factors of the remaining rows are equal
+ * to the last one. Since the system does not depend on the points to be
+ * interpolated, the factorization is shared by all dimensions and series.
+ */
+size_t ts_int_cubic_natural_factors(tsReal *factors)
 {
-	size_t i, j, k, l;
-	tsReal m, *cc = NULL;
-	tsError err;
-
-	if (dim == 0) {
-		TS_RETURN_0(status, TS_DIM_ZERO,
-			"unsupported dimension: 0")
-	}
-	if (num <= 1) {
-		TS_RETURN_1(status, TS_NUM_POINTS,
-			"num(points) (%lu) <= 1", (unsigned long) num)
+	size_t i;
+	factors[0] = (tsReal) 0.25;
+	for (i = 1; i < TS_INT_CUBIC_NATURAL_NUM_FACTORS; i++) {
+		factors[i] = (tsReal) 1.0 / ((tsReal) 4.0 - factors[i-1]);
+		if (!(factors[i] < factors[i-1]) &&
+			!(factors[i] > factors[i-1]))
+			break;
 	}
-	cc = (tsReal *) malloc(num * sizeof(tsReal));
-	if (!cc) TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	return i;
+}
 
-	TS_TRY(try, err, status)
-		/* Forward sweep. */
-		if (fabs(b[0]) <= fabs(c[0])) {
-			TS_THROW_2(try, err, status, TS_NO_RESULT,
-				"error: |%f| <= |%f|", b[0], c[0])
-		}
-		/* |b[i]| > |c[i]| implies that |b[i]| > 0. Thus, the following
-		 * statements cannot evaluate to division by zero.*/
-		cc[0] = c[0] / b[0];
-		for (i = 0; i < dim; i++)
-			d[i] = d[i] / b[0];
-		for (i = 1; i < num; i++) {
-			if (fabs(b[i]) <= fabs(a[i]) + fabs(c[i])) {
-				TS_THROW_3(try, err, status, TS_NO_RESULT,
-					"error: |%f| <= |%f| + |%f|",
-					b[i], a[i], c[i])
-			}
-			/* |a[i]| < |b[i]| and cc[i - 1] < 1. Therefore, the
-			 * following statement cannot evaluate to division by
-			 * zero. */
-			m = 1.f / (b[i] - a[i] * cc[i - 1]);
-			/* |b[i]| > |a[i]| + |c[i]| implies that there must be
-			 * an eps > 0 such that |b[i]| = |a[i]| + |c[i]| + eps.
-			 * Even if |a[i]| is 0 (by which the result of the
-			 * following statement becomes maximum), |c[i]| is less
-			 * than |b[i]| by an amount of eps. By substituting the
-			 * previous and the following statements (under the
-			 * assumption that |a[i]| is 0), we obtain c[i] / b[i],
-			 * which must be less than 1. */
-			cc[i] = c[i] * m;
-			for (j = 0; j < dim; j++) {
-				k = i * dim + j;
-				l = (i-1) * dim + j;
-				d[k] = (d[k] - a[i] * d[l]) * m;
-			}
-		}
-
-		/* Back substitution. */
-		for (i = num-1; i > 0; i--) {
-			for (j = 0; j < dim; j++) {
-				k = (i-1) * dim + j;
-				l = i * dim + j;
-				d[k] -= cc[i-1] * d[l];
-			}
+/**
+ * Computes the control points \p ctrlp of the relaxed uniform cubic spline
+ * (cf. ts_int_relaxed_uniform_cubic_bspline) interpolating the \p n points
+ * \p points of dimension \p dim. The first and last control point are the
+ * first and last point. The inner control points are the solution of the
+ * system of linear equations
+ *
+ *     ctrlp[i-1] + 4 * ctrlp[i] + ctrlp[i+1] = 6 * points[i]
+ *
+ * which is solved in a single forward and backward sweep over the values
+ * (Thomas algorithm). Apart from the factors of the system, no additional
+ * memory is needed. \p ctrlp may be equal to \p points.
+ */
+void ts_int_cubic_natural_solve(const tsReal *points, size_t n, size_t dim,
+	tsReal *ctrlp)
+{
+	tsReal factors[TS_INT_CUBIC_NATURAL_NUM_FACTORS];
+	const size_t num_factors = ts_int_cubic_natural_factors(factors);
+	const size_t m = n - 2; /**< Number of inner points. */
+	const tsReal *last = points + (n-1) * dim;
+	tsReal value, factor;
+	size_t i, j;
+
+	memmove(ctrlp, points, dim * sizeof(tsReal));
+	if (n < 2)
+		return;
+	memmove(ctrlp + (n-1) * dim, last, dim * sizeof(tsReal));
+	if (n == 2)
+		return;
+	/* The system of linear equations is taken from:
+	 *     http://www.bakoma-tex.com/doc/generic/pst-bspline/
+	 *     pst-bspline-doc.pdf */
+	/* Forward sweep. Row i is stored in ctrlp[i+1] after reading
+	 * points[i+1], which allows \p ctrlp to be equal to \p points. */
+	for (i = 0; i < m; i++) {
+		factor = factors[i < num_factors ? i : num_factors - 1];
+		for (j = 0; j < dim; j++) {
+			value = 6 * points[(i+1) * dim + j];
+			if (i == 0)
+				value -= ctrlp[j];
+			if (i == m - 1)
+				value -= last[j];
+			if (i > 0)
+				value -= ctrlp[i * dim + j];
+			ctrlp[(i+1) * dim + j] = value * factor;
 		}
-	TS_FINALLY
-		free(cc);
-	TS_END_TRY_RETURN(err)
+	}
+	/* Back substitution. */
+	for (i = m - 1; i > 0; i--) {
+		factor = factors[i-1 < num_factors ? i-1 : num_factors - 1];
+		for (j = 0; j < dim; j++) {
+			ctrlp[i * dim + j] -=
+				factor * ctrlp[(i+1) * dim + j];
+		}
+	}
 }
 
 tsError ts_int_relaxed_uniform_cubic_bspline(const tsReal *points, size_t n,
@@ -767,7 +1942,7 @@ tsError ts_int_relaxed_uniform_cubic_bspline(const tsReal *points, size_t n,
 			(n-1)*4, dim, order-1, TS_BEZIERS, spline, status))
 		ctrlp = ts_int_bspline_access_ctrlp(spline);
 
-		s = (tsReal*) malloc(n * sof_ctrlp);
+		s = (tsReal*) ts_int_malloc(n * sof_ctrlp);
 		if (!s) {
 			TS_THROW_0(try, err, status, TS_MALLOC,
 				"out of memory")
@@ -805,7 +1980,7 @@ tsError ts_int_relaxed_uniform_cubic_bspline(const tsReal *points, size_t n,
 		ts_bspline_free(spline);
 	TS_FINALLY
 		if (s)
-			free(s);
+			ts_int_free(s);
 	TS_END_TRY_RETURN(err)
 }
 
@@ -814,14 +1989,13 @@ tsError ts_bspline_interpolate_cubic_natural(const tsReal *points,
 	tsStatus *status)
 {
 	const size_t sof_ctrlp = dimension * sizeof(tsReal);
-	const size_t len_points = num_points * dimension;
-	const size_t num_int_points = num_points - 2;
-	const size_t len_int_points = num_int_points * dimension;
-	tsReal *thomas, *a, *b, *c, *d;
-	size_t i, j, k, l;
+	tsReal *ctrlp;
+	size_t i;
 	tsError err;
 
 	ts_int_bspline_init(spline);
+	if (dimension == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
 	if (num_points == 0)
 		TS_RETURN_0(status, TS_NUM_POINTS, "num(points) == 0")
 	if (num_points == 1) {
@@ -838,60 +2012,170 @@ tsError ts_bspline_interpolate_cubic_natural(const tsReal *points,
 			points, num_points, dimension, spline, status);
 	}
 	/* `num_points` >= 3 */
-	thomas = NULL;
-	TS_TRY(try, err, status)
-		thomas = (tsReal *) malloc(3 * num_int_points * sof_ctrlp);
-		if (!thomas) {
-			TS_THROW_0(try, err, status, TS_MALLOC,
-				"out of memory")
-		}
-		/* The system of linear equations is taken from:
-		 *     http://www.bakoma-tex.com/doc/generic/pst-bspline/
-		 *     pst-bspline-doc.pdf */
-		a = c = thomas;
-		ts_arr_fill(a, len_int_points, 1);
-		b = a + len_int_points;
-		ts_arr_fill(b, len_int_points, 4);
-		d = b + len_int_points;
-		/* 6 * S_{i+1} */
-		for (i = 0; i < num_int_points; i++) {
-			for (j = 0; j < dimension; j++) {
-				k = i * dimension + j;
-				l = (i+1) * dimension + j;
-				d[k] = 6 * points[l];
-			}
-		}
-		for (i = 0; i < dimension; i++) {
-			/* 6 * S_{1} - S_{0} */
-			d[i] -= points[i];
-			/* 6 * S_{n-1} - S_{n} */
-			k = len_int_points - (i+1);
-			l = len_points - (i+1);
-			d[k] -= points[l];
-		}
-		/* The Thomas algorithm requires at least two points. Hence,
-		 * `num_int_points` == 1 must be handled separately (let's call
-		 * it "Mini Thomas"). */
-		if (num_int_points == 1) {
-			for (i = 0; i < dimension; i++)
-				d[i] *= (tsReal) 0.25f;
-		} else {
-			TS_CALL(try, err, ts_int_thomas_algorithm(
-				a, b, c, num_int_points, dimension, d,
-				status))
+	ctrlp = (tsReal *) ts_int_malloc(num_points * sof_ctrlp);
+	if (!ctrlp)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	ts_int_cubic_natural_solve(points, num_points, dimension, ctrlp);
+	err = ts_int_relaxed_uniform_cubic_bspline(
+		ctrlp, num_points, dimension, spline, status);
+	ts_int_free(ctrlp);
+	return err;
+}
+
+/**
+ * The context shared by the tasks of ts_cubic_natural_solve_columns.
+ */
+struct ts_int_cubic_natural_task_context
+{
+	const tsReal *points;
+	size_t num_points;  /**< Number of points per series. */
+	size_t num_series;  /**< Total number of series. */
+	size_t grain_size;  /**< Number of series per task. */
+	tsReal *ctrlp;      /**< Output of all tasks. */
+};
+
+/**
+ * Solves the \p index'th chunk of ts_int_cubic_natural_task_context (cf.
+ * ::tsTask).
+ */
+void ts_int_cubic_natural_task(void *context, size_t index)
+{
+	const struct ts_int_cubic_natural_task_context *ctx =
+		(const struct ts_int_cubic_natural_task_context *) context;
+	const size_t n = ctx->num_points;
+	const size_t begin = index * ctx->grain_size;
+	const size_t end = ctx->num_series - begin < ctx->grain_size
+		? ctx->num_series : begin + ctx->grain_size;
+	size_t i;
+	for (i = begin; i < end; i++) {
+		ts_int_cubic_natural_solve(ctx->points + i * n, n, 1,
+			ctx->ctrlp + i * n);
+	}
+}
+
+tsError ts_cubic_natural_solve_columns(const tsReal *points,
+	size_t num_points, size_t num_series, tsReal *ctrlp,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status)
+{
+	struct ts_int_cubic_natural_task_context ctx;
+	size_t num_tasks, i;
+	if (num_series == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	if (num_points == 0)
+		TS_RETURN_0(status, TS_NUM_POINTS, "num(points) == 0")
+	if (grain_size == 0) {
+		grain_size = TS_INT_GRAIN_SIZE / num_points;
+		if (grain_size == 0)
+			grain_size = 1;
+	}
+	num_tasks = (num_series - 1) / grain_size + 1;
+	ctx.points = points;
+	ctx.num_points = num_points;
+	ctx.num_series = num_series;
+	ctx.grain_size = grain_size;
+	ctx.ctrlp = ctrlp;
+	if (executor) {
+		executor(executor_data, num_tasks,
+			ts_int_cubic_natural_task, &ctx);
+	} else {
+		for (i = 0; i < num_tasks; i++)
+			ts_int_cubic_natural_task(&ctx, i);
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_cubic_natural_to_beziers(const tsReal *ctrlp, size_t num_points,
+	size_t num_series, size_t first, size_t num_segments, tsReal *beziers,
+	tsStatus *status)
+{
+	const tsReal as = 1.f/6.f; /**< The value 'a sixth'. */
+	const tsReal at = 1.f/3.f; /**< The value 'a third'. */
+	const tsReal tt = 2.f/3.f; /**< The value 'two third'. */
+	const size_t num_segs = num_points < 2 ? 0 : num_points - 1;
+	const tsReal *b;           /**< Control points of a series. */
+	tsReal *out;               /**< First value of a segment. */
+	tsReal s;                  /**< Start of a segment. */
+	size_t i, j, k;            /**< Used in for loops. */
+
+	if (num_series == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	if (first > num_segs || num_segments > num_segs - first) {
+		TS_RETURN_3(status, TS_INDEX_ERROR,
+			"segments [%lu, %lu) exceed num(segments) (%lu)",
+			(unsigned long) first,
+			(unsigned long) (first + num_segments),
+			(unsigned long) num_segs)
+	}
+	for (j = 0; j < num_series; j++) {
+		b = ctrlp + j * num_points;
+		for (k = 0; k < num_segments; k++) {
+			i = first + k;
+			out = beziers + k * 4 * num_series + j;
+			/* Same as in ts_int_relaxed_uniform_cubic_bspline. */
+			if (i == 0) {
+				s = b[0];
+			} else {
+				s = as * b[i-1];
+				s += tt * b[i];
+				s += as * b[i+1];
+			}
+			out[0] = s;
+			out[num_series] = tt*b[i] + at*b[i+1];
+			out[2*num_series] = at*b[i] + tt*b[i+1];
+			if (i + 1 == num_segs) {
+				s = b[i+1];
+			} else {
+				s = as * b[i];
+				s += tt * b[i+1];
+				s += as * b[i+2];
+			}
+			out[3*num_series] = s;
 		}
-		memcpy(thomas, points, sof_ctrlp);
-		memmove(thomas + dimension, d, num_int_points * sof_ctrlp);
-		memcpy(thomas + (num_int_points+1) * dimension,
-			points + (num_points-1) * dimension, sof_ctrlp);
-		TS_CALL(try, err, ts_int_relaxed_uniform_cubic_bspline(
-			thomas, num_points, dimension, spline, status))
-	TS_CATCH(err)
-		ts_bspline_free(spline);
-	TS_FINALLY
-		if (thomas)
-			free(thomas);
-	TS_END_TRY_RETURN(err)
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Translates the Catmull-Rom segment between \p p1 and \p p2 (with the
+ * neighbours \p p0 and \p p3) into a cubic Bezier curve and stores its four
+ * control points in \p out. \p alpha is the knot parameterization (cf.
+ * ts_bspline_interpolate_catmull_rom). Each value of \p p3 is read before
+ * the corresponding value of the last control point is written, that is,
+ * \p p3 may point to the last control point of \p out.
+ */
+void ts_int_catmull_rom_segment(const tsReal *p0, const tsReal *p1,
+	const tsReal *p2, const tsReal *p3, size_t dimension, tsReal alpha,
+	tsReal *out)
+{
+	/* [https://en.wikipedia.org/wiki/
+	 * Centripetal_Catmull%E2%80%93Rom_spline] */
+	tsReal t0, t1, t2, t3; /**< Catmull-Rom knots. */
+	/* [https://stackoverflow.com/questions/30748316/
+	 * catmull-rom-interpolation-on-svg-paths/30826434#30826434] */
+	tsReal c1, c2, d1, d2, m1, m2; /**< Used to calculate derivatives. */
+	size_t d; /**< Used in for loops. */
+
+	t0 = (tsReal) 0.f;
+	t1 = t0 + (tsReal) pow(ts_distance(p0, p1, dimension), alpha);
+	t2 = t1 + (tsReal) pow(ts_distance(p1, p2, dimension), alpha);
+	t3 = t2 + (tsReal) pow(ts_distance(p2, p3, dimension), alpha);
+
+	c1 = (t2-t1) / (t2-t0);
+	c2 = (t1-t0) / (t2-t0);
+	d1 = (t3-t2) / (t3-t1);
+	d2 = (t2-t1) / (t3-t1);
+
+	for (d = 0; d < dimension; d++) {
+		m1 = (t2-t1)*(c1*(p1[d]-p0[d])/(t1-t0)
+			+ c2*(p2[d]-p1[d])/(t2-t1));
+		m2 = (t2-t1)*(d1*(p2[d]-p1[d])/(t2-t1)
+			+ d2*(p3[d]-p2[d])/(t3-t2));
+		out[(0 * dimension) + d] = p1[d];
+		out[(1 * dimension) + d] = p1[d] + m1/3;
+		out[(2 * dimension) + d] = p2[d] - m2/3;
+		out[(3 * dimension) + d] = p2[d];
+	}
 }
 
 tsError ts_bspline_interpolate_catmull_rom(const tsReal *points,
@@ -906,13 +2190,7 @@ tsError ts_bspline_interpolate_catmull_rom(const tsReal *points,
 	tsReal *cr_ctrlp; /**< The points to interpolate based on `points`. */
 	size_t i, d; /**< Used in for loops. */
 	tsError err; /**< Local error handling. */
-	/* [https://en.wikipedia.org/wiki/
-	 * Centripetal_Catmull%E2%80%93Rom_spline] */
-	tsReal t0, t1, t2, t3; /**< Catmull-Rom knots. */
-	/* [https://stackoverflow.com/questions/30748316/
-	 * catmull-rom-interpolation-on-svg-paths/30826434#30826434] */
-	tsReal c1, c2, d1, d2, m1, m2; /**< Used to calculate derivatives. */
-	tsReal *p0, *p1, *p2, *p3; /**< Processed Catmull-Rom points. */
+	tsReal *p0, *p1; /**< Processed Catmull-Rom points. */
 
 	ts_int_bspline_init(spline);
 	if (dimension == 0)
@@ -931,33 +2209,27 @@ tsError ts_bspline_interpolate_catmull_rom(const tsReal *points,
 	if (alpha > 1.f)
 		alpha = (tsReal) 1.f;
 
-	/* Copy `points` to `cr_ctrlp`. Add space for `first` and `last`. */
-	cr_ctrlp = (tsReal *) malloc((num_points + 2) * sof_ctrlp);
+	/* Copy `points` to `cr_ctrlp`. Add space for `first` and `last`.
+	 * Redundant points are skipped while copying (single pass). Update
+	 * `num_points`. */
+	cr_ctrlp = (tsReal *) ts_int_malloc((num_points + 2) * sof_ctrlp);
 	if (!cr_ctrlp)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
-	memcpy(cr_ctrlp + dimension, points, num_points * sof_ctrlp);
-
-	/* Remove redundant points from `cr_ctrlp`. Update `num_points`. */
-	for (i = 1 /* 0 (`first`) is not assigned yet */;
-			i < num_points /* skip last point (inclusive end) */;
-			i++) {
-		p0 = cr_ctrlp + (i * dimension);
-		p1 = p0 + dimension;
-		if (ts_distance(p0, p1, dimension) <= eps) {
-			/* Are there any other points (after the one that is
-			 * to be removed) that need to be shifted? */
-			if (i < num_points - 1) {
-				memmove(p1, p1 + dimension,
-					(num_points - (i + 1)) * sof_ctrlp);
-			}
-			num_points--;
-			i--;
+	p0 = cr_ctrlp + dimension; /* 0 (`first`) is not assigned yet */
+	memcpy(p0, points, sof_ctrlp);
+	for (i = 1, d = 1; i < num_points; i++) {
+		p1 = (tsReal *) points + (i * dimension);
+		if (ts_distance(p0, p1, dimension) > eps) {
+			p0 += dimension;
+			memcpy(p0, p1, sof_ctrlp);
+			d++;
 		}
 	}
+	num_points = d;
 
 	/* Check if there are still enough points for interpolation. */
 	if (num_points == 1) { /* `num_points` can't be 0 */
-		free(cr_ctrlp); /* The point is copied from `points`. */
+		ts_int_free(cr_ctrlp); /* The point is copied from `points`. */
 		TS_CALL_ROE(err, ts_bspline_new(num_points, dimension,
 			num_points - 1, TS_CLAMPED, spline, status))
 		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
@@ -995,39 +2267,399 @@ tsError ts_bspline_interpolate_catmull_rom(const tsReal *points,
 			TS_BEZIERS, spline, status))
 		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
 	TS_CATCH(err)
-		free(cr_ctrlp);
+		ts_int_free(cr_ctrlp);
 	TS_END_TRY_ROE(err)
 	for (i = 0; i < ts_bspline_num_control_points(spline) / 4; i++) {
-		p0 = cr_ctrlp + ((i+0) * dimension);
-		p1 = cr_ctrlp + ((i+1) * dimension);
-		p2 = cr_ctrlp + ((i+2) * dimension);
-		p3 = cr_ctrlp + ((i+3) * dimension);
+		ts_int_catmull_rom_segment(
+			cr_ctrlp + ((i+0) * dimension),
+			cr_ctrlp + ((i+1) * dimension),
+			cr_ctrlp + ((i+2) * dimension),
+			cr_ctrlp + ((i+3) * dimension),
+			dimension, alpha, bs_ctrlp + (i*4 * dimension));
+	}
+	ts_int_free(cr_ctrlp);
+	TS_RETURN_SUCCESS(status)
+}
+
+
+/**
+ * Computes the chord length parameterization of the \p num points \p points
+ * (\p num >= 2), mapped to the default domain of splines. If all points are
+ * equal, a uniform parameterization is computed.
+ */
+void ts_int_approximate_params(const tsReal *points, size_t num, size_t dim,
+	tsReal *params)
+{
+	const tsReal min = (tsReal) TS_DOMAIN_DEFAULT_MIN;
+	const tsReal max = (tsReal) TS_DOMAIN_DEFAULT_MAX;
+	tsReal total = 0;
+	size_t i;
+	params[0] = 0;
+	for (i = 1; i < num; i++) {
+		total += ts_distance(points + (i-1) * dim, points + i * dim,
+			dim);
+		params[i] = total;
+	}
+	for (i = 1; i < num - 1; i++) {
+		if (total > 0)
+			params[i] = min + (max - min) * (params[i] / total);
+		else
+			params[i] = min + (max - min) * i / (num - 1);
+	}
+	params[0] = min;
+	params[num - 1] = max;
+}
+
+/**
+ * Places the inner knots of the clamped spline \p spline by averaging
+ * \p params such that each knot span contains at least one parameter (see
+ * equations 9.68 and 9.69 of "The NURBS Book"). This guarantees that the
+ * normal equations of ts_int_approximate_fit are positive definite.
+ */
+void ts_int_approximate_knots(const tsReal *params, size_t num_points,
+	tsBSpline *spline)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const tsReal d = (tsReal) num_points / (n_ctrlp - deg);
+	tsReal *knots = ts_int_bspline_access_knots(spline);
+	tsReal a;
+	size_t i, j;
+	for (j = 1; j < n_ctrlp - deg; j++) {
+		i = (size_t) (j * d);
+		a = j * d - i;
+		knots[deg + j] = (1 - a) * params[i-1] + a * params[i];
+	}
+}
 
-		t0 = (tsReal) 0.f;
-		t1 = t0 + (tsReal) pow(ts_distance(p0, p1, dimension), alpha);
-		t2 = t1 + (tsReal) pow(ts_distance(p1, p2, dimension), alpha);
-		t3 = t2 + (tsReal) pow(ts_distance(p2, p3, dimension), alpha);
+/**
+ * Solves the symmetric positive definite system of linear equations whose
+ * lower half-band (of width \p bw) is stored in \p band with the Cholesky
+ * decomposition, that is, band[i * (bw+1) + j] stores the value of row i and
+ * column i - j. The decomposition is stored in \p band. \p rhs stores the
+ * \p dim right-hand sides of the \p n equations (interleaved) and receives
+ * the solution.
+ */
+tsError ts_int_band_cholesky_solve(tsReal *band, size_t n, size_t bw,
+	tsReal *rhs, size_t dim, tsStatus *status)
+{
+	const size_t w = bw + 1;
+	size_t i, j, k, d, lo, hi;
+	tsReal sum;
+	for (i = 0; i < n; i++) {
+		lo = i > bw ? i - bw : 0;
+		for (j = lo; j <= i; j++) {
+			sum = band[i * w + (i-j)];
+			for (k = lo; k < j; k++)
+				sum -= band[i * w + (i-k)] * band[j * w + (j-k)];
+			if (j < i) {
+				band[i * w + (i-j)] = sum / band[j * w];
+			} else if (sum > 0) {
+				band[i * w] = (tsReal) sqrt(sum);
+			} else {
+				TS_RETURN_0(status, TS_NO_RESULT,
+					"not enough points per knot span")
+			}
+		}
+	}
+	/* Forward substitution. */
+	for (i = 0; i < n; i++) {
+		lo = i > bw ? i - bw : 0;
+		for (d = 0; d < dim; d++) {
+			sum = rhs[i * dim + d];
+			for (k = lo; k < i; k++)
+				sum -= band[i * w + (i-k)] * rhs[k * dim + d];
+			rhs[i * dim + d] = sum / band[i * w];
+		}
+	}
+	/* Back substitution. */
+	for (i = n; i-- > 0;) {
+		hi = i + bw < n - 1 ? i + bw : n - 1;
+		for (d = 0; d < dim; d++) {
+			sum = rhs[i * dim + d];
+			for (k = i + 1; k <= hi; k++)
+				sum -= band[k * w + (k-i)] * rhs[k * dim + d];
+			rhs[i * dim + d] = sum / band[i * w];
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
 
-		c1 = (t2-t1) / (t2-t0);
-		c2 = (t1-t0) / (t2-t0);
-		d1 = (t3-t2) / (t3-t1);
-		d2 = (t2-t1) / (t3-t1);
+/**
+ * Returns the length of the workspace of ts_int_approximate_fit for splines
+ * with up to \p n_ctrlp control points.
+ */
+size_t ts_int_approximate_len_work(size_t n_ctrlp, size_t deg, size_t dim)
+{
+	const size_t n = n_ctrlp > 2 ? n_ctrlp - 2 : 0;
+	return n * (deg + 1) + n * dim + (deg + 1) + dim;
+}
 
-		for (d = 0; d < dimension; d++) {
-			m1 = (t2-t1)*(c1*(p1[d]-p0[d])/(t1-t0)
-				+ c2*(p2[d]-p1[d])/(t2-t1));
-			m2 = (t2-t1)*(d1*(p2[d]-p1[d])/(t2-t1)
-				+ d2*(p3[d]-p2[d])/(t3-t2));
-			bs_ctrlp[((i*4 + 0) * dimension) + d] = p1[d];
-			bs_ctrlp[((i*4 + 1) * dimension) + d] = p1[d] + m1/3;
-			bs_ctrlp[((i*4 + 2) * dimension) + d] = p2[d] - m2/3;
-			bs_ctrlp[((i*4 + 3) * dimension) + d] = p2[d];
+/**
+ * Computes the control points of \p spline (whose knots are set up already)
+ * that minimize the sum of the squared distances between the \p num_points
+ * points \p points and the points of \p spline at \p params. The first and
+ * last control point are fixed to the first and last point. Each parameter
+ * affects at most order(spline) control points, so the normal equations are
+ * banded with half-bandwidth degree(spline) and are solved in linear time.
+ */
+tsError ts_int_approximate_fit(const tsReal *points, const tsReal *params,
+	size_t num_points, tsBSpline *spline, tsReal *work, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const size_t n = n_ctrlp - 2; /**< Number of unknowns. */
+	const tsReal *last = points + (num_points - 1) * dim;
+	tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	tsReal *band = work;
+	tsReal *rhs = band + n * order;
+	tsReal *weights = rhs + n * dim;
+	tsReal *residual = weights + order;
+	size_t cursor = ts_bspline_num_knots(spline);
+	size_t fst, k, a, b, r, c, d;
+	tsError err;
+
+	memcpy(ctrlp, points, dim * sizeof(tsReal));
+	memcpy(ctrlp + (n_ctrlp - 1) * dim, last, dim * sizeof(tsReal));
+	if (n == 0)
+		TS_RETURN_SUCCESS(status)
+	ts_arr_fill(band, n * order + n * dim, 0);
+	for (k = 1; k < num_points - 1; k++) {
+		TS_CALL_ROE(err, ts_int_bspline_eval_basis(spline, params[k],
+			&cursor, &fst, weights, status))
+		/* Move the fixed control points to the right-hand side. */
+		memcpy(residual, points + k * dim, dim * sizeof(tsReal));
+		for (d = 0; d < dim; d++) {
+			if (fst == 0)
+				residual[d] -= weights[0] * points[d];
+			if (fst + order == n_ctrlp)
+				residual[d] -= weights[deg] * last[d];
+		}
+		for (a = 0; a < order; a++) {
+			if (fst + a == 0 || fst + a == n_ctrlp - 1)
+				continue;
+			r = fst + a - 1;
+			for (d = 0; d < dim; d++)
+				rhs[r * dim + d] += weights[a] * residual[d];
+			for (b = 0; b <= a; b++) {
+				if (fst + b == 0)
+					continue;
+				c = fst + b - 1;
+				band[r * order + (r-c)] +=
+					weights[a] * weights[b];
+			}
 		}
 	}
-	free(cr_ctrlp);
+	TS_CALL_ROE(err, ts_int_band_cholesky_solve(band, n, deg, rhs, dim,
+		status))
+	memcpy(ctrlp + dim, rhs, n * dim * sizeof(tsReal));
 	TS_RETURN_SUCCESS(status)
 }
 
+/**
+ * A knot span split by ts_bspline_approximate in error-driven mode.
+ */
+struct ts_int_approximate_split
+{
+	tsReal error; /**< Maximum distance of the points of the span. */
+	size_t span;  /**< Index of the span (0 is the first inner span). */
+	tsReal knot;  /**< The knot inserted into the span. */
+};
+
+int ts_int_approximate_split_cmp_error(const void *x, const void *y)
+{
+	const struct ts_int_approximate_split *a =
+		(const struct ts_int_approximate_split *) x;
+	const struct ts_int_approximate_split *b =
+		(const struct ts_int_approximate_split *) y;
+	/* Descending. */
+	return a->error > b->error ? -1 : a->error < b->error ? 1 : 0;
+}
+
+int ts_int_approximate_split_cmp_span(const void *x, const void *y)
+{
+	const struct ts_int_approximate_split *a =
+		(const struct ts_int_approximate_split *) x;
+	const struct ts_int_approximate_split *b =
+		(const struct ts_int_approximate_split *) y;
+	return a->span < b->span ? -1 : a->span > b->span ? 1 : 0;
+}
+
+/**
+ * Finds the knot spans of \p spline whose points are farther away from
+ * \p spline than \p tolerance and stores them (together with the knot
+ * splitting the points of each span in halves) in \p splits. Spans whose
+ * points cannot be split are skipped. Returns the number of splits.
+ */
+size_t ts_int_approximate_find_splits(const tsReal *points,
+	const tsReal *params, size_t num_points, const tsBSpline *spline,
+	tsReal tolerance, tsReal *work,
+	struct ts_int_approximate_split *splits)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t n_spans = ts_bspline_num_control_points(spline) - deg;
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	tsReal *weights = work;
+	tsReal *point = weights + order;
+	size_t cursor = ts_bspline_num_knots(spline);
+	size_t num = 0, span = 0, first = 0, k, j, d, fst, mid;
+	tsReal error, max_error = 0, lo, hi;
+
+	for (k = 0; k <= num_points; k++) {
+		if (k == num_points || (span + 1 < n_spans &&
+				!(params[k] < knots[deg + span + 1]))) {
+			/* The points [first, k) belong to `span'. */
+			mid = (first + k) / 2;
+			lo = knots[deg + span];
+			hi = knots[deg + span + 1];
+			if (max_error > tolerance && k - first >= 2 &&
+					!ts_knots_equal(params[mid], lo) &&
+					!ts_knots_equal(params[mid], hi)) {
+				splits[num].error = max_error;
+				splits[num].span = span;
+				splits[num].knot = params[mid];
+				num++;
+			}
+			if (k == num_points)
+				break;
+			while (span + 1 < n_spans &&
+					!(params[k] < knots[deg + span + 1]))
+				span++;
+			first = k;
+			max_error = 0;
+		}
+		/* Cannot fail: params[k] is within the domain. */
+		ts_int_bspline_eval_basis(spline, params[k], &cursor, &fst,
+			weights, NULL);
+		ts_arr_fill(point, dim, 0);
+		for (j = 0; j < order; j++) {
+			for (d = 0; d < dim; d++) {
+				point[d] += weights[j] *
+					ctrlp[(fst + j) * dim + d];
+			}
+		}
+		error = ts_distance(point, points + k * dim, dim);
+		if (error > max_error)
+			max_error = error;
+	}
+	return num;
+}
+
+tsError ts_bspline_approximate(const tsReal *points, size_t num_points,
+	size_t dimension, size_t num_control_points, size_t degree,
+	tsReal tolerance, tsBSpline *spline, tsStatus *status)
+{
+	const size_t order = degree + 1;
+	tsBSpline refined;
+	tsReal *params = NULL, *work = NULL, *from, *to;
+	struct ts_int_approximate_split *splits = NULL;
+	size_t n_ctrlp, num, i, j;
+	tsError err;
+
+	ts_int_bspline_init(spline);
+	ts_int_bspline_init(&refined);
+	if (dimension == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	if (degree >= num_control_points) {
+		TS_RETURN_2(status, TS_DEG_GE_NCTRLP,
+			"degree (%lu) >= num(control_points) (%lu)",
+			(unsigned long) degree,
+			(unsigned long) num_control_points)
+	}
+	if (num_control_points < 2) {
+		TS_RETURN_1(status, TS_NUM_POINTS,
+			"num(control_points) (%lu) < 2",
+			(unsigned long) num_control_points)
+	}
+	if (num_points < num_control_points) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"num(points) (%lu) < num(control_points) (%lu)",
+			(unsigned long) num_points,
+			(unsigned long) num_control_points)
+	}
+	n_ctrlp = num_control_points;
+	if (tolerance > 0)
+		n_ctrlp = order < 2 ? 2 : order;
+
+	TS_TRY(try, err, status)
+		params = (tsReal *) ts_int_malloc(num_points * sizeof(tsReal));
+		work = (tsReal *) ts_int_malloc(ts_int_approximate_len_work(
+			num_control_points, degree, dimension) *
+			sizeof(tsReal));
+		if (!params || !work) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		ts_int_approximate_params(points, num_points, dimension,
+			params);
+		TS_CALL(try, err, ts_bspline_new(n_ctrlp, dimension, degree,
+			TS_CLAMPED, spline, status))
+		ts_int_approximate_knots(params, num_points, spline);
+		TS_CALL(try, err, ts_int_bspline_check_knots(spline,
+			ts_int_bspline_access_knots(spline), status))
+		TS_CALL(try, err, ts_int_approximate_fit(points, params,
+			num_points, spline, work, status))
+		if (tolerance > 0) {
+			splits = (struct ts_int_approximate_split *)
+				ts_int_malloc((num_control_points - degree) *
+				sizeof(struct ts_int_approximate_split));
+			if (!splits) {
+				TS_THROW_0(try, err, status, TS_MALLOC,
+					"out of memory")
+			}
+		}
+		/* Error-driven mode: split the spans exceeding `tolerance'
+		 * (the worst first) until the budget is exhausted. */
+		while (tolerance > 0 && n_ctrlp < num_control_points) {
+			num = ts_int_approximate_find_splits(points, params,
+				num_points, spline, tolerance, work, splits);
+			if (num == 0)
+				break;
+			if (num > num_control_points - n_ctrlp) {
+				qsort(splits, num, sizeof(*splits),
+					ts_int_approximate_split_cmp_error);
+				num = num_control_points - n_ctrlp;
+			}
+			qsort(splits, num, sizeof(*splits),
+				ts_int_approximate_split_cmp_span);
+			TS_CALL(try, err, ts_bspline_new(n_ctrlp + num,
+				dimension, degree, TS_CLAMPED, &refined,
+				status))
+			/* Merge the knots of `spline' and `splits'. */
+			from = ts_int_bspline_access_knots(spline);
+			to = ts_int_bspline_access_knots(&refined);
+			for (i = 0, j = 0; i < n_ctrlp + order; i++) {
+				*to++ = from[i];
+				while (j < num && i == degree + splits[j].span)
+					*to++ = splits[j++].knot;
+			}
+			if (ts_int_approximate_fit(points, params, num_points,
+					&refined, work, NULL)) {
+				/* Keep the previous fit. */
+				ts_bspline_free(&refined);
+				break;
+			}
+			ts_bspline_free(spline);
+			ts_bspline_move(&refined, spline);
+			n_ctrlp += num;
+		}
+	TS_CATCH(err)
+		ts_bspline_free(spline);
+		ts_bspline_free(&refined);
+	TS_FINALLY
+		if (params)
+			ts_int_free(params);
+		if (work)
+			ts_int_free(work);
+		if (splits)
+			ts_int_free(splits);
+	TS_END_TRY_RETURN(err)
+}
 
 
 /******************************************************************************
@@ -1035,14 +2667,14 @@ tsError ts_bspline_interpolate_catmull_rom(const tsReal *points,
 * :: Query Functions                                                          *
 *                                                                             *
 ******************************************************************************/
-tsError ts_int_bspline_find_knot(const tsBSpline *spline, tsReal knot,
-	size_t *index, size_t *multiplicity, tsStatus *status)
+tsError ts_int_bspline_find_knot_from(const tsBSpline *spline, tsReal knot,
+	size_t hint, size_t *index, size_t *multiplicity, tsStatus *status)
 {
 	const size_t deg = ts_bspline_degree(spline);
 	const size_t num_knots = ts_bspline_num_knots(spline);
 	const tsReal *knots = ts_int_bspline_access_knots(spline);
 	tsReal min, max;
-	size_t low, high;
+	size_t low, high, step;
 
 	ts_bspline_domain(spline, &min, &max);
 	if (knot < min && !ts_knots_equal(knot, min)) {
@@ -1053,6 +2685,10 @@ tsError ts_int_bspline_find_knot(const tsBSpline *spline, tsReal knot,
 		TS_RETURN_2(status, TS_U_UNDEFINED,
 			"knot (%f) > max(domain) (%f)", knot, max)
 	}
+	/* Knots slightly below the domain would never satisfy the condition
+	 * of the binary search if knots[0] == min (e.g., clamped splines). */
+	if (knot < min)
+		knot = min;
 
 	/* Based on 'The NURBS Book' (Les Piegl and Wayne Tiller). */
 	if (ts_knots_equal(knot, knots[num_knots - 1])) {
@@ -1060,8 +2696,25 @@ tsError ts_int_bspline_find_knot(const tsBSpline *spline, tsReal knot,
 	} else {
 		low = 0;
 		high = num_knots - 1;
+		if (hint < num_knots - 1 && knots[hint] <= knot) {
+			/* Exponential search starting at `hint`. Finds the
+			 * index in amortized constant time if the knots to
+			 * search are passed in ascending order. Ensures that
+			 * knots[low] <= knot < knots[high]. */
+			low = hint;
+			step = 1;
+			high = low + step;
+			while (high < num_knots - 1 && knots[high] <= knot) {
+				TS_INT_STATS_ADD(knot_searches, 1)
+				low = high;
+				step *= 2;
+				high = low + step < num_knots - 1
+					? low + step : num_knots - 1;
+			}
+		}
 		*index = (low+high) / 2;
 		while (knot < knots[*index] || knot >= knots[*index + 1]) {
+			TS_INT_STATS_ADD(knot_searches, 1)
 			if (knot < knots[*index])
 				high = *index;
 			else
@@ -1085,6 +2738,14 @@ tsError ts_int_bspline_find_knot(const tsBSpline *spline, tsReal knot,
 	TS_RETURN_SUCCESS(status)
 }
 
+tsError ts_int_bspline_find_knot(const tsBSpline *spline, tsReal knot,
+	size_t *index, size_t *multiplicity, tsStatus *status)
+{
+	return ts_int_bspline_find_knot_from(spline, knot,
+		ts_bspline_num_knots(spline), /* no hint */
+		index, multiplicity, status);
+}
+
 tsError ts_int_bspline_eval_woa(const tsBSpline *spline, tsReal u,
 	tsDeBoorNet *net, tsStatus *status)
 {
@@ -1189,1336 +2850,9107 @@ tsError ts_int_bspline_eval_woa(const tsBSpline *spline, tsReal u,
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_eval(const tsBSpline *spline, tsReal u, tsDeBoorNet *net,
-	tsStatus *status)
+/**
+ * Evaluates \p spline at \p u and stores the resultant point in \p point.
+ * \p work must be able to store ts_bspline_order(spline) *
+ * ts_bspline_dimension(spline) values. If \p cursor is not NULL, it is used
+ * as search hint for the index of \p u (cf. ts_int_bspline_find_knot_from)
+ * and is updated with the index that has been found. Accordingly, passing
+ * the same cursor when evaluating knots in ascending order yields an
+ * amortized constant lookup time. A cursor without hint is initialized with
+ * ts_bspline_num_knots(spline).
+ */
+tsError ts_int_bspline_eval_point(const tsBSpline *spline, tsReal u,
+	size_t *cursor, tsReal *work, tsReal *point, tsStatus *status)
 {
-	tsError err;
-	ts_int_deboornet_init(net);
-	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_int_deboornet_new(
-			spline, net, status))
-		TS_CALL(try, err, ts_int_bspline_eval_woa(
-			spline, u, net, status))
-	TS_CATCH(err)
-		ts_deboornet_free(net);
-	TS_END_TRY_RETURN(err)
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_ctrlp = dim * sizeof(tsReal);
+
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+
+	size_t k;        /**< Index of \p u. */
+	size_t s;        /**< Multiplicity of \p u. */
+	size_t fst;      /**< First affected control point, inclusive. */
+	size_t N;        /**< Number of affected control points. */
+	size_t r, i, j, d;  /**< Used in for loop. */
+	tsReal ui;       /**< Knot value at index i. */
+	tsReal a, a_hat; /**< Weighting factors of control points. */
+	tsReal *lp, *rp; /**< Left and right point of the current step. */
+
+	tsError err;
+
+	k = s = 0;
+	TS_CALL_ROE(err, ts_int_bspline_find_knot_from(spline, u,
+		cursor ? *cursor : ts_bspline_num_knots(spline),
+		&k, &s, status))
+	if (cursor)
+		*cursor = k;
+	if (ts_knots_equal(u, knots[k]))
+		u = knots[k]; /* Same as in ts_int_bspline_eval_woa. */
+
+	if (s == order) {
+		/* Take the first of the two points k-s and k-s + 1. If k-s
+		 * doesn't exist (k == deg), take k-s + 1. */
+		memcpy(point, ctrlp + (k == deg ? 0 : (k-s) * dim), sof_ctrlp);
+		TS_RETURN_SUCCESS(status)
+	}
+
+	/* De Boor's algorithm (s <= deg). In contrast to
+	 * ts_int_bspline_eval_woa, each level of the net overwrites the
+	 * previous one. Iterating from back to front ensures that the left
+	 * point of the current step has not been overwritten yet. */
+	fst = k-deg;
+	N = k-s - fst + 1;
+	memcpy(work, ctrlp + fst*dim, N * sof_ctrlp);
+	for (r = 1; r <= deg-s; r++) {
+		for (j = N-1; j >= r; j--) {
+			i = fst + j;
+			ui = knots[i];
+			a = (u - ui) / (knots[i+deg-r+1] - ui);
+			a_hat = 1.f-a;
+			lp = work + (j-1) * dim;
+			rp = lp + dim;
+			for (d = 0; d < dim; d++)
+				rp[d] = a_hat * lp[d] + a * rp[d];
+		}
+	}
+	memcpy(point, work + (N-1) * dim, sof_ctrlp);
+	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_eval_all(const tsBSpline *spline, const tsReal *us,
-	size_t num, tsReal **points, tsStatus *status)
+/**
+ * Computes the basis functions of \p spline at knot \p u, that is, the index
+ * of the first affected control point \p fst and the ts_bspline_order(spline)
+ * weights \p weights such that the point at \p u is:
+ *
+ *     sum_j weights[j] * control_points[fst + j]
+ *
+ * The weights are obtained by propagating the result of De Boor's algorithm
+ * (cf. ts_int_bspline_eval_point) back to the affected control points.
+ * Accordingly, the weighted sum yields the same point as the evaluation with
+ * De Boor's algorithm (up to rounding). Unaffected control points are assigned
+ * zero weights, and \p fst is chosen such that all indices are valid (i.e.,
+ * \p fst + order <= num(control points)). \p cursor is used as in
+ * ts_int_bspline_eval_point.
+ */
+tsError ts_int_bspline_eval_basis(const tsBSpline *spline, tsReal u,
+	size_t *cursor, size_t *fst, tsReal *weights, tsStatus *status)
 {
-	const size_t dim = ts_bspline_dimension(spline);
-	const size_t sof_point = dim * sizeof(tsReal);
-	const size_t sof_points = num * sof_point;
-	tsDeBoorNet net = ts_deboornet_init();
-	tsReal *result;
-	size_t i;
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+
+	size_t k;        /**< Index of \p u. */
+	size_t s;        /**< Multiplicity of \p u. */
+	size_t N;        /**< Number of affected control points. */
+	size_t shift;    /**< Used to keep the indices valid. */
+	size_t r, i, j;  /**< Used in for loop. */
+	tsReal ui;       /**< Knot value at index i. */
+	tsReal a;        /**< Weighting factor of a control point. */
+	tsReal w;        /**< Weight of the current step. */
+
 	tsError err;
-	TS_TRY(try, err, status)
-		*points = (tsReal *) malloc(sof_points);
-		if (!*points) {
-			TS_THROW_0(try, err, status, TS_MALLOC,
-				"out of memory")
+
+	k = s = 0;
+	TS_CALL_ROE(err, ts_int_bspline_find_knot_from(spline, u,
+		cursor ? *cursor : ts_bspline_num_knots(spline),
+		&k, &s, status))
+	if (cursor)
+		*cursor = k;
+	if (ts_knots_equal(u, knots[k]))
+		u = knots[k]; /* Same as in ts_int_bspline_eval_woa. */
+
+	ts_arr_fill(weights, order, 0);
+	if (s == order) {
+		/* Same as in ts_int_bspline_eval_point. */
+		*fst = k == deg ? 0 : k-s;
+		weights[0] = 1;
+	} else {
+		/* Level r of De Boor's algorithm computes the points
+		 * j = r ... N-1 (local index) from the points j-1 and j of
+		 * level r-1. Starting with the result (level deg-s, index
+		 * N-1), the weights are distributed to the points of the
+		 * previous level until level 0 (the control points) is
+		 * reached. Ascending j ensures that weights[j+1] still stores
+		 * the weight of the current level. */
+		*fst = k-deg;
+		N = k-s - *fst + 1;
+		weights[N-1] = 1;
+		for (r = deg-s; r >= 1; r--) {
+			for (j = r-1; j < N; j++) {
+				w = 0;
+				if (j >= r) {
+					i = *fst + j;
+					ui = knots[i];
+					a = (u - ui) / (knots[i+deg-r+1] - ui);
+					w += a * weights[j];
+				}
+				if (j+1 < N) {
+					i = *fst + j+1;
+					ui = knots[i];
+					a = (u - ui) / (knots[i+deg-r+1] - ui);
+					w += (1.f-a) * weights[j+1];
+				}
+				weights[j] = w;
+			}
 		}
-		TS_CALL(try, err, ts_int_deboornet_new(
-			spline,&net, status))
-		for (i = 0; i < num; i++) {
-			TS_CALL(try, err, ts_int_bspline_eval_woa(
-				spline, us[i], &net, status))
-			result = ts_int_deboornet_access_result(&net);
-			memcpy((*points) + i * dim, result, sof_point);
+	}
+	/* The last control points may not be affected at all. */
+	if (*fst + order > n_ctrlp) {
+		shift = *fst + order - n_ctrlp;
+		memmove(weights + shift, weights,
+			(order - shift) * sizeof(tsReal));
+		ts_arr_fill(weights, shift, 0);
+		*fst -= shift;
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Computes a step of De Boor's algorithm of ts_int_bspline_eval_lanes_f and
+ * ts_int_bspline_eval_lanes_d for all lanes: the weighting factor of lane l
+ * is a = (\p ul[l] - \p lo[l]) * \p dk[l] and the \p stride values of the
+ * level \p rp are replaced with (1 - a) * \p lp + a * \p rp, where l is the
+ * lane of a value. If \p uniform is true, all lanes share the same knots and
+ * \p lo and \p dk store a single value only. There is a float and a double
+ * version for each supported SIMD instruction set. All versions of a type
+ * compute the same results (the multiplications and additions are not
+ * fused).
+ */
+typedef void (*ts_int_lanes_combine_f_func)(const float *ul, const float *lo,
+	const float *dk, int uniform, const float *lp, float *rp,
+	size_t stride);
+
+typedef void (*ts_int_lanes_combine_d_func)(const double *ul,
+	const double *lo, const double *dk, int uniform, const double *lp,
+	double *rp, size_t stride);
+
+/**
+ * Defines ts_int_lanes_combine_##suffix, the portable version of the combine
+ * functions of type \p T.
+ */
+#define TS_INT_DEFINE_LANES_COMBINE(T, suffix)                                \
+void ts_int_lanes_combine_##suffix(const T *ul, const T *lo, const T *dk,     \
+	int uniform, const T *lp, T *rp, size_t stride)                       \
+{                                                                             \
+	T as[TS_INT_NUM_LANES], hs[TS_INT_NUM_LANES];                         \
+	size_t d, l;                                                          \
+	for (l = 0; l < TS_INT_NUM_LANES; l++) {                              \
+		as[l] = uniform ? (ul[l] - lo[0]) * dk[0]                     \
+			: (ul[l] - lo[l]) * dk[l];                            \
+		hs[l] = 1.f - as[l];                                          \
+	}                                                                     \
+	for (d = 0; d < stride; d += TS_INT_NUM_LANES) {                      \
+		for (l = 0; l < TS_INT_NUM_LANES; l++)                        \
+			rp[d + l] = hs[l] * lp[d + l] + as[l] * rp[d + l];    \
+	}                                                                     \
+}
+
+TS_INT_DEFINE_LANES_COMBINE(float, f)
+TS_INT_DEFINE_LANES_COMBINE(double, d)
+
+#ifdef TS_INT_SIMD_SSE
+void ts_int_lanes_combine_sse_f(const float *ul, const float *lo,
+	const float *dk, int uniform, const float *lp, float *rp,
+	size_t stride)
+{
+	__m128 a, h, lv, dv;
+	size_t d, l;
+	lv = _mm_set1_ps(lo[0]);
+	dv = _mm_set1_ps(dk[0]);
+	for (l = 0; l < TS_INT_NUM_LANES; l += 4) {
+		if (!uniform) {
+			lv = _mm_loadu_ps(lo + l);
+			dv = _mm_loadu_ps(dk + l);
 		}
-	TS_CATCH(err)
-		if (*points)
-			free(*points);
-		*points = NULL;
-	TS_FINALLY
-		ts_deboornet_free(&net);
-	TS_END_TRY_RETURN(err)
+		a = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(ul + l), lv), dv);
+		h = _mm_sub_ps(_mm_set1_ps(1.f), a);
+		for (d = l; d < stride; d += TS_INT_NUM_LANES) {
+			_mm_storeu_ps(rp + d, _mm_add_ps(
+				_mm_mul_ps(h, _mm_loadu_ps(lp + d)),
+				_mm_mul_ps(a, _mm_loadu_ps(rp + d))));
+		}
+	}
 }
 
-tsError ts_bspline_sample(const tsBSpline *spline, size_t num, tsReal **points,
-	size_t *actual_num, tsStatus *status)
+void ts_int_lanes_combine_sse_d(const double *ul, const double *lo,
+	const double *dk, int uniform, const double *lp, double *rp,
+	size_t stride)
 {
-	tsError err;
-	tsReal *knots;
-	tsReal min, max;
-	size_t i;
-	if (num == 0)
-		num = (ts_bspline_num_control_points(spline) -
-			ts_bspline_degree(spline)) * 30;
-	*actual_num = num;
-	knots = (tsReal *) malloc(num * sizeof(tsReal));
-	if (!knots) {
-		*points = NULL;
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	__m128d a, h, lv, dv;
+	size_t d, l;
+	lv = _mm_set1_pd(lo[0]);
+	dv = _mm_set1_pd(dk[0]);
+	for (l = 0; l < TS_INT_NUM_LANES; l += 2) {
+		if (!uniform) {
+			lv = _mm_loadu_pd(lo + l);
+			dv = _mm_loadu_pd(dk + l);
+		}
+		a = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(ul + l), lv), dv);
+		h = _mm_sub_pd(_mm_set1_pd(1.f), a);
+		for (d = l; d < stride; d += TS_INT_NUM_LANES) {
+			_mm_storeu_pd(rp + d, _mm_add_pd(
+				_mm_mul_pd(h, _mm_loadu_pd(lp + d)),
+				_mm_mul_pd(a, _mm_loadu_pd(rp + d))));
+		}
 	}
-	ts_bspline_domain(spline, &min, &max);
-	for (i = 0; i < num; i++) {
-		knots[i] = max - min;
-		knots[i] *= (tsReal)i / (num - 1);
-		knots[i] += min;
-	}
-	/* Set knots[0] after knots[num - 1] to ensure that
-	 * knots[0] = min if num == 1. */
-	knots[num - 1] = max;
-	knots[0] = min;
-	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_eval_all(
-			spline, knots, num, points, status))
-	TS_FINALLY
-		free(knots);
-	TS_END_TRY_RETURN(err)
 }
+#endif
 
-tsError ts_bspline_bisect(const tsBSpline *spline, tsReal value,
-	tsReal epsilon, int persnickety, size_t index, int ascending,
-	size_t max_iter, tsDeBoorNet *net, tsStatus *status)
+#ifdef TS_INT_SIMD_AVX
+/* Not called from code using SSE instructions without returning in between,
+ * so that the transition penalty between AVX and SSE code is avoided (the
+ * compiler clears the upper halves of the registers on return). */
+__attribute__((target("avx")))
+void ts_int_lanes_combine_avx_f(const float *ul, const float *lo,
+	const float *dk, int uniform, const float *lp, float *rp,
+	size_t stride)
 {
-	tsError err;
-	const size_t dim = ts_bspline_dimension(spline);
-	const tsReal eps = (tsReal) fabs(epsilon);
-	size_t i = 0;
-	tsReal dist = 0;
-	tsReal min, max, mid;
-	tsReal *P;
+	__m256 a, h, lv, dv;
+	size_t d, l;
+	lv = _mm256_set1_ps(lo[0]);
+	dv = _mm256_set1_ps(dk[0]);
+	for (l = 0; l < TS_INT_NUM_LANES; l += 8) {
+		if (!uniform) {
+			lv = _mm256_loadu_ps(lo + l);
+			dv = _mm256_loadu_ps(dk + l);
+		}
+		a = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(ul + l), lv),
+			dv);
+		h = _mm256_sub_ps(_mm256_set1_ps(1.f), a);
+		for (d = l; d < stride; d += TS_INT_NUM_LANES) {
+			_mm256_storeu_ps(rp + d, _mm256_add_ps(
+				_mm256_mul_ps(h, _mm256_loadu_ps(lp + d)),
+				_mm256_mul_ps(a, _mm256_loadu_ps(rp + d))));
+		}
+	}
+}
 
-	ts_int_deboornet_init(net);
+__attribute__((target("avx")))
+void ts_int_lanes_combine_avx_d(const double *ul, const double *lo,
+	const double *dk, int uniform, const double *lp, double *rp,
+	size_t stride)
+{
+	__m256d a, h, lv, dv;
+	size_t d, l;
+	lv = _mm256_set1_pd(lo[0]);
+	dv = _mm256_set1_pd(dk[0]);
+	for (l = 0; l < TS_INT_NUM_LANES; l += 4) {
+		if (!uniform) {
+			lv = _mm256_loadu_pd(lo + l);
+			dv = _mm256_loadu_pd(dk + l);
+		}
+		a = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(ul + l), lv),
+			dv);
+		h = _mm256_sub_pd(_mm256_set1_pd(1.f), a);
+		for (d = l; d < stride; d += TS_INT_NUM_LANES) {
+			_mm256_storeu_pd(rp + d, _mm256_add_pd(
+				_mm256_mul_pd(h, _mm256_loadu_pd(lp + d)),
+				_mm256_mul_pd(a, _mm256_loadu_pd(rp + d))));
+		}
+	}
+}
+#endif
 
-	if (dim < index) {
-		TS_RETURN_2(status, TS_INDEX_ERROR,
-			"dimension (%lu) <= index (%lu)",
-			(unsigned long) dim,
-			(unsigned long) index)
+#ifdef TS_INT_SIMD_NEON
+void ts_int_lanes_combine_neon_f(const float *ul, const float *lo,
+	const float *dk, int uniform, const float *lp, float *rp,
+	size_t stride)
+{
+	float32x4_t a, h, lv, dv;
+	size_t d, l;
+	lv = vdupq_n_f32(lo[0]);
+	dv = vdupq_n_f32(dk[0]);
+	for (l = 0; l < TS_INT_NUM_LANES; l += 4) {
+		if (!uniform) {
+			lv = vld1q_f32(lo + l);
+			dv = vld1q_f32(dk + l);
+		}
+		a = vmulq_f32(vsubq_f32(vld1q_f32(ul + l), lv), dv);
+		h = vsubq_f32(vdupq_n_f32(1.f), a);
+		for (d = l; d < stride; d += TS_INT_NUM_LANES) {
+			vst1q_f32(rp + d, vaddq_f32(
+				vmulq_f32(h, vld1q_f32(lp + d)),
+				vmulq_f32(a, vld1q_f32(rp + d))));
+		}
 	}
-	if(max_iter == 0)
-		TS_RETURN_0(status, TS_NO_RESULT, "0 iterations")
+}
+#endif
 
-	ts_bspline_domain(spline, &min, &max);
+#ifdef TS_INT_SIMD_NEON_F64
+void ts_int_lanes_combine_neon_d(const double *ul, const double *lo,
+	const double *dk, int uniform, const double *lp, double *rp,
+	size_t stride)
+{
+	float64x2_t a, h, lv, dv;
+	size_t d, l;
+	lv = vdupq_n_f64(lo[0]);
+	dv = vdupq_n_f64(dk[0]);
+	for (l = 0; l < TS_INT_NUM_LANES; l += 2) {
+		if (!uniform) {
+			lv = vld1q_f64(lo + l);
+			dv = vld1q_f64(dk + l);
+		}
+		a = vmulq_f64(vsubq_f64(vld1q_f64(ul + l), lv), dv);
+		h = vsubq_f64(vdupq_n_f64(1.f), a);
+		for (d = l; d < stride; d += TS_INT_NUM_LANES) {
+			vst1q_f64(rp + d, vaddq_f64(
+				vmulq_f64(h, vld1q_f64(lp + d)),
+				vmulq_f64(a, vld1q_f64(rp + d))));
+		}
+	}
+}
+#endif
+
+/**
+ * Returns the fastest version of ts_int_lanes_combine_f that is supported by
+ * the CPU running the program. Since AVX is detected at runtime, the library
+ * can be built for the baseline of a platform without giving up wider
+ * vectors.
+ */
+ts_int_lanes_combine_f_func ts_int_lanes_combine_select_f()
+{
+#ifdef TS_INT_SIMD_AVX
+	if (__builtin_cpu_supports("avx"))
+		return ts_int_lanes_combine_avx_f;
+#endif
+#if defined(TS_INT_SIMD_SSE)
+	return ts_int_lanes_combine_sse_f;
+#elif defined(TS_INT_SIMD_NEON)
+	return ts_int_lanes_combine_neon_f;
+#else
+	return ts_int_lanes_combine_f;
+#endif
+}
+
+/**
+ * Like ts_int_lanes_combine_select_f, but returns a version of
+ * ts_int_lanes_combine_d.
+ */
+ts_int_lanes_combine_d_func ts_int_lanes_combine_select_d()
+{
+#ifdef TS_INT_SIMD_AVX
+	if (__builtin_cpu_supports("avx"))
+		return ts_int_lanes_combine_avx_d;
+#endif
+#if defined(TS_INT_SIMD_SSE)
+	return ts_int_lanes_combine_sse_d;
+#elif defined(TS_INT_SIMD_NEON_F64)
+	return ts_int_lanes_combine_neon_d;
+#else
+	return ts_int_lanes_combine_d;
+#endif
+}
+
+/**
+ * Defines ts_int_bspline_eval_lanes_##suffix, which evaluates \p spline at
+ * the \p num (<= ::TS_INT_NUM_LANES) knots \p us and stores the resultant
+ * points in \p points (cf. ts_int_bspline_eval_point). The De Boor nets of
+ * the knots are laid out in SoA form, that is, the components of all knots
+ * are stored next to each other in \p work (which must be able to store
+ * ::TS_INT_NUM_LANES * ts_bspline_order(spline) *
+ * ts_bspline_dimension(spline) values). Thus, the innermost loop of the
+ * recurrence runs over a fixed number of lanes instead of the (usually
+ * small) dimension of \p spline and is computed with the SIMD instructions
+ * of the CPU (cf. ts_int_lanes_combine_select_f). The knot search is done in
+ * tsReal and the recurrence in type \p T, i.e., the control points and knots
+ * of \p spline are converted to \p T as they are loaded. Knots whose
+ * multiplicity is greater than 0 (i.e., knots that require fewer
+ * insertions) are passed to ts_int_bspline_eval_point, which computes in
+ * tsReal and uses \p scratch (of (ts_bspline_order(spline) + 1) *
+ * ts_bspline_dimension(spline) values). If \p T is tsReal, \p scratch may
+ * be \p work.
+ */
+#define TS_INT_DEFINE_EVAL_LANES(T, suffix)                                   \
+tsError ts_int_bspline_eval_lanes_##suffix(const tsBSpline *spline,           \
+	const tsReal *us, size_t num, size_t *cursor, T *work,                \
+	tsReal *scratch, T *points, tsStatus *status)                         \
+{                                                                             \
+	const size_t deg = ts_bspline_degree(spline);                         \
+	const size_t order = ts_bspline_order(spline);                        \
+	const size_t dim = ts_bspline_dimension(spline);                      \
+	const size_t num_knots = ts_bspline_num_knots(spline);                \
+	const size_t stride = dim * TS_INT_NUM_LANES; /* Size of a level. */  \
+                                                                              \
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);            \
+	const tsReal *knots = ts_int_bspline_access_knots(spline);            \
+	const ts_int_lanes_combine_##suffix##_func combine =                  \
+		ts_int_lanes_combine_select_##suffix();                       \
+                                                                              \
+	size_t ks[TS_INT_NUM_LANES]; /* Index of the knot of each lane. */    \
+	T ul[TS_INT_NUM_LANES]; /* Knot of each lane. */                      \
+	T lo[TS_INT_NUM_LANES]; /* Lower knot of a step of each lane. */      \
+	T dk[TS_INT_NUM_LANES]; /* Inverse distance of the knots. */          \
+	int packed[TS_INT_NUM_LANES]; /* Does a lane use the SoA kernel? */   \
+                                                                              \
+	size_t first;  /* First packed lane. */                               \
+	int uniform;   /* Do all lanes share the same index? */               \
+	size_t k, s;   /* Index and multiplicity of a knot. */                \
+	size_t l, r, i, j, d;  /* Used in for loop. */                        \
+	T ui;          /* A (shared) control point value. */                  \
+	T *lp, *rp;    /* Left and right level of the current step. */        \
+                                                                              \
+	tsError err;                                                          \
+                                                                              \
+	first = TS_INT_NUM_LANES;                                             \
+	for (l = 0; l < num; l++) {                                           \
+		k = *cursor;                                                  \
+		if (k >= deg && k + order < num_knots &&                      \
+			us[l] - knots[k] >= TS_KNOT_EPSILON &&                \
+			knots[k+1] - us[l] >= TS_KNOT_EPSILON) {              \
+			/* Inside the (non-empty) span of the previous knot   \
+			 * and not equal to one of its bounds, which is the   \
+			 * common case when sampling densely. The search      \
+			 * would yield the same index and a multiplicity of   \
+			 * 0. */                                              \
+			s = 0;                                                \
+		} else {                                                      \
+			TS_CALL_ROE(err, ts_int_bspline_find_knot_from(       \
+				spline, us[l], *cursor, &k, &s, status))      \
+			*cursor = k;                                          \
+		}                                                             \
+		packed[l] = s == 0;                                           \
+		if (packed[l]) {                                              \
+			/* s == 0 implies that u is not equal to knots[k]. */ \
+			ks[l] = k;                                            \
+			ul[l] = (T) us[l];                                    \
+			if (first == TS_INT_NUM_LANES)                        \
+				first = l;                                    \
+			continue;                                             \
+		}                                                             \
+		TS_CALL_ROE(err, ts_int_bspline_eval_point(spline, us[l],     \
+			cursor, scratch + dim, scratch, status))              \
+		for (d = 0; d < dim; d++)                                     \
+			points[l * dim + d] = (T) scratch[d];                 \
+	}                                                                     \
+	if (first == TS_INT_NUM_LANES)                                        \
+		TS_RETURN_SUCCESS(status)                                     \
+	/* Fill the lanes that are not packed with a valid knot so that the   \
+	 * recurrence runs over all lanes. The results are discarded. */      \
+	uniform = 1;                                                          \
+	for (l = 0; l < TS_INT_NUM_LANES; l++) {                              \
+		if (l >= num || !packed[l]) {                                 \
+			ks[l] = ks[first];                                    \
+			ul[l] = ul[first];                                    \
+		}                                                             \
+		uniform = uniform && ks[l] == ks[first];                      \
+	}                                                                     \
+                                                                              \
+	/* Gather the affected control points (N == order because s == 0). */ \
+	for (j = 0; j < order; j++) {                                         \
+		for (d = 0; d < dim; d++) {                                   \
+			rp = work + j * stride + d * TS_INT_NUM_LANES;        \
+			if (uniform) {                                        \
+				ui = (T) ctrlp[(ks[0] - deg + j) * dim + d];  \
+				for (l = 0; l < TS_INT_NUM_LANES; l++)        \
+					rp[l] = ui;                           \
+			} else {                                              \
+				for (l = 0; l < TS_INT_NUM_LANES; l++) {      \
+					rp[l] = (T) ctrlp[                    \
+						(ks[l] - deg + j) * dim + d]; \
+				}                                             \
+			}                                                     \
+		}                                                             \
+	}                                                                     \
+                                                                              \
+	/* De Boor's algorithm, in place from back to front (cf.              \
+	 * ts_int_bspline_eval_point). */                                     \
+	for (r = 1; r <= deg; r++) {                                          \
+		for (j = deg; j >= r; j--) {                                  \
+			if (uniform) {                                        \
+				/* All lanes share the same knots. */         \
+				i = ks[0] - deg + j;                          \
+				lo[0] = (T) knots[i];                         \
+				dk[0] = 1.f / ((T) knots[i+deg-r+1] - lo[0]); \
+			} else {                                              \
+				for (l = 0; l < TS_INT_NUM_LANES; l++) {      \
+					i = ks[l] - deg + j;                  \
+					lo[l] = (T) knots[i];                 \
+					dk[l] = 1.f / ((T)                    \
+						knots[i+deg-r+1] - lo[l]);    \
+				}                                             \
+			}                                                     \
+			lp = work + (j-1) * stride;                           \
+			rp = lp + stride;                                     \
+			combine(ul, lo, dk, uniform, lp, rp, stride);         \
+		}                                                             \
+	}                                                                     \
+                                                                              \
+	/* Scatter the results. */                                            \
+	rp = work + deg * stride;                                             \
+	for (l = 0; l < num; l++) {                                           \
+		if (!packed[l])                                               \
+			continue;                                             \
+		for (d = 0; d < dim; d++)                                     \
+			points[l * dim + d] = rp[d * TS_INT_NUM_LANES + l];   \
+	}                                                                     \
+	TS_RETURN_SUCCESS(status)                                             \
+}
+
+TS_INT_DEFINE_EVAL_LANES(float, f)
+TS_INT_DEFINE_EVAL_LANES(double, d)
+
+/**
+ * Evaluates \p spline at the \p num (<= ::TS_INT_NUM_LANES) knots \p us in
+ * tsReal, i.e., calls ts_int_bspline_eval_lanes_f in float and
+ * ts_int_bspline_eval_lanes_d in double builds. \p work is also used as the
+ * scratch of ts_int_bspline_eval_point.
+ */
+tsError ts_int_bspline_eval_lanes(const tsBSpline *spline, const tsReal *us,
+	size_t num, size_t *cursor, tsReal *work, tsReal *points,
+	tsStatus *status)
+{
+#ifdef TINYSPLINE_FLOAT_PRECISION
+	return ts_int_bspline_eval_lanes_f(spline, us, num, cursor, work,
+		work, points, status);
+#else
+	return ts_int_bspline_eval_lanes_d(spline, us, num, cursor, work,
+		work, points, status);
+#endif
+}
+
+tsError TS_INT_STATS_IMPL(ts_bspline_eval)(const tsBSpline *spline, tsReal u,
+	tsDeBoorNet *net, tsStatus *status)
+{
+	tsError err;
+	ts_int_deboornet_init(net);
 	TS_TRY(try, err, status)
 		TS_CALL(try, err, ts_int_deboornet_new(
 			spline, net, status))
-		do {
-			mid = (tsReal) ((min + max) / 2.0);
-			TS_CALL(try, err, ts_int_bspline_eval_woa(
-				spline, mid, net, status))
-			P = ts_int_deboornet_access_result(net);
-			dist = ts_distance(&P[index], &value, 1);
-			if (dist <= eps)
-				TS_RETURN_SUCCESS(status)
-			if (ascending) {
-				if (P[index] < value)
-					min = mid;
-				else
-					max = mid;
-			} else {
-				if (P[index] < value)
-					max = mid;
-				else
-					min = mid;
-			}
-		} while (i++ < max_iter);
-		if (persnickety) {
-			TS_THROW_1(try, err, status, TS_NO_RESULT,
-				"maximum iterations (%lu) exceeded",
-				(unsigned long) max_iter)
-		}
+		TS_CALL(try, err, ts_int_bspline_eval_woa(
+			spline, u, net, status))
 	TS_CATCH(err)
 		ts_deboornet_free(net);
 	TS_END_TRY_RETURN(err)
 }
 
-void ts_bspline_domain(const tsBSpline *spline, tsReal *min, tsReal *max)
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval(const tsBSpline *spline, tsReal u, tsDeBoorNet *net,
+	tsStatus *status)
 {
-	*min = ts_int_bspline_access_knots(spline)
-		[ts_bspline_degree(spline)];
-	*max = ts_int_bspline_access_knots(spline)
-		[ts_bspline_num_knots(spline) - ts_bspline_order(spline)];
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval",
+		TS_INT_STATS_IMPL(ts_bspline_eval)(spline, u, net, status))
 }
+#endif
 
-tsError ts_bspline_is_closed(const tsBSpline *spline, tsReal epsilon,
-	int *closed, tsStatus *status)
+tsError TS_INT_STATS_IMPL(ts_bspline_eval_into)(const tsBSpline *spline,
+	tsReal u, tsDeBoorNet *net, tsStatus *status)
 {
-	const size_t deg = ts_bspline_degree(spline);
 	const size_t dim = ts_bspline_dimension(spline);
-	tsBSpline derivative;
-	tsReal min, max;
-	tsDeBoorNet first, last;
-	size_t i;
+	const size_t len = ts_int_deboornet_num_points_max(spline) * dim;
 	tsError err;
+	if (!net->pImpl || net->pImpl->cap < len) {
+		ts_deboornet_free(net);
+		TS_CALL_ROE(err, ts_int_deboornet_new(spline, net, status))
+	}
+	/* If evaluation fails, `net` is not modified. */
+	TS_CALL_ROE(err, ts_int_bspline_eval_woa(spline, u, net, status))
+	net->pImpl->dim = dim;
+	TS_RETURN_SUCCESS(status)
+}
 
-	ts_int_bspline_init(&derivative);
-	ts_int_deboornet_init(&first);
-	ts_int_deboornet_init(&last);
-
-	TS_TRY(try, err, status)
-		for (i = 0; i < deg; i++) {
-			TS_CALL(try, err, ts_bspline_derive(
-				spline, i, -1.f, &derivative, status))
-			ts_bspline_domain(&derivative, &min, &max);
-			TS_CALL(try, err, ts_bspline_eval(
-				&derivative, min, &first, status))
-			TS_CALL(try, err, ts_bspline_eval(
-				&derivative, max, &last, status))
-			*closed = ts_distance(
-				ts_int_deboornet_access_result(&first),
-				ts_int_deboornet_access_result(&last),
-				dim) <= epsilon ? 1 : 0;
-			ts_bspline_free(&derivative);
-			ts_deboornet_free(&first);
-			ts_deboornet_free(&last);
-			if (!*closed)
-				TS_RETURN_SUCCESS(status)
-		}
-	TS_FINALLY
-		ts_bspline_free(&derivative);
-		ts_deboornet_free(&first);
-		ts_deboornet_free(&last);
-	TS_END_TRY_RETURN(err)
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval_into(const tsBSpline *spline, tsReal u,
+	tsDeBoorNet *net, tsStatus *status)
+{
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval_into",
+		TS_INT_STATS_IMPL(ts_bspline_eval_into)(spline, u, net, status))
 }
+#endif
 
+tsError TS_INT_STATS_IMPL(ts_bspline_eval_point)(const tsBSpline *spline,
+	tsReal u, tsReal *point, tsStatus *status)
+{
+	const size_t len_work = ts_bspline_order(spline) *
+		ts_bspline_dimension(spline);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	tsError err;
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	err = ts_int_bspline_eval_point(spline, u, NULL, work, point, status);
+	if (work != stack)
+		ts_int_free(work);
+	return err;
+}
 
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval_point(const tsBSpline *spline, tsReal u,
+	tsReal *point, tsStatus *status)
+{
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval_point",
+		TS_INT_STATS_IMPL(ts_bspline_eval_point)(spline, u, point,
+			status))
+}
+#endif
 
-/******************************************************************************
-*                                                                             *
-* :: Transformation Functions                                                 *
-*                                                                             *
-******************************************************************************/
-tsError ts_int_bspline_resize(const tsBSpline *spline, int n, int back,
-	tsBSpline *_resized_, tsStatus *status)
+tsError TS_INT_STATS_IMPL(ts_bspline_eval_all)(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal **points, tsStatus *status)
 {
-	const size_t deg = ts_bspline_degree(spline);
 	const size_t dim = ts_bspline_dimension(spline);
-	const size_t sof_real = sizeof(tsReal);
-
-	const size_t num_ctrlp = ts_bspline_num_control_points(spline);
-	const size_t num_knots = ts_bspline_num_knots(spline);
-	const size_t nnum_ctrlp = num_ctrlp + n; /**< New length of ctrlp. */
-	const size_t nnum_knots = num_knots + n; /**< New length of knots. */
-	const size_t min_num_ctrlp_vec = n < 0 ? nnum_ctrlp : num_ctrlp;
-	const size_t min_num_knots_vec = n < 0 ? nnum_knots : num_knots;
+	const size_t len_points = num * dim;
+	tsError err;
+	*points = (tsReal *) ts_int_malloc(len_points * sizeof(tsReal));
+	if (!*points)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_eval_all_into(
+			spline, us, num, *points, len_points, status))
+	TS_CATCH(err)
+		ts_int_free(*points);
+		*points = NULL;
+	TS_END_TRY_RETURN(err)
+}
 
-	const size_t sof_min_num_ctrlp = min_num_ctrlp_vec * dim * sof_real;
-	const size_t sof_min_num_knots = min_num_knots_vec * sof_real;
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval_all(const tsBSpline *spline, const tsReal *us,
+	size_t num, tsReal **points, tsStatus *status)
+{
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval_all",
+		TS_INT_STATS_IMPL(ts_bspline_eval_all)(spline, us, num, points,
+			status))
+}
+#endif
 
-	tsBSpline tmp; /**< Temporarily stores the result. */
-	const tsReal* from_ctrlp = ts_int_bspline_access_ctrlp(spline);
-	const tsReal* from_knots = ts_int_bspline_access_knots(spline);
-	tsReal* to_ctrlp = NULL; /**< Pointer to the control points of tmp. */
-	tsReal* to_knots = NULL; /**< Pointer to the knots of tmp. */
+/**
+ * Returns the \p index'th of \p num knots that are equally distributed in the
+ * domain [\p min, \p max] (cf. ts_bspline_sample). The first and the last knot
+ * are pinned to the domain to prevent floating point errors. If \p num == 1,
+ * the minimum of the domain is returned.
+ */
+tsReal ts_int_sample_knot(tsReal min, tsReal max, size_t num, size_t index)
+{
+	tsReal u;
+	if (index == 0)
+		return min;
+	if (index == num - 1)
+		return max;
+	u = max - min;
+	u *= (tsReal) index / (num - 1);
+	return u + min;
+}
 
+/**
+ * Evaluates \p spline at the knots with index [\p begin, \p end) and stores
+ * the resultant points at the corresponding positions in \p points, that is,
+ * the first point is stored at \p points + \p begin * dim. If \p us is NULL,
+ * the knots are generated as in ts_bspline_sample_into, where \p num is the
+ * total number of knots to generate. Otherwise, the knots are read from \p us
+ * and \p num is ignored. Uses its own workspace and, thus, can be called
+ * concurrently with distinct ranges.
+ */
+tsError ts_int_bspline_eval_range(const tsBSpline *spline, const tsReal *us,
+	size_t num, size_t begin, size_t end, tsReal *points,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t len_work = TS_INT_NUM_LANES *
+		ts_bspline_order(spline) * dim;
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	tsReal knots[TS_INT_NUM_LANES];
+	tsReal min, max;
+	size_t cursor = ts_bspline_num_knots(spline); /* no hint */
+	size_t i, j, n;
 	tsError err;
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	ts_bspline_domain(spline, &min, &max);
+	TS_TRY(try, err, status)
+		for (i = begin; i < end; i += TS_INT_NUM_LANES) {
+			n = end - i < TS_INT_NUM_LANES
+				? end - i : TS_INT_NUM_LANES;
+			for (j = 0; !us && j < n; j++) {
+				knots[j] = ts_int_sample_knot(
+					min, max, num, i + j);
+			}
+			TS_CALL(try, err, ts_int_bspline_eval_lanes(spline,
+				us ? us + i : knots, n, &cursor, work,
+				points + i * dim, status))
+		}
+	TS_FINALLY
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
 
-	if (n == 0)
-		return ts_bspline_copy(spline, _resized_, status);
+/**
+ * The context shared by the tasks of ts_int_bspline_eval_parallel.
+ */
+struct ts_int_eval_task_context
+{
+	const tsBSpline *spline;
+	const tsReal *us;   /**< NULL if the knots are generated. */
+	size_t num;         /**< Total number of knots. */
+	size_t grain_size;  /**< Number of knots per task. */
+	tsReal *points;     /**< Output of all tasks. */
+	tsStatus *statuses; /**< One status per task. */
+};
 
-	INIT_OUT_BSPLINE(spline, _resized_)
-	TS_CALL_ROE(err, ts_bspline_new(
-		nnum_ctrlp, dim, deg, TS_OPENED, &tmp, status))
-	to_ctrlp = ts_int_bspline_access_ctrlp(&tmp);
-	to_knots = ts_int_bspline_access_knots(&tmp);
+/**
+ * Evaluates the \p index'th chunk of ts_int_eval_task_context (cf. ::tsTask).
+ */
+void ts_int_bspline_eval_task(void *context, size_t index)
+{
+	const struct ts_int_eval_task_context *ctx =
+		(const struct ts_int_eval_task_context *) context;
+	const size_t begin = index * ctx->grain_size;
+	const size_t end = ctx->num - begin < ctx->grain_size
+		? ctx->num : begin + ctx->grain_size;
+	ts_int_bspline_eval_range(ctx->spline, ctx->us, ctx->num, begin, end,
+		ctx->points, ctx->statuses + index);
+}
 
-	/* Copy control points and knots. */
-	if (!back && n < 0) {
-		memcpy(to_ctrlp, from_ctrlp - n*dim, sof_min_num_ctrlp);
-		memcpy(to_knots, from_knots - n    , sof_min_num_knots);
-	} else if (!back && n > 0) {
-		memcpy(to_ctrlp + n*dim, from_ctrlp, sof_min_num_ctrlp);
-		memcpy(to_knots + n    , from_knots, sof_min_num_knots);
+/**
+ * Splits the evaluation of the \p num knots (cf. ts_int_bspline_eval_range)
+ * into tasks of \p grain_size knots and runs them with \p executor. If
+ * \p executor is NULL, the tasks are run serially. The error of the task with
+ * the lowest index is reported.
+ */
+tsError ts_int_bspline_eval_parallel(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t grain_size,
+	tsExecutor executor, void *executor_data, tsStatus *status)
+{
+	struct ts_int_eval_task_context ctx;
+	size_t num_tasks, i;
+	tsError err = TS_SUCCESS;
+	if (num == 0)
+		TS_RETURN_SUCCESS(status)
+	if (grain_size == 0)
+		grain_size = TS_INT_GRAIN_SIZE;
+	num_tasks = (num - 1) / grain_size + 1;
+	ctx.spline = spline;
+	ctx.us = us;
+	ctx.num = num;
+	ctx.grain_size = grain_size;
+	ctx.points = points;
+	ctx.statuses = (tsStatus *) ts_int_malloc(num_tasks * sizeof(tsStatus));
+	if (!ctx.statuses)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	for (i = 0; i < num_tasks; i++)
+		ctx.statuses[i].code = TS_SUCCESS;
+	if (executor) {
+		executor(executor_data, num_tasks,
+			ts_int_bspline_eval_task, &ctx);
 	} else {
-		/* n != 0 implies back == true */
-		memcpy(to_ctrlp, from_ctrlp, sof_min_num_ctrlp);
-		memcpy(to_knots, from_knots, sof_min_num_knots);
+		for (i = 0; i < num_tasks; i++)
+			ts_int_bspline_eval_task(&ctx, i);
+	}
+	for (i = 0; i < num_tasks; i++) {
+		if (ctx.statuses[i].code != TS_SUCCESS) {
+			err = ctx.statuses[i].code;
+			if (status)
+				*status = ctx.statuses[i];
+			break;
+		}
 	}
+	ts_int_free(ctx.statuses);
+	if (err == TS_SUCCESS)
+		TS_RETURN_SUCCESS(status)
+	return err;
+}
 
-	if (spline == _resized_)
-		ts_bspline_free(_resized_);
-	ts_bspline_move(&tmp, _resized_);
-	TS_RETURN_SUCCESS(status)
+tsError TS_INT_STATS_IMPL(ts_bspline_eval_all_into)(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	return ts_int_bspline_eval_range(spline, us, num, 0, num, points,
+		status);
 }
 
-tsError ts_bspline_derive(const tsBSpline *spline, size_t n, tsReal epsilon,
-	tsBSpline *derivative, tsStatus *status)
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval_all_into(const tsBSpline *spline, const tsReal *us,
+	size_t num, tsReal *points, size_t capacity, tsStatus *status)
+{
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval_all_into",
+		TS_INT_STATS_IMPL(ts_bspline_eval_all_into)(spline, us, num,
+			points, capacity, status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_eval_all_parallel)(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status)
 {
-	const size_t sof_real = sizeof(tsReal);
 	const size_t dim = ts_bspline_dimension(spline);
-	const size_t sof_ctrlp = dim * sof_real;
-	size_t deg = ts_bspline_degree(spline);
-	size_t num_ctrlp = ts_bspline_num_control_points(spline);
-	size_t num_knots = ts_bspline_num_knots(spline);
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	return ts_int_bspline_eval_parallel(spline, us, num, points,
+		grain_size, executor, executor_data, status);
+}
 
-	tsBSpline worker; /**< Stores the intermediate result. */
-	tsReal* ctrlp;    /**< Pointer to the control points of worker. */
-	tsReal* knots;    /**< Pointer to the knots of worker. */
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval_all_parallel(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval_all_parallel",
+		TS_INT_STATS_IMPL(ts_bspline_eval_all_parallel)(spline, us, num,
+			points, capacity, grain_size, executor, executor_data,
+			status))
+}
+#endif
 
-	size_t m, i, j, k, l; /**< Used in for loops. */
-	tsReal *fst, *snd; /**< Pointer to first and second control point. */
-	tsReal dist; /**< Distance between fst and snd. */
-	tsReal kid1, ki1; /**< Knots at i+deg+1 and i+1. */
-	tsReal span; /**< Distance between kid1 and ki1. */
+/**
+ * Returns the length of the workspace of ts_int_bspline_eval_derivs.
+ */
+size_t ts_int_bspline_len_work_derivs(const tsBSpline *spline, size_t n)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t du = n < deg ? n : deg;
+	return order * order + 4 * order + (du + 1) * order;
+}
 
-	tsBSpline swap; /**< Used to swap worker and derivative. */
-	tsError err;
+/**
+ * Evaluates \p spline and its first \p n derivatives at \p u (cf.
+ * ts_bspline_eval_derivs). \p work must be able to store
+ * ts_int_bspline_len_work_derivs(spline, n) values. \p cursor is used as in
+ * ts_int_bspline_eval_point.
+ */
+tsError ts_int_bspline_eval_derivs(const tsBSpline *spline, tsReal u,
+	size_t n, size_t *cursor, tsReal *work, tsReal *derivs,
+	tsStatus *status)
+{
+	const long p = (long) ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const long du = (long) n < p ? (long) n : p;
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
 
-	INIT_OUT_BSPLINE(spline, derivative)
-	TS_CALL_ROE(err, ts_bspline_copy(spline, &worker, status))
-	ctrlp = ts_int_bspline_access_ctrlp(&worker);
-	knots = ts_int_bspline_access_knots(&worker);
+	tsReal *ndu = work;                /**< Basis functions and knot
+	                                    *   differences, order x order. */
+	tsReal *a = ndu + order * order;   /**< Two rows of coefficients. */
+	tsReal *left = a + 2 * order;      /**< u - knots[i+1-j]. */
+	tsReal *right = left + order;      /**< knots[i+j] - u. */
+	tsReal *ders = right + order;      /**< Derivatives of the basis
+	                                    *   functions, (du+1) x order. */
+	size_t k;        /**< Index of \p u. */
+	size_t s;        /**< Multiplicity of \p u. */
+	size_t i;        /**< Span of \p u. */
+	long r, l, j, j1, j2, rk, pk, s1, s2; /**< Used in for loop. */
+	size_t d;        /**< Used in for loop. */
+	tsReal saved, temp, v;
+	const tsReal *pt;
 
-	TS_TRY(try, err, status)
-		for (m = 1; m <= n; m++) { /* from 1st to n'th derivative */
-			if (deg == 0) {
-				ts_arr_fill(ctrlp, dim, 0.f);
-				ts_bspline_domain(spline,
-					&knots[0], &knots[1]);
-				num_ctrlp = 1;
-				num_knots = 2;
-				break;
+	tsError err;
+
+	k = s = 0;
+	TS_CALL_ROE(err, ts_int_bspline_find_knot_from(spline, u,
+		cursor ? *cursor : ts_bspline_num_knots(spline),
+		&k, &s, status))
+	if (cursor)
+		*cursor = k;
+	if (ts_knots_equal(u, knots[k]))
+		u = knots[k]; /* Same as in ts_int_bspline_eval_woa. */
+	/* The span must be non-empty. If u is a knot, its left span is taken
+	 * (unless u is the minimum of the domain). */
+	i = s > 0 && k >= s + (size_t) p ? k - s : k;
+
+	/* Based on 'The NURBS Book' (Les Piegl and Wayne Tiller), algorithm
+	 * A2.3. ndu[j * order + r] stores the basis function N(r, j) if
+	 * r <= j and the knot difference right[r+1] + left[j-r] otherwise. */
+	ndu[0] = 1.f;
+	for (j = 1; j <= p; j++) {
+		left[j] = u - knots[i + 1 - j];
+		right[j] = knots[i + j] - u;
+		saved = 0.f;
+		for (r = 0; r < j; r++) {
+			ndu[j * order + r] = right[r + 1] + left[j - r];
+			temp = ndu[r * order + j - 1] / ndu[j * order + r];
+			ndu[r * order + j] = saved + right[r + 1] * temp;
+			saved = left[j - r] * temp;
+		}
+		ndu[j * order + j] = saved;
+	}
+	for (j = 0; j <= p; j++)
+		ders[j] = ndu[j * order + p];
+	for (r = 0; r <= p; r++) {
+		s1 = 0;
+		s2 = 1;
+		a[0] = 1.f;
+		for (l = 1; l <= du; l++) {
+			v = 0.f;
+			rk = r - l;
+			pk = p - l;
+			if (r >= l) {
+				a[s2 * order] = a[s1 * order] /
+					ndu[(pk + 1) * order + rk];
+				v = a[s2 * order] * ndu[rk * order + pk];
 			}
-			/* Check and, if possible, fix discontinuity. */
-			for (i = 2*deg + 1; i < num_knots - (deg+1); i++) {
-				if (!ts_knots_equal(knots[i], knots[i-deg]))
-					continue;
-				fst = ctrlp + (i - (deg+1)) * dim;
-				snd = fst + dim;
-				dist = ts_distance(fst, snd, dim);
-				if (epsilon >= 0.f && dist > epsilon) {
-					TS_THROW_1(try, err, status,
-						TS_UNDERIVABLE,
-						"discontinuity at knot: %f",
-						knots[i])
-				}
-				memmove(snd, snd + dim,
-					(num_ctrlp - (i+1-deg)) * sof_ctrlp);
-				memmove(&knots[i], &knots[i+1],
-					(num_knots - (i+1)) * sof_real);
-				num_ctrlp--;
-				num_knots--;
-				i += deg-1;
+			j1 = rk >= -1 ? 1 : -rk;
+			j2 = r - 1 <= pk ? l - 1 : p - r;
+			for (j = j1; j <= j2; j++) {
+				a[s2 * order + j] = (a[s1 * order + j] -
+					a[s1 * order + j - 1]) /
+					ndu[(pk + 1) * order + (rk + j)];
+				v += a[s2 * order + j] *
+					ndu[(rk + j) * order + pk];
 			}
-			/* Derive continuous worker. */
-			for (i = 0; i < num_ctrlp-1; i++) {
-				for (j = 0; j < dim; j++) {
-					k = i    *dim + j;
-					l = (i+1)*dim + j;
-					ctrlp[k] = ctrlp[l] - ctrlp[k];
-					kid1 = knots[i+deg+1];
-					ki1  = knots[i+1];
-					span = kid1 - ki1;
-					if (span < TS_KNOT_EPSILON)
-						span = TS_KNOT_EPSILON;
-					ctrlp[k] *= deg;
-					ctrlp[k] /= span;
-				}
+			if (r <= pk) {
+				a[s2 * order + l] = -a[s1 * order + l - 1] /
+					ndu[(pk + 1) * order + r];
+				v += a[s2 * order + l] * ndu[r * order + pk];
 			}
-			deg       -= 1;
-			num_ctrlp -= 1;
-			num_knots -= 2;
-			knots     += 1;
+			ders[l * order + r] = v;
+			j = s1;
+			s1 = s2;
+			s2 = j;
 		}
-		TS_CALL(try, err, ts_bspline_new(
-			num_ctrlp, dim, deg, TS_OPENED, &swap, status))
-		memcpy(ts_int_bspline_access_ctrlp(&swap), ctrlp,
-			num_ctrlp * sof_ctrlp);
-		memcpy(ts_int_bspline_access_knots(&swap), knots,
-			num_knots * sof_real);
-		if (spline == derivative)
-			ts_bspline_free(derivative);
-		ts_bspline_move(&swap, derivative);
-	TS_FINALLY
-		ts_bspline_free(&worker);
-	TS_END_TRY_RETURN(err)
+	}
+	for (r = p, l = 1; l <= du; l++) {
+		for (j = 0; j <= p; j++)
+			ders[l * order + j] *= (tsReal) r;
+		r *= p - l;
+	}
+
+	/* Weight the affected control points. */
+	ts_arr_fill(derivs, (n + 1) * dim, 0.f);
+	for (l = 0; l <= du; l++) {
+		for (j = 0; j <= p; j++) {
+			pt = ctrlp + (i - p + j) * dim;
+			v = ders[l * order + j];
+			for (d = 0; d < dim; d++)
+				derivs[l * dim + d] += v * pt[d];
+		}
+	}
+	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_int_bspline_insert_knot(const tsBSpline *spline,
-	const tsDeBoorNet *deBoorNet, size_t n, tsBSpline *result,
-	tsStatus *status)
+tsError TS_INT_STATS_IMPL(ts_bspline_eval_derivs)(const tsBSpline *spline,
+	tsReal u, size_t n, tsReal *derivs, tsStatus *status)
 {
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t order = ts_bspline_order(spline);
-	const size_t dim = ts_bspline_dimension(spline);
-	const tsReal knot = ts_deboornet_knot(deBoorNet);
-	const size_t k = ts_deboornet_index(deBoorNet);
-	const size_t mult = ts_deboornet_multiplicity(deBoorNet);
-	const size_t sof_real = sizeof(tsReal);
-	const size_t sof_ctrlp = dim * sof_real;
-
-	size_t N;     /**< Number of affected control points. */
-	tsReal* from; /**< Pointer to copy the values from. */
-	tsReal* to;   /**< Pointer to copy the values to. */
-	int stride;   /**< Stride of the next pointer to copy. */
-	size_t i;     /**< Used in for loops. */
+	return ts_bspline_eval_derivs_all(spline, &u, 1, n, derivs, status);
+}
 
-	tsReal *ctrlp_spline, *ctrlp_result;
-	tsReal *knots_spline, *knots_result;
-	size_t num_ctrlp_result;
-	size_t num_knots_result;
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval_derivs(const tsBSpline *spline, tsReal u, size_t n,
+	tsReal *derivs, tsStatus *status)
+{
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval_derivs",
+		TS_INT_STATS_IMPL(ts_bspline_eval_derivs)(spline, u, n, derivs,
+			status))
+}
+#endif
 
+tsError TS_INT_STATS_IMPL(ts_bspline_eval_derivs_all)(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t n, tsReal *derivs,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t len_work = ts_int_bspline_len_work_derivs(spline, n);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t cursor = ts_bspline_num_knots(spline); /* no hint */
+	size_t i;
 	tsError err;
 
-	INIT_OUT_BSPLINE(spline, result)
-	if (n == 0)
-		return ts_bspline_copy(spline, result, status);
-	if (mult + n > order) {
-		TS_RETURN_4(status, TS_MULTIPLICITY,
-			"multiplicity(%f) (%lu) + %lu > order (%lu)",
-			knot, (unsigned long) mult, (unsigned long) n,
-			(unsigned long) order)
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	}
+	TS_TRY(try, err, status)
+		for (i = 0; i < num; i++) {
+			TS_CALL(try, err, ts_int_bspline_eval_derivs(spline,
+				us[i], n, &cursor, work,
+				derivs + i * (n + 1) * dim, status))
+		}
+	TS_FINALLY
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
 
-	TS_CALL_ROE(err, ts_int_bspline_resize(
-		spline, (int)n, 1, result, status))
-	ctrlp_spline = ts_int_bspline_access_ctrlp(spline);
-	knots_spline = ts_int_bspline_access_knots(spline);
-	ctrlp_result = ts_int_bspline_access_ctrlp(result);
-	knots_result = ts_int_bspline_access_knots(result);
-	num_ctrlp_result = ts_bspline_num_control_points(result);
-	num_knots_result = ts_bspline_num_knots(result);
-
-	/* mult + n <= deg + 1 (order) with n >= 1
-	 * =>  mult <= deg
-	 * =>  regular evaluation
-	 * =>  N = h + 1 is valid */
-	N = ts_deboornet_num_insertions(deBoorNet) + 1;
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_eval_derivs_all(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t n, tsReal *derivs,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(EVAL, "ts_bspline_eval_derivs_all",
+		TS_INT_STATS_IMPL(ts_bspline_eval_derivs_all)(spline, us, num,
+			n, derivs, status))
+}
+#endif
+
+size_t ts_int_bspline_sample_num(const tsBSpline *spline, size_t num)
+{
+	if (num == 0)
+		num = (ts_bspline_num_control_points(spline) -
+			ts_bspline_degree(spline)) * 30;
+	return num;
+}
+
+tsError TS_INT_STATS_IMPL(ts_bspline_sample)(const tsBSpline *spline,
+	size_t num, tsReal **points, size_t *actual_num, tsStatus *status)
+{
+	size_t len_points;
+	tsError err;
+	*actual_num = ts_int_bspline_sample_num(spline, num);
+	len_points = *actual_num * ts_bspline_dimension(spline);
+	*points = (tsReal *) ts_int_malloc(len_points * sizeof(tsReal));
+	if (!*points)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_sample_into(
+			spline, num, *points, len_points, actual_num, status))
+	TS_CATCH(err)
+		ts_int_free(*points);
+		*points = NULL;
+	TS_END_TRY_RETURN(err)
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_sample(const tsBSpline *spline, size_t num, tsReal **points,
+	size_t *actual_num, tsStatus *status)
+{
+	TS_INT_STATS_CALL(SAMPLE, "ts_bspline_sample",
+		TS_INT_STATS_IMPL(ts_bspline_sample)(spline, num, points,
+			actual_num, status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_sample_into)(const tsBSpline *spline,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	num = ts_int_bspline_sample_num(spline, num);
+	*actual_num = num;
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	return ts_int_bspline_eval_range(spline, NULL, num, 0, num, points,
+		status);
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_sample_into(const tsBSpline *spline, size_t num,
+	tsReal *points, size_t capacity, size_t *actual_num, tsStatus *status)
+{
+	TS_INT_STATS_CALL(SAMPLE, "ts_bspline_sample_into",
+		TS_INT_STATS_IMPL(ts_bspline_sample_into)(spline, num, points,
+			capacity, actual_num, status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_sample_parallel)(const tsBSpline *spline,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	num = ts_int_bspline_sample_num(spline, num);
+	*actual_num = num;
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	return ts_int_bspline_eval_parallel(spline, NULL, num, points,
+		grain_size, executor, executor_data, status);
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_sample_parallel(const tsBSpline *spline, size_t num,
+	tsReal *points, size_t capacity, size_t *actual_num,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(SAMPLE, "ts_bspline_sample_parallel",
+		TS_INT_STATS_IMPL(ts_bspline_sample_parallel)(spline, num,
+			points, capacity, actual_num, grain_size, executor,
+			executor_data, status))
+}
+#endif
+
+/**
+ * Defines ts_int_bspline_eval_all_##suffix, which evaluates \p spline at the
+ * \p num knots \p us, or at the knots of ts_int_sample_knot if \p us is NULL,
+ * and stores the resultant points in type \p T (cf. ts_bspline_eval_all_f
+ * and ts_bspline_sample_f). Each chunk of ::TS_INT_NUM_LANES knots is
+ * converted to (or generated in) tsReal and passed to
+ * ts_int_bspline_eval_lanes_##suffix.
+ */
+#define TS_INT_DEFINE_EVAL_ALL(T, suffix)                                     \
+tsError ts_int_bspline_eval_all_##suffix(const tsBSpline *spline,             \
+	const T *us, size_t num, T *points, size_t capacity,                  \
+	tsStatus *status)                                                     \
+{                                                                             \
+	const size_t order = ts_bspline_order(spline);                        \
+	const size_t dim = ts_bspline_dimension(spline);                      \
+	const size_t len_work = TS_INT_NUM_LANES * order * dim;               \
+	const size_t len_scratch = (order + 1) * dim;                         \
+	/* len_work <= TS_INT_STACK_BUFFER_LEN implies that len_scratch <=    \
+	 * 2 * TS_INT_STACK_BUFFER_LEN / TS_INT_NUM_LANES. */                 \
+	T stack[TS_INT_STACK_BUFFER_LEN];                                     \
+	tsReal stack_scratch[2 * TS_INT_STACK_BUFFER_LEN / TS_INT_NUM_LANES]; \
+	T *work = stack;                                                      \
+	tsReal *scratch = stack_scratch;                                      \
+	tsReal knots[TS_INT_NUM_LANES];                                       \
+	tsReal min, max;                                                      \
+	size_t cursor = ts_bspline_num_knots(spline); /* no hint */           \
+	size_t i, j, n;                                                       \
+	tsError err;                                                          \
+	if (capacity < num * dim) {                                           \
+		TS_RETURN_2(status, TS_NUM_POINTS,                            \
+			"capacity (%lu) < num(points) * dimension (%lu)",     \
+			(unsigned long) capacity, (unsigned long) (num * dim))\
+	}                                                                     \
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {                             \
+		/* The size of work is a multiple of TS_INT_NUM_LANES values  \
+		 * of T. Thus, scratch is suitably aligned. */                \
+		work = (T *) ts_int_malloc(len_work * sizeof(T) +             \
+			len_scratch * sizeof(tsReal));                        \
+		if (!work)                                                    \
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")       \
+		scratch = (tsReal *) (work + len_work);                       \
+	}                                                                     \
+	ts_bspline_domain(spline, &min, &max);                                \
+	TS_TRY(try, err, status)                                              \
+		for (i = 0; i < num; i += TS_INT_NUM_LANES) {                 \
+			n = num - i < TS_INT_NUM_LANES                        \
+				? num - i : TS_INT_NUM_LANES;                 \
+			for (j = 0; j < n; j++) {                             \
+				knots[j] = us ? (tsReal) us[i + j]            \
+					: ts_int_sample_knot(                 \
+						min, max, num, i + j);        \
+			}                                                     \
+			TS_CALL(try, err, ts_int_bspline_eval_lanes_##suffix( \
+				spline, knots, n, &cursor, work, scratch,     \
+				points + i * dim, status))                    \
+		}                                                             \
+	TS_FINALLY                                                            \
+		if (work != stack)                                            \
+			ts_int_free(work);                                    \
+	TS_END_TRY_RETURN(err)                                                \
+}
+
+TS_INT_DEFINE_EVAL_ALL(float, f)
+TS_INT_DEFINE_EVAL_ALL(double, d)
+
+tsError ts_bspline_eval_all_f(const tsBSpline *spline, const float *us,
+	size_t num, float *points, size_t capacity, tsStatus *status)
+{
+	return ts_int_bspline_eval_all_f(spline, us, num, points, capacity,
+		status);
+}
+
+tsError ts_bspline_eval_all_d(const tsBSpline *spline, const double *us,
+	size_t num, double *points, size_t capacity, tsStatus *status)
+{
+	return ts_int_bspline_eval_all_d(spline, us, num, points, capacity,
+		status);
+}
+
+tsError ts_bspline_sample_f(const tsBSpline *spline, size_t num,
+	float *points, size_t capacity, size_t *actual_num, tsStatus *status)
+{
+	*actual_num = ts_int_bspline_sample_num(spline, num);
+	return ts_int_bspline_eval_all_f(spline, NULL, *actual_num, points,
+		capacity, status);
+}
+
+tsError ts_bspline_sample_d(const tsBSpline *spline, size_t num,
+	double *points, size_t capacity, size_t *actual_num, tsStatus *status)
+{
+	*actual_num = ts_int_bspline_sample_num(spline, num);
+	return ts_int_bspline_eval_all_d(spline, NULL, *actual_num, points,
+		capacity, status);
+}
+
+/**
+ * Like ts_int_bspline_eval_range, but divides the resultant (homogeneous)
+ * points by their weight, i.e., their last component, and stores the first
+ * dim - 1 components only (cf. ts_bspline_eval_rational_all). The points of
+ * each chunk of ::TS_INT_NUM_LANES knots are computed into \p work by
+ * ts_int_bspline_eval_lanes and divided while they are still in cache.
+ * \p work must be able to store (ts_bspline_order(spline) + 1) *
+ * ts_bspline_dimension(spline) * ::TS_INT_NUM_LANES values.
+ */
+tsError ts_int_bspline_eval_rational_range(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t begin, size_t end,
+	tsReal *points, tsReal *work, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t edim = dim - 1; /**< Dimension without the weight. */
+	tsReal *hom = work + TS_INT_NUM_LANES *
+		ts_bspline_order(spline) * dim; /**< Homogeneous points. */
+	tsReal knots[TS_INT_NUM_LANES];
+	size_t cursor = ts_bspline_num_knots(spline); /* no hint */
+	size_t i, j, n, d;
+	tsReal min, max, w;
+	const tsReal *h;
+	tsReal *p;
+	tsError err;
+
+	ts_bspline_domain(spline, &min, &max);
+	for (i = begin; i < end; i += TS_INT_NUM_LANES) {
+		n = end - i < TS_INT_NUM_LANES ? end - i : TS_INT_NUM_LANES;
+		for (j = 0; !us && j < n; j++)
+			knots[j] = ts_int_sample_knot(min, max, num, i + j);
+		TS_CALL_ROE(err, ts_int_bspline_eval_lanes(spline,
+			us ? us + i : knots, n, &cursor, work, hom, status))
+		for (j = 0; j < n; j++) {
+			h = hom + j * dim;
+			p = points + (i + j) * edim;
+			w = 1.f / h[edim];
+			for (d = 0; d < edim; d++)
+				p[d] = h[d] * w;
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Checks whether \p spline has a weight and \p capacity suffices to store
+ * \p num points without weight.
+ */
+tsError ts_int_bspline_check_rational(const tsBSpline *spline, size_t num,
+	size_t capacity, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	if (dim < 2) {
+		TS_RETURN_0(status, TS_DIM_ZERO,
+			"unsupported dimension (without weight): 0")
+	}
+	if (capacity < num * (dim - 1)) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * (dimension - 1) (%lu)",
+			(unsigned long) capacity,
+			(unsigned long) (num * (dim - 1)))
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Allocates the workspace of ts_int_bspline_eval_rational_range and
+ * evaluates the knots [0, \p num).
+ */
+tsError ts_int_bspline_eval_rational_all(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status)
+{
+	const size_t len_work = (ts_bspline_order(spline) + 1) *
+		ts_bspline_dimension(spline) * TS_INT_NUM_LANES;
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	tsError err;
+
+	TS_CALL_ROE(err, ts_int_bspline_check_rational(
+		spline, num, capacity, status))
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	err = ts_int_bspline_eval_rational_range(spline, us, num, 0, num,
+		points, work, status);
+	if (work != stack)
+		ts_int_free(work);
+	return err;
+}
+
+tsError ts_bspline_eval_rational_point(const tsBSpline *spline, tsReal u,
+	tsReal *point, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	return ts_int_bspline_eval_rational_all(spline, &u, 1, point,
+		dim > 0 ? dim - 1 : 0, status);
+}
+
+tsError ts_bspline_eval_rational_all(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status)
+{
+	return ts_int_bspline_eval_rational_all(spline, us, num, points,
+		capacity, status);
+}
+
+tsError ts_bspline_sample_rational(const tsBSpline *spline, size_t num,
+	tsReal *points, size_t capacity, size_t *actual_num, tsStatus *status)
+{
+	*actual_num = ts_int_bspline_sample_num(spline, num);
+	return ts_int_bspline_eval_rational_all(spline, NULL, *actual_num,
+		points, capacity, status);
+}
+
+tsError ts_bspline_eval_rational_derivs_all(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t n, tsReal *derivs,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t edim = dim - 1; /**< Dimension without the weight. */
+	const size_t len_derivs = ts_int_bspline_len_work_derivs(spline, n);
+	const size_t len_work = len_derivs + (n + 1) * dim;
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	tsReal *hom; /**< Homogeneous derivatives of a knot. */
+	size_t cursor = ts_bspline_num_knots(spline); /* no hint */
+	size_t i, k, j, d;
+	tsReal bin, wj, w;
+	tsReal *c, *ck;
+	tsError err;
+
+	if (dim < 2) {
+		TS_RETURN_0(status, TS_DIM_ZERO,
+			"unsupported dimension (without weight): 0")
+	}
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	hom = work + len_derivs;
+	TS_TRY(try, err, status)
+		for (i = 0; i < num; i++) {
+			TS_CALL(try, err, ts_int_bspline_eval_derivs(spline,
+				us[i], n, &cursor, work, hom, status))
+			/* Based on 'The NURBS Book' (Les Piegl and Wayne
+			 * Tiller), algorithm A4.2:
+			 * C(k) = (A(k) - sum_j binom(k, j) w(j) C(k-j)) / w */
+			c = derivs + i * (n + 1) * edim;
+			w = 1.f / hom[edim];
+			for (k = 0; k <= n; k++) {
+				ck = c + k * edim;
+				for (d = 0; d < edim; d++)
+					ck[d] = hom[k * dim + d];
+				bin = 1.f;
+				for (j = 1; j <= k; j++) {
+					bin = bin * (tsReal) (k - j + 1) /
+						(tsReal) j;
+					wj = bin * hom[j * dim + edim];
+					for (d = 0; d < edim; d++) {
+						ck[d] -= wj *
+							c[(k - j) * edim + d];
+					}
+				}
+				for (d = 0; d < edim; d++)
+					ck[d] *= w;
+			}
+		}
+	TS_FINALLY
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_eval_rational_derivs(const tsBSpline *spline, tsReal u,
+	size_t n, tsReal *derivs, tsStatus *status)
+{
+	return ts_bspline_eval_rational_derivs_all(spline, &u, 1, n, derivs,
+		status);
+}
+
+/**
+ * Returns whether \p x <= \p y with respect to ts_knots_equal.
+ */
+int ts_int_knot_le(tsReal x, tsReal y)
+{
+	return x < y || ts_knots_equal(x, y);
+}
+
+/**
+ * Evaluates the Bezier curve with \p order control points \p ctrlp at \p t
+ * using De Casteljau's algorithm and stores the result in \p point. \p t may
+ * be outside of [0, 1], in which case the polynomial of the curve is
+ * extrapolated. \p work must be able to store \p order * \p dim values.
+ */
+void ts_int_bezier_eval(const tsReal *ctrlp, size_t order, size_t dim,
+	tsReal t, tsReal *work, tsReal *point)
+{
+	const tsReal t_hat = 1.f - t;
+	size_t r, j, d;
+	tsReal *p;
+	memcpy(work, ctrlp, order * dim * sizeof(tsReal));
+	for (r = 1; r < order; r++) {
+		for (j = 0; j < order - r; j++) {
+			p = work + j * dim;
+			for (d = 0; d < dim; d++)
+				p[d] = t_hat * p[d] + t * p[d + dim];
+		}
+	}
+	memcpy(point, work, dim * sizeof(tsReal));
+}
+
+/**
+ * Like ts_int_bezier_eval, but additionally stores the first and second
+ * derivative of the Bezier curve at \p t in \p first and \p second. The
+ * derivatives are taken from the intermediate points of De Casteljau's
+ * algorithm, i.e., they do not require further evaluations.
+ */
+void ts_int_bezier_eval_derivs(const tsReal *ctrlp, size_t order, size_t dim,
+	tsReal t, tsReal *work, tsReal *point, tsReal *first, tsReal *second)
+{
+	const size_t deg = order - 1;
+	const tsReal t_hat = 1.f - t;
+	size_t r, j, d;
+	tsReal *p;
+	memcpy(work, ctrlp, order * dim * sizeof(tsReal));
+	for (d = 0; d < dim; d++)
+		first[d] = second[d] = 0.f;
+	for (r = 1; r < order; r++) {
+		/* order - r + 1 points are left. */
+		if (order - r == 2) {
+			for (d = 0; d < dim; d++) {
+				second[d] = (tsReal) (deg * (deg - 1)) *
+					(work[2 * dim + d] -
+					 2.f * work[dim + d] + work[d]);
+			}
+		} else if (order - r == 1) {
+			for (d = 0; d < dim; d++) {
+				first[d] = (tsReal) deg *
+					(work[dim + d] - work[d]);
+			}
+		}
+		for (j = 0; j < order - r; j++) {
+			p = work + j * dim;
+			for (d = 0; d < dim; d++)
+				p[d] = t_hat * p[d] + t * p[d + dim];
+		}
+	}
+	memcpy(point, work, dim * sizeof(tsReal));
+}
+
+tsError TS_INT_STATS_IMPL(ts_bspline_sample_fast)(const tsBSpline *spline,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsReal *error, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_point = dim * sizeof(tsReal);
+	const size_t len_work = (2 * order + 1) * dim;
+
+	tsBSpline beziers = ts_bspline_init();
+	const tsReal *ctrlp, *knots;  /**< Of `beziers`. */
+	size_t num_segments;          /**< Number of Bezier segments. */
+
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack; /**< De Casteljau's algorithm. */
+	tsReal *diffs;        /**< Forward differences of a run. */
+	tsReal *point;        /**< Exact point of a run. */
+
+	tsReal min, max;  /**< Domain of \p spline. */
+	tsReal a, b;      /**< Domain of the current segment. */
+	tsReal du;        /**< Distance of sampled knots. */
+	tsReal h;         /**< du in the domain of the current segment. */
+	tsReal u, t, dist;
+	size_t seg, i, end, fd_end, run, m, k, d;
+	const tsReal *seg_ctrlp;
+	tsReal *out;
+	tsError err;
+
+	num = ts_int_bspline_sample_num(spline, num);
+	*actual_num = num;
+	if (error)
+		*error = 0;
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	ts_bspline_domain(spline, &min, &max);
+	if (num == 1)
+		return ts_bspline_eval_point(spline, min, points, status);
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	diffs = work + order * dim;
+	point = diffs + order * dim;
+
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		ctrlp = ts_int_bspline_access_ctrlp(&beziers);
+		knots = ts_int_bspline_access_knots(&beziers);
+		num_segments = ts_bspline_num_control_points(&beziers) / order;
+		du = (max - min) / (num - 1);
+		i = 0;
+		for (seg = 0; seg < num_segments; seg++) {
+			seg_ctrlp = ctrlp + seg * order * dim;
+			a = knots[seg * order];
+			b = knots[(seg + 1) * order];
+			h = du / (b - a);
+			/* The knots [i, end) are located in [a, b]. Knots
+			 * equal to b belong to this segment because
+			 * ts_bspline_eval takes the first of two points if
+			 * the spline is discontinuous at b. */
+			end = num;
+			if (seg < num_segments - 1) {
+				end = (size_t) ((b - min) / du);
+				end = end > num ? num : end;
+				for (; end < num; end++) {
+					u = ts_int_sample_knot(
+						min, max, num, end);
+					if (!ts_int_knot_le(u, b))
+						break;
+				}
+				for (; end > i; end--) {
+					u = ts_int_sample_knot(
+						min, max, num, end - 1);
+					if (ts_int_knot_le(u, b))
+						break;
+				}
+			}
+			/* Like ts_bspline_eval, snap knots that are equal to
+			 * (but may slightly differ from) a or b. */
+			for (fd_end = end; fd_end > i; fd_end--) {
+				u = ts_int_sample_knot(
+					min, max, num, fd_end - 1);
+				if (!ts_knots_equal(u, b))
+					break;
+				memcpy(points + (fd_end - 1) * dim,
+					seg_ctrlp + deg * dim, sof_point);
+			}
+			for (; i < fd_end; i++) {
+				u = ts_int_sample_knot(min, max, num, i);
+				if (!ts_knots_equal(u, a))
+					break;
+				memcpy(points + i * dim, seg_ctrlp, sof_point);
+			}
+			for (; i < fd_end; i += run) {
+				run = fd_end - i < TS_INT_FORWARD_DIFF_STEPS
+					? fd_end - i : TS_INT_FORWARD_DIFF_STEPS;
+				/* Compute the forward differences from the
+				 * exact points at t, t + h, ..., t + deg*h. */
+				t = (ts_int_sample_knot(min, max, num, i) - a)
+					/ (b - a);
+				for (k = 0; k <= deg; k++) {
+					ts_int_bezier_eval(seg_ctrlp, order,
+						dim, t + k*h, work,
+						diffs + k * dim);
+				}
+				for (k = 1; k <= deg; k++) {
+					for (m = deg; m >= k; m--) {
+						out = diffs + m * dim;
+						for (d = 0; d < dim; d++)
+							out[d] -= out[d - dim];
+					}
+				}
+				/* Generate the points of the run. */
+				memcpy(points + i * dim, diffs, sof_point);
+				for (m = 1; m < run; m++) {
+					for (k = 0; k < deg; k++) {
+						out = diffs + k * dim;
+						for (d = 0; d < dim; d++)
+							out[d] += out[d + dim];
+					}
+					memcpy(points + (i+m) * dim, diffs,
+						sof_point);
+				}
+				/* The error accumulates towards the end of
+				 * the run. */
+				if (error && run > 1) {
+					t = ts_int_sample_knot(min, max, num,
+						i + run - 1);
+					t = (t - a) / (b - a);
+					ts_int_bezier_eval(seg_ctrlp, order,
+						dim, t, work, point);
+					dist = ts_distance(point, diffs, dim);
+					*error = dist > *error ? dist : *error;
+				}
+			}
+			i = end;
+		}
+		/* Pin the last point to the end of the spline. */
+		memcpy(points + (num - 1) * dim,
+			ctrlp + ts_bspline_len_control_points(&beziers) - dim,
+			sof_point);
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_sample_fast(const tsBSpline *spline, size_t num,
+	tsReal *points, size_t capacity, size_t *actual_num, tsReal *error,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(SAMPLE, "ts_bspline_sample_fast",
+		TS_INT_STATS_IMPL(ts_bspline_sample_fast)(spline, num, points,
+			capacity, actual_num, error, status))
+}
+#endif
+
+/**
+ * Appends \p point to the buffer \p points (cf. ts_bspline_sample_adaptive),
+ * which is grown if necessary.
+ */
+tsError ts_int_append_point(const tsReal *point, size_t dim, tsReal **points,
+	size_t *capacity, size_t *num, tsStatus *status)
+{
+	size_t cap = *capacity;
+	tsReal *buffer;
+	if ((*num + 1) * dim > cap) {
+		cap = cap * 2 < 64 * dim ? 64 * dim : cap * 2;
+		buffer = (tsReal *) ts_int_realloc(*points,
+			cap * sizeof(tsReal));
+		if (!buffer)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		*points = buffer;
+		*capacity = cap;
+	}
+	memcpy(*points + *num * dim, point, dim * sizeof(tsReal));
+	(*num)++;
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Returns the maximum distance of the inner control points of the Bezier
+ * curve with \p order control points \p ctrlp to the line segment connecting
+ * its first and its last control point. Since a Bezier curve is located in
+ * the convex hull of its control points, the distance of the curve to the
+ * line segment is less than or equal to the returned value.
+ */
+tsReal ts_int_bezier_flatness(const tsReal *ctrlp, size_t order, size_t dim)
+{
+	const tsReal *first = ctrlp;
+	const tsReal *last = ctrlp + (order - 1) * dim;
+	const tsReal *p;
+	tsReal len2, dot, t, diff, dist, max = 0;
+	size_t i, d;
+	len2 = 0;
+	for (d = 0; d < dim; d++)
+		len2 += (last[d] - first[d]) * (last[d] - first[d]);
+	for (i = 1; i + 1 < order; i++) {
+		p = ctrlp + i * dim;
+		/* Project p onto the line segment. */
+		t = 0;
+		if (len2 > 0) {
+			dot = 0;
+			for (d = 0; d < dim; d++)
+				dot += (p[d] - first[d]) * (last[d] - first[d]);
+			t = dot / len2;
+			t = t < 0 ? 0 : t > 1 ? 1 : t;
+		}
+		dist = 0;
+		for (d = 0; d < dim; d++) {
+			diff = p[d] - (first[d] + t * (last[d] - first[d]));
+			dist += diff * diff;
+		}
+		max = dist > max ? dist : max;
+	}
+	return (tsReal) sqrt(max);
+}
+
+/**
+ * Splits the Bezier curve with \p order control points \p ctrlp at t = 0.5
+ * and stores the control points of the first half in \p left and those of
+ * the second half in \p right. \p left may be equal to \p ctrlp.
+ */
+void ts_int_bezier_split(const tsReal *ctrlp, size_t order, size_t dim,
+	tsReal *left, tsReal *right)
+{
+	const size_t sof_point = dim * sizeof(tsReal);
+	size_t r, j, d;
+	tsReal *p;
+	memcpy(right, ctrlp, order * sof_point);
+	for (r = 1; r < order; r++) {
+		memcpy(left + (r - 1) * dim, right, sof_point);
+		for (j = 0; j < order - r; j++) {
+			p = right + j * dim;
+			for (d = 0; d < dim; d++)
+				p[d] = (p[d] + p[d + dim]) / 2;
+		}
+	}
+	memcpy(left + (order - 1) * dim, right, sof_point);
+}
+
+tsError TS_INT_STATS_IMPL(ts_bspline_sample_adaptive)(const tsBSpline *spline,
+	tsReal tolerance, tsReal **points, size_t *capacity, size_t *num,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t len_curve = order * dim;
+	const size_t len_work = (TS_INT_MAX_SUBDIVISIONS + 1) * len_curve;
+	const tsReal tol = (tsReal) fabs(tolerance);
+
+	tsBSpline beziers = ts_bspline_init();
+	const tsReal *ctrlp;  /**< Of `beziers`. */
+	size_t num_segments;  /**< Number of Bezier segments. */
+
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	tsReal *curve;   /**< The curve to subdivide. */
+	tsReal *pending; /**< Second halves yet to process (LIFO). */
+	size_t depths[TS_INT_MAX_SUBDIVISIONS]; /**< Of `pending`. */
+	size_t top;      /**< Number of curves in `pending`. */
+	size_t depth;    /**< Depth of `curve`. */
+	size_t seg;
+	tsReal dist;
+	tsError err;
+
+	*num = 0;
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	curve = work;
+	pending = work + len_curve;
+
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		ctrlp = ts_int_bspline_access_ctrlp(&beziers);
+		num_segments = ts_bspline_num_control_points(&beziers) / order;
+		for (seg = 0; seg < num_segments; seg++) {
+			memcpy(curve, ctrlp + seg * len_curve,
+				len_curve * sizeof(tsReal));
+			/* Add the first point of the spline and the first
+			 * point of segments that are not connected to their
+			 * predecessor (the spline may have gaps). */
+			dist = 0;
+			if (seg > 0) {
+				dist = ts_distance(curve,
+					*points + (*num - 1) * dim, dim);
+			}
+			if (deg > 0 && (seg == 0 || dist > tol)) {
+				TS_CALL(try, err, ts_int_append_point(curve,
+					dim, points, capacity, num, status))
+			}
+			depth = top = 0;
+			for (;;) {
+				if (depth < TS_INT_MAX_SUBDIVISIONS &&
+					ts_int_bezier_flatness(curve, order,
+						dim) > tol) {
+					ts_int_bezier_split(curve, order, dim,
+						curve,
+						pending + top * len_curve);
+					depths[top++] = ++depth;
+					continue;
+				}
+				TS_CALL(try, err, ts_int_append_point(
+					curve + deg * dim, dim, points,
+					capacity, num, status))
+				if (top == 0)
+					break;
+				top--;
+				memcpy(curve, pending + top * len_curve,
+					len_curve * sizeof(tsReal));
+				depth = depths[top];
+			}
+		}
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_sample_adaptive(const tsBSpline *spline, tsReal tolerance,
+	tsReal **points, size_t *capacity, size_t *num, tsStatus *status)
+{
+	TS_INT_STATS_CALL(SAMPLE, "ts_bspline_sample_adaptive",
+		TS_INT_STATS_IMPL(ts_bspline_sample_adaptive)(spline, tolerance,
+			points, capacity, num, status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_bisect)(const tsBSpline *spline,
+	tsReal value, tsReal epsilon, int persnickety, size_t index,
+	int ascending, size_t max_iter, tsDeBoorNet *net, tsStatus *status)
+{
+	tsError err;
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t len_work = (ts_bspline_order(spline) + 1) * dim;
+	const tsReal eps = (tsReal) fabs(epsilon);
+	size_t i = 0;
+	tsReal dist = 0;
+	tsReal min, max, mid;
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	tsReal *P;
+
+	ts_int_deboornet_init(net);
+
+	if (dim < index) {
+		TS_RETURN_2(status, TS_INDEX_ERROR,
+			"dimension (%lu) <= index (%lu)",
+			(unsigned long) dim,
+			(unsigned long) index)
+	}
+	if(max_iter == 0)
+		TS_RETURN_0(status, TS_NO_RESULT, "0 iterations")
+
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	/* The first `dim` values of `work` store the current point. */
+	P = work;
+
+	ts_bspline_domain(spline, &min, &max);
+	TS_TRY(try, err, status)
+		do {
+			mid = (tsReal) ((min + max) / 2.0);
+			TS_CALL(try, err, ts_int_bspline_eval_point(
+				spline, mid, NULL, work + dim, P, status))
+			dist = ts_distance(&P[index], &value, 1);
+			if (dist <= eps)
+				break;
+			if (ascending) {
+				if (P[index] < value)
+					min = mid;
+				else
+					max = mid;
+			} else {
+				if (P[index] < value)
+					max = mid;
+				else
+					min = mid;
+			}
+		} while (i++ < max_iter);
+		if (dist > eps && persnickety) {
+			TS_THROW_1(try, err, status, TS_NO_RESULT,
+				"maximum iterations (%lu) exceeded",
+				(unsigned long) max_iter)
+		}
+		/* Only the final point requires the full net. */
+		TS_CALL(try, err, ts_bspline_eval(
+			spline, mid, net, status))
+	TS_CATCH(err)
+		ts_deboornet_free(net);
+	TS_FINALLY
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_bisect(const tsBSpline *spline, tsReal value,
+	tsReal epsilon, int persnickety, size_t index, int ascending,
+	size_t max_iter, tsDeBoorNet *net, tsStatus *status)
+{
+	TS_INT_STATS_CALL(BISECT, "ts_bspline_bisect",
+		TS_INT_STATS_IMPL(ts_bspline_bisect)(spline, value, epsilon,
+			persnickety, index, ascending, max_iter, net, status))
+}
+#endif
+
+/**
+ * Returns the number of control points of \p spline whose component \p index
+ * (multiplied with \p sign) is less than \p value (\p or_equal == 0) or less
+ * than or equal to \p value (\p or_equal != 0). The control points must be
+ * sorted in ascending order with respect to \p sign.
+ */
+size_t ts_int_bspline_count_ctrlp(const tsBSpline *spline, size_t index,
+	tsReal sign, tsReal value, int or_equal)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	size_t low = 0, high = ts_bspline_num_control_points(spline), mid;
+	tsReal p;
+	while (low < high) {
+		mid = (low + high) / 2;
+		p = sign * ctrlp[mid * dim + index];
+		if (p < value || (or_equal && !(p > value)))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+/**
+ * Evaluates component \p index of \p spline and its first derivative at \p u,
+ * which must be within the domain of \p spline. In contrast to
+ * ts_int_bspline_eval_point, only the required component is computed. The
+ * derivative is obtained from the last but one level of De Boor's algorithm.
+ * \p work must be able to store ts_bspline_order(spline) values.
+ */
+void ts_int_bspline_eval_component(const tsBSpline *spline, tsReal u,
+	size_t index, tsReal *work, tsReal *value, tsReal *derivative)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	size_t low = deg, high = ts_bspline_num_control_points(spline) - 1;
+	size_t k, r, j;
+	tsReal ui, a;
+
+	/* The last span [u_k, u_k+1) of the domain with u_k <= u. */
+	while (low < high) {
+		k = (low + high + 1) / 2;
+		if (knots[k] <= u)
+			low = k;
+		else
+			high = k - 1;
+	}
+	k = low;
+
+	for (j = 0; j <= deg; j++)
+		work[j] = ctrlp[(k - deg + j) * dim + index];
+	*derivative = 0;
+	for (r = 1; r <= deg; r++) {
+		if (r == deg) {
+			*derivative = (work[deg] - work[deg - 1]) *
+				(tsReal) deg / (knots[k + 1] - knots[k]);
+		}
+		for (j = deg; j >= r; j--) {
+			ui = knots[k - deg + j];
+			a = (u - ui) / (knots[k + 1 + j - r] - ui);
+			work[j] = (1.f - a) * work[j - 1] + a * work[j];
+		}
+	}
+	*value = work[deg];
+}
+
+/**
+ * Refines the bracket [\p low, \p high] of the knot \p u at which component
+ * \p index of \p spline is closest to \p value, where \p f_low and \p f_high
+ * are the values of the component at \p low and \p high. \p value, \p f_low,
+ * and \p f_high are multiplied with \p sign (so that the component is
+ * ascending). Starting with a linear interpolation, safeguarded Newton
+ * iterations are run in the bracket. Steps leaving the bracket fall back to
+ * bisection. \p found is set to 1 if the distance of the component and
+ * \p value is less than or equal to \p eps (and 0 otherwise). \p work is
+ * used as in ts_int_bspline_eval_component.
+ */
+void ts_int_bspline_refine(const tsBSpline *spline, tsReal value, tsReal eps,
+	size_t index, tsReal sign, size_t max_iter, tsReal *work, tsReal low,
+	tsReal high, tsReal f_low, tsReal f_high, tsReal *u, int *found)
+{
+	size_t i;
+	tsReal f, df, next, dist, best;
+
+	if (!(value > f_low)) {
+		*u = low;
+		*found = f_low - value <= eps;
+		return;
+	}
+	if (!(value < f_high)) {
+		*u = high;
+		*found = value - f_high <= eps;
+		return;
+	}
+
+	/* Regula falsi step as initial guess. */
+	next = low + (high - low) * (value - f_low) / (f_high - f_low);
+	best = f_high - value;
+	*u = high;
+	for (i = 0; i < max_iter; i++) {
+		ts_int_bspline_eval_component(spline, next, index, work, &f,
+			&df);
+		f *= sign;
+		df *= sign;
+		dist = (tsReal) fabs(f - value);
+		if (dist < best) {
+			best = dist;
+			*u = next;
+		}
+		if (dist <= eps)
+			break;
+		if (f < value)
+			low = next;
+		else
+			high = next;
+		if (df > 0)
+			next -= (f - value) / df;
+		if (!(df > 0) || !(next > low && next < high)) {
+			next = (tsReal) ((low + high) / 2.0);
+			/* The bracket cannot be narrowed anymore. */
+			if (!(next > low && next < high))
+				break;
+		}
+	}
+	*found = best <= eps;
+}
+
+/**
+ * Finds the knot \p u at which component \p index of \p spline is closest to
+ * \p value (cf. ts_bspline_solve). First, the range of spans whose control
+ * points enclose \p value is determined by binary searching the (sorted)
+ * control points, which gives a bracket that is usually much smaller than the
+ * domain of \p spline. Then, the bracket is refined with
+ * ts_int_bspline_refine.
+ */
+void ts_int_bspline_solve(const tsBSpline *spline, tsReal value, tsReal eps,
+	size_t index, int ascending, size_t max_iter, tsReal *work, tsReal *u,
+	int *found)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const tsReal sign = ascending ? (tsReal) 1.0 : (tsReal) -1.0;
+	size_t first; /**< First span enclosing `value`. */
+	size_t last;  /**< Last span enclosing `value`. */
+	size_t num;
+	tsReal min, max, low, high, f_low, f_high, df;
+
+	value *= sign;
+	ts_bspline_domain(spline, &min, &max);
+	/* The points of span k lie within the control points k-deg ... k.
+	 * Thus, span k encloses `value` if P[k-deg] <= value <= P[k]. */
+	first = ts_int_bspline_count_ctrlp(spline, index, sign, value, 0);
+	num = ts_int_bspline_count_ctrlp(spline, index, sign, value, 1);
+	first = first < deg ? deg : first;
+	first = first > n_ctrlp - 1 ? n_ctrlp - 1 : first;
+	last = num == 0 ? deg : num - 1 + deg;
+	last = last > n_ctrlp - 1 ? n_ctrlp - 1 : last;
+	if (first > last) {
+		first = deg;
+		last = n_ctrlp - 1;
+	}
+	low = knots[first] < min ? min : knots[first];
+	high = knots[last + 1] > max ? max : knots[last + 1];
+
+	ts_int_bspline_eval_component(spline, low, index, work, &f_low, &df);
+	ts_int_bspline_eval_component(spline, high, index, work, &f_high,
+		&df);
+	f_low *= sign;
+	f_high *= sign;
+	if ((value < f_low || value > f_high) && (low > min || high < max)) {
+		/* Rounding errors; fall back to the whole domain. */
+		low = min;
+		high = max;
+		ts_int_bspline_eval_component(spline, low, index, work,
+			&f_low, &df);
+		ts_int_bspline_eval_component(spline, high, index, work,
+			&f_high, &df);
+		f_low *= sign;
+		f_high *= sign;
+	}
+	ts_int_bspline_refine(spline, value, eps, index, sign, max_iter, work,
+		low, high, f_low, f_high, u, found);
+}
+
+tsError ts_int_bspline_solve_check(const tsBSpline *spline, size_t index,
+	size_t max_iter, tsStatus *status)
+{
+	if (index >= ts_bspline_dimension(spline)) {
+		TS_RETURN_2(status, TS_INDEX_ERROR,
+			"dimension (%lu) <= index (%lu)",
+			(unsigned long) ts_bspline_dimension(spline),
+			(unsigned long) index)
+	}
+	if(max_iter == 0)
+		TS_RETURN_0(status, TS_NO_RESULT, "0 iterations")
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_solve(const tsBSpline *spline, tsReal value,
+	tsReal epsilon, int persnickety, size_t index, int ascending,
+	size_t max_iter, tsDeBoorNet *net, tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	tsReal u;
+	int found;
+	tsError err;
+
+	ts_int_deboornet_init(net);
+	TS_CALL_ROE(err, ts_int_bspline_solve_check(spline, index, max_iter,
+		status))
+	if (order > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(order * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+
+	TS_TRY(try, err, status)
+		ts_int_bspline_solve(spline, value, (tsReal) fabs(epsilon),
+			index, ascending, max_iter, work, &u, &found);
+		if (!found && persnickety) {
+			TS_THROW_1(try, err, status, TS_NO_RESULT,
+				"maximum iterations (%lu) exceeded",
+				(unsigned long) max_iter)
+		}
+		TS_CALL(try, err, ts_bspline_eval(spline, u, net, status))
+	TS_CATCH(err)
+		ts_deboornet_free(net);
+	TS_FINALLY
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_solve_all(const tsBSpline *spline, const tsReal *values,
+	size_t num, tsReal epsilon, int persnickety, size_t index,
+	int ascending, size_t max_iter, tsReal *us, tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	const tsReal eps = (tsReal) fabs(epsilon);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t i;
+	int found;
+	tsError err;
+
+	TS_CALL_ROE(err, ts_int_bspline_solve_check(spline, index, max_iter,
+		status))
+	if (order > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(order * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+
+	TS_TRY(try, err, status)
+		for (i = 0; i < num; i++) {
+			ts_int_bspline_solve(spline, values[i], eps, index,
+				ascending, max_iter, work, us + i, &found);
+			if (!found && persnickety) {
+				TS_THROW_2(try, err, status, TS_NO_RESULT,
+					"maximum iterations (%lu) exceeded "
+					"at value %lu",
+					(unsigned long) max_iter,
+					(unsigned long) i)
+			}
+		}
+	TS_FINALLY
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+void ts_bspline_domain(const tsBSpline *spline, tsReal *min, tsReal *max)
+{
+	*min = ts_int_bspline_access_knots(spline)
+		[ts_bspline_degree(spline)];
+	*max = ts_int_bspline_access_knots(spline)
+		[ts_bspline_num_knots(spline) - ts_bspline_order(spline)];
+}
+
+tsError ts_bspline_is_closed(const tsBSpline *spline, tsReal epsilon,
+	int *closed, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	tsBSpline derivative;
+	tsReal min, max;
+	tsDeBoorNet first, last;
+	size_t i;
+	tsError err;
+
+	ts_int_bspline_init(&derivative);
+	ts_int_deboornet_init(&first);
+	ts_int_deboornet_init(&last);
+
+	TS_TRY(try, err, status)
+		for (i = 0; i < deg; i++) {
+			TS_CALL(try, err, ts_bspline_derive(
+				spline, i, -1.f, &derivative, status))
+			ts_bspline_domain(&derivative, &min, &max);
+			TS_CALL(try, err, ts_bspline_eval(
+				&derivative, min, &first, status))
+			TS_CALL(try, err, ts_bspline_eval(
+				&derivative, max, &last, status))
+			*closed = ts_distance(
+				ts_int_deboornet_access_result(&first),
+				ts_int_deboornet_access_result(&last),
+				dim) <= epsilon ? 1 : 0;
+			ts_bspline_free(&derivative);
+			ts_deboornet_free(&first);
+			ts_deboornet_free(&last);
+			if (!*closed)
+				TS_RETURN_SUCCESS(status)
+		}
+	TS_FINALLY
+		ts_bspline_free(&derivative);
+		ts_deboornet_free(&first);
+		ts_deboornet_free(&last);
+	TS_END_TRY_RETURN(err)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Sampling Plan Functions                                                  *
+*                                                                             *
+******************************************************************************/
+tsSamplingPlan ts_sampling_plan_init()
+{
+	tsSamplingPlan plan;
+	ts_int_sampling_plan_init(&plan);
+	return plan;
+}
+
+tsError ts_sampling_plan_new(const tsBSpline *spline, const tsReal *us,
+	size_t num, tsSamplingPlan *plan, tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	size_t cursor = n_knots; /* no hint */
+	size_t size, i;
+	size_t *firsts;
+	tsReal *weights;
+	tsError err;
+
+	ts_int_sampling_plan_init(plan);
+	size = ts_int_sampling_plan_sof_firsts(num) +
+		(n_knots + num * order) * sizeof(tsReal);
+	plan->pImpl = (struct tsSamplingPlanImpl *) ts_int_malloc(size);
+	if (!plan->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	plan->pImpl->deg = ts_bspline_degree(spline);
+	plan->pImpl->n_knots = n_knots;
+	plan->pImpl->n_points = num;
+	memcpy(ts_int_sampling_plan_access_knots(plan),
+		ts_int_bspline_access_knots(spline),
+		ts_bspline_sof_knots(spline));
+	firsts = ts_int_sampling_plan_access_firsts(plan);
+	weights = ts_int_sampling_plan_access_weights(plan);
+
+	TS_TRY(try, err, status)
+		for (i = 0; i < num; i++) {
+			TS_CALL(try, err, ts_int_bspline_eval_basis(spline,
+				us[i], &cursor, firsts + i,
+				weights + i * order, status))
+		}
+	TS_CATCH(err)
+		ts_sampling_plan_free(plan);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_sampling_plan_copy(const tsSamplingPlan *src,
+	tsSamplingPlan *dest, tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_sampling_plan_init(dest);
+	size = ts_int_sampling_plan_sof_state(src);
+	dest->pImpl = (struct tsSamplingPlanImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_sampling_plan_move(tsSamplingPlan *src, tsSamplingPlan *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_sampling_plan_init(src);
+}
+
+void ts_sampling_plan_free(tsSamplingPlan *plan)
+{
+	if (plan->pImpl)
+		ts_int_free(plan->pImpl);
+	ts_int_sampling_plan_init(plan);
+}
+
+size_t ts_sampling_plan_num_points(const tsSamplingPlan *plan)
+{
+	return plan->pImpl->n_points;
+}
+
+tsError ts_sampling_plan_eval(const tsSamplingPlan *plan,
+	const tsBSpline *spline, tsReal *points, size_t capacity,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	const size_t num = ts_sampling_plan_num_points(plan);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const tsReal *plan_knots = ts_int_sampling_plan_access_knots(plan);
+	const size_t *firsts = ts_int_sampling_plan_access_firsts(plan);
+	const tsReal *weights = ts_int_sampling_plan_access_weights(plan);
+	const tsReal *p, *w;
+	tsReal *out;
+	size_t i, j, d;
+
+	if (deg != plan->pImpl->deg) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"degree (%lu) != degree(plan) (%lu)",
+			(unsigned long) deg,
+			(unsigned long) plan->pImpl->deg)
+	}
+	if (n_knots != plan->pImpl->n_knots) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"num(knots) (%lu) != num(knots(plan)) (%lu)",
+			(unsigned long) n_knots,
+			(unsigned long) plan->pImpl->n_knots)
+	}
+	for (i = 0; i < n_knots; i++) {
+		if (!ts_knots_equal(knots[i], plan_knots[i])) {
+			TS_RETURN_3(status, TS_INCOMPATIBLE,
+				"knot at index %lu (%f) != plan (%f)",
+				(unsigned long) i, knots[i], plan_knots[i])
+		}
+	}
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+
+	for (i = 0; i < num; i++) {
+		p = ctrlp + firsts[i] * dim;
+		w = weights + i * order;
+		out = points + i * dim;
+		for (d = 0; d < dim; d++)
+			out[d] = w[0] * p[d];
+		for (j = 1; j < order; j++) {
+			p += dim;
+			for (d = 0; d < dim; d++)
+				out[d] += w[j] * p[d];
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Compiled Spline Functions                                                *
+*                                                                             *
+******************************************************************************/
+tsCompiledSpline ts_compiled_spline_init()
+{
+	tsCompiledSpline compiled;
+	ts_int_compiled_spline_init(&compiled);
+	return compiled;
+}
+
+tsError ts_compiled_spline_new(const tsBSpline *spline,
+	tsCompiledSpline *compiled, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+
+	tsBSpline beziers = ts_bspline_init();
+	const tsReal *ctrlp, *knots; /**< Of `beziers`. */
+	tsReal *breaks, *scales, *coeffs, *c;
+	struct tsCompiledSplineImpl impl;
+	size_t n_spans, s, k, m, d;
+	tsReal width, bin;
+	tsError err;
+
+	ts_int_compiled_spline_init(compiled);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		ctrlp = ts_int_bspline_access_ctrlp(&beziers);
+		knots = ts_int_bspline_access_knots(&beziers);
+		n_spans = ts_bspline_num_control_points(&beziers) / order;
+		impl.deg = deg;
+		impl.dim = dim;
+		impl.n_spans = n_spans;
+		impl.n_samples = ts_int_bspline_sample_num(spline, 0);
+		impl.n_ctrlp = ts_bspline_num_control_points(spline);
+		impl.n_knots = ts_bspline_num_knots(spline);
+		compiled->pImpl = (struct tsCompiledSplineImpl *)
+			ts_int_malloc(ts_int_compiled_spline_sof_state(&impl));
+		if (!compiled->pImpl) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		*compiled->pImpl = impl;
+		memcpy(ts_int_compiled_spline_access_ctrlp(compiled),
+			ts_int_bspline_access_ctrlp(spline),
+			ts_bspline_sof_control_points(spline));
+		memcpy(ts_int_compiled_spline_access_knots(compiled),
+			ts_int_bspline_access_knots(spline),
+			ts_bspline_sof_knots(spline));
+		breaks = ts_int_compiled_spline_access_breaks(compiled);
+		scales = ts_int_compiled_spline_access_scales(compiled);
+		coeffs = ts_int_compiled_spline_access_coeffs(compiled);
+		for (s = 0; s < n_spans; s++) {
+			breaks[s] = knots[s * order];
+			width = knots[(s + 1) * order] - breaks[s];
+			scales[s] = width > 0 ? 1.f / width : 0.f;
+			/* The k'th power basis coefficient of a Bezier curve
+			 * is binomial(deg, k) times the k'th forward
+			 * difference of its control points. */
+			c = coeffs + s * order * dim;
+			memcpy(c, ctrlp + s * order * dim,
+				order * dim * sizeof(tsReal));
+			for (k = 1; k <= deg; k++) {
+				for (m = deg; m >= k; m--) {
+					for (d = 0; d < dim; d++) {
+						c[m * dim + d] -=
+							c[(m - 1) * dim + d];
+					}
+				}
+			}
+			bin = 1.f;
+			for (k = 1; k <= deg; k++) {
+				bin = bin * (tsReal) (deg - k + 1) / (tsReal) k;
+				for (d = 0; d < dim; d++)
+					c[k * dim + d] *= bin;
+			}
+		}
+		breaks[n_spans] = knots[n_spans * order];
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_compiled_spline_copy(const tsCompiledSpline *src,
+	tsCompiledSpline *dest, tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_compiled_spline_init(dest);
+	size = ts_int_compiled_spline_sof_state(src->pImpl);
+	dest->pImpl = (struct tsCompiledSplineImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_compiled_spline_move(tsCompiledSpline *src, tsCompiledSpline *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_compiled_spline_init(src);
+}
+
+void ts_compiled_spline_free(tsCompiledSpline *compiled)
+{
+	if (compiled->pImpl)
+		ts_int_free(compiled->pImpl);
+	ts_int_compiled_spline_init(compiled);
+}
+
+size_t ts_compiled_spline_dimension(const tsCompiledSpline *compiled)
+{
+	return compiled->pImpl->dim;
+}
+
+void ts_compiled_spline_domain(const tsCompiledSpline *compiled,
+	tsReal *min, tsReal *max)
+{
+	const tsReal *breaks = ts_int_compiled_spline_access_breaks(compiled);
+	*min = breaks[0];
+	*max = breaks[compiled->pImpl->n_spans];
+}
+
+tsError ts_compiled_spline_check(const tsCompiledSpline *compiled,
+	const tsBSpline *spline, tsStatus *status)
+{
+	const struct tsCompiledSplineImpl *impl = compiled->pImpl;
+	const size_t len_ctrlp = ts_bspline_len_control_points(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const tsReal *c_ctrlp = ts_int_compiled_spline_access_ctrlp(compiled);
+	const tsReal *c_knots = ts_int_compiled_spline_access_knots(compiled);
+	size_t i;
+
+	if (ts_bspline_degree(spline) != impl->deg) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"degree (%lu) != degree(compiled) (%lu)",
+			(unsigned long) ts_bspline_degree(spline),
+			(unsigned long) impl->deg)
+	}
+	if (ts_bspline_dimension(spline) != impl->dim) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"dimension (%lu) != dimension(compiled) (%lu)",
+			(unsigned long) ts_bspline_dimension(spline),
+			(unsigned long) impl->dim)
+	}
+	if (ts_bspline_num_control_points(spline) != impl->n_ctrlp) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"num(control points) (%lu) != "
+			"num(control points(compiled)) (%lu)",
+			(unsigned long) ts_bspline_num_control_points(spline),
+			(unsigned long) impl->n_ctrlp)
+	}
+	for (i = 0; i < len_ctrlp; i++) {
+		if (ctrlp[i] < c_ctrlp[i] || ctrlp[i] > c_ctrlp[i]) {
+			TS_RETURN_3(status, TS_INCOMPATIBLE,
+				"control point value at index %lu (%f) != "
+				"compiled (%f)", (unsigned long) i, ctrlp[i],
+				c_ctrlp[i])
+		}
+	}
+	for (i = 0; i < n_knots; i++) {
+		if (!ts_knots_equal(knots[i], c_knots[i])) {
+			TS_RETURN_3(status, TS_INCOMPATIBLE,
+				"knot at index %lu (%f) != compiled (%f)",
+				(unsigned long) i, knots[i], c_knots[i])
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Returns the index of the span of \p compiled containing \p u, which must
+ * be located in the domain of \p compiled. Like ts_bspline_eval, knots equal
+ * to the breakpoint between two spans belong to the first of them.
+ */
+size_t ts_int_compiled_spline_find_span(const tsCompiledSpline *compiled,
+	tsReal u)
+{
+	const tsReal *breaks = ts_int_compiled_spline_access_breaks(compiled);
+	size_t low = 0, high = compiled->pImpl->n_spans - 1, mid;
+	while (low < high) {
+		mid = low + (high - low) / 2;
+		if (ts_int_knot_le(u, breaks[mid + 1]))
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return low;
+}
+
+/**
+ * Evaluates \p compiled at the knots \p us, or at \p num equally distributed
+ * knots if \p us is NULL (cf. ts_bspline_sample_into), and stores the
+ * resultant points in \p points. Each point is obtained with Horner's rule
+ * from the coefficients of its span.
+ *
+ * The bounds of the current span, widened and narrowed by TS_KNOT_EPSILON
+ * (cf. ts_knots_equal), are kept in `lower', `upper', and `snap'. Thus, the
+ * span of the next knot and whether the knot is snapped to the end of the
+ * span are found with plain comparisons: the span is moved forward as long
+ * as the knot is not less than `upper'. Only knots less than `lower', i.e.,
+ * knots preceding the span or knots close to the minimum of the domain, are
+ * validated, snapped to the minimum, and searched with binary search. When
+ * sampling, these are the knots within TS_KNOT_EPSILON of the minimum only.
+ * Knots beyond the domain are rejected when there is no further span to move
+ * to.
+ */
+tsError ts_int_compiled_spline_eval_range(const tsCompiledSpline *compiled,
+	const tsReal *us, size_t num, tsReal *points, tsStatus *status)
+{
+	const size_t deg = compiled->pImpl->deg;
+	const size_t order = deg + 1;
+	const size_t dim = compiled->pImpl->dim;
+	const size_t n_spans = compiled->pImpl->n_spans;
+	const tsReal *breaks = ts_int_compiled_spline_access_breaks(compiled);
+	const tsReal *scales = ts_int_compiled_spline_access_scales(compiled);
+	const tsReal *coeffs = ts_int_compiled_spline_access_coeffs(compiled);
+	const tsReal eps = (tsReal) TS_KNOT_EPSILON;
+	size_t span = 0, i, j, d;
+	tsReal min, max, lower, upper, snap, u, t, v;
+	const tsReal *c;
+	tsReal *p;
+
+	ts_compiled_spline_domain(compiled, &min, &max);
+	lower = min + eps;
+	upper = breaks[1] + eps;
+	snap = breaks[1] - eps;
+	for (i = 0; i < num; i++) {
+		u = us ? us[i] : ts_int_sample_knot(min, max, num, i);
+		if (u < lower) {
+			if (u < min && !ts_knots_equal(u, min)) {
+				TS_RETURN_2(status, TS_U_UNDEFINED,
+					"knot (%f) < min(domain) (%f)", u, min)
+			}
+			if (ts_knots_equal(u, min))
+				u = min;
+			span = ts_int_compiled_spline_find_span(compiled, u);
+			lower = breaks[span] + eps;
+			upper = breaks[span + 1] + eps;
+			snap = breaks[span + 1] - eps;
+		}
+		while (u >= upper) {
+			if (span + 1 == n_spans) {
+				if (u > max && !ts_knots_equal(u, max)) {
+					TS_RETURN_2(status, TS_U_UNDEFINED,
+						"knot (%f) > max(domain) (%f)",
+						u, max)
+				}
+				break;
+			}
+			span++;
+			lower = breaks[span] + eps;
+			upper = breaks[span + 1] + eps;
+			snap = breaks[span + 1] - eps;
+		}
+		/* Like ts_int_bspline_eval_woa, snap knots to breakpoints. */
+		t = u > snap ? 1 : (u - breaks[span]) * scales[span];
+		/* Accumulate in a local, which, unlike points, cannot alias
+		 * coeffs and thus is kept in a register. */
+		c = coeffs + span * order * dim;
+		p = points + i * dim;
+		for (d = 0; d < dim; d++) {
+			v = c[deg * dim + d];
+			for (j = deg; j > 0; j--)
+				v = v * t + c[(j - 1) * dim + d];
+			p[d] = v;
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_compiled_spline_eval(const tsCompiledSpline *compiled, tsReal u,
+	tsReal *point, tsStatus *status)
+{
+	return ts_compiled_spline_eval_all(compiled, &u, 1, point,
+		ts_compiled_spline_dimension(compiled), status);
+}
+
+tsError ts_compiled_spline_eval_all(const tsCompiledSpline *compiled,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status)
+{
+	const size_t dim = ts_compiled_spline_dimension(compiled);
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	return ts_int_compiled_spline_eval_range(compiled, us, num, points,
+		status);
+}
+
+tsError ts_compiled_spline_sample(const tsCompiledSpline *compiled,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsStatus *status)
+{
+	const size_t dim = ts_compiled_spline_dimension(compiled);
+	if (num == 0)
+		num = compiled->pImpl->n_samples;
+	*actual_num = num;
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	return ts_int_compiled_spline_eval_range(compiled, NULL, num, points,
+		status);
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Spline Pool Functions                                                    *
+*                                                                             *
+******************************************************************************/
+tsSplinePool ts_spline_pool_init()
+{
+	tsSplinePool pool;
+	ts_int_spline_pool_init(&pool);
+	return pool;
+}
+
+tsError ts_int_spline_pool_check(const struct tsSplinePoolImpl *impl,
+	const tsBSpline *spline, tsStatus *status)
+{
+	if (ts_bspline_degree(spline) != impl->deg) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"degree (%lu) != degree(pool) (%lu)",
+			(unsigned long) ts_bspline_degree(spline),
+			(unsigned long) impl->deg)
+	}
+	if (ts_bspline_dimension(spline) != impl->dim) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"dimension (%lu) != dimension(pool) (%lu)",
+			(unsigned long) ts_bspline_dimension(spline),
+			(unsigned long) impl->dim)
+	}
+	if (ts_bspline_num_control_points(spline) != impl->n_ctrlp) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"num(control_points) (%lu) != "
+			"num(control_points(pool)) (%lu)",
+			(unsigned long) ts_bspline_num_control_points(spline),
+			(unsigned long) impl->n_ctrlp)
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Copies the control points and knots of \p spline (which must be compatible
+ * with \p pool) to the spline at \p index of \p pool.
+ */
+void ts_int_spline_pool_store(tsSplinePool *pool, size_t index,
+	const tsBSpline *spline)
+{
+	const struct tsSplinePoolImpl *impl = pool->pImpl;
+	const size_t n = impl->n_splines;
+	const size_t len_ctrlp = impl->n_ctrlp * impl->dim;
+	const tsReal *from = ts_int_bspline_access_ctrlp(spline);
+	tsReal *to = ts_int_spline_pool_access_ctrlp(pool) + index;
+	tsBSpline basis;
+	size_t i;
+
+	for (i = 0; i < len_ctrlp; i++)
+		to[i * n] = from[i];
+	ts_int_spline_pool_access_basis(pool, index, &basis);
+	basis.pImpl->deg = impl->deg;
+	basis.pImpl->dim = 0;
+	basis.pImpl->n_ctrlp = impl->n_ctrlp;
+	basis.pImpl->n_knots = impl->n_knots;
+	memcpy(ts_int_bspline_access_knots(&basis),
+		ts_int_bspline_access_knots(spline),
+		ts_bspline_sof_knots(spline));
+}
+
+/**
+ * Checks whether all splines of \p pool share the knots of the first spline
+ * and updates tsSplinePoolImpl::shared accordingly.
+ */
+void ts_int_spline_pool_update_shared(tsSplinePool *pool)
+{
+	struct tsSplinePoolImpl *impl = pool->pImpl;
+	tsBSpline basis;
+	const tsReal *first, *knots;
+	size_t i, j;
+
+	ts_int_spline_pool_access_basis(pool, 0, &basis);
+	first = ts_int_bspline_access_knots(&basis);
+	impl->shared = 1;
+	for (i = 1; i < impl->n_splines && impl->shared; i++) {
+		ts_int_spline_pool_access_basis(pool, i, &basis);
+		knots = ts_int_bspline_access_knots(&basis);
+		for (j = 0; j < impl->n_knots; j++) {
+			if (!ts_knots_equal(first[j], knots[j])) {
+				impl->shared = 0;
+				break;
+			}
+		}
+	}
+}
+
+tsError ts_spline_pool_new(const tsBSpline *splines, size_t num,
+	tsSplinePool *pool, tsStatus *status)
+{
+	struct tsSplinePoolImpl impl;
+	size_t i;
+	tsError err;
+
+	ts_int_spline_pool_init(pool);
+	if (num == 0)
+		TS_RETURN_0(status, TS_INDEX_ERROR, "num(splines) == 0")
+	impl.deg = ts_bspline_degree(splines);
+	impl.dim = ts_bspline_dimension(splines);
+	impl.n_ctrlp = ts_bspline_num_control_points(splines);
+	impl.n_knots = ts_bspline_num_knots(splines);
+	impl.n_splines = num;
+	impl.shared = 1;
+	for (i = 1; i < num; i++) {
+		TS_CALL_ROE(err, ts_int_spline_pool_check(
+			&impl, splines + i, status))
+	}
+
+	pool->pImpl = (struct tsSplinePoolImpl *) ts_int_malloc(
+		ts_int_spline_pool_sof_state(&impl));
+	if (!pool->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	*pool->pImpl = impl;
+	for (i = 0; i < num; i++)
+		ts_int_spline_pool_store(pool, i, splines + i);
+	ts_int_spline_pool_update_shared(pool);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_spline_pool_copy(const tsSplinePool *src, tsSplinePool *dest,
+	tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_spline_pool_init(dest);
+	size = ts_int_spline_pool_sof_state(src->pImpl);
+	dest->pImpl = (struct tsSplinePoolImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_spline_pool_move(tsSplinePool *src, tsSplinePool *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_spline_pool_init(src);
+}
+
+void ts_spline_pool_free(tsSplinePool *pool)
+{
+	if (pool->pImpl)
+		ts_int_free(pool->pImpl);
+	ts_int_spline_pool_init(pool);
+}
+
+size_t ts_spline_pool_num_splines(const tsSplinePool *pool)
+{
+	return pool->pImpl->n_splines;
+}
+
+size_t ts_spline_pool_dimension(const tsSplinePool *pool)
+{
+	return pool->pImpl->dim;
+}
+
+int ts_spline_pool_shares_knots(const tsSplinePool *pool)
+{
+	return pool->pImpl->shared ? 1 : 0;
+}
+
+tsError ts_spline_pool_get(const tsSplinePool *pool, size_t index,
+	tsBSpline *spline, tsStatus *status)
+{
+	const struct tsSplinePoolImpl *impl = pool->pImpl;
+	const size_t n = impl->n_splines;
+	const size_t len_ctrlp = impl->n_ctrlp * impl->dim;
+	const tsReal *from = ts_int_spline_pool_access_ctrlp(pool) + index;
+	tsBSpline basis;
+	tsReal *to;
+	size_t i;
+	tsError err;
+
+	ts_int_bspline_init(spline);
+	if (index >= n) {
+		TS_RETURN_2(status, TS_INDEX_ERROR,
+			"index (%lu) >= num(splines) (%lu)",
+			(unsigned long) index, (unsigned long) n)
+	}
+	TS_CALL_ROE(err, ts_int_bspline_alloc(len_ctrlp + impl->n_knots,
+		spline, status))
+	spline->pImpl->deg = impl->deg;
+	spline->pImpl->dim = impl->dim;
+	spline->pImpl->n_ctrlp = impl->n_ctrlp;
+	spline->pImpl->n_knots = impl->n_knots;
+	to = ts_int_bspline_access_ctrlp(spline);
+	for (i = 0; i < len_ctrlp; i++)
+		to[i] = from[i * n];
+	ts_int_spline_pool_access_basis(pool, index, &basis);
+	memcpy(ts_int_bspline_access_knots(spline),
+		ts_int_bspline_access_knots(&basis),
+		ts_bspline_sof_knots(spline));
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_spline_pool_set(tsSplinePool *pool, size_t index,
+	const tsBSpline *spline, tsStatus *status)
+{
+	struct tsSplinePoolImpl *impl = pool->pImpl;
+	tsError err;
+
+	if (index >= impl->n_splines) {
+		TS_RETURN_2(status, TS_INDEX_ERROR,
+			"index (%lu) >= num(splines) (%lu)",
+			(unsigned long) index, (unsigned long) impl->n_splines)
+	}
+	TS_CALL_ROE(err, ts_int_spline_pool_check(impl, spline, status))
+	ts_int_spline_pool_store(pool, index, spline);
+	ts_int_spline_pool_update_shared(pool);
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Evaluates all splines of \p pool and stores the point of the i'th spline at
+ * \p points + i * \p stride. If \p num is 0, the splines are evaluated at
+ * \p u. Otherwise, each spline is evaluated at the \p index'th of \p num
+ * knots that are equally distributed in its domain (cf. ts_int_sample_knot)
+ * and \p u is ignored. If the splines share their knots, the basis functions
+ * are computed once and the innermost loops run over the (contiguous) control
+ * points of all splines.
+ */
+tsError ts_int_spline_pool_eval(const tsSplinePool *pool, tsReal u,
+	size_t num, size_t index, tsReal *points, size_t stride,
+	tsStatus *status)
+{
+	const struct tsSplinePoolImpl *impl = pool->pImpl;
+	const size_t order = impl->deg + 1;
+	const size_t dim = impl->dim;
+	const size_t n = impl->n_splines;
+	const size_t level = dim * n; /**< Distance of two control points. */
+	const tsReal *ctrlp = ts_int_spline_pool_access_ctrlp(pool);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *weights = stack;
+	tsBSpline basis;
+	const tsReal *c;
+	tsReal min, max, v;
+	size_t fst, i, j, d;
+	tsError err;
+
+	if (order > TS_INT_STACK_BUFFER_LEN) {
+		weights = (tsReal *) ts_int_malloc(order * sizeof(tsReal));
+		if (!weights)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+
+	TS_TRY(try, err, status)
+		if (impl->shared) {
+			ts_int_spline_pool_access_basis(pool, 0, &basis);
+			if (num > 0) {
+				ts_bspline_domain(&basis, &min, &max);
+				u = ts_int_sample_knot(min, max, num, index);
+			}
+			TS_CALL(try, err, ts_int_bspline_eval_basis(&basis, u,
+				NULL, &fst, weights, status))
+			for (d = 0; d < dim; d++) {
+				c = ctrlp + fst * level + d * n;
+				for (i = 0; i < n; i++) {
+					points[i * stride + d] =
+						weights[0] * c[i];
+				}
+				for (j = 1; j < order; j++) {
+					c += level;
+					for (i = 0; i < n; i++) {
+						points[i * stride + d] +=
+							weights[j] * c[i];
+					}
+				}
+			}
+		} else {
+			for (i = 0; i < n; i++) {
+				ts_int_spline_pool_access_basis(
+					pool, i, &basis);
+				v = u;
+				if (num > 0) {
+					ts_bspline_domain(&basis, &min, &max);
+					v = ts_int_sample_knot(min, max, num,
+						index);
+				}
+				TS_CALL(try, err, ts_int_bspline_eval_basis(
+					&basis, v, NULL, &fst, weights, status))
+				for (d = 0; d < dim; d++) {
+					c = ctrlp + fst * level + d * n + i;
+					v = weights[0] * c[0];
+					for (j = 1; j < order; j++)
+						v += weights[j] * c[j * level];
+					points[i * stride + d] = v;
+				}
+			}
+		}
+	TS_FINALLY
+		if (weights != stack)
+			ts_int_free(weights);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_spline_pool_eval(const tsSplinePool *pool, tsReal u,
+	tsReal *points, size_t capacity, tsStatus *status)
+{
+	const size_t dim = ts_spline_pool_dimension(pool);
+	const size_t len = ts_spline_pool_num_splines(pool) * dim;
+	if (capacity < len) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(splines) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) len)
+	}
+	return ts_int_spline_pool_eval(pool, u, 0, 0, points, dim, status);
+}
+
+tsError ts_spline_pool_sample(const tsSplinePool *pool, size_t num,
+	tsReal *points, size_t capacity, size_t *actual_num, tsStatus *status)
+{
+	const struct tsSplinePoolImpl *impl = pool->pImpl;
+	const size_t dim = impl->dim;
+	size_t len, i;
+	tsError err;
+
+	if (num == 0)
+		num = (impl->n_ctrlp - impl->deg) * 30;
+	*actual_num = num;
+	len = impl->n_splines * num * dim;
+	if (capacity < len) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(splines) * num(points) * "
+			"dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) len)
+	}
+	for (i = 0; i < num; i++) {
+		TS_CALL_ROE(err, ts_int_spline_pool_eval(pool, 0, num, i,
+			points + i * dim, num * dim, status))
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: GPU Functions                                                            *
+*                                                                             *
+******************************************************************************/
+void ts_int_gpu_init(tsGpu *_gpu_)
+{
+	_gpu_->pImpl = NULL;
+}
+
+tsGpu ts_gpu_init()
+{
+	tsGpu gpu;
+	ts_int_gpu_init(&gpu);
+	return gpu;
+}
+
+/**
+ * Checks whether the \p num knot values \p us are within [\p min, \p max]
+ * (cf. ts_int_bspline_find_knot_from).
+ */
+tsError ts_int_gpu_check_domain(tsReal min, tsReal max, const tsReal *us,
+	size_t num, tsStatus *status)
+{
+	size_t k;
+	for (k = 0; k < num; k++) {
+		if (us[k] < min && !ts_knots_equal(us[k], min)) {
+			TS_RETURN_2(status, TS_U_UNDEFINED,
+				"knot (%f) < min(domain) (%f)", us[k], min)
+		}
+		if (us[k] > max && !ts_knots_equal(us[k], max)) {
+			TS_RETURN_2(status, TS_U_UNDEFINED,
+				"knot (%f) > max(domain) (%f)", us[k], max)
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+#ifdef TINYSPLINE_ENABLE_OPENCL
+/**
+ * Source of the OpenCL kernel evaluating splines. Work item `gid' computes
+ * the point of spline i = gid % n at knot value k = gid / n and stores it at
+ * points + gid * dim. Component d of control point j of spline i is read
+ * from ctrlp[j * cs + d * ds + i * is] and the knots of spline i start at
+ * knots + i * ks. That is, single splines (n = 1) and the SoA layout of
+ * spline pools are supported alike. Spans are searched such that
+ * t[span] < u <= t[span+1] to obtain the first of the two results at gaps
+ * (cf. ts_int_bspline_eval_basis), and knot values closer than
+ * TS_KNOT_EPSILON to a knot are moved onto the knot (cf. ts_knots_equal).
+ * The basis functions are computed with algorithm A2.2 of 'The NURBS Book'
+ * (Les Piegl and Wayne Tiller). Is split into lines because C89 compilers
+ * need not support string literals longer than 509 characters.
+ */
+const char *ts_int_gpu_source[] = {
+	"#ifdef TS_DOUBLE\n",
+	"#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n",
+	"typedef double real;\n",
+	"#else\n",
+	"typedef float real;\n",
+	"#endif\n",
+	"ulong ts_span(__global const real *t, ulong deg, ulong n_ctrlp,\n",
+	"	real u)\n",
+	"{\n",
+	"	ulong low = deg, high = n_ctrlp - 1, mid;\n",
+	"	while (low < high) {\n",
+	"		mid = (low + high + 1) / 2;\n",
+	"		if (t[mid] < u) low = mid; else high = mid - 1;\n",
+	"	}\n",
+	"	if (!(t[low] < u)) {\n",
+	"		while (low + 1 < n_ctrlp && !(t[low] < t[low + 1]))\n",
+	"			low++;\n",
+	"	}\n",
+	"	return low;\n",
+	"}\n",
+	"__kernel void ts_eval(__global const real *ctrlp,\n",
+	"	__global const real *knots, ulong deg, ulong n_ctrlp,\n",
+	"	ulong dim, ulong n, ulong cs, ulong ds, ulong is, ulong ks,\n",
+	"	__global const real *us, ulong num, __global real *points)\n",
+	"{\n",
+	"	real N[MAX_ORDER], left[MAX_ORDER], right[MAX_ORDER];\n",
+	"	real u, saved, tmp, den, v;\n",
+	"	ulong gid = get_global_id(0), k = gid / n, i = gid % n;\n",
+	"	ulong span, j, r, d;\n",
+	"	__global const real *t = knots + i * ks;\n",
+	"	__global const real *c;\n",
+	"	if (k >= num) return;\n",
+	"	u = clamp(us[k], t[deg], t[n_ctrlp]);\n",
+	"	span = ts_span(t, deg, n_ctrlp, u);\n",
+	"	if (u - t[span] < KNOT_EPSILON) {\n",
+	"		u = t[span];\n",
+	"		span = ts_span(t, deg, n_ctrlp, u);\n",
+	"	} else if (t[span + 1] - u < KNOT_EPSILON) {\n",
+	"		u = t[span + 1];\n",
+	"	}\n",
+	"	N[0] = 1;\n",
+	"	for (j = 1; j <= deg; j++) {\n",
+	"		left[j] = u - t[span + 1 - j];\n",
+	"		right[j] = t[span + j] - u;\n",
+	"		saved = 0;\n",
+	"		for (r = 0; r < j; r++) {\n",
+	"			den = right[r + 1] + left[j - r];\n",
+	"			tmp = den != 0 ? N[r] / den : 0;\n",
+	"			N[r] = saved + right[r + 1] * tmp;\n",
+	"			saved = left[j - r] * tmp;\n",
+	"		}\n",
+	"		N[j] = saved;\n",
+	"	}\n",
+	"	c = ctrlp + (span - deg) * cs + i * is;\n",
+	"	for (d = 0; d < dim; d++) {\n",
+	"		v = 0;\n",
+	"		for (j = 0; j <= deg; j++)\n",
+	"			v += N[j] * c[j * cs + d * ds];\n",
+	"		points[gid * dim + d] = v;\n",
+	"	}\n",
+	"}\n"
+};
+
+void ts_int_gpu_release(struct tsGpuImpl *impl)
+{
+	if (impl->kernel)
+		clReleaseKernel(impl->kernel);
+	if (impl->program)
+		clReleaseProgram(impl->program);
+	if (impl->queue)
+		clReleaseCommandQueue(impl->queue);
+	if (impl->context)
+		clReleaseContext(impl->context);
+	impl->kernel = NULL;
+	impl->program = NULL;
+	impl->queue = NULL;
+	impl->context = NULL;
+	impl->device = 0;
+}
+
+/**
+ * Creates the context, command queue, and kernel of \p impl on \p device.
+ * Returns 1 on success. Otherwise, 0 is returned and all handles are
+ * released.
+ */
+int ts_int_gpu_setup_device(struct tsGpuImpl *impl, cl_device_id device)
+{
+	const cl_uint num_lines = (cl_uint) (sizeof(ts_int_gpu_source) /
+		sizeof(ts_int_gpu_source[0]));
+	char options[128];
+	cl_int err;
+#ifndef TINYSPLINE_FLOAT_PRECISION
+	cl_device_fp_config fp = 0;
+	if (clGetDeviceInfo(device, CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(fp),
+			&fp, NULL) != CL_SUCCESS || !fp) {
+		return 0;
+	}
+	sprintf(options, "-DMAX_ORDER=%d -DKNOT_EPSILON=%.9g -DTS_DOUBLE",
+		TS_INT_GPU_MAX_ORDER, (double) TS_KNOT_EPSILON);
+#else
+	sprintf(options, "-DMAX_ORDER=%d -DKNOT_EPSILON=%.9gf",
+		TS_INT_GPU_MAX_ORDER, (double) TS_KNOT_EPSILON);
+#endif
+	impl->context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+	if (err == CL_SUCCESS) {
+		impl->queue = clCreateCommandQueue(impl->context, device, 0,
+			&err);
+	}
+	if (err == CL_SUCCESS) {
+		impl->program = clCreateProgramWithSource(impl->context,
+			num_lines, ts_int_gpu_source, NULL, &err);
+	}
+	if (err == CL_SUCCESS) {
+		err = clBuildProgram(impl->program, 1, &device, options,
+			NULL, NULL);
+	}
+	if (err == CL_SUCCESS)
+		impl->kernel = clCreateKernel(impl->program, "ts_eval", &err);
+	if (err != CL_SUCCESS) {
+		ts_int_gpu_release(impl);
+		return 0;
+	}
+	impl->device = 1;
+	return 1;
+}
+
+/**
+ * Returns whether ts_int_gpu_setup may fall back to CPU devices, which is
+ * the case if the environment variable \c TINYSPLINE_GPU_ALLOW_CPU is set to
+ * a value other than "0" (cf. ::tsGpu).
+ */
+int ts_int_gpu_allow_cpu()
+{
+	const char *env = getenv("TINYSPLINE_GPU_ALLOW_CPU");
+	return env && *env && strcmp(env, "0") != 0;
+}
+
+/**
+ * Sets up \p impl on the first suitable GPU or accelerator of all platforms.
+ * If there is none and CPU devices are allowed (cf. ts_int_gpu_allow_cpu),
+ * the first suitable CPU device is used. If there is no device at all, all
+ * handles of \p impl remain NULL.
+ */
+void ts_int_gpu_setup(struct tsGpuImpl *impl)
+{
+	const cl_device_type types[2] = {
+		CL_DEVICE_TYPE_GPU | CL_DEVICE_TYPE_ACCELERATOR,
+		CL_DEVICE_TYPE_CPU
+	};
+	const size_t num_types = ts_int_gpu_allow_cpu() ? 2 : 1;
+	cl_platform_id platforms[16];
+	cl_device_id devices[16];
+	cl_uint num_platforms, num_devices, p, d;
+	size_t t;
+
+	if (clGetPlatformIDs(16, platforms, &num_platforms) != CL_SUCCESS)
+		return;
+	if (num_platforms > 16)
+		num_platforms = 16;
+	for (t = 0; t < num_types; t++) {
+		for (p = 0; p < num_platforms; p++) {
+			if (clGetDeviceIDs(platforms[p], types[t], 16,
+					devices, &num_devices) != CL_SUCCESS) {
+				continue;
+			}
+			if (num_devices > 16)
+				num_devices = 16;
+			for (d = 0; d < num_devices; d++) {
+				if (ts_int_gpu_setup_device(impl, devices[d]))
+					return;
+			}
+		}
+	}
+}
+
+/**
+ * Evaluates \p n splines at the \p num knot values \p us with the kernel of
+ * \p impl (cf. ts_int_gpu_source). \p ctrlp and \p knots are the host
+ * buffers storing \p len_ctrlp control point values and \p len_knots knots,
+ * and \p args stores the kernel arguments deg, n_ctrlp, dim, n, cs, ds, is,
+ * and ks. The points are stored in \p buffer (a cl_mem). If \p buffer is
+ * NULL, a temporary device buffer is used. If \p points is not NULL, the
+ * points are copied from the device buffer to \p points.
+ */
+tsError ts_int_gpu_launch(struct tsGpuImpl *impl, const tsReal *ctrlp,
+	size_t len_ctrlp, const tsReal *knots, size_t len_knots,
+	const cl_ulong *args, const tsReal *us, size_t num, void *buffer,
+	tsReal *points, tsStatus *status)
+{
+	const size_t global = num * (size_t) args[3];
+	const size_t sof_points = global * (size_t) args[2] * sizeof(tsReal);
+	const cl_ulong num_us = (cl_ulong) num;
+	cl_mem mem[4]; /**< ctrlp, knots, us, and points (if temporary). */
+	cl_mem out = (cl_mem) buffer;
+	size_t sof_buffer, i;
+	cl_int err = CL_SUCCESS;
+
+	if (global == 0)
+		TS_RETURN_SUCCESS(status)
+	if (buffer) {
+		err = clGetMemObjectInfo((cl_mem) buffer, CL_MEM_SIZE,
+			sizeof(sof_buffer), &sof_buffer, NULL);
+		if (err == CL_SUCCESS && sof_buffer < sof_points) {
+			TS_RETURN_2(status, TS_NUM_POINTS,
+				"size of buffer (%lu) < size of points (%lu)",
+				(unsigned long) sof_buffer,
+				(unsigned long) sof_points)
+		}
+	}
+	for (i = 0; i < 4; i++)
+		mem[i] = NULL;
+	if (err == CL_SUCCESS) {
+		mem[0] = clCreateBuffer(impl->context,
+			CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+			len_ctrlp * sizeof(tsReal), (void *) ctrlp, &err);
+	}
+	if (err == CL_SUCCESS) {
+		mem[1] = clCreateBuffer(impl->context,
+			CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+			len_knots * sizeof(tsReal), (void *) knots, &err);
+	}
+	if (err == CL_SUCCESS) {
+		mem[2] = clCreateBuffer(impl->context,
+			CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+			num * sizeof(tsReal), (void *) us, &err);
+	}
+	if (err == CL_SUCCESS && !buffer) {
+		mem[3] = clCreateBuffer(impl->context, CL_MEM_WRITE_ONLY,
+			sof_points, NULL, &err);
+		out = mem[3];
+	}
+	for (i = 0; err == CL_SUCCESS && i < 2; i++) {
+		err = clSetKernelArg(impl->kernel, (cl_uint) i,
+			sizeof(cl_mem), &mem[i]);
+	}
+	for (i = 0; err == CL_SUCCESS && i < 8; i++) {
+		err = clSetKernelArg(impl->kernel, (cl_uint) (2 + i),
+			sizeof(cl_ulong), &args[i]);
+	}
+	if (err == CL_SUCCESS) {
+		err = clSetKernelArg(impl->kernel, 10, sizeof(cl_mem),
+			&mem[2]);
+	}
+	if (err == CL_SUCCESS) {
+		err = clSetKernelArg(impl->kernel, 11, sizeof(cl_ulong),
+			&num_us);
+	}
+	if (err == CL_SUCCESS) {
+		err = clSetKernelArg(impl->kernel, 12, sizeof(cl_mem), &out);
+	}
+	if (err == CL_SUCCESS) {
+		err = clEnqueueNDRangeKernel(impl->queue, impl->kernel, 1,
+			NULL, &global, NULL, 0, NULL, NULL);
+	}
+	if (err == CL_SUCCESS && points) {
+		err = clEnqueueReadBuffer(impl->queue, out, CL_TRUE, 0,
+			sof_points, points, 0, NULL, NULL);
+	}
+	/* Enqueued commands retain the buffers they use. */
+	for (i = 0; i < 4; i++) {
+		if (mem[i])
+			clReleaseMemObject(mem[i]);
+	}
+	if (err != CL_SUCCESS)
+		TS_RETURN_1(status, TS_DEVICE_ERROR, "OpenCL error (%d)", err)
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_int_gpu_eval_all(tsGpu *gpu, const tsBSpline *spline,
+	const tsReal *us, size_t num, void *buffer, tsReal *points,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	cl_ulong args[8];
+	tsReal min, max;
+	tsError err;
+
+	ts_bspline_domain(spline, &min, &max);
+	TS_CALL_ROE(err, ts_int_gpu_check_domain(min, max, us, num, status))
+	args[0] = (cl_ulong) ts_bspline_degree(spline);
+	args[1] = (cl_ulong) ts_bspline_num_control_points(spline);
+	args[2] = (cl_ulong) dim;
+	args[3] = 1;   /* n  */
+	args[4] = (cl_ulong) dim; /* cs */
+	args[5] = 1;   /* ds */
+	args[6] = 0;   /* is */
+	args[7] = 0;   /* ks */
+	return ts_int_gpu_launch(gpu->pImpl,
+		ts_int_bspline_access_ctrlp(spline),
+		ts_bspline_len_control_points(spline),
+		ts_int_bspline_access_knots(spline),
+		ts_bspline_num_knots(spline),
+		args, us, num, buffer, points, status);
+}
+
+tsError ts_int_gpu_pool_eval_all(tsGpu *gpu, const tsSplinePool *pool,
+	const tsReal *us, size_t num, void *buffer, tsReal *points,
+	tsStatus *status)
+{
+	const struct tsSplinePoolImpl *impl = pool->pImpl;
+	const size_t n = impl->n_splines;
+	const size_t n_knots = impl->n_knots;
+	const size_t num_copies = impl->shared ? 1 : n;
+	tsReal *knots = NULL;
+	tsBSpline basis;
+	cl_ulong args[8];
+	tsReal min, max, lo, hi;
+	size_t i;
+	tsError err;
+
+	ts_int_spline_pool_access_basis(pool, 0, &basis);
+	ts_bspline_domain(&basis, &min, &max);
+	for (i = 1; i < num_copies; i++) {
+		ts_int_spline_pool_access_basis(pool, i, &basis);
+		ts_bspline_domain(&basis, &lo, &hi);
+		min = lo > min ? lo : min;
+		max = hi < max ? hi : max;
+	}
+	TS_CALL_ROE(err, ts_int_gpu_check_domain(min, max, us, num, status))
+
+	args[0] = (cl_ulong) impl->deg;
+	args[1] = (cl_ulong) impl->n_ctrlp;
+	args[2] = (cl_ulong) impl->dim;
+	args[3] = (cl_ulong) n;
+	args[4] = (cl_ulong) (impl->dim * n); /* cs */
+	args[5] = (cl_ulong) n;               /* ds */
+	args[6] = 1;                          /* is */
+	args[7] = (cl_ulong) (impl->shared ? 0 : n_knots); /* ks */
+
+	/* The knots of a pool are interleaved with struct tsBSplineImpl. */
+	knots = (tsReal *) ts_int_malloc(num_copies * n_knots *
+		sizeof(tsReal));
+	if (!knots)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	for (i = 0; i < num_copies; i++) {
+		ts_int_spline_pool_access_basis(pool, i, &basis);
+		memcpy(knots + i * n_knots, ts_int_bspline_access_knots(&basis),
+			n_knots * sizeof(tsReal));
+	}
+	err = ts_int_gpu_launch(gpu->pImpl,
+		ts_int_spline_pool_access_ctrlp(pool),
+		impl->n_ctrlp * impl->dim * n, knots, num_copies * n_knots,
+		args, us, num, buffer, points, status);
+	ts_int_free(knots);
+	return err;
+}
+#endif
+
+tsError ts_gpu_new(tsGpu *gpu, tsStatus *status)
+{
+	ts_int_gpu_init(gpu);
+	gpu->pImpl = (struct tsGpuImpl *) ts_int_malloc(
+		sizeof(struct tsGpuImpl));
+	if (!gpu->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	gpu->pImpl->device = 0;
+#ifdef TINYSPLINE_ENABLE_OPENCL
+	gpu->pImpl->context = NULL;
+	gpu->pImpl->queue = NULL;
+	gpu->pImpl->program = NULL;
+	gpu->pImpl->kernel = NULL;
+	ts_int_gpu_setup(gpu->pImpl);
+#endif
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_gpu_free(tsGpu *gpu)
+{
+	if (gpu->pImpl) {
+#ifdef TINYSPLINE_ENABLE_OPENCL
+		ts_int_gpu_release(gpu->pImpl);
+#endif
+		ts_int_free(gpu->pImpl);
+	}
+	ts_int_gpu_init(gpu);
+}
+
+int ts_gpu_has_device(const tsGpu *gpu)
+{
+	return gpu->pImpl->device;
+}
+
+void ts_gpu_handles(const tsGpu *gpu, void **context, void **queue)
+{
+	if (context)
+		*context = NULL;
+	if (queue)
+		*queue = NULL;
+#ifdef TINYSPLINE_ENABLE_OPENCL
+	if (context)
+		*context = (void *) gpu->pImpl->context;
+	if (queue)
+		*queue = (void *) gpu->pImpl->queue;
+#else
+	(void) gpu;
+#endif
+}
+
+tsError ts_gpu_eval_all(tsGpu *gpu, const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status)
+{
+	const size_t len = num * ts_bspline_dimension(spline);
+	if (!gpu->pImpl->device ||
+			ts_bspline_order(spline) > TS_INT_GPU_MAX_ORDER) {
+		return ts_bspline_eval_all_into(spline, us, num, points,
+			capacity, status);
+	}
+	if (capacity < len) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) len)
+	}
+#ifdef TINYSPLINE_ENABLE_OPENCL
+	return ts_int_gpu_eval_all(gpu, spline, us, num, NULL, points,
+		status);
+#else
+	TS_RETURN_0(status, TS_DEVICE_ERROR, "no device")
+#endif
+}
+
+tsError ts_gpu_eval_all_device(tsGpu *gpu, const tsBSpline *spline,
+	const tsReal *us, size_t num, void *buffer, tsStatus *status)
+{
+	if (!gpu->pImpl->device)
+		TS_RETURN_0(status, TS_DEVICE_ERROR, "no device")
+	if (ts_bspline_order(spline) > TS_INT_GPU_MAX_ORDER) {
+		TS_RETURN_2(status, TS_DEVICE_ERROR,
+			"order (%lu) > max order (%lu)",
+			(unsigned long) ts_bspline_order(spline),
+			(unsigned long) TS_INT_GPU_MAX_ORDER)
+	}
+#ifdef TINYSPLINE_ENABLE_OPENCL
+	return ts_int_gpu_eval_all(gpu, spline, us, num, buffer, NULL,
+		status);
+#else
+	(void) us;
+	(void) num;
+	(void) buffer;
+	TS_RETURN_0(status, TS_DEVICE_ERROR, "no device")
+#endif
+}
+
+tsError ts_gpu_pool_eval_all(tsGpu *gpu, const tsSplinePool *pool,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status)
+{
+	const size_t stride = ts_spline_pool_num_splines(pool) *
+		ts_spline_pool_dimension(pool);
+	const size_t len = num * stride;
+	size_t k;
+	tsError err;
+
+	if (capacity < len) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * num(splines) * "
+			"dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) len)
+	}
+	if (!gpu->pImpl->device ||
+			pool->pImpl->deg + 1 > TS_INT_GPU_MAX_ORDER) {
+		for (k = 0; k < num; k++) {
+			TS_CALL_ROE(err, ts_spline_pool_eval(pool, us[k],
+				points + k * stride, stride, status))
+		}
+		TS_RETURN_SUCCESS(status)
+	}
+#ifdef TINYSPLINE_ENABLE_OPENCL
+	return ts_int_gpu_pool_eval_all(gpu, pool, us, num, NULL, points,
+		status);
+#else
+	TS_RETURN_0(status, TS_DEVICE_ERROR, "no device")
+#endif
+}
+
+tsError ts_gpu_pool_eval_all_device(tsGpu *gpu, const tsSplinePool *pool,
+	const tsReal *us, size_t num, void *buffer, tsStatus *status)
+{
+	if (!gpu->pImpl->device)
+		TS_RETURN_0(status, TS_DEVICE_ERROR, "no device")
+	if (pool->pImpl->deg + 1 > TS_INT_GPU_MAX_ORDER) {
+		TS_RETURN_2(status, TS_DEVICE_ERROR,
+			"order (%lu) > max order (%lu)",
+			(unsigned long) (pool->pImpl->deg + 1),
+			(unsigned long) TS_INT_GPU_MAX_ORDER)
+	}
+#ifdef TINYSPLINE_ENABLE_OPENCL
+	return ts_int_gpu_pool_eval_all(gpu, pool, us, num, buffer, NULL,
+		status);
+#else
+	(void) us;
+	(void) num;
+	(void) buffer;
+	TS_RETURN_0(status, TS_DEVICE_ERROR, "no device")
+#endif
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Surface Functions                                                        *
+*                                                                             *
+******************************************************************************/
+tsBSplineSurface ts_bspline_surface_init()
+{
+	tsBSplineSurface surface;
+	ts_int_bspline_surface_init(&surface);
+	return surface;
+}
+
+/**
+ * Checks the number of control points and the degree of a direction of a
+ * surface (cf. ts_bspline_new). \p name is the name of the direction.
+ */
+tsError ts_int_bspline_surface_check_dir(size_t num_control_points,
+	size_t degree, const char *name, tsStatus *status)
+{
+	const size_t num_knots = num_control_points + degree + 1;
+	(void) name; /* Unused if TINYSPLINE_NO_MESSAGES is defined. */
+	if (num_knots > TS_MAX_NUM_KNOTS) {
+		TS_RETURN_3(status, TS_NUM_KNOTS,
+			"unsupported number of knots (%s): %lu > %lu", name,
+			(unsigned long) num_knots,
+			(unsigned long) TS_MAX_NUM_KNOTS)
+	}
+	if (degree >= num_control_points) {
+		TS_RETURN_4(status, TS_DEG_GE_NCTRLP,
+			"degree_%s (%lu) >= num_%s(control_points) (%lu)",
+			name, (unsigned long) degree, name,
+			(unsigned long) num_control_points)
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_surface_new(size_t num_u, size_t num_v, size_t dimension,
+	size_t degree_u, size_t degree_v, tsBSplineType type_u,
+	tsBSplineType type_v, tsBSplineSurface *surface, tsStatus *status)
+{
+	struct tsBSplineSurfaceImpl impl;
+	tsBSpline basis;
+	tsError err;
+
+	ts_int_bspline_surface_init(surface);
+	if (dimension < 1) {
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	}
+	TS_CALL_ROE(err, ts_int_bspline_surface_check_dir(
+		num_u, degree_u, "u", status))
+	TS_CALL_ROE(err, ts_int_bspline_surface_check_dir(
+		num_v, degree_v, "v", status))
+	impl.deg_u = degree_u;
+	impl.deg_v = degree_v;
+	impl.dim = dimension;
+	impl.n_ctrlp_u = num_u;
+	impl.n_ctrlp_v = num_v;
+
+	surface->pImpl = (struct tsBSplineSurfaceImpl *) ts_int_malloc(
+		ts_int_bspline_surface_sof_state(&impl));
+	if (!surface->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	*surface->pImpl = impl;
+	ts_arr_fill(ts_int_bspline_surface_access_ctrlp(surface),
+		num_u * num_v * dimension, 0);
+
+	TS_TRY(try, err, status)
+		ts_int_bspline_surface_access_basis(surface, 0, &basis);
+		basis.pImpl->deg = degree_u;
+		basis.pImpl->dim = 0;
+		basis.pImpl->n_ctrlp = num_u;
+		basis.pImpl->n_knots = num_u + degree_u + 1;
+		TS_CALL(try, err, ts_int_bspline_generate_knots(
+			&basis, type_u, status))
+		ts_int_bspline_surface_access_basis(surface, 1, &basis);
+		basis.pImpl->deg = degree_v;
+		basis.pImpl->dim = 0;
+		basis.pImpl->n_ctrlp = num_v;
+		basis.pImpl->n_knots = num_v + degree_v + 1;
+		TS_CALL(try, err, ts_int_bspline_generate_knots(
+			&basis, type_v, status))
+	TS_CATCH(err)
+		ts_bspline_surface_free(surface);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_surface_copy(const tsBSplineSurface *src,
+	tsBSplineSurface *dest, tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_bspline_surface_init(dest);
+	size = ts_int_bspline_surface_sof_state(src->pImpl);
+	dest->pImpl = (struct tsBSplineSurfaceImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_bspline_surface_move(tsBSplineSurface *src, tsBSplineSurface *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_bspline_surface_init(src);
+}
+
+void ts_bspline_surface_free(tsBSplineSurface *surface)
+{
+	if (surface->pImpl)
+		ts_int_free(surface->pImpl);
+	ts_int_bspline_surface_init(surface);
+}
+
+size_t ts_bspline_surface_degree_u(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->deg_u;
+}
+
+size_t ts_bspline_surface_degree_v(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->deg_v;
+}
+
+size_t ts_bspline_surface_num_control_points_u(
+	const tsBSplineSurface *surface)
+{
+	return surface->pImpl->n_ctrlp_u;
+}
+
+size_t ts_bspline_surface_num_control_points_v(
+	const tsBSplineSurface *surface)
+{
+	return surface->pImpl->n_ctrlp_v;
+}
+
+size_t ts_bspline_surface_dimension(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->dim;
+}
+
+void ts_bspline_surface_domain(const tsBSplineSurface *surface,
+	tsReal *min_u, tsReal *max_u, tsReal *min_v, tsReal *max_v)
+{
+	tsBSpline basis;
+	ts_int_bspline_surface_access_basis(surface, 0, &basis);
+	ts_bspline_domain(&basis, min_u, max_u);
+	ts_int_bspline_surface_access_basis(surface, 1, &basis);
+	ts_bspline_domain(&basis, min_v, max_v);
+}
+
+const tsReal *ts_bspline_surface_control_points_ptr(
+	const tsBSplineSurface *surface)
+{
+	return ts_int_bspline_surface_access_ctrlp(surface);
+}
+
+tsError ts_bspline_surface_set_control_points(tsBSplineSurface *surface,
+	const tsReal *ctrlp, tsStatus *status)
+{
+	const struct tsBSplineSurfaceImpl *impl = surface->pImpl;
+	memmove(ts_int_bspline_surface_access_ctrlp(surface), ctrlp,
+		impl->n_ctrlp_u * impl->n_ctrlp_v * impl->dim *
+			sizeof(tsReal));
+	TS_RETURN_SUCCESS(status)
+}
+
+const tsReal *ts_bspline_surface_knots_u_ptr(const tsBSplineSurface *surface)
+{
+	tsBSpline basis;
+	ts_int_bspline_surface_access_basis(surface, 0, &basis);
+	return ts_int_bspline_access_knots(&basis);
+}
+
+const tsReal *ts_bspline_surface_knots_v_ptr(const tsBSplineSurface *surface)
+{
+	tsBSpline basis;
+	ts_int_bspline_surface_access_basis(surface, 1, &basis);
+	return ts_int_bspline_access_knots(&basis);
+}
+
+tsError ts_bspline_surface_set_knots(tsBSplineSurface *surface,
+	const tsReal *knots_u, const tsReal *knots_v, tsStatus *status)
+{
+	tsBSpline basis_u, basis_v;
+	tsError err;
+
+	ts_int_bspline_surface_access_basis(surface, 0, &basis_u);
+	ts_int_bspline_surface_access_basis(surface, 1, &basis_v);
+	if (knots_u) {
+		TS_CALL_ROE(err, ts_int_bspline_check_knots(
+			&basis_u, knots_u, status))
+	}
+	if (knots_v) {
+		TS_CALL_ROE(err, ts_int_bspline_check_knots(
+			&basis_v, knots_v, status))
+	}
+	/* The bases have no header and, thus, no cache to drop. */
+	if (knots_u) {
+		memmove(ts_int_bspline_access_knots(&basis_u), knots_u,
+			ts_bspline_sof_knots(&basis_u));
+	}
+	if (knots_v) {
+		memmove(ts_int_bspline_access_knots(&basis_v), knots_v,
+			ts_bspline_sof_knots(&basis_v));
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Returns the number of tsReal values the workspace of
+ * ts_int_bspline_surface_eval_grid must be able to store.
+ */
+size_t ts_int_bspline_surface_len_work(const tsBSplineSurface *surface,
+	size_t num_v)
+{
+	const struct tsBSplineSurfaceImpl *impl = surface->pImpl;
+	return num_v * (impl->deg_v + 1) + (impl->deg_u + 1) +
+		impl->n_ctrlp_v * impl->dim;
+}
+
+/**
+ * Evaluates \p surface at the grid \p us x \p vs (cf.
+ * ts_bspline_surface_eval_grid). \p fst_v must be able to store \p num_v
+ * values and \p work ts_int_bspline_surface_len_work(surface, num_v) values.
+ * The basis functions of the columns (and the indices of their first
+ * affected control points) are computed once and stored at the beginning of
+ * \p work (and in \p fst_v). For each row, the affected rows of control
+ * points are collapsed into the control points of a curve in direction v,
+ * which is then evaluated with the cached basis functions.
+ */
+tsError ts_int_bspline_surface_eval_grid(const tsBSplineSurface *surface,
+	const tsReal *us, size_t num_u, const tsReal *vs, size_t num_v,
+	tsReal *points, size_t *fst_v, tsReal *work, tsStatus *status)
+{
+	const struct tsBSplineSurfaceImpl *impl = surface->pImpl;
+	const size_t order_u = impl->deg_u + 1;
+	const size_t order_v = impl->deg_v + 1;
+	const size_t dim = impl->dim;
+	const size_t level = impl->n_ctrlp_v * dim; /**< Size of a row. */
+	const tsReal *ctrlp = ts_int_bspline_surface_access_ctrlp(surface);
+
+	tsReal *weights_v = work; /**< Basis functions of the columns. */
+	tsReal *weights_u = weights_v + num_v * order_v; /**< Of a row. */
+	tsReal *curve = weights_u + order_u; /**< Collapsed rows. */
+	tsBSpline basis_u, basis_v;
+	size_t cursor_u, cursor_v; /**< Speed up sorted knot values. */
+	size_t first, last; /**< Range of the control points of the curve. */
+	size_t fst_u, i, j, a, d;
+	const tsReal *c, *w;
+	tsReal *p, *q;
+	tsError err;
+
+	ts_int_bspline_surface_access_basis(surface, 0, &basis_u);
+	ts_int_bspline_surface_access_basis(surface, 1, &basis_v);
+
+	cursor_v = ts_bspline_num_knots(&basis_v); /* no hint */
+	first = impl->n_ctrlp_v;
+	last = 0;
+	for (j = 0; j < num_v; j++) {
+		TS_CALL_ROE(err, ts_int_bspline_eval_basis(&basis_v, vs[j],
+			&cursor_v, fst_v + j, weights_v + j * order_v, status))
+		if (fst_v[j] < first)
+			first = fst_v[j];
+		if (fst_v[j] + order_v > last)
+			last = fst_v[j] + order_v;
+	}
+
+	cursor_u = ts_bspline_num_knots(&basis_u); /* no hint */
+	for (i = 0; i < num_u; i++) {
+		TS_CALL_ROE(err, ts_int_bspline_eval_basis(&basis_u, us[i],
+			&cursor_u, &fst_u, weights_u, status))
+		/* Collapse the affected rows. Only the control points of the
+		 * curve that are used by any of the columns are computed. */
+		c = ctrlp + fst_u * level;
+		for (j = first * dim; j < last * dim; j++)
+			curve[j] = weights_u[0] * c[j];
+		for (a = 1; a < order_u; a++) {
+			c += level;
+			for (j = first * dim; j < last * dim; j++)
+				curve[j] += weights_u[a] * c[j];
+		}
+		/* Evaluate the curve at the columns. */
+		p = points + i * num_v * dim;
+		for (j = 0; j < num_v; j++, p += dim) {
+			w = weights_v + j * order_v;
+			q = curve + fst_v[j] * dim;
+			for (d = 0; d < dim; d++)
+				p[d] = w[0] * q[d];
+			for (a = 1; a < order_v; a++) {
+				q += dim;
+				for (d = 0; d < dim; d++)
+					p[d] += w[a] * q[d];
+			}
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_surface_eval(const tsBSplineSurface *surface, tsReal u,
+	tsReal v, tsReal *point, tsStatus *status)
+{
+	const size_t len_work = ts_int_bspline_surface_len_work(surface, 1);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t fst_v;
+	tsError err;
+
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	err = ts_int_bspline_surface_eval_grid(surface, &u, 1, &v, 1, point,
+		&fst_v, work, status);
+	if (work != stack)
+		ts_int_free(work);
+	return err;
+}
+
+tsError ts_bspline_surface_eval_grid(const tsBSplineSurface *surface,
+	const tsReal *us, size_t num_u, const tsReal *vs, size_t num_v,
+	tsReal *points, size_t capacity, tsStatus *status)
+{
+	const size_t len = num_u * num_v * ts_bspline_surface_dimension(
+		surface);
+	size_t *fst_v = NULL;
+	tsReal *work = NULL;
+	tsError err;
+
+	if (capacity < len) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num_u * num_v * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) len)
+	}
+	if (len == 0)
+		TS_RETURN_SUCCESS(status)
+	TS_TRY(try, err, status)
+		fst_v = (size_t *) ts_int_malloc(num_v * sizeof(size_t));
+		work = (tsReal *) ts_int_malloc(
+			ts_int_bspline_surface_len_work(surface, num_v) *
+			sizeof(tsReal));
+		if (!fst_v || !work)
+			TS_THROW_0(try, err, status, TS_MALLOC, "out of memory")
+		TS_CALL(try, err, ts_int_bspline_surface_eval_grid(surface,
+			us, num_u, vs, num_v, points, fst_v, work, status))
+	TS_FINALLY
+		if (fst_v)
+			ts_int_free(fst_v);
+		if (work)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Monotone Index Functions                                                 *
+*                                                                             *
+******************************************************************************/
+tsMonotoneIndex ts_monotone_index_init()
+{
+	tsMonotoneIndex index;
+	ts_int_monotone_index_init(&index);
+	return index;
+}
+
+tsError ts_monotone_index_new(const tsBSpline *spline, size_t index,
+	int ascending, size_t num_samples, tsMonotoneIndex *monotone_index,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	const tsReal *from = ts_int_bspline_access_ctrlp(spline);
+	const tsReal sign = ascending ? (tsReal) 1.0 : (tsReal) -1.0;
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	struct tsMonotoneIndexImpl *impl;
+	tsBSpline component;
+	tsReal *ctrlp, *us, *fs, min, max, range, v, df;
+	size_t *buckets, size, i, j;
+
+	ts_int_monotone_index_init(monotone_index);
+	if (index >= dim) {
+		TS_RETURN_2(status, TS_INDEX_ERROR,
+			"dimension (%lu) <= index (%lu)",
+			(unsigned long) dim, (unsigned long) index)
+	}
+	if (num_samples == 1)
+		TS_RETURN_0(status, TS_NUM_POINTS, "num(samples) == 1")
+	if (num_samples == 0) {
+		num_samples = (n_ctrlp - deg) * 4;
+		num_samples = num_samples < 2 ? 2 : num_samples;
+	}
+	if (order > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(order * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+
+	size = sizeof(struct tsMonotoneIndexImpl) +
+		ts_int_monotone_index_sof_samples(n_ctrlp, n_knots,
+			num_samples) +
+		num_samples * sizeof(size_t);
+	impl = (struct tsMonotoneIndexImpl *) ts_int_malloc(size);
+	if (!impl) {
+		if (work != stack)
+			ts_int_free(work);
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	impl->n_samples = num_samples;
+	impl->n_buckets = num_samples;
+	impl->sign = sign;
+	monotone_index->pImpl = impl;
+
+	ts_int_monotone_index_access_component(monotone_index, &component);
+	component.pImpl->deg = deg;
+	component.pImpl->dim = 1;
+	component.pImpl->n_ctrlp = n_ctrlp;
+	component.pImpl->n_knots = n_knots;
+	ctrlp = ts_int_bspline_access_ctrlp(&component);
+	for (i = 0; i < n_ctrlp; i++)
+		ctrlp[i] = sign * from[i * dim + index];
+	memcpy(ts_int_bspline_access_knots(&component),
+		ts_int_bspline_access_knots(spline),
+		ts_bspline_sof_knots(spline));
+
+	us = ts_int_monotone_index_access_us(monotone_index);
+	fs = ts_int_monotone_index_access_fs(monotone_index);
+	buckets = ts_int_monotone_index_access_buckets(monotone_index);
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < num_samples; i++) {
+		us[i] = ts_int_sample_knot(min, max, num_samples, i);
+		ts_int_bspline_eval_component(&component, us[i], 0, work,
+			fs + i, &df);
+		/* Rounding errors must not break the order. */
+		if (i > 0 && fs[i] < fs[i - 1])
+			fs[i] = fs[i - 1];
+	}
+	if (work != stack)
+		ts_int_free(work);
+
+	/* The first sample of a bucket is the last sample that is less than
+	 * or equal to the lower bound of the bucket. */
+	range = fs[num_samples - 1] - fs[0];
+	impl->scale = range > 0 ? (tsReal) impl->n_buckets / range : 0;
+	for (i = j = 0; i < impl->n_buckets; i++) {
+		v = fs[0] + range * (tsReal) i / (tsReal) impl->n_buckets;
+		while (j + 2 < num_samples && fs[j + 1] <= v)
+			j++;
+		buckets[i] = j;
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_monotone_index_copy(const tsMonotoneIndex *src,
+	tsMonotoneIndex *dest, tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_monotone_index_init(dest);
+	size = ts_int_monotone_index_sof_state(src);
+	dest->pImpl = (struct tsMonotoneIndexImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_monotone_index_move(tsMonotoneIndex *src, tsMonotoneIndex *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_monotone_index_init(src);
+}
+
+void ts_monotone_index_free(tsMonotoneIndex *monotone_index)
+{
+	if (monotone_index->pImpl)
+		ts_int_free(monotone_index->pImpl);
+	ts_int_monotone_index_init(monotone_index);
+}
+
+size_t ts_monotone_index_num_samples(const tsMonotoneIndex *monotone_index)
+{
+	return monotone_index->pImpl->n_samples;
+}
+
+/**
+ * Finds the samples enclosing \p value (which must be multiplied with
+ * tsMonotoneIndexImpl::sign) and refines them with ts_int_bspline_refine.
+ * The search starts at the bucket of \p value or at \p cursor (the first
+ * sample of the previous value), whichever is greater. \p cursor is updated
+ * accordingly and must be initialized with the number of samples.
+ */
+void ts_int_monotone_index_solve(const tsMonotoneIndex *index, tsReal value,
+	tsReal eps, size_t max_iter, tsReal *work, size_t *cursor, tsReal *u,
+	int *found)
+{
+	const struct tsMonotoneIndexImpl *impl = index->pImpl;
+	const size_t n = impl->n_samples;
+	const tsReal *us = ts_int_monotone_index_access_us(index);
+	const tsReal *fs = ts_int_monotone_index_access_fs(index);
+	const size_t *buckets = ts_int_monotone_index_access_buckets(index);
+	tsBSpline component;
+	tsReal t;
+	size_t j;
+
+	t = (value - fs[0]) * impl->scale;
+	if (!(t > 0))
+		j = buckets[0];
+	else if (t >= (tsReal) impl->n_buckets)
+		j = buckets[impl->n_buckets - 1];
+	else
+		j = buckets[(size_t) t];
+	/* Rounding errors may yield the next bucket. */
+	while (j > 0 && fs[j] > value)
+		j--;
+	if (*cursor < n && *cursor > j && !(fs[*cursor] > value))
+		j = *cursor;
+	while (j + 2 < n && fs[j + 1] <= value)
+		j++;
+	*cursor = j;
+
+	ts_int_monotone_index_access_component(index, &component);
+	ts_int_bspline_refine(&component, value, eps, 0, (tsReal) 1.0,
+		max_iter, work, us[j], us[j + 1], fs[j], fs[j + 1], u, found);
+}
+
+tsError ts_monotone_index_solve(const tsMonotoneIndex *monotone_index,
+	tsReal value, tsReal epsilon, int persnickety, size_t max_iter,
+	tsReal *u, tsStatus *status)
+{
+	return ts_monotone_index_solve_all(monotone_index, &value, 1, epsilon,
+		persnickety, max_iter, u, status);
+}
+
+tsError ts_monotone_index_solve_all(const tsMonotoneIndex *monotone_index,
+	const tsReal *values, size_t num, tsReal epsilon, int persnickety,
+	size_t max_iter, tsReal *us, tsStatus *status)
+{
+	const struct tsMonotoneIndexImpl *impl = monotone_index->pImpl;
+	const tsReal eps = (tsReal) fabs(epsilon);
+	tsBSpline component;
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t order, cursor, i;
+	int found;
+	tsError err;
+
+	ts_int_monotone_index_access_component(monotone_index, &component);
+	order = ts_bspline_order(&component);
+	if (order > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(order * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+
+	cursor = impl->n_samples; /* no hint */
+	TS_TRY(try, err, status)
+		for (i = 0; i < num; i++) {
+			ts_int_monotone_index_solve(monotone_index,
+				impl->sign * values[i], eps, max_iter, work,
+				&cursor, us + i, &found);
+			if (!found && persnickety) {
+				TS_THROW_2(try, err, status, TS_NO_RESULT,
+					"maximum iterations (%lu) exceeded "
+					"at value %lu",
+					(unsigned long) max_iter,
+					(unsigned long) i)
+			}
+		}
+	TS_FINALLY
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Projector Functions                                                      *
+*                                                                             *
+******************************************************************************/
+tsProjector ts_projector_init()
+{
+	tsProjector projector;
+	ts_int_projector_init(&projector);
+	return projector;
+}
+
+/**
+ * Sets up the node \p *next (which is incremented afterwards) and its
+ * children such that they contain the segments [\p first, \p last]. Returns
+ * the index of the node.
+ */
+size_t ts_int_projector_build(const tsProjector *projector, size_t first,
+	size_t last, size_t *next)
+{
+	const struct tsProjectorImpl *impl = projector->pImpl;
+	const size_t dim = impl->dim;
+	const size_t order = impl->order;
+	struct tsProjectorNode *node;
+	const tsReal *ctrlp, *lbox, *rbox;
+	tsReal *box;
+	size_t index, mid, i, d;
+
+	index = (*next)++;
+	node = ts_int_projector_access_nodes(projector) + index;
+	node->first = first;
+	node->last = last;
+	node->left = node->right = 0;
+	if (first == last) {
+		box = ts_int_projector_access_boxes(projector) +
+			index * 2 * dim;
+		ctrlp = ts_int_projector_access_ctrlp(projector) +
+			first * order * dim;
+		memcpy(box, ctrlp, dim * sizeof(tsReal));
+		memcpy(box + dim, ctrlp, dim * sizeof(tsReal));
+		for (i = 1; i < order; i++) {
+			for (d = 0; d < dim; d++) {
+				if (ctrlp[i * dim + d] < box[d])
+					box[d] = ctrlp[i * dim + d];
+				if (ctrlp[i * dim + d] > box[dim + d])
+					box[dim + d] = ctrlp[i * dim + d];
+			}
+		}
+		return index;
+	}
+	mid = first + (last - first) / 2;
+	node->left = ts_int_projector_build(projector, first, mid, next);
+	node->right = ts_int_projector_build(projector, mid + 1, last, next);
+	box = ts_int_projector_access_boxes(projector) + index * 2 * dim;
+	lbox = ts_int_projector_access_boxes(projector) +
+		node->left * 2 * dim;
+	rbox = ts_int_projector_access_boxes(projector) +
+		node->right * 2 * dim;
+	for (d = 0; d < dim; d++) {
+		box[d] = lbox[d] < rbox[d] ? lbox[d] : rbox[d];
+		box[dim + d] = lbox[dim + d] > rbox[dim + d]
+			? lbox[dim + d] : rbox[dim + d];
+	}
+	return index;
+}
+
+tsError ts_projector_new(const tsBSpline *spline, tsProjector *projector,
+	tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t order = ts_bspline_order(spline);
+	tsBSpline beziers = ts_bspline_init();
+	struct tsProjectorImpl *impl;
+	const tsReal *knots;
+	tsReal *bounds;
+	size_t n_segments, next, i;
+	tsError err;
+
+	ts_int_projector_init(projector);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		n_segments = ts_bspline_num_control_points(&beziers) / order;
+		impl = (struct tsProjectorImpl *) ts_int_malloc(
+			ts_int_projector_sof_state(dim, order, n_segments));
+		if (!impl) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		impl->dim = dim;
+		impl->order = order;
+		impl->n_segments = n_segments;
+		impl->n_nodes = 2 * n_segments - 1;
+		projector->pImpl = impl;
+
+		knots = ts_int_bspline_access_knots(&beziers);
+		bounds = ts_int_projector_access_bounds(projector);
+		for (i = 0; i <= n_segments; i++)
+			bounds[i] = knots[i * order];
+		memcpy(ts_int_projector_access_ctrlp(projector),
+			ts_int_bspline_access_ctrlp(&beziers),
+			ts_bspline_sof_control_points(&beziers));
+		next = 0;
+		ts_int_projector_build(projector, 0, n_segments - 1, &next);
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_projector_copy(const tsProjector *src, tsProjector *dest,
+	tsStatus *status)
+{
+	const struct tsProjectorImpl *impl = src->pImpl;
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_projector_init(dest);
+	size = ts_int_projector_sof_state(impl->dim, impl->order,
+		impl->n_segments);
+	dest->pImpl = (struct tsProjectorImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_projector_move(tsProjector *src, tsProjector *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_projector_init(src);
+}
+
+void ts_projector_free(tsProjector *projector)
+{
+	if (projector->pImpl)
+		ts_int_free(projector->pImpl);
+	ts_int_projector_init(projector);
+}
+
+size_t ts_projector_dimension(const tsProjector *projector)
+{
+	return projector->pImpl->dim;
+}
+
+/**
+ * Returns the squared distance between \p point and \p box.
+ */
+tsReal ts_int_projector_box_dist(const tsReal *box, size_t dim,
+	const tsReal *point)
+{
+	tsReal dist = 0.f, v;
+	size_t d;
+	for (d = 0; d < dim; d++) {
+		if (point[d] < box[d])
+			v = box[d] - point[d];
+		else if (point[d] > box[dim + d])
+			v = point[d] - box[dim + d];
+		else
+			continue;
+		dist += v * v;
+	}
+	return dist;
+}
+
+/**
+ * Finds the point of \p segment that is closest to \p point. The segment is
+ * sampled at 2 * deg + 1 equidistant values of t (which is sufficient to
+ * separate the local minima of a segment that is not too wiggly) and the
+ * closest sample is refined with Newton's method applied to the derivative
+ * of the squared distance. Stores t and the squared distance in \p t and
+ * \p dist if the squared distance is less than \p *dist or if \p *dist is
+ * negative. \p work must be able to store (order + 3) * dim values.
+ */
+void ts_int_projector_refine(const tsProjector *projector, size_t segment,
+	const tsReal *point, tsReal *work, tsReal *t, tsReal *dist)
+{
+	const struct tsProjectorImpl *impl = projector->pImpl;
+	const size_t dim = impl->dim;
+	const size_t order = impl->order;
+	const size_t deg = order - 1;
+	const size_t n_samples = deg == 0 ? 1 : 2 * deg + 1;
+	const tsReal *ctrlp = ts_int_projector_access_ctrlp(projector) +
+		segment * order * dim;
+	tsReal *pt = work + order * dim;
+	tsReal *first = pt + dim;
+	tsReal *second = first + dim;
+	tsReal best_t = 0.f, best_dist = -1.f, v, dst, f, df, next;
+	size_t i, d;
+
+	for (i = 0; i < n_samples; i++) {
+		v = n_samples == 1 ? 0.f : (tsReal) i / (n_samples - 1);
+		ts_int_bezier_eval(ctrlp, order, dim, v, work, pt);
+		for (dst = 0.f, d = 0; d < dim; d++)
+			dst += (pt[d] - point[d]) * (pt[d] - point[d]);
+		if (best_dist < 0.f || dst < best_dist) {
+			best_t = v;
+			best_dist = dst;
+		}
+	}
+	v = best_t;
+	for (i = 0; deg > 0 && i < TS_INT_PROJECTOR_MAX_ITER; i++) {
+		ts_int_bezier_eval_derivs(ctrlp, order, dim, v, work, pt,
+			first, second);
+		for (dst = f = df = 0.f, d = 0; d < dim; d++) {
+			dst += (pt[d] - point[d]) * (pt[d] - point[d]);
+			f += (pt[d] - point[d]) * first[d];
+			df += first[d] * first[d] +
+				(pt[d] - point[d]) * second[d];
+		}
+		if (dst < best_dist) {
+			best_t = v;
+			best_dist = dst;
+		}
+		if (!(df > 0.f))
+			break; /* not a minimum */
+		next = v - f / df;
+		next = next < 0.f ? 0.f : next > 1.f ? 1.f : next;
+		if (!(next < v) && !(next > v))
+			break; /* converged */
+		v = next;
+	}
+	if (*dist < 0.f || best_dist < *dist) {
+		*t = best_t;
+		*dist = best_dist;
+	}
+}
+
+/**
+ * Projects \p point onto the spline of \p projector. The segment \p *segment
+ * is refined first, which speeds up the search if it contains the closest
+ * point. Afterwards, the hierarchy is traversed depth first, skipping the
+ * nodes whose bounding box is farther away than the closest point found so
+ * far. Stores the segment and t of the closest point in \p segment and
+ * \p t. \p work must be able to store (order + 3) * dim values.
+ */
+void ts_int_projector_project(const tsProjector *projector,
+	const tsReal *point, tsReal *work, size_t *segment, tsReal *t)
+{
+	const struct tsProjectorImpl *impl = projector->pImpl;
+	const size_t dim = impl->dim;
+	const struct tsProjectorNode *nodes =
+		ts_int_projector_access_nodes(projector);
+	const tsReal *boxes = ts_int_projector_access_boxes(projector);
+	/* The depth of the hierarchy is bound by the number of bits of
+	 * size_t. Each visited node pushes at most two children. */
+	size_t stack[2 * sizeof(size_t) * CHAR_BIT];
+	tsReal dists[2 * sizeof(size_t) * CHAR_BIT];
+	const size_t hint = *segment;
+	const struct tsProjectorNode *node;
+	tsReal dist = -1.f, prev, ld, rd;
+	size_t top, near, far;
+
+	ts_int_projector_refine(projector, hint, point, work, t, &dist);
+	stack[0] = 0;
+	dists[0] = ts_int_projector_box_dist(boxes, dim, point);
+	top = 1;
+	while (top > 0) {
+		top--;
+		if (!(dists[top] < dist))
+			continue;
+		node = nodes + stack[top];
+		if (node->first == node->last) {
+			if (node->first == hint)
+				continue;
+			prev = dist;
+			ts_int_projector_refine(projector, node->first,
+				point, work, t, &dist);
+			if (dist < prev)
+				*segment = node->first;
+			continue;
+		}
+		ld = ts_int_projector_box_dist(
+			boxes + node->left * 2 * dim, dim, point);
+		rd = ts_int_projector_box_dist(
+			boxes + node->right * 2 * dim, dim, point);
+		/* Visit the nearer child first. */
+		near = ld < rd ? node->left : node->right;
+		far = ld < rd ? node->right : node->left;
+		stack[top] = far;
+		dists[top++] = ld < rd ? rd : ld;
+		stack[top] = near;
+		dists[top++] = ld < rd ? ld : rd;
+	}
+}
+
+tsError ts_projector_project(const tsProjector *projector,
+	const tsReal *point, tsReal *u, tsReal *closest, tsStatus *status)
+{
+	const struct tsProjectorImpl *impl = projector->pImpl;
+	const size_t dim = impl->dim;
+	const size_t order = impl->order;
+	const size_t len_work = (order + 3) * dim;
+	const tsReal *bounds = ts_int_projector_access_bounds(projector);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t segment = 0;
+	tsReal t;
+
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	ts_int_projector_project(projector, point, work, &segment, &t);
+	*u = bounds[segment] + t * (bounds[segment + 1] - bounds[segment]);
+	if (closest) {
+		ts_int_bezier_eval(ts_int_projector_access_ctrlp(projector) +
+			segment * order * dim, order, dim, t, work, closest);
+	}
+	if (work != stack)
+		ts_int_free(work);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_projector_project_all(const tsProjector *projector,
+	const tsReal *points, size_t num, tsReal *us, tsStatus *status)
+{
+	const struct tsProjectorImpl *impl = projector->pImpl;
+	const size_t dim = impl->dim;
+	const size_t len_work = (impl->order + 3) * dim;
+	const tsReal *bounds = ts_int_projector_access_bounds(projector);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t segment = 0, i;
+	tsReal t;
+
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	for (i = 0; i < num; i++) {
+		/* The segment of the previous point is the hint. */
+		ts_int_projector_project(projector, points + i * dim, work,
+			&segment, &t);
+		us[i] = bounds[segment] +
+			t * (bounds[segment + 1] - bounds[segment]);
+	}
+	if (work != stack)
+		ts_int_free(work);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_project_point(const tsBSpline *spline,
+	const tsReal *point, tsReal *u, tsReal *closest, tsStatus *status)
+{
+	tsProjector projector = ts_projector_init();
+	tsError err;
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_projector_new(
+			spline, &projector, status))
+		TS_CALL(try, err, ts_projector_project(
+			&projector, point, u, closest, status))
+	TS_FINALLY
+		ts_projector_free(&projector);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_project_points(const tsBSpline *spline,
+	const tsReal *points, size_t num, tsReal *us, tsStatus *status)
+{
+	tsProjector projector = ts_projector_init();
+	tsError err;
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_projector_new(
+			spline, &projector, status))
+		TS_CALL(try, err, ts_projector_project_all(
+			&projector, points, num, us, status))
+	TS_FINALLY
+		ts_projector_free(&projector);
+	TS_END_TRY_RETURN(err)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Arc Length Functions                                                     *
+*                                                                             *
+******************************************************************************/
+tsArcLength ts_arc_length_init()
+{
+	tsArcLength table;
+	ts_int_arc_length_init(&table);
+	return table;
+}
+
+/**
+ * Returns the speed (the norm of the first derivative with respect to t) of
+ * \p segment at \p t. \p work must be able to store order * dim values.
+ */
+tsReal ts_int_arc_length_speed(const tsArcLength *table, size_t segment,
+	tsReal t, tsReal *work)
+{
+	const struct tsArcLengthImpl *impl = table->pImpl;
+	const size_t dim = impl->dim;
+	const size_t deg = impl->order - 1;
+	tsReal *point = work + deg * dim, speed = 0.f;
+	size_t d;
+	if (deg == 0)
+		return 0.f;
+	ts_int_bezier_eval(ts_int_arc_length_access_derivs(table) +
+		segment * deg * dim, deg, dim, t, work, point);
+	for (d = 0; d < dim; d++)
+		speed += point[d] * point[d];
+	return (tsReal) sqrt((double) speed);
+}
+
+/**
+ * Returns the arc length of \p segment between \p a and \p b (given in t)
+ * using 5-point Gauss-Legendre quadrature. \p work must be able to store
+ * order * dim values.
+ */
+tsReal ts_int_arc_length_integrate(const tsArcLength *table, size_t segment,
+	tsReal a, tsReal b, tsReal *work)
+{
+	/* Nodes and weights mapped from [-1, 1] to [0, 1]. */
+	const tsReal nodes[5] = {
+		(tsReal) 0.046910077030668, (tsReal) 0.230765344947158,
+		(tsReal) 0.5, (tsReal) 0.769234655052842,
+		(tsReal) 0.953089922969332 };
+	const tsReal weights[5] = {
+		(tsReal) 0.118463442528095, (tsReal) 0.239314335249683,
+		(tsReal) 0.284444444444444, (tsReal) 0.239314335249683,
+		(tsReal) 0.118463442528095 };
+	tsReal length = 0.f;
+	size_t i;
+	for (i = 0; i < 5; i++) {
+		length += weights[i] * ts_int_arc_length_speed(table,
+			segment, a + (b - a) * nodes[i], work);
+	}
+	return length * (b - a);
+}
+
+tsError ts_arc_length_new(const tsBSpline *spline, size_t num_steps,
+	tsArcLength *table, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t deg = order - 1;
+	tsBSpline beziers = ts_bspline_init();
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	struct tsArcLengthImpl *impl;
+	const tsReal *knots, *from;
+	tsReal *bounds, *derivs, *lengths;
+	size_t n_segments, i, j, d;
+	tsError err;
+
+	ts_int_arc_length_init(table);
+	if (num_steps == 0)
+		num_steps = 4;
+	if (order * dim > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(order * dim * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		n_segments = ts_bspline_num_control_points(&beziers) / order;
+		impl = (struct tsArcLengthImpl *) ts_int_malloc(
+			ts_int_arc_length_sof_state(dim, order, n_segments,
+				num_steps));
+		if (!impl) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		impl->dim = dim;
+		impl->order = order;
+		impl->n_segments = n_segments;
+		impl->n_steps = num_steps;
+		table->pImpl = impl;
+
+		knots = ts_int_bspline_access_knots(&beziers);
+		bounds = ts_int_arc_length_access_bounds(table);
+		for (i = 0; i <= n_segments; i++)
+			bounds[i] = knots[i * order];
+		from = ts_int_bspline_access_ctrlp(&beziers);
+		memcpy(ts_int_arc_length_access_ctrlp(table), from,
+			ts_bspline_sof_control_points(&beziers));
+		/* The derivative of a Bezier segment (with respect to t) is
+		 * a Bezier segment of degree deg - 1. */
+		derivs = ts_int_arc_length_access_derivs(table);
+		for (i = 0; i < n_segments; i++) {
+			for (j = 0; j < deg; j++) {
+				for (d = 0; d < dim; d++) {
+					derivs[(i * deg + j) * dim + d] =
+						(tsReal) deg *
+						(from[(i * order + j + 1) *
+							dim + d] -
+						 from[(i * order + j) *
+							dim + d]);
+				}
+			}
+		}
+		lengths = ts_int_arc_length_access_lengths(table);
+		lengths[0] = 0.f;
+		for (i = 0; i < n_segments; i++) {
+			for (j = 0; j < num_steps; j++) {
+				lengths[i * num_steps + j + 1] =
+					lengths[i * num_steps + j] +
+					ts_int_arc_length_integrate(table, i,
+						(tsReal) j / num_steps,
+						(tsReal) (j + 1) / num_steps,
+						work);
+			}
+		}
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+		if (work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_arc_length_copy(const tsArcLength *src, tsArcLength *dest,
+	tsStatus *status)
+{
+	const struct tsArcLengthImpl *impl = src->pImpl;
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_arc_length_init(dest);
+	size = ts_int_arc_length_sof_state(impl->dim, impl->order,
+		impl->n_segments, impl->n_steps);
+	dest->pImpl = (struct tsArcLengthImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_arc_length_move(tsArcLength *src, tsArcLength *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_arc_length_init(src);
+}
+
+void ts_arc_length_free(tsArcLength *table)
+{
+	if (table->pImpl)
+		ts_int_free(table->pImpl);
+	ts_int_arc_length_init(table);
+}
+
+size_t ts_arc_length_dimension(const tsArcLength *table)
+{
+	return table->pImpl->dim;
+}
+
+tsReal ts_arc_length_length(const tsArcLength *table)
+{
+	const struct tsArcLengthImpl *impl = table->pImpl;
+	return ts_int_arc_length_access_lengths(table)[
+		impl->n_segments * impl->n_steps];
+}
+
+/**
+ * Finds the segment and t at which the arc length is \p length (which must
+ * be within [0, length of the spline]). The integration step \p *cursor
+ * (the step of the previous length) and its successor are checked before
+ * the table is searched with binary search. \p cursor is updated
+ * accordingly. \p work must be able to store order * dim values.
+ */
+void ts_int_arc_length_locate(const tsArcLength *table, tsReal length,
+	tsReal *work, size_t *cursor, size_t *segment, tsReal *t)
+{
+	const struct tsArcLengthImpl *impl = table->pImpl;
+	const size_t n = impl->n_segments * impl->n_steps;
+	const tsReal *lengths = ts_int_arc_length_access_lengths(table);
+	tsReal lo, hi, target, piece, g, speed, next, a;
+	size_t j, mid, i;
+
+	/* The smallest step j such that lengths[j + 1] >= length. */
+	j = *cursor;
+	if (j + 1 < n && lengths[j + 1] < length)
+		j++;
+	if (!(j < n && lengths[j + 1] >= length &&
+		(j == 0 || lengths[j] < length))) {
+		j = 0;
+		i = n - 1;
+		while (j < i) {
+			mid = j + (i - j) / 2;
+			if (lengths[mid + 1] >= length)
+				i = mid;
+			else
+				j = mid + 1;
+		}
+	}
+	*cursor = j;
+	*segment = j / impl->n_steps;
+
+	lo = a = (tsReal) (j % impl->n_steps) / impl->n_steps;
+	hi = (tsReal) (j % impl->n_steps + 1) / impl->n_steps;
+	target = length - lengths[j];
+	piece = lengths[j + 1] - lengths[j];
+	if (!(piece > 0.f)) {
+		*t = a;
+		return;
+	}
+	/* Newton's method safeguarded by bisection. */
+	*t = a + (hi - a) * target / piece;
+	for (i = 0; i < TS_INT_ARC_LENGTH_MAX_ITER; i++) {
+		g = ts_int_arc_length_integrate(table, *segment, a, *t, work)
+			- target;
+		if (!(g < 0.f) && !(g > 0.f))
+			break;
+		if (g < 0.f)
+			lo = *t;
+		else
+			hi = *t;
+		speed = ts_int_arc_length_speed(table, *segment, *t, work);
+		next = speed > 0.f ? *t - g / speed : (lo + hi) / 2.f;
+		if (!(next < *t) && !(next > *t))
+			break; /* converged */
+		if (!(next > lo && next < hi))
+			next = (lo + hi) / 2.f;
+		*t = next;
+	}
+}
+
+tsError ts_arc_length_u_at(const tsArcLength *table, tsReal length,
+	tsReal *u, tsStatus *status)
+{
+	return ts_arc_length_u_at_all(table, &length, 1, u, status);
+}
+
+tsError ts_arc_length_u_at_all(const tsArcLength *table,
+	const tsReal *lengths, size_t num, tsReal *us, tsStatus *status)
+{
+	const struct tsArcLengthImpl *impl = table->pImpl;
+	const size_t len_work = impl->order * impl->dim;
+	const tsReal *bounds = ts_int_arc_length_access_bounds(table);
+	const tsReal total = ts_arc_length_length(table);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t cursor = 0, segment, i;
+	tsReal length, t;
+
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	for (i = 0; i < num; i++) {
+		length = lengths[i] < 0.f ? 0.f : lengths[i];
+		length = length > total ? total : length;
+		ts_int_arc_length_locate(table, length, work, &cursor,
+			&segment, &t);
+		us[i] = bounds[segment] +
+			t * (bounds[segment + 1] - bounds[segment]);
+	}
+	if (work != stack)
+		ts_int_free(work);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_arc_length_sample(const tsArcLength *table, size_t num,
+	tsReal *points, size_t capacity, size_t *actual_num, tsStatus *status)
+{
+	const struct tsArcLengthImpl *impl = table->pImpl;
+	const size_t dim = impl->dim;
+	const size_t order = impl->order;
+	const size_t len_work = order * dim;
+	const tsReal *ctrlp = ts_int_arc_length_access_ctrlp(table);
+	const tsReal total = ts_arc_length_length(table);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t cursor = 0, segment, i;
+	tsReal t;
+
+	if (num == 0)
+		num = impl->n_segments * 30;
+	*actual_num = num;
+	if (capacity < num * dim) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"capacity (%lu) < num(points) * dimension (%lu)",
+			(unsigned long) capacity, (unsigned long) (num * dim))
+	}
+	if (len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(len_work * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	for (i = 0; i < num; i++) {
+		ts_int_arc_length_locate(table,
+			ts_int_sample_knot(0.f, total, num, i), work, &cursor,
+			&segment, &t);
+		ts_int_bezier_eval(ctrlp + segment * order * dim, order, dim,
+			t, work, points + i * dim);
+	}
+	if (work != stack)
+		ts_int_free(work);
+	TS_RETURN_SUCCESS(status)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Catmull-Rom Fitter Functions                                             *
+*                                                                             *
+******************************************************************************/
+tsCatmullRomFitter ts_catmull_rom_fitter_init()
+{
+	tsCatmullRomFitter fitter;
+	ts_int_catmull_rom_fitter_init(&fitter);
+	return fitter;
+}
+
+tsError ts_catmull_rom_fitter_new(size_t dimension, tsReal alpha,
+	const tsReal *first, tsReal epsilon, tsCatmullRomFitter *fitter,
+	tsStatus *status)
+{
+	struct tsCatmullRomFitterImpl *impl;
+	ts_int_catmull_rom_fitter_init(fitter);
+	if (dimension == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	impl = (struct tsCatmullRomFitterImpl *) ts_int_malloc(
+		ts_int_catmull_rom_fitter_sof_state(dimension));
+	if (!impl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	if (alpha < 0.f)
+		alpha = (tsReal) 0.f;
+	if (alpha > 1.f)
+		alpha = (tsReal) 1.f;
+	impl->dim = dimension;
+	impl->alpha = alpha;
+	impl->epsilon = (tsReal) fabs(epsilon);
+	impl->has_first = first != NULL;
+	impl->n_points = 0;
+	impl->n_finished = 0;
+	impl->cap = 0;
+	impl->segments = NULL;
+	fitter->pImpl = impl;
+	if (first) {
+		memcpy(ts_int_catmull_rom_fitter_access_first(fitter), first,
+			dimension * sizeof(tsReal));
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_catmull_rom_fitter_copy(const tsCatmullRomFitter *src,
+	tsCatmullRomFitter *dest, tsStatus *status)
+{
+	const struct tsCatmullRomFitterImpl *impl = src->pImpl;
+	const size_t len_segment = 4 * impl->dim;
+	struct tsCatmullRomFitterImpl *copy;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_catmull_rom_fitter_init(dest);
+	copy = (struct tsCatmullRomFitterImpl *) ts_int_malloc(
+		ts_int_catmull_rom_fitter_sof_state(impl->dim));
+	if (!copy)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(copy, impl, ts_int_catmull_rom_fitter_sof_state(impl->dim));
+	copy->cap = impl->n_finished;
+	copy->segments = NULL;
+	if (impl->n_finished > 0) {
+		copy->segments = (tsReal *) ts_int_malloc(
+			impl->n_finished * len_segment * sizeof(tsReal));
+		if (!copy->segments) {
+			ts_int_free(copy);
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		}
+		memcpy(copy->segments, impl->segments,
+			impl->n_finished * len_segment * sizeof(tsReal));
+	}
+	dest->pImpl = copy;
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_catmull_rom_fitter_move(tsCatmullRomFitter *src,
+	tsCatmullRomFitter *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_catmull_rom_fitter_init(src);
+}
+
+void ts_catmull_rom_fitter_free(tsCatmullRomFitter *fitter)
+{
+	if (fitter->pImpl) {
+		if (fitter->pImpl->segments)
+			ts_int_free(fitter->pImpl->segments);
+		ts_int_free(fitter->pImpl);
+	}
+	ts_int_catmull_rom_fitter_init(fitter);
+}
+
+size_t ts_catmull_rom_fitter_dimension(const tsCatmullRomFitter *fitter)
+{
+	return fitter->pImpl->dim;
+}
+
+size_t ts_catmull_rom_fitter_num_points(const tsCatmullRomFitter *fitter)
+{
+	return fitter->pImpl->n_points;
+}
+
+size_t ts_catmull_rom_fitter_num_finished(const tsCatmullRomFitter *fitter)
+{
+	return fitter->pImpl->n_finished;
+}
+
+tsError ts_catmull_rom_fitter_push(tsCatmullRomFitter *fitter,
+	const tsReal *points, size_t num, tsStatus *status)
+{
+	struct tsCatmullRomFitterImpl *impl = fitter->pImpl;
+	const size_t dim = impl->dim;
+	const size_t sof_point = dim * sizeof(tsReal);
+	tsReal *first = ts_int_catmull_rom_fitter_access_first(fitter);
+	tsReal *window = ts_int_catmull_rom_fitter_access_window(fitter);
+	const tsReal *point;
+	tsReal *segments;
+	size_t i, d, w, cap;
+
+	for (i = 0; i < num; i++) {
+		point = points + i * dim;
+		w = impl->n_points < 4 ? impl->n_points : 4;
+		if (w > 0 && ts_distance(window + (w-1) * dim, point, dim)
+				<= impl->epsilon)
+			continue;
+		/* Accepting the point finishes a segment if there are at
+		 * least two points already. */
+		if (w >= 2 && impl->n_finished == impl->cap) {
+			cap = impl->cap < 8 ? 8 : impl->cap * 2;
+			segments = (tsReal *) ts_int_realloc(impl->segments,
+				cap * 4 * sof_point);
+			if (!segments)
+				TS_RETURN_0(status, TS_MALLOC, "out of memory")
+			impl->segments = segments;
+			impl->cap = cap;
+		}
+		if (w == 0 && impl->has_first &&
+				ts_distance(first, point, dim) <= impl->epsilon)
+			impl->has_first = 0;
+		if (w == 4) {
+			memmove(window, window + dim, 3 * sof_point);
+			w = 3;
+		}
+		memcpy(window + w * dim, point, sof_point);
+		w++;
+		impl->n_points++;
+		if (impl->n_points == 2 && !impl->has_first) {
+			/* Generate the first control point from the first two
+			 * points. */
+			for (d = 0; d < dim; d++) {
+				first[d] = window[d] +
+					(window[d] - window[dim + d]);
+			}
+			impl->has_first = 1;
+		}
+		if (impl->n_points >= 3) {
+			ts_int_catmull_rom_segment(
+				w == 4 ? window : first,
+				window + (w-3) * dim,
+				window + (w-2) * dim,
+				window + (w-1) * dim,
+				dim, impl->alpha,
+				impl->segments + impl->n_finished * 4 * dim);
+			impl->n_finished++;
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_catmull_rom_fitter_spline(const tsCatmullRomFitter *fitter,
+	const tsReal *last, tsBSpline *spline, tsStatus *status)
+{
+	const struct tsCatmullRomFitterImpl *impl = fitter->pImpl;
+	const size_t dim = impl->dim;
+	const size_t len_segment = 4 * dim;
+	const tsReal *first = ts_int_catmull_rom_fitter_access_first(fitter);
+	const tsReal *window = ts_int_catmull_rom_fitter_access_window(fitter);
+	const size_t w = impl->n_points < 4 ? impl->n_points : 4;
+	const tsReal *p1, *p2;
+	tsReal *ctrlp, *p3;
+	size_t d;
+	tsError err;
+
+	ts_int_bspline_init(spline);
+	if (impl->n_points == 0)
+		TS_RETURN_0(status, TS_NUM_POINTS, "num(points) == 0")
+	if (impl->n_points == 1) {
+		TS_CALL_ROE(err, ts_bspline_new(1, dim, 0, TS_CLAMPED, spline,
+			status))
+		memcpy(ts_int_bspline_access_ctrlp(spline), window,
+			dim * sizeof(tsReal));
+		TS_RETURN_SUCCESS(status)
+	}
+	TS_CALL_ROE(err, ts_bspline_new((impl->n_finished + 1) * 4, dim, 3,
+		TS_BEZIERS, spline, status))
+	ctrlp = ts_int_bspline_access_ctrlp(spline);
+	if (impl->n_finished > 0) {
+		memcpy(ctrlp, impl->segments,
+			impl->n_finished * len_segment * sizeof(tsReal));
+		ctrlp += impl->n_finished * len_segment;
+	}
+	/* The last control point of the sequence is stored in the last
+	 * control point of the unfinished segment, which is overwritten
+	 * by ts_int_catmull_rom_segment only after being read. */
+	p1 = window + (w-2) * dim;
+	p2 = window + (w-1) * dim;
+	p3 = ctrlp + 3 * dim;
+	if (last && ts_distance(p2, last, dim) > impl->epsilon) {
+		memcpy(p3, last, dim * sizeof(tsReal));
+	} else {
+		for (d = 0; d < dim; d++)
+			p3[d] = p2[d] + (p2[d] - p1[d]);
+	}
+	ts_int_catmull_rom_segment(w >= 3 ? window + (w-3) * dim : first,
+		p1, p2, p3, dim, impl->alpha, ctrlp);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_catmull_rom_fitter_take(tsCatmullRomFitter *fitter,
+	tsBSpline *segments, tsStatus *status)
+{
+	struct tsCatmullRomFitterImpl *impl = fitter->pImpl;
+	tsError err;
+	ts_int_bspline_init(segments);
+	if (impl->n_finished == 0)
+		TS_RETURN_0(status, TS_NUM_POINTS, "no finished segments")
+	TS_CALL_ROE(err, ts_bspline_new(impl->n_finished * 4, impl->dim, 3,
+		TS_BEZIERS, segments, status))
+	memcpy(ts_int_bspline_access_ctrlp(segments), impl->segments,
+		impl->n_finished * 4 * impl->dim * sizeof(tsReal));
+	impl->n_finished = 0;
+	TS_RETURN_SUCCESS(status)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Transformation Functions                                                 *
+*                                                                             *
+******************************************************************************/
+/**
+ * Resizes \p spline in place by \p n control points and knots, which are
+ * added to or removed from the back (\p back != 0) or front of \p spline.
+ * The capacity of \p spline is grown geometrically if necessary, but never
+ * shrunk. Added values are not initialized.
+ */
+tsError ts_int_bspline_resize_in_place(tsBSpline *spline, int n, int back,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_real = sizeof(tsReal);
+	const size_t m = (size_t) (n < 0 ? -n : n); /**< Absolute of n. */
+
+	const size_t num_ctrlp = ts_bspline_num_control_points(spline);
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const size_t nnum_ctrlp = n > 0 ? num_ctrlp + m :
+		(m < num_ctrlp ? num_ctrlp - m : 0);
+	const size_t nnum_knots = nnum_ctrlp + deg + 1;
+	const size_t len = nnum_ctrlp * dim + nnum_knots;
+	size_t cap = ts_int_bspline_capacity(spline);
+
+	tsReal *ctrlp, *knots;
+	tsError err;
+
+	if (nnum_knots > TS_MAX_NUM_KNOTS) {
+		TS_RETURN_2(status, TS_NUM_KNOTS,
+			"unsupported number of knots: %lu > %lu",
+			(unsigned long) nnum_knots,
+			(unsigned long) TS_MAX_NUM_KNOTS)
+	}
+	if (deg >= nnum_ctrlp) {
+		TS_RETURN_2(status, TS_DEG_GE_NCTRLP,
+			"degree (%lu) >= num(control_points) (%lu)",
+			(unsigned long) deg, (unsigned long) nnum_ctrlp)
+	}
+	ts_int_bspline_drop_cache(spline);
+	if (len > cap) {
+		cap = cap * 2 < len ? len : cap * 2;
+		TS_CALL_ROE(err, ts_int_bspline_realloc(spline, cap, status))
+	}
+	ctrlp = ts_int_bspline_access_ctrlp(spline);
+	knots = ts_int_bspline_access_knots(spline);
+
+	if (n > 0) {
+		/* The control points grow into the knots. */
+		memmove(ctrlp + nnum_ctrlp*dim + (back ? 0 : m), knots,
+			num_knots * sof_real);
+		if (!back)
+			memmove(ctrlp + m*dim, ctrlp, num_ctrlp*dim * sof_real);
+	} else {
+		/* The knots shrink into the control points. */
+		if (!back)
+			memmove(ctrlp, ctrlp + m*dim, nnum_ctrlp*dim * sof_real);
+		memmove(ctrlp + nnum_ctrlp*dim, knots + (back ? 0 : m),
+			nnum_knots * sof_real);
+	}
+	spline->pImpl->n_ctrlp = nnum_ctrlp;
+	spline->pImpl->n_knots = nnum_knots;
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_int_bspline_resize(const tsBSpline *spline, int n, int back,
+	tsBSpline *_resized_, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_real = sizeof(tsReal);
+
+	const size_t num_ctrlp = ts_bspline_num_control_points(spline);
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const size_t nnum_ctrlp = num_ctrlp + n; /**< New length of ctrlp. */
+	const size_t nnum_knots = num_knots + n; /**< New length of knots. */
+	const size_t min_num_ctrlp_vec = n < 0 ? nnum_ctrlp : num_ctrlp;
+	const size_t min_num_knots_vec = n < 0 ? nnum_knots : num_knots;
+
+	const size_t sof_min_num_ctrlp = min_num_ctrlp_vec * dim * sof_real;
+	const size_t sof_min_num_knots = min_num_knots_vec * sof_real;
+
+	tsBSpline tmp; /**< Temporarily stores the result. */
+	const tsReal* from_ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal* from_knots = ts_int_bspline_access_knots(spline);
+	tsReal* to_ctrlp = NULL; /**< Pointer to the control points of tmp. */
+	tsReal* to_knots = NULL; /**< Pointer to the knots of tmp. */
+
+	tsError err;
+
+	if (n == 0)
+		return ts_bspline_copy(spline, _resized_, status);
+	if (spline == _resized_) {
+		return ts_int_bspline_resize_in_place(
+			_resized_, n, back, status);
+	}
+
+	INIT_OUT_BSPLINE(spline, _resized_)
+	TS_CALL_ROE(err, ts_bspline_new(
+		nnum_ctrlp, dim, deg, TS_OPENED, &tmp, status))
+	to_ctrlp = ts_int_bspline_access_ctrlp(&tmp);
+	to_knots = ts_int_bspline_access_knots(&tmp);
+
+	/* Copy control points and knots. */
+	if (!back && n < 0) {
+		memcpy(to_ctrlp, from_ctrlp - n*dim, sof_min_num_ctrlp);
+		memcpy(to_knots, from_knots - n    , sof_min_num_knots);
+	} else if (!back && n > 0) {
+		memcpy(to_ctrlp + n*dim, from_ctrlp, sof_min_num_ctrlp);
+		memcpy(to_knots + n    , from_knots, sof_min_num_knots);
+	} else {
+		/* n != 0 implies back == true */
+		memcpy(to_ctrlp, from_ctrlp, sof_min_num_ctrlp);
+		memcpy(to_knots, from_knots, sof_min_num_knots);
+	}
+	ts_bspline_move(&tmp, _resized_);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError TS_INT_STATS_IMPL(ts_bspline_derive)(const tsBSpline *spline, size_t n,
+	tsReal epsilon, tsBSpline *derivative, tsStatus *status)
+{
+	const size_t sof_real = sizeof(tsReal);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_ctrlp = dim * sof_real;
+	const size_t len = ts_bspline_len_control_points(spline) +
+		ts_bspline_num_knots(spline);
+	size_t deg = ts_bspline_degree(spline);
+	size_t num_ctrlp = ts_bspline_num_control_points(spline);
+	size_t num_knots = ts_bspline_num_knots(spline);
+
+	tsReal buffer[TS_INT_STACK_BUFFER_LEN]; /**< Avoids a heap buffer. */
+	tsReal* ctrlp; /**< Control points of the intermediate result. */
+	tsReal* knots; /**< Knots of the intermediate result. */
+
+	size_t m, i, j, k, l; /**< Used in for loops. */
+	size_t c; /**< Number of removed knots (and control points). */
+	size_t kw, pw; /**< Number of compacted knots and control points. */
+	tsReal *fst, *snd; /**< Pointer to first and second control point. */
+	tsReal dist; /**< Distance between fst and snd. */
+	tsReal kid1, ki1; /**< Knots at i+deg+1 and i+1. */
+	tsReal span; /**< Distance between kid1 and ki1. */
+
+	tsError err;
+
+	INIT_OUT_BSPLINE(spline, derivative)
+	/* The input is left untouched until the derivative is known so that
+	 * it stays valid if an error occurs (even when deriving in place). */
+	ctrlp = buffer;
+	if (len > TS_INT_STACK_BUFFER_LEN) {
+		ctrlp = (tsReal *) ts_int_malloc(len * sof_real);
+		if (!ctrlp)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	memcpy(ctrlp, ts_int_bspline_access_ctrlp(spline), len * sof_real);
+	knots = ctrlp + ts_bspline_len_control_points(spline);
+
+	TS_TRY(try, err, status)
+		for (m = 1; m <= n; m++) { /* from 1st to n'th derivative */
+			if (deg == 0) {
+				ts_arr_fill(ctrlp, dim, 0.f);
+				ts_bspline_domain(spline,
+					&knots[0], &knots[1]);
+				num_ctrlp = 1;
+				num_knots = 2;
+				break;
+			}
+			/* Check and, if possible, fix discontinuity. Rather
+			 * than shifting the tail of the arrays for each
+			 * removed knot (and control point), `knots' and
+			 * `ctrlp' are compacted in a single pass. `i' is the
+			 * index in the compacted arrays, which lag behind by
+			 * `c' values. */
+			c = kw = pw = 0;
+			for (i = 2*deg + 1; i + c < num_knots - (deg+1); i++) {
+				if (c > 0) {
+					memmove(&knots[kw], &knots[kw + c],
+						(i + 1 - kw) * sof_real);
+				}
+				kw = i + 1;
+				if (!ts_knots_equal(knots[i], knots[i-deg]))
+					continue;
+				if (c > 0) {
+					memmove(ctrlp + pw*dim,
+						ctrlp + (pw + c)*dim,
+						(i - deg - pw) * sof_ctrlp);
+				}
+				pw = i - deg;
+				fst = ctrlp + (i - (deg+1)) * dim;
+				snd = ctrlp + (i - deg + c) * dim;
+				dist = ts_distance(fst, snd, dim);
+				if (epsilon >= 0.f && dist > epsilon) {
+					TS_THROW_1(try, err, status,
+						TS_UNDERIVABLE,
+						"discontinuity at knot: %f",
+						knots[i])
+				}
+				/* Remove `snd' and knot `i'. */
+				c++;
+				kw = i;
+				i += deg-1;
+			}
+			if (c > 0) {
+				memmove(&knots[kw], &knots[kw + c],
+					(num_knots - c - kw) * sof_real);
+				memmove(ctrlp + pw*dim, ctrlp + (pw + c)*dim,
+					(num_ctrlp - c - pw) * sof_ctrlp);
+				num_ctrlp -= c;
+				num_knots -= c;
+			}
+			/* Derive continuous worker. */
+			for (i = 0; i < num_ctrlp-1; i++) {
+				for (j = 0; j < dim; j++) {
+					k = i    *dim + j;
+					l = (i+1)*dim + j;
+					ctrlp[k] = ctrlp[l] - ctrlp[k];
+					kid1 = knots[i+deg+1];
+					ki1  = knots[i+1];
+					span = kid1 - ki1;
+					if (span < TS_KNOT_EPSILON)
+						span = TS_KNOT_EPSILON;
+					ctrlp[k] *= deg;
+					ctrlp[k] /= span;
+				}
+			}
+			deg       -= 1;
+			num_ctrlp -= 1;
+			num_knots -= 2;
+			knots     += 1;
+		}
+		if (spline == derivative) {
+			/* The derivative never has more control points and
+			 * knots than its spline. */
+			derivative->pImpl->deg = deg;
+			derivative->pImpl->n_ctrlp = num_ctrlp;
+			derivative->pImpl->n_knots = num_knots;
+		} else {
+			TS_CALL(try, err, ts_bspline_new(num_ctrlp, dim, deg,
+				TS_OPENED, derivative, status))
+		}
+		memcpy(ts_int_bspline_access_ctrlp(derivative), ctrlp,
+			num_ctrlp * sof_ctrlp);
+		memcpy(ts_int_bspline_access_knots(derivative), knots,
+			num_knots * sof_real);
+	TS_FINALLY
+		if (ctrlp != buffer)
+			ts_int_free(ctrlp);
+	TS_END_TRY_RETURN(err)
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_derive(const tsBSpline *spline, size_t n, tsReal epsilon,
+	tsBSpline *derivative, tsStatus *status)
+{
+	TS_INT_STATS_CALL(DERIVE, "ts_bspline_derive",
+		TS_INT_STATS_IMPL(ts_bspline_derive)(spline, n, epsilon,
+			derivative, status))
+}
+#endif
+
+tsError ts_bspline_cached_derivative(tsBSpline *spline, size_t n,
+	tsReal epsilon, const tsBSpline **derivative, tsStatus *status)
+{
+	union tsBSplineHeader *header;
+	struct tsBSplineCache *cache, *grown;
+	tsBSpline *derivs;
+	size_t i, num;
+	tsError err;
+
+	if (n == 0) {
+		*derivative = spline;
+		TS_RETURN_SUCCESS(status)
+	}
+	header = ts_int_bspline_header(spline);
+	cache = header->h.cache;
+	if (cache && (cache->epsilon < epsilon || cache->epsilon > epsilon)) {
+		ts_int_bspline_drop_cache(spline);
+		cache = NULL;
+	}
+	num = cache ? cache->num : 0;
+	if (num < n) {
+		grown = (struct tsBSplineCache *) ts_int_malloc(
+			sizeof(struct tsBSplineCache) + n * sizeof(tsBSpline));
+		if (!grown)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		derivs = ts_int_bspline_cache_access_derivs(grown);
+		if (cache) {
+			memcpy(derivs, ts_int_bspline_cache_access_derivs(
+				cache), num * sizeof(tsBSpline));
+			ts_int_free(cache);
+		}
+		grown->epsilon = epsilon;
+		grown->num = num;
+		header->h.cache = grown;
+		/* Derivatives computed so far are kept on error. */
+		for (i = num; i < n; i++) {
+			ts_int_bspline_init(derivs + i);
+			TS_CALL_ROE(err, ts_bspline_derive(
+				i == 0 ? spline : derivs + i - 1, 1, epsilon,
+				derivs + i, status))
+			grown->num++;
+		}
+	}
+	*derivative = ts_int_bspline_cache_access_derivs(header->h.cache)
+		+ (n - 1);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_bspline_clear_cache(tsBSpline *spline)
+{
+	ts_int_bspline_drop_cache(spline);
+}
+
+tsError ts_int_bspline_insert_knot(const tsBSpline *spline,
+	const tsDeBoorNet *deBoorNet, size_t n, tsBSpline *result,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const tsReal knot = ts_deboornet_knot(deBoorNet);
+	const size_t k = ts_deboornet_index(deBoorNet);
+	const size_t mult = ts_deboornet_multiplicity(deBoorNet);
+	const size_t sof_real = sizeof(tsReal);
+	const size_t sof_ctrlp = dim * sof_real;
+
+	size_t N;     /**< Number of affected control points. */
+	tsReal* from; /**< Pointer to copy the values from. */
+	tsReal* to;   /**< Pointer to copy the values to. */
+	int stride;   /**< Stride of the next pointer to copy. */
+	size_t i;     /**< Used in for loops. */
+
+	tsReal *ctrlp_spline, *ctrlp_result;
+	tsReal *knots_spline, *knots_result;
+	size_t num_ctrlp_result;
+	size_t num_knots_result;
+
+	tsError err;
+
+	INIT_OUT_BSPLINE(spline, result)
+	if (n == 0)
+		return ts_bspline_copy(spline, result, status);
+	if (mult + n > order) {
+		TS_RETURN_4(status, TS_MULTIPLICITY,
+			"multiplicity(%f) (%lu) + %lu > order (%lu)",
+			knot, (unsigned long) mult, (unsigned long) n,
+			(unsigned long) order)
+	}
+
+	TS_CALL_ROE(err, ts_int_bspline_resize(
+		spline, (int)n, 1, result, status))
+	ctrlp_spline = ts_int_bspline_access_ctrlp(spline);
+	knots_spline = ts_int_bspline_access_knots(spline);
+	ctrlp_result = ts_int_bspline_access_ctrlp(result);
+	knots_result = ts_int_bspline_access_knots(result);
+	num_ctrlp_result = ts_bspline_num_control_points(result);
+	num_knots_result = ts_bspline_num_knots(result);
+
+	/* mult + n <= deg + 1 (order) with n >= 1
+	 * =>  mult <= deg
+	 * =>  regular evaluation
+	 * =>  N = h + 1 is valid */
+	N = ts_deboornet_num_insertions(deBoorNet) + 1;
 
 	/* 1. Copy all necessary control points and knots from
 	 *    the original B-Spline.
 	 * 2. Copy all necessary control points and knots from
 	 *    the de Boor net. */
 
-	/* 1.
-	 *
-	 * a) Copy left hand side control points from original b-spline.
-	 * b) Copy right hand side control points from original b-spline.
-	 * c) Copy left hand side knots from original b-spline.
-	 * d) Copy right hand side knots form original b-spline. */
-	/* copy control points */
-	memmove(ctrlp_result, ctrlp_spline, (k-deg) * sof_ctrlp);      /* a) */
-	from = (tsReal *) ctrlp_spline + dim*(k-deg+N);
-	/* n >= 0 implies to >= from */
-	to = ctrlp_result + dim*(k-deg+N+n);
-	memmove(to, from, (num_ctrlp_result-n-(k-deg+N)) * sof_ctrlp); /* b) */
-	/* copy knots */
-	memmove(knots_result, knots_spline, (k+1) * sof_real);         /* c) */
-	from = (tsReal *) knots_spline + k+1;
-	/* n >= 0 implies to >= from */
-	to = knots_result + k+1+n;
-	memmove(to, from, (num_knots_result-n-(k+1)) * sof_real);      /* d) */
+	/* 1.
+	 *
+	 * a) Copy left hand side control points from original b-spline.
+	 * b) Copy right hand side control points from original b-spline.
+	 * c) Copy left hand side knots from original b-spline.
+	 * d) Copy right hand side knots form original b-spline. */
+	/* copy control points */
+	memmove(ctrlp_result, ctrlp_spline, (k-deg) * sof_ctrlp);      /* a) */
+	from = (tsReal *) ctrlp_spline + dim*(k-deg+N);
+	/* n >= 0 implies to >= from */
+	to = ctrlp_result + dim*(k-deg+N+n);
+	memmove(to, from, (num_ctrlp_result-n-(k-deg+N)) * sof_ctrlp); /* b) */
+	/* copy knots */
+	memmove(knots_result, knots_spline, (k+1) * sof_real);         /* c) */
+	from = (tsReal *) knots_spline + k+1;
+	/* n >= 0 implies to >= from */
+	to = knots_result + k+1+n;
+	memmove(to, from, (num_knots_result-n-(k+1)) * sof_real);      /* d) */
+
+	/* 2.
+	 *
+	 * a) Copy left hand side control points from de boor net.
+	 * b) Copy middle part control points from de boor net.
+	 * c) Copy right hand side control points from de boor net.
+	 * d) Insert knots with u_k. */
+	from = ts_int_deboornet_access_points(deBoorNet);
+	to = ctrlp_result + (k-deg)*dim;
+	stride = (int)(N*dim);
+
+	/* copy control points */
+	for (i = 0; i < n; i++) {                                      /* a) */
+		memcpy(to, from, sof_ctrlp);
+		from += stride;
+		to += dim;
+		stride -= (int)dim;
+	}
+	memcpy(to, from, (N-n) * sof_ctrlp);                           /* b) */
+
+	from -= dim;
+	to += (N-n)*dim;
+	/* N = h+1 with h = deg-mult (ts_int_bspline_eval)
+	 * =>  N = deg-mult+1 = order-mult.
+	 *
+	 * n <= order-mult
+	 * =>  N-n+1 >= order-mult - order-mult + 1 = 1
+	 * =>  -(int)(N-n+1) <= -1. */
+	stride = -(int)(N-n+1) * (int)dim;
+
+	for (i = 0; i < n; i++) {                                      /* c) */
+		memcpy(to, from, sof_ctrlp);
+		from += stride;
+		stride -= (int)dim;
+		to += dim;
+	}
+	/* copy knots */
+	to = knots_result + k+1;
+	for (i = 0; i < n; i++) {                                      /* d) */
+		*to = knot;
+		to++;
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError TS_INT_STATS_IMPL(ts_bspline_insert_knot)(const tsBSpline *spline,
+	tsReal u, size_t num, tsBSpline *result, size_t* k, tsStatus *status)
+{
+	tsDeBoorNet net;
+	tsError err;
+	INIT_OUT_BSPLINE(spline, result)
+	ts_int_deboornet_init(&net);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
+		TS_CALL(try, err, ts_int_bspline_insert_knot(
+			spline, &net, num, result, status))
+		TS_CALL(try, err, ts_bspline_eval_into(
+			result, u, &net, status))
+		*k = ts_deboornet_index(&net);
+	TS_CATCH(err)
+		*k = 0;
+	TS_FINALLY
+		ts_deboornet_free(&net);
+	TS_END_TRY_RETURN(err)
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_insert_knot(const tsBSpline *spline, tsReal u, size_t num,
+	tsBSpline *result, size_t* k, tsStatus *status)
+{
+	TS_INT_STATS_CALL(INSERT_KNOT, "ts_bspline_insert_knot",
+		TS_INT_STATS_IMPL(ts_bspline_insert_knot)(spline, u, num,
+			result, k, status))
+}
+#endif
+
+tsError ts_bspline_split(const tsBSpline *spline, tsReal u, tsBSpline *split,
+	size_t* k, tsStatus *status)
+{
+	tsDeBoorNet net;
+	tsError err;
+	INIT_OUT_BSPLINE(spline, split)
+	ts_int_deboornet_init(&net);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
+		if (ts_deboornet_multiplicity(&net)
+				== ts_bspline_order(spline)) {
+			TS_CALL(try, err, ts_bspline_copy(
+				spline, split, status))
+			*k = ts_deboornet_index(&net);
+		} else {
+			TS_CALL(try, err, ts_int_bspline_insert_knot(
+				spline, &net,
+				ts_deboornet_num_insertions(&net) + 1, split,
+				status))
+			*k = ts_deboornet_index(&net) +
+				ts_deboornet_num_insertions(&net) + 1;
+		}
+	TS_CATCH(err)
+		*k = 0;
+	TS_FINALLY
+		ts_deboornet_free(&net);
+	TS_END_TRY_RETURN(err)
+}
+
+int ts_int_real_cmp(const void *x, const void *y)
+{
+	const tsReal a = *((const tsReal *) x);
+	const tsReal b = *((const tsReal *) y);
+	return a < b ? -1 : a > b ? 1 : 0;
+}
+
+tsError ts_bspline_refine_knots(const tsBSpline *spline, const tsReal *knots,
+	size_t num, tsBSpline *out, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t n = ts_bspline_num_control_points(spline) - 1;
+	const size_t m = ts_bspline_num_knots(spline) - 1;
+	const size_t sof_ctrlp = dim * sizeof(tsReal);
+	const tsReal *P = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *U = ts_int_bspline_access_knots(spline);
+
+	tsBSpline tmp; /**< Stores the result if spline == out. */
+	tsReal *X = NULL; /**< Sorted copy of knots. */
+	tsReal *Q, *Ubar; /**< Control points and knots of tmp. */
+	tsReal *from, *to; /**< Control points to blend. */
+	tsReal min, max, alpha;
+	size_t a, b;      /**< First and last affected span. */
+	size_t i, j, k, l, d, s, ind;
+	tsError err;
+
+	INIT_OUT_BSPLINE(spline, out)
+	ts_int_bspline_init(&tmp);
+	if (num == 0)
+		return ts_bspline_copy(spline, out, status);
+	ts_bspline_domain(spline, &min, &max);
+
+	TS_TRY(try, err, status)
+		X = (tsReal *) ts_int_malloc(num * sizeof(tsReal));
+		if (!X) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		memcpy(X, knots, num * sizeof(tsReal));
+		for (j = 1; j < num && !(X[j] < X[j-1]); j++);
+		if (j < num) /* Not sorted yet. */
+			qsort(X, num, sizeof(tsReal), ts_int_real_cmp);
+		if (X[0] < min && !ts_knots_equal(X[0], min)) {
+			TS_THROW_2(try, err, status, TS_U_UNDEFINED,
+				"knot (%f) < min(domain) (%f)", X[0], min)
+		}
+		if (X[num - 1] > max && !ts_knots_equal(X[num - 1], max)) {
+			TS_THROW_2(try, err, status, TS_U_UNDEFINED,
+				"knot (%f) > max(domain) (%f)", X[num - 1], max)
+		}
+		/* Snap the knots to the existing knots that are equal within
+		 * TS_KNOT_EPSILON to avoid tiny knot spans. Since X is sorted,
+		 * the knots of spline are walked along. */
+		for (j = 0, k = deg; j < num; j++) {
+			while (k < n + 1 && !(X[j] < U[k+1]))
+				k++;
+			if (ts_knots_equal(X[j], U[k]))
+				X[j] = U[k];
+			else if (k < n + 1 && ts_knots_equal(X[j], U[k+1]))
+				X[j] = U[k+1];
+		}
+		TS_CALL(try, err, ts_bspline_new(n + 1 + num, dim, deg,
+			TS_OPENED, &tmp, status))
+		Q = ts_int_bspline_access_ctrlp(&tmp);
+		Ubar = ts_int_bspline_access_knots(&tmp);
+
+		/* Based on algorithm A5.4 of 'The NURBS Book' (Les Piegl and
+		 * Wayne Tiller). The spans are clamped to [deg, n] so that
+		 * the maximum of the domain is handled properly. */
+		TS_CALL(try, err, ts_int_bspline_find_knot(spline, X[0], &a,
+			&s, status))
+		TS_CALL(try, err, ts_int_bspline_find_knot(spline,
+			X[num - 1], &b, &s, status))
+		a = a > n ? n : a;
+		b = (b > n ? n : b) + 1;
+		memcpy(Q, P, (a - deg + 1) * sof_ctrlp);
+		memcpy(Q + (b - 1 + num) * dim, P + (b - 1) * dim,
+			(n - b + 2) * sof_ctrlp);
+		memcpy(Ubar, U, (a + 1) * sizeof(tsReal));
+		memcpy(Ubar + b + deg + num, U + b + deg,
+			(m - b - deg + 1) * sizeof(tsReal));
+		i = b + deg - 1;
+		k = b + deg + num - 1;
+		for (j = num; j-- > 0;) {
+			while (!(X[j] > U[i]) && i > a) {
+				memcpy(Q + (k - deg - 1) * dim,
+					P + (i - deg - 1) * dim, sof_ctrlp);
+				Ubar[k] = U[i];
+				k--;
+				i--;
+			}
+			memcpy(Q + (k - deg - 1) * dim, Q + (k - deg) * dim,
+				sof_ctrlp);
+			for (l = 1; l <= deg; l++) {
+				ind = k - deg + l;
+				alpha = Ubar[k + l] - X[j];
+				if (ts_knots_equal(Ubar[k + l], X[j])) {
+					memcpy(Q + (ind - 1) * dim,
+						Q + ind * dim, sof_ctrlp);
+					continue;
+				}
+				alpha /= Ubar[k + l] - U[i - deg + l];
+				from = Q + ind * dim;
+				to = from - dim;
+				for (d = 0; d < dim; d++) {
+					to[d] = alpha * to[d] +
+						(1.f - alpha) * from[d];
+				}
+			}
+			Ubar[k] = X[j];
+			k--;
+		}
+		TS_CALL(try, err, ts_int_bspline_check_knots(&tmp, Ubar,
+			status))
+		if (spline == out)
+			ts_bspline_free(out);
+		ts_bspline_move(&tmp, out);
+	TS_CATCH(err)
+		ts_bspline_free(&tmp);
+		if (spline != out)
+			ts_bspline_free(out);
+	TS_FINALLY
+		if (X)
+			ts_int_free(X);
+	TS_END_TRY_RETURN(err)
+}
+
+/**
+ * Computes the control points of the spline given by the control points \p P
+ * and knots \p U after removing the knot U[\p r] (multiplicity \p s, r is the
+ * last index of the knot) once and stores them in \p temp (see algorithm
+ * A5.8 of 'The NURBS Book'). Returns the distance between the two control
+ * points computed from the left and from the right, which bounds the
+ * deviation of the resultant spline. \p temp must be able to store
+ * (deg + 3) * dim values.
+ */
+tsReal ts_int_bspline_removal_error(const tsReal *P, const tsReal *U,
+	size_t deg, size_t dim, size_t r, size_t s, tsReal *temp)
+{
+	const size_t order = deg + 1;
+	const size_t first = r - deg; /**< First affected control point. */
+	const size_t last = r - s;    /**< Last affected control point. */
+	const size_t off = first - 1;
+	const size_t sof_ctrlp = dim * sizeof(tsReal);
+	const tsReal u = U[r];
+	size_t i = first, j = last, ii = 1, jj = last - off, d;
+	tsReal alfi, alfj, diff, dist = 0;
+
+	memcpy(temp, P + off * dim, sof_ctrlp);
+	memcpy(temp + (last + 1 - off) * dim, P + (last + 1) * dim,
+		sof_ctrlp);
+	while (j > i) {
+		alfi = (u - U[i]) / (U[i + order] - U[i]);
+		alfj = (u - U[j]) / (U[j + order] - U[j]);
+		for (d = 0; d < dim; d++) {
+			temp[ii * dim + d] = (P[i * dim + d] -
+				(1.f - alfi) * temp[(ii - 1) * dim + d]) / alfi;
+			temp[jj * dim + d] = (P[j * dim + d] -
+				alfj * temp[(jj + 1) * dim + d]) / (1.f - alfj);
+		}
+		i++; ii++;
+		j--; jj--;
+	}
+	if (j < i) {
+		return ts_distance(temp + (ii - 1) * dim,
+			temp + (jj + 1) * dim, dim);
+	}
+	alfi = (u - U[i]) / (U[i + order] - U[i]);
+	for (d = 0; d < dim; d++) {
+		diff = P[i * dim + d] - (alfi * temp[(ii + 1) * dim + d] +
+			(1.f - alfi) * temp[(ii - 1) * dim + d]);
+		dist += diff * diff;
+	}
+	return (tsReal) sqrt(dist);
+}
+
+/**
+ * The arrays processed by ts_bspline_remove_knots contain a gap (the removed
+ * elements) that separates the elements before index \p *gap from the
+ * remaining ones. This function moves the gap to index \p to (if it is not
+ * already there), such that all elements before \p to can be accessed
+ * directly. Each element consists of \p stride values.
+ */
+void ts_int_gap_move(tsReal *arr, size_t stride, size_t removed, size_t to,
+	size_t *gap)
+{
+	if (*gap >= to)
+		return;
+	if (removed)
+		memmove(arr + *gap * stride, arr + (*gap + removed) *
+			stride, (to - *gap) * stride * sizeof(tsReal));
+	*gap = to;
+}
+
+tsError ts_bspline_remove_knots(const tsBSpline *spline, tsReal tolerance,
+	tsBSpline *out, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_real = sizeof(tsReal);
+	const size_t sof_ctrlp = dim * sof_real;
+	size_t n = ts_bspline_num_control_points(spline) - 1;
+	size_t m = ts_bspline_num_knots(spline) - 1;
+	const size_t len_P = n + 1, len_U = m + 1;
+
+	tsBSpline tmp;  /**< Stores the result. */
+	tsReal *P, *U;  /**< The control points and knots of the result. */
+	tsReal *E;      /**< Accumulated error bounds of the knot spans. */
+	tsReal *temp;   /**< See ts_int_bspline_removal_error. */
+	tsReal *work = NULL;
+	tsReal umin, umax, dist, bound;
+	size_t k, r, s, i, j, hi, first, last, fout;
+	/* Removing a knot affects only a few elements of P, U, and E. Rather
+	 * than shifting their tails, the removed elements form a gap that
+	 * moves along with the processed knots. This keeps the runtime
+	 * linear in the number of knots. */
+	size_t gp, gu, ge, removed = 0;
+	tsError err;
+
+	INIT_OUT_BSPLINE(spline, out)
+	ts_int_bspline_init(&tmp);
+	TS_TRY(try, err, status)
+		work = (tsReal *) ts_int_malloc((len_P * dim + 2 * len_U +
+			(deg + 3) * dim) * sof_real);
+		if (!work) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		P = work;
+		U = P + len_P * dim;
+		E = U + len_U;
+		temp = E + len_U;
+		memcpy(P, ts_int_bspline_access_ctrlp(spline),
+			len_P * sof_ctrlp);
+		memcpy(U, ts_int_bspline_access_knots(spline),
+			len_U * sof_real);
+		ts_arr_fill(E, len_U, 0);
+		gp = gu = ge = 0;
+		umin = U[deg];
+		umax = U[n + 1];
+
+		/* The knots within the domain, i.e., U[deg+1] ... U[n]. Each
+		 * knot is removed as often as possible before continuing with
+		 * the next one. */
+		for (k = deg + 1; k <= n; k = r + 1) {
+			ts_int_gap_move(P, dim, removed, k + deg + 2 < n + 1
+				? k + deg + 2 : n + 1, &gp);
+			ts_int_gap_move(U, 1, removed, k + 2 * deg + 3 < m + 1
+				? k + 2 * deg + 3 : m + 1, &gu);
+			ts_int_gap_move(E, 1, removed, gu, &ge);
+			for (r = k; r < n && ts_knots_equal(U[r + 1], U[k]);
+				r++);
+			s = r - k + 1;
+			if (ts_knots_equal(U[k], umin) ||
+				ts_knots_equal(U[k], umax))
+				continue;
+			dist = ts_int_bspline_removal_error(P, U, deg, dim, r,
+				s, temp);
+			/* The affected knot spans. */
+			first = r - deg;
+			last = r - s;
+			hi = last + deg < m ? last + deg : m - 1;
+			bound = 0;
+			for (i = first; i <= hi; i++)
+				bound = E[i] > bound ? E[i] : bound;
+			if (!(bound + dist <= tolerance))
+				continue;
+			for (i = first; i <= hi; i++)
+				E[i] += dist;
+			/* Apply. */
+			for (i = first, j = last; j > i; i++, j--) {
+				memcpy(P + i * dim, temp + (i - first + 1) *
+					dim, sof_ctrlp);
+				memcpy(P + j * dim, temp + (j - first + 1) *
+					dim, sof_ctrlp);
+			}
+			fout = (2 * r - s - deg) / 2;
+			memmove(P + fout * dim, P + (fout + 1) * dim,
+				(gp - fout - 1) * sof_ctrlp);
+			memmove(U + r, U + r + 1, (gu - r - 1) * sof_real);
+			/* The spans r-1 and r are merged. */
+			E[r - 1] = E[r] > E[r - 1] ? E[r] : E[r - 1];
+			memmove(E + r, E + r + 1, (ge - r - 1) * sof_real);
+			gp--;
+			gu--;
+			ge--;
+			removed++;
+			n--;
+			m--;
+			/* Try to remove the knot once more. */
+			r = k - 1;
+		}
+		ts_int_gap_move(P, dim, removed, n + 1, &gp);
+		ts_int_gap_move(U, 1, removed, m + 1, &gu);
+
+		TS_CALL(try, err, ts_bspline_new(n + 1, dim, deg, TS_OPENED,
+			&tmp, status))
+		memcpy(ts_int_bspline_access_ctrlp(&tmp), P,
+			(n + 1) * sof_ctrlp);
+		memcpy(ts_int_bspline_access_knots(&tmp), U,
+			(m + 1) * sof_real);
+		if (spline == out)
+			ts_bspline_free(out);
+		ts_bspline_move(&tmp, out);
+	TS_CATCH(err)
+		ts_bspline_free(&tmp);
+		if (spline != out)
+			ts_bspline_free(out);
+	TS_FINALLY
+		if (work)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_tension(const tsBSpline *spline, tsReal tension,
+	tsBSpline *out, tsStatus *status)
+{
+	const tsReal s  = 1.f - tension; /**< The straightening factor. */
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t N = ts_bspline_num_control_points(spline);
+	const tsReal* p0 = ts_int_bspline_access_ctrlp(spline);
+	const tsReal* pn_1 = p0 + (N-1)*dim;
+
+	tsReal *ctrlp; /**< Pointer to the control points of \p out. */
+	size_t i, d; /**< Used in for loops. */
+	tsError err;
+
+	TS_CALL_ROE(err, ts_bspline_copy(spline, out, status))
+	ts_int_bspline_drop_cache(out); /* if spline == out */
+	ctrlp = ts_int_bspline_access_ctrlp(out);
+
+	/* The first and last control point are not affected by tension.
+	 * Skipping them keeps p0 and pn_1 intact if \p spline == \p out. */
+	for (i = 1; i + 1 < N; i++) {
+		for (d = 0; d < dim; d++) {
+			ctrlp[i*dim + d] *= tension;
+			ctrlp[i*dim + d] += s * (p0[d] + ((tsReal)i / (N-1)) *
+				(pn_1[d] - p0[d]));
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_to_beziers(const tsBSpline *spline, tsBSpline *beziers,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+
+	tsReal *insert = NULL; /**< The knots to insert. */
+	size_t num;            /**< Number of knots in insert. */
+	size_t first, last;    /**< First and last index of a knot value. */
+	size_t i, j;           /**< Used in for loops. */
+	tsReal min, max;       /**< Domain of spline. */
+	tsError err;
+
+	INIT_OUT_BSPLINE(spline, beziers)
+	ts_bspline_domain(spline, &min, &max);
+	TS_TRY(try, err, status)
+		/* Each knot value of the domain is inserted until its
+		 * multiplicity is equal to the order of spline. */
+		for (num = 0, i = deg; i <= n_ctrlp; i = last + 1) {
+			for (first = i; first > 0 &&
+				ts_knots_equal(knots[first-1], knots[i]);
+				first--);
+			for (last = i; last < n_knots - 1 &&
+				ts_knots_equal(knots[last+1], knots[i]);
+				last++);
+			num += order - (last - first + 1);
+		}
+		if (num > 0) {
+			insert = (tsReal *) ts_int_malloc(num * sizeof(tsReal));
+			if (!insert) {
+				TS_THROW_0(try, err, status, TS_MALLOC,
+					"out of memory")
+			}
+		}
+		for (num = 0, i = deg; i <= n_ctrlp; i = last + 1) {
+			for (first = i; first > 0 &&
+				ts_knots_equal(knots[first-1], knots[i]);
+				first--);
+			for (last = i; last < n_knots - 1 &&
+				ts_knots_equal(knots[last+1], knots[i]);
+				last++);
+			for (j = last - first + 1; j < order; j++)
+				insert[num++] = knots[i];
+		}
+		TS_CALL(try, err, ts_bspline_refine_knots(spline, insert, num,
+			beziers, status))
+
+		/* Remove the control points and knots that are not within the
+		 * domain (if spline is not clamped). */
+		knots = ts_int_bspline_access_knots(beziers);
+		for (first = 0; !ts_knots_equal(knots[first], min); first++);
+		if (first > 0) {
+			TS_CALL(try, err, ts_int_bspline_resize(beziers,
+				-(int) first, 0, beziers, status))
+		}
+		knots = ts_int_bspline_access_knots(beziers);
+		last = ts_bspline_num_knots(beziers) - 1;
+		for (i = last; !ts_knots_equal(knots[i], max); i--);
+		if (i < last) {
+			TS_CALL(try, err, ts_int_bspline_resize(beziers,
+				-(int) (last - i), 1, beziers, status))
+		}
+	TS_CATCH(err)
+		if (spline != beziers)
+			ts_bspline_free(beziers);
+	TS_FINALLY
+		if (insert)
+			ts_int_free(insert);
+	TS_END_TRY_RETURN(err)
+}
+
+/**
+ * Computes the order(spline) control points of the Bezier segment of the
+ * non-empty knot span [knots[k], knots[k+1]) of \p spline by evaluating the
+ * polar form (blossom) of the span, that is, the i-th control point is the
+ * blossom of i times knots[k+1] and deg-i times knots[k]. \p work must be
+ * able to store order(spline) * dimension(spline) values.
+ */
+void ts_int_bspline_bezier_at(const tsBSpline *spline, size_t k,
+	tsReal *work, tsReal *points)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_ctrlp = dim * sizeof(tsReal);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const tsReal a = knots[k], b = knots[k+1];
+	size_t i, r, j, d, idx;
+	tsReal x, alpha, *lp, *rp;
+
+	for (i = 0; i <= deg; i++) {
+		memcpy(work, ctrlp + (k-deg) * dim, (deg+1) * sof_ctrlp);
+		for (r = 1; r <= deg; r++) {
+			x = r <= i ? b : a;
+			for (j = deg; j >= r; j--) {
+				idx = k-deg + j;
+				alpha = (x - knots[idx]) /
+					(knots[idx+deg+1-r] - knots[idx]);
+				lp = work + (j-1) * dim;
+				rp = lp + dim;
+				for (d = 0; d < dim; d++) {
+					rp[d] = (1.f - alpha) * lp[d] +
+						alpha * rp[d];
+				}
+			}
+		}
+		memcpy(points + i * dim, work + deg * dim, sof_ctrlp);
+	}
+}
+
+tsError ts_bspline_to_beziers_stream(const tsBSpline *spline,
+	tsBezierSink sink, void *data, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const size_t len_work = ts_bspline_order(spline) *
+		ts_bspline_dimension(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	tsReal stack[TS_INT_STACK_BUFFER_LEN];
+	tsReal *work = stack;
+	size_t k, index = 0;
+	tsError err = TS_SUCCESS;
+
+	if (2 * len_work > TS_INT_STACK_BUFFER_LEN) {
+		work = (tsReal *) ts_int_malloc(2 * len_work *
+			sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	for (k = deg; k < n_ctrlp && !err; k++) {
+		if (ts_knots_equal(knots[k], knots[k+1]))
+			continue;
+		ts_int_bspline_bezier_at(spline, k, work, work + len_work);
+		err = sink(data, index++, knots[k], knots[k+1],
+			work + len_work, status);
+	}
+	if (work != stack)
+		ts_int_free(work);
+	if (!err)
+		TS_RETURN_SUCCESS(status)
+	return err;
+}
+
+/**
+ * Returns the binomial coefficient of \p n and \p k.
+ */
+tsReal ts_int_binomial(size_t n, size_t k)
+{
+	tsReal b = 1;
+	size_t i;
+	for (i = 1; i <= k; i++)
+		b = b * (tsReal) (n - k + i) / (tsReal) i;
+	return b;
+}
+
+/* Shared (read-only) state of the tasks elevating bezier segments. */
+struct ts_int_elevate_task_context
+{
+	const tsReal *beziers;  /**< Control points of the segments. */
+	const size_t *offsets;  /**< Index of the first output point. */
+	const tsReal *coeffs;   /**< Elevation coefficients (A5.9). */
+	size_t num_segments;
+	size_t order;           /**< Order of the segments. */
+	size_t amount;          /**< Elevate by. */
+	size_t dim;
+	size_t grain_size;      /**< Number of segments per task. */
+	tsReal *ctrlp;          /**< Output of all tasks. */
+};
+
+/**
+ * Elevates the \p index'th chunk of segments of ts_int_elevate_task_context
+ * (cf. ::tsTask). If a segment is merged with its successor, its last
+ * control point is written by the successor.
+ */
+void ts_int_bspline_elevate_task(void *context, size_t index)
+{
+	const struct ts_int_elevate_task_context *ctx =
+		(const struct ts_int_elevate_task_context *) context;
+	const size_t order = ctx->order;
+	const size_t deg = order - 1;
+	const size_t amount = ctx->amount;
+	const size_t dim = ctx->dim;
+	const size_t begin = index * ctx->grain_size;
+	const size_t end = ctx->num_segments - begin < ctx->grain_size
+		? ctx->num_segments : begin + ctx->grain_size;
+	const tsReal *p, *c;
+	tsReal *q;
+	size_t s, num, i, j, lo, hi, d;
+
+	for (s = begin; s < end; s++) {
+		p = ctx->beziers + s * order * dim;
+		q = ctx->ctrlp + ctx->offsets[s] * dim;
+		num = s + 1 < ctx->num_segments
+			? ctx->offsets[s + 1] - ctx->offsets[s]
+			: order + amount;
+		for (i = 0; i < num; i++, q += dim) {
+			c = ctx->coeffs + i * order;
+			lo = i > amount ? i - amount : 0;
+			hi = i < deg ? i : deg;
+			ts_arr_fill(q, dim, 0);
+			for (j = lo; j <= hi; j++) {
+				for (d = 0; d < dim; d++)
+					q[d] += c[j] * p[j * dim + d];
+			}
+		}
+	}
+}
+
+/**
+ * Elevates the degree of \p spline by \p amount in a single pass: \p spline
+ * is decomposed into bezier segments, the layout of the result is computed
+ * (adjacent segments whose common control point is "equal" with respect to
+ * \p epsilon are merged), and the segments are elevated directly into the
+ * memory of the result using the closed-form coefficients of algorithm A5.9
+ * of 'The NURBS Book'. The segments are elevated in tasks of \p grain_size
+ * segments run by \p executor (serially if NULL).
+ */
+tsError ts_int_bspline_elevate_degree(const tsBSpline *spline, size_t amount,
+	tsReal epsilon, tsBSpline *elevated, size_t grain_size,
+	tsExecutor executor, void *executor_data, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t deg = order - 1;
+	const size_t e_order = order + amount;
+	struct ts_int_elevate_task_context ctx;
+	tsBSpline beziers, tmp;
+	const tsReal *b_ctrlp, *b_knots;
+	size_t *offsets, sof_coeffs;
+	tsReal *coeffs = NULL, *knots, bin;
+	size_t num_segments, n_ctrlp, num_tasks, i, j, k, merged;
+	tsError err;
+
+	/* Trivial case. */
+	if (amount == 0)
+		return ts_bspline_copy(spline, elevated, status);
+
+	INIT_OUT_BSPLINE(spline, elevated)
+	ts_int_bspline_init(&beziers);
+	ts_int_bspline_init(&tmp);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		num_segments = ts_bspline_num_control_points(&beziers) /
+			order;
+		b_ctrlp = ts_int_bspline_access_ctrlp(&beziers);
+		b_knots = ts_int_bspline_access_knots(&beziers);
+
+		/* The coefficients followed by the offsets of the segments
+		 * (cf. ts_int_sof_aligned). */
+		sof_coeffs = ts_int_sof_aligned(
+			e_order * order * sizeof(tsReal));
+		coeffs = (tsReal *) ts_int_malloc(sof_coeffs +
+			num_segments * sizeof(size_t));
+		if (!coeffs) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		offsets = (size_t *) ((char *) coeffs + sof_coeffs);
+		for (i = 0; i < e_order; i++) {
+			bin = ts_int_binomial(deg + amount, i);
+			for (j = 0; j < order; j++) {
+				coeffs[i * order + j] = j <= i && i - j <= amount
+					? ts_int_binomial(deg, j) *
+					ts_int_binomial(amount, i - j) / bin
+					: 0;
+			}
+		}
+
+		/* Layout. The outer control points of a segment are not
+		 * changed by elevation. */
+		offsets[0] = 0;
+		for (i = 1; i < num_segments; i++) {
+			merged = ts_distance(b_ctrlp + (i * order - 1) * dim,
+				b_ctrlp + i * order * dim, dim) <= epsilon;
+			offsets[i] = offsets[i - 1] + e_order - merged;
+		}
+		n_ctrlp = offsets[num_segments - 1] + e_order;
+		TS_CALL(try, err, ts_bspline_new(n_ctrlp, dim, deg + amount,
+			TS_OPENED, &tmp, status))
+
+		/* Knots. Each group of knots is elevated by `amount', minus
+		 * the merged control point. */
+		knots = ts_int_bspline_access_knots(&tmp);
+		for (i = 0, k = 0; i <= num_segments; i++) {
+			j = e_order;
+			if (i > 0 && i < num_segments)
+				j = offsets[i] - offsets[i - 1];
+			for (; j > 0; j--)
+				knots[k++] = b_knots[i * order];
+		}
+
+		/* Control points. */
+		if (grain_size == 0)
+			grain_size = TS_INT_GRAIN_SIZE / (e_order * order) + 1;
+		num_tasks = (num_segments - 1) / grain_size + 1;
+		ctx.beziers = b_ctrlp;
+		ctx.offsets = offsets;
+		ctx.coeffs = coeffs;
+		ctx.num_segments = num_segments;
+		ctx.order = order;
+		ctx.amount = amount;
+		ctx.dim = dim;
+		ctx.grain_size = grain_size;
+		ctx.ctrlp = ts_int_bspline_access_ctrlp(&tmp);
+		if (executor) {
+			executor(executor_data, num_tasks,
+				ts_int_bspline_elevate_task, &ctx);
+		} else {
+			for (i = 0; i < num_tasks; i++)
+				ts_int_bspline_elevate_task(&ctx, i);
+		}
+
+		if (spline == elevated)
+			ts_bspline_free(elevated);
+		ts_bspline_move(&tmp, elevated);
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+		ts_bspline_free(&tmp);
+		if (coeffs)
+			ts_int_free(coeffs);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_elevate_degree(const tsBSpline *spline, size_t amount,
+	tsReal epsilon, tsBSpline *elevated, tsStatus * status)
+{
+	return ts_int_bspline_elevate_degree(spline, amount, epsilon,
+		elevated, 0, NULL, NULL, status);
+}
+
+tsError ts_bspline_elevate_degree_parallel(const tsBSpline *spline,
+	size_t amount, tsReal epsilon, tsBSpline *elevated, size_t grain_size,
+	tsExecutor executor, void *executor_data, tsStatus *status)
+{
+	return ts_int_bspline_elevate_degree(spline, amount, epsilon,
+		elevated, grain_size, executor, executor_data, status);
+}
+
+/* State of the tasks of ts_bspline_elevate_to_common_degree. */
+struct ts_int_elevate_all_task_context
+{
+	const tsBSpline *splines;
+	size_t num;
+	size_t deg;          /**< The common degree. */
+	tsReal epsilon;
+	size_t grain_size;   /**< Number of splines per task. */
+	tsBSpline *elevated; /**< Output of all tasks. */
+	tsStatus *statuses;  /**< One status per task. */
+};
+
+/**
+ * Elevates the \p index'th chunk of splines of
+ * ts_int_elevate_all_task_context (cf. ::tsTask).
+ */
+void ts_int_bspline_elevate_all_task(void *context, size_t index)
+{
+	const struct ts_int_elevate_all_task_context *ctx =
+		(const struct ts_int_elevate_all_task_context *) context;
+	const size_t begin = index * ctx->grain_size;
+	const size_t end = ctx->num - begin < ctx->grain_size
+		? ctx->num : begin + ctx->grain_size;
+	size_t i;
+	for (i = begin; i < end; i++) {
+		if (ts_bspline_elevate_degree(ctx->splines + i, ctx->deg -
+				ts_bspline_degree(ctx->splines + i),
+				ctx->epsilon, ctx->elevated + i,
+				ctx->statuses + index))
+			return;
+	}
+}
+
+tsError ts_bspline_elevate_to_common_degree(const tsBSpline *splines,
+	size_t num, tsReal epsilon, tsBSpline *elevated, size_t grain_size,
+	tsExecutor executor, void *executor_data, tsStatus *status)
+{
+	struct ts_int_elevate_all_task_context ctx;
+	size_t num_tasks, i;
+	tsError err = TS_SUCCESS;
+
+	if (num == 0)
+		TS_RETURN_SUCCESS(status)
+	if (grain_size == 0)
+		grain_size = 1;
+	num_tasks = (num - 1) / grain_size + 1;
+	ctx.splines = splines;
+	ctx.num = num;
+	ctx.deg = 0;
+	for (i = 0; i < num; i++) {
+		if (ts_bspline_degree(splines + i) > ctx.deg)
+			ctx.deg = ts_bspline_degree(splines + i);
+	}
+	ctx.epsilon = epsilon;
+	ctx.grain_size = grain_size;
+	ctx.elevated = elevated;
+	ctx.statuses = (tsStatus *) ts_int_malloc(num_tasks * sizeof(tsStatus));
+	if (!ctx.statuses)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	for (i = 0; i < num_tasks; i++)
+		ctx.statuses[i].code = TS_SUCCESS;
+	/* Splines that are not elevated (due to an error) can be freed. */
+	if (splines != elevated) {
+		for (i = 0; i < num; i++)
+			ts_int_bspline_init(elevated + i);
+	}
+	if (executor) {
+		executor(executor_data, num_tasks,
+			ts_int_bspline_elevate_all_task, &ctx);
+	} else {
+		for (i = 0; i < num_tasks; i++)
+			ts_int_bspline_elevate_all_task(&ctx, i);
+	}
+	for (i = 0; i < num_tasks; i++) {
+		if (ctx.statuses[i].code != TS_SUCCESS) {
+			err = ctx.statuses[i].code;
+			if (status)
+				*status = ctx.statuses[i];
+			break;
+		}
+	}
+	ts_int_free(ctx.statuses);
+	if (err == TS_SUCCESS)
+		TS_RETURN_SUCCESS(status)
+	return err;
+}
+
+tsError ts_bspline_align(const tsBSpline *s1, const tsBSpline *s2,
+	tsReal epsilon, tsBSpline *s1_out, tsBSpline *s2_out, tsStatus *status)
+{
+	tsBSpline s1_worker, s2_worker, *smaller, *larger;
+	tsDeBoorNet net; /* the net of `smaller'. */
+	size_t i, missing, remaining;
+	tsReal min, max, shift, nextKnot;
+	tsError err;
+
+	INIT_OUT_BSPLINE(s1, s1_out)
+	INIT_OUT_BSPLINE(s2, s2_out)
+	s1_worker = ts_bspline_init();
+	s2_worker = ts_bspline_init();
+	net = ts_deboornet_init();
+	smaller = larger = NULL;
+	TS_TRY(try, err, status)
+		/* Set up `s1_worker' and `s2_worker'. After this
+		 * if-elseif-else-block, `s1_worker' and `s2_worker' have same
+		 * degree. */
+		if (ts_bspline_degree(s1) < ts_bspline_degree(s2)) {
+			TS_CALL(try, err, ts_bspline_elevate_degree(s1,
+				ts_bspline_degree(s2) - ts_bspline_degree(s1),
+				epsilon, &s1_worker, status))
+			TS_CALL(try, err, ts_bspline_copy(
+				s2, &s2_worker, status))
+		} else if (ts_bspline_degree(s2) < ts_bspline_degree(s1)) {
+			TS_CALL(try, err, ts_bspline_elevate_degree(s2,
+				ts_bspline_degree(s1) - ts_bspline_degree(s2),
+				epsilon, &s2_worker, status))
+			TS_CALL(try, err, ts_bspline_copy(
+				s1, &s1_worker, status))
+		} else {
+			TS_CALL(try, err, ts_bspline_copy(
+				s1, &s1_worker, status))
+			TS_CALL(try, err, ts_bspline_copy(
+				s2, &s2_worker, status))
+		}
+
+		/* Set up `smaller', `larger', and `net'. */
+		if (ts_bspline_num_knots(&s1_worker) <
+				ts_bspline_num_knots(&s2_worker)) {
+			smaller = &s1_worker;
+			larger  = &s2_worker;
+		} else {
+			smaller = &s2_worker;
+			larger  = &s1_worker;
+		}
+		TS_CALL(try, err, ts_int_deboornet_new(
+			smaller, &net, status))
+
+		/* Insert knots into `smaller' until it has the same number of
+		 * knots (and therefore the same number of control points) as
+		 * `larger'. */
+		ts_bspline_domain(smaller, &min, &max);
+		missing = remaining = ts_bspline_num_knots(larger) -
+			ts_bspline_num_knots(smaller);
+		shift = (tsReal) 0.0;
+		if (missing > 0)
+			shift = ( (tsReal) 1.0 / missing ) * (tsReal) 0.5;
+		for (i = 0; remaining > 0; i++, remaining--) {
+			nextKnot = (max - min) * ((tsReal)i / missing) + min;
+			nextKnot += shift;
+			TS_CALL(try, err, ts_int_bspline_eval_woa(
+				smaller, nextKnot, &net, status))
+			while (!ts_deboornet_num_insertions(&net)) {
+				/* Linear exploration for next knot. */
+				nextKnot += 5 * TS_KNOT_EPSILON;
+				if (nextKnot > max) {
+					TS_THROW_0(try, err, status,
+						TS_NO_RESULT,
+						"no more knots for insertion")
+				}
+				TS_CALL(try, err, ts_int_bspline_eval_woa(
+					smaller, nextKnot, &net, status))
+			}
+			TS_CALL(try, err, ts_int_bspline_insert_knot(
+				smaller, &net, 1, smaller, status))
+		}
+
+		if (s1 == s1_out)
+			ts_bspline_free(s1_out);
+		if (s2 == s2_out)
+			ts_bspline_free(s2_out);
+		ts_bspline_move(&s1_worker, s1_out);
+		/* if `s1_out' == `s2_out', `s2_worker' must not be moved
+		 * because otherwise the memory of `s1_worker' is leaked
+		 * (`s2_worker' overrides `s1_worker'). */
+		if (s1_out != s2_out)
+			ts_bspline_move(&s2_worker, s2_out);
+	TS_FINALLY
+		ts_bspline_free(&s1_worker);
+		ts_bspline_free(&s2_worker);
+		ts_deboornet_free(&net);
+	TS_END_TRY_RETURN(err)
+}
+
+/* Interpolates between the aligned splines `start' and `end'. The memory of
+ * `out' is reused if it has the layout of the interpolated spline. */
+tsError ts_int_bspline_morph(const tsBSpline *start, const tsBSpline *end,
+	tsReal t, tsBSpline *out, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(start);
+	const size_t num_ctrlp = ts_bspline_num_control_points(start);
+	const size_t num_knots = ts_bspline_num_knots(start);
+	const size_t dim_start = ts_bspline_dimension(start);
+	const size_t dim_end = ts_bspline_dimension(end);
+	const size_t dim = dim_start < dim_end ? dim_start : dim_end;
+	const tsReal *start_c = ts_int_bspline_access_ctrlp(start);
+	const tsReal *start_k = ts_int_bspline_access_knots(start);
+	const tsReal *end_c = ts_int_bspline_access_ctrlp(end);
+	const tsReal *end_k = ts_int_bspline_access_knots(end);
+
+	tsBSpline tmp = ts_bspline_init(), *target = out;
+	tsReal t_hat, *ctrlp, *knots;
+	size_t i, d;
+	tsError err;
+
+	/* Limit `t' to domain [0, 1] and set up `t_hat'. */
+	if (t < (tsReal) 0.0)
+		t = (tsReal) 0.0;
+	if (t > (tsReal) 1.0)
+		t = (tsReal) 1.0;
+	t_hat = (tsReal) 1.0 - t;
+
+	/* Set up the output. If the layout of `out' does not match, the
+	 * result is computed in a new spline first because `out' may alias
+	 * `start' or `end'. */
+	if (!out->pImpl || ts_bspline_degree(out) != deg ||
+		ts_bspline_dimension(out) != dim ||
+		ts_bspline_num_control_points(out) != num_ctrlp) {
+		TS_CALL_ROE(err, ts_bspline_new(num_ctrlp, dim, deg,
+			TS_OPENED /* doesn't matter */, &tmp, status))
+		target = &tmp;
+	} else {
+		ts_int_bspline_drop_cache(out);
+	}
+	ctrlp = ts_int_bspline_access_ctrlp(target);
+	knots = ts_int_bspline_access_knots(target);
+
+	/* Interpolate control points. */
+	for (i = 0; i < num_ctrlp; i++) {
+		for (d = 0; d < dim; d++) {
+			ctrlp[i * dim + d] = t * end_c[i * dim_end + d] +
+				t_hat * start_c[i * dim_start + d];
+		}
+	}
+
+	/* Interpolate knots. */
+	for (i = 0; i < num_knots; i++)
+		knots[i] = t * end_k[i] + t_hat * start_k[i];
+
+	if (target == &tmp) {
+		ts_bspline_free(out);
+		ts_bspline_move(&tmp, out);
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_morph(const tsBSpline *start, const tsBSpline *end,
+	tsReal t, tsReal epsilon, tsBSpline *out, tsStatus *status)
+{
+	tsBSpline start_al, end_al; /* aligned start and end */
+	tsError err;
+
+	start_al = ts_bspline_init();
+	end_al = ts_bspline_init();
+	TS_TRY(try, err, status)
+		/* Set up `start_al' and `end_al'. */
+		/* Degree must be elevated... */
+		if (ts_bspline_degree(start) != ts_bspline_degree(end) ||
+		/* .. or knots (and thus control points) must be inserted. */
+		ts_bspline_num_knots(start) != ts_bspline_num_knots(end)) {
+			TS_CALL(try, err, ts_bspline_align(
+				start, end, epsilon, &start_al, &end_al,
+				status));
+		} else {
+			/* Flat copy. */
+			start_al = *start;
+			end_al = *end;
+		}
+		TS_CALL(try, err, ts_int_bspline_morph(
+			&start_al, &end_al, t, out, status))
+	TS_FINALLY
+		if (start->pImpl != start_al.pImpl)
+			ts_bspline_free(&start_al);
+		if (end->pImpl != end_al.pImpl)
+			ts_bspline_free(&end_al);
+	TS_END_TRY_RETURN(err)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Collection Functions                                                     *
+*                                                                             *
+******************************************************************************/
+/* State of the tasks of ts_bspline_map. */
+struct ts_int_map_task_context
+{
+	const tsBSpline *splines;
+	size_t num;
+	tsBSplineOp op;
+	const void *args;
+	size_t grain_size;   /**< Number of splines per task. */
+	tsBSpline *results;  /**< Output of all tasks. */
+	tsStatus *statuses;  /**< One status per spline. May be NULL. */
+	tsStatus *firsts;    /**< First error of each task. */
+};
+
+/**
+ * Transforms the \p index'th chunk of splines of ts_int_map_task_context
+ * (cf. ::tsTask). Failures are recorded, but do not stop the chunk.
+ */
+void ts_int_bspline_map_task(void *context, size_t index)
+{
+	const struct ts_int_map_task_context *ctx =
+		(const struct ts_int_map_task_context *) context;
+	const size_t begin = index * ctx->grain_size;
+	const size_t end = ctx->num - begin < ctx->grain_size
+		? ctx->num : begin + ctx->grain_size;
+	tsStatus local, *status;
+	size_t i;
+	for (i = begin; i < end; i++) {
+		status = ctx->statuses ? ctx->statuses + i : &local;
+		if (ctx->op(ctx->splines + i, ctx->args, ctx->results + i,
+				status)) {
+			if (ctx->firsts[index].code == TS_SUCCESS)
+				ctx->firsts[index] = *status;
+		}
+	}
+}
+
+tsError ts_bspline_map(const tsBSpline *splines, size_t num, tsBSplineOp op,
+	const void *args, tsBSpline *results, tsStatus *statuses,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status)
+{
+	struct ts_int_map_task_context ctx;
+	size_t num_tasks, i;
+	tsError err = TS_SUCCESS;
+
+	if (num == 0)
+		TS_RETURN_SUCCESS(status)
+	if (grain_size == 0)
+		grain_size = 1;
+	num_tasks = (num - 1) / grain_size + 1;
+	ctx.splines = splines;
+	ctx.num = num;
+	ctx.op = op;
+	ctx.args = args;
+	ctx.grain_size = grain_size;
+	ctx.results = results;
+	ctx.statuses = statuses;
+	ctx.firsts = (tsStatus *) ts_int_malloc(num_tasks * sizeof(tsStatus));
+	if (!ctx.firsts)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	for (i = 0; i < num_tasks; i++)
+		ctx.firsts[i].code = TS_SUCCESS;
+	/* Splines that are not transformed (due to an error) can be freed. */
+	if (splines != results) {
+		for (i = 0; i < num; i++)
+			ts_int_bspline_init(results + i);
+	}
+	if (executor) {
+		executor(executor_data, num_tasks, ts_int_bspline_map_task,
+			&ctx);
+	} else {
+		for (i = 0; i < num_tasks; i++)
+			ts_int_bspline_map_task(&ctx, i);
+	}
+	for (i = 0; i < num_tasks; i++) {
+		if (ctx.firsts[i].code != TS_SUCCESS) {
+			err = ctx.firsts[i].code;
+			if (status)
+				*status = ctx.firsts[i];
+			break;
+		}
+	}
+	ts_int_free(ctx.firsts);
+	if (err == TS_SUCCESS)
+		TS_RETURN_SUCCESS(status)
+	return err;
+}
+
+tsError ts_bspline_op_derive(const tsBSpline *spline, const void *args,
+	tsBSpline *out, tsStatus *status)
+{
+	const tsBSplineOpArgs *a = (const tsBSplineOpArgs *) args;
+	return ts_bspline_derive(spline, a->n, a->epsilon, out, status);
+}
+
+tsError ts_bspline_op_split(const tsBSpline *spline, const void *args,
+	tsBSpline *out, tsStatus *status)
+{
+	const tsBSplineOpArgs *a = (const tsBSplineOpArgs *) args;
+	size_t k;
+	return ts_bspline_split(spline, a->value, out, &k, status);
+}
+
+tsError ts_bspline_op_tension(const tsBSpline *spline, const void *args,
+	tsBSpline *out, tsStatus *status)
+{
+	const tsBSplineOpArgs *a = (const tsBSplineOpArgs *) args;
+	return ts_bspline_tension(spline, a->value, out, status);
+}
+
+tsError ts_bspline_op_to_beziers(const tsBSpline *spline, const void *args,
+	tsBSpline *out, tsStatus *status)
+{
+	(void) args;
+	return ts_bspline_to_beziers(spline, out, status);
+}
+
+tsError ts_bspline_op_elevate_degree(const tsBSpline *spline,
+	const void *args, tsBSpline *out, tsStatus *status)
+{
+	const tsBSplineOpArgs *a = (const tsBSplineOpArgs *) args;
+	return ts_bspline_elevate_degree(spline, a->n, a->epsilon, out,
+		status);
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Alignment Plan Functions                                                 *
+*                                                                             *
+******************************************************************************/
+tsAlignmentPlan ts_alignment_plan_init()
+{
+	tsAlignmentPlan plan;
+	ts_int_alignment_plan_init(&plan);
+	return plan;
+}
+
+/**
+ * Creates a spline with the degree and knots of \p spline whose control
+ * points form an identity matrix, i.e., the resultant spline has dimension
+ * num(control_points) and control point j is the j-th unit vector. Aligning
+ * such a spline yields the weights of the original control points. To save
+ * memory, the unit vectors are wrapped around after \p channels dimensions.
+ * Since aligning a spline is a local operation (each aligned control point
+ * depends on a few consecutive control points only), the weights can still
+ * be assigned to their control points unambiguously (cf.
+ * ts_int_alignment_plan_rows).
+ */
+tsError ts_int_alignment_plan_pack(const tsBSpline *spline, size_t channels,
+	tsBSpline *packed, tsStatus *status)
+{
+	const size_t n = ts_bspline_num_control_points(spline);
+	const size_t dim = n < channels ? n : channels;
+	tsReal *ctrlp;
+	size_t j;
+	tsError err;
+
+	TS_CALL_ROE(err, ts_bspline_new(n, dim, ts_bspline_degree(spline),
+		TS_OPENED, packed, status))
+	memcpy(ts_int_bspline_access_knots(packed),
+		ts_int_bspline_access_knots(spline),
+		ts_bspline_sof_knots(spline));
+	ctrlp = ts_int_bspline_access_ctrlp(packed);
+	ts_arr_fill(ctrlp, n * dim, 0);
+	for (j = 0; j < n; j++)
+		ctrlp[j * dim + j % dim] = 1;
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Reads the weights of the aligned control points of \p aligned, a packed
+ * spline (cf. ts_int_alignment_plan_pack) with \p n_in control points before
+ * the alignment. The index of the first affected control point of each
+ * aligned control point increases monotonically. Thus, the channel of a
+ * weight is mapped to the first control point with this channel that is not
+ * less than the first affected control point of the previous aligned control
+ * point. If \p firsts, \p offsets, and \p weights are NULL, the weights are
+ * counted only. The number of weights is stored in \p n_weights.
+ */
+tsError ts_int_alignment_plan_rows(const tsBSpline *aligned, size_t n_in,
+	size_t *firsts, size_t *offsets, tsReal *weights, size_t *n_weights,
+	tsStatus *status)
+{
+	const size_t n_out = ts_bspline_num_control_points(aligned);
+	const size_t dim = ts_bspline_dimension(aligned);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(aligned);
+	const tsReal *row;
+	size_t r, c, j, base = 0, first, last, count = 0;
+
+	for (r = 0; r < n_out; r++) {
+		row = ctrlp + r * dim;
+		first = n_in;
+		last = 0;
+		for (c = 0; c < dim; c++) {
+			if (!(row[c] < 0 || row[c] > 0))
+				continue;
+			j = base + (c + dim - base % dim) % dim;
+			if (j < first)
+				first = j;
+			if (j > last)
+				last = j;
+		}
+		if (first >= n_in || last >= n_in) {
+			TS_RETURN_1(status, TS_NO_RESULT,
+				"unable to compute weights of control point %lu",
+				(unsigned long) r)
+		}
+		if (weights) {
+			firsts[r] = first;
+			offsets[r] = count;
+			for (j = first; j <= last; j++)
+				weights[count + j - first] = row[j % dim];
+		}
+		count += last - first + 1;
+		base = first;
+	}
+	if (weights)
+		offsets[n_out] = count;
+	*n_weights = count;
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_alignment_plan_new(const tsBSpline *s1, const tsBSpline *s2,
+	tsReal epsilon, tsAlignmentPlan *plan, tsStatus *status)
+{
+	const tsBSpline *splines[2];
+	tsBSpline packed[2], aligned[2];
+	struct tsAlignmentPlanImpl impl;
+	size_t side, channels, size;
+	tsError err;
+
+	ts_int_alignment_plan_init(plan);
+	splines[0] = s1;
+	splines[1] = s2;
+	impl.degs[0] = ts_bspline_degree(s1);
+	impl.degs[1] = ts_bspline_degree(s2);
+	impl.deg = impl.degs[0] > impl.degs[1] ? impl.degs[0] : impl.degs[1];
+	/* Wide enough for the control points affecting an aligned control
+	 * point plus the shift between two consecutive aligned control
+	 * points. */
+	channels = 4 * (impl.deg + 1);
+	for (side = 0; side < 2; side++) {
+		ts_int_bspline_init(&packed[side]);
+		ts_int_bspline_init(&aligned[side]);
+	}
+	TS_TRY(try, err, status)
+		for (side = 0; side < 2; side++) {
+			impl.n_knots[side] = ts_bspline_num_knots(splines[side]);
+			TS_CALL(try, err, ts_int_alignment_plan_pack(
+				splines[side], channels, &packed[side], status))
+		}
+		TS_CALL(try, err, ts_bspline_align(&packed[0], &packed[1],
+			epsilon, &aligned[0], &aligned[1], status))
+		impl.n_ctrlp = ts_bspline_num_control_points(&aligned[0]);
+		for (side = 0; side < 2; side++) {
+			TS_CALL(try, err, ts_int_alignment_plan_rows(
+				&aligned[side],
+				ts_bspline_num_control_points(splines[side]),
+				NULL, NULL, NULL, impl.n_weights + side, status))
+		}
+
+		size = ts_int_alignment_plan_sof_state(&impl);
+		plan->pImpl = (struct tsAlignmentPlanImpl *)
+			ts_int_malloc(size);
+		if (!plan->pImpl) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		*plan->pImpl = impl;
+		for (side = 0; side < 2; side++) {
+			memcpy(ts_int_alignment_plan_access_knots(plan, side),
+				ts_int_bspline_access_knots(splines[side]),
+				ts_bspline_sof_knots(splines[side]));
+			memcpy(ts_int_alignment_plan_access_aligned(plan, side),
+				ts_int_bspline_access_knots(&aligned[side]),
+				ts_bspline_sof_knots(&aligned[side]));
+			TS_CALL(try, err, ts_int_alignment_plan_rows(
+				&aligned[side],
+				ts_bspline_num_control_points(splines[side]),
+				ts_int_alignment_plan_access_firsts(plan, side),
+				ts_int_alignment_plan_access_offsets(plan, side),
+				ts_int_alignment_plan_access_weights(plan, side),
+				impl.n_weights + side, status))
+		}
+	TS_CATCH(err)
+		ts_alignment_plan_free(plan);
+	TS_FINALLY
+		for (side = 0; side < 2; side++) {
+			ts_bspline_free(&packed[side]);
+			ts_bspline_free(&aligned[side]);
+		}
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_alignment_plan_copy(const tsAlignmentPlan *src,
+	tsAlignmentPlan *dest, tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_alignment_plan_init(dest);
+	size = ts_int_alignment_plan_sof_state(src->pImpl);
+	dest->pImpl = (struct tsAlignmentPlanImpl *) ts_int_malloc(size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_alignment_plan_move(tsAlignmentPlan *src, tsAlignmentPlan *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_alignment_plan_init(src);
+}
+
+void ts_alignment_plan_free(tsAlignmentPlan *plan)
+{
+	if (plan->pImpl)
+		ts_int_free(plan->pImpl);
+	ts_int_alignment_plan_init(plan);
+}
+
+/* Checks whether `spline' has the degree and knots of the spline `plan' was
+ * created with (`side' 0: s1, `side' 1: s2). */
+tsError ts_int_alignment_plan_check(const tsAlignmentPlan *plan, size_t side,
+	const tsBSpline *spline, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const tsReal *plan_knots =
+		ts_int_alignment_plan_access_knots(plan, side);
+	size_t i;
+
+	if (deg != plan->pImpl->degs[side]) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"degree (%lu) != degree(plan) (%lu)",
+			(unsigned long) deg,
+			(unsigned long) plan->pImpl->degs[side])
+	}
+	if (n_knots != plan->pImpl->n_knots[side]) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"num(knots) (%lu) != num(knots(plan)) (%lu)",
+			(unsigned long) n_knots,
+			(unsigned long) plan->pImpl->n_knots[side])
+	}
+	for (i = 0; i < n_knots; i++) {
+		if (!ts_knots_equal(knots[i], plan_knots[i])) {
+			TS_RETURN_3(status, TS_INCOMPATIBLE,
+				"knot at index %lu (%f) != plan (%f)",
+				(unsigned long) i, knots[i], plan_knots[i])
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Applies one side of `plan' to `spline' and stores the result in `out',
+ * which must not alias `spline'. The memory of `out' is reused if it has the
+ * layout of the aligned spline. */
+tsError ts_int_alignment_plan_apply(const tsAlignmentPlan *plan, size_t side,
+	const tsBSpline *spline, tsBSpline *out, tsStatus *status)
+{
+	const size_t deg = plan->pImpl->deg;
+	const size_t n_ctrlp = plan->pImpl->n_ctrlp;
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t *firsts = ts_int_alignment_plan_access_firsts(plan, side);
+	const size_t *offsets =
+		ts_int_alignment_plan_access_offsets(plan, side);
+	const tsReal *weights =
+		ts_int_alignment_plan_access_weights(plan, side);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *p;
+	tsBSpline tmp;
+	tsReal *q;
+	size_t r, j, d;
+	tsError err;
+
+	if (!out->pImpl || ts_bspline_degree(out) != deg ||
+		ts_bspline_dimension(out) != dim ||
+		ts_bspline_num_control_points(out) != n_ctrlp) {
+		TS_CALL_ROE(err, ts_bspline_new(n_ctrlp, dim, deg,
+			TS_OPENED /* doesn't matter */, &tmp, status))
+		ts_bspline_free(out);
+		ts_bspline_move(&tmp, out);
+	} else {
+		ts_int_bspline_drop_cache(out);
+	}
+	memcpy(ts_int_bspline_access_knots(out),
+		ts_int_alignment_plan_access_aligned(plan, side),
+		ts_bspline_sof_knots(out));
+	q = ts_int_bspline_access_ctrlp(out);
+	for (r = 0; r < n_ctrlp; r++, q += dim) {
+		p = ctrlp + firsts[r] * dim;
+		ts_arr_fill(q, dim, 0);
+		for (j = offsets[r]; j < offsets[r + 1]; j++, p += dim) {
+			for (d = 0; d < dim; d++)
+				q[d] += weights[j] * p[d];
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_alignment_plan_apply(const tsAlignmentPlan *plan,
+	const tsBSpline *s1, const tsBSpline *s2, tsBSpline *s1_out,
+	tsBSpline *s2_out, tsStatus *status)
+{
+	const tsBSpline *splines[2];
+	tsBSpline *outs[2], *targets[2], tmp[2];
+	/* If `s1_out' == `s2_out', only `s1' is aligned (cf.
+	 * ts_bspline_align). */
+	const size_t num = s1_out == s2_out ? 1 : 2;
+	size_t side;
+	tsError err;
+
+	splines[0] = s1;
+	splines[1] = s2;
+	outs[0] = s1_out;
+	outs[1] = s2_out;
+	for (side = 0; side < 2; side++) {
+		TS_CALL_ROE(err, ts_int_alignment_plan_check(plan, side,
+			splines[side], status))
+		ts_int_bspline_init(&tmp[side]);
+	}
+	TS_TRY(try, err, status)
+		/* Outputs aliasing one of the inputs are computed in a new
+		 * spline first. */
+		for (side = 0; side < num; side++) {
+			targets[side] = outs[side]->pImpl &&
+				(outs[side]->pImpl == s1->pImpl ||
+				outs[side]->pImpl == s2->pImpl)
+				? &tmp[side] : outs[side];
+			TS_CALL(try, err, ts_int_alignment_plan_apply(plan,
+				side, splines[side], targets[side], status))
+		}
+		for (side = 0; side < num; side++) {
+			if (targets[side] == &tmp[side]) {
+				ts_bspline_free(outs[side]);
+				ts_bspline_move(&tmp[side], outs[side]);
+			}
+		}
+	TS_FINALLY
+		for (side = 0; side < 2; side++)
+			ts_bspline_free(&tmp[side]);
+	TS_END_TRY_RETURN(err)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Morphism Functions                                                       *
+*                                                                             *
+******************************************************************************/
+tsMorphism ts_morphism_init()
+{
+	tsMorphism morphism;
+	ts_int_morphism_init(&morphism);
+	return morphism;
+}
+
+tsError ts_int_morphism_alloc(tsMorphism *morphism, tsStatus *status)
+{
+	morphism->pImpl = (struct tsMorphismImpl *) ts_int_malloc(
+		sizeof(struct tsMorphismImpl));
+	if (!morphism->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	morphism->pImpl->start = ts_bspline_init();
+	morphism->pImpl->end = ts_bspline_init();
+	morphism->pImpl->epsilon = TS_CONTROL_POINT_EPSILON;
+	ts_int_alignment_plan_init(&morphism->pImpl->plan);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_morphism_new(const tsBSpline *start, const tsBSpline *end,
+	tsReal epsilon, tsMorphism *morphism, tsStatus *status)
+{
+	struct tsMorphismImpl *impl;
+	tsError err;
+	ts_int_morphism_init(morphism);
+	TS_CALL_ROE(err, ts_int_morphism_alloc(morphism, status))
+	impl = morphism->pImpl;
+	impl->epsilon = epsilon;
+	TS_TRY(try, err, status)
+		if (ts_bspline_degree(start) != ts_bspline_degree(end) ||
+			ts_bspline_num_knots(start) !=
+			ts_bspline_num_knots(end)) {
+			TS_CALL(try, err, ts_bspline_align(start, end,
+				epsilon, &impl->start, &impl->end, status))
+		} else {
+			TS_CALL(try, err, ts_bspline_copy(
+				start, &impl->start, status))
+			TS_CALL(try, err, ts_bspline_copy(
+				end, &impl->end, status))
+		}
+	TS_CATCH(err)
+		ts_morphism_free(morphism);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_morphism_copy(const tsMorphism *src, tsMorphism *dest,
+	tsStatus *status)
+{
+	tsError err;
+	if (dest == src)
+		TS_RETURN_SUCCESS(status)
+	TS_CALL_ROE(err, ts_int_morphism_alloc(dest, status))
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_copy(&src->pImpl->start,
+			&dest->pImpl->start, status))
+		TS_CALL(try, err, ts_bspline_copy(&src->pImpl->end,
+			&dest->pImpl->end, status))
+		dest->pImpl->epsilon = src->pImpl->epsilon;
+		if (src->pImpl->plan.pImpl) {
+			TS_CALL(try, err, ts_alignment_plan_copy(
+				&src->pImpl->plan, &dest->pImpl->plan, status))
+		}
+	TS_CATCH(err)
+		ts_morphism_free(dest);
+	TS_END_TRY_RETURN(err)
+}
+
+void ts_morphism_move(tsMorphism *src, tsMorphism *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_morphism_init(src);
+}
+
+void ts_morphism_free(tsMorphism *morphism)
+{
+	if (morphism->pImpl) {
+		ts_bspline_free(&morphism->pImpl->start);
+		ts_bspline_free(&morphism->pImpl->end);
+		ts_alignment_plan_free(&morphism->pImpl->plan);
+		ts_int_free(morphism->pImpl);
+	}
+	ts_int_morphism_init(morphism);
+}
+
+tsError ts_morphism_update(tsMorphism *morphism, const tsBSpline *start,
+	const tsBSpline *end, tsStatus *status)
+{
+	struct tsMorphismImpl *impl = morphism->pImpl;
+	tsError err;
+	if (!impl->plan.pImpl) {
+		TS_CALL_ROE(err, ts_alignment_plan_new(start, end,
+			impl->epsilon, &impl->plan, status))
+	}
+	return ts_alignment_plan_apply(&impl->plan, start, end, &impl->start,
+		&impl->end, status);
+}
+
+tsError ts_morphism_eval(const tsMorphism *morphism, tsReal t,
+	tsBSpline *out, tsStatus *status)
+{
+	return ts_int_bspline_morph(&morphism->pImpl->start,
+		&morphism->pImpl->end, t, out, status);
+}
+
+tsError ts_morphism_eval_all(const tsMorphism *morphism, const tsReal *ts,
+	size_t num, tsBSpline *outs, tsStatus *status)
+{
+	size_t i;
+	tsError err;
+	for (i = 0; i < num; i++) {
+		TS_CALL_ROE(err, ts_int_bspline_morph(&morphism->pImpl->start,
+			&morphism->pImpl->end, ts[i], outs + i, status))
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
 
-	/* 2.
-	 *
-	 * a) Copy left hand side control points from de boor net.
-	 * b) Copy middle part control points from de boor net.
-	 * c) Copy right hand side control points from de boor net.
-	 * d) Insert knots with u_k. */
-	from = ts_int_deboornet_access_points(deBoorNet);
-	to = ctrlp_result + (k-deg)*dim;
-	stride = (int)(N*dim);
 
-	/* copy control points */
-	for (i = 0; i < n; i++) {                                      /* a) */
-		memcpy(to, from, sof_ctrlp);
-		from += stride;
-		to += dim;
-		stride -= (int)dim;
+/******************************************************************************
+*                                                                             *
+* :: Serialization and Persistence Functions                                  *
+*                                                                             *
+******************************************************************************/
+/* Writes JSON to a file, a fixed size buffer, or a growing buffer. */
+struct ts_int_json_writer {
+	FILE *file;   /**< Target file, or NULL if writing to buf. */
+	char *buf;    /**< Target buffer (chunk if writing to file). */
+	size_t size;  /**< Size of buf. */
+	size_t len;   /**< Number of chars written to buf so far. */
+	int grow;     /**< Reallocate buf (in place of truncating it)? */
+	int pretty;   /**< Insert line breaks and indentation? */
+	char chunk[TS_INT_STACK_BUFFER_LEN]; /**< Buffers the output of file. */
+};
+
+void ts_int_json_writer_init(struct ts_int_json_writer *writer, FILE *file,
+	char *buf, size_t size, int pretty)
+{
+	writer->file = file;
+	writer->buf = file ? writer->chunk : buf;
+	writer->size = file ? sizeof(writer->chunk) : size;
+	writer->len = 0;
+	writer->grow = 0;
+	writer->pretty = pretty;
+}
+
+tsError ts_int_json_flush(struct ts_int_json_writer *writer,
+	tsStatus *status)
+{
+	if (writer->file && writer->len > 0) {
+		if (fwrite(writer->buf, 1, writer->len, writer->file)
+				!= writer->len) {
+			TS_RETURN_0(status, TS_IO_ERROR, "unable to write file")
+		}
+		writer->len = 0;
 	}
-	memcpy(to, from, (N-n) * sof_ctrlp);                           /* b) */
+	TS_RETURN_SUCCESS(status)
+}
 
-	from -= dim;
-	to += (N-n)*dim;
-	/* N = h+1 with h = deg-mult (ts_int_bspline_eval)
-	 * =>  N = deg-mult+1 = order-mult.
-	 *
-	 * n <= order-mult
-	 * =>  N-n+1 >= order-mult - order-mult + 1 = 1
-	 * =>  -(int)(N-n+1) <= -1. */
-	stride = -(int)(N-n+1) * (int)dim;
+tsError ts_int_json_write(struct ts_int_json_writer *writer,
+	const char *str, tsStatus *status)
+{
+	const size_t n = strlen(str);
+	size_t size;
+	char *buf;
+	tsError err;
+
+	if (writer->file) {
+		if (writer->len + n > writer->size)
+			TS_CALL_ROE(err, ts_int_json_flush(writer, status))
+		memcpy(writer->buf + writer->len, str, n);
+		writer->len += n;
+		TS_RETURN_SUCCESS(status)
+	}
+	/* Keep space for the terminating null character. */
+	if (writer->grow && writer->len + n >= writer->size) {
+		size = writer->size ? writer->size : TS_INT_STACK_BUFFER_LEN;
+		while (writer->len + n >= size)
+			size *= 2;
+		buf = (char *) ts_int_realloc(writer->buf, size);
+		if (!buf)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		writer->buf = buf;
+		writer->size = size;
+	}
+	if (writer->len + 1 < writer->size) {
+		size = writer->size - 1 - writer->len;
+		memcpy(writer->buf + writer->len, str, n < size ? n : size);
+	}
+	writer->len += n;
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Formats val with the least number of significant digits that are
+ * required to read val back exactly (with strtod) by trying increasing
+ * precisions.
+ *
+ * If a normalized val can be restored from d <= TS_INT_REAL_DIG digits,
+ * rounding val to TS_INT_REAL_DIG digits yields these d digits followed by
+ * zeros, which %g strips. Hence, starting the search at TS_INT_REAL_DIG
+ * finds the shortest representation of normalized values in at most four
+ * steps. Starting at a lower precision yields the same digits, but %g
+ * switches to exponential notation earlier (e.g., 1.441e+04 instead of
+ * 14410). Subnormal values have fewer significant digits and are searched
+ * from a precision of 1. */
+void ts_int_json_search_real(tsReal val, char *num)
+{
+	tsReal parsed;
+	int prec = TS_INT_REAL_DIG;
+	if (val > -TS_INT_REAL_MIN && val < TS_INT_REAL_MIN)
+		prec = 1;
+	for (; prec <= TS_INT_REAL_DIG + 3; prec++) {
+		sprintf(num, "%.*g", prec, (double) val);
+		parsed = (tsReal) strtod(num, NULL);
+		if (!(parsed < val) && !(parsed > val))
+			break;
+	}
+}
+
+#ifdef TS_INT_JSON_GRISU
+/* The number f * 2^e. */
+struct ts_int_diy_fp {
+	unsigned long f; /**< 64-bit significand. */
+	int e;           /**< Binary exponent. */
+};
+
+/* The power 10^k approximated by f * 2^e. */
+struct ts_int_json_power {
+	unsigned long f; /**< Normalized 64-bit significand (rounded). */
+	int e;           /**< Binary exponent. */
+	int k;           /**< Decimal exponent. */
+};
+
+/* The powers 10^-348, 10^-340, ..., 10^340. */
+const struct ts_int_json_power ts_int_json_powers[] = {
+	{ 0xfa8fd5a0081c0288UL, -1220, -348 },
+	{ 0xbaaee17fa23ebf76UL, -1193, -340 },
+	{ 0x8b16fb203055ac76UL, -1166, -332 },
+	{ 0xcf42894a5dce35eaUL, -1140, -324 },
+	{ 0x9a6bb0aa55653b2dUL, -1113, -316 },
+	{ 0xe61acf033d1a45dfUL, -1087, -308 },
+	{ 0xab70fe17c79ac6caUL, -1060, -300 },
+	{ 0xff77b1fcbebcdc4fUL, -1034, -292 },
+	{ 0xbe5691ef416bd60cUL, -1007, -284 },
+	{ 0x8dd01fad907ffc3cUL,  -980, -276 },
+	{ 0xd3515c2831559a83UL,  -954, -268 },
+	{ 0x9d71ac8fada6c9b5UL,  -927, -260 },
+	{ 0xea9c227723ee8bcbUL,  -901, -252 },
+	{ 0xaecc49914078536dUL,  -874, -244 },
+	{ 0x823c12795db6ce57UL,  -847, -236 },
+	{ 0xc21094364dfb5637UL,  -821, -228 },
+	{ 0x9096ea6f3848984fUL,  -794, -220 },
+	{ 0xd77485cb25823ac7UL,  -768, -212 },
+	{ 0xa086cfcd97bf97f4UL,  -741, -204 },
+	{ 0xef340a98172aace5UL,  -715, -196 },
+	{ 0xb23867fb2a35b28eUL,  -688, -188 },
+	{ 0x84c8d4dfd2c63f3bUL,  -661, -180 },
+	{ 0xc5dd44271ad3cdbaUL,  -635, -172 },
+	{ 0x936b9fcebb25c996UL,  -608, -164 },
+	{ 0xdbac6c247d62a584UL,  -582, -156 },
+	{ 0xa3ab66580d5fdaf6UL,  -555, -148 },
+	{ 0xf3e2f893dec3f126UL,  -529, -140 },
+	{ 0xb5b5ada8aaff80b8UL,  -502, -132 },
+	{ 0x87625f056c7c4a8bUL,  -475, -124 },
+	{ 0xc9bcff6034c13053UL,  -449, -116 },
+	{ 0x964e858c91ba2655UL,  -422, -108 },
+	{ 0xdff9772470297ebdUL,  -396, -100 },
+	{ 0xa6dfbd9fb8e5b88fUL,  -369,  -92 },
+	{ 0xf8a95fcf88747d94UL,  -343,  -84 },
+	{ 0xb94470938fa89bcfUL,  -316,  -76 },
+	{ 0x8a08f0f8bf0f156bUL,  -289,  -68 },
+	{ 0xcdb02555653131b6UL,  -263,  -60 },
+	{ 0x993fe2c6d07b7facUL,  -236,  -52 },
+	{ 0xe45c10c42a2b3b06UL,  -210,  -44 },
+	{ 0xaa242499697392d3UL,  -183,  -36 },
+	{ 0xfd87b5f28300ca0eUL,  -157,  -28 },
+	{ 0xbce5086492111aebUL,  -130,  -20 },
+	{ 0x8cbccc096f5088ccUL,  -103,  -12 },
+	{ 0xd1b71758e219652cUL,   -77,   -4 },
+	{ 0x9c40000000000000UL,   -50,    4 },
+	{ 0xe8d4a51000000000UL,   -24,   12 },
+	{ 0xad78ebc5ac620000UL,     3,   20 },
+	{ 0x813f3978f8940984UL,    30,   28 },
+	{ 0xc097ce7bc90715b3UL,    56,   36 },
+	{ 0x8f7e32ce7bea5c70UL,    83,   44 },
+	{ 0xd5d238a4abe98068UL,   109,   52 },
+	{ 0x9f4f2726179a2245UL,   136,   60 },
+	{ 0xed63a231d4c4fb27UL,   162,   68 },
+	{ 0xb0de65388cc8ada8UL,   189,   76 },
+	{ 0x83c7088e1aab65dbUL,   216,   84 },
+	{ 0xc45d1df942711d9aUL,   242,   92 },
+	{ 0x924d692ca61be758UL,   269,  100 },
+	{ 0xda01ee641a708deaUL,   295,  108 },
+	{ 0xa26da3999aef774aUL,   322,  116 },
+	{ 0xf209787bb47d6b85UL,   348,  124 },
+	{ 0xb454e4a179dd1877UL,   375,  132 },
+	{ 0x865b86925b9bc5c2UL,   402,  140 },
+	{ 0xc83553c5c8965d3dUL,   428,  148 },
+	{ 0x952ab45cfa97a0b3UL,   455,  156 },
+	{ 0xde469fbd99a05fe3UL,   481,  164 },
+	{ 0xa59bc234db398c25UL,   508,  172 },
+	{ 0xf6c69a72a3989f5cUL,   534,  180 },
+	{ 0xb7dcbf5354e9beceUL,   561,  188 },
+	{ 0x88fcf317f22241e2UL,   588,  196 },
+	{ 0xcc20ce9bd35c78a5UL,   614,  204 },
+	{ 0x98165af37b2153dfUL,   641,  212 },
+	{ 0xe2a0b5dc971f303aUL,   667,  220 },
+	{ 0xa8d9d1535ce3b396UL,   694,  228 },
+	{ 0xfb9b7cd9a4a7443cUL,   720,  236 },
+	{ 0xbb764c4ca7a44410UL,   747,  244 },
+	{ 0x8bab8eefb6409c1aUL,   774,  252 },
+	{ 0xd01fef10a657842cUL,   800,  260 },
+	{ 0x9b10a4e5e9913129UL,   827,  268 },
+	{ 0xe7109bfba19c0c9dUL,   853,  276 },
+	{ 0xac2820d9623bf429UL,   880,  284 },
+	{ 0x80444b5e7aa7cf85UL,   907,  292 },
+	{ 0xbf21e44003acdd2dUL,   933,  300 },
+	{ 0x8e679c2f5e44ff8fUL,   960,  308 },
+	{ 0xd433179d9c8cb841UL,   986,  316 },
+	{ 0x9e19db92b4e31ba9UL,  1013,  324 },
+	{ 0xeb96bf6ebadf77d9UL,  1039,  332 },
+	{ 0xaf87023b9bf0ee6bUL,  1066,  340 }
+};
+
+/* Returns the upper 64 bits (rounded) of the 128-bit product of a and b. */
+struct ts_int_diy_fp ts_int_diy_fp_mul(struct ts_int_diy_fp a,
+	struct ts_int_diy_fp b)
+{
+	const unsigned long m32 = 0xFFFFFFFFUL;
+	const unsigned long ah = a.f >> 32, al = a.f & m32;
+	const unsigned long bh = b.f >> 32, bl = b.f & m32;
+	const unsigned long hh = ah * bh, lh = al * bh;
+	const unsigned long hl = ah * bl, ll = al * bl;
+	/* Carry of the lower 64 bits, plus 2^31 to round. */
+	const unsigned long mid = (ll >> 32) + (hl & m32) + (lh & m32) +
+		(1UL << 31);
+	struct ts_int_diy_fp r;
+	r.f = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+	r.e = a.e + b.e + 64;
+	return r;
+}
+
+struct ts_int_diy_fp ts_int_diy_fp_normalize(struct ts_int_diy_fp x)
+{
+	while (!(x.f & (1UL << 63))) {
+		x.f <<= 1;
+		x.e--;
+	}
+	return x;
+}
+
+/* Moves the last digit of the n digits generated by ts_int_json_grisu
+ * towards w (if this is safe). Returns 0 if it cannot be decided whether
+ * the digits are the shortest and closest representation of w. */
+int ts_int_json_round_weed(char *digits, int n, unsigned long dist_high_w,
+	unsigned long unsafe, unsigned long rest, unsigned long ten_kappa,
+	unsigned long unit)
+{
+	const unsigned long small_dist = dist_high_w - unit;
+	const unsigned long big_dist = dist_high_w + unit;
+	while (rest < small_dist && unsafe - rest >= ten_kappa &&
+			(rest + ten_kappa < small_dist ||
+			small_dist - rest >= rest + ten_kappa - small_dist)) {
+		digits[n - 1]--;
+		rest += ten_kappa;
+	}
+	if (rest < big_dist && unsafe - rest >= ten_kappa &&
+			(rest + ten_kappa < big_dist ||
+			big_dist - rest > rest + ten_kappa - big_dist))
+		return 0;
+	return 2 * unit <= rest && rest <= unsafe - 4 * unit;
+}
+
+/* Generates the shortest digits of the positive and normalized val that
+ * are required to read val back exactly (with strtod), using Grisu3 (Florian
+ * Loitsch, 'Printing Floating-Point Numbers Quickly and Accurately with
+ * Integers'). That is, val is the number `digits' (\p n chars) times 10^k.
+ * Grisu3 rejects about 0.5% of all doubles, for which the shortest digits
+ * cannot be proven with 64-bit integers. Returns 0 in this case. */
+int ts_int_json_grisu(tsReal val, char *digits, int *n, int *k)
+{
+	const int shift = 64 - TS_INT_REAL_MANT_DIG;
+	struct ts_int_diy_fp w, low, high, one, ten_mk;
+	const struct ts_int_json_power *power;
+	unsigned long integrals, fractionals, divisor, unsafe, rest, unit;
+	int bexp, dk, kappa;
+
+	/* val = w.f * 2^w.e, with TS_INT_REAL_MANT_DIG bits in w.f. */
+	w.f = (unsigned long) ldexp(frexp((double) val, &bexp),
+		TS_INT_REAL_MANT_DIG);
+	w.e = bexp - TS_INT_REAL_MANT_DIG;
+
+	/* The boundaries of the rounding interval of val. The lower one is
+	 * closer if w.f is a power of two (except for TS_INT_REAL_MIN). */
+	high.f = (w.f << 1) + 1;
+	high.e = w.e - 1;
+	high = ts_int_diy_fp_normalize(high);
+	if (w.f == 1UL << (TS_INT_REAL_MANT_DIG - 1) &&
+			val > TS_INT_REAL_MIN) {
+		low.f = (w.f << 2) - 1;
+		low.e = w.e - 2;
+	} else {
+		low.f = (w.f << 1) - 1;
+		low.e = w.e - 1;
+	}
+	low.f <<= low.e - high.e;
+	low.e = high.e;
+	w.f <<= shift;
+	w.e -= shift;
+
+	/* Scale by 10^-k so that the binary exponent is in [-60, -32]. */
+	dk = (int) ceil((-60 - (w.e + 64) + 63) * 0.30102999566398114);
+	power = &ts_int_json_powers[(348 + dk - 1) / 8 + 1];
+	ten_mk.f = power->f;
+	ten_mk.e = power->e;
+	w = ts_int_diy_fp_mul(w, ten_mk);
+	low = ts_int_diy_fp_mul(low, ten_mk);
+	high = ts_int_diy_fp_mul(high, ten_mk);
+
+	/* Generate the digits of high (widened by the error of the products)
+	 * until the rest is within the widened interval. */
+	unit = 1;
+	low.f -= unit;
+	high.f += unit;
+	unsafe = high.f - low.f;
+	one.f = 1UL << -w.e;
+	one.e = w.e;
+	integrals = high.f >> -one.e;
+	fractionals = high.f & (one.f - 1);
+	for (divisor = 1, kappa = 1; divisor * 10 <= integrals;
+			divisor *= 10)
+		kappa++;
+	*n = 0;
+	while (kappa > 0) {
+		digits[(*n)++] = (char) ('0' + integrals / divisor);
+		integrals %= divisor;
+		kappa--;
+		rest = (integrals << -one.e) + fractionals;
+		if (rest < unsafe) {
+			*k = kappa - power->k;
+			return ts_int_json_round_weed(digits, *n,
+				high.f - w.f, unsafe, rest,
+				divisor << -one.e, unit);
+		}
+		divisor /= 10;
+	}
+	for (;;) {
+		fractionals *= 10;
+		unit *= 10;
+		unsafe *= 10;
+		digits[(*n)++] = (char) ('0' + (fractionals >> -one.e));
+		fractionals &= one.f - 1;
+		kappa--;
+		if (fractionals < unsafe) {
+			*k = kappa - power->k;
+			return ts_int_json_round_weed(digits, *n,
+				(high.f - w.f) * unit, unsafe, fractionals,
+				one.f, unit);
+		}
+	}
+}
+
+/* Formats the n digits times 10^k like %g with a precision of
+ * max(TS_INT_REAL_DIG, n), i.e., like ts_int_json_search_real. */
+void ts_int_json_format_digits(const char *digits, int n, int k, int neg,
+	char *num)
+{
+	const int prec = n > TS_INT_REAL_DIG ? n : TS_INT_REAL_DIG;
+	const int x = n + k - 1; /* Exponent of the first digit. */
+	int i;
+	if (neg)
+		*num++ = '-';
+	if (x < -4 || x >= prec) {
+		*num++ = digits[0];
+		if (n > 1) {
+			*num++ = '.';
+			memcpy(num, digits + 1, n - 1);
+			num += n - 1;
+		}
+		sprintf(num, "e%+03d", x);
+	} else if (x < 0) {
+		*num++ = '0';
+		*num++ = '.';
+		for (i = -1; i > x; i--)
+			*num++ = '0';
+		memcpy(num, digits, n);
+		num[n] = '\0';
+	} else if (n <= x + 1) {
+		memcpy(num, digits, n);
+		for (i = n; i <= x; i++)
+			num[i] = '0';
+		num[x + 1] = '\0';
+	} else {
+		memcpy(num, digits, x + 1);
+		num[x + 1] = '.';
+		memcpy(num + x + 2, digits + x + 1, n - x - 1);
+		num[n + 1] = '\0';
+	}
+}
+#endif
+
+/* Formats val with the least number of significant digits that are
+ * required to read val back exactly (with strtod). */
+tsError ts_int_json_write_real(struct ts_int_json_writer *writer,
+	tsReal val, tsStatus *status)
+{
+	char num[32];
+#ifdef TS_INT_JSON_GRISU
+	char digits[32];
+	int n, k;
+#ifdef TINYSPLINE_FLOAT_PRECISION
+	tsReal parsed;
+#endif
+#endif
+	/* NaN and infinity (val - val is NaN) cannot be represented. */
+	if (!(val - val < 1)) {
+		TS_RETURN_0(status, TS_PARSE_ERROR,
+			"NaN and infinity are not supported by JSON")
+	}
+#ifdef TS_INT_JSON_GRISU
+	/* Zero and subnormal values are rare. */
+	if (!(val > -TS_INT_REAL_MIN && val < TS_INT_REAL_MIN) &&
+			ts_int_json_grisu(val < 0 ? -val : val, digits, &n,
+			&k)) {
+		ts_int_json_format_digits(digits, n, k, val < 0, num);
+#ifdef TINYSPLINE_FLOAT_PRECISION
+		/* strtod rounds num to double before it is rounded to float.
+		 * If num is very close to a boundary of the rounding interval
+		 * of val, the first rounding may hit the boundary. */
+		parsed = (tsReal) strtod(num, NULL);
+		if (parsed < val || parsed > val)
+			ts_int_json_search_real(val, num);
+#endif
+		return ts_int_json_write(writer, num, status);
+	}
+#endif
+	ts_int_json_search_real(val, num);
+	return ts_int_json_write(writer, num, status);
+}
+
+tsError ts_int_json_write_reals(struct ts_int_json_writer *writer,
+	const tsReal *vals, size_t n, tsStatus *status)
+{
+	const char *sep = writer->pretty ? ",\n        " : ",";
+	size_t i;
+	tsError err;
+	TS_CALL_ROE(err, ts_int_json_write(writer,
+		writer->pretty ? "[\n        " : "[", status))
+	for (i = 0; i < n; i++) {
+		if (i > 0)
+			TS_CALL_ROE(err, ts_int_json_write(writer, sep, status))
+		TS_CALL_ROE(err, ts_int_json_write_real(writer, vals[i],
+			status))
+	}
+	return ts_int_json_write(writer, writer->pretty ? "\n    ]" : "]",
+		status);
+}
+
+/* Writes spline with the same layout as parson (if writer->pretty is set),
+ * but without building a JSON_Value tree. */
+tsError ts_int_bspline_write_json(const tsBSpline *spline,
+	struct ts_int_json_writer *writer, tsStatus *status)
+{
+	const int pretty = writer->pretty;
+	char num[32];
+	tsError err;
+
+	TS_CALL_ROE(err, ts_int_json_write(writer,
+		pretty ? "{\n    \"degree\": " : "{\"degree\":", status))
+	sprintf(num, "%lu", (unsigned long) ts_bspline_degree(spline));
+	TS_CALL_ROE(err, ts_int_json_write(writer, num, status))
+	TS_CALL_ROE(err, ts_int_json_write(writer,
+		pretty ? ",\n    \"dimension\": " : ",\"dimension\":", status))
+	sprintf(num, "%lu", (unsigned long) ts_bspline_dimension(spline));
+	TS_CALL_ROE(err, ts_int_json_write(writer, num, status))
+	TS_CALL_ROE(err, ts_int_json_write(writer, pretty
+		? ",\n    \"control_points\": " : ",\"control_points\":",
+		status))
+	TS_CALL_ROE(err, ts_int_json_write_reals(writer,
+		ts_int_bspline_access_ctrlp(spline),
+		ts_bspline_len_control_points(spline), status))
+	TS_CALL_ROE(err, ts_int_json_write(writer,
+		pretty ? ",\n    \"knots\": " : ",\"knots\":", status))
+	TS_CALL_ROE(err, ts_int_json_write_reals(writer,
+		ts_int_bspline_access_knots(spline),
+		ts_bspline_num_knots(spline), status))
+	TS_CALL_ROE(err, ts_int_json_write(writer,
+		pretty ? "\n}" : "}", status))
+
+	if (writer->file)
+		return ts_int_json_flush(writer, status);
+	if (writer->size > 0) {
+		writer->buf[writer->len < writer->size
+			? writer->len : writer->size - 1] = '\0';
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_int_bspline_parse_json(const JSON_Value *spline_value,
+	tsBSpline *_spline_, tsStatus *status)
+{
+	size_t deg, dim, len_ctrlp, num_knots;
+	tsReal *ctrlp, *knots;
+
+	JSON_Object *spline_object;
+	JSON_Value *deg_value;
+	JSON_Value *dim_value;
+	JSON_Value *ctrlp_value;
+	JSON_Array *ctrlp_array;
+	JSON_Value *knots_value;
+	JSON_Array *knots_array;
+	JSON_Value *real_value;
+	size_t i;
+	tsError err;
+
+	ts_int_bspline_init(_spline_);
+
+	/* Read spline object. */
+	if (json_value_get_type(spline_value) != JSONObject)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
+	spline_object = json_value_get_object(spline_value);
+	if (!spline_object)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
+
+	/* Read degree. */
+	deg_value = json_object_get_value(spline_object, "degree");
+	if (json_value_get_type(deg_value) != JSONNumber)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "degree is not a number")
+	if (json_value_get_number(deg_value) < -0.01f) {
+		TS_RETURN_1(status, TS_PARSE_ERROR, "degree (%f) < 0",
+			json_value_get_number(deg_value))
+	}
+	deg = (size_t) json_value_get_number(deg_value);
+
+	/* Read dimension. */
+	dim_value = json_object_get_value(spline_object, "dimension");
+	if (json_value_get_type(dim_value) != JSONNumber) {
+		TS_RETURN_0(status, TS_PARSE_ERROR,
+			"dimension is not a number")
+	}
+	if (json_value_get_number(dim_value) < 0.99f) {
+		TS_RETURN_1(status, TS_PARSE_ERROR, "dimension (%f) < 1",
+			json_value_get_number(deg_value))
+	}
+	dim = (size_t) json_value_get_number(dim_value);
+
+	/* Read length of control point vector. */
+	ctrlp_value = json_object_get_value(spline_object, "control_points");
+	if (json_value_get_type(ctrlp_value) != JSONArray) {
+		TS_RETURN_0(status, TS_PARSE_ERROR,
+			"control_points is not an array")
+	}
+	ctrlp_array = json_value_get_array(ctrlp_value);
+	len_ctrlp = json_array_get_count(ctrlp_array);
+	if (len_ctrlp % dim != 0) {
+		TS_RETURN_2(status, TS_PARSE_ERROR,
+			"len(control_points) (%lu) %% dimension (%lu) != 0",
+			(unsigned long) len_ctrlp, (unsigned long) dim)
+	}
+
+	/* Read number of knots. */
+	knots_value = json_object_get_value(spline_object, "knots");
+	if (json_value_get_type(knots_value) != JSONArray) {
+		TS_RETURN_0(status, TS_PARSE_ERROR,
+			"knots is not an array")
+	}
+	knots_array = json_value_get_array(knots_value);
+	num_knots = json_array_get_count(knots_array);
+
+	/* Create spline. */
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_new(len_ctrlp/dim,
+				dim, deg, TS_CLAMPED, _spline_, status))
+		if (num_knots != ts_bspline_num_knots(_spline_))
+			TS_THROW_2(try, err, status, TS_NUM_KNOTS,
+				"unexpected num(knots): (%lu) != (%lu)",
+				(unsigned long) num_knots,
+				(unsigned long) ts_bspline_num_knots(_spline_))
+
+		/* Set control points. */
+		ctrlp = ts_int_bspline_access_ctrlp(_spline_);
+		for (i = 0; i < len_ctrlp; i++) {
+			real_value = json_array_get_value(ctrlp_array, i);
+			if (json_value_get_type(real_value) != JSONNumber)
+				TS_THROW_1(try, err, status, TS_PARSE_ERROR,
+					"control_points: value at index %lu is not a number",
+					(unsigned long) i)
+			ctrlp[i] = (tsReal) json_value_get_number(real_value);
+		}
+		TS_CALL(try, err, ts_bspline_set_control_points(
+			_spline_, ctrlp, status))
+
+		/* Set knots. */
+		knots = ts_int_bspline_access_knots(_spline_);
+		for (i = 0; i < num_knots; i++) {
+			real_value = json_array_get_value(knots_array, i);
+			if (json_value_get_type(real_value) != JSONNumber)
+			TS_THROW_1(try, err, status, TS_PARSE_ERROR,
+				"knots: value at index %lu is not a number",
+				(unsigned long) i)
+			knots[i] = (tsReal) json_value_get_number(real_value);
+		}
+		TS_CALL(try, err, ts_bspline_set_knots(
+			_spline_, knots, status))
+	TS_CATCH(err)
+		ts_bspline_free(_spline_);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError TS_INT_STATS_IMPL(ts_bspline_to_json)(const tsBSpline *spline,
+	char **json, tsStatus *status)
+{
+	struct ts_int_json_writer writer;
+	tsError err;
+	ts_int_json_writer_init(&writer, NULL, NULL, 0, 1);
+	writer.grow = 1;
+	*json = NULL;
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_int_bspline_write_json(
+			spline, &writer, status))
+		*json = writer.buf;
+	TS_CATCH(err)
+		ts_int_free(writer.buf);
+	TS_END_TRY_RETURN(err)
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_to_json(const tsBSpline *spline, char **json,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(JSON_WRITE, "ts_bspline_to_json",
+		TS_INT_STATS_IMPL(ts_bspline_to_json)(spline, json, status))
+}
+#endif
 
-	for (i = 0; i < n; i++) {                                      /* c) */
-		memcpy(to, from, sof_ctrlp);
-		from += stride;
-		stride -= (int)dim;
-		to += dim;
-	}
-	/* copy knots */
-	to = knots_result + k+1;
-	for (i = 0; i < n; i++) {                                      /* d) */
-		*to = knot;
-		to++;
-	}
+tsError TS_INT_STATS_IMPL(ts_bspline_write_json)(const tsBSpline *spline,
+	FILE *file, int pretty, tsStatus *status)
+{
+	struct ts_int_json_writer writer;
+	ts_int_json_writer_init(&writer, file, NULL, 0, pretty);
+	return ts_int_bspline_write_json(spline, &writer, status);
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_write_json(const tsBSpline *spline, FILE *file,
+	int pretty, tsStatus *status)
+{
+	TS_INT_STATS_CALL(JSON_WRITE, "ts_bspline_write_json",
+		TS_INT_STATS_IMPL(ts_bspline_write_json)(spline, file, pretty,
+			status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_write_json_buffer)(const tsBSpline *spline,
+	char *buf, size_t size, int pretty, size_t *len, tsStatus *status)
+{
+	struct ts_int_json_writer writer;
+	tsError err;
+	ts_int_json_writer_init(&writer, NULL, buf, size, pretty);
+	TS_CALL_ROE(err, ts_int_bspline_write_json(spline, &writer, status))
+	*len = writer.len;
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_insert_knot(const tsBSpline *spline, tsReal u, size_t num,
-	tsBSpline *result, size_t* k, tsStatus *status)
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_write_json_buffer(const tsBSpline *spline, char *buf,
+	size_t size, int pretty, size_t *len, tsStatus *status)
+{
+	TS_INT_STATS_CALL(JSON_WRITE, "ts_bspline_write_json_buffer",
+		TS_INT_STATS_IMPL(ts_bspline_write_json_buffer)(spline, buf,
+			size, pretty, len, status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_parse_json)(const char *json,
+	tsBSpline *spline, tsStatus *status)
 {
-	tsDeBoorNet net;
 	tsError err;
-	INIT_OUT_BSPLINE(spline, result)
-	ts_int_deboornet_init(&net);
+	JSON_Value *value = NULL;
+	ts_int_bspline_init(spline);
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
-		TS_CALL(try, err, ts_int_bspline_insert_knot(
-			spline, &net, num, result, status))
-		ts_deboornet_free(&net);
-		TS_CALL(try, err, ts_bspline_eval(result, u, &net, status))
-		*k = ts_deboornet_index(&net);
-	TS_CATCH(err)
-		*k = 0;
+		value = json_parse_string(json);
+		if (!value) {
+			TS_RETURN_0(status, TS_PARSE_ERROR,
+				"invalid json input")
+		}
+		TS_CALL(try, err, ts_int_bspline_parse_json(
+			value, spline, status))
 	TS_FINALLY
-		ts_deboornet_free(&net);
+		if (value)
+			json_value_free(value);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_split(const tsBSpline *spline, tsReal u, tsBSpline *split,
-	size_t* k, tsStatus *status)
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_parse_json(const char *json, tsBSpline *spline,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(JSON_READ, "ts_bspline_parse_json",
+		TS_INT_STATS_IMPL(ts_bspline_parse_json)(json, spline, status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_save)(const tsBSpline *spline,
+	const char *path, tsStatus *status)
 {
-	tsDeBoorNet net;
 	tsError err;
-	INIT_OUT_BSPLINE(spline, split)
-	ts_int_deboornet_init(&net);
+	FILE *file = fopen(path, "w");
+	if (!file)
+		TS_RETURN_0(status, TS_IO_ERROR, "unable to open file")
+	err = ts_bspline_write_json(spline, file, 1, status);
+	if (fclose(file) != 0 && !err)
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	return err;
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_save(const tsBSpline *spline, const char *path,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(JSON_WRITE, "ts_bspline_save",
+		TS_INT_STATS_IMPL(ts_bspline_save)(spline, path, status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_load)(const char *path, tsBSpline *spline,
+	tsStatus *status)
+{
+	tsError err;
+	FILE *file = NULL;
+	JSON_Value *value = NULL;
+	ts_int_bspline_init(spline);
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
-		if (ts_deboornet_multiplicity(&net)
-				== ts_bspline_order(spline)) {
-			TS_CALL(try, err, ts_bspline_copy(
-				spline, split, status))
-			*k = ts_deboornet_index(&net);
-		} else {
-			TS_CALL(try, err, ts_int_bspline_insert_knot(
-				spline, &net,
-				ts_deboornet_num_insertions(&net) + 1, split,
-				status))
-			*k = ts_deboornet_index(&net) +
-				ts_deboornet_num_insertions(&net) + 1;
+		file = fopen(path, "r");
+		if (!file) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unable to open file")
 		}
-	TS_CATCH(err)
-		*k = 0;
+		value = json_parse_file(path);
+		if (!value) {
+			TS_RETURN_0(status, TS_PARSE_ERROR,
+				"invalid json input")
+		}
+		TS_CALL(try, err, ts_int_bspline_parse_json(
+			value, spline, status))
 	TS_FINALLY
-		ts_deboornet_free(&net);
+		if (file)
+			fclose(file);
+		if (value)
+			json_value_free(value);
+	TS_CATCH(err)
+		ts_bspline_free(spline);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_tension(const tsBSpline *spline, tsReal tension,
-	tsBSpline *out, tsStatus *status)
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_load(const char *path, tsBSpline *spline, tsStatus *status)
 {
-	const tsReal s  = 1.f - tension; /**< The straightening factor. */
-	const size_t dim = ts_bspline_dimension(spline);
-	const size_t N = ts_bspline_num_control_points(spline);
-	const tsReal* p0 = ts_int_bspline_access_ctrlp(spline);
-	const tsReal* pn_1 = p0 + (N-1)*dim;
+	TS_INT_STATS_CALL(JSON_READ, "ts_bspline_load",
+		TS_INT_STATS_IMPL(ts_bspline_load)(path, spline, status))
+}
+#endif
 
-	tsReal *ctrlp; /**< Pointer to the control points of \p out. */
-	size_t i, d; /**< Used in for loops. */
-	tsError err;
+/**
+ * The input of the streaming JSON parser: either a string (`str` != NULL) or
+ * a file. `c` is the current character, which has been read from the input
+ * but not yet processed (EOF at the end of the input).
+ */
+struct ts_int_json_reader
+{
+	const char *str; /**< The remaining string. */
+	FILE *file; /**< The file (if `str` is NULL). */
+	int c; /**< The current character. */
+};
 
-	TS_CALL_ROE(err, ts_bspline_copy(spline, out, status))
-	ctrlp = ts_int_bspline_access_ctrlp(out);
+void ts_int_json_next(struct ts_int_json_reader *reader)
+{
+	if (reader->str)
+		reader->c = *reader->str ? (unsigned char) *reader->str++ : EOF;
+	else
+		reader->c = fgetc(reader->file);
+}
 
-	for (i = 0; i < N; i++) {
-		for (d = 0; d < dim; d++) {
-			ctrlp[i*dim + d] *= tension;
-			ctrlp[i*dim + d] += s * (p0[d] + ((tsReal)i / (N-1)) *
-				(pn_1[d] - p0[d]));
+void ts_int_json_skip_ws(struct ts_int_json_reader *reader)
+{
+	while (reader->c == ' ' || reader->c == '\t' || reader->c == '\n' ||
+			reader->c == '\r')
+		ts_int_json_next(reader);
+}
+
+tsError ts_int_json_expect(struct ts_int_json_reader *reader, int c,
+	tsStatus *status)
+{
+	ts_int_json_skip_ws(reader);
+	if (reader->c != c) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"invalid json input: expected '%c'", (char) c)
+	}
+	ts_int_json_next(reader);
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Reads a string (the opening quote being the current character) and stores
+ * up to \p len - 1 characters of it in \p buf (which is null-terminated).
+ * Escape sequences are not decoded, which is sufficient for the keys of a
+ * spline.
+ */
+tsError ts_int_json_read_string(struct ts_int_json_reader *reader, char *buf,
+	size_t len, tsStatus *status)
+{
+	size_t i = 0;
+	if (reader->c != '"')
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
+	ts_int_json_next(reader);
+	while (reader->c != '"') {
+		if (reader->c == EOF || reader->c == '\n') {
+			TS_RETURN_0(status, TS_PARSE_ERROR,
+				"invalid json input: unterminated string")
+		}
+		if (reader->c == '\\') {
+			ts_int_json_next(reader);
+			if (reader->c == EOF)
+				continue;
 		}
+		if (buf && i + 1 < len)
+			buf[i++] = (char) reader->c;
+		ts_int_json_next(reader);
 	}
+	ts_int_json_next(reader);
+	if (buf)
+		buf[i] = '\0';
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_to_beziers(const tsBSpline *spline, tsBSpline *beziers,
-	tsStatus *status)
+tsError ts_int_json_read_number(struct ts_int_json_reader *reader,
+	double *number, tsStatus *status)
 {
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t order = ts_bspline_order(spline);
+	char buf[64];
+	char *end;
+	size_t i = 0;
+	ts_int_json_skip_ws(reader);
+	while ((reader->c >= '0' && reader->c <= '9') || reader->c == '-' ||
+			reader->c == '+' || reader->c == '.' ||
+			reader->c == 'e' || reader->c == 'E') {
+		if (i + 1 == sizeof(buf)) {
+			TS_RETURN_0(status, TS_PARSE_ERROR,
+				"invalid json input: number too long")
+		}
+		buf[i++] = (char) reader->c;
+		ts_int_json_next(reader);
+	}
+	buf[i] = '\0';
+	*number = strtod(buf, &end);
+	if (i == 0 || *end != '\0') {
+		TS_RETURN_0(status, TS_PARSE_ERROR,
+			"invalid json input: not a number")
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Skips an arbitrary JSON value (e.g., the value of an unknown key).
+ */
+tsError ts_int_json_skip_value(struct ts_int_json_reader *reader,
+	size_t depth, tsStatus *status)
+{
+	double number;
+	int close;
+	tsError err;
+	if (depth > 64) {
+		TS_RETURN_0(status, TS_PARSE_ERROR,
+			"invalid json input: nested too deeply")
+	}
+	ts_int_json_skip_ws(reader);
+	if (reader->c == '"')
+		return ts_int_json_read_string(reader, NULL, 0, status);
+	if (reader->c == '{' || reader->c == '[') {
+		close = reader->c == '{' ? '}' : ']';
+		ts_int_json_next(reader);
+		ts_int_json_skip_ws(reader);
+		if (reader->c == close) {
+			ts_int_json_next(reader);
+			TS_RETURN_SUCCESS(status)
+		}
+		for (;;) {
+			if (close == '}') {
+				ts_int_json_skip_ws(reader);
+				TS_CALL_ROE(err, ts_int_json_read_string(
+					reader, NULL, 0, status))
+				TS_CALL_ROE(err, ts_int_json_expect(
+					reader, ':', status))
+			}
+			TS_CALL_ROE(err, ts_int_json_skip_value(reader,
+				depth + 1, status))
+			ts_int_json_skip_ws(reader);
+			if (reader->c == close)
+				break;
+			TS_CALL_ROE(err, ts_int_json_expect(reader, ',',
+				status))
+		}
+		ts_int_json_next(reader);
+		TS_RETURN_SUCCESS(status)
+	}
+	if (reader->c >= 'a' && reader->c <= 'z') {
+		/* true, false, null */
+		while (reader->c >= 'a' && reader->c <= 'z')
+			ts_int_json_next(reader);
+		TS_RETURN_SUCCESS(status)
+	}
+	return ts_int_json_read_number(reader, &number, status);
+}
 
-	int resize;    /**< Number of control points to add/remove. */
-	size_t k;      /**< Index of the split knot value. */
-	tsReal u_min;  /**< Minimum of the knot values. */
-	tsReal u_max;  /**< Maximum of the knot values. */
+/**
+ * Appends the numbers of the array at the current position of \p reader to
+ * the \p len values of the state of \p spline, which grows as needed.
+ */
+tsError ts_int_json_read_array(struct ts_int_json_reader *reader,
+	tsBSpline *spline, size_t *len, tsStatus *status)
+{
+	double number;
+	size_t cap;
+	tsError err;
+	TS_CALL_ROE(err, ts_int_json_expect(reader, '[', status))
+	ts_int_json_skip_ws(reader);
+	if (reader->c == ']') {
+		ts_int_json_next(reader);
+		TS_RETURN_SUCCESS(status)
+	}
+	for (;;) {
+		TS_CALL_ROE(err, ts_int_json_read_number(reader, &number,
+			status))
+		cap = ts_int_bspline_capacity(spline);
+		if (*len == cap) {
+			TS_CALL_ROE(err, ts_int_bspline_realloc(
+				spline, cap * 2, status))
+		}
+		ts_int_bspline_access_ctrlp(spline)[(*len)++] =
+			(tsReal) number;
+		ts_int_json_skip_ws(reader);
+		if (reader->c == ']')
+			break;
+		TS_CALL_ROE(err, ts_int_json_expect(reader, ',', status))
+	}
+	ts_int_json_next(reader);
+	TS_RETURN_SUCCESS(status)
+}
 
-	tsBSpline tmp;    /**< Temporarily stores the result. */
-	tsReal *knots;    /**< Pointer to the knots of tmp. */
-	size_t num_knots; /**< Number of knots in tmp. */
+/* Reverses the values in [begin, end). */
+void ts_int_reverse(tsReal *begin, tsReal *end)
+{
+	tsReal tmp;
+	while (end - begin > 1) {
+		end--;
+		tmp = *begin;
+		*begin = *end;
+		*end = tmp;
+		begin++;
+	}
+}
 
+/**
+ * Reads a spline object from \p reader without building a DOM. The numbers
+ * of `control_points` and `knots` are read straight into a growing spline
+ * state (cf. struct tsBSplineImpl), which is shrunk to fit eventually.
+ */
+tsError ts_int_bspline_read_json(struct ts_int_json_reader *reader,
+	tsBSpline *spline, tsStatus *status)
+{
+	tsBSpline worker; /**< Stores the values read so far. */
+	struct tsBSplineImpl *impl;
+	size_t len = 0; /**< Number of values read. */
+	size_t len_ctrlp = 0, num_knots = 0;
+	int has_ctrlp = 0, has_knots = 0, knots_first = 0;
+	double deg = -1.0, dim = 0.0;
+	int has_deg = 0, has_dim = 0;
+	char key[32];
+	tsReal *values;
 	tsError err;
 
-	INIT_OUT_BSPLINE(spline, beziers)
-	TS_CALL_ROE(err, ts_bspline_copy(spline, &tmp, status))
-	knots = ts_int_bspline_access_knots(&tmp);
-	num_knots = ts_bspline_num_knots(&tmp);
+	ts_int_bspline_init(spline);
+	TS_CALL_ROE(err, ts_int_bspline_alloc(64, &worker, status))
 
 	TS_TRY(try, err, status)
-		/* DO NOT FORGET TO UPDATE knots AND num_knots AFTER EACH
-		 * TRANSFORMATION OF tmp! */
-
-		/* Fix first control point if necessary. */
-		u_min = knots[deg];
-		if (!ts_knots_equal(knots[0], u_min)) {
-			TS_CALL(try, err, ts_bspline_split(
-				&tmp, u_min, &tmp, &k, status))
-			resize = (int)(-1*deg + (deg*2 - k));
-			TS_CALL(try, err, ts_int_bspline_resize(
-				&tmp, resize, 0, &tmp, status))
-			knots = ts_int_bspline_access_knots(&tmp);
-			num_knots = ts_bspline_num_knots(&tmp);
-		}
-
-		/* Fix last control point if necessary. */
-		u_max = knots[num_knots - order];
-		if (!ts_knots_equal(knots[num_knots - 1], u_max)) {
-			TS_CALL(try, err, ts_bspline_split(
-				&tmp, u_max, &tmp, &k, status))
-			num_knots = ts_bspline_num_knots(&tmp);
-			resize = (int)(-1*deg + (k - (num_knots - order)));
-			TS_CALL(try, err, ts_int_bspline_resize(
-				&tmp, resize, 1, &tmp, status))
-			knots = ts_int_bspline_access_knots(&tmp);
-			num_knots = ts_bspline_num_knots(&tmp);
-		}
-
-		/* Split internal knots. */
-		k = order;
-		while (k < num_knots - order) {
-			TS_CALL(try, err, ts_bspline_split(
-				&tmp, knots[k], &tmp, &k, status))
-			knots = ts_int_bspline_access_knots(&tmp);
-			num_knots = ts_bspline_num_knots(&tmp);
-			k++;
-		}
-
-		if (spline == beziers)
-			ts_bspline_free(beziers);
-		ts_bspline_move(&tmp, beziers);
-	TS_FINALLY
-		ts_bspline_free(&tmp);
+		TS_CALL(try, err, ts_int_json_expect(reader, '{', status))
+		ts_int_json_skip_ws(reader);
+		while (reader->c != '}') {
+			TS_CALL(try, err, ts_int_json_read_string(reader, key,
+				sizeof(key), status))
+			TS_CALL(try, err, ts_int_json_expect(reader, ':',
+				status))
+			if (!strcmp(key, "degree")) {
+				TS_CALL(try, err, ts_int_json_read_number(
+					reader, &deg, status))
+				has_deg = 1;
+			} else if (!strcmp(key, "dimension")) {
+				TS_CALL(try, err, ts_int_json_read_number(
+					reader, &dim, status))
+				has_dim = 1;
+			} else if (!strcmp(key, "control_points") &&
+					!has_ctrlp) {
+				knots_first = has_knots;
+				TS_CALL(try, err, ts_int_json_read_array(
+					reader, &worker, &len, status))
+				len_ctrlp = len - num_knots;
+				has_ctrlp = 1;
+			} else if (!strcmp(key, "knots") && !has_knots) {
+				TS_CALL(try, err, ts_int_json_read_array(
+					reader, &worker, &len, status))
+				num_knots = len - len_ctrlp;
+				has_knots = 1;
+			} else {
+				TS_CALL(try, err, ts_int_json_skip_value(
+					reader, 0, status))
+			}
+			ts_int_json_skip_ws(reader);
+			if (reader->c == ',') {
+				ts_int_json_next(reader);
+				ts_int_json_skip_ws(reader);
+			} else if (reader->c != '}') {
+				TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+					"invalid json input: expected '}'")
+			}
+		}
+		/* The closing brace is not processed (the current character)
+		 * so that no input following the object is read. */
+
+		/* Validate input. */
+		if (!has_deg)
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"degree is not a number")
+		if (deg < -0.01f)
+			TS_THROW_1(try, err, status, TS_PARSE_ERROR,
+				"degree (%f) < 0", deg)
+		if (!has_dim)
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"dimension is not a number")
+		if (dim < 0.99f)
+			TS_THROW_1(try, err, status, TS_PARSE_ERROR,
+				"dimension (%f) < 1", dim)
+		if (!has_ctrlp)
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"control_points is not an array")
+		if (!has_knots)
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"knots is not an array")
+		if (deg > (double) len || dim > (double) len) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"degree or dimension out of range")
+		}
+		impl = worker.pImpl;
+		impl->deg = (size_t) deg;
+		impl->dim = (size_t) dim;
+		if (len_ctrlp % impl->dim != 0) {
+			TS_THROW_2(try, err, status, TS_PARSE_ERROR,
+				"len(control_points) (%lu) %% dimension "
+				"(%lu) != 0", (unsigned long) len_ctrlp,
+				(unsigned long) impl->dim)
+		}
+		impl->n_ctrlp = len_ctrlp / impl->dim;
+		impl->n_knots = num_knots;
+		if (impl->deg >= impl->n_ctrlp) {
+			TS_THROW_2(try, err, status, TS_DEG_GE_NCTRLP,
+				"degree (%lu) >= num(control_points) (%lu)",
+				(unsigned long) impl->deg,
+				(unsigned long) impl->n_ctrlp)
+		}
+		if (num_knots != impl->n_ctrlp + impl->deg + 1) {
+			TS_THROW_2(try, err, status, TS_NUM_KNOTS,
+				"unexpected num(knots): (%lu) != (%lu)",
+				(unsigned long) num_knots,
+				(unsigned long) (impl->n_ctrlp + impl->deg + 1))
+		}
+		if (num_knots > TS_MAX_NUM_KNOTS) {
+			TS_THROW_2(try, err, status, TS_NUM_KNOTS,
+				"unsupported number of knots: %lu > %lu",
+				(unsigned long) num_knots,
+				(unsigned long) TS_MAX_NUM_KNOTS)
+		}
+		/* The control points must precede the knots. Rotate the
+		 * values if they were read in reverse order. */
+		values = (tsReal *) &impl[1];
+		if (knots_first) {
+			ts_int_reverse(values, values + num_knots);
+			ts_int_reverse(values + num_knots, values + len);
+			ts_int_reverse(values, values + len);
+		}
+		/* Shrinking is optional. */
+		ts_int_bspline_realloc(&worker, len, NULL);
+		TS_CALL(try, err, ts_int_bspline_check_knots(&worker,
+			ts_int_bspline_access_knots(&worker), status))
+		ts_bspline_move(&worker, spline);
+	TS_CATCH(err)
+		ts_bspline_free(&worker);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_elevate_degree(const tsBSpline *spline, size_t amount,
-	tsReal epsilon, tsBSpline *elevated, tsStatus * status)
+tsError TS_INT_STATS_IMPL(ts_bspline_read_json)(const char *json,
+	tsBSpline *spline, const char **end, tsStatus *status)
 {
-	tsBSpline worker;
-	size_t dim, order;
-	tsReal *ctrlp, *knots;
-	size_t num_beziers, i, a, c, d, offset, idx;
-	tsReal f, f_hat, *first, *last;
+	struct ts_int_json_reader reader;
 	tsError err;
+	reader.str = json;
+	reader.file = NULL;
+	ts_int_json_next(&reader);
+	err = ts_int_bspline_read_json(&reader, spline, status);
+	if (end)
+		*end = reader.str;
+	return err;
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_read_json(const char *json, tsBSpline *spline,
+	const char **end, tsStatus *status)
+{
+	TS_INT_STATS_CALL(JSON_READ, "ts_bspline_read_json",
+		TS_INT_STATS_IMPL(ts_bspline_read_json)(json, spline, end,
+			status))
+}
+#endif
+
+tsError TS_INT_STATS_IMPL(ts_bspline_read_json_file)(FILE *file,
+	tsBSpline *spline, int *eof, tsStatus *status)
+{
+	struct ts_int_json_reader reader;
+	ts_int_bspline_init(spline);
+	reader.str = NULL;
+	reader.file = file;
+	ts_int_json_next(&reader);
+	ts_int_json_skip_ws(&reader);
+	*eof = reader.c == EOF;
+	if (*eof) {
+		if (ferror(file))
+			TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+		TS_RETURN_SUCCESS(status)
+	}
+	return ts_int_bspline_read_json(&reader, spline, status);
+}
+
+#ifdef TINYSPLINE_ENABLE_STATS
+tsError ts_bspline_read_json_file(FILE *file, tsBSpline *spline, int *eof,
+	tsStatus *status)
+{
+	TS_INT_STATS_CALL(JSON_READ, "ts_bspline_read_json_file",
+		TS_INT_STATS_IMPL(ts_bspline_read_json_file)(file, spline, eof,
+			status))
+}
+#endif
+int ts_int_little_endian()
+{
+	const unsigned int one = 1;
+	return *((const unsigned char *) &one) == 1;
+}
+
+void ts_int_binary_write_size(size_t value, unsigned char *bytes)
+{
+	size_t i;
+	for (i = 0; i < 8; i++) {
+		bytes[i] = (unsigned char) (value & 0xFF);
+		value >>= 8;
+	}
+}
+
+/* Returns 0 if the value does not fit into size_t. */
+int ts_int_binary_read_size(const unsigned char *bytes, size_t *value)
+{
+	size_t i = 8;
+	*value = 0;
+	while (i-- > 0) {
+		if (*value > ((size_t) -1) >> 8)
+			return 0;
+		*value = (*value << 8) | bytes[i];
+	}
+	return 1;
+}
 
-	/* Trivial case. */
-	if (amount == 0)
-		return ts_bspline_copy(spline, elevated, status);
+tsReal ts_int_binary_read_real(const unsigned char *bytes, size_t precision,
+	int swap)
+{
+	unsigned char tmp[8];
+	float f;
+	double d;
+	size_t i;
+	for (i = 0; i < precision; i++)
+		tmp[i] = swap ? bytes[precision - 1 - i] : bytes[i];
+	if (precision == sizeof(float)) {
+		memcpy(&f, tmp, sizeof(float));
+		return (tsReal) f;
+	}
+	memcpy(&d, tmp, sizeof(double));
+	return (tsReal) d;
+}
 
-	/* An overview of this algorithm can be found at:
-	 * https://pages.mtu.edu/~shene/COURSES/cs3621/LAB/curve/elevation.html */
-	INIT_OUT_BSPLINE(spline, elevated);
-	worker = ts_bspline_init();
-	TS_TRY(try, err, status)
-		/* Decompose `spline' into a sequence of bezier curves and make
-		 * space for the additional control points and knots that are
-		 * to be inserted. Results are stored in `worker'. */
-		TS_CALL(try, err, ts_bspline_to_beziers(
-			spline, &worker, status));
-		num_beziers = ts_bspline_num_control_points(&worker) /
-			ts_bspline_order(&worker);
-		TS_CALL(try, err, ts_int_bspline_resize(
-			/* Resize by the number of knots to insert. Note that
-			 * this creates too many control points (due to
-			 * increasing degree), which are removed at the end of
-			 * this function. */
-			&worker, (int) ((num_beziers+1) * amount), 1, &worker,
-			status));
-		dim = ts_bspline_dimension(&worker);
-		order = ts_bspline_order(&worker);
-		ctrlp = ts_int_bspline_access_ctrlp(&worker);
-		knots = ts_int_bspline_access_knots(&worker);
-
-		/* Move all but the first bezier curve to their new location in
-		 * the control point array so that the additional control
-		 * points can be inserted without overwriting the others. Note
-		 * that iteration must run backwards. Otherwise, the moved
-		 * values overwrite each other. */
-		for (i = num_beziers - 1; i > 0; i--) {
-			/* `i' can be interpreted as the number of bezier
-			 * curves before the current bezier curve. */
-
-			/* Location of current bezier curve. */
-			offset = i * order * dim;
-			/* Each elevation inserts an additional control point
-			 * into every bezier curve. `i * amount' is the total
-			 * number of control points to be inserted before the
-			 * current bezier curve. */
-			memmove(ctrlp + offset + (i * amount * dim),
-				ctrlp + offset,
-				dim * order * sizeof(tsReal));
-		}
-
-		/* Move all but the first group of knots to their new location
-		 * in the knot vector so that the additional knots can be
-		 * inserted without overwriting the others. Note that iteration
-		 * must run backwards. Otherwise, the moved values overwrite
-		 * each other. */
-		for (i = num_beziers; i > 0; i--) {
-			/* Note that the number of knot groups is one more than
-			 * the number of bezier curves. `i' can be interpreted
-			 * as the number of knot groups before the current
-			 * group. */
-
-			/* Location of current knot group. */
-			offset = i * order;
-			/* Each elevation inserts an additional knot into every
-			 * group of knots. `i * amount' is the total number of
-			 * knots to be inserted before the current knot
-			 * group. */
-			memmove(knots + offset + (i * amount),
-				knots + offset,
-				order * sizeof(tsReal));
-		}
-
-		/* `worker' is now fully set up.
-		 * The following formulas are based on:
-		 * https://pages.mtu.edu/~shene/COURSES/cs3621/NOTES/spline/Bezier/bezier-elev.html */
-		for (a = 0; a < amount; a++) {
-			/* For each bezier curve... */
-			for (i = 0; i < num_beziers; i++) {
-				/* ... 1) Insert and update control points. */
-
-				/* Location of current bezier curve. Each
-				 * elevation (`a') inserts an additional
-				 * control point into every bezier curve and
-				 * increases the degree (`order') by one. The
-				 * location is thus made up of two parts:
-				 *
-				 * i) `i * order', which is the location taking
-				 * into account the increasing order but
-				 * neglecting the control points that are to be
-				 * inserted before the current bezier curve. It
-				 * can be seen as some sort of base location:
-				 * Where would the bezier curve be (with
-				 * respect to the current value of `order') if
-				 * no additional control points had to be
-				 * inserted?
-				 *
-				 * ii) `i * (amount - a)', which is the total
-				 * number of control points to be inserted
-				 * before the current bezier curve
-				 * (`i * amount') taking into account the
-				 * increasing order (`order' and `a' are
-				 * increased equally, thus, `a' compensates for
-				 * the increasing value of `order'). This part
-				 * adds the necessary offset to the base
-				 * location (`i * order'). */
-				offset = (i * order + i * (amount - a)) * dim;
-				/* Duplicate last control point to the new end
-				 * position (next control point). */
-				memmove(ctrlp + offset + ((order) * dim),
-					ctrlp + offset + ((order-1) * dim),
-					dim * sizeof(tsReal));
-				/* All but the outer control points must be
-				 * recalculated (domain: [1, order - 1]). By
-				 * traversing backwards, control points can be
-				 * modified in-place. */
-				for (c = order - 1; c > 0; c--) {
-					/* Location of current control point
-					 * within current bezier curve. */
-					idx = offset + c * dim;
-					f = (tsReal) c / (tsReal) (order);
-					f_hat = 1 - f;
-					for (d = 0; d < dim; d++) {
-						/* For the sake of space, we
-						 * increment idx by d and
-						 * decrement it at the end of
-						 * this loop. */
-						idx += d;
-						ctrlp[idx] =
-							f * ctrlp[idx - dim] +
-							f_hat * ctrlp[idx];
-						/* Reset idx. */
-						idx -= d;
-					}
-				}
+void ts_int_bspline_write_binary_header(const tsBSpline *spline,
+	unsigned char *header)
+{
+	memcpy(header, TS_INT_BINARY_MAGIC, 4);
+	header[4] = TS_INT_BINARY_VERSION;
+	header[5] = (unsigned char) sizeof(tsReal);
+	header[6] = ts_int_little_endian() ? 1 : 2;
+	header[7] = 0;
+	ts_int_binary_write_size(ts_bspline_degree(spline), header + 8);
+	ts_int_binary_write_size(ts_bspline_dimension(spline), header + 16);
+	ts_int_binary_write_size(ts_bspline_num_control_points(spline),
+		header + 24);
+	ts_int_binary_write_size(ts_bspline_num_knots(spline), header + 32);
+}
 
-				/* ...2) Increase the multiplicity of the
-				 * second knot group (maximum of the domain of
-				 * the current bezier curve) by one. Note that
-				 * this loop misses the last knot group (the
-				 * group of the last bezier curve) as there is
-				 * one more knot group than bezier curves to
-				 * process. Thus, the last group must be
-				 * increased separately after this loop. */
-
-				/* Location of current knot group. Each
-				 * elevation (`a') inserts an additional
-				 * knot into the knot vector of every bezier
-				 * curve and increases the degree (`order') by
-				 * one. The location is thus made up of two
-				 * parts:
-				 *
-				 * i) `i * order', which is the location taking
-				 * into account the increasing order but
-				 * neglecting the knots that are to be inserted
-				 * before the current knot group. It can be
-				 * seen as some sort of base location: Where
-				 * would the knot group be (with respect to the
-				 * current value of `order') if no additional
-				 * knots had to be inserted?
-				 *
-				 * ii) `i * (amount - a)', which is the total
-				 * number of knots to be inserted before the
-				 * current knot group (`i * amount') taking
-				 * into account the increasing order (`order'
-				 * and `a' are increased equally, thus, `a'
-				 * compensates for the increasing value of
-				 * `order'). This part adds the necessary
-				 * offset to the base location
-				 * (`i * order'). */
-				offset = i * order + i * (amount - a);
-				/* Duplicate knot. */
-				knots[offset + order] = knots[offset];
-			}
-
-			/* Increase the multiplicity of the very last knot
-			 * group (the second group of the last bezier curve)
-			 * by one. For more details, see knot duplication in
-			 * previous loop. */
-			offset = num_beziers * order +
-				num_beziers * (amount - a);
-			knots[offset + order] = knots[offset];
-
-			/* Elevated by one. */
-			order++;
-		}
-
-		/* Combine bezier curves. */
-		d = 0; /* Number of removed knots/control points. */
-		for (i = 0; i < num_beziers - 1; i++) {
-			/* Is the last control point of bezier curve `i' equal
-			 * to the first control point of bezier curve `i+1'? */
-			last = ctrlp + (
-				i * order /* base location of `i' */
-				- d /* minus the number of removed values */
-				+ (order - 1) /* jump to last control point */
-				) * dim;
-			first = last + dim; /* next control point */
-			if (ts_distance(last, first, dim) <= epsilon) {
-				/* Move control points. */
-				memmove(last, first, (num_beziers - 1 - i) *
-					order * dim * sizeof(tsReal));
-
-				/* Move knots. `last' is the last knot of the
-				 * second knot group of bezier curve `i'.
-				 * `first' is the first knot of the first knot
-				 * group of bezier curve `i+1'. The
-				 * calculations are quite similar to those for
-				 * the control points `last' and `first' (see
-				 * above). */
-				last = knots + i * order - d + (2 * order - 1);
-				first = last + 1;
-				memmove(last, first, (num_beziers - 1 - i) *
-					order * sizeof(tsReal));
-
-				/* Removed one knot/control point. */
-				d++;
-			}
-		}
-
-		/* Repair internal state. */
-		worker.pImpl->deg = order - 1;
-		worker.pImpl->n_knots -= d;
-		worker.pImpl->n_ctrlp = ts_bspline_num_knots(&worker) - order;
-		memmove(ts_int_bspline_access_knots(&worker),
-			knots, ts_bspline_sof_knots(&worker));
-		worker.pImpl = realloc(worker.pImpl,
-			 ts_int_bspline_sof_state(&worker));
-		if (worker.pImpl == NULL) {
-			TS_THROW_0(try, err, status, TS_MALLOC,
-				"out of memory")
-		}
+/**
+ * Reads and validates the header of the binary data \p binary with \p size
+ * bytes. \p swap is set to 1 if the byte order of the real values of
+ * \p binary differs from the byte order of this machine.
+ */
+tsError ts_int_binary_read_header(const unsigned char *binary, size_t size,
+	size_t *deg, size_t *dim, size_t *n_ctrlp, size_t *n_knots,
+	size_t *precision, int *swap, tsStatus *status)
+{
+	size_t avail; /**< Number of real values following the header. */
+	if (size < TS_INT_BINARY_HEADER_LEN)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "binary input too short")
+	if (memcmp(binary, TS_INT_BINARY_MAGIC, 4) != 0)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid binary input")
+	if (binary[4] != TS_INT_BINARY_VERSION) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"unsupported binary version (%d)", (int) binary[4])
+	}
+	*precision = binary[5];
+	if (*precision != sizeof(float) && *precision != sizeof(double)) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"unsupported precision (%d)", (int) binary[5])
+	}
+	if (binary[6] != 1 && binary[6] != 2) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"invalid byte order (%d)", (int) binary[6])
+	}
+	*swap = (binary[6] == 1) != ts_int_little_endian();
+	if (!ts_int_binary_read_size(binary + 8, deg) ||
+		!ts_int_binary_read_size(binary + 16, dim) ||
+		!ts_int_binary_read_size(binary + 24, n_ctrlp) ||
+		!ts_int_binary_read_size(binary + 32, n_knots)) {
+		TS_RETURN_0(status, TS_PARSE_ERROR, "binary input too large")
+	}
+	if (*dim < 1)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	/* Division avoids overflows. */
+	avail = (size - TS_INT_BINARY_HEADER_LEN) / *precision;
+	if (*n_ctrlp > avail / *dim ||
+		*n_knots > avail - *n_ctrlp * *dim) {
+		TS_RETURN_0(status, TS_PARSE_ERROR, "binary input too short")
+	}
+	TS_RETURN_SUCCESS(status)
+}
 
-		/* Move `worker' to output parameter. */
-		if (spline == elevated)
-			ts_bspline_free(elevated);
-		ts_bspline_move(&worker, elevated);
-	TS_FINALLY
-		ts_bspline_free(&worker);
-	TS_END_TRY_RETURN(err)
+tsError ts_bspline_to_binary(const tsBSpline *spline, unsigned char **binary,
+	size_t *size, tsStatus *status)
+{
+	const size_t sof_values = ts_bspline_sof_control_points(spline) +
+		ts_bspline_sof_knots(spline);
+	*size = TS_INT_BINARY_HEADER_LEN + sof_values;
+	*binary = (unsigned char *) ts_int_malloc(*size);
+	if (!*binary) {
+		*size = 0;
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	ts_int_bspline_write_binary_header(spline, *binary);
+	/* The knots follow the control points (single block). */
+	memcpy(*binary + TS_INT_BINARY_HEADER_LEN,
+		ts_int_bspline_access_ctrlp(spline), sof_values);
+	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_align(const tsBSpline *s1, const tsBSpline *s2,
-	tsReal epsilon, tsBSpline *s1_out, tsBSpline *s2_out, tsStatus *status)
+tsError ts_bspline_parse_binary(const unsigned char *binary, size_t size,
+	tsBSpline *spline, tsStatus *status)
 {
-	tsBSpline s1_worker, s2_worker, *smaller, *larger;
-	tsDeBoorNet net; /* the net of `smaller'. */
-	size_t i, missing, remaining;
-	tsReal min, max, shift, nextKnot;
+	size_t deg, dim, n_ctrlp, n_knots, precision, num_values, i;
+	const unsigned char *values = binary + TS_INT_BINARY_HEADER_LEN;
+	tsReal *ctrlp;
+	int swap;
 	tsError err;
 
-	INIT_OUT_BSPLINE(s1, s1_out)
-	INIT_OUT_BSPLINE(s2, s2_out)
-	s1_worker = ts_bspline_init();
-	s2_worker = ts_bspline_init();
-	smaller = larger = NULL;
+	ts_int_bspline_init(spline);
+	TS_CALL_ROE(err, ts_int_binary_read_header(binary, size, &deg, &dim,
+		&n_ctrlp, &n_knots, &precision, &swap, status))
 	TS_TRY(try, err, status)
-		/* Set up `s1_worker' and `s2_worker'. After this
-		 * if-elseif-else-block, `s1_worker' and `s2_worker' have same
-		 * degree. */
-		if (ts_bspline_degree(s1) < ts_bspline_degree(s2)) {
-			TS_CALL(try, err, ts_bspline_elevate_degree(s1,
-				ts_bspline_degree(s2) - ts_bspline_degree(s1),
-				epsilon, &s1_worker, status))
-			TS_CALL(try, err, ts_bspline_copy(
-				s2, &s2_worker, status))
-		} else if (ts_bspline_degree(s2) < ts_bspline_degree(s1)) {
-			TS_CALL(try, err, ts_bspline_elevate_degree(s2,
-				ts_bspline_degree(s1) - ts_bspline_degree(s2),
-				epsilon, &s2_worker, status))
-			TS_CALL(try, err, ts_bspline_copy(
-				s1, &s1_worker, status))
-		} else {
-			TS_CALL(try, err, ts_bspline_copy(
-				s1, &s1_worker, status))
-			TS_CALL(try, err, ts_bspline_copy(
-				s2, &s2_worker, status))
+		TS_CALL(try, err, ts_bspline_new(n_ctrlp, dim, deg,
+			TS_CLAMPED, spline, status))
+		if (n_knots != ts_bspline_num_knots(spline)) {
+			TS_THROW_2(try, err, status, TS_NUM_KNOTS,
+				"unexpected num(knots): (%lu) != (%lu)",
+				(unsigned long) n_knots,
+				(unsigned long) ts_bspline_num_knots(spline))
 		}
-
-		/* Set up `smaller', `larger', and `net'. */
-		if (ts_bspline_num_knots(&s1_worker) <
-				ts_bspline_num_knots(&s2_worker)) {
-			smaller = &s1_worker;
-			larger  = &s2_worker;
+		/* The knots follow the control points (single block). */
+		ctrlp = ts_int_bspline_access_ctrlp(spline);
+		num_values = n_ctrlp * dim + n_knots;
+		if (precision == sizeof(tsReal) && !swap) {
+			memcpy(ctrlp, values, num_values * sizeof(tsReal));
 		} else {
-			smaller = &s2_worker;
-			larger  = &s1_worker;
-		}
-		TS_CALL(try, err, ts_int_deboornet_new(
-			smaller, &net, status))
-
-		/* Insert knots into `smaller' until it has the same number of
-		 * knots (and therefore the same number of control points) as
-		 * `larger'. */
-		ts_bspline_domain(smaller, &min, &max);
-		missing = remaining = ts_bspline_num_knots(larger) -
-			ts_bspline_num_knots(smaller);
-		shift = (tsReal) 0.0;
-		if (missing > 0)
-			shift = ( (tsReal) 1.0 / missing ) * (tsReal) 0.5;
-		for (i = 0; remaining > 0; i++, remaining--) {
-			nextKnot = (max - min) * ((tsReal)i / missing) + min;
-			nextKnot += shift;
-			TS_CALL(try, err, ts_int_bspline_eval_woa(
-				smaller, nextKnot, &net, status))
-			while (!ts_deboornet_num_insertions(&net)) {
-				/* Linear exploration for next knot. */
-				nextKnot += 5 * TS_KNOT_EPSILON;
-				if (nextKnot > max) {
-					TS_THROW_0(try, err, status,
-						TS_NO_RESULT,
-						"no more knots for insertion")
-				}
-				TS_CALL(try, err, ts_int_bspline_eval_woa(
-					smaller, nextKnot, &net, status))
+			for (i = 0; i < num_values; i++) {
+				ctrlp[i] = ts_int_binary_read_real(
+					values + i * precision, precision,
+					swap);
 			}
-			TS_CALL(try, err, ts_int_bspline_insert_knot(
-				smaller, &net, 1, smaller, status))
 		}
-
-		if (s1 == s1_out)
-			ts_bspline_free(s1_out);
-		if (s2 == s2_out)
-			ts_bspline_free(s2_out);
-		ts_bspline_move(&s1_worker, s1_out);
-		/* if `s1_out' == `s2_out', `s2_worker' must not be moved
-		 * because otherwise the memory of `s1_worker' is leaked
-		 * (`s2_worker' overrides `s1_worker'). */
-		if (s1_out != s2_out)
-			ts_bspline_move(&s2_worker, s2_out);
-	TS_FINALLY
-		ts_bspline_free(&s1_worker);
-		ts_bspline_free(&s2_worker);
-		ts_deboornet_free(&net);
+		TS_CALL(try, err, ts_bspline_set_knots(spline,
+			ts_int_bspline_access_knots(spline), status))
+	TS_CATCH(err)
+		ts_bspline_free(spline);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_morph(const tsBSpline *start, const tsBSpline *end,
-	tsReal t, tsReal epsilon, tsBSpline *out, tsStatus *status)
+tsError ts_bspline_save_binary(const tsBSpline *spline, const char *path,
+	tsStatus *status)
 {
-	tsBSpline start_al, end_al; /* aligned start and end */
-	tsReal *start_al_c, *start_al_k; /* control points and knots */
-	tsReal *end_al_c, *end_al_k; /* control points and knots */
-
-	/* Properties of `out'. */
-	size_t deg, dim, num_ctrlp, num_knots;
-	tsReal *ctrlp, *knots;
+	const size_t sof_values = ts_bspline_sof_control_points(spline) +
+		ts_bspline_sof_knots(spline);
+	unsigned char header[TS_INT_BINARY_HEADER_LEN];
+	FILE *file;
+	int failed;
+
+	ts_int_bspline_write_binary_header(spline, header);
+	file = fopen(path, "wb");
+	if (!file)
+		TS_RETURN_0(status, TS_IO_ERROR, "unable to open file")
+	/* Writing the values directly avoids a temporary copy. */
+	failed = fwrite(header, 1, TS_INT_BINARY_HEADER_LEN, file) !=
+			TS_INT_BINARY_HEADER_LEN ||
+		fwrite(ts_int_bspline_access_ctrlp(spline), 1, sof_values,
+			file) != sof_values;
+	if (fclose(file) != 0 || failed)
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	TS_RETURN_SUCCESS(status)
+}
 
-	tsReal t_hat;
-	size_t i, offset, d;
+tsError ts_bspline_load_binary(const char *path, tsBSpline *spline,
+	tsStatus *status)
+{
 	tsError err;
-
-	start_al = ts_bspline_init();
-	end_al = ts_bspline_init();
+	FILE *file = NULL;
+	unsigned char *binary = NULL;
+	long size;
+	ts_int_bspline_init(spline);
 	TS_TRY(try, err, status)
-		/* Limit `t' to domain [0, 1] and set up `t_hat'. */
-		if (t < (tsReal) 0.0)
-			t = (tsReal) 0.0;
-		if (t > (tsReal) 1.0)
-			t = (tsReal) 1.0;
-		t_hat = (tsReal) 1.0 - t;
-
-		/* Set up `start_al' and `end_al'. */
-		/* Degree must be elevated... */
-		if (ts_bspline_degree(start) != ts_bspline_degree(end) ||
-		/* .. or knots (and thus control points) must be inserted. */
-		ts_bspline_num_knots(start) != ts_bspline_num_knots(end)) {
-			TS_CALL(try, err, ts_bspline_align(
-				start, end, epsilon, &start_al, &end_al,
-				status));
-		} else {
-			/* Flat copy. */
-			start_al = *start;
-			end_al = *end;
+		file = fopen(path, "rb");
+		if (!file) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unable to open file")
 		}
-		start_al_c = ts_int_bspline_access_ctrlp(&start_al);
-		start_al_k = ts_int_bspline_access_knots(&start_al);
-		end_al_c = ts_int_bspline_access_ctrlp(&end_al);
-		end_al_k = ts_int_bspline_access_knots(&end_al);
-
-		/* Set up `out'. */
-		deg = ts_bspline_degree(&start_al);
-		num_ctrlp = ts_bspline_num_control_points(&start_al);
-		dim = ts_bspline_dimension(&start_al);
-		if (ts_bspline_dimension(&end_al) < dim)
-			dim = ts_bspline_dimension(&end_al);
-		if (out->pImpl == NULL) {
-			TS_CALL(try, err, ts_bspline_new(num_ctrlp, dim, deg,
-				TS_OPENED /* doesn't matter */, out, status))
+		if (fseek(file, 0, SEEK_END) != 0 ||
+			(size = ftell(file)) < 0 ||
+			fseek(file, 0, SEEK_SET) != 0) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unexpected io error")
 		}
-		num_knots = ts_bspline_num_knots(out);
-		ctrlp = ts_int_bspline_access_ctrlp(out);
-		knots = ts_int_bspline_access_knots(out);
-
-		/* Interpolate control points. */
-		for (i = 0; i < num_ctrlp; i++) {
-			for (d = 0; d < dim; d++) {
-				offset = i * dim + d;
-				ctrlp[offset] = t * end_al_c[offset] +
-					t_hat * start_al_c[offset];
-			}
+		/* Prevent malloc(0). */
+		binary = (unsigned char *) ts_int_malloc((size_t) size + 1);
+		if (!binary) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
 		}
-
-		/* Interpolate knots. */
-		for (i = 0; i < num_knots; i++) {
-			knots[i] = t * end_al_k[i] +
-				t_hat * start_al_k[i];
+		if (fread(binary, 1, (size_t) size, file) != (size_t) size) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unexpected io error")
 		}
+		TS_CALL(try, err, ts_bspline_parse_binary(binary,
+			(size_t) size, spline, status))
 	TS_FINALLY
-		if (start->pImpl != start_al.pImpl)
-			ts_bspline_free(&start_al);
-		if (end->pImpl != end_al.pImpl)
-			ts_bspline_free(&end_al);
+		if (file)
+			fclose(file);
+		ts_int_free(binary);
 	TS_END_TRY_RETURN(err)
 }
 
 
+tsError ts_bspline_view_binary(const unsigned char *binary, size_t size,
+	tsBSplineView *view, tsStatus *status)
+{
+	size_t deg, dim, n_ctrlp, n_knots, precision;
+	int swap;
+	tsError err;
+
+	view->spline.pImpl = NULL;
+	TS_CALL_ROE(err, ts_int_binary_read_header(binary, size, &deg, &dim,
+		&n_ctrlp, &n_knots, &precision, &swap, status))
+	/* The integers of the header (little endian, 8 bytes each) are
+	 * located right before the control points. If they match the memory
+	 * layout of struct tsBSplineImpl, the header can be used as is. */
+	if (sizeof(size_t) != 8 ||
+		sizeof(struct tsBSplineImpl) != 4 * sizeof(size_t) ||
+		!ts_int_little_endian() || precision != sizeof(tsReal) ||
+		swap) {
+		TS_RETURN_0(status, TS_INCOMPATIBLE,
+			"binary data does not match the memory layout")
+	}
+	if ((size_t) binary % sizeof(size_t) != 0) {
+		TS_RETURN_0(status, TS_INCOMPATIBLE,
+			"binary data is not properly aligned")
+	}
+	if (deg >= n_ctrlp) {
+		TS_RETURN_2(status, TS_DEG_GE_NCTRLP,
+			"degree (%lu) >= num(control_points) (%lu)",
+			(unsigned long) deg, (unsigned long) n_ctrlp)
+	}
+	if (n_knots != n_ctrlp + deg + 1) {
+		TS_RETURN_2(status, TS_NUM_KNOTS,
+			"unexpected num(knots): (%lu) != (%lu)",
+			(unsigned long) n_knots,
+			(unsigned long) (n_ctrlp + deg + 1))
+	}
+	view->spline.pImpl = (struct tsBSplineImpl *) (binary + 8);
+	err = ts_int_bspline_check_knots(&view->spline,
+		ts_int_bspline_access_knots(&view->spline), status);
+	if (err)
+		view->spline.pImpl = NULL;
+	return err;
+}
+
+const tsBSpline *ts_bspline_view_spline(const tsBSplineView *view)
+{
+	return &view->spline;
+}
+
 
 /******************************************************************************
 *                                                                             *
-* :: Serialization and Persistence Functions                                  *
+* :: Archive Functions                                                        *
 *                                                                             *
 ******************************************************************************/
-tsError ts_int_bspline_to_json(const tsBSpline * spline, JSON_Value **value,
-	tsStatus *status)
+void ts_int_archive_init(tsArchive *_archive_)
 {
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t dim = ts_bspline_dimension(spline);
-	const size_t len_ctrlp = ts_bspline_len_control_points(spline);
-	const size_t len_knots = ts_bspline_num_knots(spline);
-	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
-	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	_archive_->pImpl = NULL;
+}
+
+tsArchive ts_archive_init()
+{
+	tsArchive archive;
+	ts_int_archive_init(&archive);
+	return archive;
+}
+
+tsError ts_int_archive_seek(FILE *file, size_t offset, tsStatus *status)
+{
+	/* fseek is limited to long. */
+	if (offset > (size_t) LONG_MAX)
+		TS_RETURN_0(status, TS_IO_ERROR, "archive too large")
+	if (fseek(file, (long) offset, SEEK_SET) != 0)
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	TS_RETURN_SUCCESS(status)
+}
 
-	size_t i; /**< Used in loops */
+tsError ts_int_archive_write(FILE *file, size_t offset, const void *data,
+	size_t size, tsStatus *status)
+{
 	tsError err;
+	TS_CALL_ROE(err, ts_int_archive_seek(file, offset, status))
+	if (fwrite(data, 1, size, file) != size)
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	TS_RETURN_SUCCESS(status)
+}
 
-	JSON_Value  *ctrlp_value;
-	JSON_Value  *knots_value;
-	JSON_Object *spline_object;
-	JSON_Array  *ctrlp_array;
-	JSON_Array  *knots_array;
-
-	*value = ctrlp_value = knots_value = NULL;
-	TS_TRY(values, err, status)
-		/* Init memory. */
-		*value = json_value_init_object();
-		if (!*value) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
-		ctrlp_value = json_value_init_array();
-		if (!ctrlp_value) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
-		knots_value = json_value_init_array();
-		if (!knots_value) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
+tsError ts_int_archive_read(FILE *file, size_t offset, void *data,
+	size_t size, tsStatus *status)
+{
+	tsError err;
+	TS_CALL_ROE(err, ts_int_archive_seek(file, offset, status))
+	if (fread(data, 1, size, file) != size)
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	TS_RETURN_SUCCESS(status)
+}
 
-		/* Although the following functions cannot fail, that is, they
-		 * won't return NULL or JSONFailure, we nevertheless handle
-		 * unexpected return values. */
+/**
+ * Validates the \p header of an archive with \p size bytes and stores the
+ * file offset of the index in \p index_offset (0 if the archive has no
+ * index yet).
+ */
+tsError ts_int_archive_read_header(const unsigned char *header, size_t size,
+	size_t *index_offset, tsStatus *status)
+{
+	if (size < TS_INT_ARCHIVE_HEADER_LEN)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "archive too short")
+	if (memcmp(header, TS_INT_ARCHIVE_MAGIC, 4) != 0)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid archive")
+	if (header[4] != TS_INT_ARCHIVE_VERSION) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"unsupported archive version (%d)", (int) header[4])
+	}
+	if (!ts_int_binary_read_size(header + 8, index_offset))
+		TS_RETURN_0(status, TS_PARSE_ERROR, "archive too large")
+	if (*index_offset != 0 && (*index_offset < TS_INT_ARCHIVE_HEADER_LEN
+			|| *index_offset > size - 8)) {
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid index offset")
+	}
+	TS_RETURN_SUCCESS(status)
+}
 
-		/* Init output. */
-		spline_object = json_value_get_object(*value);
-		if (!spline_object) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
+/**
+ * Reads the \p i'th entry of the index \p index (stored on disk) and
+ * validates it with respect to \p index_offset.
+ */
+tsError ts_int_archive_read_entry(const unsigned char *index, size_t i,
+	size_t index_offset, struct tsArchiveEntry *entry, tsStatus *status)
+{
+	const unsigned char *bytes = index + 8 + i * TS_INT_ARCHIVE_ENTRY_LEN;
+	if (!ts_int_binary_read_size(bytes, &entry->id) ||
+		!ts_int_binary_read_size(bytes + 8, &entry->offset) ||
+		!ts_int_binary_read_size(bytes + 16, &entry->size) ||
+		entry->offset < TS_INT_ARCHIVE_HEADER_LEN ||
+		entry->offset > index_offset ||
+		entry->size > index_offset - entry->offset) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"invalid index entry: %lu", (unsigned long) i)
+	}
+	TS_RETURN_SUCCESS(status)
+}
 
-		/* Set degree and dimension. */
-		if (JSONSuccess != json_object_set_number(
-				spline_object, "degree", (double) deg)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
-		if (JSONSuccess != json_object_set_number(
-				spline_object, "dimension", (double) dim)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
+/**
+ * Initializes the new, empty archive file of \p impl.
+ */
+tsError ts_int_archive_create(struct tsArchiveImpl *impl, tsStatus *status)
+{
+	unsigned char header[TS_INT_ARCHIVE_HEADER_LEN];
+	tsError err;
+	memset(header, 0, TS_INT_ARCHIVE_HEADER_LEN);
+	memcpy(header, TS_INT_ARCHIVE_MAGIC, 4);
+	header[4] = TS_INT_ARCHIVE_VERSION;
+	TS_CALL_ROE(err, ts_int_archive_write(impl->file, 0, header,
+		TS_INT_ARCHIVE_HEADER_LEN, status))
+	impl->end = TS_INT_ARCHIVE_HEADER_LEN;
+	TS_RETURN_SUCCESS(status)
+}
+
+/**
+ * Reads the header and the index of the archive file of \p impl.
+ */
+tsError ts_int_archive_read_index(struct tsArchiveImpl *impl,
+	tsStatus *status)
+{
+	unsigned char header[TS_INT_ARCHIVE_HEADER_LEN];
+	unsigned char *index = NULL;
+	size_t index_offset, file_size, n_entries, i;
+	long tell;
+	tsError err;
+
+	if (fseek(impl->file, 0, SEEK_END) != 0 ||
+		(tell = ftell(impl->file)) < 0) {
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	}
+	file_size = (size_t) tell;
+	if (file_size < TS_INT_ARCHIVE_HEADER_LEN)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "archive too short")
+	TS_CALL_ROE(err, ts_int_archive_read(impl->file, 0, header,
+		TS_INT_ARCHIVE_HEADER_LEN, status))
+	TS_CALL_ROE(err, ts_int_archive_read_header(header, file_size,
+		&index_offset, status))
+	/* New splines are appended to the end of the file (keeping the
+	 * current index valid until a new one is written). */
+	impl->end = (file_size + 7) / 8 * 8;
+	if (index_offset == 0)
+		TS_RETURN_SUCCESS(status)
 
-		/* Set control points. */
-		if (JSONSuccess != json_object_set_value(spline_object,
-				"control_points", ctrlp_value)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
-		ctrlp_array = json_array(ctrlp_value);
-		if (!ctrlp_array) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
+	TS_CALL_ROE(err, ts_int_archive_read(impl->file, index_offset,
+		header, 8, status))
+	if (!ts_int_binary_read_size(header, &n_entries) ||
+		n_entries > (file_size - index_offset - 8) /
+			TS_INT_ARCHIVE_ENTRY_LEN) {
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid index")
+	}
+	index = (unsigned char *) ts_int_malloc(8 +
+		n_entries * TS_INT_ARCHIVE_ENTRY_LEN);
+	if (!index)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	TS_TRY(try, err, status)
+		impl->cap = n_entries < 16 ? 16 : n_entries;
+		impl->entries = (struct tsArchiveEntry *) ts_int_malloc(
+			impl->cap * sizeof(struct tsArchiveEntry));
+		if (!impl->entries) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
 				"out of memory")
 		}
-		for (i = 0; i < len_ctrlp; i++) {
-			if (JSONSuccess != json_array_append_number(
-					ctrlp_array, (double) ctrlp[i])) {
-				TS_THROW_0(values, err, status, TS_MALLOC,
-					"out of memory")
+		TS_CALL(try, err, ts_int_archive_read(impl->file,
+			index_offset, index,
+			8 + n_entries * TS_INT_ARCHIVE_ENTRY_LEN, status))
+		for (i = 0; i < n_entries; i++) {
+			TS_CALL(try, err, ts_int_archive_read_entry(index, i,
+				index_offset, impl->entries + i, status))
+			if (i > 0 && impl->entries[i - 1].id >=
+					impl->entries[i].id) {
+				TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+					"index is not sorted")
 			}
+			impl->n_entries++;
 		}
+	TS_FINALLY
+		ts_int_free(index);
+	TS_END_TRY_RETURN(err)
+}
 
-		/* Set knots. */
-		if (JSONSuccess != json_object_set_value(
-				spline_object, "knots", knots_value)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
-		knots_array = json_array(knots_value);
-		if (!knots_array) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
-		}
-		for (i = 0; i < len_knots; i++) {
-			if (JSONSuccess != json_array_append_number(
-					knots_array, (double) knots[i])) {
-				TS_THROW_0(values, err, status, TS_MALLOC,
-					"out of memory")
+tsError ts_archive_open(const char *path, tsArchive *archive,
+	tsStatus *status)
+{
+	struct tsArchiveImpl *impl;
+	tsError err;
+
+	ts_int_archive_init(archive);
+	impl = (struct tsArchiveImpl *) ts_int_malloc(
+		sizeof(struct tsArchiveImpl));
+	if (!impl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memset(impl, 0, sizeof(struct tsArchiveImpl));
+	impl->sorted = 1;
+	archive->pImpl = impl;
+
+	TS_TRY(try, err, status)
+		/* Read-only archives can be opened, but not appended. */
+		impl->file = fopen(path, "r+b");
+		if (!impl->file)
+			impl->file = fopen(path, "rb");
+		if (impl->file) {
+			TS_CALL(try, err, ts_int_archive_read_index(impl,
+				status))
+		} else {
+			impl->file = fopen(path, "w+b");
+			if (!impl->file) {
+				TS_THROW_0(try, err, status, TS_IO_ERROR,
+					"unable to open file")
 			}
+			TS_CALL(try, err, ts_int_archive_create(impl, status))
 		}
 	TS_CATCH(err)
-		if (*value)
-			json_value_free(*value);
-		if (ctrlp_value && !json_value_get_parent(ctrlp_value))
-			json_value_free(ctrlp_value);
-		if (knots_value && !json_value_get_parent(knots_value))
-			json_value_free(knots_value);
-		*value = NULL;
+		ts_archive_free(archive);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_int_bspline_parse_json(const JSON_Value *spline_value,
-	tsBSpline *_spline_, tsStatus *status)
+size_t ts_archive_num_splines(const tsArchive *archive)
 {
-	size_t deg, dim, len_ctrlp, num_knots;
-	tsReal *ctrlp, *knots;
-
-	JSON_Object *spline_object;
-	JSON_Value *deg_value;
-	JSON_Value *dim_value;
-	JSON_Value *ctrlp_value;
-	JSON_Array *ctrlp_array;
-	JSON_Value *knots_value;
-	JSON_Array *knots_array;
-	JSON_Value *real_value;
-	size_t i;
-	tsError err;
-
-	ts_int_bspline_init(_spline_);
-
-	/* Read spline object. */
-	if (json_value_get_type(spline_value) != JSONObject)
-		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
-	spline_object = json_value_get_object(spline_value);
-	if (!spline_object)
-		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
+	return archive->pImpl->n_entries;
+}
 
-	/* Read degree. */
-	deg_value = json_object_get_value(spline_object, "degree");
-	if (json_value_get_type(deg_value) != JSONNumber)
-		TS_RETURN_0(status, TS_PARSE_ERROR, "degree is not a number")
-	if (json_value_get_number(deg_value) < -0.01f) {
-		TS_RETURN_1(status, TS_PARSE_ERROR, "degree (%f) < 0",
-			json_value_get_number(deg_value))
-	}
-	deg = (size_t) json_value_get_number(deg_value);
+int ts_int_archive_entry_cmp(const void *x, const void *y)
+{
+	const struct tsArchiveEntry *a = (const struct tsArchiveEntry *) x;
+	const struct tsArchiveEntry *b = (const struct tsArchiveEntry *) y;
+	return a->id < b->id ? -1 : a->id > b->id ? 1 : 0;
+}
 
-	/* Read dimension. */
-	dim_value = json_object_get_value(spline_object, "dimension");
-	if (json_value_get_type(dim_value) != JSONNumber) {
-		TS_RETURN_0(status, TS_PARSE_ERROR,
-			"dimension is not a number")
-	}
-	if (json_value_get_number(dim_value) < 0.99f) {
-		TS_RETURN_1(status, TS_PARSE_ERROR, "dimension (%f) < 1",
-			json_value_get_number(deg_value))
+/**
+ * Sorts the index of \p archive by id (if necessary) and checks for
+ * duplicate ids.
+ */
+tsError ts_int_archive_sort(tsArchive *archive, tsStatus *status)
+{
+	struct tsArchiveImpl *impl = archive->pImpl;
+	size_t i;
+	if (impl->sorted)
+		TS_RETURN_SUCCESS(status)
+	qsort(impl->entries, impl->n_entries, sizeof(struct tsArchiveEntry),
+		ts_int_archive_entry_cmp);
+	for (i = 1; i < impl->n_entries; i++) {
+		if (impl->entries[i - 1].id == impl->entries[i].id) {
+			TS_RETURN_1(status, TS_INDEX_ERROR,
+				"duplicate id: %lu",
+				(unsigned long) impl->entries[i].id)
+		}
 	}
-	dim = (size_t) json_value_get_number(dim_value);
+	impl->sorted = 1;
+	TS_RETURN_SUCCESS(status)
+}
 
-	/* Read length of control point vector. */
-	ctrlp_value = json_object_get_value(spline_object, "control_points");
-	if (json_value_get_type(ctrlp_value) != JSONArray) {
-		TS_RETURN_0(status, TS_PARSE_ERROR,
-			"control_points is not an array")
-	}
-	ctrlp_array = json_value_get_array(ctrlp_value);
-	len_ctrlp = json_array_get_count(ctrlp_array);
-	if (len_ctrlp % dim != 0) {
-		TS_RETURN_2(status, TS_PARSE_ERROR,
-			"len(control_points) (%lu) %% dimension (%lu) != 0",
-			(unsigned long) len_ctrlp, (unsigned long) dim)
-	}
+tsError ts_archive_append(tsArchive *archive, size_t id,
+	const tsBSpline *spline, tsStatus *status)
+{
+	struct tsArchiveImpl *impl = archive->pImpl;
+	struct tsArchiveEntry *entries;
+	const unsigned char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	unsigned char *binary = NULL;
+	size_t size, num_padding, cap;
+	tsError err;
 
-	/* Read number of knots. */
-	knots_value = json_object_get_value(spline_object, "knots");
-	if (json_value_get_type(knots_value) != JSONArray) {
-		TS_RETURN_0(status, TS_PARSE_ERROR,
-			"knots is not an array")
+	if (impl->n_entries == impl->cap) {
+		cap = impl->cap < 16 ? 16 : impl->cap * 2;
+		entries = (struct tsArchiveEntry *) ts_int_realloc(impl->entries,
+			cap * sizeof(struct tsArchiveEntry));
+		if (!entries)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		impl->entries = entries;
+		impl->cap = cap;
 	}
-	knots_array = json_value_get_array(knots_value);
-	num_knots = json_array_get_count(knots_array);
 
-	/* Create spline. */
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_new(len_ctrlp/dim,
-				dim, deg, TS_CLAMPED, _spline_, status))
-		if (num_knots != ts_bspline_num_knots(_spline_))
-			TS_THROW_2(try, err, status, TS_NUM_KNOTS,
-				"unexpected num(knots): (%lu) != (%lu)",
-				(unsigned long) num_knots,
-				(unsigned long) ts_bspline_num_knots(_spline_))
-
-		/* Set control points. */
-		ctrlp = ts_int_bspline_access_ctrlp(_spline_);
-		for (i = 0; i < len_ctrlp; i++) {
-			real_value = json_array_get_value(ctrlp_array, i);
-			if (json_value_get_type(real_value) != JSONNumber)
-				TS_THROW_1(try, err, status, TS_PARSE_ERROR,
-					"control_points: value at index %lu is not a number",
-					(unsigned long) i)
-			ctrlp[i] = (tsReal) json_value_get_number(real_value);
+		TS_CALL(try, err, ts_bspline_to_binary(spline, &binary, &size,
+			status))
+		/* Keep the binary data of each spline aligned to 8 bytes
+		 * (cf. ts_bspline_view_binary). */
+		num_padding = (8 - size % 8) % 8;
+		TS_CALL(try, err, ts_int_archive_write(impl->file, impl->end,
+			binary, size, status))
+		if (fwrite(padding, 1, num_padding, impl->file) !=
+				num_padding) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unexpected io error")
 		}
-		TS_CALL(try, err, ts_bspline_set_control_points(
-			_spline_, ctrlp, status))
+		impl->entries[impl->n_entries].id = id;
+		impl->entries[impl->n_entries].offset = impl->end;
+		impl->entries[impl->n_entries].size = size;
+		if (impl->n_entries > 0 &&
+			impl->entries[impl->n_entries - 1].id >= id)
+			impl->sorted = 0;
+		impl->n_entries++;
+		impl->end += size + num_padding;
+		impl->dirty = 1;
+	TS_FINALLY
+		ts_int_free(binary);
+	TS_END_TRY_RETURN(err)
+}
 
-		/* Set knots. */
-		knots = ts_int_bspline_access_knots(_spline_);
-		for (i = 0; i < num_knots; i++) {
-			real_value = json_array_get_value(knots_array, i);
-			if (json_value_get_type(real_value) != JSONNumber)
-			TS_THROW_1(try, err, status, TS_PARSE_ERROR,
-				"knots: value at index %lu is not a number",
-				(unsigned long) i)
-			knots[i] = (tsReal) json_value_get_number(real_value);
+tsError ts_archive_flush(tsArchive *archive, tsStatus *status)
+{
+	struct tsArchiveImpl *impl = archive->pImpl;
+	const size_t size = 8 + impl->n_entries * TS_INT_ARCHIVE_ENTRY_LEN;
+	unsigned char *index = NULL, *bytes, offset[8];
+	size_t i;
+	tsError err;
+
+	if (!impl->dirty)
+		TS_RETURN_SUCCESS(status)
+	TS_CALL_ROE(err, ts_int_archive_sort(archive, status))
+	index = (unsigned char *) ts_int_malloc(size);
+	if (!index)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	TS_TRY(try, err, status)
+		ts_int_binary_write_size(impl->n_entries, index);
+		for (i = 0; i < impl->n_entries; i++) {
+			bytes = index + 8 + i * TS_INT_ARCHIVE_ENTRY_LEN;
+			ts_int_binary_write_size(impl->entries[i].id, bytes);
+			ts_int_binary_write_size(impl->entries[i].offset,
+				bytes + 8);
+			ts_int_binary_write_size(impl->entries[i].size,
+				bytes + 16);
 		}
-		TS_CALL(try, err, ts_bspline_set_knots(
-			_spline_, knots, status))
-	TS_CATCH(err)
-		ts_bspline_free(_spline_);
+		/* Write the new index behind the splines and, once it is on
+		 * disk, let the header point to it. Until then, the header
+		 * points to the previous (intact) index. */
+		TS_CALL(try, err, ts_int_archive_write(impl->file, impl->end,
+			index, size, status))
+		if (fflush(impl->file) != 0) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unexpected io error")
+		}
+		ts_int_binary_write_size(impl->end, offset);
+		TS_CALL(try, err, ts_int_archive_write(impl->file, 8,
+			offset, 8, status))
+		if (fflush(impl->file) != 0) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unexpected io error")
+		}
+		impl->end += size;
+		impl->dirty = 0;
+	TS_FINALLY
+		ts_int_free(index);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_to_json(const tsBSpline *spline, char **json,
+tsError ts_archive_id_at(tsArchive *archive, size_t index, size_t *id,
 	tsStatus *status)
 {
 	tsError err;
-	JSON_Value *value = NULL;
-	*json = NULL;
-	TS_CALL_ROE(err, ts_int_bspline_to_json(spline, &value, status))
-	*json = json_serialize_to_string_pretty(value);
-	json_value_free(value);
-	if (!*json)
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	TS_CALL_ROE(err, ts_int_archive_sort(archive, status))
+	if (index >= ts_archive_num_splines(archive)) {
+		TS_RETURN_2(status, TS_INDEX_ERROR, "index (%lu) >= num(%lu)",
+			(unsigned long) index,
+			(unsigned long) ts_archive_num_splines(archive))
+	}
+	*id = archive->pImpl->entries[index].id;
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_parse_json(const char *json, tsBSpline *spline,
-	tsStatus *status)
+tsError ts_archive_load_at(tsArchive *archive, size_t index,
+	tsBSpline *spline, tsStatus *status)
 {
+	const struct tsArchiveEntry *entry;
+	unsigned char *binary;
+	size_t id;
 	tsError err;
-	JSON_Value *value = NULL;
+
 	ts_int_bspline_init(spline);
+	TS_CALL_ROE(err, ts_archive_id_at(archive, index, &id, status))
+	entry = archive->pImpl->entries + index;
+	/* Prevent malloc(0). */
+	binary = (unsigned char *) ts_int_malloc(entry->size + 1);
+	if (!binary)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	TS_TRY(try, err, status)
-		value = json_parse_string(json);
-		if (!value) {
-			TS_RETURN_0(status, TS_PARSE_ERROR,
-				"invalid json input")
-		}
-		TS_CALL(try, err, ts_int_bspline_parse_json(
-			value, spline, status))
+		TS_CALL(try, err, ts_int_archive_read(archive->pImpl->file,
+			entry->offset, binary, entry->size, status))
+		TS_CALL(try, err, ts_bspline_parse_binary(binary,
+			entry->size, spline, status))
 	TS_FINALLY
-		if (value)
-			json_value_free(value);
+		ts_int_free(binary);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_save(const tsBSpline *spline, const char *path,
+tsError ts_archive_load(tsArchive *archive, size_t id, tsBSpline *spline,
 	tsStatus *status)
 {
+	const struct tsArchiveEntry *entries;
+	size_t lo = 0, hi, mid;
 	tsError err;
-	JSON_Status json_status;
-	JSON_Value *value = NULL;
-	TS_CALL_ROE(err, ts_int_bspline_to_json(spline, &value, status))
-	json_status = json_serialize_to_file_pretty(value, path);
-	json_value_free(value);
-	if (json_status != JSONSuccess)
-		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
-	TS_RETURN_SUCCESS(status)
+
+	ts_int_bspline_init(spline);
+	TS_CALL_ROE(err, ts_int_archive_sort(archive, status))
+	entries = archive->pImpl->entries;
+	hi = archive->pImpl->n_entries;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (entries[mid].id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == archive->pImpl->n_entries || entries[lo].id != id) {
+		TS_RETURN_1(status, TS_INDEX_ERROR, "unknown id: %lu",
+			(unsigned long) id)
+	}
+	return ts_archive_load_at(archive, lo, spline, status);
 }
 
-tsError ts_bspline_load(const char *path, tsBSpline *spline, tsStatus *status)
+void ts_archive_free(tsArchive *archive)
+{
+	if (archive->pImpl) {
+		ts_archive_flush(archive, NULL);
+		if (archive->pImpl->file)
+			fclose(archive->pImpl->file);
+		ts_int_free(archive->pImpl->entries);
+		ts_int_free(archive->pImpl);
+	}
+	ts_int_archive_init(archive);
+}
+
+tsError ts_archive_view(const unsigned char *data, size_t size, size_t id,
+	tsBSplineView *view, tsStatus *status)
 {
+	struct tsArchiveEntry entry;
+	const unsigned char *index = NULL;
+	size_t index_offset, n_entries, lo = 0, hi, mid;
 	tsError err;
-	FILE *file = NULL;
-	JSON_Value *value = NULL;
-	ts_int_bspline_init(spline);
-	TS_TRY(try, err, status)
-		file = fopen(path, "r");
-		if (!file) {
-			TS_THROW_0(try, err, status, TS_IO_ERROR,
-				"unable to open file")
+
+	view->spline.pImpl = NULL;
+	TS_CALL_ROE(err, ts_int_archive_read_header(data, size,
+		&index_offset, status))
+	n_entries = 0;
+	if (index_offset != 0) {
+		index = data + index_offset;
+		if (!ts_int_binary_read_size(index, &n_entries) ||
+			n_entries > (size - index_offset - 8) /
+				TS_INT_ARCHIVE_ENTRY_LEN) {
+			TS_RETURN_0(status, TS_PARSE_ERROR, "invalid index")
 		}
-		value = json_parse_file(path);
-		if (!value) {
-			TS_RETURN_0(status, TS_PARSE_ERROR,
-				"invalid json input")
+	}
+	/* Binary search on the index stored on disk. */
+	hi = n_entries;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		TS_CALL_ROE(err, ts_int_archive_read_entry(index, mid,
+			index_offset, &entry, status))
+		if (entry.id == id) {
+			return ts_bspline_view_binary(data + entry.offset,
+				entry.size, view, status);
 		}
-		TS_CALL(try, err, ts_int_bspline_parse_json(
-			value, spline, status))
-	TS_FINALLY
-		if (file)
-			fclose(file);
-		if (value)
-			json_value_free(value);
-	TS_CATCH(err)
-		ts_bspline_free(spline);
-	TS_END_TRY_RETURN(err)
+		if (entry.id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	TS_RETURN_1(status, TS_INDEX_ERROR, "unknown id: %lu",
+		(unsigned long) id)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Memory Management Functions                                              *
+*                                                                             *
+******************************************************************************/
+void ts_set_allocator(const tsAllocator *allocator)
+{
+	if (allocator) {
+		ts_int_allocator = *allocator;
+	} else {
+		ts_int_allocator.allocate = ts_int_std_allocate;
+		ts_int_allocator.reallocate = ts_int_std_reallocate;
+		ts_int_allocator.deallocate = ts_int_std_deallocate;
+		ts_int_allocator.data = NULL;
+	}
+	json_set_allocation_functions(ts_int_malloc, ts_int_free);
+}
+
+void ts_get_allocator(tsAllocator *allocator)
+{
+	*allocator = ts_int_allocator;
+}
+
+void ts_free(void *ptr)
+{
+	ts_int_free(ptr);
+}
+
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Statistics Functions                                                     *
+*                                                                             *
+******************************************************************************/
+int ts_stats_enabled()
+{
+#ifdef TINYSPLINE_ENABLE_STATS
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+void ts_stats_snapshot(tsStats *stats)
+{
+#ifdef TINYSPLINE_ENABLE_STATS
+	*stats = ts_int_stats;
+#else
+	memset(stats, 0, sizeof(tsStats));
+#endif
+}
+
+void ts_stats_reset()
+{
+#ifdef TINYSPLINE_ENABLE_STATS
+	memset(&ts_int_stats, 0, sizeof(tsStats));
+#endif
+}
+
+void ts_set_stats_hooks(const tsStatsHooks *hooks)
+{
+#ifdef TINYSPLINE_ENABLE_STATS
+	if (hooks) {
+		ts_int_stats_hooks = *hooks;
+	} else {
+		ts_int_stats_hooks.begin = NULL;
+		ts_int_stats_hooks.end = NULL;
+		ts_int_stats_hooks.clock = NULL;
+		ts_int_stats_hooks.data = NULL;
+	}
+#else
+	(void) hooks;
+#endif
 }
 
 
@@ -4,6 +4,7 @@
 #define TINYSPLINE_H
 
 #include <stddef.h>
+#include <stdio.h>
 
 
 
@@ -65,7 +66,11 @@ extern "C" {
  * and should only be changed with great caution! The values chosen should be
  * suitable for most environments and can be used with float (single) and
  * double precision (see ::tsReal). If changes are necessary, please read the
- * documentation of the constants in advance.
+ * documentation of the constants in advance. ::TS_MAX_NUM_KNOTS and
+ * ::TS_KNOT_EPSILON can be configured by supplying the corresponding
+ * preprocessor definitions (e.g., via the CMake variables
+ * TINYSPLINE_MAX_NUM_KNOTS and TINYSPLINE_KNOT_EPSILON). Note that the
+ * library and the code using it must be compiled with the same values.
  *
  * @{
  */
@@ -79,8 +84,17 @@ extern "C" {
  * ::TS_MAX_NUM_KNOTS and ::TS_KNOT_EPSILON is as follows:
  *
  *     TS_MAX_NUM_KNOTS = 1 / TS_KNOTS_EPSILON
+ *
+ * This constant may be raised, for example, to represent long time series
+ * with millions of knots as single splines. In this case, keep in mind that
+ * ::TS_KNOT_EPSILON (which, unless defined otherwise, follows
+ * ::TS_MAX_NUM_KNOTS) should remain greater than the precision of ::tsReal in
+ * the domain of the splines. That is, large values should be used with double
+ * precision (the default).
  */
+#ifndef TS_MAX_NUM_KNOTS
 #define TS_MAX_NUM_KNOTS 10000
+#endif
 
 /**
  * The minimum of the domain of newly created splines. Must be less than
@@ -104,7 +118,9 @@ extern "C" {
  * ::TS_MAX_NUM_KNOTS has to be. Likewise, the larger ::TS_MAX_NUM_KNOTS is,
  * the less precise ::TS_KNOT_EPSILON has to be (i.e., knots with greater
  * distance are considered equal). By default, the relation between
- * ::TS_KNOT_EPSILON and ::TS_MAX_NUM_KNOTS is as follows:
+ * ::TS_KNOT_EPSILON and ::TS_MAX_NUM_KNOTS is as follows (which is why
+ * ::TS_KNOT_EPSILON is derived from ::TS_MAX_NUM_KNOTS unless defined
+ * otherwise):
  *
  *     TS_KNOT_EPSILON = 1 / TS_MAX_NUM_KNOTS
  *
@@ -115,7 +131,9 @@ extern "C" {
  * ::TS_KNOT_EPSILON. This is in particular recommended when ::TS_KNOT_EPSILON
  * and ::TS_MAX_NUM_KNOTS are related to each other as described above.
  */
-#define TS_KNOT_EPSILON 1e-4f
+#ifndef TS_KNOT_EPSILON
+#define TS_KNOT_EPSILON (1.0f / TS_MAX_NUM_KNOTS)
+#endif
 
 /**
  * If the distance between two (control) points is less than or equal to this
@@ -369,6 +387,16 @@ typedef double tsReal;
  *   - ::TS_RETURN_SUCCESS: Shortcut for ::TS_RETURN_0 with error code
  *     ::TS_SUCCESS and an empty error message.
  *
+ * Error messages are formatted (with sprintf) only if an error occurs and
+ * only if a ::tsStatus object is passed. On success, the macros set
+ * tsStatus#code and clear the first character of tsStatus#message. If the
+ * formatting of error messages is not desired at all (e.g., because errors
+ * are expected frequently in performance critical code and only the error
+ * code is evaluated), define \c TINYSPLINE_NO_MESSAGES (e.g., via the CMake
+ * option of the same name). In this mode, the \c TS_RETURN_<N> and
+ * \c TS_THROW_<N> macros set tsStatus#code only and leave tsStatus#message
+ * empty. Passing NULL instead of a ::tsStatus object skips both.
+ *
  * @{
  */
 /**
@@ -419,7 +447,15 @@ typedef enum
 	TS_NO_RESULT = -14,
 
 	/** Unexpected number of points. */
-	TS_NUM_POINTS = -15
+	TS_NUM_POINTS = -15,
+
+	/** Data does not match (e.g., a spline with different degree or
+	 * knots, or binary data with a foreign memory layout). */
+	TS_INCOMPATIBLE = -16,
+
+	/** No device is available or a device operation failed (cf.
+	 * ::tsGpu). */
+	TS_DEVICE_ERROR = -17
 } tsError;
 
 /**
@@ -438,6 +474,35 @@ typedef struct
 	char message[100];
 } tsStatus;
 
+/**
+ * Stores the formatted error message \p msg in \p status, which must not be
+ * NULL. Used by the \c TS_RETURN_<N> and \c TS_THROW_<N> macros. If
+ * \c TINYSPLINE_NO_MESSAGES is defined, the message is left empty instead.
+ */
+#ifdef TINYSPLINE_NO_MESSAGES
+#define TS_MESSAGE_0(status, msg) \
+	(status)->message[0] = '\0';
+#define TS_MESSAGE_1(status, msg, arg1) \
+	(status)->message[0] = '\0';
+#define TS_MESSAGE_2(status, msg, arg1, arg2) \
+	(status)->message[0] = '\0';
+#define TS_MESSAGE_3(status, msg, arg1, arg2, arg3) \
+	(status)->message[0] = '\0';
+#define TS_MESSAGE_4(status, msg, arg1, arg2, arg3, arg4) \
+	(status)->message[0] = '\0';
+#else
+#define TS_MESSAGE_0(status, msg) \
+	sprintf((status)->message, msg);
+#define TS_MESSAGE_1(status, msg, arg1) \
+	sprintf((status)->message, msg, arg1);
+#define TS_MESSAGE_2(status, msg, arg1, arg2) \
+	sprintf((status)->message, msg, arg1, arg2);
+#define TS_MESSAGE_3(status, msg, arg1, arg2, arg3) \
+	sprintf((status)->message, msg, arg1, arg2, arg3);
+#define TS_MESSAGE_4(status, msg, arg1, arg2, arg3, arg4) \
+	sprintf((status)->message, msg, arg1, arg2, arg3, arg4);
+#endif
+
 #define TS_TRY(label, error, status)         \
 {                                            \
 	(error) = TS_SUCCESS;                \
@@ -487,7 +552,7 @@ typedef struct
 {                                                \
 	if ((status) != NULL) {                  \
 		(status)->code = error;          \
-		sprintf((status)->message, msg); \
+		TS_MESSAGE_0(status, msg)        \
 	}                                        \
 	return error;                            \
 }
@@ -496,7 +561,7 @@ typedef struct
 {                                                      \
 	if ((status) != NULL) {                        \
 		(status)->code = error;                \
-		sprintf((status)->message, msg, arg1); \
+		TS_MESSAGE_1(status, msg, arg1)        \
 	}                                              \
 	return error;                                  \
 }
@@ -505,7 +570,7 @@ typedef struct
 {                                                            \
 	if ((status) != NULL) {                              \
 		(status)->code = error;                      \
-		sprintf((status)->message, msg, arg1, arg2); \
+		TS_MESSAGE_2(status, msg, arg1, arg2)        \
 	}                                                    \
 	return error;                                        \
 }
@@ -514,7 +579,7 @@ typedef struct
 {                                                                  \
 	if ((status) != NULL) {                                    \
 		(status)->code = error;                            \
-		sprintf((status)->message, msg, arg1, arg2, arg3); \
+		TS_MESSAGE_3(status, msg, arg1, arg2, arg3)        \
 	}                                                          \
 	return error;                                              \
 }
@@ -523,7 +588,7 @@ typedef struct
 {                                                                        \
 	if ((status) != NULL) {                                          \
 		(status)->code = error;                                  \
-		sprintf((status)->message, msg, arg1, arg2, arg3, arg4); \
+		TS_MESSAGE_4(status, msg, arg1, arg2, arg3, arg4)        \
 	}                                                                \
 	return error;                                                    \
 }
@@ -533,7 +598,7 @@ typedef struct
 	(error) = val;                             \
 	if ((status) != NULL) {                    \
 		(status)->code = val;              \
-		sprintf((status)->message, msg);   \
+		TS_MESSAGE_0(status, msg)          \
 	}                                          \
 	goto __ ## label ## __;                    \
 }
@@ -543,7 +608,7 @@ typedef struct
 	(error) = val;                                   \
 	if ((status) != NULL) {                          \
 		(status)->code = val;                    \
-		sprintf((status)->message, msg, arg1);   \
+		TS_MESSAGE_1(status, msg, arg1)          \
 	}                                                \
 	goto __ ## label ## __;                          \
 }
@@ -553,7 +618,7 @@ typedef struct
 	(error) = val;                                         \
 	if ((status) != NULL) {                                \
 		(status)->code = val;                          \
-		sprintf((status)->message, msg, arg1, arg2);   \
+		TS_MESSAGE_2(status, msg, arg1, arg2)          \
 	}                                                      \
 	goto __ ## label ## __;                                \
 }
@@ -563,7 +628,7 @@ typedef struct
 	(error) = val;                                               \
 	if ((status) != NULL) {                                      \
 		(status)->code = val;                                \
-		sprintf((status)->message, msg, arg1, arg2, arg3);   \
+		TS_MESSAGE_3(status, msg, arg1, arg2, arg3)          \
 	}                                                            \
 	goto __ ## label ## __;                                      \
 }
@@ -573,7 +638,7 @@ typedef struct
 	(error) = val;                                                     \
 	if ((status) != NULL) {                                            \
 		(status)->code = val;                                      \
-		sprintf((status)->message, msg, arg1, arg2, arg3, arg4);   \
+		TS_MESSAGE_4(status, msg, arg1, arg2, arg3, arg4)          \
 	}                                                                  \
 	goto __ ## label ## __;                                            \
 }
@@ -581,6 +646,35 @@ typedef struct
 
 
 
+/*! @name Thread Safety
+ *
+ * TinySpline has no global state except for the allocator (see
+ * ::ts_set_allocator), which must not be changed while other threads are
+ * using TinySpline, and the statistics of builds with
+ * \c TINYSPLINE_ENABLE_STATS (see ::ts_stats_snapshot), which are not
+ * synchronized. All other functions are reentrant, that is, they can be
+ * called concurrently as long as each thread uses its own output objects
+ * (including ::tsStatus objects). In particular, functions taking an object
+ * by pointer to const (e.g., ::ts_bspline_eval, ::ts_bspline_eval_all,
+ * ::ts_bspline_sample, ::ts_sampling_plan_eval, ::ts_spline_pool_eval,
+ * ::ts_projector_project, or ::ts_arc_length_u_at) do not modify the object,
+ * neither its visible values nor any internal state, so a single spline (or
+ * plan, pool, projector, etc.) can be shared by any number of threads
+ * without synchronization. Functions taking an object by pointer to non-const
+ * require exclusive access to this object. This also applies to functions
+ * that modify an object although their primary purpose is to read it, which
+ * are ::ts_bspline_cached_derivative (modifies the derivative cache), the
+ * functions of ::tsArchive (modify the file position), and the functions of
+ * ::tsGpu (share a command queue and kernel). Concurrent stress tests
+ * (instrumented with ThreadSanitizer, if available) are found in
+ * test/stress.
+ *
+ * @{
+ */
+/*! @} */
+
+
+
 /******************************************************************************
 *                                                                             *
 * :: Data Types                                                               *
@@ -641,6 +735,21 @@ typedef struct
 	struct tsBSplineImpl *pImpl; /**< The actual implementation. */
 } tsBSpline;
 
+/**
+ * A read-only spline whose state is located in memory owned by the caller,
+ * e.g., a memory-mapped file containing a spline in binary format (cf.
+ * ::ts_bspline_view_binary). Accordingly, neither creating nor using a view
+ * allocates memory. The viewed spline (cf. ::ts_bspline_view_spline) can be
+ * passed to all functions accepting a const ::tsBSpline, for example, to
+ * ::ts_bspline_eval or ::ts_bspline_copy (to obtain a modifiable spline). It
+ * must not be passed to functions modifying or freeing a spline. A view is
+ * valid as long as the viewed memory is.
+ */
+typedef struct
+{
+	tsBSpline spline; /**< The viewed spline. */
+} tsBSplineView;
+
 /**
  * Represents the output of De Boor's algorithm. It is used to evaluate a
  * spline at given knots by iteratively computing a net of intermediate values
@@ -704,6 +813,428 @@ typedef struct
 	struct tsDeBoorNetImpl *pImpl; /**< The actual implementation. */
 } tsDeBoorNet;
 
+/**
+ * A unit of work that is scheduled by a ::tsExecutor. \p context is the
+ * (opaque) context passed to the executor and \p index is the index of the
+ * task to process, ranging from 0 to the number of tasks minus 1. Tasks are
+ * independent of each other and can therefore be processed concurrently and
+ * in any order.
+ */
+typedef void (*tsTask)(void *context, size_t index);
+
+/**
+ * Runs \p num_tasks tasks, that is, calls \p task(\p context, i) exactly once
+ * for each i in [0, \p num_tasks). Executors allow to plug an arbitrary
+ * thread pool (OpenMP, TBB, etc.) into functions such as
+ * ::ts_bspline_eval_all_parallel. \p data is the user data that was passed to
+ * the corresponding function together with the executor. An executor must not
+ * return until all tasks have been processed. A serial implementation could
+ * look like this:
+ *
+ *     void serial(void *data, size_t num_tasks, tsTask task, void *context)
+ *     {
+ *         size_t i;
+ *         for (i = 0; i < num_tasks; i++)
+ *             task(context, i);
+ *     }
+ */
+typedef void (*tsExecutor)(void *data, size_t num_tasks, tsTask task,
+	void *context);
+
+/**
+ * Receives the Bezier segments of a spline one at a time (see
+ * ::ts_bspline_to_beziers_stream). \p index is the index of the segment,
+ * [\p min, \p max] is its knot interval, and \p ctrlp stores its order *
+ * dimension control points. \p ctrlp is valid during the call only. \p data
+ * is the user data that was passed together with the sink. If a sink returns
+ * an error (and, optionally, sets \p status), the decomposition stops and
+ * the error is returned.
+ */
+typedef tsError (*tsBezierSink)(void *data, size_t index, tsReal min,
+	tsReal max, const tsReal *ctrlp, tsStatus *status);
+
+/**
+ * A spline transformation that is applied to each spline of a collection by
+ * ::ts_bspline_map. Stores the transformed version of \p spline in \p out,
+ * which has been initialized with ::ts_bspline_init (or is equal to
+ * \p spline if the collection is transformed in place). \p args is the
+ * user data that was passed to ::ts_bspline_map. Since an operation may be
+ * called concurrently, it must not modify \p args. Ready-made operations
+ * for the transformation functions of this library are
+ * ::ts_bspline_op_derive, ::ts_bspline_op_split, ::ts_bspline_op_tension,
+ * ::ts_bspline_op_to_beziers, and ::ts_bspline_op_elevate_degree.
+ */
+typedef tsError (*tsBSplineOp)(const tsBSpline *spline, const void *args,
+	tsBSpline *out, tsStatus *status);
+
+/**
+ * The arguments of the ready-made operations of ::ts_bspline_map. Each
+ * operation reads the fields it needs and ignores the others.
+ */
+typedef struct
+{
+	/** ::ts_bspline_op_derive: The number of derivations.
+	 *  ::ts_bspline_op_elevate_degree: The amount of elevation. */
+	size_t n;
+	/** ::ts_bspline_op_split: The split point.
+	 *  ::ts_bspline_op_tension: The tension factor. */
+	tsReal value;
+	/** ::ts_bspline_op_derive, ::ts_bspline_op_elevate_degree: The
+	 *  epsilon passed to the corresponding function. */
+	tsReal epsilon;
+} tsBSplineOpArgs;
+
+/**
+ * Stores the basis functions of a knot vector at a fixed sequence of knot
+ * values, that is, for each knot value 'u', the index of the first affected
+ * control point and the 'order' weights of the affected control points. Since
+ * the basis functions of a spline depend on its degree and knots only, a plan
+ * can be applied to any spline with the same degree and knots (regardless of
+ * its dimension and control points), which reduces the evaluation of 'u' to a
+ * weighted sum of 'order' control points:
+ *
+ *     point(u) = sum_j weights(u)[j] * control_points[first(u) + j]
+ *
+ * This is useful if the control points of a spline change frequently (e.g.,
+ * when animating a spline), but its knots do not.
+ */
+typedef struct
+{
+	struct tsSamplingPlanImpl *pImpl; /**< The actual implementation. */
+} tsSamplingPlan;
+
+/**
+ * Stores a spline in piecewise polynomial form, that is, the spline is
+ * converted into a sequence of Bezier curves (cf. ::ts_bspline_to_beziers)
+ * and the control points of each curve are converted into the coefficients
+ * of a polynomial in power basis. A compiled spline evaluates a point with a
+ * span lookup and Horner's rule, i.e., with degree * dimension
+ * multiply-adds instead of the O(degree^2 * dimension) operations of De
+ * Boor's algorithm, which pays off if a spline is evaluated many times
+ * between two modifications. A compiled spline is a snapshot of the spline
+ * it was created with (cf. ::ts_compiled_spline_new): later modifications of
+ * the spline are not reflected, and the spline may be freed afterwards. To
+ * detect stale compiled splines, the snapshot keeps the control points and
+ * knots of the spline, which are compared by ::ts_compiled_spline_check.
+ */
+typedef struct
+{
+	struct tsCompiledSplineImpl *pImpl; /**< The actual implementation. */
+} tsCompiledSpline;
+
+/**
+ * Stores a large number of splines with the same degree, dimension, and number
+ * of control points in a single block of memory. The control points are laid
+ * out in SoA form, that is, the i'th component of a control point is stored
+ * next to the i'th component of the corresponding control points of all the
+ * other splines:
+ *
+ *     [x_0(s_0), x_0(s_1), ..., y_0(s_0), y_0(s_1), ..., x_1(s_0), ...]
+ *
+ * This allows to evaluate all splines of a pool at once (cf.
+ * ::ts_spline_pool_eval) in a single pass over contiguous memory with neither
+ * pointer chasing nor allocating a ::tsDeBoorNet for each spline. If all
+ * splines share the same knots (which is the common case for splines created
+ * with the same type, cf. ::tsBSplineType), their basis functions are
+ * computed only once per knot value and the innermost loop runs over the
+ * splines, which allows compilers to vectorize it. Otherwise, the basis
+ * functions are computed for each spline separately. Splines are imported
+ * with ::ts_spline_pool_new and ::ts_spline_pool_set and exported with
+ * ::ts_spline_pool_get.
+ */
+typedef struct
+{
+	struct tsSplinePoolImpl *pImpl; /**< The actual implementation. */
+} tsSplinePool;
+
+/**
+ * Evaluates splines (cf. ::ts_gpu_eval_all) and spline pools (cf.
+ * ::ts_gpu_pool_eval_all) on a GPU. The control points and knots are
+ * uploaded in the memory layout of ::tsBSpline and ::tsSplinePool, and each
+ * point is computed by a separate work item from the basis functions of its
+ * knot value. The device is accessed with OpenCL, which must be enabled with
+ * the CMake option \c TINYSPLINE_ENABLE_OPENCL. If OpenCL is disabled or no
+ * suitable device is found (a GPU or accelerator supporting double precision
+ * unless \c TINYSPLINE_FLOAT_PRECISION is enabled), all functions working
+ * with host buffers fall back to the CPU (::ts_bspline_eval_all_into and
+ * ::ts_spline_pool_eval). OpenCL CPU devices (e.g., PoCL) are used only if
+ * the environment variable \c TINYSPLINE_GPU_ALLOW_CPU is set to a value
+ * other than "0" and neither a GPU nor an accelerator is available, which
+ * allows testing the device code on machines without a GPU. Use
+ * ::ts_gpu_has_device to check which backend is used. Points computed on
+ * the device may deviate from those computed on the CPU by rounding errors.
+ */
+typedef struct
+{
+	struct tsGpuImpl *pImpl; /**< The actual implementation. */
+} tsGpu;
+
+/**
+ * Represents a tensor-product B-spline surface, i.e., a net of
+ * num_u * num_v control points with a knot vector (and degree) for each of
+ * the two parameter directions u and v:
+ *
+ *     S(u, v) = sum_i sum_j N_i(u) * M_j(v) * P_ij
+ *
+ * The control points are stored row by row, that is, P_ij is stored at
+ * (i * num_v + j) * dimension. Surfaces are created with
+ * ::ts_bspline_surface_new and evaluated with ::ts_bspline_surface_eval and
+ * ::ts_bspline_surface_eval_grid. The latter computes the basis functions of
+ * each column (v) once for the whole grid and collapses the affected rows of
+ * control points into a curve once per row (u), which is much cheaper than
+ * evaluating the surface point by point.
+ */
+typedef struct
+{
+	struct tsBSplineSurfaceImpl *pImpl; /**< The actual implementation. */
+} tsBSplineSurface;
+
+/**
+ * A search index for splines that are monotone at one of their components
+ * (e.g., the time axis of a time series). The index stores the component
+ * (which is a one-dimensional spline), samples of the component, and a table
+ * of equally sized buckets mapping a value to the samples enclosing it. Thus,
+ * the search for the knot of a value (cf. ::ts_bspline_solve) starts with a
+ * bracket found in constant time, which is then refined with a few Newton
+ * iterations. In addition, ascending values (cf. ::ts_monotone_index_solve_all)
+ * are processed in a single sweep over the samples. Since an index copies the
+ * required data, it does not depend on the spline it was created with.
+ */
+typedef struct
+{
+	struct tsMonotoneIndexImpl *pImpl; /**< The actual implementation. */
+} tsMonotoneIndex;
+
+/**
+ * An acceleration structure for finding the point of a spline that is closest
+ * to an arbitrary point (cf. ::ts_projector_project). A projector splits its
+ * spline into Bezier segments (cf. ::ts_bspline_to_beziers) and stores them
+ * in a bounding volume hierarchy (BVH), i.e., a binary tree whose nodes store
+ * the axis-aligned bounding box of the control points of a range of
+ * segments. Since each segment lies within the convex hull of its control
+ * points, a query only needs to visit the segments whose bounding box is
+ * closer than the best point found so far. The closest point of a visited
+ * segment is refined with Newton iterations. Since a projector copies the
+ * required data, it does not depend on the spline it was created with.
+ */
+typedef struct
+{
+	struct tsProjectorImpl *pImpl; /**< The actual implementation. */
+} tsProjector;
+
+/**
+ * A table storing the arc length of a spline at regular steps of each of its
+ * Bezier segments (cf. ::ts_arc_length_new). The table allows to
+ * reparameterize a spline by arc length, e.g., to move along a spline at
+ * constant speed (cf. ::ts_arc_length_u_at) or to sample points that are
+ * equally spaced along a spline (cf. ::ts_arc_length_sample). Since the
+ * table copies the required data, it does not depend on the spline it was
+ * created with.
+ */
+typedef struct
+{
+	struct tsArcLengthImpl *pImpl; /**< The actual implementation. */
+} tsArcLength;
+
+/**
+ * Fits a sequence of Catmull-Rom segments (cf.
+ * ::ts_bspline_interpolate_catmull_rom) to points that arrive one at a time
+ * or in chunks (cf. ::ts_catmull_rom_fitter_push). Since a Catmull-Rom
+ * segment depends only on its four neighbouring points, appending a point
+ * finishes exactly one segment, which is computed once and never touched
+ * again. Thus, fitting \e n points takes \e O(n) time in total rather than
+ * \e O(n^2) when interpolating the whole (growing) sequence on each append.
+ * Finished segments can be moved out of a fitter (cf.
+ * ::ts_catmull_rom_fitter_take) to bound its memory.
+ */
+typedef struct
+{
+	struct tsCatmullRomFitterImpl *pImpl; /**< The actual implementation. */
+} tsCatmullRomFitter;
+
+/**
+ * A file storing a large number of splines in binary format (cf.
+ * ::ts_bspline_to_binary), each of which is identified by a unique id. In
+ * addition to the splines, an archive file contains an index mapping ids to
+ * file offsets. This allows to load single splines (cf. ::ts_archive_load)
+ * without reading the whole file and to append splines (cf.
+ * ::ts_archive_append) without rewriting the file. The binary data of each
+ * spline is aligned to 8 bytes, which allows to view the splines of a
+ * memory-mapped archive file (cf. ::ts_archive_view). An archive is not
+ * thread-safe.
+ */
+typedef struct
+{
+	struct tsArchiveImpl *pImpl; /**< The actual implementation. */
+} tsArchive;
+
+/**
+ * Stores how two splines, \c s1 and \c s2, are aligned (cf.
+ * ::ts_bspline_align). Elevating the degree of a spline and inserting knots
+ * are linear transformations of its control points that depend on the degree
+ * and knots only. Thus, each control point of an aligned spline is a weighted
+ * sum of a few consecutive control points of the original spline:
+ *
+ *     aligned[r] = sum_j weights(r)[j] * control_points[first(r) + j]
+ *
+ * A plan can be applied to any pair of splines with the degrees and knots of
+ * \c s1 and \c s2 (regardless of their dimensions and control points), which
+ * is considerably faster than aligning the splines from scratch. This is
+ * useful if the geometry of the splines changes frequently (e.g., when
+ * morphing between keyframes of the same topology), but their knots do not.
+ */
+typedef struct
+{
+	struct tsAlignmentPlanImpl *pImpl; /**< The actual implementation. */
+} tsAlignmentPlan;
+
+/**
+ * Interpolates between two splines, \c start and \c end, which are aligned
+ * (cf. ::ts_bspline_align) once when the morphism is created. In contrast to
+ * ::ts_bspline_morph, evaluating a morphism (cf. ::ts_morphism_eval) does not
+ * need to check and align its splines. This is useful if many intermediate
+ * splines are computed (e.g., when animating a spline or baking keyframes).
+ */
+typedef struct
+{
+	struct tsMorphismImpl *pImpl; /**< The actual implementation. */
+} tsMorphism;
+
+/**
+ * A set of functions that is used to allocate, reallocate, and free memory.
+ * The functions have the same semantics as \c malloc, \c realloc, and \c
+ * free, respectively, and receive \c data as first argument. Installing an
+ * allocator with ::ts_set_allocator, for example, allows to serve all
+ * allocations of a task (e.g., rendering a frame) from an arena, which is
+ * then reset in one go:
+ *
+ *     void *arena_allocate(void *data, size_t size) { ... }
+ *     void *arena_reallocate(void *data, void *ptr, size_t size) { ... }
+ *     void arena_deallocate(void *data, void *ptr) { }
+ *
+ *     tsAllocator previous, arena = {
+ *         arena_allocate, arena_reallocate, arena_deallocate, &frame_arena
+ *     };
+ *     ts_get_allocator(&previous);
+ *     ts_set_allocator(&arena);
+ *     ... ts_bspline_split, ts_bspline_derive, ts_bspline_sample, ...
+ *     ts_set_allocator(&previous);
+ *     reset(&frame_arena);
+ *
+ * Since \c realloc does not receive the size of the old block, an arena
+ * usually stores the size of each block in front of it.
+ */
+typedef struct
+{
+	/** Allocates \p size bytes (cf. \c malloc). */
+	void *(*allocate)(void *data, size_t size);
+	/** Resizes the block \p ptr to \p size bytes (cf. \c realloc). */
+	void *(*reallocate)(void *data, void *ptr, size_t size);
+	/** Frees the block \p ptr, which may be NULL (cf. \c free). */
+	void (*deallocate)(void *data, void *ptr);
+	void *data; /**< The user data passed to the functions. */
+} tsAllocator;
+
+/**
+ * The groups of functions whose calls are recorded if TinySpline is built
+ * with \c TINYSPLINE_ENABLE_STATS (cf. ::ts_stats_snapshot).
+ */
+typedef enum
+{
+	/** ::ts_bspline_eval, ::ts_bspline_eval_into, ::ts_bspline_eval_point,
+	 * ::ts_bspline_eval_all, ::ts_bspline_eval_all_into,
+	 * ::ts_bspline_eval_all_parallel, ::ts_bspline_eval_derivs, and
+	 * ::ts_bspline_eval_derivs_all. */
+	TS_STATS_EVAL = 0,
+
+	/** ::ts_bspline_sample, ::ts_bspline_sample_into,
+	 * ::ts_bspline_sample_parallel, ::ts_bspline_sample_fast, and
+	 * ::ts_bspline_sample_adaptive. */
+	TS_STATS_SAMPLE,
+
+	/** ::ts_bspline_bisect. */
+	TS_STATS_BISECT,
+
+	/** ::ts_bspline_insert_knot. */
+	TS_STATS_INSERT_KNOT,
+
+	/** ::ts_bspline_derive. */
+	TS_STATS_DERIVE,
+
+	/** ::ts_bspline_to_json, ::ts_bspline_write_json,
+	 * ::ts_bspline_write_json_buffer, and ::ts_bspline_save. */
+	TS_STATS_JSON_WRITE,
+
+	/** ::ts_bspline_parse_json, ::ts_bspline_load, ::ts_bspline_read_json,
+	 * and ::ts_bspline_read_json_file. */
+	TS_STATS_JSON_READ,
+
+	/** The number of groups. */
+	TS_STATS_NUM_FUNCTIONS
+} tsStatsFunction;
+
+/**
+ * The counters of a group of functions (cf. ::tsStatsFunction). A call is
+ * recorded when the outermost function of a group returns, that is, calls
+ * of a group nested into a call of the same group (e.g.,
+ * ::ts_bspline_eval_all calling ::ts_bspline_eval_all_into) are subsumed by
+ * the outer call. The time, bytes, and iterations of a call are inclusive,
+ * i.e., they contain the costs of nested calls of other groups.
+ */
+typedef struct
+{
+	size_t calls;          /**< The number of calls. */
+	double seconds;        /**< The cumulative time of all calls. */
+	size_t bytes;          /**< The bytes allocated by all calls. */
+	size_t knot_searches;  /**< The knot search iterations of all calls. */
+} tsStatsCounters;
+
+/**
+ * A snapshot of the statistics recorded by TinySpline (cf.
+ * ::ts_stats_snapshot).
+ */
+typedef struct
+{
+	/** The counters of each group of functions. */
+	tsStatsCounters functions[TS_STATS_NUM_FUNCTIONS];
+	/** The bytes allocated by all functions. The allocations of the
+	 * JSON parser used by ::ts_bspline_parse_json and ::ts_bspline_load
+	 * are included only if TinySpline's allocator has been set with
+	 * ::ts_set_allocator. */
+	size_t bytes;
+	/** The number of allocations (including reallocations). */
+	size_t allocations;
+	/** The knot search iterations of all functions. */
+	size_t knot_searches;
+} tsStats;
+
+/**
+ * Optional callbacks of the statistics (cf. ::ts_set_stats_hooks). \c begin
+ * and \c end are called when the outermost function of a group (cf.
+ * ::tsStatsFunction) is entered and left, respectively, with the name of the
+ * called function (a string literal, e.g., "ts_bspline_eval"). This allows to
+ * forward the calls to a tracing profiler such as Tracy or Perfetto:
+ *
+ *     void begin(void *data, const char *name)
+ *     { TRACE_EVENT_BEGIN("tinyspline", perfetto::DynamicString(name)); }
+ *     void end(void *data, const char *name)
+ *     { TRACE_EVENT_END("tinyspline"); }
+ *
+ * \c clock returns the current time in seconds and is used to measure the
+ * time of calls. If NULL, \c clock of the C standard library (processor
+ * time) is used. All callbacks may be NULL.
+ */
+typedef struct
+{
+	/** Called when a function is entered. May be NULL. */
+	void (*begin)(void *data, const char *name);
+	/** Called when a function is left. May be NULL. */
+	void (*end)(void *data, const char *name);
+	/** Returns the current time in seconds. May be NULL. */
+	double (*clock)(void *data);
+	void *data; /**< The user data passed to the callbacks. */
+} tsStatsHooks;
+
 
 
 /******************************************************************************
@@ -775,6 +1306,21 @@ size_t TINYSPLINE_API ts_bspline_num_control_points(const tsBSpline *spline);
  */
 size_t TINYSPLINE_API ts_bspline_sof_control_points(const tsBSpline *spline);
 
+/**
+ * Returns the number of control points \p spline is able to store (with its
+ * current degree and dimension) without reallocating memory. Similar to
+ * \c std::vector, the capacity is never less than
+ * ::ts_bspline_num_control_points and can be increased with
+ * ::ts_bspline_reserve. \p spline must not be the spline of a view (cf.
+ * ::ts_bspline_view_binary).
+ *
+ * @param[in] spline
+ * 	The spline whose capacity is read.
+ * @return
+ * 	The capacity of \p spline.
+ */
+size_t TINYSPLINE_API ts_bspline_capacity(const tsBSpline *spline);
+
 /**
  * Returns a deep copy of the control points of \p spline.
  *
@@ -792,6 +1338,20 @@ size_t TINYSPLINE_API ts_bspline_sof_control_points(const tsBSpline *spline);
 tsError TINYSPLINE_API ts_bspline_control_points(const tsBSpline *spline,
 	tsReal **ctrlp, tsStatus *status);
 
+/**
+ * Returns a read-only pointer to the control points of \p spline
+ * (::ts_bspline_len_control_points values). In contrast to
+ * ::ts_bspline_control_points, no copy is created. The pointer is valid until
+ * \p spline is modified or freed.
+ *
+ * @param[in] spline
+ * 	The spline whose control points are accessed.
+ * @return
+ * 	The control points of \p spline.
+ */
+const tsReal TINYSPLINE_API *ts_bspline_control_points_ptr(
+	const tsBSpline *spline);
+
 /**
  * Returns a deep copy of the control point of \p spline at \p index.
  *
@@ -886,6 +1446,18 @@ size_t TINYSPLINE_API ts_bspline_sof_knots(const tsBSpline *spline);
 tsError TINYSPLINE_API ts_bspline_knots(const tsBSpline *spline,
 	tsReal **knots, tsStatus *status);
 
+/**
+ * Returns a read-only pointer to the knots of \p spline
+ * (::ts_bspline_num_knots values). In contrast to ::ts_bspline_knots, no copy
+ * is created. The pointer is valid until \p spline is modified or freed.
+ *
+ * @param[in] spline
+ * 	The spline whose knots are accessed.
+ * @return
+ * 	The knots of \p spline.
+ */
+const tsReal TINYSPLINE_API *ts_bspline_knots_ptr(const tsBSpline *spline);
+
 /**
  * Returns the knot of \p spline at \p index.
  *
@@ -1081,6 +1653,18 @@ size_t TINYSPLINE_API ts_deboornet_sof_points(const tsDeBoorNet *net);
 tsError TINYSPLINE_API ts_deboornet_points(const tsDeBoorNet *net,
 	tsReal **points, tsStatus *status);
 
+/**
+ * Returns a read-only pointer to the points of \p net
+ * (::ts_deboornet_len_points values). In contrast to ::ts_deboornet_points,
+ * no copy is created. The pointer is valid until \p net is modified or freed.
+ *
+ * @param[in] net
+ * 	The net whose points are accessed.
+ * @return
+ * 	The points of \p net.
+ */
+const tsReal TINYSPLINE_API *ts_deboornet_points_ptr(const tsDeBoorNet *net);
+
 /**
  * Returns the length of the result array of \p net.
  *
@@ -1130,6 +1714,18 @@ size_t TINYSPLINE_API ts_deboornet_sof_result(const tsDeBoorNet *net);
 tsError TINYSPLINE_API ts_deboornet_result(const tsDeBoorNet *net,
 	tsReal **result, tsStatus *status);
 
+/**
+ * Returns a read-only pointer to the result of \p net
+ * (::ts_deboornet_len_result values). In contrast to ::ts_deboornet_result,
+ * no copy is created. The pointer is valid until \p net is modified or freed.
+ *
+ * @param[in] net
+ * 	The net whose result are accessed.
+ * @return
+ * 	The result of \p net.
+ */
+const tsReal TINYSPLINE_API *ts_deboornet_result_ptr(const tsDeBoorNet *net);
+
 
 
 /******************************************************************************
@@ -1256,6 +1852,50 @@ void TINYSPLINE_API ts_bspline_move(tsBSpline *src, tsBSpline *dest);
  */
 void TINYSPLINE_API ts_bspline_free(tsBSpline *spline);
 
+/**
+ * Increases the capacity (cf. ::ts_bspline_capacity) of \p spline such that
+ * it is able to store at least \p num_control_points control points (with
+ * its current degree and dimension) without reallocating memory. Does
+ * nothing if the capacity of \p spline is already sufficient. Transformation
+ * functions that enlarge a spline in place (i.e., with the same spline as
+ * input and output), for example, ::ts_bspline_insert_knot and
+ * ::ts_bspline_split, make use of the capacity of their output and, if it is
+ * not sufficient, grow it geometrically. Thus, repeated refinement of a
+ * spline in place reallocates memory only occasionally.
+ *
+ * @param[in, out] spline
+ * 	The spline whose capacity is increased.
+ * @param[in] num_control_points
+ * 	The minimum number of control points to reserve memory for.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_KNOTS
+ * 	If the corresponding number of knots exceeds TS_MAX_NUM_KNOTS.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_reserve(tsBSpline *spline,
+	size_t num_control_points, tsStatus *status);
+
+/**
+ * Reduces the capacity (cf. ::ts_bspline_capacity) of \p spline to its
+ * number of control points, releasing the memory reserved for additional
+ * control points and knots.
+ *
+ * @param[in, out] spline
+ * 	The spline whose capacity is reduced.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If reallocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_shrink_to_fit(tsBSpline *spline,
+	tsStatus *status);
+
 /* ------------------------------------------------------------------------- */
 
 /**
@@ -1268,7 +1908,9 @@ tsDeBoorNet TINYSPLINE_API ts_deboornet_init();
 
 /**
  * Creates a deep copy of \p src and stores the copied values in \p dest. Does
- * nothing, if \p src == \p dest.
+ * nothing, if \p src == \p dest. If the data of \p src points to NULL (e.g.,
+ * because it was created with ::ts_deboornet_init), the data of \p dest
+ * points to NULL as well.
  *
  * @param[in] src
  * 	The net to deep copy.
@@ -1355,6 +1997,93 @@ tsError TINYSPLINE_API ts_bspline_interpolate_cubic_natural(
 	const tsReal *points, size_t num_points, size_t dimension,
 	tsBSpline *spline, tsStatus *status);
 
+/**
+ * Solves the system of linear equations of
+ * ::ts_bspline_interpolate_cubic_natural
+ * for large inputs that do not fit into a single spline (cf.
+ * ::TS_MAX_NUM_KNOTS), for example, long sensor logs. Rather than creating a
+ * spline, this function computes the control points \p ctrlp of the relaxed
+ * uniform cubic spline interpolating \p points. Use
+ * ::ts_cubic_natural_to_beziers to convert (windows of) the result into
+ * sequences of Bezier curves.
+ *
+ * \p points and \p ctrlp use a column layout, that is, each series (e.g.,
+ * each dimension or each channel of a log) is stored contiguously:
+ *
+ *     [x0, x1, ..., x{n-1}, y0, y1, ..., y{n-1}, ...]
+ *
+ * The series are solved independently of each other in chunks of
+ * \p grain_size series that are passed, as tasks, to \p executor (cf.
+ * ::ts_bspline_eval_all_parallel). Because the system depends only on
+ * \p num_points, its factorization is computed once and shared by all series.
+ * Apart from the factorization (which requires a small, constant amount of
+ * memory on the stack) no workspace is allocated. \p ctrlp may be equal to
+ * \p points, in which case the series are solved in place.
+ *
+ * @param[in] points
+ * 	The points to interpolate in column layout.
+ * @param[in] num_points
+ * 	The number of points per series.
+ * @param[in] num_series
+ * 	The number of series in \p points.
+ * @param[out] ctrlp
+ * 	Stores \p num_points * \p num_series control points in column layout.
+ * 	May be equal to \p points.
+ * @param[in] grain_size
+ * 	The (maximum) number of series solved by a single task. If 0, a
+ * 	default is taken as fallback.
+ * @param[in] executor
+ * 	The executor running the tasks. May be NULL.
+ * @param[in] executor_data
+ * 	The user data passed to \p executor. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p num_series is 0.
+ * @return TS_NUM_POINTS
+ * 	If \p num_points is 0.
+ */
+tsError TINYSPLINE_API ts_cubic_natural_solve_columns(const tsReal *points,
+	size_t num_points, size_t num_series, tsReal *ctrlp,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status);
+
+/**
+ * Converts the segments [\p first, \p first + \p num_segments) of the
+ * control points computed by ::ts_cubic_natural_solve_columns into a sequence
+ * of cubic Bezier curves. The result has dimension \p num_series and uses the
+ * layout of ::ts_bspline_set_control_points, i.e., the values can be passed
+ * to a spline of type ::TS_BEZIERS with 4 * \p num_segments control points.
+ * The spline interpolating all points consists of \p num_points - 1 segments.
+ * Hence, long series can be processed in windows of segments.
+ *
+ * @param[in] ctrlp
+ * 	The control points computed by ::ts_cubic_natural_solve_columns.
+ * @param[in] num_points
+ * 	The number of points per series.
+ * @param[in] num_series
+ * 	The number of series in \p ctrlp.
+ * @param[in] first
+ * 	The index of the first segment to convert.
+ * @param[in] num_segments
+ * 	The number of segments to convert.
+ * @param[out] beziers
+ * 	Stores 4 * \p num_segments * \p num_series values.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p num_series is 0.
+ * @return TS_INDEX_ERROR
+ * 	If \p first + \p num_segments > \p num_points - 1.
+ */
+tsError TINYSPLINE_API ts_cubic_natural_to_beziers(const tsReal *ctrlp,
+	size_t num_points, size_t num_series, size_t first, size_t num_segments,
+	tsReal *beziers, tsStatus *status);
+
 /**
  * Interpolates a piecewise cubic spline by translating the given catmull-rom
  * control points into a sequence of bezier curves. In order to avoid division
@@ -1409,6 +2138,64 @@ tsError TINYSPLINE_API ts_bspline_interpolate_catmull_rom(const tsReal *points,
 	const tsReal *last, tsReal epsilon, tsBSpline *spline,
 	tsStatus *status);
 
+/**
+ * Approximates \p points with a clamped spline of degree \p degree and
+ * \p num_control_points control points in the least-squares sense. That is,
+ * the control points minimize the sum of the squared distances between the
+ * points and the spline evaluated at the chord length parameters of the
+ * points (mapped to the default domain). The first and last control point are
+ * fixed to the first and last point so that the resultant spline starts and
+ * ends exactly at the given points. The knots are placed such that each knot
+ * span contains at least one parameter, which keeps the system of linear
+ * equations solvable. Since each point affects at most \p degree + 1 control
+ * points, the system is banded and solved in linear time.
+ *
+ * If \p tolerance is greater than zero, \p num_control_points is the maximum
+ * number of control points instead (error-driven mode). Starting with
+ * \p degree + 1 (and at least 2) control points, every knot span whose
+ * points are farther away from the spline than \p tolerance is split at the
+ * parameter of its middle point and the spline is fitted again. If more spans
+ * need to be split than the budget allows, the spans with the largest error
+ * are split first. This is repeated until all points are within \p tolerance,
+ * no span can be split anymore, or the budget is exhausted. Thus, the
+ * resultant spline may violate \p tolerance.
+ *
+ * @param[in] points
+ * 	The points to approximate.
+ * @param[in] num_points
+ * 	The number of points in \p points.
+ * @param[in] dimension
+ * 	The dimensionality of the points.
+ * @param[in] num_control_points
+ * 	The number of control points of the resultant spline (the maximum
+ * 	number if \p tolerance is greater than zero).
+ * @param[in] degree
+ * 	The degree of the resultant spline.
+ * @param[in] tolerance
+ * 	The maximum distance between a point and the resultant spline. Pass a
+ * 	value less than or equal to zero to disable the error-driven mode.
+ * @param[out] spline
+ * 	The approximating spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension is 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If \p degree >= \p num_control_points.
+ * @return TS_NUM_POINTS
+ * 	If \p num_control_points < 2 or \p num_points < \p num_control_points.
+ * @return TS_NO_RESULT
+ * 	If the system of linear equations is not solvable (e.g., because
+ * 	several points have the same parameter).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_approximate(const tsReal *points,
+	size_t num_points, size_t dimension, size_t num_control_points,
+	size_t degree, tsReal tolerance, tsBSpline *spline, tsStatus *status);
+
 
 
 /******************************************************************************
@@ -1439,37 +2226,198 @@ tsError TINYSPLINE_API ts_bspline_eval(const tsBSpline *spline, tsReal u,
 	tsDeBoorNet *net, tsStatus *status);
 
 /**
- * Evaluates \p spline at knots \p us and stores the resultant points in
- * \p points. If \p us contains one or more knots where \p spline is
- * discontinuous at, only the first point of the corresponding evaluation
- * result is taken. After calling this function \p points contains exactly
- * \p num * ts_bspline_dimension(spline) values.
- *
- * This function is in particular useful in cases where a multitude of knots
- * need to be evaluated, because only a single instance of tsDeBoorNet is
- * created and reused for all evaluation tasks (therefore the memory footprint
- * is reduced to a minimum).
+ * Like ::ts_bspline_eval, but reuses the memory of \p net if it is able to
+ * store the De Boor net of \p spline. Otherwise, the memory of \p net is
+ * released and a new net is allocated. Consequently, this function does not
+ * allocate memory when being called repeatedly with splines of the same (or
+ * a smaller) degree and dimension. Unlike ::ts_bspline_eval, \p net must be
+ * initialized (either with ::ts_deboornet_init or by a previous evaluation)
+ * and is not modified if \p spline is not defined at \p u. The caller is
+ * responsible for releasing \p net with ::ts_deboornet_free.
  *
  * @param[in] spline
  * 	The spline to evaluate.
- * @param[in] us
- * 	The knot values to evaluate.
- * @param[in] num
- * 	The number of knots in \p us.
- * @param[out] points
- * 	The output parameter.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[in, out] net
+ * 	The net to reuse and to store the result in.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
  * @return TS_U_UNDEFINED
- * 	If \p spline is not defined at one of the knot values in \p us.
+ * 	If \p spline is not defined at knot value \p u.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_eval_all(const tsBSpline *spline,
+tsError TINYSPLINE_API ts_bspline_eval_into(const tsBSpline *spline,
+	tsReal u, tsDeBoorNet *net, tsStatus *status);
+
+/**
+ * Evaluates \p spline at knot \p u and stores the resultant point in
+ * \p point. In contrast to ::ts_bspline_eval, this function does not create
+ * the full De Boor net. Instead, each level of the net overwrites the previous
+ * one in a small workspace of ts_bspline_order(spline) *
+ * ts_bspline_dimension(spline) values, which is allocated on the stack for
+ * common degrees and dimensions. If \p spline is discontinuous at \p u, only
+ * the first point of the evaluation result is taken (cf.
+ * ::ts_bspline_eval_all).
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[out] point
+ * 	The buffer to store the resultant point in. Must be able to store
+ * 	ts_bspline_dimension(spline) values.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
+ * @return TS_MALLOC
+ * 	If the workspace exceeds the stack buffer and allocating memory
+ * 	failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_point(const tsBSpline *spline,
+	tsReal u, tsReal *point, tsStatus *status);
+
+/**
+ * Evaluates \p spline at knots \p us and stores the resultant points in
+ * \p points. If \p us contains one or more knots where \p spline is
+ * discontinuous at, only the first point of the corresponding evaluation
+ * result is taken. After calling this function \p points contains exactly
+ * \p num * ts_bspline_dimension(spline) values.
+ *
+ * This function is in particular useful in cases where a multitude of knots
+ * need to be evaluated, because, instead of creating a tsDeBoorNet, only the
+ * resultant points are calculated (cf. ::ts_bspline_eval_point). Therefore,
+ * the memory footprint is reduced to a minimum.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_all(const tsBSpline *spline,
 	const tsReal *us, size_t num, tsReal **points, tsStatus *status);
 
+/**
+ * Like ::ts_bspline_eval_all, but stores the resultant points in \p points,
+ * which is a buffer allocated (and owned) by the caller. This function does
+ * not allocate memory for the resultant points. It is therefore well suited
+ * for applications that evaluate splines repeatedly and want to reuse a
+ * single output buffer. \p capacity is the number of tsReal values \p points
+ * is able to store and must be at least:
+ *
+ *     num * ts_bspline_dimension(spline)
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num * ts_bspline_dimension(spline).
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_all_into(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status);
+
+/**
+ * Evaluates \p spline and its first \p n derivatives at knot \p u and stores
+ * the resultant points in \p derivs (the point first, followed by the first
+ * derivative, the second derivative, and so on). Unlike calling
+ * ::ts_bspline_derive and evaluating the derived splines, this function
+ * neither allocates nor copies splines. Instead, the derivatives of the
+ * basis functions are computed with a single span lookup (based on 'The
+ * NURBS Book' by Les Piegl and Wayne Tiller, algorithm A2.3) and are
+ * weighted with the affected control points. Derivatives of a degree
+ * greater than the degree of \p spline are zero. If \p spline, or one of
+ * its derivatives, is discontinuous at \p u, the left-hand limit is taken
+ * (except at the minimum of the domain), which is consistent with
+ * ::ts_bspline_eval_point. The workspace is allocated on the stack for
+ * common degrees.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @param[out] derivs
+ * 	The buffer to store the resultant point and derivatives in. Must be
+ * 	able to store (\p n + 1) * ts_bspline_dimension(spline) values.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
+ * @return TS_MALLOC
+ * 	If the workspace exceeds the stack buffer and allocating memory
+ * 	failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_derivs(const tsBSpline *spline,
+	tsReal u, size_t n, tsReal *derivs, tsStatus *status);
+
+/**
+ * Batched version of ::ts_bspline_eval_derivs. Evaluates \p spline and its
+ * first \p n derivatives at the \p num knots \p us and stores the results,
+ * one knot after another, in \p derivs, which must be able to store
+ * \p num * (\p n + 1) * ts_bspline_dimension(spline) values. The workspace
+ * is shared by all knots, and the span lookup of a knot starts at the span
+ * of the previous knot. Thus, ascending knots are processed fastest.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @param[out] derivs
+ * 	The buffer to store the resultant points and derivatives in.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_derivs_all(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t n, tsReal *derivs,
+	tsStatus *status);
+
 /**
  * Generates a sequence of \p num different knots (The knots are equally
  * distributed between the minimum and the maximum of the domain of \p spline),
@@ -1505,352 +2453,3025 @@ tsError TINYSPLINE_API ts_bspline_sample(const tsBSpline *spline, size_t num,
 	tsReal **points, size_t *actual_num, tsStatus *status);
 
 /**
- * Tries to find a point P on \p spline such that:
- *
- *     ts_distance(P[index], value, 1) <= fabs(epsilon)
+ * Like ::ts_bspline_sample, but stores the resultant points in \p points,
+ * which is a buffer allocated (and owned) by the caller. Unlike
+ * ::ts_bspline_sample, this function does not allocate a temporary sequence
+ * of knots, but rather generates the knots while evaluating \p spline.
+ * \p capacity is the number of tsReal values \p points is able to store and
+ * must be at least:
  *
- * This function is using the bisection method to determine P. Accordingly, it
- * is expected that the control points of \p spline are sorted at component
- * \p index either in ascending order (if \p ascending != 0) or in descending
- * order (if \p ascending == 0). If the control points of \p spline are not
- * sorted at component \p index, the behaviour of this function is undefined.
- * For the sake of fail-safeness, the distance of P[index] and \p value is
- * compared with the absolute value of \p epsilon (using fabs).
+ *     actual_num * ts_bspline_dimension(spline)
  *
- * The bisection method is an iterative approach which minimizes the error
- * (\p epsilon) with each iteration step until an "optimum" was found. However,
- * there may be no point P satisfying the distance condition. Thus, the number
- * of iterations must be limited (\p max_iter). Depending on the domain of the
- * control points of \p spline at component \p index and \p epsilon,
- * \p max_iter ranges from 7 to 50. In most cases \p max_iter == 30 should be
- * fine though. The parameter \p persnickety allows to define the behaviour of
- * this function is case no point was found after \p max_iter iterations. If
- * enabled (!= 0), TS_NO_RESULT is returned. If disabled (== 0), the best
- * fitting point is returned.
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Is set even if \p capacity is insufficient. Must not be
+ * 	NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p actual_num * ts_bspline_dimension(spline).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_sample_into(const tsBSpline *spline,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsStatus *status);
+
+/**
+ * Like ::ts_bspline_eval_all_into, but splits \p us into chunks of
+ * \p grain_size knots and passes the evaluation of the chunks, as tasks, to
+ * \p executor. Each task uses its own workspace, i.e., tasks do not share any
+ * mutable state and can be processed concurrently. If \p executor is NULL,
+ * the tasks are processed serially by the calling thread. If \p grain_size is
+ * 0, a default is taken as fallback.
  *
  * @param[in] spline
- * 	The spline to evaluate
- * @param[in] value
- * 	The value (point at component \p index) to find.
- * @param[in] epsilon
- * 	The maximum distance (inclusive).
- * @param[in] persnickety
- * 	Indicates whether TS_NO_RESULT should be returned if there is no point
- * 	P satisfying the distance condition (!= 0 to enable, == 0 to disable).
- * 	If disabled, the best fitting point is returned.
- * @param[in] index
- * 	The point's component.
- * @param[in] ascending
- * 	Indicates whether the control points of \p spline are sorted in
- * 	ascending (!= 0) or in descending (== 0) order at component \p index.
- * @param[in] max_iter
- * 	The maximum number of iterations (30 is a sane default value).
- * @param[out] net
- * 	The output parameter.
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[in] grain_size
+ * 	The (maximum) number of knots evaluated by a single task.
+ * @param[in] executor
+ * 	The executor running the tasks. May be NULL.
+ * @param[in] executor_data
+ * 	The user data passed to \p executor. May be NULL.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
- * @return TS_INDEX_ERROR
- * 	If the dimension of the control points of \p spline <= \p index.
- * @return TS_NO_RESULT
- * 	If \p persnickety is enabled (!= 0) and there is no point P satisfying
- * 	the distance condition.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num * ts_bspline_dimension(spline).
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us. If
+ * 	multiple tasks fail, the error of the task with the lowest index is
+ * 	reported.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_bisect(const tsBSpline *spline, tsReal value,
-	tsReal epsilon, int persnickety, size_t index, int ascending,
-	size_t max_iter,  tsDeBoorNet *net, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_eval_all_parallel(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status);
 
 /**
- * Returns the domain of \p spline.
+ * Like ::ts_bspline_sample_into, but splits the generated knots into chunks
+ * of \p grain_size knots and passes the evaluation of the chunks, as tasks,
+ * to \p executor (cf. ::ts_bspline_eval_all_parallel).
  *
  * @param[in] spline
- * 	The spline to query.
- * @param[out] min
- * 	The lower bound of the domain of \p spline.
- * @param[out] max
- * 	The upper bound of the domain of \p spline.
+ * 	The spline to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Is set even if \p capacity is insufficient. Must not be
+ * 	NULL.
+ * @param[in] grain_size
+ * 	The (maximum) number of knots evaluated by a single task.
+ * @param[in] executor
+ * 	The executor running the tasks. May be NULL.
+ * @param[in] executor_data
+ * 	The user data passed to \p executor. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p actual_num * ts_bspline_dimension(spline).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
  */
-void TINYSPLINE_API ts_bspline_domain(const tsBSpline *spline, tsReal *min,
-	tsReal *max);
+tsError TINYSPLINE_API ts_bspline_sample_parallel(const tsBSpline *spline,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	size_t grain_size, tsExecutor executor, void *executor_data,
+	tsStatus *status);
 
 /**
- * Checks whether the distance of the endpoints of \p spline is less than or
- * equal to \p epsilon for the first 'ts_bspline_degree - 1' derivatives
- * (starting with the zeroth derivative).
+ * Like ::ts_bspline_eval_all_into, but reads \p us from, computes in, and
+ * stores the resultant points in single precision, regardless of the type of
+ * tsReal. This allows, for example, double builds to generate vertex data
+ * for graphics APIs without converting \p spline or the result. The knot
+ * search is done in tsReal, the recurrence of De Boor's algorithm with the
+ * same (SIMD) kernel as ::ts_bspline_eval_all_into, but in float lanes. The
+ * control points and knots of \p spline are converted to float as they are
+ * loaded. Accordingly, the result has the accuracy of float (i.e., about 7
+ * significant digits) even if tsReal is double. Knots that are equal to a
+ * knot of \p spline require fewer insertions and are evaluated in tsReal.
+ * In double builds, this function is moderately faster than
+ * ::ts_bspline_eval_all_into (about 20% for cubic 3D splines): a vector
+ * holds twice as many floats, but searching the knots and loading the
+ * control points costs the same.
  *
  * @param[in] spline
- * 	The spline to query.
- * @param[in] epsilon
- * 	The maximum distance.
- * @param[out] closed
- * 	The output parameter. 1 if true, 0 otherwise.
- * @param status
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of float values \p points is able to store.
+ * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num * ts_bspline_dimension(spline).
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_is_closed(const tsBSpline *spline,
-	tsReal epsilon, int *closed, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_eval_all_f(const tsBSpline *spline,
+	const float *us, size_t num, float *points, size_t capacity,
+	tsStatus *status);
 
+/**
+ * Like ::ts_bspline_eval_all_f, but computes in double precision. In double
+ * builds, this function computes the same results as
+ * ::ts_bspline_eval_all_into. In float builds, it accumulates the recurrence
+ * of De Boor's algorithm in double precision (except for the knots of
+ * \p spline, cf. ::ts_bspline_eval_all_f), which reduces the rounding errors
+ * of splines with a high degree.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of double values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num * ts_bspline_dimension(spline).
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_all_d(const tsBSpline *spline,
+	const double *us, size_t num, double *points, size_t capacity,
+	tsStatus *status);
 
+/**
+ * Like ::ts_bspline_sample_into, but computes and stores the resultant points
+ * in single precision (cf. ::ts_bspline_eval_all_f). The knots are generated
+ * in tsReal.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of float values \p points is able to store.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Is set even if \p capacity is insufficient. Must not be
+ * 	NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p actual_num * ts_bspline_dimension(spline).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_sample_f(const tsBSpline *spline,
+	size_t num, float *points, size_t capacity, size_t *actual_num,
+	tsStatus *status);
 
-/******************************************************************************
-*                                                                             *
-* :: Transformation functions                                                 *
-*                                                                             *
-* TinySpline is a library focusing on transformations. That is, most          *
-* functions are used to transform splines by modifying their state, e.g.,     *
-* their number of control points, their degree, and so on. Accordingly, each  *
-* transformation functions specifies an input and output parameter (along     *
-* with the other parameters required to calculate the actual transformation). *
-* By passing a different pointer to the output parameter, the transformation  *
-* result is calculated and stored without changing the state of the input.    *
-* This is in particular useful when dealing with errors as the original state *
-* will never be modified. For instance, let's have a look at the following    *
-* code snippet:                                                               *
-*                                                                             *
-*     tsBSpline in = ...    // an arbitrary spline                            *
-*     tsBSpline out;        // result of transformation                       *
-*                                                                             *
-*     // Subdivide 'in' into sequence of bezier curves and store the result   *
-*     // in 'out'. Does not change 'in' in any way.                           *
-*     tsError err = ts_bspline_to_beziers(&in, &out);                         *
-*     if (err != TS_SUCCESS) {                                                *
-*         // fortunately, 'in' has not been changed                           *
-*     }                                                                       *
-*                                                                             *
-* Even if 'ts_bspline_to_beziers' fails, the state of 'in' has not been       *
-* changed allowing you to handle the error properly.                          *
-*                                                                             *
-* Unless stated otherwise, the order of the parameters for transformation     *
-* functions is:                                                               *
-*                                                                             *
-*     function(input, [additional_input], output, [additional_output])        *
-*                                                                             *
-* 'additional_input' are parameters required to calculate the actual          *
-* transformation. 'additional_output' are parameters storing further result.  *
-*                                                                             *
-* Note: None of TinySpline's transformation functions frees the memory of the *
-*       output parameter. Thus, when using the same output parameter multiple *
-*       times, make sure to free memory before each call. Otherwise, you will *
-*       have a bad time with memory leaks:                                    *
-*                                                                             *
-*     tsBSpline in = ...                  // an arbitrary spline              *
-*     tsBSpline out;                      // result of transformations        *
-*                                                                             *
-*     ts_bspline_to_beziers(&in, &out);    // first transformation            *
-*     ...                                  // some code                       *
-*     ts_bspline_free(&out);               // avoid memory leak.              *
-*     ts_bspline_tension(&in, 0.85, &out); // next transformation             *
-*                                                                             *
-* If you want to modify your input directly without having a separate output, *
-* pass it as input and output at once:                                        *
-*                                                                             *
-*     tsBSpline s = ...                       // an arbitrary spline          *
-*     tsReal *knots = ...                     // a knot vector                *
-*                                                                             *
-*     ts_bspline_set_knots(&s, knots, &s);    // copy 'knots' into 's'        *
-*                                                                             *
-* Note: If a transformation function fails *and* input != output, all fields  *
-*       of the output parameter are set to 0/NULL. If input == output, your   *
-*       input may have an invalid state in case of errors.                    *
-*                                                                             *
-******************************************************************************/
 /**
- * Returns the \p n'th derivative of \p spline and stores the result in
- * \p derivative. Creates a deep copy of \p spline if
- * \p spline != \p derivative. For more details, see:
- * 
- *     http://www.cs.mtu.edu/~shene/COURSES/cs3621/NOTES/spline/B-spline/bspline-derv.html
+ * Like ::ts_bspline_sample_f, but computes and stores the resultant points in
+ * double precision (cf. ::ts_bspline_eval_all_d).
  *
- * The derivative of a spline _s_ of degree _d_ (_d_ > 0) with _m_ control
- * points and _n_ knots is another spline _s'_ of degree _d-1_ with _m-1_
- * control points and _n-2_ knots, defined over _s_ as:
- * 
- * \f{eqnarray*}{
- *   s'(u) &=& \sum_{i=0}^{n-1} N_{i+1,p-1}(u) *
- * 		(P_{i+1} - P_{i}) * p / (u_{i+p+1}-u_{i+1}) \\
- *         &=& \sum_{i=1}^{n} N_{i,p-1}(u) *
- * 		(P_{i} - P_{i-1}) * p / (u_{i+p}-u_{i})
- * \f}
- * 
- * If _s_ has a clamped knot vector, it can be shown that:
- * 
- * \f{eqnarray*}{
- *   s'(u) &=& \sum_{i=0}^{n-1} N_{i,p-1}(u) *
- * 		(P_{i+1} - P_{i}) * p / (u_{i+p+1}-u_{i+1})
- * \f}
- * 
- * where the multiplicity of the first and the last knot value _u_ is _p_
- * rather than _p+1_. The derivative of a point (degree == 0) is another point
- * with coordinate 0.
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of double values \p points is able to store.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Is set even if \p capacity is insufficient. Must not be
+ * 	NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p actual_num * ts_bspline_dimension(spline).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_sample_d(const tsBSpline *spline,
+	size_t num, double *points, size_t capacity, size_t *actual_num,
+	tsStatus *status);
+
+/**
+ * Evaluates the NURBS \p spline at \p u and stores the resultant point,
+ * without weight, in \p point. NURBS store their control points in
+ * homogeneous coordinates (cf. ::tsBSpline), i.e., the last component of a
+ * control point is its weight and the other components are premultiplied
+ * with the weight. The homogeneous point is divided by its weight (the
+ * perspective divide) inside the evaluation, so that the result can be used
+ * as is. Accordingly, \p point must be able to store
+ * ts_bspline_dimension(spline) - 1 values. Like ::ts_bspline_eval_point, the
+ * first of the two results is taken where \p spline has a gap. The weights
+ * should be positive, otherwise the result may be infinite.
  *
  * @param[in] spline
- * 	The spline to derive.
- * @param[in] n
- * 	The number of derivations.
- * @param[in] epsilon
- * 	The maximum distance of discontinuous points. If negative,
- * 	discontinuity is ignored and the derivative is computed based on the
- * 	first result of the corresponding DeBoorNet.
- * @param[out] derivative
- *	The derivative of \p spline.
+ * 	The NURBS to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[out] point
+ * 	The buffer to store the resultant point in.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
- * @return TS_UNDERIVABLE
- * 	If \p spline is discontinuous at an internal knot and the distance
- * 	between the corresponding points is greater than \p epsilon.
+ * @return TS_DIM_ZERO
+ * 	If ts_bspline_dimension(spline) < 2, i.e., the control points have no
+ * 	component besides the weight.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_derive(const tsBSpline *spline, size_t n,
-	tsReal epsilon, tsBSpline *derivative, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_eval_rational_point(const tsBSpline *spline,
+	tsReal u, tsReal *point, tsStatus *status);
 
 /**
- * Inserts \p knot \p num times into the knot vector of \p spline and stores
- * the result in \p result. Creates a deep copy of \p spline if \p spline !=
- * \p result. The operation fails if \p result would have an invalid knot
- * vector ( i.e., multiplicity(\p knot) > order(\p result) ).
- * 
+ * Batched version of ::ts_bspline_eval_rational_point. Like
+ * ::ts_bspline_eval_all_into, the knots are evaluated in chunks of several
+ * lanes at once. The homogeneous points of a chunk are divided by their
+ * weight right after they have been computed, i.e., neither a second pass
+ * over the points nor a buffer for the homogeneous points is required. The
+ * point at us[i] is stored at \p points + i * (ts_bspline_dimension(spline)
+ * - 1).
+ *
  * @param[in] spline
- * 	The spline into which \p knot is inserted \p num times.
- * @param[in] knot
- * 	The knot to insert.
+ * 	The NURBS to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
  * @param[in] num
- * 	How many times \p knot should be inserted.
- * @param[out] result
- * 	The output spline.
- * @param[out] k
- * 	Stores the last index of \p knot in \p result.
- * @param status
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If ts_bspline_dimension(spline) < 2.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num * (ts_bspline_dimension(spline) - 1).
  * @return TS_U_UNDEFINED
- * 	If \p knot is not within the domain of \p spline.
- * @return TS_MULTIPLICITY
- * 	If the multiplicity of \p knot in \p spline plus \p num is greater than
- * 	the order of \p spline.
+ * 	If \p spline is not defined at one of the knot values in \p us.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_insert_knot(const tsBSpline *spline,
-	tsReal knot, size_t num, tsBSpline *result, size_t *k,
+tsError TINYSPLINE_API ts_bspline_eval_rational_all(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
 	tsStatus *status);
 
 /**
- * Splits \p spline at knot value \p u and stores the result in \p split. That
- * is, \p u is inserted _n_ times such that the multiplicity of \p u is equal
- * to the \p spline's order. Creates a deep copy of \p spline if
- * \p spline != \p split.
- * 
+ * Like ::ts_bspline_sample_into, but evaluates the NURBS \p spline with
+ * ::ts_bspline_eval_rational_all, i.e., the resultant points have
+ * ts_bspline_dimension(spline) - 1 components.
+ *
  * @param[in] spline
- * 	The spline to split.
+ * 	The NURBS to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Is set even if \p capacity is insufficient. Must not be
+ * 	NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If ts_bspline_dimension(spline) < 2.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p actual_num * (ts_bspline_dimension(spline) - 1).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_sample_rational(const tsBSpline *spline,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsStatus *status);
+
+/**
+ * Evaluates the NURBS \p spline and its first \p n derivatives at \p u (cf.
+ * ::ts_bspline_eval_derivs) and stores the results, without weight, in
+ * \p derivs. The derivatives of the rational curve are obtained from the
+ * derivatives of the homogeneous curve with the quotient rule (algorithm
+ * A4.2 of 'The NURBS Book'), one knot at a time. \p derivs must be able to
+ * store (\p n + 1) * (ts_bspline_dimension(spline) - 1) values. In contrast
+ * to ::ts_bspline_eval_derivs, derivatives of an order greater than the
+ * degree of \p spline are not necessarily zero.
+ *
+ * @param[in] spline
+ * 	The NURBS to evaluate.
  * @param[in] u
- * 	The split point (knot).
- * @param[out] split
- * 	The split spline.
- * @param[out] k
- * 	Stores the last index of \p u in \p split.
+ * 	The knot to evaluate \p spline at.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @param[out] derivs
+ * 	The buffer to store the resultant point and derivatives in.
  * @param[out] status
- * 	Stores the last index of \p u in \p result.
+ * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If ts_bspline_dimension(spline) < 2.
  * @return TS_U_UNDEFINED
  * 	If \p spline is not defined at knot value \p u.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_split(const tsBSpline *spline, tsReal u,
-	tsBSpline *split, size_t *k, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_eval_rational_derivs(
+	const tsBSpline *spline, tsReal u, size_t n, tsReal *derivs,
+	tsStatus *status);
 
 /**
- * Sets the control points of \p spline so that their tension corresponds the
- * given tension factor (0 => yields to a line connecting the first and the
- * last control point; 1 => keeps the original shape). If \p tension < 0 or if
- * \p tension > 1, the behaviour of this function is undefined, though, it will
- * not result in an error. Creates a deep copy of \p spline if
- * \p spline != \p out.
- *
- * This function is based on:
- * 
- *      Holten, Danny. "Hierarchical edge bundles: Visualization of adjacency
- *      relations in hierarchical data." Visualization and Computer Graphics,
- *      IEEE Transactions on 12.5 (2006): 741-748.
- * 
- * Holten calls it "straightening" (page 744, equation 1).
+ * Batched version of ::ts_bspline_eval_rational_derivs (cf.
+ * ::ts_bspline_eval_derivs_all). \p derivs must be able to store \p num *
+ * (\p n + 1) * (ts_bspline_dimension(spline) - 1) values.
  *
  * @param[in] spline
- * 	The input spline.
- * @param[in] tension
- * 	The tension factor (0 <= \p tension <= 1).
- * @param[out] out
- * 	The output spline.
+ * 	The NURBS to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @param[out] derivs
+ * 	The buffer to store the resultant points and derivatives in.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If ts_bspline_dimension(spline) < 2.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_tension(const tsBSpline *spline,
-	tsReal tension, tsBSpline *out, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_eval_rational_derivs_all(
+	const tsBSpline *spline, const tsReal *us, size_t num, size_t n,
+	tsReal *derivs, tsStatus *status);
 
 /**
- * Decomposes \p spline into a sequence of Bezier curves by splitting it at
- * each internal knot value. Creates a deep copy of \p spline if
- * \p spline != \p beziers.
- * 
+ * Like ::ts_bspline_sample_into, but uses forward differencing instead of
+ * De Boor's algorithm. That is, \p spline is converted into a sequence of
+ * Bezier curves (cf. ::ts_bspline_to_beziers) and, since the knots generated
+ * by ::ts_bspline_sample are equally distributed, the points of each Bezier
+ * curve are obtained with degree * dimension additions per point (after a
+ * short setup). The conversion is linear in the number of
+ * control points and, thus, pays off if \p num is significantly greater than
+ * the number of control points (e.g., when rasterizing lines).
+ *
+ * Forward differencing accumulates rounding errors. To bound the error, the
+ * differences are recomputed from exact points after a few steps and at the
+ * beginning of each Bezier curve. The first and the last point are exact. If
+ * \p error is not NULL, it receives the maximum distance between a generated
+ * point and the corresponding exact point, measured at the end of each run of
+ * forward differences (i.e., where the error is greatest).
+ *
  * @param[in] spline
- * 	The spline to decompose.
- * @param[out] beziers
- * 	The bezier decomposition of \p spline.
+ * 	The spline to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Is set even if \p capacity is insufficient. Must not be
+ * 	NULL.
+ * @param[out] error
+ * 	The maximum error of the generated points. May be NULL.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p actual_num * ts_bspline_dimension(spline).
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_to_beziers(const tsBSpline *spline,
-	tsBSpline *beziers, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_sample_fast(const tsBSpline *spline,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsReal *error, tsStatus *status);
 
 /**
- * Elevates the degree of \p spline by \p amount and stores the result in
- * \p elevated. If \p spline != \p elevated, the internal state of \p spline is
- * not modified, that is, \p elevated is a new, independent ::tsBSpline
- * instance.
+ * Approximates \p spline by a polyline whose vertices are located on
+ * \p spline. In contrast to ::ts_bspline_sample, the knots are not equally
+ * distributed. Instead, \p spline is converted into a sequence of Bezier
+ * curves (cf. ::ts_bspline_to_beziers), each of which is recursively split in
+ * half until the control points of a part deviate from its chord (the line
+ * segment connecting the first and the last control point) by at most
+ * fabs(\p tolerance). Because a Bezier curve lies within the convex hull of
+ * its control points, the resultant polyline deviates from \p spline by at
+ * most fabs(\p tolerance). Accordingly, flat sections yield few points and
+ * strongly curved sections yield many points. The number of subdivisions per
+ * Bezier curve is limited to 16, i.e., each Bezier curve is approximated by
+ * at most 65536 line segments (which also applies if \p tolerance is 0).
+ *
+ * The first and the last point of the polyline are the first and the last
+ * point of \p spline. If \p spline is not continuous, the polyline contains
+ * the points on both sides of a gap greater than fabs(\p tolerance).
+ *
+ * The resultant points are stored in \p points, which is a buffer of
+ * \p capacity tsReal values allocated with malloc (or NULL if \p capacity is
+ * 0). The buffer is grown with realloc if necessary and \p points and
+ * \p capacity are updated accordingly. Thus, a single buffer can be reused
+ * across multiple calls. The caller owns the buffer and must free it---even if
+ * an error occurred.
  *
  * @param[in] spline
- * 	The spline to elevate.
- * @param[in] amount
- * 	How often to elevate the degree of \p spline.
- * @param[in] epsilon
- * 	In order to elevate the degree of a spline, it must be decomposed into
- * 	a sequence of bezier curves (see ::ts_bspline_to_beziers). After degree
- * 	elevation, the split points of the bezier curves are merged again. This
- * 	parameter is used to distinguish between the split points of the
- * 	decomposition process and the wanted discontinuity points. A viable
- * 	default value is ::TS_CONTROL_POINT_EPSILON.
- * @param[out] elevated
- * 	The elevated spline.
+ * 	The spline to approximate.
+ * @param[in] tolerance
+ * 	The maximum distance between the polyline and \p spline.
+ * @param[in, out] points
+ * 	The buffer to store the resultant points in. Must not be NULL, but may
+ * 	point to NULL.
+ * @param[in, out] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] num
+ * 	The number of resultant points.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
  * @return TS_MALLOC
- * 	If memory allocation failed.
+ * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_elevate_degree(const tsBSpline *spline,
+tsError TINYSPLINE_API ts_bspline_sample_adaptive(const tsBSpline *spline,
+	tsReal tolerance, tsReal **points, size_t *capacity, size_t *num,
+	tsStatus *status);
+
+/**
+ * Tries to find a point P on \p spline such that:
+ *
+ *     ts_distance(P[index], value, 1) <= fabs(epsilon)
+ *
+ * This function is using the bisection method to determine P. Accordingly, it
+ * is expected that the control points of \p spline are sorted at component
+ * \p index either in ascending order (if \p ascending != 0) or in descending
+ * order (if \p ascending == 0). If the control points of \p spline are not
+ * sorted at component \p index, the behaviour of this function is undefined.
+ * For the sake of fail-safeness, the distance of P[index] and \p value is
+ * compared with the absolute value of \p epsilon (using fabs).
+ *
+ * The bisection method is an iterative approach which minimizes the error
+ * (\p epsilon) with each iteration step until an "optimum" was found. However,
+ * there may be no point P satisfying the distance condition. Thus, the number
+ * of iterations must be limited (\p max_iter). Depending on the domain of the
+ * control points of \p spline at component \p index and \p epsilon,
+ * \p max_iter ranges from 7 to 50. In most cases \p max_iter == 30 should be
+ * fine though. The parameter \p persnickety allows to define the behaviour of
+ * this function is case no point was found after \p max_iter iterations. If
+ * enabled (!= 0), TS_NO_RESULT is returned. If disabled (== 0), the best
+ * fitting point is returned.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate
+ * @param[in] value
+ * 	The value (point at component \p index) to find.
+ * @param[in] epsilon
+ * 	The maximum distance (inclusive).
+ * @param[in] persnickety
+ * 	Indicates whether TS_NO_RESULT should be returned if there is no point
+ * 	P satisfying the distance condition (!= 0 to enable, == 0 to disable).
+ * 	If disabled, the best fitting point is returned.
+ * @param[in] index
+ * 	The point's component.
+ * @param[in] ascending
+ * 	Indicates whether the control points of \p spline are sorted in
+ * 	ascending (!= 0) or in descending (== 0) order at component \p index.
+ * @param[in] max_iter
+ * 	The maximum number of iterations (30 is a sane default value).
+ * @param[out] net
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If the dimension of the control points of \p spline <= \p index.
+ * @return TS_NO_RESULT
+ * 	If \p persnickety is enabled (!= 0) and there is no point P satisfying
+ * 	the distance condition.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_bisect(const tsBSpline *spline, tsReal value,
+	tsReal epsilon, int persnickety, size_t index, int ascending,
+	size_t max_iter,  tsDeBoorNet *net, tsStatus *status);
+
+/**
+ * Solves the same problem as ::ts_bspline_bisect, but usually requires far
+ * fewer evaluations of \p spline. First, the knot spans whose control points
+ * enclose \p value at component \p index are determined by binary searching
+ * the (sorted) control points. This is possible because each span of a
+ * spline lies within the convex hull of its control points. Then, starting
+ * with a linear interpolation in the resultant bracket, safeguarded Newton
+ * iterations (using the first derivative of \p spline) are run until the
+ * distance condition is satisfied. Steps that would leave the bracket fall
+ * back to bisection, which guarantees convergence. In addition, only the
+ * component \p index (and its derivative) is computed in each iteration
+ * (rather than all components). As with ::ts_bspline_bisect, the control
+ * points of \p spline must be sorted at component \p index. If \p value is
+ * outside the range of \p spline at component \p index, the closest end of
+ * the range is returned.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate
+ * @param[in] value
+ * 	The value (point at component \p index) to find.
+ * @param[in] epsilon
+ * 	The maximum distance (inclusive).
+ * @param[in] persnickety
+ * 	Indicates whether TS_NO_RESULT should be returned if there is no point
+ * 	P satisfying the distance condition (!= 0 to enable, == 0 to disable).
+ * 	If disabled, the best fitting point is returned.
+ * @param[in] index
+ * 	The point's component.
+ * @param[in] ascending
+ * 	Indicates whether the control points of \p spline are sorted in
+ * 	ascending (!= 0) or in descending (== 0) order at component \p index.
+ * @param[in] max_iter
+ * 	The maximum number of iterations (10 is usually more than enough).
+ * @param[out] net
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If the dimension of the control points of \p spline <= \p index.
+ * @return TS_NO_RESULT
+ * 	If \p max_iter == 0 or if \p persnickety is enabled (!= 0) and there is
+ * 	no point P satisfying the distance condition.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_solve(const tsBSpline *spline, tsReal value,
+	tsReal epsilon, int persnickety, size_t index, int ascending,
+	size_t max_iter, tsDeBoorNet *net, tsStatus *status);
+
+/**
+ * Batched version of ::ts_bspline_solve. Finds the knots of the \p num values
+ * \p values (at component \p index) and stores them in \p us, which must be
+ * able to store \p num values. The resultant knots can be evaluated with
+ * ::ts_bspline_eval_all_into, for example. Does not allocate memory unless
+ * the degree of \p spline is very large.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate
+ * @param[in] values
+ * 	The values (points at component \p index) to find.
+ * @param[in] num
+ * 	The number of values in \p values.
+ * @param[in] epsilon
+ * 	The maximum distance (inclusive).
+ * @param[in] persnickety
+ * 	Indicates whether TS_NO_RESULT should be returned if there is a value
+ * 	without point satisfying the distance condition (!= 0 to enable, == 0
+ * 	to disable). If disabled, the best fitting knots are returned.
+ * @param[in] index
+ * 	The point's component.
+ * @param[in] ascending
+ * 	Indicates whether the control points of \p spline are sorted in
+ * 	ascending (!= 0) or in descending (== 0) order at component \p index.
+ * @param[in] max_iter
+ * 	The maximum number of iterations per value.
+ * @param[out] us
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If the dimension of the control points of \p spline <= \p index.
+ * @return TS_NO_RESULT
+ * 	If \p max_iter == 0 or if \p persnickety is enabled (!= 0) and there is
+ * 	a value without point satisfying the distance condition.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_solve_all(const tsBSpline *spline,
+	const tsReal *values, size_t num, tsReal epsilon, int persnickety,
+	size_t index, int ascending, size_t max_iter, tsReal *us,
+	tsStatus *status);
+
+/**
+ * Returns the domain of \p spline.
+ *
+ * @param[in] spline
+ * 	The spline to query.
+ * @param[out] min
+ * 	The lower bound of the domain of \p spline.
+ * @param[out] max
+ * 	The upper bound of the domain of \p spline.
+ */
+void TINYSPLINE_API ts_bspline_domain(const tsBSpline *spline, tsReal *min,
+	tsReal *max);
+
+/**
+ * Checks whether the distance of the endpoints of \p spline is less than or
+ * equal to \p epsilon for the first 'ts_bspline_degree - 1' derivatives
+ * (starting with the zeroth derivative).
+ *
+ * @param[in] spline
+ * 	The spline to query.
+ * @param[in] epsilon
+ * 	The maximum distance.
+ * @param[out] closed
+ * 	The output parameter. 1 if true, 0 otherwise.
+ * @param status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_is_closed(const tsBSpline *spline,
+	tsReal epsilon, int *closed, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Sampling Plan Functions                                                  *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new plan whose data points to NULL.
+ *
+ * @return
+ * 	A new plan whose data points to NULL.
+ */
+tsSamplingPlan TINYSPLINE_API ts_sampling_plan_init();
+
+/**
+ * Computes the basis functions of \p spline at the \p num knot values \p us
+ * and stores them in \p plan (cf. ::tsSamplingPlan). The knot values may be
+ * passed in any order, but ascending knot values are processed faster.
+ *
+ * @param[in] spline
+ * 	The spline whose degree and knots are used to compute the plan.
+ * @param[in] us
+ * 	The knot values to compute the basis functions at.
+ * @param[in] num
+ * 	The number of knot values in \p us.
+ * @param[out] plan
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_sampling_plan_new(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsSamplingPlan *plan, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The plan to deep copy.
+ * @param[out] dest
+ * 	The output plan.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_sampling_plan_copy(const tsSamplingPlan *src,
+	tsSamplingPlan *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The plan whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The plan that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_sampling_plan_move(tsSamplingPlan *src,
+	tsSamplingPlan *dest);
+
+/**
+ * Frees the data of \p plan. After calling this function, the data of
+ * \p plan points to NULL.
+ *
+ * @param[out] plan
+ * 	The plan to free.
+ */
+void TINYSPLINE_API ts_sampling_plan_free(tsSamplingPlan *plan);
+
+/**
+ * Returns the number of knot values (and thus the number of points generated
+ * by ::ts_sampling_plan_eval) of \p plan.
+ *
+ * @param[in] plan
+ * 	The plan whose number of knot values is read.
+ * @return
+ * 	The number of knot values of \p plan.
+ */
+size_t TINYSPLINE_API ts_sampling_plan_num_points(const tsSamplingPlan *plan);
+
+/**
+ * Evaluates \p spline at the knot values of \p plan and stores the resultant
+ * points in \p points. \p spline must have the same degree and knots as the
+ * spline \p plan was created with. \p capacity is the number of tsReal values
+ * \p points is able to store and must be at least:
+ *
+ *     ts_sampling_plan_num_points(plan) * ts_bspline_dimension(spline)
+ *
+ * @param[in] plan
+ * 	The plan to apply.
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INCOMPATIBLE
+ * 	If the degree or the knots of \p spline differ from the degree or the
+ * 	knots of \p plan.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < ts_sampling_plan_num_points(plan) *
+ * 	ts_bspline_dimension(spline).
+ */
+tsError TINYSPLINE_API ts_sampling_plan_eval(const tsSamplingPlan *plan,
+	const tsBSpline *spline, tsReal *points, size_t capacity,
+	tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Compiled Spline Functions                                                *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new compiled spline whose data points to NULL.
+ *
+ * @return
+ * 	A new compiled spline whose data points to NULL.
+ */
+tsCompiledSpline TINYSPLINE_API ts_compiled_spline_init();
+
+/**
+ * Compiles \p spline into piecewise polynomial form (cf. ::tsCompiledSpline)
+ * and stores the result in \p compiled. \p spline is not modified and may be
+ * the spline of a view (cf. ::ts_bspline_view_binary).
+ *
+ * The power basis is numerically less stable than De Boor's algorithm, so
+ * the points of \p compiled may slightly differ from the ones computed by
+ * ::ts_bspline_eval_all_into (the error grows with the degree).
+ *
+ * @param[in] spline
+ * 	The spline to compile.
+ * @param[out] compiled
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_compiled_spline_new(const tsBSpline *spline,
+	tsCompiledSpline *compiled, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The compiled spline to deep copy.
+ * @param[out] dest
+ * 	The output compiled spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_compiled_spline_copy(const tsCompiledSpline *src,
+	tsCompiledSpline *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The compiled spline whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The compiled spline that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_compiled_spline_move(tsCompiledSpline *src,
+	tsCompiledSpline *dest);
+
+/**
+ * Frees the data of \p compiled. After calling this function, the data of
+ * \p compiled points to NULL.
+ *
+ * @param[out] compiled
+ * 	The compiled spline to free.
+ */
+void TINYSPLINE_API ts_compiled_spline_free(tsCompiledSpline *compiled);
+
+/**
+ * Returns the dimension of the points of \p compiled.
+ *
+ * @param[in] compiled
+ * 	The compiled spline whose dimension is read.
+ * @return
+ * 	The dimension of \p compiled.
+ */
+size_t TINYSPLINE_API ts_compiled_spline_dimension(
+	const tsCompiledSpline *compiled);
+
+/**
+ * Returns the domain of \p compiled, which is the domain of the spline
+ * \p compiled was created with (cf. ::ts_bspline_domain).
+ *
+ * @param[in] compiled
+ * 	The compiled spline to query.
+ * @param[out] min
+ * 	The lower bound of the domain of \p compiled.
+ * @param[out] max
+ * 	The upper bound of the domain of \p compiled.
+ */
+void TINYSPLINE_API ts_compiled_spline_domain(
+	const tsCompiledSpline *compiled, tsReal *min, tsReal *max);
+
+/**
+ * Checks whether \p compiled is up to date, i.e., whether \p spline has the
+ * degree, dimension, control points, and knots of the spline \p compiled
+ * was created with. The control points must be exactly the same, the knots
+ * are compared with ::ts_knots_equal. This allows to recompile \p spline
+ * (cf. ::ts_compiled_spline_new) only if it has been modified. The check is
+ * linear in the number of control points and knots and is not done by the
+ * evaluation functions.
+ *
+ * @param[in] compiled
+ * 	The compiled spline to check.
+ * @param[in] spline
+ * 	The spline to compare with.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	If \p compiled is up to date.
+ * @return TS_INCOMPATIBLE
+ * 	If the degree, dimension, number of control points, control points,
+ * 	or knots of \p spline differ from those of the spline \p compiled was
+ * 	created with.
+ */
+tsError TINYSPLINE_API ts_compiled_spline_check(
+	const tsCompiledSpline *compiled, const tsBSpline *spline,
+	tsStatus *status);
+
+/**
+ * Evaluates \p compiled at \p u (cf. ::ts_compiled_spline_eval_all) and
+ * stores the result in \p point, which must be able to store
+ * ts_compiled_spline_dimension(compiled) values.
+ *
+ * @param[in] compiled
+ * 	The compiled spline to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p compiled at.
+ * @param[out] point
+ * 	The buffer to store the resultant point in.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p compiled is not defined at knot value \p u.
+ */
+tsError TINYSPLINE_API ts_compiled_spline_eval(
+	const tsCompiledSpline *compiled, tsReal u, tsReal *point,
+	tsStatus *status);
+
+/**
+ * Like ::ts_bspline_eval_all_into, but evaluates the compiled spline
+ * \p compiled. Like ::ts_bspline_eval, knots within ::TS_KNOT_EPSILON of a
+ * breakpoint are evaluated at the breakpoint, and knots equal to the
+ * breakpoint between two spans (i.e., the knots of a discontinuity) are
+ * evaluated with the first of them. The span of the previous knot is checked
+ * first, and the span is moved forward with plain comparisons, so sorted
+ * knots are looked up in amortized constant time.
+ *
+ * @param[in] compiled
+ * 	The compiled spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num * ts_compiled_spline_dimension(compiled).
+ * @return TS_U_UNDEFINED
+ * 	If \p compiled is not defined at one of the knot values in \p us.
+ */
+tsError TINYSPLINE_API ts_compiled_spline_eval_all(
+	const tsCompiledSpline *compiled, const tsReal *us, size_t num,
+	tsReal *points, size_t capacity, tsStatus *status);
+
+/**
+ * Like ::ts_bspline_sample_into, but samples the compiled spline
+ * \p compiled (cf. ::ts_compiled_spline_eval_all). If \p num is 0, the
+ * number of points is chosen like ::ts_bspline_sample does for the spline
+ * \p compiled was created with.
+ *
+ * @param[in] compiled
+ * 	The compiled spline to sample.
+ * @param[in] num
+ * 	The number of points to sample.
+ * @param[out] points
+ * 	The buffer to store the sampled points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Is set even if \p capacity is insufficient.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p actual_num * ts_compiled_spline_dimension(compiled).
+ */
+tsError TINYSPLINE_API ts_compiled_spline_sample(
+	const tsCompiledSpline *compiled, size_t num, tsReal *points,
+	size_t capacity, size_t *actual_num, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Spline Pool Functions                                                    *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new pool whose data points to NULL.
+ *
+ * @return
+ * 	A new pool whose data points to NULL.
+ */
+tsSplinePool TINYSPLINE_API ts_spline_pool_init();
+
+/**
+ * Copies the \p num splines \p splines into \p pool (cf. ::tsSplinePool). All
+ * splines must have the same degree, dimension, and number of control points.
+ *
+ * @param[in] splines
+ * 	The splines to import.
+ * @param[in] num
+ * 	The number of splines in \p splines.
+ * @param[out] pool
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If \p num == 0.
+ * @return TS_INCOMPATIBLE
+ * 	If the degree, the dimension, or the number of control points of one
+ * 	of the splines differs from the first spline.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_spline_pool_new(const tsBSpline *splines, size_t num,
+	tsSplinePool *pool, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The pool to deep copy.
+ * @param[out] dest
+ * 	The output pool.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_spline_pool_copy(const tsSplinePool *src,
+	tsSplinePool *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The pool whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The pool that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_spline_pool_move(tsSplinePool *src, tsSplinePool *dest);
+
+/**
+ * Frees the data of \p pool. After calling this function, the data of \p pool
+ * points to NULL.
+ *
+ * @param[out] pool
+ * 	The pool to free.
+ */
+void TINYSPLINE_API ts_spline_pool_free(tsSplinePool *pool);
+
+/**
+ * Returns the number of splines of \p pool.
+ *
+ * @param[in] pool
+ * 	The pool whose number of splines is read.
+ * @return
+ * 	The number of splines of \p pool.
+ */
+size_t TINYSPLINE_API ts_spline_pool_num_splines(const tsSplinePool *pool);
+
+/**
+ * Returns the dimension of the splines of \p pool.
+ *
+ * @param[in] pool
+ * 	The pool whose dimension is read.
+ * @return
+ * 	The dimension of the splines of \p pool.
+ */
+size_t TINYSPLINE_API ts_spline_pool_dimension(const tsSplinePool *pool);
+
+/**
+ * Returns whether all splines of \p pool share the same knots, i.e., whether
+ * ::ts_spline_pool_eval and ::ts_spline_pool_sample compute the basis
+ * functions only once per knot value.
+ *
+ * @param[in] pool
+ * 	The pool to check.
+ * @return 1
+ * 	If all splines of \p pool share the same knots.
+ * @return 0
+ * 	Otherwise.
+ */
+int TINYSPLINE_API ts_spline_pool_shares_knots(const tsSplinePool *pool);
+
+/**
+ * Copies the spline at \p index of \p pool into \p spline.
+ *
+ * @param[in] pool
+ * 	The pool to read from.
+ * @param[in] index
+ * 	The index of the spline to export.
+ * @param[out] spline
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If \p index >= ts_spline_pool_num_splines(pool).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_spline_pool_get(const tsSplinePool *pool,
+	size_t index, tsBSpline *spline, tsStatus *status);
+
+/**
+ * Replaces the spline at \p index of \p pool with \p spline, which must have
+ * the same degree, dimension, and number of control points as the splines of
+ * \p pool. Does not allocate memory.
+ *
+ * @param[in, out] pool
+ * 	The pool to modify.
+ * @param[in] index
+ * 	The index of the spline to replace.
+ * @param[in] spline
+ * 	The spline to import.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If \p index >= ts_spline_pool_num_splines(pool).
+ * @return TS_INCOMPATIBLE
+ * 	If the degree, the dimension, or the number of control points of
+ * 	\p spline differs from the splines of \p pool.
+ */
+tsError TINYSPLINE_API ts_spline_pool_set(tsSplinePool *pool, size_t index,
+	const tsBSpline *spline, tsStatus *status);
+
+/**
+ * Evaluates all splines of \p pool at \p u and stores the resultant points in
+ * \p points, that is, the point of the i'th spline is stored at \p points +
+ * i * ts_spline_pool_dimension(pool). \p capacity is the number of tsReal
+ * values \p points is able to store and must be at least:
+ *
+ *     ts_spline_pool_num_splines(pool) * ts_spline_pool_dimension(pool)
+ *
+ * In contrast to ::ts_bspline_eval, points at which a spline has a gap (cf.
+ * ::tsDeBoorNet) yield the first of the two results. Does not allocate memory
+ * unless the degree of the splines is very large.
+ *
+ * @param[in] pool
+ * 	The pool to evaluate.
+ * @param[in] u
+ * 	The knot value to evaluate.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If one of the splines is not defined at \p u.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < ts_spline_pool_num_splines(pool) *
+ * 	ts_spline_pool_dimension(pool).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_spline_pool_eval(const tsSplinePool *pool, tsReal u,
+	tsReal *points, size_t capacity, tsStatus *status);
+
+/**
+ * Samples all splines of \p pool like ::ts_bspline_sample_into, that is, each
+ * spline is evaluated at \p num knots that are equally distributed in its
+ * domain. The points of the i'th spline are stored at \p points + i * num *
+ * ts_spline_pool_dimension(pool). If \p num is 0, a default value is used
+ * (see ::ts_bspline_sample). The number of points sampled per spline is
+ * stored in \p actual_num. \p capacity is the number of tsReal values
+ * \p points is able to store and must be at least:
+ *
+ *     ts_spline_pool_num_splines(pool) * num * ts_spline_pool_dimension(pool)
+ *
+ * @param[in] pool
+ * 	The pool to sample.
+ * @param[in] num
+ * 	The number of points to sample per spline.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] actual_num
+ * 	The number of points sampled per spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity is too small.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_spline_pool_sample(const tsSplinePool *pool,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: GPU Functions                                                            *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new GPU backend whose data points to NULL.
+ *
+ * @return
+ * 	A new GPU backend whose data points to NULL.
+ */
+tsGpu TINYSPLINE_API ts_gpu_init();
+
+/**
+ * Creates a GPU backend (cf. ::tsGpu) on the first suitable device. If no
+ * device is available (or OpenCL is disabled), the backend falls back to the
+ * CPU, which is not considered an error. CPU devices are considered only if
+ * \c TINYSPLINE_GPU_ALLOW_CPU is set (cf. ::tsGpu).
+ *
+ * @param[out] gpu
+ * 	The output backend.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_gpu_new(tsGpu *gpu, tsStatus *status);
+
+/**
+ * Releases the device resources of \p gpu and frees its memory. After
+ * calling this function, the data of \p gpu points to NULL.
+ *
+ * @param[out] gpu
+ * 	The backend to free.
+ */
+void TINYSPLINE_API ts_gpu_free(tsGpu *gpu);
+
+/**
+ * Returns whether \p gpu evaluates splines on a device (1) or falls back to
+ * the CPU (0).
+ *
+ * @param[in] gpu
+ * 	The backend whose device is checked.
+ * @return
+ * 	1 if a device is used, 0 otherwise.
+ */
+int TINYSPLINE_API ts_gpu_has_device(const tsGpu *gpu);
+
+/**
+ * Returns the OpenCL context (\c cl_context) and command queue
+ * (\c cl_command_queue) of \p gpu, which can be used to create and read the
+ * device buffers passed to ::ts_gpu_eval_all_device and
+ * ::ts_gpu_pool_eval_all_device. Both are NULL if \p gpu has no device.
+ *
+ * @param[in] gpu
+ * 	The backend whose handles are returned.
+ * @param[out] context
+ * 	The OpenCL context. May be NULL.
+ * @param[out] queue
+ * 	The OpenCL command queue. May be NULL.
+ */
+void TINYSPLINE_API ts_gpu_handles(const tsGpu *gpu, void **context,
+	void **queue);
+
+/**
+ * Evaluates \p spline at the \p num knot values \p us like
+ * ::ts_bspline_eval_all_into, but on the device of \p gpu (if any). At
+ * knots where \p spline has a gap (cf. ::tsDeBoorNet), the first of the two
+ * results is computed. \p capacity is the number of tsReal values \p points
+ * is able to store and must be at least:
+ *
+ *     num * ts_bspline_dimension(spline)
+ *
+ * Splines whose order exceeds a fixed limit (currently 32) are evaluated on
+ * the CPU.
+ *
+ * @param[in] gpu
+ * 	The backend used for evaluation.
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The host buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num * ts_bspline_dimension(spline).
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_DEVICE_ERROR
+ * 	If a device operation failed.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_gpu_eval_all(tsGpu *gpu, const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, size_t capacity,
+	tsStatus *status);
+
+/**
+ * Like ::ts_gpu_eval_all, but stores the resultant points in the device
+ * buffer \p buffer (a \c cl_mem created in the context of \p gpu, cf.
+ * ::ts_gpu_handles) so that they can be processed further on the device
+ * without copying them to the host. \p buffer must be able to store
+ * \p num * ts_bspline_dimension(spline) tsReal values. The points are
+ * available once the command queue of \p gpu has finished.
+ *
+ * @param[in] gpu
+ * 	The backend used for evaluation.
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] buffer
+ * 	The device buffer to store the resultant points in.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p buffer is too small.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_DEVICE_ERROR
+ * 	If \p gpu has no device, the order of \p spline is not supported, or a
+ * 	device operation failed.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_gpu_eval_all_device(tsGpu *gpu,
+	const tsBSpline *spline, const tsReal *us, size_t num, void *buffer,
+	tsStatus *status);
+
+/**
+ * Evaluates all splines of \p pool at the \p num knot values \p us like
+ * ::ts_spline_pool_eval, but on the device of \p gpu (if any). The point of
+ * the i'th spline at the k'th knot value is stored at \p points + (k *
+ * ts_spline_pool_num_splines(pool) + i) * ts_spline_pool_dimension(pool).
+ * \p capacity is the number of tsReal values \p points is able to store and
+ * must be at least:
+ *
+ *     num * ts_spline_pool_num_splines(pool) * ts_spline_pool_dimension(pool)
+ *
+ * @param[in] gpu
+ * 	The backend used for evaluation.
+ * @param[in] pool
+ * 	The pool to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The host buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity is too small.
+ * @return TS_U_UNDEFINED
+ * 	If one of the splines is not defined at one of the knot values in
+ * 	\p us.
+ * @return TS_DEVICE_ERROR
+ * 	If a device operation failed.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_gpu_pool_eval_all(tsGpu *gpu,
+	const tsSplinePool *pool, const tsReal *us, size_t num, tsReal *points,
+	size_t capacity, tsStatus *status);
+
+/**
+ * Like ::ts_gpu_pool_eval_all, but stores the resultant points in the device
+ * buffer \p buffer (cf. ::ts_gpu_eval_all_device).
+ *
+ * @param[in] gpu
+ * 	The backend used for evaluation.
+ * @param[in] pool
+ * 	The pool to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] buffer
+ * 	The device buffer to store the resultant points in.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p buffer is too small.
+ * @return TS_U_UNDEFINED
+ * 	If one of the splines is not defined at one of the knot values in
+ * 	\p us.
+ * @return TS_DEVICE_ERROR
+ * 	If \p gpu has no device, the order of the splines is not supported, or
+ * 	a device operation failed.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_gpu_pool_eval_all_device(tsGpu *gpu,
+	const tsSplinePool *pool, const tsReal *us, size_t num, void *buffer,
+	tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Surface Functions                                                        *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new surface whose data points to NULL.
+ *
+ * @return
+ * 	A new surface whose data points to NULL.
+ */
+tsBSplineSurface TINYSPLINE_API ts_bspline_surface_init();
+
+/**
+ * Creates a new surface with \p num_u * \p num_v control points and stores
+ * the result in \p surface. The knot vectors of the two directions are set
+ * up like the knot vector of ::ts_bspline_new. All control points are 0.
+ *
+ * @param[in] num_u
+ * 	The number of control points in direction u (i.e., rows).
+ * @param[in] num_v
+ * 	The number of control points in direction v (i.e., columns).
+ * @param[in] dimension
+ * 	The dimension of each control point of \p surface.
+ * @param[in] degree_u
+ * 	The degree of \p surface in direction u.
+ * @param[in] degree_v
+ * 	The degree of \p surface in direction v.
+ * @param[in] type_u
+ * 	How to setup the knot vector of direction u.
+ * @param[in] type_v
+ * 	How to setup the knot vector of direction v.
+ * @param[out] surface
+ * 	The output surface.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension == 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If \p degree_u >= \p num_u or \p degree_v >= \p num_v.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots of a direction is not supported (cf.
+ * 	::ts_bspline_new).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_surface_new(size_t num_u, size_t num_v,
+	size_t dimension, size_t degree_u, size_t degree_v,
+	tsBSplineType type_u, tsBSplineType type_v, tsBSplineSurface *surface,
+	tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The surface to deep copy.
+ * @param[out] dest
+ * 	The output surface.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_surface_copy(const tsBSplineSurface *src,
+	tsBSplineSurface *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The surface whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The surface that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_bspline_surface_move(tsBSplineSurface *src,
+	tsBSplineSurface *dest);
+
+/**
+ * Frees the data of \p surface. After calling this function, the data of
+ * \p surface points to NULL.
+ *
+ * @param[out] surface
+ * 	The surface to free.
+ */
+void TINYSPLINE_API ts_bspline_surface_free(tsBSplineSurface *surface);
+
+/**
+ * Returns the degree of \p surface in direction u.
+ *
+ * @param[in] surface
+ * 	The surface whose degree is read.
+ * @return
+ * 	The degree of \p surface in direction u.
+ */
+size_t TINYSPLINE_API ts_bspline_surface_degree_u(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the degree of \p surface in direction v.
+ *
+ * @param[in] surface
+ * 	The surface whose degree is read.
+ * @return
+ * 	The degree of \p surface in direction v.
+ */
+size_t TINYSPLINE_API ts_bspline_surface_degree_v(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the number of control points of \p surface in direction u (i.e.,
+ * the number of rows).
+ *
+ * @param[in] surface
+ * 	The surface whose number of control points is read.
+ * @return
+ * 	The number of control points of \p surface in direction u.
+ */
+size_t TINYSPLINE_API ts_bspline_surface_num_control_points_u(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the number of control points of \p surface in direction v (i.e.,
+ * the number of columns).
+ *
+ * @param[in] surface
+ * 	The surface whose number of control points is read.
+ * @return
+ * 	The number of control points of \p surface in direction v.
+ */
+size_t TINYSPLINE_API ts_bspline_surface_num_control_points_v(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the dimension of the control points of \p surface.
+ *
+ * @param[in] surface
+ * 	The surface whose dimension is read.
+ * @return
+ * 	The dimension of the control points of \p surface.
+ */
+size_t TINYSPLINE_API ts_bspline_surface_dimension(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the domain of \p surface in both directions (cf.
+ * ::ts_bspline_domain).
+ *
+ * @param[in] surface
+ * 	The surface whose domain is read.
+ * @param[out] min_u
+ * 	The minimum of the domain in direction u.
+ * @param[out] max_u
+ * 	The maximum of the domain in direction u.
+ * @param[out] min_v
+ * 	The minimum of the domain in direction v.
+ * @param[out] max_v
+ * 	The maximum of the domain in direction v.
+ */
+void TINYSPLINE_API ts_bspline_surface_domain(const tsBSplineSurface *surface,
+	tsReal *min_u, tsReal *max_u, tsReal *min_v, tsReal *max_v);
+
+/**
+ * Returns a pointer to the control points of \p surface (cf.
+ * ::tsBSplineSurface for the layout). The pointer is valid as long as
+ * \p surface is neither freed nor modified.
+ *
+ * @param[in] surface
+ * 	The surface whose pointer is returned.
+ * @return
+ * 	Pointer to the num_u * num_v * dimension control point values of
+ * 	\p surface.
+ */
+const tsReal TINYSPLINE_API *ts_bspline_surface_control_points_ptr(
+	const tsBSplineSurface *surface);
+
+/**
+ * Sets the control points of \p surface. Creates a deep copy of \p ctrlp,
+ * which must contain num_u * num_v * dimension values (cf.
+ * ::tsBSplineSurface for the layout).
+ *
+ * @param[out] surface
+ * 	The surface whose control points are set.
+ * @param[in] ctrlp
+ * 	The values to deep copy.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ */
+tsError TINYSPLINE_API ts_bspline_surface_set_control_points(
+	tsBSplineSurface *surface, const tsReal *ctrlp, tsStatus *status);
+
+/**
+ * Returns a pointer to the num_u + degree_u + 1 knots of \p surface in
+ * direction u. The pointer is valid as long as \p surface is neither freed
+ * nor modified.
+ *
+ * @param[in] surface
+ * 	The surface whose pointer is returned.
+ * @return
+ * 	Pointer to the knots of \p surface in direction u.
+ */
+const tsReal TINYSPLINE_API *ts_bspline_surface_knots_u_ptr(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns a pointer to the num_v + degree_v + 1 knots of \p surface in
+ * direction v. The pointer is valid as long as \p surface is neither freed
+ * nor modified.
+ *
+ * @param[in] surface
+ * 	The surface whose pointer is returned.
+ * @return
+ * 	Pointer to the knots of \p surface in direction v.
+ */
+const tsReal TINYSPLINE_API *ts_bspline_surface_knots_v_ptr(
+	const tsBSplineSurface *surface);
+
+/**
+ * Sets the knots of \p surface. Creates a deep copy of \p knots_u and
+ * \p knots_v. Either of them may be NULL, in which case the knots of the
+ * corresponding direction are kept. Both knot vectors are validated (cf.
+ * ::ts_bspline_set_knots) before \p surface is modified, i.e., \p surface is
+ * not modified if an error occurs.
+ *
+ * @param[out] surface
+ * 	The surface whose knots are set.
+ * @param[in] knots_u
+ * 	The knots of direction u. May be NULL.
+ * @param[in] knots_v
+ * 	The knots of direction v. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_KNOTS_DECR
+ * 	If a knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity > order of its direction.
+ */
+tsError TINYSPLINE_API ts_bspline_surface_set_knots(tsBSplineSurface *surface,
+	const tsReal *knots_u, const tsReal *knots_v, tsStatus *status);
+
+/**
+ * Evaluates \p surface at (\p u, \p v) and stores the resultant point in
+ * \p point, which must be able to store ts_bspline_surface_dimension(surface)
+ * values. Like ::ts_bspline_eval_point, points at which \p surface has a gap
+ * yield the first of the two results. Does not allocate memory unless the
+ * degrees or the number of control points of \p surface are very large.
+ *
+ * @param[in] surface
+ * 	The surface to evaluate.
+ * @param[in] u
+ * 	The knot value to evaluate in direction u.
+ * @param[in] v
+ * 	The knot value to evaluate in direction v.
+ * @param[out] point
+ * 	The buffer to store the resultant point in.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p surface is not defined at (\p u, \p v).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_surface_eval(
+	const tsBSplineSurface *surface, tsReal u, tsReal v, tsReal *point,
+	tsStatus *status);
+
+/**
+ * Evaluates \p surface at the grid \p us x \p vs and stores the resultant
+ * points row by row in \p points, that is, the point at (us[i], vs[j]) is
+ * stored at \p points + (i * \p num_v + j) * ts_bspline_surface_dimension(
+ * surface). The basis functions of \p vs are computed once for all rows, and
+ * the control points affected by us[i] are collapsed once per row into a
+ * curve in direction v, which is then evaluated at \p vs with the cached
+ * basis functions. Thus, the cost of a point amortizes to a weighted sum of
+ * degree_v + 1 points. Sorted knot values speed up the knot search (cf.
+ * ::ts_bspline_eval_all_into), but are not required.
+ *
+ * @param[in] surface
+ * 	The surface to evaluate.
+ * @param[in] us
+ * 	The knot values of the rows.
+ * @param[in] num_u
+ * 	The number of knot values in \p us.
+ * @param[in] vs
+ * 	The knot values of the columns.
+ * @param[in] num_v
+ * 	The number of knot values in \p vs.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity < \p num_u * \p num_v *
+ * 	ts_bspline_surface_dimension(surface).
+ * @return TS_U_UNDEFINED
+ * 	If \p surface is not defined at one of the knot values.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_surface_eval_grid(
+	const tsBSplineSurface *surface, const tsReal *us, size_t num_u,
+	const tsReal *vs, size_t num_v, tsReal *points, size_t capacity,
+	tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Monotone Index Functions                                                 *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new index whose data points to NULL.
+ *
+ * @return
+ * 	A new index whose data points to NULL.
+ */
+tsMonotoneIndex TINYSPLINE_API ts_monotone_index_init();
+
+/**
+ * Creates an index (cf. ::tsMonotoneIndex) for component \p index of
+ * \p spline, whose control points must be sorted at component \p index
+ * (cf. ::ts_bspline_bisect). The component is sampled at \p num_samples
+ * knots that are equally distributed in the domain of \p spline. More
+ * samples yield smaller brackets and, thus, fewer iterations per query. If
+ * \p num_samples is 0, four samples per knot span (at least two) are used.
+ *
+ * @param[in] spline
+ * 	The spline to index.
+ * @param[in] index
+ * 	The component to index.
+ * @param[in] ascending
+ * 	Indicates whether the control points of \p spline are sorted in
+ * 	ascending (!= 0) or in descending (== 0) order at component \p index.
+ * @param[in] num_samples
+ * 	The number of samples.
+ * @param[out] monotone_index
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If the dimension of the control points of \p spline <= \p index.
+ * @return TS_NUM_POINTS
+ * 	If \p num_samples == 1.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_monotone_index_new(const tsBSpline *spline,
+	size_t index, int ascending, size_t num_samples,
+	tsMonotoneIndex *monotone_index, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The index to deep copy.
+ * @param[out] dest
+ * 	The output index.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_monotone_index_copy(const tsMonotoneIndex *src,
+	tsMonotoneIndex *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The index whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The index that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_monotone_index_move(tsMonotoneIndex *src,
+	tsMonotoneIndex *dest);
+
+/**
+ * Frees the data of \p monotone_index. After calling this function, the data
+ * of \p monotone_index points to NULL.
+ *
+ * @param[out] monotone_index
+ * 	The index to free.
+ */
+void TINYSPLINE_API ts_monotone_index_free(tsMonotoneIndex *monotone_index);
+
+/**
+ * Returns the number of samples of \p monotone_index.
+ *
+ * @param[in] monotone_index
+ * 	The index whose number of samples is read.
+ * @return
+ * 	The number of samples of \p monotone_index.
+ */
+size_t TINYSPLINE_API ts_monotone_index_num_samples(
+	const tsMonotoneIndex *monotone_index);
+
+/**
+ * Finds the knot \p u at which the indexed component is closest to \p value
+ * (cf. ::ts_bspline_solve). If \p value is outside the range of the indexed
+ * component, the closest end of the domain is returned.
+ *
+ * @param[in] monotone_index
+ * 	The index to query.
+ * @param[in] value
+ * 	The value to find.
+ * @param[in] epsilon
+ * 	The maximum distance (inclusive).
+ * @param[in] persnickety
+ * 	Indicates whether TS_NO_RESULT should be returned if there is no knot
+ * 	satisfying the distance condition (!= 0 to enable, == 0 to disable).
+ * 	If disabled, the best fitting knot is returned.
+ * @param[in] max_iter
+ * 	The maximum number of iterations.
+ * @param[out] u
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NO_RESULT
+ * 	If \p persnickety is enabled (!= 0) and there is no knot satisfying
+ * 	the distance condition.
+ * @return TS_MALLOC
+ * 	If allocating memory failed (only if the degree of the indexed spline
+ * 	is very large).
+ */
+tsError TINYSPLINE_API ts_monotone_index_solve(
+	const tsMonotoneIndex *monotone_index, tsReal value, tsReal epsilon,
+	int persnickety, size_t max_iter, tsReal *u, tsStatus *status);
+
+/**
+ * Batched version of ::ts_monotone_index_solve. Finds the knots of the \p num
+ * values \p values and stores them in \p us, which must be able to store
+ * \p num values. Values that are greater than or equal to their predecessor
+ * (with respect to the order of the indexed component) continue the search
+ * at the samples of the predecessor. Accordingly, sorted values are processed
+ * in a single sweep over the samples. Does not allocate memory unless the
+ * degree of the indexed spline is very large.
+ *
+ * @param[in] monotone_index
+ * 	The index to query.
+ * @param[in] values
+ * 	The values to find.
+ * @param[in] num
+ * 	The number of values in \p values.
+ * @param[in] epsilon
+ * 	The maximum distance (inclusive).
+ * @param[in] persnickety
+ * 	Indicates whether TS_NO_RESULT should be returned if there is a value
+ * 	without knot satisfying the distance condition (!= 0 to enable, == 0
+ * 	to disable). If disabled, the best fitting knots are returned.
+ * @param[in] max_iter
+ * 	The maximum number of iterations per value.
+ * @param[out] us
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NO_RESULT
+ * 	If \p persnickety is enabled (!= 0) and there is a value without knot
+ * 	satisfying the distance condition.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_monotone_index_solve_all(
+	const tsMonotoneIndex *monotone_index, const tsReal *values,
+	size_t num, tsReal epsilon, int persnickety, size_t max_iter,
+	tsReal *us, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Projector Functions                                                      *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new projector whose data points to NULL.
+ *
+ * @return
+ * 	A new projector whose data points to NULL.
+ */
+tsProjector TINYSPLINE_API ts_projector_init();
+
+/**
+ * Creates a projector (cf. ::tsProjector) for \p spline.
+ *
+ * @param[in] spline
+ * 	The spline to project points onto.
+ * @param[out] projector
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_projector_new(const tsBSpline *spline,
+	tsProjector *projector, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The projector to deep copy.
+ * @param[out] dest
+ * 	The output projector.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_projector_copy(const tsProjector *src,
+	tsProjector *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The projector whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The projector that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_projector_move(tsProjector *src, tsProjector *dest);
+
+/**
+ * Frees the data of \p projector. After calling this function, the data of
+ * \p projector points to NULL.
+ *
+ * @param[out] projector
+ * 	The projector to free.
+ */
+void TINYSPLINE_API ts_projector_free(tsProjector *projector);
+
+/**
+ * Returns the dimension of the points that can be projected with
+ * \p projector, i.e., the dimension of the spline it was created with.
+ *
+ * @param[in] projector
+ * 	The projector whose dimension is read.
+ * @return
+ * 	The dimension of \p projector.
+ */
+size_t TINYSPLINE_API ts_projector_dimension(const tsProjector *projector);
+
+/**
+ * Finds the knot \p u of the point of the spline of \p projector that is
+ * closest to \p point, which must have the dimension of the spline. If
+ * \p closest is not NULL, the closest point itself is stored in \p closest
+ * (which must be able to store ts_projector_dimension(projector) values). If
+ * there are several closest points, any of them may be returned. Does not
+ * allocate memory unless the degree of the spline is very large.
+ *
+ * @param[in] projector
+ * 	The projector to query.
+ * @param[in] point
+ * 	The point to project.
+ * @param[out] u
+ * 	The knot of the closest point.
+ * @param[out] closest
+ * 	The closest point. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_projector_project(const tsProjector *projector,
+	const tsReal *point, tsReal *u, tsReal *closest, tsStatus *status);
+
+/**
+ * Batched version of ::ts_projector_project. Projects the \p num points
+ * \p points (stored one after another) and stores the knots of the closest
+ * points in \p us, which must be able to store \p num values. Since the
+ * closest point of the previous point is checked first, nearby consecutive
+ * points (e.g., a GPS trace) are projected faster.
+ *
+ * @param[in] projector
+ * 	The projector to query.
+ * @param[in] points
+ * 	The points to project.
+ * @param[in] num
+ * 	The number of points in \p points.
+ * @param[out] us
+ * 	The knots of the closest points.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_projector_project_all(const tsProjector *projector,
+	const tsReal *points, size_t num, tsReal *us, tsStatus *status);
+
+/**
+ * Finds the knot \p u of the point of \p spline that is closest to \p point
+ * (cf. ::ts_projector_project). Creates a temporary ::tsProjector. Thus,
+ * when projecting many points onto the same spline, create a projector once
+ * or use ::ts_bspline_project_points.
+ *
+ * @param[in] spline
+ * 	The spline to project \p point onto.
+ * @param[in] point
+ * 	The point to project.
+ * @param[out] u
+ * 	The knot of the closest point.
+ * @param[out] closest
+ * 	The closest point. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_project_point(const tsBSpline *spline,
+	const tsReal *point, tsReal *u, tsReal *closest, tsStatus *status);
+
+/**
+ * Batched version of ::ts_bspline_project_point (cf.
+ * ::ts_projector_project_all).
+ *
+ * @param[in] spline
+ * 	The spline to project \p points onto.
+ * @param[in] points
+ * 	The points to project.
+ * @param[in] num
+ * 	The number of points in \p points.
+ * @param[out] us
+ * 	The knots of the closest points.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_project_points(const tsBSpline *spline,
+	const tsReal *points, size_t num, tsReal *us, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Arc Length Functions                                                     *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new arc length table whose data points to NULL.
+ *
+ * @return
+ * 	A new arc length table whose data points to NULL.
+ */
+tsArcLength TINYSPLINE_API ts_arc_length_init();
+
+/**
+ * Creates an arc length table (cf. ::tsArcLength) for \p spline. Each Bezier
+ * segment of \p spline is split into \p num_steps parts of equal parameter
+ * length, and each part is integrated with 5-point Gauss-Legendre
+ * quadrature. If \p num_steps is 0, a default value (4) is used. More steps
+ * give more accurate lengths for segments whose speed changes a lot.
+ *
+ * @param[in] spline
+ * 	The spline to measure.
+ * @param[in] num_steps
+ * 	The number of integration steps per Bezier segment.
+ * @param[out] table
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arc_length_new(const tsBSpline *spline,
+	size_t num_steps, tsArcLength *table, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The arc length table to deep copy.
+ * @param[out] dest
+ * 	The output arc length table.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arc_length_copy(const tsArcLength *src,
+	tsArcLength *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The arc length table whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The arc length table that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_arc_length_move(tsArcLength *src, tsArcLength *dest);
+
+/**
+ * Frees the data of \p table. After calling this function, the data of
+ * \p table points to NULL.
+ *
+ * @param[out] table
+ * 	The arc length table to free.
+ */
+void TINYSPLINE_API ts_arc_length_free(tsArcLength *table);
+
+/**
+ * Returns the dimension of the spline \p table was created with.
+ *
+ * @param[in] table
+ * 	The arc length table whose dimension is read.
+ * @return
+ * 	The dimension of \p table.
+ */
+size_t TINYSPLINE_API ts_arc_length_dimension(const tsArcLength *table);
+
+/**
+ * Returns the length of the spline \p table was created with. Runs in
+ * constant time.
+ *
+ * @param[in] table
+ * 	The arc length table whose length is read.
+ * @return
+ * 	The length of the spline of \p table.
+ */
+tsReal TINYSPLINE_API ts_arc_length_length(const tsArcLength *table);
+
+/**
+ * Finds the knot \p u at which the arc length of the spline of \p table
+ * (measured from the minimum of its domain) is \p length. \p length is
+ * clamped to [0, ts_arc_length_length(table)]. The table is searched with
+ * binary search, and \p u is refined with Newton's method within the
+ * enclosing integration step. If the spline is stationary in some region
+ * of its domain (i.e., several knots yield the same arc length), the
+ * smallest knot is returned.
+ *
+ * @param[in] table
+ * 	The arc length table to query.
+ * @param[in] length
+ * 	The arc length to find the knot of.
+ * @param[out] u
+ * 	The knot at \p length.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arc_length_u_at(const tsArcLength *table,
+	tsReal length, tsReal *u, tsStatus *status);
+
+/**
+ * Batched version of ::ts_arc_length_u_at. Stores the knots at the \p num
+ * arc lengths \p lengths in \p us, which must be able to store \p num
+ * values. Ascending lengths (e.g., the frames of an animation) are found
+ * faster because the search starts at the integration step of the previous
+ * length.
+ *
+ * @param[in] table
+ * 	The arc length table to query.
+ * @param[in] lengths
+ * 	The arc lengths to find the knots of.
+ * @param[in] num
+ * 	The number of values in \p lengths.
+ * @param[out] us
+ * 	The knots at \p lengths.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arc_length_u_at_all(const tsArcLength *table,
+	const tsReal *lengths, size_t num, tsReal *us, tsStatus *status);
+
+/**
+ * Samples the spline of \p table at \p num points that are equally
+ * distributed along its arc (as opposed to ::ts_bspline_sample, which
+ * distributes the knots equally in the domain of a spline). The first and
+ * the last point are the ends of the spline. If \p num is 0, a default value
+ * (30 points per Bezier segment) is used. The number of sampled points is
+ * stored in \p actual_num. \p capacity is the number of tsReal values
+ * \p points is able to store and must be at least:
+ *
+ *     num * ts_arc_length_dimension(table)
+ *
+ * @param[in] table
+ * 	The arc length table to sample.
+ * @param[in] num
+ * 	The number of points to sample.
+ * @param[out] points
+ * 	The buffer to store the resultant points in.
+ * @param[in] capacity
+ * 	The number of tsReal values \p points is able to store.
+ * @param[out] actual_num
+ * 	The number of sampled points.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p capacity is too small.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arc_length_sample(const tsArcLength *table,
+	size_t num, tsReal *points, size_t capacity, size_t *actual_num,
+	tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Catmull-Rom Fitter Functions                                             *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new Catmull-Rom fitter whose data points to NULL.
+ *
+ * @return
+ * 	A new Catmull-Rom fitter whose data points to NULL.
+ */
+tsCatmullRomFitter TINYSPLINE_API ts_catmull_rom_fitter_init();
+
+/**
+ * Creates a Catmull-Rom fitter (cf. ::tsCatmullRomFitter) for points of
+ * dimension \p dimension. The parameters are the same as the ones of
+ * ::ts_bspline_interpolate_catmull_rom, except that the last control point
+ * of the Catmull-Rom sequence is passed to ::ts_catmull_rom_fitter_spline,
+ * because it is not known until all points have been pushed. The fitter
+ * starts without points.
+ *
+ * @param[in] dimension
+ * 	The dimensionality of the points.
+ * @param[in] alpha
+ * 	The knot parameterization: 0 => uniform, 0.5 => centripetal,
+ * 	1 => chordal. The input value is automatically trimmed to the [0, 1]
+ * 	interval.
+ * @param[in] first
+ * 	The first control point of the Catmull-Rom sequence. If NULL, an
+ * 	appropriate point is generated based on the first two points pushed
+ * 	into the fitter. Treated as NULL if the distance between \p first and
+ * 	the first pushed point is less than or equal to \p epsilon.
+ * @param[in] epsilon
+ * 	The maximum distance between points with "same" coordinates. Pushed
+ * 	points whose distance to the previous point is less than or equal to
+ * 	\p epsilon are skipped. The sign is removed with fabs.
+ * @param[out] fitter
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension is 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_catmull_rom_fitter_new(size_t dimension,
+	tsReal alpha, const tsReal *first, tsReal epsilon,
+	tsCatmullRomFitter *fitter, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The fitter to deep copy.
+ * @param[out] dest
+ * 	The output fitter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_catmull_rom_fitter_copy(
+	const tsCatmullRomFitter *src, tsCatmullRomFitter *dest,
+	tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The fitter whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The fitter that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_catmull_rom_fitter_move(tsCatmullRomFitter *src,
+	tsCatmullRomFitter *dest);
+
+/**
+ * Frees the data of \p fitter. After calling this function, the data of
+ * \p fitter points to NULL.
+ *
+ * @param[out] fitter
+ * 	The fitter to free.
+ */
+void TINYSPLINE_API ts_catmull_rom_fitter_free(tsCatmullRomFitter *fitter);
+
+/**
+ * Returns the dimension of the points of \p fitter.
+ *
+ * @param[in] fitter
+ * 	The fitter whose dimension is read.
+ * @return
+ * 	The dimension of \p fitter.
+ */
+size_t TINYSPLINE_API ts_catmull_rom_fitter_dimension(
+	const tsCatmullRomFitter *fitter);
+
+/**
+ * Returns the number of points accepted by \p fitter, i.e., the number of
+ * pushed points minus the number of skipped points.
+ *
+ * @param[in] fitter
+ * 	The fitter whose number of points is read.
+ * @return
+ * 	The number of points accepted by \p fitter.
+ */
+size_t TINYSPLINE_API ts_catmull_rom_fitter_num_points(
+	const tsCatmullRomFitter *fitter);
+
+/**
+ * Returns the number of finished segments that have not been taken from
+ * \p fitter yet (cf. ::ts_catmull_rom_fitter_take). All but the last segment
+ * are finished, that is, the segment between the last two points is not
+ * finished until the next point is pushed.
+ *
+ * @param[in] fitter
+ * 	The fitter whose number of finished segments is read.
+ * @return
+ * 	The number of finished segments of \p fitter.
+ */
+size_t TINYSPLINE_API ts_catmull_rom_fitter_num_finished(
+	const tsCatmullRomFitter *fitter);
+
+/**
+ * Pushes the \p num points \p points into \p fitter. Each accepted point
+ * finishes the segment between the second and third last accepted point.
+ * Apart from occasionally growing the buffer of the finished segments, this
+ * function runs in time linear to \p num.
+ *
+ * @param[in] fitter
+ * 	The fitter to push the points into.
+ * @param[in] points
+ * 	The points to push. Stores \p num * ts_catmull_rom_fitter_dimension
+ * 	values.
+ * @param[in] num
+ * 	The number of points in \p points.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed. The points pushed before the failing
+ * 	point are kept.
+ */
+tsError TINYSPLINE_API ts_catmull_rom_fitter_push(tsCatmullRomFitter *fitter,
+	const tsReal *points, size_t num, tsStatus *status);
+
+/**
+ * Creates the spline of the finished segments (that have not been taken) of
+ * \p fitter and the unfinished segment between the last two points. If no
+ * segment has been taken from \p fitter, the result equals the result of
+ * ::ts_bspline_interpolate_catmull_rom applied to all accepted points. As
+ * with ::ts_bspline_interpolate_catmull_rom, a spline of degree 0 is created
+ * if \p fitter has accepted a single point only.
+ *
+ * @param[in] fitter
+ * 	The fitter whose spline is created.
+ * @param[in] last
+ * 	The last control point of the Catmull-Rom sequence. If NULL, an
+ * 	appropriate point is generated based on the last two accepted points.
+ * 	Treated as NULL if the distance between \p last and the last accepted
+ * 	point is less than or equal to the epsilon of \p fitter.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p fitter has not accepted any point.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_catmull_rom_fitter_spline(
+	const tsCatmullRomFitter *fitter, const tsReal *last,
+	tsBSpline *spline, tsStatus *status);
+
+/**
+ * Moves the finished segments of \p fitter into \p segments, a sequence of
+ * cubic Bezier curves (::TS_BEZIERS). Afterwards, \p fitter stores only the
+ * points required to finish the next segments, i.e., its memory is bounded
+ * if segments are taken regularly. The buffer of the finished segments is
+ * kept for reuse.
+ *
+ * @param[in] fitter
+ * 	The fitter whose finished segments are taken.
+ * @param[out] segments
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p fitter has no finished segments.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_catmull_rom_fitter_take(tsCatmullRomFitter *fitter,
+	tsBSpline *segments, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Transformation functions                                                 *
+*                                                                             *
+* TinySpline is a library focusing on transformations. That is, most          *
+* functions are used to transform splines by modifying their state, e.g.,     *
+* their number of control points, their degree, and so on. Accordingly, each  *
+* transformation functions specifies an input and output parameter (along     *
+* with the other parameters required to calculate the actual transformation). *
+* By passing a different pointer to the output parameter, the transformation  *
+* result is calculated and stored without changing the state of the input.    *
+* This is in particular useful when dealing with errors as the original state *
+* will never be modified. For instance, let's have a look at the following    *
+* code snippet:                                                               *
+*                                                                             *
+*     tsBSpline in = ...    // an arbitrary spline                            *
+*     tsBSpline out;        // result of transformation                       *
+*                                                                             *
+*     // Subdivide 'in' into sequence of bezier curves and store the result   *
+*     // in 'out'. Does not change 'in' in any way.                           *
+*     tsError err = ts_bspline_to_beziers(&in, &out);                         *
+*     if (err != TS_SUCCESS) {                                                *
+*         // fortunately, 'in' has not been changed                           *
+*     }                                                                       *
+*                                                                             *
+* Even if 'ts_bspline_to_beziers' fails, the state of 'in' has not been       *
+* changed allowing you to handle the error properly.                          *
+*                                                                             *
+* Unless stated otherwise, the order of the parameters for transformation     *
+* functions is:                                                               *
+*                                                                             *
+*     function(input, [additional_input], output, [additional_output])        *
+*                                                                             *
+* 'additional_input' are parameters required to calculate the actual          *
+* transformation. 'additional_output' are parameters storing further result.  *
+*                                                                             *
+* Note: None of TinySpline's transformation functions frees the memory of the *
+*       output parameter. Thus, when using the same output parameter multiple *
+*       times, make sure to free memory before each call. Otherwise, you will *
+*       have a bad time with memory leaks:                                    *
+*                                                                             *
+*     tsBSpline in = ...                  // an arbitrary spline              *
+*     tsBSpline out;                      // result of transformations        *
+*                                                                             *
+*     ts_bspline_to_beziers(&in, &out);    // first transformation            *
+*     ...                                  // some code                       *
+*     ts_bspline_free(&out);               // avoid memory leak.              *
+*     ts_bspline_tension(&in, 0.85, &out); // next transformation             *
+*                                                                             *
+* If you want to modify your input directly without having a separate output, *
+* pass it as input and output at once:                                        *
+*                                                                             *
+*     tsBSpline s = ...                       // an arbitrary spline          *
+*     tsReal *knots = ...                     // a knot vector                *
+*                                                                             *
+*     ts_bspline_set_knots(&s, knots, &s);    // copy 'knots' into 's'        *
+*                                                                             *
+* Note: If a transformation function fails *and* input != output, all fields  *
+*       of the output parameter are set to 0/NULL. If input == output, your   *
+*       input may have an invalid state in case of errors.                    *
+*                                                                             *
+* Transformations in place (input == output) reuse the memory of the spline *
+* and do not copy it beforehand. Transformations that enlarge a spline, for   *
+* example, ts_bspline_insert_knot and ts_bspline_split, make use of its       *
+* capacity (see ts_bspline_reserve) and grow it geometrically if necessary.   *
+* Thus, refining a spline in place reallocates memory only occasionally:      *
+*                                                                             *
+*     ts_bspline_reserve(&s, 1000, &status);  // optional                     *
+*     ts_bspline_insert_knot(&s, u, 1, &s, &k, &status);                      *
+*                                                                             *
+******************************************************************************/
+/**
+ * Returns the \p n'th derivative of \p spline and stores the result in
+ * \p derivative. Creates a deep copy of \p spline if
+ * \p spline != \p derivative. For more details, see:
+ * 
+ *     http://www.cs.mtu.edu/~shene/COURSES/cs3621/NOTES/spline/B-spline/bspline-derv.html
+ *
+ * The derivative of a spline _s_ of degree _d_ (_d_ > 0) with _m_ control
+ * points and _n_ knots is another spline _s'_ of degree _d-1_ with _m-1_
+ * control points and _n-2_ knots, defined over _s_ as:
+ * 
+ * \f{eqnarray*}{
+ *   s'(u) &=& \sum_{i=0}^{n-1} N_{i+1,p-1}(u) *
+ * 		(P_{i+1} - P_{i}) * p / (u_{i+p+1}-u_{i+1}) \\
+ *         &=& \sum_{i=1}^{n} N_{i,p-1}(u) *
+ * 		(P_{i} - P_{i-1}) * p / (u_{i+p}-u_{i})
+ * \f}
+ * 
+ * If _s_ has a clamped knot vector, it can be shown that:
+ * 
+ * \f{eqnarray*}{
+ *   s'(u) &=& \sum_{i=0}^{n-1} N_{i,p-1}(u) *
+ * 		(P_{i+1} - P_{i}) * p / (u_{i+p+1}-u_{i+1})
+ * \f}
+ * 
+ * where the multiplicity of the first and the last knot value _u_ is _p_
+ * rather than _p+1_. The derivative of a point (degree == 0) is another point
+ * with coordinate 0.
+ *
+ * @param[in] spline
+ * 	The spline to derive.
+ * @param[in] n
+ * 	The number of derivations.
+ * @param[in] epsilon
+ * 	The maximum distance of discontinuous points. If negative,
+ * 	discontinuity is ignored and the derivative is computed based on the
+ * 	first result of the corresponding DeBoorNet.
+ * @param[out] derivative
+ *	The derivative of \p spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_UNDERIVABLE
+ * 	If \p spline is discontinuous at an internal knot and the distance
+ * 	between the corresponding points is greater than \p epsilon.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_derive(const tsBSpline *spline, size_t n,
+	tsReal epsilon, tsBSpline *derivative, tsStatus *status);
+
+/**
+ * Returns the \p n'th derivative of \p spline (cf. ::ts_bspline_derive)
+ * from a cache stored alongside \p spline. Missing derivatives are computed
+ * on demand, so repeatedly evaluating the derivatives of a spline does not
+ * copy the spline each time. All functions modifying the control points or
+ * knots of \p spline (e.g., ::ts_bspline_set_control_points,
+ * ::ts_bspline_set_knot_at, or in-place transformations) invalidate the
+ * cache, as does passing an \p epsilon different from the one used to fill
+ * it. If \p n == 0, \p spline itself is returned.
+ *
+ * The returned spline is owned by \p spline. It must not be freed and stays
+ * valid until \p spline is modified or freed, ::ts_bspline_clear_cache is
+ * called, or the cache is invalidated by this function. Since this function
+ * modifies the cache, it is not thread-safe with respect to \p spline and
+ * \p spline must not be the spline of a view (cf. ::ts_bspline_view_binary).
+ *
+ * @param[in] spline
+ * 	The spline whose derivative is returned.
+ * @param[in] n
+ * 	The number of derivations.
+ * @param[in] epsilon
+ * 	Passed to ::ts_bspline_derive.
+ * @param[out] derivative
+ * 	Points to the \p n'th derivative of \p spline on success.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_UNDERIVABLE
+ * 	If \p spline (or one of its derivatives) is discontinuous at an
+ * 	internal knot and the distance between the corresponding points is
+ * 	greater than \p epsilon.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_cached_derivative(tsBSpline *spline,
+	size_t n, tsReal epsilon, const tsBSpline **derivative,
+	tsStatus *status);
+
+/**
+ * Frees the derivatives cached by ::ts_bspline_cached_derivative. Does
+ * nothing if the cache of \p spline is empty.
+ *
+ * @param[in] spline
+ * 	The spline whose cache is cleared.
+ */
+void TINYSPLINE_API ts_bspline_clear_cache(tsBSpline *spline);
+
+/**
+ * Inserts \p knot \p num times into the knot vector of \p spline and stores
+ * the result in \p result. Creates a deep copy of \p spline if \p spline !=
+ * \p result. The operation fails if \p result would have an invalid knot
+ * vector ( i.e., multiplicity(\p knot) > order(\p result) ).
+ * 
+ * @param[in] spline
+ * 	The spline into which \p knot is inserted \p num times.
+ * @param[in] knot
+ * 	The knot to insert.
+ * @param[in] num
+ * 	How many times \p knot should be inserted.
+ * @param[out] result
+ * 	The output spline.
+ * @param[out] k
+ * 	Stores the last index of \p knot in \p result.
+ * @param status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p knot is not within the domain of \p spline.
+ * @return TS_MULTIPLICITY
+ * 	If the multiplicity of \p knot in \p spline plus \p num is greater than
+ * 	the order of \p spline.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_insert_knot(const tsBSpline *spline,
+	tsReal knot, size_t num, tsBSpline *result, size_t *k,
+	tsStatus *status);
+
+/**
+ * Splits \p spline at knot value \p u and stores the result in \p split. That
+ * is, \p u is inserted _n_ times such that the multiplicity of \p u is equal
+ * to the \p spline's order. Creates a deep copy of \p spline if
+ * \p spline != \p split.
+ * 
+ * @param[in] spline
+ * 	The spline to split.
+ * @param[in] u
+ * 	The split point (knot).
+ * @param[out] split
+ * 	The split spline.
+ * @param[out] k
+ * 	Stores the last index of \p u in \p split.
+ * @param[out] status
+ * 	Stores the last index of \p u in \p result.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_split(const tsBSpline *spline, tsReal u,
+	tsBSpline *split, size_t *k, tsStatus *status);
+
+/**
+ * Inserts the \p num knots \p knots into the knot vector of \p spline and
+ * stores the result in \p out (knot refinement). In contrast to calling
+ * ::ts_bspline_insert_knot for each knot, \p out is allocated only once and
+ * all new control points are computed in a single sweep from back to front
+ * (algorithm A5.4 of "The NURBS Book"). \p knots does not need to be sorted
+ * and may contain duplicates. Knots that are equal to a knot of \p spline
+ * (see ::ts_knots_equal) are snapped to this knot. Creates a deep copy of
+ * \p spline if \p spline != \p out.
+ *
+ * @param[in] spline
+ * 	The spline to refine.
+ * @param[in] knots
+ * 	The knots to insert.
+ * @param[in] num
+ * 	The number of knots in \p knots.
+ * @param[out] out
+ * 	The refined spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If a knot of \p knots is not within the domain of \p spline.
+ * @return TS_MULTIPLICITY
+ * 	If the multiplicity of a knot in \p out would be greater than the
+ * 	order of \p spline.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_refine_knots(const tsBSpline *spline,
+	const tsReal *knots, size_t num, tsBSpline *out, tsStatus *status);
+
+/**
+ * Removes as many internal knots from \p spline as possible such that the
+ * resultant spline \p out deviates from \p spline by at most \p tolerance
+ * and stores the result in \p out (spline simplification). Useful to get rid
+ * of redundant knots and control points that accumulate in the course of
+ * functions such as ::ts_bspline_align, ::ts_bspline_elevate_degree,
+ * ::ts_bspline_to_beziers, and ::ts_bspline_split. Knots are removed one at a
+ * time with algorithm A5.8 of "The NURBS Book". Each removal yields an upper
+ * bound of the deviation it causes in the affected knot spans. These bounds
+ * are accumulated per knot span, and a knot is removed only if the
+ * accumulated bound of all affected knot spans remains within \p tolerance.
+ * Since the bound is conservative, the actual deviation is usually smaller
+ * than \p tolerance. Pass ::TS_CONTROL_POINT_EPSILON to remove redundant
+ * knots only (i.e., without changing the shape of \p spline). Creates a deep
+ * copy of \p spline if \p spline != \p out.
+ *
+ * @param[in] spline
+ * 	The spline to simplify.
+ * @param[in] tolerance
+ * 	The maximum deviation between \p spline and \p out. If negative, no
+ * 	knot is removed.
+ * @param[out] out
+ * 	The simplified spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_remove_knots(const tsBSpline *spline,
+	tsReal tolerance, tsBSpline *out, tsStatus *status);
+
+/**
+ * Sets the control points of \p spline so that their tension corresponds the
+ * given tension factor (0 => yields to a line connecting the first and the
+ * last control point; 1 => keeps the original shape). If \p tension < 0 or if
+ * \p tension > 1, the behaviour of this function is undefined, though, it will
+ * not result in an error. Creates a deep copy of \p spline if
+ * \p spline != \p out.
+ *
+ * This function is based on:
+ * 
+ *      Holten, Danny. "Hierarchical edge bundles: Visualization of adjacency
+ *      relations in hierarchical data." Visualization and Computer Graphics,
+ *      IEEE Transactions on 12.5 (2006): 741-748.
+ * 
+ * Holten calls it "straightening" (page 744, equation 1).
+ *
+ * @param[in] spline
+ * 	The input spline.
+ * @param[in] tension
+ * 	The tension factor (0 <= \p tension <= 1).
+ * @param[out] out
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_tension(const tsBSpline *spline,
+	tsReal tension, tsBSpline *out, tsStatus *status);
+
+/**
+ * Decomposes \p spline into a sequence of Bezier curves by splitting it at
+ * each internal knot value. Creates a deep copy of \p spline if
+ * \p spline != \p beziers. All knots are inserted at once with
+ * ::ts_bspline_refine_knots, that is, the decomposition takes linear time and
+ * allocates \p beziers only once.
+ * 
+ * @param[in] spline
+ * 	The spline to decompose.
+ * @param[out] beziers
+ * 	The bezier decomposition of \p spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_to_beziers(const tsBSpline *spline,
+	tsBSpline *beziers, tsStatus *status);
+
+/**
+ * Decomposes \p spline into a sequence of Bezier curves like
+ * ::ts_bspline_to_beziers, but passes the segments to \p sink one at a time
+ * (from first to last) instead of storing them in a spline. Thus, the
+ * decomposition requires constant memory (for splines of reasonable degree
+ * and dimension no memory is allocated at all). The control points passed to
+ * \p sink are equal to the ones stored by ::ts_bspline_to_beziers (up to
+ * rounding).
+ *
+ * @param[in] spline
+ * 	The spline to decompose.
+ * @param[in] sink
+ * 	Receives the segments of \p spline.
+ * @param[in] data
+ * 	Passed to \p sink.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ * @return other
+ * 	The error returned by \p sink.
+ */
+tsError TINYSPLINE_API ts_bspline_to_beziers_stream(const tsBSpline *spline,
+	tsBezierSink sink, void *data, tsStatus *status);
+
+/**
+ * Elevates the degree of \p spline by \p amount and stores the result in
+ * \p elevated. If \p spline != \p elevated, the internal state of \p spline is
+ * not modified, that is, \p elevated is a new, independent ::tsBSpline
+ * instance. The bezier segments of \p spline are elevated at once (algorithm
+ * A5.9 of "The NURBS Book") directly into the memory of \p elevated.
+ *
+ * @param[in] spline
+ * 	The spline to elevate.
+ * @param[in] amount
+ * 	How often to elevate the degree of \p spline.
+ * @param[in] epsilon
+ * 	In order to elevate the degree of a spline, it must be decomposed into
+ * 	a sequence of bezier curves (see ::ts_bspline_to_beziers). After degree
+ * 	elevation, the split points of the bezier curves are merged again. This
+ * 	parameter is used to distinguish between the split points of the
+ * 	decomposition process and the wanted discontinuity points. A viable
+ * 	default value is ::TS_CONTROL_POINT_EPSILON.
+ * @param[out] elevated
+ * 	The elevated spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If memory allocation failed.
+ */
+tsError TINYSPLINE_API ts_bspline_elevate_degree(const tsBSpline *spline,
 	size_t amount, tsReal epsilon, tsBSpline *elevated, tsStatus *status);
 
+/**
+ * Like ::ts_bspline_elevate_degree, but splits the bezier segments of
+ * \p spline into chunks of \p grain_size segments and passes the elevation of
+ * the chunks, as tasks, to \p executor. The segments are independent of each
+ * other, i.e., the tasks can be processed concurrently. If \p executor is
+ * NULL, the tasks are processed serially by the calling thread. If
+ * \p grain_size is 0, a default is taken as fallback.
+ *
+ * @param[in] spline
+ * 	The spline to elevate.
+ * @param[in] amount
+ * 	How often to elevate the degree of \p spline.
+ * @param[in] epsilon
+ * 	See ::ts_bspline_elevate_degree.
+ * @param[out] elevated
+ * 	The elevated spline.
+ * @param[in] grain_size
+ * 	The (maximum) number of bezier segments elevated by a single task.
+ * @param[in] executor
+ * 	The executor running the tasks. May be NULL.
+ * @param[in] executor_data
+ * 	The user data passed to \p executor. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_KNOTS
+ * 	If the elevated spline has more than ::TS_MAX_NUM_KNOTS knots.
+ * @return TS_MALLOC
+ * 	If memory allocation failed.
+ */
+tsError TINYSPLINE_API ts_bspline_elevate_degree_parallel(
+	const tsBSpline *spline, size_t amount, tsReal epsilon,
+	tsBSpline *elevated, size_t grain_size, tsExecutor executor,
+	void *executor_data, tsStatus *status);
+
+/**
+ * Elevates the \p num splines \p splines to the highest degree among them
+ * and stores the result in \p elevated (e.g., to prepare a sequence of
+ * keyframes for ::ts_bspline_morph or ::ts_alignment_plan_new). The splines
+ * are split into chunks of \p grain_size splines, which are passed, as
+ * tasks, to \p executor. If \p executor is NULL, the tasks are processed
+ * serially by the calling thread. If \p grain_size is 0, each task elevates
+ * a single spline. \p elevated may be equal to \p splines (in-place
+ * elevation), but must not overlap with \p splines otherwise. If this
+ * function fails, the splines of \p elevated that have been elevated so far
+ * remain valid, the others (if \p splines != \p elevated) point to NULL. In
+ * either case, the splines of \p elevated must be freed by the caller.
+ *
+ * @param[in] splines
+ * 	The splines to elevate.
+ * @param[in] num
+ * 	The number of splines in \p splines (and \p elevated).
+ * @param[in] epsilon
+ * 	See ::ts_bspline_elevate_degree.
+ * @param[out] elevated
+ * 	The elevated splines.
+ * @param[in] grain_size
+ * 	The (maximum) number of splines elevated by a single task.
+ * @param[in] executor
+ * 	The executor running the tasks. May be NULL.
+ * @param[in] executor_data
+ * 	The user data passed to \p executor. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_KNOTS
+ * 	If an elevated spline has more than ::TS_MAX_NUM_KNOTS knots. If
+ * 	multiple tasks fail, the error of the task with the lowest index is
+ * 	reported.
+ * @return TS_MALLOC
+ * 	If memory allocation failed.
+ */
+tsError TINYSPLINE_API ts_bspline_elevate_to_common_degree(
+	const tsBSpline *splines, size_t num, tsReal epsilon,
+	tsBSpline *elevated, size_t grain_size, tsExecutor executor,
+	void *executor_data, tsStatus *status);
+
 /**
  * Modifies the splines \p s1 and \p s2 such that they have same degree and
  * number of control points/knots (without modifying the shape of \p s1 and
@@ -1860,15 +5481,282 @@ tsError TINYSPLINE_API ts_bspline_elevate_degree(const tsBSpline *spline,
  * \p s2 and \p s2_out.
  *
  * @param[in] s1
- * 	The spline which is to be aligned with \p s2.
+ * 	The spline which is to be aligned with \p s2.
+ * @param[in] s2
+ * 	The spline which is to be aligned with \p s1.
+ * @param[int] epsilon
+ * 	Spline alignment relies on degree elevation. This parameter is used in
+ * 	::ts_bspline_elevate_degree to check whether two control points, \c p1
+ * 	and \c p2, are "equal", that is, the distance between \c p1 and \c p2
+ * 	is less than or equal to \p epsilon. A viable default value is
+ * 	::TS_CONTROL_POINT_EPSILON.
+ * @param[out] s1_out
+ * 	The aligned version of \p s1.
+ * @param[out] s2_out
+ * 	The aligned version of \p s2.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If memory allocation failed.
+ */
+tsError TINYSPLINE_API ts_bspline_align(const tsBSpline *s1,
+	const tsBSpline *s2, tsReal epsilon, tsBSpline *s1_out,
+	tsBSpline *s2_out, tsStatus *status);
+
+/**
+ * Interpolates between \p start and \p end with respect to the time parameter
+ * \p t (domain: [0, 1]). The resulting spline is stored in \p out. if \p t is
+ * less than 0, it is interpreted as 0. If \p t is greater than 1, it is
+ * interpreted as 1. That is, \p is limited to the domain [0, 1]. Because it is
+ * to be expected that this function is called several times in a row (e.g., to
+ * have a smooth transition from one spline to another), memory for \p out is
+ * allocated only if it points to NULL or if its degree, dimension, or number
+ * of control points does not match the interpolated spline. This way, this
+ * function can be used as follows:
+ *
+ *     tsReal t;
+ *     tsBSpline start = ...
+ *     tsBSpline end = ...
+ *     tsBSpline morph = ts_bspline_init();
+ *     for (t = (tsReal) 0.0; t <= (tsReal) 1.0; t += (tsReal) 0.001)
+ *         ts_bspline_morph(&start, &end, t, ..., &morph, ...);
+ *     ts_bspline_free(&morph);
+ *
+ * It should be noted that this function aligns \p start and \p end using
+ * ::ts_bspline_align if necessary. In order to avoid the overhead of spline
+ * alignment, \p start and \p end should be aligned in advance (e.g., with
+ * ::ts_morphism_new).
+ *
+ * If \p start and \p end have different dimensions, \p out has the lower
+ * of both dimensions and the surplus components of the control points of
+ * the other spline are ignored. That is, morphing a 3D spline into a 2D
+ * spline yields the same result as morphing its projection onto the xy-plane
+ * into the 2D spline.
+ *
+ * @param[in] start
+ * 	The origin spline.
+ * @param[in] end
+ * 	The target spline.
+ * @param[in] t
+ * 	The time parameter. If 0, \p out becomes \p start. If 1, \p out becomes
+ * 	\p end. The value of this parameter is automatically limited to the
+ * 	domain [0. 1].
+ * @param[in] epsilon
+ * 	If \p start and \p end must be aligned, this parameter is passed
+ * 	::ts_bspline_elevate_degree to check whether two control points, \c p1
+ * 	and \c p2, are "equal", that is, the distance between \c p1 and \c p2
+ * 	is less than or equal to \p epsilon. A viable default value is
+ * 	::TS_CONTROL_POINT_EPSILON.
+ * @param[out] out
+ * 	The resulting spline.
+ * @return[out] TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If memory allocation failed.
+ */
+tsError TINYSPLINE_API ts_bspline_morph(const tsBSpline *start,
+	const tsBSpline *end, tsReal t, tsReal epsilon, tsBSpline *out,
+	tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Collection Functions                                                     *
+*                                                                             *
+* The following functions apply a transformation to each spline of a          *
+* collection (e.g., a batch of stored splines). Failures are reported per     *
+* spline, that is, a spline that cannot be transformed does not abort the     *
+* transformation of the others.                                               *
+*                                                                             *
+******************************************************************************/
+/**
+ * Applies \p op (cf. ::tsBSplineOp) to each of the \p num splines
+ * \p splines and stores the results in \p results. The splines are split
+ * into chunks of \p grain_size splines, which are passed, as tasks, to
+ * \p executor. If \p executor is NULL, the tasks are processed serially by
+ * the calling thread. If \p grain_size is 0, each task transforms a single
+ * spline. \p results may be equal to \p splines (in-place transformation,
+ * provided that \p op supports \p spline == \p out), but must not overlap
+ * with \p splines otherwise.
+ *
+ * All splines are processed, even if some of them cannot be transformed. If
+ * \p statuses is not NULL, it receives the status of each spline. A spline
+ * of \p results whose transformation failed points to NULL (or, if
+ * \p results == \p splines, is left as is). In either case, the splines of
+ * \p results must be freed by the caller.
+ *
+ * @param[in] splines
+ * 	The splines to transform.
+ * @param[in] num
+ * 	The number of splines in \p splines (and \p results and \p statuses).
+ * @param[in] op
+ * 	The transformation to apply.
+ * @param[in] args
+ * 	The user data passed to \p op. May be NULL.
+ * @param[out] results
+ * 	The transformed splines.
+ * @param[out] statuses
+ * 	The status of each spline. May be NULL.
+ * @param[in] grain_size
+ * 	The (maximum) number of splines transformed by a single task.
+ * @param[in] executor
+ * 	The executor running the tasks. May be NULL.
+ * @param[in] executor_data
+ * 	The user data passed to \p executor. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL. If the transformation of
+ * 	one or more splines failed, receives the status of the first of
+ * 	them.
+ * @return TS_SUCCESS
+ * 	If all splines have been transformed.
+ * @return TS_MALLOC
+ * 	If memory allocation failed (before any spline has been transformed).
+ * @return any
+ * 	The error of the first spline that could not be transformed.
+ */
+tsError TINYSPLINE_API ts_bspline_map(const tsBSpline *splines, size_t num,
+	tsBSplineOp op, const void *args, tsBSpline *results,
+	tsStatus *statuses, size_t grain_size, tsExecutor executor,
+	void *executor_data, tsStatus *status);
+
+/**
+ * Operation (cf. ::tsBSplineOp) calling ::ts_bspline_derive with the fields
+ * \c n and \c epsilon of \p args (a ::tsBSplineOpArgs).
+ */
+tsError TINYSPLINE_API ts_bspline_op_derive(const tsBSpline *spline,
+	const void *args, tsBSpline *out, tsStatus *status);
+
+/**
+ * Operation (cf. ::tsBSplineOp) calling ::ts_bspline_split with the field
+ * \c value of \p args (a ::tsBSplineOpArgs).
+ */
+tsError TINYSPLINE_API ts_bspline_op_split(const tsBSpline *spline,
+	const void *args, tsBSpline *out, tsStatus *status);
+
+/**
+ * Operation (cf. ::tsBSplineOp) calling ::ts_bspline_tension with the field
+ * \c value of \p args (a ::tsBSplineOpArgs).
+ */
+tsError TINYSPLINE_API ts_bspline_op_tension(const tsBSpline *spline,
+	const void *args, tsBSpline *out, tsStatus *status);
+
+/**
+ * Operation (cf. ::tsBSplineOp) calling ::ts_bspline_to_beziers. \p args is
+ * ignored.
+ */
+tsError TINYSPLINE_API ts_bspline_op_to_beziers(const tsBSpline *spline,
+	const void *args, tsBSpline *out, tsStatus *status);
+
+/**
+ * Operation (cf. ::tsBSplineOp) calling ::ts_bspline_elevate_degree with the
+ * fields \c n and \c epsilon of \p args (a ::tsBSplineOpArgs).
+ */
+tsError TINYSPLINE_API ts_bspline_op_elevate_degree(const tsBSpline *spline,
+	const void *args, tsBSpline *out, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Alignment Plan Functions                                                 *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new plan whose data points to NULL.
+ *
+ * @return
+ * 	A new plan whose data points to NULL.
+ */
+tsAlignmentPlan TINYSPLINE_API ts_alignment_plan_init();
+
+/**
+ * Computes how \p s1 and \p s2 are aligned by ::ts_bspline_align and stores
+ * the result in \p plan (cf. ::tsAlignmentPlan). Only the degrees and knots
+ * of \p s1 and \p s2 are taken into account. Accordingly, unlike
+ * ::ts_bspline_align, adjacent bezier segments are merged during degree
+ * elevation only if the spline is continuous at their common knot by
+ * construction (multiplicity < order), not if their control points happen
+ * to coincide.
+ *
+ * @param[in] s1
+ * 	The spline whose degree and knots are used as first input.
+ * @param[in] s2
+ * 	The spline whose degree and knots are used as second input.
+ * @param[in] epsilon
+ * 	Passed to ::ts_bspline_align. A viable default value is
+ * 	::TS_CONTROL_POINT_EPSILON.
+ * @param[out] plan
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_alignment_plan_new(const tsBSpline *s1,
+	const tsBSpline *s2, tsReal epsilon, tsAlignmentPlan *plan,
+	tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The plan to deep copy.
+ * @param[out] dest
+ * 	The output plan.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_alignment_plan_copy(const tsAlignmentPlan *src,
+	tsAlignmentPlan *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The plan whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The plan that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_alignment_plan_move(tsAlignmentPlan *src,
+	tsAlignmentPlan *dest);
+
+/**
+ * Frees the data of \p plan. After calling this function, the data of
+ * \p plan points to NULL.
+ *
+ * @param[out] plan
+ * 	The plan to free.
+ */
+void TINYSPLINE_API ts_alignment_plan_free(tsAlignmentPlan *plan);
+
+/**
+ * Aligns \p s1 and \p s2 according to \p plan and stores the result in
+ * \p s1_out and \p s2_out. \p s1 and \p s2 must have the degrees and knots
+ * of the splines \p plan was created with. \p s1_out and \p s2_out must
+ * either be initialized with ::ts_bspline_init or be valid splines (e.g.,
+ * created by a previous call of this function), in which case their memory
+ * is reused if they have the degree, dimension, and number of control points
+ * of the aligned splines. Just like ::ts_bspline_align, \p s2 is not aligned
+ * if \p s1_out == \p s2_out.
+ *
+ * @param[in] plan
+ * 	The plan to apply.
+ * @param[in] s1
+ * 	The spline to align with \p s2.
  * @param[in] s2
- * 	The spline which is to be aligned with \p s1.
- * @param[int] epsilon
- * 	Spline alignment relies on degree elevation. This parameter is used in
- * 	::ts_bspline_elevate_degree to check whether two control points, \c p1
- * 	and \c p2, are "equal", that is, the distance between \c p1 and \c p2
- * 	is less than or equal to \p epsilon. A viable default value is
- * 	::TS_CONTROL_POINT_EPSILON.
+ * 	The spline to align with \p s1.
  * @param[out] s1_out
  * 	The aligned version of \p s1.
  * @param[out] s2_out
@@ -1877,78 +5765,493 @@ tsError TINYSPLINE_API ts_bspline_elevate_degree(const tsBSpline *spline,
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_INCOMPATIBLE
+ * 	If the degree or the knots of \p s1 or \p s2 differ from the degrees
+ * 	or the knots of \p plan.
  * @return TS_MALLOC
- * 	If memory allocation failed.
+ * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_align(const tsBSpline *s1,
-	const tsBSpline *s2, tsReal epsilon, tsBSpline *s1_out,
+tsError TINYSPLINE_API ts_alignment_plan_apply(const tsAlignmentPlan *plan,
+	const tsBSpline *s1, const tsBSpline *s2, tsBSpline *s1_out,
 	tsBSpline *s2_out, tsStatus *status);
 
+
+
+/******************************************************************************
+*                                                                             *
+* :: Morphism Functions                                                       *
+*                                                                             *
+******************************************************************************/
 /**
- * Interpolates between \p start and \p end with respect to the time parameter
- * \p t (domain: [0, 1]). The resulting spline is stored in \p out. if \p t is
- * less than 0, it is interpreted as 0. If \p t is greater than 1, it is
- * interpreted as 1. That is, \p is limited to the domain [0, 1]. Because it is
- * to be expected that this function is called several times in a row (e.g., to
- * have a smooth transition from one spline to another), memory for \p out is
- * allocated only if it points to NULL. This way, this function can be used as
- * follows:
- *
- *     tsReal t;
- *     tsBSpline start = ...
- *     tsBSpline end = ...
- *     tsBSpline morph = ts_bspline_init();
- *     for (t = (tsReal) 0.0; t <= (tsReal) 1.0; t += (tsReal) 0.001)
- *         ts_bspline_morph(&start, &end, t, ..., &morph, ...);
- *     ts_bspline_free(&morph);
+ * Creates a new morphism whose data points to NULL.
  *
- * It should be noted that this function aligns \p start and \p end using
- * ::ts_bspline_align if necessary. In order to avoid the overhead of spline
- * alignment, \p start and \p end should be aligned in advance.
+ * @return
+ * 	A new morphism whose data points to NULL.
+ */
+tsMorphism TINYSPLINE_API ts_morphism_init();
+
+/**
+ * Aligns \p start and \p end (if necessary) and stores the aligned splines
+ * in \p morphism (cf. ::tsMorphism).
+ * If \p start and \p end have different dimensions, the interpolated splines
+ * have the lower of both dimensions (cf. ::ts_bspline_morph).
  *
  * @param[in] start
  * 	The origin spline.
  * @param[in] end
  * 	The target spline.
- * @param[in] t
- * 	The time parameter. If 0, \p out becomes \p start. If 1, \p out becomes
- * 	\p end. The value of this parameter is automatically limited to the
- * 	domain [0. 1].
  * @param[in] epsilon
- * 	If \p start and \p end must be aligned, this parameter is passed
- * 	::ts_bspline_elevate_degree to check whether two control points, \c p1
- * 	and \c p2, are "equal", that is, the distance between \c p1 and \c p2
- * 	is less than or equal to \p epsilon. A viable default value is
- * 	::TS_CONTROL_POINT_EPSILON.
+ * 	Passed to ::ts_bspline_align if \p start and \p end must be aligned.
+ * 	A viable default value is ::TS_CONTROL_POINT_EPSILON.
+ * @param[out] morphism
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_morphism_new(const tsBSpline *start,
+	const tsBSpline *end, tsReal epsilon, tsMorphism *morphism,
+	tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The morphism to deep copy.
+ * @param[out] dest
+ * 	The output morphism.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_morphism_copy(const tsMorphism *src,
+	tsMorphism *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The morphism whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The morphism that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_morphism_move(tsMorphism *src, tsMorphism *dest);
+
+/**
+ * Frees the data of \p morphism. After calling this function, the data of
+ * \p morphism points to NULL.
+ *
+ * @param[out] morphism
+ * 	The morphism to free.
+ */
+void TINYSPLINE_API ts_morphism_free(tsMorphism *morphism);
+
+/**
+ * Replaces the splines of \p morphism with \p start and \p end, which must
+ * have the same degrees and knots as the splines passed to the first call of
+ * this function, but may have different control points (e.g., the next pair
+ * of keyframes of an animation). The first call computes an alignment plan
+ * (cf. ::tsAlignmentPlan) with the epsilon \p morphism was created with.
+ * Subsequent calls apply this plan, which avoids the allocations and
+ * intermediate splines of ::ts_bspline_align and reuses the memory of the
+ * splines of \p morphism.
+ *
+ * @param[out] morphism
+ * 	The morphism to update.
+ * @param[in] start
+ * 	The new origin spline.
+ * @param[in] end
+ * 	The new target spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INCOMPATIBLE
+ * 	If the degree or the knots of \p start or \p end differ from the
+ * 	splines passed to the first call of this function.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_morphism_update(tsMorphism *morphism,
+	const tsBSpline *start, const tsBSpline *end, tsStatus *status);
+
+/**
+ * Interpolates the splines of \p morphism with respect to the time parameter
+ * \p t (cf. ::ts_bspline_morph) and stores the result in \p out. The memory
+ * of \p out is reused if it has the degree, dimension, and number of control
+ * points of the interpolated spline. Thus, evaluating a morphism repeatedly
+ * with the same output spline allocates memory at most once:
+ *
+ *     tsMorphism morphism = ts_morphism_init();
+ *     tsBSpline frame = ts_bspline_init();
+ *     ts_morphism_new(&start, &end, TS_CONTROL_POINT_EPSILON, &morphism,
+ *         NULL);
+ *     for (t = (tsReal) 0.0; t <= (tsReal) 1.0; t += (tsReal) 0.001) {
+ *         ts_morphism_eval(&morphism, t, &frame, NULL);
+ *         ...
+ *     }
+ *     ts_bspline_free(&frame);
+ *     ts_morphism_free(&morphism);
+ *
+ * @param[in] morphism
+ * 	The morphism to evaluate.
+ * @param[in] t
+ * 	The time parameter. Is limited to the domain [0, 1].
  * @param[out] out
  * 	The resulting spline.
- * @return[out] TS_SUCCESS
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_morphism_eval(const tsMorphism *morphism, tsReal t,
+	tsBSpline *out, tsStatus *status);
+
+/**
+ * Evaluates \p morphism at the \p num time parameters \p ts and stores the
+ * resulting splines in \p outs (e.g., to bake keyframes). Each spline of \p
+ * outs must either be initialized with ::ts_bspline_init or have been
+ * created by a previous call of this function (or ::ts_morphism_eval), in
+ * which case its memory is reused. If this function fails, the splines that
+ * have been computed so far remain valid and must be freed by the caller.
+ *
+ * @param[in] morphism
+ * 	The morphism to evaluate.
+ * @param[in] ts
+ * 	The time parameters.
+ * @param[in] num
+ * 	The number of time parameters in \p ts (and splines in \p outs).
+ * @param[out] outs
+ * 	The resulting splines.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_morphism_eval_all(const tsMorphism *morphism,
+	const tsReal *ts, size_t num, tsBSpline *outs, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Serialization and Persistence Functions                                  *
+*                                                                             *
+* The following section contains functions to serialize and persist the data  *
+* types listed above.                                                         *
+*                                                                             *
+******************************************************************************/
+/**
+ * Serializes \p spline to a null-terminated JSON string and stores the result
+ * in \p json. The output is pretty-printed (see ::ts_bspline_write_json).
+ *
+ * Note: Earlier versions formatted each value with 17 significant digits
+ * (\c %1.17g). Now, values are formatted with the least number of digits
+ * that restore the exact same value (see ::ts_bspline_write_json). The
+ * output is shorter, but the digits may differ from those of earlier
+ * versions (e.g., 0.1 instead of 0.10000000000000001).
+ *
+ * @param[in] spline
+ * 	The spline to serialize.
+ * @param[out] json
+ * 	The serialized JSON string.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_PARSE_ERROR
+ * 	If \p spline contains NaN or infinity.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_to_json(const tsBSpline *spline, char **json,
+	tsStatus *status);
+
+/**
+ * Writes \p spline in JSON format to \p file. The output is produced
+ * directly, that is, without building a document tree in memory. Each value
+ * is formatted with the least number of significant digits that are
+ * required to read back the exact same value, e.g., 0.1 (rather than
+ * 0.10000000000000001). The digits are generated with Grisu3 (with a
+ * fallback to \c sprintf for the few values that Grisu3 rejects) and
+ * written like \c %g. If \p pretty is 0, the output contains no
+ * whitespace at all. Otherwise, line breaks and indentation are inserted.
+ * File descriptors can be wrapped with \c fdopen (POSIX).
+ *
+ * @param[in] spline
+ * 	The spline to serialize.
+ * @param[in] file
+ * 	The file to write to.
+ * @param[in] pretty
+ * 	Insert line breaks and indentation?
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If writing \p file failed.
+ * @return TS_PARSE_ERROR
+ * 	If \p spline contains NaN or infinity.
+ */
+tsError TINYSPLINE_API ts_bspline_write_json(const tsBSpline *spline,
+	FILE *file, int pretty, tsStatus *status);
+
+/**
+ * Like ::ts_bspline_write_json, but writes to the caller-provided buffer \p
+ * buf of \p size chars. Similar to \c snprintf, at most \p size - 1 chars
+ * are written to \p buf, followed by a terminating null character (if \p
+ * size is greater than 0). \p len is set to the length of the JSON string,
+ * excluding the null character, regardless of \p size. That is, if \p len
+ * is greater or equals to \p size, the output has been truncated and
+ * another call with a buffer of \p len + 1 chars is required. \p buf may be
+ * NULL if \p size is 0.
+ *
+ * @param[in] spline
+ * 	The spline to serialize.
+ * @param[out] buf
+ * 	The buffer to write to.
+ * @param[in] size
+ * 	The size of \p buf.
+ * @param[in] pretty
+ * 	Insert line breaks and indentation?
+ * @param[out] len
+ * 	The length of the (untruncated) JSON string.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success (even if the output has been truncated).
+ * @return TS_PARSE_ERROR
+ * 	If \p spline contains NaN or infinity.
+ */
+tsError TINYSPLINE_API ts_bspline_write_json_buffer(const tsBSpline *spline,
+	char *buf, size_t size, int pretty, size_t *len, tsStatus *status);
+
+/**
+ * Parses \p json and stores the result in \p spline.
+ *
+ * @param[in] json
+ * 	The JSON string to parse.
+ * @param[out] spline
+ * 	The deserialized spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_PARSE_ERROR
+ * 	If an error occurred while parsing \p json.
+ * @return TS_DIM_ZERO
+ * 	If the dimension is 0.
+ * @return TS_LCTRLP_DIM_MISMATCH
+ * 	If the length of the control point vector modulo dimension is not 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots stored in \p json does not match to the number
+ * 	of control points and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_parse_json(const char *json,
+	tsBSpline *spline, tsStatus *status);
+
+/**
+ * Saves \p spline as (pretty-printed) JSON ASCII file. See
+ * ::ts_bspline_write_json. Like ::ts_bspline_to_json, the values are
+ * formatted with the least number of digits that restore the exact same
+ * value (rather than with 17 significant digits as in earlier versions).
+ *
+ * @param[in] spline
+ * 	The spline to save.
+ * @param[in] path
+ * 	Path of the JSON file.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If an error occurred while saving \p spline.
+ * @return TS_PARSE_ERROR
+ * 	If \p spline contains NaN or infinity.
+ */
+tsError TINYSPLINE_API ts_bspline_save(const tsBSpline *spline,
+	const char *path, tsStatus *status);
+
+/**
+ * Loads \p spline from a JSON ASCII file.
+ *
+ * @param[in] path
+ * 	Path of the JSON file.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[ou] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If \p path does not exist.
+ * @return TS_PARSE_ERROR
+ * 	If an error occurred while parsing the contents of \p path.
+ * @return TS_DIM_ZERO
+ * 	If the dimension is 0.
+ * @return TS_LCTRLP_DIM_MISMATCH
+ * 	If the length of the control point vector modulo dimension is not 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots stored in \p json does not match to the number
+ * 	of control points and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_load(const char *path, tsBSpline *spline,
+	tsStatus *status);
+
+/**
+ * Parses the first spline object of \p json and stores the result in
+ * \p spline. In contrast to ::ts_bspline_parse_json, this function does not
+ * build a DOM of \p json. Instead, \p json is read in a single pass and the
+ * numbers of `control_points` and `knots` are written straight into the
+ * state of \p spline, which reduces the peak memory usage considerably. The
+ * schema of \p json is the same as for ::ts_bspline_parse_json (unknown keys
+ * are skipped). If \p end is not NULL, it is set to the character following
+ * the parsed object. Thus, multiple splines (e.g., newline-delimited JSON)
+ * can be parsed as follows:
+ *
+ *     const char *pos = json;
+ *     while (*pos) {
+ *         ts_bspline_read_json(pos, &spline, &pos, &status);
+ *         ...
+ *         ts_bspline_free(&spline);
+ *         while (isspace(*pos)) pos++;
+ *     }
+ *
+ * @param[in] json
+ * 	The JSON string to parse.
+ * @param[out] spline
+ * 	The deserialized spline.
+ * @param[out] end
+ * 	The character following the parsed object. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
  * 	On success.
+ * @return TS_PARSE_ERROR
+ * 	If an error occurred while parsing \p json.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots stored in \p json does not match to the number
+ * 	of control points and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
  * @return TS_MALLOC
- * 	If memory allocation failed.
+ * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_morph(const tsBSpline *start,
-	const tsBSpline *end, tsReal t, tsReal epsilon, tsBSpline *out,
-	tsStatus *status);
-
+tsError TINYSPLINE_API ts_bspline_read_json(const char *json,
+	tsBSpline *spline, const char **end, tsStatus *status);
 
+/**
+ * Like ::ts_bspline_read_json, but reads the next spline object from
+ * \p file, which is not read beyond the closing brace of the object. Leading
+ * whitespace (including newlines) is skipped. If the end of \p file is
+ * reached before an object starts, \p eof is set to 1 and \p spline points to
+ * NULL. Accordingly, a stream of splines (e.g., newline-delimited JSON) can be
+ * read as follows:
+ *
+ *     int eof;
+ *     while (!ts_bspline_read_json_file(file, &spline, &eof, &status)
+ *             && !eof) {
+ *         ...
+ *         ts_bspline_free(&spline);
+ *     }
+ *
+ * @param[in] file
+ * 	The file to read.
+ * @param[out] spline
+ * 	The deserialized spline.
+ * @param[out] eof
+ * 	Set to 1 if the end of \p file has been reached, 0 otherwise.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If reading \p file failed.
+ * @return TS_PARSE_ERROR
+ * 	If an error occurred while parsing the contents of \p file.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots does not match to the number of control points
+ * 	and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_read_json_file(FILE *file,
+	tsBSpline *spline, int *eof, tsStatus *status);
 
-/******************************************************************************
-*                                                                             *
-* :: Serialization and Persistence Functions                                  *
-*                                                                             *
-* The following section contains functions to serialize and persist the data  *
-* types listed above.                                                         *
-*                                                                             *
-******************************************************************************/
 /**
- * Serializes \p spline to a null-terminated JSON string and stores the result
- * in \p json.
+ * Serializes \p spline to a compact binary representation and stores the
+ * result in \p binary (\p size is set to the number of bytes of \p binary).
+ * In contrast to ::ts_bspline_to_json, the control points and knots are
+ * copied verbatim, that is, neither formatting nor rounding takes place. The
+ * binary format (version 1) consists of a header of 40 bytes followed by the
+ * control points and the knots:
+ *
+ *     Offset | Size | Content
+ *     -------|------|-----------------------------------------------------
+ *          0 |    4 | Magic number: 'T', 'S', 'B', 'S'
+ *          4 |    1 | Version: 1
+ *          5 |    1 | Precision: sizeof(tsReal), i.e., 4 (float) or 8
+ *          6 |    1 | Byte order of the reals: 1 (little) or 2 (big endian)
+ *          7 |    1 | Reserved: 0
+ *          8 |    8 | Degree
+ *         16 |    8 | Dimension
+ *         24 |    8 | Number of control points (n_ctrlp)
+ *         32 |    8 | Number of knots (n_knots)
+ *         40 |      | n_ctrlp * dimension reals: the control points
+ *            |      | n_knots reals: the knots
+ *
+ * The integers of the header are unsigned and stored in little endian byte
+ * order. The reals are stored in the byte order of the machine that
+ * serialized \p spline. Because the size of the header is a multiple of 8,
+ * the reals are properly aligned if \p binary is (e.g., if \p binary is
+ * allocated with malloc or memory-mapped). The layout of the reals matches the
+ * memory layout of ::tsBSpline.
  *
  * @param[in] spline
  * 	The spline to serialize.
- * @param[out] json
- * 	The serialized JSON string.
+ * @param[out] binary
+ * 	The serialized binary data.
+ * @param[out] size
+ * 	The number of bytes of \p binary.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
@@ -1956,14 +6259,19 @@ tsError TINYSPLINE_API ts_bspline_morph(const tsBSpline *start,
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_to_json(const tsBSpline *spline, char **json,
-	tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_to_binary(const tsBSpline *spline,
+	unsigned char **binary, size_t *size, tsStatus *status);
 
 /**
- * Parses \p json and stores the result in \p spline.
- *
- * @param[in] json
- * 	The JSON string to parse.
+ * Parses the binary data \p binary with \p size bytes (cf.
+ * ::ts_bspline_to_binary) and stores the result in \p spline. Binary data
+ * serialized on machines with a different precision or byte order is
+ * converted accordingly.
+ *
+ * @param[in] binary
+ * 	The binary data to parse.
+ * @param[in] size
+ * 	The number of bytes of \p binary.
  * @param[out] spline
  * 	The deserialized spline.
  * @param[out] status
@@ -1971,15 +6279,14 @@ tsError TINYSPLINE_API ts_bspline_to_json(const tsBSpline *spline, char **json,
  * @return TS_SUCCESS
  * 	On success.
  * @return TS_PARSE_ERROR
- * 	If an error occurred while parsing \p json.
+ * 	If \p binary is not in the binary format, has an unsupported version,
+ * 	or is too short.
  * @return TS_DIM_ZERO
  * 	If the dimension is 0.
- * @return TS_LCTRLP_DIM_MISMATCH
- * 	If the length of the control point vector modulo dimension is not 0.
  * @return TS_DEG_GE_NCTRLP
  * 	If the degree is greater or equals to the number of control points.
  * @return TS_NUM_KNOTS
- * 	If the number of knots stored in \p json does not match to the number
+ * 	If the number of knots stored in \p binary does not match to the number
  * 	of control points and the degree of the spline.
  * @return TS_KNOTS_DECR
  * 	If the knot vector is decreasing.
@@ -1988,62 +6295,429 @@ tsError TINYSPLINE_API ts_bspline_to_json(const tsBSpline *spline, char **json,
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_parse_json(const char *json,
-	tsBSpline *spline, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_parse_binary(const unsigned char *binary,
+	size_t size, tsBSpline *spline, tsStatus *status);
 
 /**
- * Saves \p spline as JSON ASCII file.
+ * Saves \p spline as binary file (cf. ::ts_bspline_to_binary).
  *
  * @param[in] spline
  * 	The spline to save.
  * @param[in] path
- * 	Path of the JSON file.
+ * 	Path of the binary file.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
  * @return TS_IO_ERROR
  * 	If an error occurred while saving \p spline.
- * @return TS_MALLOC
- * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_save(const tsBSpline *spline,
+tsError TINYSPLINE_API ts_bspline_save_binary(const tsBSpline *spline,
 	const char *path, tsStatus *status);
 
 /**
- * Loads \p spline from a JSON ASCII file.
+ * Loads \p spline from a binary file (cf. ::ts_bspline_parse_binary).
  *
  * @param[in] path
- * 	Path of the JSON file.
+ * 	Path of the binary file.
  * @param[out] spline
  * 	The output spline.
- * @param[ou] status
+ * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
  * @return TS_IO_ERROR
- * 	If \p path does not exist.
+ * 	If \p path does not exist or could not be read.
  * @return TS_PARSE_ERROR
- * 	If an error occurred while parsing the contents of \p path.
+ * 	If the contents of \p path are not in the binary format.
  * @return TS_DIM_ZERO
  * 	If the dimension is 0.
- * @return TS_LCTRLP_DIM_MISMATCH
- * 	If the length of the control point vector modulo dimension is not 0.
  * @return TS_DEG_GE_NCTRLP
  * 	If the degree is greater or equals to the number of control points.
  * @return TS_NUM_KNOTS
- * 	If the number of knots stored in \p json does not match to the number
+ * 	If the number of knots does not match to the number of control points
+ * 	and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_load_binary(const char *path,
+	tsBSpline *spline, tsStatus *status);
+
+/**
+ * Creates a read-only view (cf. ::tsBSplineView) of the binary data \p binary
+ * with \p size bytes (cf. ::ts_bspline_to_binary) without copying the
+ * control points and knots of the serialized spline. This allows, for
+ * example, to use splines straight out of a memory-mapped file. The header of
+ * the binary format and the layout of the control points and knots are
+ * designed to match the memory layout of ::tsBSpline on 64-bit little endian
+ * machines, which is a prerequisite of this function. Furthermore, the
+ * precision of \p binary must match ::tsReal and \p binary must be aligned
+ * to 8 bytes (e.g., memory returned by malloc or mmap is). Binary data not
+ * fulfilling these requirements can be parsed with
+ * ::ts_bspline_parse_binary instead. The degree, number of knots, and knot
+ * vector of \p binary are validated (which, in contrast to parsing, takes
+ * place in a single read-only pass).
+ *
+ * @param[in] binary
+ * 	The binary data to view. Must remain valid (and unmodified) as long as
+ * 	\p view is used.
+ * @param[in] size
+ * 	The number of bytes of \p binary.
+ * @param[out] view
+ * 	The view of \p binary.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_PARSE_ERROR
+ * 	If \p binary is not in the binary format, has an unsupported version,
+ * 	or is too short.
+ * @return TS_INCOMPATIBLE
+ * 	If the precision, byte order, or alignment of \p binary does not
+ * 	match the memory layout of ::tsBSpline on this machine.
+ * @return TS_DIM_ZERO
+ * 	If the dimension is 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots stored in \p binary does not match to the number
  * 	of control points and the degree of the spline.
  * @return TS_KNOTS_DECR
  * 	If the knot vector is decreasing.
  * @return TS_MULTIPLICITY
  * 	If there is a knot with multiplicity greater than order.
+ */
+tsError TINYSPLINE_API ts_bspline_view_binary(const unsigned char *binary,
+	size_t size, tsBSplineView *view, tsStatus *status);
+
+/**
+ * Returns the read-only spline of \p view.
+ *
+ * @param[in] view
+ * 	The view.
+ * @return
+ * 	The viewed spline.
+ */
+const tsBSpline TINYSPLINE_API *ts_bspline_view_spline(
+	const tsBSplineView *view);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Archive Functions                                                        *
+*                                                                             *
+* The following section contains functions to store a large number of splines *
+* in a single file (cf. ::tsArchive).                                         *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new archive whose data points to NULL.
+ *
+ * @return
+ * 	A new archive whose data points to NULL.
+ */
+tsArchive TINYSPLINE_API ts_archive_init();
+
+/**
+ * Opens the archive file \p path, which is created if it does not exist. If
+ * \p path exists but is read-only, the archive is opened in read-only mode,
+ * that is, ::ts_archive_append fails with ::TS_IO_ERROR. Only the index of
+ * the archive is read by this function. The splines are read on demand.
+ *
+ * @param[in] path
+ * 	Path of the archive file.
+ * @param[out] archive
+ * 	The opened archive.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If \p path could not be opened or created.
+ * @return TS_PARSE_ERROR
+ * 	If \p path is not an archive or its index is corrupted.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_load(const char *path, tsBSpline *spline,
+tsError TINYSPLINE_API ts_archive_open(const char *path, tsArchive *archive,
 	tsStatus *status);
 
+/**
+ * Returns the number of splines stored in \p archive (including the splines
+ * appended, but not yet flushed).
+ *
+ * @param[in] archive
+ * 	The archive whose number of splines is read.
+ * @return
+ * 	The number of splines of \p archive.
+ */
+size_t TINYSPLINE_API ts_archive_num_splines(const tsArchive *archive);
+
+/**
+ * Appends \p spline to \p archive using the (unique) identifier \p id. The
+ * spline is written to the end of the archive file immediately, but the
+ * index of \p archive is not written until ::ts_archive_flush (or
+ * ::ts_archive_free) is called. Appending splines in ascending order of
+ * \p id is slightly faster.
+ *
+ * @param[in] archive
+ * 	The archive to append \p spline to.
+ * @param[in] id
+ * 	The identifier of \p spline.
+ * @param[in] spline
+ * 	The spline to append.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If writing \p spline failed (e.g., if \p archive is read-only).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_archive_append(tsArchive *archive, size_t id,
+	const tsBSpline *spline, tsStatus *status);
+
+/**
+ * Writes the index of \p archive if splines have been appended since the
+ * last flush. The new index is written behind the splines before the header
+ * of the archive file is updated, so that a failed flush leaves the
+ * previous state of the archive intact.
+ *
+ * @param[in] archive
+ * 	The archive to flush.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If an id has been appended more than once.
+ * @return TS_IO_ERROR
+ * 	If writing the index failed.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_archive_flush(tsArchive *archive, tsStatus *status);
+
+/**
+ * Returns the id of the spline at position \p index of \p archive. The
+ * splines of an archive are ordered by id. Together with
+ * ::ts_archive_load_at, this function allows to iterate over the splines of
+ * an archive without loading more than one spline at a time.
+ *
+ * @param[in] archive
+ * 	The archive to read.
+ * @param[in] index
+ * 	Position of the spline.
+ * @param[out] id
+ * 	Id of the spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If \p index >= ts_archive_num_splines(archive) or if an id has been
+ * 	appended more than once.
+ */
+tsError TINYSPLINE_API ts_archive_id_at(tsArchive *archive, size_t index,
+	size_t *id, tsStatus *status);
+
+/**
+ * Loads the spline at position \p index of \p archive (cf.
+ * ::ts_archive_id_at).
+ *
+ * @param[in] archive
+ * 	The archive to read.
+ * @param[in] index
+ * 	Position of the spline.
+ * @param[out] spline
+ * 	The loaded spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If \p index >= ts_archive_num_splines(archive) or if an id has been
+ * 	appended more than once.
+ * @return TS_IO_ERROR
+ * 	If reading the spline failed.
+ * @return TS_PARSE_ERROR
+ * 	If the spline is corrupted (cf. ::ts_bspline_parse_binary).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_archive_load_at(tsArchive *archive, size_t index,
+	tsBSpline *spline, tsStatus *status);
+
+/**
+ * Loads the spline with identifier \p id from \p archive. Only the binary
+ * data of the requested spline is read from the archive file.
+ *
+ * @param[in] archive
+ * 	The archive to read.
+ * @param[in] id
+ * 	Id of the spline.
+ * @param[out] spline
+ * 	The loaded spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INDEX_ERROR
+ * 	If \p archive does not contain \p id or if an id has been appended more
+ * 	than once.
+ * @return TS_IO_ERROR
+ * 	If reading the spline failed.
+ * @return TS_PARSE_ERROR
+ * 	If the spline is corrupted (cf. ::ts_bspline_parse_binary).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_archive_load(tsArchive *archive, size_t id,
+	tsBSpline *spline, tsStatus *status);
+
+/**
+ * Flushes (cf. ::ts_archive_flush, errors are ignored) and closes \p archive
+ * and frees its memory. Afterwards, the data of \p archive points to NULL.
+ * If \p archive already points to NULL, this function does nothing.
+ *
+ * @param[out] archive
+ * 	The archive to free.
+ */
+void TINYSPLINE_API ts_archive_free(tsArchive *archive);
+
+/**
+ * Creates a read-only view (cf. ::ts_bspline_view_binary) of the spline with
+ * identifier \p id stored in the archive \p data with \p size bytes (e.g., a
+ * memory-mapped archive file). The index of the archive is searched in place.
+ * Neither the index nor the spline is copied.
+ *
+ * @param[in] data
+ * 	The archive data. Must be aligned to 8 bytes and must remain valid (and
+ * 	unmodified) as long as \p view is used.
+ * @param[in] size
+ * 	The number of bytes of \p data.
+ * @param[in] id
+ * 	Id of the spline.
+ * @param[out] view
+ * 	The view of the spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_PARSE_ERROR
+ * 	If \p data is not an archive or is corrupted.
+ * @return TS_INDEX_ERROR
+ * 	If the archive does not contain \p id.
+ * @return TS_INCOMPATIBLE
+ * 	If the spline cannot be viewed on this machine (cf.
+ * 	::ts_bspline_view_binary).
+ */
+tsError TINYSPLINE_API ts_archive_view(const unsigned char *data,
+	size_t size, size_t id, tsBSplineView *view, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Memory Management Functions                                              *
+*                                                                             *
+* By default, TinySpline allocates memory with malloc, realloc, and free.     *
+* The following section contains functions to install a custom allocator.     *
+* The allocator is global, that is, it is shared by all threads. Memory must  *
+* be freed with the allocator it was allocated with.                          *
+*                                                                             *
+******************************************************************************/
+/**
+ * Sets the allocator that is used by all functions of TinySpline to
+ * allocate, reallocate, and free memory (including the memory of the output
+ * arrays of, e.g., ::ts_bspline_control_points and ::ts_bspline_sample).
+ * Passing NULL restores the default allocator (malloc, realloc, and free).
+ * The allocator must not be changed while other threads are using
+ * TinySpline, and memory allocated with the previous allocator must not be
+ * passed to TinySpline afterwards (e.g., to ::ts_bspline_free).
+ *
+ * @param[in] allocator
+ * 	The allocator to use. May be NULL.
+ */
+void TINYSPLINE_API ts_set_allocator(const tsAllocator *allocator);
+
+/**
+ * Stores the allocator that is currently used by TinySpline in \p
+ * allocator. Useful to restore the current allocator after installing
+ * another one temporarily.
+ *
+ * @param[out] allocator
+ * 	The current allocator.
+ */
+void TINYSPLINE_API ts_get_allocator(tsAllocator *allocator);
+
+/**
+ * Frees \p ptr with the allocator that is currently used by TinySpline. Use
+ * this function in place of \c free to release the output arrays of
+ * TinySpline if a custom allocator is installed.
+ *
+ * @param[in] ptr
+ * 	The memory to free. May be NULL.
+ */
+void TINYSPLINE_API ts_free(void *ptr);
+
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Statistics Functions                                                     *
+*                                                                             *
+* If TinySpline is built with TINYSPLINE_ENABLE_STATS (CMake option of the    *
+* same name), the calls of the hot path functions are recorded (cf.           *
+* tsStatsFunction), as are the bytes allocated and the knot search            *
+* iterations. Otherwise, the functions are not instrumented at all and the    *
+* functions of this section are no-ops. The statistics are global and not     *
+* synchronized, that is, they are meant for profiling and are approximate if  *
+* TinySpline is used by multiple threads concurrently.                        *
+*                                                                             *
+******************************************************************************/
+/**
+ * Returns whether TinySpline has been built with \c TINYSPLINE_ENABLE_STATS.
+ *
+ * @return 1
+ * 	If statistics are recorded.
+ * @return 0
+ * 	If statistics are not recorded.
+ */
+int TINYSPLINE_API ts_stats_enabled();
+
+/**
+ * Copies the current statistics into \p stats. If statistics are not
+ * recorded, all counters of \p stats are 0.
+ *
+ * @param[out] stats
+ * 	The current statistics.
+ */
+void TINYSPLINE_API ts_stats_snapshot(tsStats *stats);
+
+/**
+ * Resets all counters of the statistics to 0.
+ */
+void TINYSPLINE_API ts_stats_reset();
+
+/**
+ * Sets the callbacks of the statistics (cf. ::tsStatsHooks). Passing NULL
+ * removes the callbacks. Like the allocator (cf. ::ts_set_allocator), the
+ * callbacks must not be changed while other threads are using TinySpline.
+ * Has no effect if statistics are not recorded.
+ *
+ * @param[in] hooks
+ * 	The callbacks to use. May be NULL.
+ */
+void TINYSPLINE_API ts_set_stats_hooks(const tsStatsHooks *hooks);
+
 
 
 /******************************************************************************
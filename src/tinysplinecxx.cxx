@@ -3,6 +3,16 @@
 #include <stdexcept>
 #include <cstdio>
 #include <sstream>
+#include <cstring>
+
+/* The built-in thread pool requires C++11. */
+#if (__cplusplus >= 201103L || \
+		(defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)) && \
+		!defined(TINYSPLINE_EMSCRIPTEN)
+#define TINYSPLINECXX_THREADS
+#include <atomic>
+#include <thread>
+#endif
 
 /* Suppress some useless MSVC warnings. */
 #ifdef _MSC_VER
@@ -31,6 +41,47 @@
 #define std_real_vector_read(var) var.
 #endif
 
+/******************************************************************************
+*                                                                             *
+* RealView                                                                    *
+*                                                                             *
+******************************************************************************/
+tinyspline::RealView::RealView(const tinyspline::real *data, size_t size)
+: _data(data), _size(size)
+{}
+
+tinyspline::real tinyspline::RealView::operator[](size_t index) const
+{
+	return _data[index];
+}
+
+const tinyspline::real * tinyspline::RealView::data() const
+{
+	return _data;
+}
+
+size_t tinyspline::RealView::size() const
+{
+	return _size;
+}
+
+const tinyspline::real * tinyspline::RealView::begin() const
+{
+	return _data;
+}
+
+const tinyspline::real * tinyspline::RealView::end() const
+{
+	return _data + _size;
+}
+
+std::vector<tinyspline::real> tinyspline::RealView::toVector() const
+{
+	return std::vector<tinyspline::real>(begin(), end());
+}
+
+
+
 /******************************************************************************
 *                                                                             *
 * DeBoorNet                                                                   *
@@ -50,6 +101,14 @@ tinyspline::DeBoorNet::DeBoorNet(const tinyspline::DeBoorNet &other)
 		throw std::runtime_error(status.message);
 }
 
+#ifdef TINYSPLINECXX_MOVE
+tinyspline::DeBoorNet::DeBoorNet(tinyspline::DeBoorNet &&other) noexcept
+: net(ts_deboornet_init())
+{
+	ts_deboornet_move(&other.net, &net);
+}
+#endif
+
 tinyspline::DeBoorNet::~DeBoorNet()
 {
 	ts_deboornet_free(&net);
@@ -69,6 +128,18 @@ tinyspline::DeBoorNet & tinyspline::DeBoorNet::operator=(
 	return *this;
 }
 
+#ifdef TINYSPLINECXX_MOVE
+tinyspline::DeBoorNet & tinyspline::DeBoorNet::operator=(
+	tinyspline::DeBoorNet &&other) noexcept
+{
+	if (&other != this) {
+		ts_deboornet_free(&net);
+		ts_deboornet_move(&other.net, &net);
+	}
+	return *this;
+}
+#endif
+
 tinyspline::real tinyspline::DeBoorNet::knot() const
 {
 	return ts_deboornet_knot(&net);
@@ -105,7 +176,7 @@ std::vector<tinyspline::real> tinyspline::DeBoorNet::points() const
 	tinyspline::real *end = begin + num_points * dimension();
 	std::vector<tinyspline::real> vec =
 		std::vector<tinyspline::real>(begin, end);
-	free(points);
+	ts_free(points);
 	return vec;
 }
 
@@ -120,10 +191,22 @@ std::vector<tinyspline::real> tinyspline::DeBoorNet::result() const
 	tinyspline::real *end = begin + num_result * dimension();
 	std::vector<tinyspline::real> vec =
 		std::vector<tinyspline::real>(begin, end);
-	free(result);
+	ts_free(result);
 	return vec;
 }
 
+tinyspline::RealView tinyspline::DeBoorNet::pointsView() const
+{
+	return tinyspline::RealView(ts_deboornet_points_ptr(&net),
+		ts_deboornet_len_points(&net));
+}
+
+tinyspline::RealView tinyspline::DeBoorNet::resultView() const
+{
+	return tinyspline::RealView(ts_deboornet_result_ptr(&net),
+		ts_deboornet_len_result(&net));
+}
+
 tsDeBoorNet * tinyspline::DeBoorNet::data()
 {
 	return &net;
@@ -192,6 +275,68 @@ std::string tinyspline::Domain::toString() const
 
 
 
+/******************************************************************************
+*                                                                             *
+* Thread Pool                                                                 *
+*                                                                             *
+******************************************************************************/
+namespace {
+#ifdef TINYSPLINECXX_THREADS
+struct TaskQueue {
+	std::atomic<size_t> next;
+	size_t numTasks;
+	tsTask task;
+	void *context;
+};
+
+void processTasks(TaskQueue *queue)
+{
+	size_t index;
+	while ((index = queue->next++) < queue->numTasks)
+		queue->task(queue->context, index);
+}
+#endif
+
+/* Executor (cf. ::tsExecutor) running the tasks with the number of threads
+ * `data' is pointing to (0 = number of hardware threads). The calling thread
+ * is one of them. Tasks are processed serially if threads are unavailable. */
+void threadPoolExecutor(void *data, size_t numTasks, tsTask task,
+	void *context)
+{
+	size_t numThreads = *static_cast<size_t *>(data);
+#ifdef TINYSPLINECXX_THREADS
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency();
+	if (numThreads > numTasks)
+		numThreads = numTasks;
+	TaskQueue queue;
+	queue.next = 0;
+	queue.numTasks = numTasks;
+	queue.task = task;
+	queue.context = context;
+	std::vector<std::thread> workers;
+	try {
+		workers.reserve(numThreads);
+		for (size_t i = 1; i < numThreads; i++)
+			workers.push_back(std::thread(processTasks, &queue));
+	} catch (...) {
+		/* Process the remaining tasks with the threads that have been
+		 * started so far. */
+	}
+	processTasks(&queue);
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+#else
+	(void) numThreads;
+	for (size_t i = 0; i < numTasks; i++)
+		task(context, i);
+#endif
+}
+}
+
+
+
+
 /******************************************************************************
 *                                                                             *
 * BSpline                                                                     *
@@ -222,6 +367,14 @@ tinyspline::BSpline::BSpline(const tinyspline::BSpline &other)
 		throw std::runtime_error(status.message);
 }
 
+#ifdef TINYSPLINECXX_MOVE
+tinyspline::BSpline::BSpline(tinyspline::BSpline &&other) noexcept
+: spline(ts_bspline_init())
+{
+	ts_bspline_move(&other.spline, &spline);
+}
+#endif
+
 tinyspline::BSpline::BSpline(size_t numControlPoints, size_t dimension,
 	size_t degree, tinyspline::BSpline::type type)
 : spline(ts_bspline_init())
@@ -280,6 +433,24 @@ tinyspline::BSpline tinyspline::BSpline::interpolateCatmullRom(
 	return BSpline(data);
 }
 
+tinyspline::BSpline tinyspline::BSpline::approximate(
+	const std_real_vector_in points, size_t dimension,
+	size_t numControlPoints, size_t degree, tsReal tolerance)
+{
+	if (dimension == 0)
+		throw std::runtime_error("unsupported dimension: 0");
+	if (std_real_vector_read(points)size() % dimension != 0)
+		throw std::runtime_error("#points % dimension != 0");
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_approximate(std_real_vector_read(points)data(),
+			std_real_vector_read(points)size()/dimension,
+			dimension, numControlPoints, degree, tolerance,
+			&data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
 tinyspline::BSpline tinyspline::BSpline::parseJson(std::string json)
 {
 	tsBSpline data = ts_bspline_init();
@@ -298,6 +469,28 @@ tinyspline::BSpline tinyspline::BSpline::load(std::string path)
 	return BSpline(data);
 }
 
+tinyspline::BSpline tinyspline::BSpline::fromBinary(
+	const std::vector<unsigned char> &binary)
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	/* data() of an empty vector may be NULL. */
+	const unsigned char empty = 0;
+	if (ts_bspline_parse_binary(binary.empty() ? &empty : &binary[0],
+			binary.size(), &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::loadBinary(std::string path)
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_load_binary(path.c_str(), &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
 tinyspline::BSpline & tinyspline::BSpline::operator=(
 	const tinyspline::BSpline &other)
 {
@@ -312,6 +505,18 @@ tinyspline::BSpline & tinyspline::BSpline::operator=(
 	return *this;
 }
 
+#ifdef TINYSPLINECXX_MOVE
+tinyspline::BSpline & tinyspline::BSpline::operator=(
+	tinyspline::BSpline &&other) noexcept
+{
+	if (&other != this) {
+		ts_bspline_free(&spline);
+		ts_bspline_move(&other.spline, &spline);
+	}
+	return *this;
+}
+#endif
+
 tinyspline::DeBoorNet tinyspline::BSpline::operator()(tinyspline::real u) const
 {
 	return eval(u);
@@ -343,7 +548,7 @@ std::vector<tinyspline::real> tinyspline::BSpline::controlPoints() const
 	tinyspline::real *end = begin + num_ctrlp * dimension();
 	std::vector<tinyspline::real> vec =
 		std::vector<tinyspline::real>(begin, end);
-	free(ctrlp);
+	ts_free(ctrlp);
 	return vec;
 }
 
@@ -356,7 +561,7 @@ std_real_vector_out tinyspline::BSpline::controlPointAt(size_t index) const
 	tinyspline::real *begin  = ctrlp;
 	tinyspline::real *end = begin + dimension();
 	std_real_vector_out vec = std_real_vector_init(begin, end);
-	free(ctrlp);
+	ts_free(ctrlp);
 	return vec;
 }
 
@@ -371,7 +576,7 @@ std::vector<tinyspline::real> tinyspline::BSpline::knots() const
 	tinyspline::real *end = begin + num_knots;
 	std::vector<tinyspline::real> vec =
 		std::vector<tinyspline::real>(begin, end);
-	free(knots);
+	ts_free(knots);
 	return vec;
 }
 
@@ -384,11 +589,28 @@ tinyspline::real tinyspline::BSpline::knotAt(size_t index) const
 	return knot;
 }
 
+tinyspline::RealView tinyspline::BSpline::controlPointsView() const
+{
+	return tinyspline::RealView(ts_bspline_control_points_ptr(&spline),
+		ts_bspline_len_control_points(&spline));
+}
+
+tinyspline::RealView tinyspline::BSpline::knotsView() const
+{
+	return tinyspline::RealView(ts_bspline_knots_ptr(&spline),
+		ts_bspline_num_knots(&spline));
+}
+
 size_t tinyspline::BSpline::numControlPoints() const
 {
 	return ts_bspline_num_control_points(&spline);
 }
 
+size_t tinyspline::BSpline::capacity() const
+{
+	return ts_bspline_capacity(&spline);
+}
+
 tinyspline::DeBoorNet tinyspline::BSpline::eval(tinyspline::real u) const
 {
 	tsDeBoorNet net = ts_deboornet_init();
@@ -411,165 +633,492 @@ std_real_vector_out tinyspline::BSpline::evalAll(
 	tinyspline::real *end = begin +
 		std_real_vector_read(us)size() * dimension();
 	std_real_vector_out vec = std_real_vector_init(begin, end);
-	free(points);
+	ts_free(points);
 	return vec;
 }
 
-std_real_vector_out tinyspline::BSpline::sample(size_t num) const
+std_real_vector_out tinyspline::BSpline::evalAll(
+	const std_real_vector_in us, size_t grainSize, size_t numThreads) const
 {
-	tinyspline::real *points;
-	size_t actualNum;
 	tsStatus status;
-	if (ts_bspline_sample(&spline, num, &points, &actualNum, &status)) {
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(us)size() * dimension());
+	if (ts_bspline_eval_all_parallel(&spline,
+			std_real_vector_read(us)data(),
+			std_real_vector_read(us)size(),
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), grainSize,
+			threadPoolExecutor, &numThreads, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
 		throw std::runtime_error(status.message);
 	}
-	tinyspline::real *begin = points;
-	tinyspline::real *end = begin + actualNum * dimension();
-	std_real_vector_out vec = std_real_vector_init(begin, end);
-	free(points);
 	return vec;
 }
 
-tinyspline::DeBoorNet tinyspline::BSpline::bisect(tinyspline::real value,
-	tinyspline::real epsilon, bool persnickety, size_t index,
-	bool ascending, size_t maxIter) const
+std_real_vector_out tinyspline::BSpline::evalDerivs(tinyspline::real u,
+	size_t n) const
 {
-	tsDeBoorNet net = ts_deboornet_init();
 	tsStatus status;
-	if (ts_bspline_bisect(&spline, value, epsilon, persnickety, index,
-			ascending, maxIter, &net, &status))
+	std_real_vector_out vec = std_real_vector_init((n + 1) * dimension());
+	if (ts_bspline_eval_derivs(&spline, u, n,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
 		throw std::runtime_error(status.message);
-	return DeBoorNet(net);
+	}
+	return vec;
 }
 
-tinyspline::Domain tinyspline::BSpline::domain() const
+std_real_vector_out tinyspline::BSpline::evalDerivsAll(
+	const std_real_vector_in us, size_t n) const
 {
-	real min, max;
-	ts_bspline_domain(&spline, &min, &max);
-	return Domain(min, max);
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(us)size() * (n + 1) * dimension());
+	if (ts_bspline_eval_derivs_all(&spline,
+			std_real_vector_read(us)data(),
+			std_real_vector_read(us)size(), n,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
 }
 
-bool tinyspline::BSpline::isClosed(tinyspline::real epsilon) const
+std_real_vector_out tinyspline::BSpline::evalDerivative(tinyspline::real u,
+	size_t n, tinyspline::real epsilon)
 {
-	int closed = 0;
+	const tsBSpline *derivative;
 	tsStatus status;
-	if (ts_bspline_is_closed(&spline, epsilon, &closed, &status))
+	if (ts_bspline_cached_derivative(&spline, n, epsilon, &derivative,
+			&status)) {
 		throw std::runtime_error(status.message);
-	return closed == 1;
+	}
+	std_real_vector_out vec = std_real_vector_init(dimension());
+	if (ts_bspline_eval_point(derivative, u,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
 }
 
-std::string tinyspline::BSpline::toJson() const
+std_real_vector_out tinyspline::BSpline::sample(size_t num) const
 {
-	char *json;
+	tinyspline::real *points;
+	size_t actualNum;
 	tsStatus status;
-	if (ts_bspline_to_json(&spline, &json, &status))
+	if (ts_bspline_sample(&spline, num, &points, &actualNum, &status)) {
 		throw std::runtime_error(status.message);
-	std::string string(json);
-	free(json);
-	return string;
+	}
+	tinyspline::real *begin = points;
+	tinyspline::real *end = begin + actualNum * dimension();
+	std_real_vector_out vec = std_real_vector_init(begin, end);
+	ts_free(points);
+	return vec;
 }
 
-void tinyspline::BSpline::save(std::string path) const
+std_real_vector_out tinyspline::BSpline::sampleFast(size_t num) const
 {
+	size_t actualNum = num;
 	tsStatus status;
-	if (ts_bspline_save(&spline, path.c_str(), &status))
+	if (actualNum == 0)
+		actualNum = (numControlPoints() - degree()) * 30;
+	std_real_vector_out vec = std_real_vector_init(
+		actualNum * dimension());
+	if (ts_bspline_sample_fast(&spline, num,
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(),
+			&actualNum, NULL, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
 		throw std::runtime_error(status.message);
+	}
+	return vec;
 }
 
-void tinyspline::BSpline::setControlPoints(
-	const std::vector<tinyspline::real> &ctrlp)
+std_real_vector_out tinyspline::BSpline::sampleAdaptive(
+	tinyspline::real tolerance) const
 {
-	size_t expected = ts_bspline_len_control_points(&spline);
-	size_t actual = ctrlp.size();
-	if (expected != actual) {
-		char expected_str[32];
-		char actual_str[32];
-		sprintf(expected_str, "%lu", (unsigned long) expected);
-		sprintf(actual_str, "%lu", (unsigned long) actual);
-		throw std::runtime_error(
-			"Expected size: " + std::string(expected_str) +
-			", Actual size: " + std::string(actual_str));
-	}
+	tinyspline::real *points = NULL;
+	size_t capacity = 0, num;
 	tsStatus status;
-	if (ts_bspline_set_control_points(&spline, ctrlp.data(), &status))
+	if (ts_bspline_sample_adaptive(&spline, tolerance, &points, &capacity,
+			&num, &status)) {
+		ts_free(points);
 		throw std::runtime_error(status.message);
+	}
+	tinyspline::real *begin = points;
+	tinyspline::real *end = begin + num * dimension();
+	std_real_vector_out vec = std_real_vector_init(begin, end);
+	ts_free(points);
+	return vec;
 }
 
-void tinyspline::BSpline::setControlPointAt(size_t index,
-	const std_real_vector_in ctrlp)
+std_real_vector_out tinyspline::BSpline::evalRationalAll(
+	const std_real_vector_in us) const
 {
-	size_t actual = std_real_vector_read(ctrlp)size();
-	size_t expected = dimension();
-	if (expected != actual) {
-		char expected_str[32];
-		char actual_str[32];
-		sprintf(expected_str, "%lu", (unsigned long) expected);
-		sprintf(actual_str, "%lu", (unsigned long) actual);
-		throw std::runtime_error(
-			"Expected size: " + std::string(expected_str) +
-			", Actual size: " + std::string(actual_str));
-	}
 	tsStatus status;
-	tsError err = ts_bspline_set_control_point_at(
-		&spline, index, std_real_vector_read(ctrlp)data(), &status);
-	if (err < 0)
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(us)size() * (dimension() - 1));
+	if (ts_bspline_eval_rational_all(&spline,
+			std_real_vector_read(us)data(),
+			std_real_vector_read(us)size(),
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
 		throw std::runtime_error(status.message);
+	}
+	return vec;
 }
 
-void tinyspline::BSpline::setKnots(const std::vector<tinyspline::real> &knots)
+std_real_vector_out tinyspline::BSpline::evalRationalDerivsAll(
+	const std_real_vector_in us, size_t n) const
 {
-	size_t expected = ts_bspline_num_knots(&spline);
-	size_t actual = knots.size();
-	if (expected != actual) {
-		char expected_str[32];
-		char actual_str[32];
-		sprintf(expected_str, "%lu", (unsigned long) expected);
-		sprintf(actual_str, "%lu", (unsigned long) actual);
-		throw std::runtime_error(
-			"Expected size: " + std::string(expected_str) +
-			", Actual size: " + std::string(actual_str));
-	}
 	tsStatus status;
-	if (ts_bspline_set_knots(&spline, knots.data(), &status))
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(us)size() * (n + 1) * (dimension() - 1));
+	if (ts_bspline_eval_rational_derivs_all(&spline,
+			std_real_vector_read(us)data(),
+			std_real_vector_read(us)size(), n,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
 		throw std::runtime_error(status.message);
+	}
+	return vec;
 }
 
-void tinyspline::BSpline::setKnotAt(size_t index, tinyspline::real knot)
+std_real_vector_out tinyspline::BSpline::sampleRational(size_t num) const
 {
+	size_t actualNum = num;
 	tsStatus status;
-	if (ts_bspline_set_knot_at(&spline, index, knot, &status))
+	if (actualNum == 0)
+		actualNum = (numControlPoints() - degree()) * 30;
+	std_real_vector_out vec = std_real_vector_init(
+		actualNum * (dimension() - 1));
+	if (ts_bspline_sample_rational(&spline, num,
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(),
+			&actualNum, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
 		throw std::runtime_error(status.message);
+	}
+	return vec;
 }
 
-tinyspline::BSpline tinyspline::BSpline::insertKnot(tinyspline::real u,
-	size_t n) const
+void tinyspline::BSpline::evalAllInto(const std_real_vector_in us,
+	std::vector<tinyspline::real> &points) const
 {
-	tsBSpline data = ts_bspline_init();
-	size_t k;
 	tsStatus status;
-	if (ts_bspline_insert_knot(&spline, u, n, &data, &k, &status))
+	/* Does not reallocate if the capacity of `points` suffices. */
+	points.resize(std_real_vector_read(us)size() * dimension());
+	if (ts_bspline_eval_all_into(&spline, std_real_vector_read(us)data(),
+			std_real_vector_read(us)size(), points.data(),
+			points.size(), &status)) {
 		throw std::runtime_error(status.message);
-	return BSpline(data);
+	}
 }
 
-tinyspline::BSpline tinyspline::BSpline::split(tinyspline::real u) const
+size_t tinyspline::BSpline::sampleInto(std::vector<tinyspline::real> &points,
+	size_t num) const
 {
-	tsBSpline data = ts_bspline_init();
-	size_t k;
+	size_t actualNum = num;
 	tsStatus status;
-	if (ts_bspline_split(&spline, u, &data, &k, &status))
+	if (actualNum == 0)
+		actualNum = (numControlPoints() - degree()) * 30;
+	/* Does not reallocate if the capacity of `points` suffices. */
+	points.resize(actualNum * dimension());
+	if (ts_bspline_sample_into(&spline, num, points.data(), points.size(),
+			&actualNum, &status)) {
 		throw std::runtime_error(status.message);
-	return BSpline(data);
+	}
+	return actualNum;
 }
 
-tinyspline::BSpline tinyspline::BSpline::tension(
-	tinyspline::real tension) const
+#ifndef SWIG
+void tinyspline::BSpline::evalAllInto(const tinyspline::real *us, size_t num,
+	tinyspline::real *points, size_t capacity) const
 {
-	tsBSpline data = ts_bspline_init();
 	tsStatus status;
-	if (ts_bspline_tension(&spline, tension, &data, &status))
+	if (ts_bspline_eval_all_into(&spline, us, num, points, capacity,
+			&status)) {
 		throw std::runtime_error(status.message);
-	return BSpline(data);
+	}
+}
+
+size_t tinyspline::BSpline::sampleInto(tinyspline::real *points,
+	size_t capacity, size_t num) const
+{
+	size_t actualNum;
+	tsStatus status;
+	if (ts_bspline_sample_into(&spline, num, points, capacity,
+			&actualNum, &status)) {
+		throw std::runtime_error(status.message);
+	}
+	return actualNum;
+}
+#endif
+
+tinyspline::DeBoorNet tinyspline::BSpline::bisect(tinyspline::real value,
+	tinyspline::real epsilon, bool persnickety, size_t index,
+	bool ascending, size_t maxIter) const
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	tsStatus status;
+	if (ts_bspline_bisect(&spline, value, epsilon, persnickety, index,
+			ascending, maxIter, &net, &status))
+		throw std::runtime_error(status.message);
+	return DeBoorNet(net);
+}
+
+tinyspline::DeBoorNet tinyspline::BSpline::solve(tinyspline::real value,
+	tinyspline::real epsilon, bool persnickety, size_t index,
+	bool ascending, size_t maxIter) const
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	tsStatus status;
+	if (ts_bspline_solve(&spline, value, epsilon, persnickety, index,
+			ascending, maxIter, &net, &status))
+		throw std::runtime_error(status.message);
+	return DeBoorNet(net);
+}
+
+std_real_vector_out tinyspline::BSpline::solveAll(
+	const std_real_vector_in values, tinyspline::real epsilon,
+	bool persnickety, size_t index, bool ascending, size_t maxIter) const
+{
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(values)size());
+	if (ts_bspline_solve_all(&spline, std_real_vector_read(values)data(),
+			std_real_vector_read(values)size(), epsilon,
+			persnickety, index, ascending, maxIter,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+tinyspline::Domain tinyspline::BSpline::domain() const
+{
+	real min, max;
+	ts_bspline_domain(&spline, &min, &max);
+	return Domain(min, max);
+}
+
+bool tinyspline::BSpline::isClosed(tinyspline::real epsilon) const
+{
+	int closed = 0;
+	tsStatus status;
+	if (ts_bspline_is_closed(&spline, epsilon, &closed, &status))
+		throw std::runtime_error(status.message);
+	return closed == 1;
+}
+
+std::string tinyspline::BSpline::toJson() const
+{
+	char *json;
+	tsStatus status;
+	if (ts_bspline_to_json(&spline, &json, &status))
+		throw std::runtime_error(status.message);
+	std::string string(json);
+	ts_free(json);
+	return string;
+}
+
+std::string tinyspline::BSpline::toCompactJson() const
+{
+	// Enough for most splines (a value has at most 24 chars). Otherwise,
+	// the spline is written a second time.
+	std::vector<char> buf(64 + 25 * (numControlPoints() * dimension() +
+		ts_bspline_num_knots(&spline)));
+	size_t len;
+	tsStatus status;
+	if (ts_bspline_write_json_buffer(&spline, &buf[0], buf.size(), 0,
+			&len, &status))
+		throw std::runtime_error(status.message);
+	if (len >= buf.size()) {
+		buf.resize(len + 1);
+		if (ts_bspline_write_json_buffer(&spline, &buf[0],
+				buf.size(), 0, &len, &status))
+			throw std::runtime_error(status.message);
+	}
+	return std::string(&buf[0], len);
+}
+
+void tinyspline::BSpline::save(std::string path) const
+{
+	tsStatus status;
+	if (ts_bspline_save(&spline, path.c_str(), &status))
+		throw std::runtime_error(status.message);
+}
+
+std::vector<unsigned char> tinyspline::BSpline::toBinary() const
+{
+	unsigned char *binary;
+	size_t size;
+	tsStatus status;
+	if (ts_bspline_to_binary(&spline, &binary, &size, &status))
+		throw std::runtime_error(status.message);
+	std::vector<unsigned char> vec(binary, binary + size);
+	ts_free(binary);
+	return vec;
+}
+
+void tinyspline::BSpline::saveBinary(std::string path) const
+{
+	tsStatus status;
+	if (ts_bspline_save_binary(&spline, path.c_str(), &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::setControlPoints(
+	const std::vector<tinyspline::real> &ctrlp)
+{
+	size_t expected = ts_bspline_len_control_points(&spline);
+	size_t actual = ctrlp.size();
+	if (expected != actual) {
+		char expected_str[32];
+		char actual_str[32];
+		sprintf(expected_str, "%lu", (unsigned long) expected);
+		sprintf(actual_str, "%lu", (unsigned long) actual);
+		throw std::runtime_error(
+			"Expected size: " + std::string(expected_str) +
+			", Actual size: " + std::string(actual_str));
+	}
+	tsStatus status;
+	if (ts_bspline_set_control_points(&spline, ctrlp.data(), &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::setControlPointAt(size_t index,
+	const std_real_vector_in ctrlp)
+{
+	size_t actual = std_real_vector_read(ctrlp)size();
+	size_t expected = dimension();
+	if (expected != actual) {
+		char expected_str[32];
+		char actual_str[32];
+		sprintf(expected_str, "%lu", (unsigned long) expected);
+		sprintf(actual_str, "%lu", (unsigned long) actual);
+		throw std::runtime_error(
+			"Expected size: " + std::string(expected_str) +
+			", Actual size: " + std::string(actual_str));
+	}
+	tsStatus status;
+	tsError err = ts_bspline_set_control_point_at(
+		&spline, index, std_real_vector_read(ctrlp)data(), &status);
+	if (err < 0)
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::setKnots(const std::vector<tinyspline::real> &knots)
+{
+	size_t expected = ts_bspline_num_knots(&spline);
+	size_t actual = knots.size();
+	if (expected != actual) {
+		char expected_str[32];
+		char actual_str[32];
+		sprintf(expected_str, "%lu", (unsigned long) expected);
+		sprintf(actual_str, "%lu", (unsigned long) actual);
+		throw std::runtime_error(
+			"Expected size: " + std::string(expected_str) +
+			", Actual size: " + std::string(actual_str));
+	}
+	tsStatus status;
+	if (ts_bspline_set_knots(&spline, knots.data(), &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::setKnotAt(size_t index, tinyspline::real knot)
+{
+	tsStatus status;
+	if (ts_bspline_set_knot_at(&spline, index, knot, &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::reserve(size_t numControlPoints)
+{
+	tsStatus status;
+	if (ts_bspline_reserve(&spline, numControlPoints, &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::shrinkToFit()
+{
+	tsStatus status;
+	if (ts_bspline_shrink_to_fit(&spline, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::BSpline tinyspline::BSpline::insertKnot(tinyspline::real u,
+	size_t n) const
+{
+	tsBSpline data = ts_bspline_init();
+	size_t k;
+	tsStatus status;
+	if (ts_bspline_insert_knot(&spline, u, n, &data, &k, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::split(tinyspline::real u) const
+{
+	tsBSpline data = ts_bspline_init();
+	size_t k;
+	tsStatus status;
+	if (ts_bspline_split(&spline, u, &data, &k, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::refineKnots(
+	const std_real_vector_in knots) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_refine_knots(&spline,
+			std_real_vector_read(knots)data(),
+			std_real_vector_read(knots)size(), &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::removeKnots(
+	tinyspline::real tolerance) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_remove_knots(&spline, tolerance, &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::tension(
+	tinyspline::real tension) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_tension(&spline, tension, &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
 }
 
 tinyspline::BSpline tinyspline::BSpline::toBeziers() const
@@ -602,6 +1151,87 @@ tinyspline::BSpline tinyspline::BSpline::elevateDegree(
 	return BSpline(data);
 }
 
+tinyspline::BSpline tinyspline::BSpline::elevateDegree(size_t amount,
+	real epsilon, size_t grainSize, size_t numThreads) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_elevate_degree_parallel(&spline, amount, epsilon,
+			&data, grainSize, threadPoolExecutor, &numThreads,
+			&status)) {
+		throw std::runtime_error(status.message);
+	}
+	return BSpline(data);
+}
+
+std::vector<tinyspline::BSpline> tinyspline::BSpline::elevateToCommonDegree(
+	const std::vector<tinyspline::BSpline> &splines, real epsilon,
+	size_t numThreads)
+{
+	std::vector<tinyspline::BSpline> result;
+	if (splines.empty())
+		return result;
+	/* Flat copies of the input, owned by `splines'. */
+	std::vector<tsBSpline> in(splines.size()), out(splines.size());
+	for (size_t i = 0; i < splines.size(); i++)
+		in[i] = splines[i].spline;
+	tsStatus status;
+	if (ts_bspline_elevate_to_common_degree(&in[0], in.size(), epsilon,
+			&out[0], 0, threadPoolExecutor, &numThreads,
+			&status)) {
+		for (size_t i = 0; i < out.size(); i++)
+			ts_bspline_free(&out[i]);
+		throw std::runtime_error(status.message);
+	}
+	result.reserve(out.size());
+	for (size_t i = 0; i < out.size(); i++)
+		result.push_back(BSpline(out[i]));
+	return result;
+}
+
+std::vector<tinyspline::BSpline> tinyspline::BSpline::map(
+	const std::vector<tinyspline::BSpline> &splines, tsBSplineOp op,
+	const void *args, std::vector<std::string> *errors, size_t numThreads)
+{
+	std::vector<tinyspline::BSpline> result;
+	if (errors)
+		errors->assign(splines.size(), std::string());
+	if (splines.empty())
+		return result;
+	/* Flat copies of the input, owned by `splines'. */
+	std::vector<tsBSpline> in(splines.size()), out(splines.size());
+	for (size_t i = 0; i < splines.size(); i++)
+		in[i] = splines[i].spline;
+	/* Reported if `ts_bspline_map' fails before transforming any spline
+	 * (`out' is value-initialized and, thus, can be freed anyway). */
+	tsStatus status;
+	status.code = TS_MALLOC;
+	strcpy(status.message, "out of memory");
+	std::vector<tsStatus> statuses(splines.size(), status);
+	if (ts_bspline_map(&in[0], in.size(), op, args, &out[0],
+			&statuses[0], 0, threadPoolExecutor, &numThreads,
+			&status) && !errors) {
+		for (size_t i = 0; i < out.size(); i++)
+			ts_bspline_free(&out[i]);
+		throw std::runtime_error(status.message);
+	}
+	result.reserve(out.size());
+	for (size_t i = 0; i < out.size(); i++) {
+		if (statuses[i].code == TS_SUCCESS) {
+			result.push_back(BSpline(out[i]));
+		} else {
+			(*errors)[i] = statuses[i].message;
+			if ((*errors)[i].empty()) { /* TINYSPLINE_NO_MESSAGES */
+				std::ostringstream oss;
+				oss << "error " << statuses[i].code;
+				(*errors)[i] = oss.str();
+			}
+			result.push_back(BSpline());
+		}
+	}
+	return result;
+}
+
 tinyspline::BSpline tinyspline::BSpline::alignWith(
 	const BSpline &other, BSpline &otherAligned, real epsilon) const
 {
@@ -624,51 +1254,1209 @@ tinyspline::Morphism tinyspline::BSpline::morphTo(
 	return Morphism(*this, other, epsilon);
 }
 
-std::string tinyspline::BSpline::toString() const
+void tinyspline::BSpline::insertKnotInPlace(tinyspline::real u, size_t n)
 {
-	Domain d = domain();
-	std::ostringstream oss;
-	oss << "BSpline{";
-	oss << "dimension: " << dimension();
-	oss << ", degree: " << degree();
-	oss << ", domain: [" << d.min() << ", " << d.max() << "]";
-	oss << ", control points: " << numControlPoints();
-	oss << ", knots: " << ts_bspline_num_knots(&spline);
-	oss << "}";
-	return oss.str();
+	size_t k;
+	tsStatus status;
+	if (ts_bspline_insert_knot(&spline, u, n, &spline, &k, &status))
+		throw std::runtime_error(status.message);
 }
 
+void tinyspline::BSpline::splitInPlace(tinyspline::real u)
+{
+	size_t k;
+	tsStatus status;
+	if (ts_bspline_split(&spline, u, &spline, &k, &status))
+		throw std::runtime_error(status.message);
+}
 
+void tinyspline::BSpline::refineKnotsInPlace(const std_real_vector_in knots)
+{
+	tsStatus status;
+	if (ts_bspline_refine_knots(&spline,
+			std_real_vector_read(knots)data(),
+			std_real_vector_read(knots)size(), &spline, &status))
+		throw std::runtime_error(status.message);
+}
 
-/******************************************************************************
-*                                                                             *
+void tinyspline::BSpline::removeKnotsInPlace(tinyspline::real tolerance)
+{
+	tsStatus status;
+	if (ts_bspline_remove_knots(&spline, tolerance, &spline, &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::tensionInPlace(tinyspline::real tension)
+{
+	tsStatus status;
+	if (ts_bspline_tension(&spline, tension, &spline, &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::deriveInPlace(size_t n, real epsilon)
+{
+	tsStatus status;
+	if (ts_bspline_derive(&spline, n, epsilon, &spline, &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSpline::elevateDegreeInPlace(size_t amount, real epsilon)
+{
+	tsStatus status;
+	if (ts_bspline_elevate_degree(&spline, amount, epsilon,
+		&spline, &status)) {
+		throw std::runtime_error(status.message);
+	}
+}
+
+std::string tinyspline::BSpline::toString() const
+{
+	Domain d = domain();
+	std::ostringstream oss;
+	oss << "BSpline{";
+	oss << "dimension: " << dimension();
+	oss << ", degree: " << degree();
+	oss << ", domain: [" << d.min() << ", " << d.max() << "]";
+	oss << ", control points: " << numControlPoints();
+	oss << ", knots: " << ts_bspline_num_knots(&spline);
+	oss << "}";
+	return oss.str();
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* Evaluator                                                                   *
+*                                                                             *
+******************************************************************************/
+tinyspline::Evaluator::Evaluator(const tinyspline::BSpline &spline)
+: bspline(spline), net(spline.eval(spline.domain().min()))
+{}
+
+tinyspline::Evaluator::Evaluator(const tinyspline::Evaluator &other)
+: bspline(other.bspline), net(other.net)
+{}
+
+tinyspline::Evaluator & tinyspline::Evaluator::operator=(
+	const tinyspline::Evaluator &other)
+{
+	if (&other != this) {
+		bspline = other.bspline;
+		net = other.net;
+	}
+	return *this;
+}
+
+const tinyspline::DeBoorNet & tinyspline::Evaluator::operator()(
+	tinyspline::real u)
+{
+	return eval(u);
+}
+
+const tinyspline::BSpline & tinyspline::Evaluator::spline() const
+{
+	return bspline;
+}
+
+const tinyspline::DeBoorNet & tinyspline::Evaluator::eval(tinyspline::real u)
+{
+	tsStatus status;
+	if (ts_bspline_eval_into(&bspline.spline, u, &net.net, &status))
+		throw std::runtime_error(status.message);
+	return net;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* SamplingPlan                                                                *
+*                                                                             *
+******************************************************************************/
+tinyspline::SamplingPlan::SamplingPlan(const tinyspline::BSpline &spline,
+	const std_real_vector_in us)
+: plan(ts_sampling_plan_init())
+{
+	tsStatus status;
+	if (ts_sampling_plan_new(&spline.spline,
+			std_real_vector_read(us)data(),
+			std_real_vector_read(us)size(), &plan, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::SamplingPlan::SamplingPlan(const tinyspline::SamplingPlan &other)
+: plan(ts_sampling_plan_init())
+{
+	tsStatus status;
+	if (ts_sampling_plan_copy(&other.plan, &plan, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::SamplingPlan::~SamplingPlan()
+{
+	ts_sampling_plan_free(&plan);
+}
+
+tinyspline::SamplingPlan & tinyspline::SamplingPlan::operator=(
+	const tinyspline::SamplingPlan &other)
+{
+	if (&other != this) {
+		tsSamplingPlan data = ts_sampling_plan_init();
+		tsStatus status;
+		if (ts_sampling_plan_copy(&other.plan, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_sampling_plan_free(&plan);
+		ts_sampling_plan_move(&data, &plan);
+	}
+	return *this;
+}
+
+size_t tinyspline::SamplingPlan::numPoints() const
+{
+	return ts_sampling_plan_num_points(&plan);
+}
+
+std_real_vector_out tinyspline::SamplingPlan::eval(
+	const tinyspline::BSpline &spline) const
+{
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		numPoints() * spline.dimension());
+	if (ts_sampling_plan_eval(&plan, &spline.spline,
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+void tinyspline::SamplingPlan::evalInto(const tinyspline::BSpline &spline,
+	std::vector<tinyspline::real> &points) const
+{
+	tsStatus status;
+	/* Does not reallocate if the capacity of `points` suffices. */
+	points.resize(numPoints() * spline.dimension());
+	if (ts_sampling_plan_eval(&plan, &spline.spline, points.data(),
+			points.size(), &status)) {
+		throw std::runtime_error(status.message);
+	}
+}
+
+
+
+
+/******************************************************************************
+*                                                                             *
+* CompiledSpline                                                              *
+*                                                                             *
+******************************************************************************/
+tinyspline::CompiledSpline::CompiledSpline(const tinyspline::BSpline &spline)
+: compiled(ts_compiled_spline_init())
+{
+	tsStatus status;
+	if (ts_compiled_spline_new(&spline.spline, &compiled, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::CompiledSpline::CompiledSpline(
+	const tinyspline::CompiledSpline &other)
+: compiled(ts_compiled_spline_init())
+{
+	tsStatus status;
+	if (ts_compiled_spline_copy(&other.compiled, &compiled, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::CompiledSpline::~CompiledSpline()
+{
+	ts_compiled_spline_free(&compiled);
+}
+
+tinyspline::CompiledSpline & tinyspline::CompiledSpline::operator=(
+	const tinyspline::CompiledSpline &other)
+{
+	if (&other != this) {
+		tsCompiledSpline data = ts_compiled_spline_init();
+		tsStatus status;
+		if (ts_compiled_spline_copy(&other.compiled, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_compiled_spline_free(&compiled);
+		ts_compiled_spline_move(&data, &compiled);
+	}
+	return *this;
+}
+
+size_t tinyspline::CompiledSpline::dimension() const
+{
+	return ts_compiled_spline_dimension(&compiled);
+}
+
+tinyspline::Domain tinyspline::CompiledSpline::domain() const
+{
+	real min, max;
+	ts_compiled_spline_domain(&compiled, &min, &max);
+	return Domain(min, max);
+}
+
+bool tinyspline::CompiledSpline::isUpToDate(
+	const tinyspline::BSpline &spline) const
+{
+	return ts_compiled_spline_check(&compiled, &spline.spline, NULL)
+		== TS_SUCCESS;
+}
+
+std_real_vector_out tinyspline::CompiledSpline::evalAll(
+	const std_real_vector_in us) const
+{
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(us)size() * dimension());
+	if (ts_compiled_spline_eval_all(&compiled,
+			std_real_vector_read(us)data(),
+			std_real_vector_read(us)size(),
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::CompiledSpline::sample(size_t num) const
+{
+	size_t actualNum;
+	tsStatus status;
+	/* Query the actual number of points first. */
+	ts_compiled_spline_sample(&compiled, num, NULL, 0, &actualNum, NULL);
+	std_real_vector_out vec = std_real_vector_init(
+		actualNum * dimension());
+	if (ts_compiled_spline_sample(&compiled, num,
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(),
+			&actualNum, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* SplinePool                                                                  *
+*                                                                             *
+******************************************************************************/
+tinyspline::SplinePool::SplinePool(const tinyspline::BSpline &spline,
+	size_t num)
+: pool(ts_spline_pool_init())
+{
+	tsStatus status;
+	/* The pool copies the splines, so sharing the handle is fine. */
+	std::vector<tsBSpline> splines(num, spline.spline);
+	if (ts_spline_pool_new(num ? &splines[0] : NULL, num, &pool, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::SplinePool::SplinePool(
+	const std::vector<tinyspline::BSpline> &splines)
+: pool(ts_spline_pool_init())
+{
+	tsStatus status;
+	std::vector<tsBSpline> data(splines.size());
+	for (size_t i = 0; i < splines.size(); i++)
+		data[i] = splines[i].spline;
+	if (ts_spline_pool_new(data.empty() ? NULL : &data[0], data.size(),
+			&pool, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::SplinePool::SplinePool(const tinyspline::SplinePool &other)
+: pool(ts_spline_pool_init())
+{
+	tsStatus status;
+	if (ts_spline_pool_copy(&other.pool, &pool, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::SplinePool::~SplinePool()
+{
+	ts_spline_pool_free(&pool);
+}
+
+tinyspline::SplinePool & tinyspline::SplinePool::operator=(
+	const tinyspline::SplinePool &other)
+{
+	if (&other != this) {
+		tsSplinePool data = ts_spline_pool_init();
+		tsStatus status;
+		if (ts_spline_pool_copy(&other.pool, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_spline_pool_free(&pool);
+		ts_spline_pool_move(&data, &pool);
+	}
+	return *this;
+}
+
+size_t tinyspline::SplinePool::numSplines() const
+{
+	return ts_spline_pool_num_splines(&pool);
+}
+
+size_t tinyspline::SplinePool::dimension() const
+{
+	return ts_spline_pool_dimension(&pool);
+}
+
+bool tinyspline::SplinePool::sharesKnots() const
+{
+	return ts_spline_pool_shares_knots(&pool) == 1;
+}
+
+tinyspline::BSpline tinyspline::SplinePool::splineAt(size_t index) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_spline_pool_get(&pool, index, &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+void tinyspline::SplinePool::setSplineAt(size_t index,
+	const tinyspline::BSpline &spline)
+{
+	tsStatus status;
+	if (ts_spline_pool_set(&pool, index, &spline.spline, &status))
+		throw std::runtime_error(status.message);
+}
+
+std_real_vector_out tinyspline::SplinePool::eval(tinyspline::real u) const
+{
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		numSplines() * dimension());
+	if (ts_spline_pool_eval(&pool, u, std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+void tinyspline::SplinePool::evalInto(tinyspline::real u,
+	std::vector<tinyspline::real> &points) const
+{
+	tsStatus status;
+	/* Does not reallocate if the capacity of `points` suffices. */
+	points.resize(numSplines() * dimension());
+	if (ts_spline_pool_eval(&pool, u, points.data(), points.size(),
+			&status)) {
+		throw std::runtime_error(status.message);
+	}
+}
+
+std_real_vector_out tinyspline::SplinePool::sample(size_t num) const
+{
+	tsStatus status;
+	size_t actual;
+	if (num == 0) {
+		BSpline first = splineAt(0);
+		num = (first.numControlPoints() - first.degree()) * 30;
+	}
+	std_real_vector_out vec = std_real_vector_init(
+		numSplines() * num * dimension());
+	if (ts_spline_pool_sample(&pool, num,
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), &actual, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* BSplineSurface                                                              *
+*                                                                             *
+******************************************************************************/
+tinyspline::BSplineSurface::BSplineSurface(size_t numU, size_t numV,
+	size_t dimension, size_t degreeU, size_t degreeV,
+	tinyspline::BSpline::type typeU, tinyspline::BSpline::type typeV)
+: surface(ts_bspline_surface_init())
+{
+	tsStatus status;
+	if (ts_bspline_surface_new(numU, numV, dimension, degreeU, degreeV,
+			typeU, typeV, &surface, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::BSplineSurface::BSplineSurface(
+	const tinyspline::BSplineSurface &other)
+: surface(ts_bspline_surface_init())
+{
+	tsStatus status;
+	if (ts_bspline_surface_copy(&other.surface, &surface, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::BSplineSurface::~BSplineSurface()
+{
+	ts_bspline_surface_free(&surface);
+}
+
+tinyspline::BSplineSurface & tinyspline::BSplineSurface::operator=(
+	const tinyspline::BSplineSurface &other)
+{
+	if (&other != this) {
+		tsBSplineSurface data = ts_bspline_surface_init();
+		tsStatus status;
+		if (ts_bspline_surface_copy(&other.surface, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_bspline_surface_free(&surface);
+		ts_bspline_surface_move(&data, &surface);
+	}
+	return *this;
+}
+
+size_t tinyspline::BSplineSurface::degreeU() const
+{
+	return ts_bspline_surface_degree_u(&surface);
+}
+
+size_t tinyspline::BSplineSurface::degreeV() const
+{
+	return ts_bspline_surface_degree_v(&surface);
+}
+
+size_t tinyspline::BSplineSurface::numControlPointsU() const
+{
+	return ts_bspline_surface_num_control_points_u(&surface);
+}
+
+size_t tinyspline::BSplineSurface::numControlPointsV() const
+{
+	return ts_bspline_surface_num_control_points_v(&surface);
+}
+
+size_t tinyspline::BSplineSurface::dimension() const
+{
+	return ts_bspline_surface_dimension(&surface);
+}
+
+tinyspline::Domain tinyspline::BSplineSurface::domainU() const
+{
+	tinyspline::real min_u, max_u, min_v, max_v;
+	ts_bspline_surface_domain(&surface, &min_u, &max_u, &min_v, &max_v);
+	return Domain(min_u, max_u);
+}
+
+tinyspline::Domain tinyspline::BSplineSurface::domainV() const
+{
+	tinyspline::real min_u, max_u, min_v, max_v;
+	ts_bspline_surface_domain(&surface, &min_u, &max_u, &min_v, &max_v);
+	return Domain(min_v, max_v);
+}
+
+std::vector<tinyspline::real>
+tinyspline::BSplineSurface::controlPoints() const
+{
+	const tinyspline::real *ctrlp =
+		ts_bspline_surface_control_points_ptr(&surface);
+	return std::vector<tinyspline::real>(ctrlp, ctrlp +
+		numControlPointsU() * numControlPointsV() * dimension());
+}
+
+std::vector<tinyspline::real> tinyspline::BSplineSurface::knotsU() const
+{
+	const tinyspline::real *knots =
+		ts_bspline_surface_knots_u_ptr(&surface);
+	return std::vector<tinyspline::real>(knots, knots +
+		numControlPointsU() + degreeU() + 1);
+}
+
+std::vector<tinyspline::real> tinyspline::BSplineSurface::knotsV() const
+{
+	const tinyspline::real *knots =
+		ts_bspline_surface_knots_v_ptr(&surface);
+	return std::vector<tinyspline::real>(knots, knots +
+		numControlPointsV() + degreeV() + 1);
+}
+
+void tinyspline::BSplineSurface::setControlPoints(
+	const std::vector<tinyspline::real> &ctrlp)
+{
+	tsStatus status;
+	if (ctrlp.size() !=
+			numControlPointsU() * numControlPointsV() * dimension())
+		throw std::runtime_error("#ctrlp != numU * numV * dimension");
+	if (ts_bspline_surface_set_control_points(&surface, ctrlp.data(),
+			&status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::BSplineSurface::setKnots(
+	const std::vector<tinyspline::real> &knotsU,
+	const std::vector<tinyspline::real> &knotsV)
+{
+	tsStatus status;
+	if (knotsU.size() != numControlPointsU() + degreeU() + 1)
+		throw std::runtime_error("#knotsU != numU + degreeU + 1");
+	if (knotsV.size() != numControlPointsV() + degreeV() + 1)
+		throw std::runtime_error("#knotsV != numV + degreeV + 1");
+	if (ts_bspline_surface_set_knots(&surface, knotsU.data(),
+			knotsV.data(), &status))
+		throw std::runtime_error(status.message);
+}
+
+std_real_vector_out tinyspline::BSplineSurface::eval(tinyspline::real u,
+	tinyspline::real v) const
+{
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(dimension());
+	if (ts_bspline_surface_eval(&surface, u, v,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::BSplineSurface::evalGrid(
+	const std_real_vector_in us, const std_real_vector_in vs) const
+{
+	const size_t numU = std_real_vector_read(us)size();
+	const size_t numV = std_real_vector_read(vs)size();
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		numU * numV * dimension());
+	if (ts_bspline_surface_eval_grid(&surface,
+			std_real_vector_read(us)data(), numU,
+			std_real_vector_read(vs)data(), numV,
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* MonotoneIndex                                                               *
+*                                                                             *
+******************************************************************************/
+tinyspline::MonotoneIndex::MonotoneIndex(const tinyspline::BSpline &spline,
+	size_t index, bool ascending, size_t numSamples)
+: index(ts_monotone_index_init())
+{
+	tsStatus status;
+	if (ts_monotone_index_new(&spline.spline, index, ascending,
+			numSamples, &this->index, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::MonotoneIndex::MonotoneIndex(
+	const tinyspline::MonotoneIndex &other)
+: index(ts_monotone_index_init())
+{
+	tsStatus status;
+	if (ts_monotone_index_copy(&other.index, &index, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::MonotoneIndex::~MonotoneIndex()
+{
+	ts_monotone_index_free(&index);
+}
+
+tinyspline::MonotoneIndex & tinyspline::MonotoneIndex::operator=(
+	const tinyspline::MonotoneIndex &other)
+{
+	if (&other != this) {
+		tsMonotoneIndex data = ts_monotone_index_init();
+		tsStatus status;
+		if (ts_monotone_index_copy(&other.index, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_monotone_index_free(&index);
+		ts_monotone_index_move(&data, &index);
+	}
+	return *this;
+}
+
+size_t tinyspline::MonotoneIndex::numSamples() const
+{
+	return ts_monotone_index_num_samples(&index);
+}
+
+tinyspline::real tinyspline::MonotoneIndex::solve(tinyspline::real value,
+	tinyspline::real epsilon, bool persnickety, size_t maxIter) const
+{
+	tinyspline::real u;
+	tsStatus status;
+	if (ts_monotone_index_solve(&index, value, epsilon, persnickety,
+			maxIter, &u, &status))
+		throw std::runtime_error(status.message);
+	return u;
+}
+
+std_real_vector_out tinyspline::MonotoneIndex::solveAll(
+	const std_real_vector_in values, tinyspline::real epsilon,
+	bool persnickety, size_t maxIter) const
+{
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(values)size());
+	if (ts_monotone_index_solve_all(&index,
+			std_real_vector_read(values)data(),
+			std_real_vector_read(values)size(), epsilon,
+			persnickety, maxIter, std_real_vector_read(vec)data(),
+			&status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* Projector                                                                   *
+*                                                                             *
+******************************************************************************/
+tinyspline::Projector::Projector(const tinyspline::BSpline &spline)
+: projector(ts_projector_init())
+{
+	tsStatus status;
+	if (ts_projector_new(&spline.spline, &projector, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::Projector::Projector(const tinyspline::Projector &other)
+: projector(ts_projector_init())
+{
+	tsStatus status;
+	if (ts_projector_copy(&other.projector, &projector, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::Projector::~Projector()
+{
+	ts_projector_free(&projector);
+}
+
+tinyspline::Projector & tinyspline::Projector::operator=(
+	const tinyspline::Projector &other)
+{
+	if (&other != this) {
+		tsProjector data = ts_projector_init();
+		tsStatus status;
+		if (ts_projector_copy(&other.projector, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_projector_free(&projector);
+		ts_projector_move(&data, &projector);
+	}
+	return *this;
+}
+
+size_t tinyspline::Projector::dimension() const
+{
+	return ts_projector_dimension(&projector);
+}
+
+tinyspline::real tinyspline::Projector::project(
+	const std_real_vector_in point) const
+{
+	tinyspline::real u;
+	tsStatus status;
+	if (std_real_vector_read(point)size() != dimension())
+		throw std::runtime_error("size(point) != dimension");
+	if (ts_projector_project(&projector,
+			std_real_vector_read(point)data(), &u, NULL,
+			&status))
+		throw std::runtime_error(status.message);
+	return u;
+}
+
+std_real_vector_out tinyspline::Projector::projectAll(
+	const std_real_vector_in points) const
+{
+	const size_t dim = dimension();
+	const size_t num = std_real_vector_read(points)size() / dim;
+	tsStatus status;
+	if (std_real_vector_read(points)size() % dim != 0)
+		throw std::runtime_error("#points % dimension != 0");
+	std_real_vector_out vec = std_real_vector_init(num);
+	if (ts_projector_project_all(&projector,
+			std_real_vector_read(points)data(), num,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::Projector::closestPoint(
+	const std_real_vector_in point) const
+{
+	tinyspline::real u;
+	tsStatus status;
+	if (std_real_vector_read(point)size() != dimension())
+		throw std::runtime_error("size(point) != dimension");
+	std_real_vector_out vec = std_real_vector_init(dimension());
+	if (ts_projector_project(&projector,
+			std_real_vector_read(point)data(), &u,
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* ArcLength                                                                   *
+*                                                                             *
+******************************************************************************/
+tinyspline::ArcLength::ArcLength(const tinyspline::BSpline &spline,
+	size_t numSteps)
+: table(ts_arc_length_init())
+{
+	tsStatus status;
+	if (ts_arc_length_new(&spline.spline, numSteps, &table, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::ArcLength::ArcLength(const tinyspline::ArcLength &other)
+: table(ts_arc_length_init())
+{
+	tsStatus status;
+	if (ts_arc_length_copy(&other.table, &table, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::ArcLength::~ArcLength()
+{
+	ts_arc_length_free(&table);
+}
+
+tinyspline::ArcLength & tinyspline::ArcLength::operator=(
+	const tinyspline::ArcLength &other)
+{
+	if (&other != this) {
+		tsArcLength data = ts_arc_length_init();
+		tsStatus status;
+		if (ts_arc_length_copy(&other.table, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_arc_length_free(&table);
+		ts_arc_length_move(&data, &table);
+	}
+	return *this;
+}
+
+size_t tinyspline::ArcLength::dimension() const
+{
+	return ts_arc_length_dimension(&table);
+}
+
+tinyspline::real tinyspline::ArcLength::length() const
+{
+	return ts_arc_length_length(&table);
+}
+
+tinyspline::real tinyspline::ArcLength::uAt(tinyspline::real length) const
+{
+	tinyspline::real u;
+	tsStatus status;
+	if (ts_arc_length_u_at(&table, length, &u, &status))
+		throw std::runtime_error(status.message);
+	return u;
+}
+
+std_real_vector_out tinyspline::ArcLength::uAtAll(
+	const std_real_vector_in lengths) const
+{
+	tsStatus status;
+	std_real_vector_out vec = std_real_vector_init(
+		std_real_vector_read(lengths)size());
+	if (ts_arc_length_u_at_all(&table,
+			std_real_vector_read(lengths)data(),
+			std_real_vector_read(lengths)size(),
+			std_real_vector_read(vec)data(), &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::ArcLength::sample(size_t num) const
+{
+	tsStatus status;
+	size_t actual;
+	if (num == 0) {
+		/* Fails with TS_NUM_POINTS, but yields the default number of
+		 * points. */
+		ts_arc_length_sample(&table, 0, NULL, 0, &num, NULL);
+	}
+	std_real_vector_out vec = std_real_vector_init(num * dimension());
+	if (ts_arc_length_sample(&table, num,
+			std_real_vector_read(vec)data(),
+			std_real_vector_read(vec)size(), &actual, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* CatmullRomFitter                                                            *
+*                                                                             *
+******************************************************************************/
+tinyspline::CatmullRomFitter::CatmullRomFitter(size_t dimension,
+	tsReal alpha, std::vector<tinyspline::real> *first, tsReal epsilon)
+: fitter(ts_catmull_rom_fitter_init())
+{
+	tsReal *fst = NULL;
+	if (first && first->size() >= dimension)
+		fst = first->data();
+	tsStatus status;
+	if (ts_catmull_rom_fitter_new(dimension, alpha, fst, epsilon,
+			&fitter, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::CatmullRomFitter::CatmullRomFitter(
+	const tinyspline::CatmullRomFitter &other)
+: fitter(ts_catmull_rom_fitter_init())
+{
+	tsStatus status;
+	if (ts_catmull_rom_fitter_copy(&other.fitter, &fitter, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::CatmullRomFitter::~CatmullRomFitter()
+{
+	ts_catmull_rom_fitter_free(&fitter);
+}
+
+tinyspline::CatmullRomFitter & tinyspline::CatmullRomFitter::operator=(
+	const tinyspline::CatmullRomFitter &other)
+{
+	if (&other != this) {
+		tsCatmullRomFitter data = ts_catmull_rom_fitter_init();
+		tsStatus status;
+		if (ts_catmull_rom_fitter_copy(&other.fitter, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_catmull_rom_fitter_free(&fitter);
+		ts_catmull_rom_fitter_move(&data, &fitter);
+	}
+	return *this;
+}
+
+size_t tinyspline::CatmullRomFitter::dimension() const
+{
+	return ts_catmull_rom_fitter_dimension(&fitter);
+}
+
+size_t tinyspline::CatmullRomFitter::numPoints() const
+{
+	return ts_catmull_rom_fitter_num_points(&fitter);
+}
+
+size_t tinyspline::CatmullRomFitter::numFinished() const
+{
+	return ts_catmull_rom_fitter_num_finished(&fitter);
+}
+
+void tinyspline::CatmullRomFitter::push(const std_real_vector_in points)
+{
+	if (std_real_vector_read(points)size() % dimension() != 0)
+		throw std::runtime_error("#points % dimension != 0");
+	tsStatus status;
+	if (ts_catmull_rom_fitter_push(&fitter,
+			std_real_vector_read(points)data(),
+			std_real_vector_read(points)size() / dimension(),
+			&status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::BSpline tinyspline::CatmullRomFitter::take()
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_catmull_rom_fitter_take(&fitter, &data, &status))
+		throw std::runtime_error(status.message);
+	return tinyspline::BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::CatmullRomFitter::spline(
+	std::vector<tinyspline::real> *last) const
+{
+	tsReal *lst = NULL;
+	if (last && last->size() >= dimension())
+		lst = last->data();
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_catmull_rom_fitter_spline(&fitter, lst, &data, &status))
+		throw std::runtime_error(status.message);
+	return tinyspline::BSpline(data);
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* SplineArchive                                                               *
+*                                                                             *
+******************************************************************************/
+tinyspline::SplineArchive::SplineArchive(std::string path)
+: archive(ts_archive_init())
+{
+	tsStatus status;
+	if (ts_archive_open(path.c_str(), &archive, &status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::SplineArchive::~SplineArchive()
+{
+	ts_archive_free(&archive);
+}
+
+size_t tinyspline::SplineArchive::numSplines() const
+{
+	return ts_archive_num_splines(&archive);
+}
+
+size_t tinyspline::SplineArchive::idAt(size_t index)
+{
+	size_t id;
+	tsStatus status;
+	if (ts_archive_id_at(&archive, index, &id, &status))
+		throw std::runtime_error(status.message);
+	return id;
+}
+
+tinyspline::BSpline tinyspline::SplineArchive::load(size_t id)
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_archive_load(&archive, id, &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::SplineArchive::loadAt(size_t index)
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_archive_load_at(&archive, index, &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+void tinyspline::SplineArchive::append(size_t id,
+	const tinyspline::BSpline &spline)
+{
+	tsStatus status;
+	if (ts_archive_append(&archive, id, &spline.spline, &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::SplineArchive::flush()
+{
+	tsStatus status;
+	if (ts_archive_flush(&archive, &status))
+		throw std::runtime_error(status.message);
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* MemoryResourceScope                                                         *
+*                                                                             *
+******************************************************************************/
+#ifdef TINYSPLINECXX_PMR
+namespace {
+// std::pmr::memory_resource::deallocate requires the size of a block, which
+// is stored in front of it.
+const size_t BLOCK_HEADER = alignof(std::max_align_t);
+
+void *resourceAllocate(void *data, size_t size)
+{
+	std::pmr::memory_resource *resource =
+		static_cast<std::pmr::memory_resource *>(data);
+	try {
+		char *block = static_cast<char *>(resource->allocate(
+			BLOCK_HEADER + size, BLOCK_HEADER));
+		*reinterpret_cast<size_t *>(block) = size;
+		return block + BLOCK_HEADER;
+	} catch (const std::bad_alloc &) {
+		return NULL;
+	}
+}
+
+void resourceDeallocate(void *data, void *ptr)
+{
+	if (!ptr)
+		return;
+	char *block = static_cast<char *>(ptr) - BLOCK_HEADER;
+	static_cast<std::pmr::memory_resource *>(data)->deallocate(block,
+		BLOCK_HEADER + *reinterpret_cast<size_t *>(block),
+		BLOCK_HEADER);
+}
+
+void *resourceReallocate(void *data, void *ptr, size_t size)
+{
+	if (!ptr)
+		return resourceAllocate(data, size);
+	size_t old = *reinterpret_cast<size_t *>(
+		static_cast<char *>(ptr) - BLOCK_HEADER);
+	void *block = resourceAllocate(data, size);
+	if (block) {
+		memcpy(block, ptr, old < size ? old : size);
+		resourceDeallocate(data, ptr);
+	}
+	return block;
+}
+}
+
+tinyspline::MemoryResourceScope::MemoryResourceScope(
+	std::pmr::memory_resource &resource)
+{
+	tsAllocator allocator;
+	allocator.allocate = resourceAllocate;
+	allocator.reallocate = resourceReallocate;
+	allocator.deallocate = resourceDeallocate;
+	allocator.data = &resource;
+	ts_get_allocator(&previous);
+	ts_set_allocator(&allocator);
+}
+
+tinyspline::MemoryResourceScope::~MemoryResourceScope()
+{
+	ts_set_allocator(&previous);
+}
+#endif
+
+
+
+/******************************************************************************
+*                                                                             *
 * Morphism                                                                    *
 *                                                                             *
 ******************************************************************************/
 tinyspline::Morphism::Morphism(const tinyspline::BSpline &start,
 	const tinyspline::BSpline &end, real epsilon)
-: start(start), end(end), epsilon(epsilon)
+: morphism(ts_morphism_init())
 {
-	startAligned = start.alignWith(end, endAligned, epsilon);
-	// Make buffer compatible by copying one of the aligned splines.
-	buffer = startAligned;
+	tsStatus status;
+	if (ts_morphism_new(&start.spline, &end.spline, epsilon, &morphism,
+			&status))
+		throw std::runtime_error(status.message);
 }
 
-tinyspline::BSpline tinyspline::Morphism::eval(real t)
+tinyspline::Morphism::Morphism(const tinyspline::Morphism &other)
+: morphism(ts_morphism_init())
 {
 	tsStatus status;
-	if (ts_bspline_morph(&startAligned.spline, &endAligned.spline, t,
-		epsilon, &buffer.spline, &status)) {
+	if (ts_morphism_copy(&other.morphism, &morphism, &status))
 		throw std::runtime_error(status.message);
+}
+
+tinyspline::Morphism::~Morphism()
+{
+	ts_morphism_free(&morphism);
+}
+
+tinyspline::Morphism & tinyspline::Morphism::operator=(
+	const tinyspline::Morphism &other)
+{
+	if (&other != this) {
+		tsMorphism data = ts_morphism_init();
+		tsStatus status;
+		if (ts_morphism_copy(&other.morphism, &data, &status))
+			throw std::runtime_error(status.message);
+		ts_morphism_free(&morphism);
+		ts_morphism_move(&data, &morphism);
 	}
-	return buffer;
+	return *this;
 }
 
-tinyspline::BSpline tinyspline::Morphism::operator()(real t)
+tinyspline::BSpline tinyspline::Morphism::operator()(real t) const
 {
 	return eval(t);
 }
 
+void tinyspline::Morphism::update(const tinyspline::BSpline &start,
+	const tinyspline::BSpline &end)
+{
+	tsStatus status;
+	if (ts_morphism_update(&morphism, &start.spline, &end.spline,
+			&status))
+		throw std::runtime_error(status.message);
+}
+
+tinyspline::BSpline tinyspline::Morphism::eval(real t) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_morphism_eval(&morphism, t, &data, &status))
+		throw std::runtime_error(status.message);
+	return tinyspline::BSpline(data);
+}
+
+void tinyspline::Morphism::evalInto(real t, tinyspline::BSpline &out) const
+{
+	tsStatus status;
+	/* Reuses the memory of `out` if possible. */
+	if (ts_morphism_eval(&morphism, t, &out.spline, &status))
+		throw std::runtime_error(status.message);
+}
+
+void tinyspline::Morphism::evalAllInto(const std::vector<real> &ts,
+	std::vector<tinyspline::BSpline> &outs) const
+{
+	outs.resize(ts.size());
+	for (size_t i = 0; i < ts.size(); i++)
+		evalInto(ts[i], outs[i]);
+}
+
 
 
 /******************************************************************************
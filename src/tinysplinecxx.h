@@ -1,9 +1,26 @@
 #pragma once
 
 #include "tinyspline.h"
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 #include <string>
 
+/* Move semantics require C++11. */
+#if !defined(SWIG) && (__cplusplus >= 201103L || \
+		(defined(_MSVC_LANG) && _MSVC_LANG >= 201103L))
+#define TINYSPLINECXX_MOVE
+#endif
+
+/* std::pmr requires C++17. */
+#if !defined(SWIG) && (__cplusplus >= 201703L || \
+		(defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#if __has_include(<memory_resource>)
+#define TINYSPLINECXX_PMR
+#include <memory_resource>
+#endif
+#endif
+
 #ifndef TINYSPLINECXX_API
 #define TINYSPLINECXX_API TINYSPLINE_API
 #endif
@@ -18,6 +35,8 @@
 
 #ifdef TINYSPLINE_EMSCRIPTEN
 #include <stdexcept>
+#include <stdint.h>
+#include <emscripten/val.h>
 void inline cannotWrite() {
 	throw std::runtime_error("cannot write read-only property");
 }
@@ -32,15 +51,49 @@ namespace tinyspline {
 typedef tsReal real;
 class BSpline;
 class Morphism;
+class Evaluator;
+
+#ifndef SWIG
+/* A read-only view of a sequence of reals owned by another object (e.g., the
+ * control points of a spline). Is invalidated if the owner is modified or
+ * destroyed. */
+class TINYSPLINECXX_API RealView {
+public:
+	/* Constructors & Destructors */
+	RealView(const real *data, size_t size);
+
+	/* Operators */
+	real operator[](size_t index) const;
+
+	/* Accessors */
+	const real * data() const;
+	size_t size() const;
+	const real * begin() const;
+	const real * end() const;
+
+	/* Conversion */
+	std::vector<real> toVector() const;
+
+private:
+	const real *_data;
+	size_t _size;
+};
+#endif
 
 class TINYSPLINECXX_API DeBoorNet {
 public:
 	/* Constructors & Destructors */
 	DeBoorNet(const DeBoorNet &other);
+#ifdef TINYSPLINECXX_MOVE
+	DeBoorNet(DeBoorNet &&other) noexcept;
+#endif
 	~DeBoorNet();
 
 	/* Operators */
 	DeBoorNet & operator=(const DeBoorNet &other);
+#ifdef TINYSPLINECXX_MOVE
+	DeBoorNet & operator=(DeBoorNet &&other) noexcept;
+#endif
 
 	/* Accessors */
 	real knot() const;
@@ -50,6 +103,10 @@ public:
 	size_t dimension() const;
 	std::vector<real> points() const;
 	std::vector<real> result() const;
+#ifndef SWIG
+	RealView pointsView() const;
+	RealView resultView() const;
+#endif
 	tsDeBoorNet * data();
 
 	/* Debug */
@@ -62,6 +119,7 @@ private:
 	explicit DeBoorNet(tsDeBoorNet &data);
 
 	friend class BSpline;
+	friend class Evaluator;
 
 #ifdef TINYSPLINE_EMSCRIPTEN
 public:
@@ -111,6 +169,9 @@ public:
 	/* Constructors & Destructors */
 	BSpline();
 	BSpline(const BSpline &other);
+#ifdef TINYSPLINECXX_MOVE
+	BSpline(BSpline &&other) noexcept;
+#endif
 	explicit BSpline(size_t numControlPoints, size_t dimension = 2,
 		size_t degree = 3,
 		tinyspline::BSpline::type type = TS_CLAMPED);
@@ -124,11 +185,19 @@ public:
 		std::vector<tinyspline::real> *first = NULL,
 		std::vector<tinyspline::real> *last = NULL,
 		tsReal epsilon = TS_CONTROL_POINT_EPSILON);
+	static BSpline approximate(const std_real_vector_in points,
+		size_t dimension, size_t numControlPoints, size_t degree = 3,
+		tsReal tolerance = 0);
 	static BSpline parseJson(std::string json);
 	static BSpline load(std::string path);
+	static BSpline fromBinary(const std::vector<unsigned char> &binary);
+	static BSpline loadBinary(std::string path);
 
 	/* Operators */
 	BSpline & operator=(const BSpline &other);
+#ifdef TINYSPLINECXX_MOVE
+	BSpline & operator=(BSpline &&other) noexcept;
+#endif
 	DeBoorNet operator()(real u) const;
 
 	/* Accessors */
@@ -139,42 +208,115 @@ public:
 	std_real_vector_out controlPointAt(size_t index) const;
 	std::vector<real> knots() const;
 	real knotAt(size_t index) const;
+#ifndef SWIG
+	RealView controlPointsView() const;
+	RealView knotsView() const;
+#endif
 
 	/* Query */
 	size_t numControlPoints() const;
+	size_t capacity() const;
 	DeBoorNet eval(real u) const;
 	std_real_vector_out evalAll(const std_real_vector_in us) const;
+	std_real_vector_out evalAll(const std_real_vector_in us,
+		size_t grainSize, size_t numThreads = 0) const;
+	std_real_vector_out evalDerivs(real u, size_t n) const;
+	std_real_vector_out evalDerivsAll(const std_real_vector_in us,
+		size_t n) const;
+	/* Uses (and fills) the derivatives cached by this spline. Not
+	 * thread-safe. */
+	std_real_vector_out evalDerivative(real u, size_t n = 1,
+		real epsilon = TS_CONTROL_POINT_EPSILON);
 	std_real_vector_out sample(size_t num = 0) const;
+	std_real_vector_out sampleFast(size_t num = 0) const;
+	std_real_vector_out sampleAdaptive(real tolerance) const;
+	/* Evaluate NURBS, i.e., the resultant points have no weight. */
+	std_real_vector_out evalRationalAll(const std_real_vector_in us) const;
+	std_real_vector_out evalRationalDerivsAll(
+		const std_real_vector_in us, size_t n) const;
+	std_real_vector_out sampleRational(size_t num = 0) const;
+	void evalAllInto(const std_real_vector_in us,
+		std::vector<real> &points) const;
+	size_t sampleInto(std::vector<real> &points, size_t num = 0) const;
+	/* Also exposed to Python, where `us' and `points' are objects
+	 * implementing the buffer protocol (e.g., NumPy arrays). */
+#if !defined(SWIG) || defined(SWIGPYTHON)
+	void evalAllInto(const real *us, size_t num, real *points,
+		size_t capacity) const;
+	size_t sampleInto(real *points, size_t capacity,
+		size_t num = 0) const;
+#endif
 	DeBoorNet bisect(real value, real epsilon = TS_CONTROL_POINT_EPSILON,
 		bool persnickety = false, size_t index = 0,
 		bool ascending = true, size_t maxIter = 30) const;
+	DeBoorNet solve(real value, real epsilon = TS_CONTROL_POINT_EPSILON,
+		bool persnickety = false, size_t index = 0,
+		bool ascending = true, size_t maxIter = 30) const;
+	std_real_vector_out solveAll(const std_real_vector_in values,
+		real epsilon = TS_CONTROL_POINT_EPSILON,
+		bool persnickety = false, size_t index = 0,
+		bool ascending = true, size_t maxIter = 30) const;
 	Domain domain() const;
 	bool isClosed(real epsilon = TS_CONTROL_POINT_EPSILON) const;
 
 	/* Serialization */
 	std::string toJson() const;
+	std::string toCompactJson() const;
 	void save(std::string path) const;
+	std::vector<unsigned char> toBinary() const;
+	void saveBinary(std::string path) const;
 
 	/* Modifications */
 	void setControlPoints(const std::vector<real> &ctrlp);
 	void setControlPointAt(size_t index, const std_real_vector_in ctrlp);
 	void setKnots(const std::vector<real> &knots);
 	void setKnotAt(size_t index, real knot);
+	void reserve(size_t numControlPoints);
+	void shrinkToFit();
 
 	/* Transformations */
 	BSpline insertKnot(real u, size_t n) const;
 	BSpline split(real u) const;
+	BSpline refineKnots(const std_real_vector_in knots) const;
+	BSpline removeKnots(real tolerance = TS_CONTROL_POINT_EPSILON) const;
 	BSpline tension(real tension) const;
 	BSpline toBeziers() const;
 	BSpline derive(size_t n = 1,
 		real epsilon = TS_CONTROL_POINT_EPSILON) const;
 	BSpline elevateDegree(size_t amount,
 		real epsilon = TS_CONTROL_POINT_EPSILON) const;
+	BSpline elevateDegree(size_t amount, real epsilon, size_t grainSize,
+		size_t numThreads = 0) const;
+#ifndef SWIG
+	static std::vector<BSpline> elevateToCommonDegree(
+		const std::vector<BSpline> &splines,
+		real epsilon = TS_CONTROL_POINT_EPSILON,
+		size_t numThreads = 0);
+	/* Applies `op' to each spline (cf. ::ts_bspline_map). If `errors' is
+	 * NULL, throws on the first failure. Otherwise, `errors' receives an
+	 * error message (or an empty string) per spline and failed splines
+	 * are replaced with default-constructed splines. */
+	static std::vector<BSpline> map(const std::vector<BSpline> &splines,
+		tsBSplineOp op, const void *args,
+		std::vector<std::string> *errors = NULL,
+		size_t numThreads = 0);
+#endif
 	BSpline alignWith(const BSpline &other, BSpline &otherAligned,
 		real epsilon = TS_CONTROL_POINT_EPSILON) const;
 	Morphism morphTo(const BSpline &other,
 		real epsilon = TS_CONTROL_POINT_EPSILON) const;
 
+	/* In-place transformations */
+	void insertKnotInPlace(real u, size_t n);
+	void splitInPlace(real u);
+	void refineKnotsInPlace(const std_real_vector_in knots);
+	void removeKnotsInPlace(real tolerance = TS_CONTROL_POINT_EPSILON);
+	void tensionInPlace(real tension);
+	void deriveInPlace(size_t n = 1,
+		real epsilon = TS_CONTROL_POINT_EPSILON);
+	void elevateDegreeInPlace(size_t amount,
+		real epsilon = TS_CONTROL_POINT_EPSILON);
+
 	/* Debug */
 	std::string toString() const;
 
@@ -186,32 +328,531 @@ private:
 
 	/* Needs to access ::spline. */
 	friend class Morphism;
+	friend class Evaluator;
+	friend class SamplingPlan;
+	friend class CompiledSpline;
+	friend class SplinePool;
+	friend class MonotoneIndex;
+	friend class Projector;
+	friend class ArcLength;
+	friend class CatmullRomFitter;
+	friend class SplineArchive;
 
 #ifdef TINYSPLINE_EMSCRIPTEN
 public:
+	std_real_vector_out evalAll0(const std_real_vector_in us) const
+	    { return evalAll(us); }
+	std_real_vector_out evalAll1(const std_real_vector_in us,
+		size_t grainSize) const { return evalAll(us, grainSize); }
 	std_real_vector_out sample0() const { return sample(); }
 	std_real_vector_out sample1(size_t num) const { return sample(num); }
+	std_real_vector_out sampleFast0() const { return sampleFast(); }
 	BSpline derive0() const { return derive(); }
 	BSpline derive1(size_t n) const { return derive(n); }
 	BSpline derive2(size_t n, real eps) const { return derive(n, eps); }
+
+	/* Typed arrays (Float64Array, or Float32Array if
+	 * TINYSPLINE_FLOAT_PRECISION is enabled) viewing the memory of this
+	 * spline. Are invalidated if this spline is modified or destroyed, or
+	 * if the WASM memory grows. */
+	emscripten::val controlPointsView0() const
+	{
+		return emscripten::val(emscripten::typed_memory_view(
+			controlPointsView().size(), controlPointsView().data()));
+	}
+	emscripten::val knotsView0() const
+	{
+		return emscripten::val(emscripten::typed_memory_view(
+			knotsView().size(), knotsView().data()));
+	}
+
+	/* Raw pointer variants of evalAllInto and sampleInto. `us' and
+	 * `points' are addresses in WASM memory, e.g., allocated with
+	 * Module._malloc and accessed through Module.HEAPF64.subarray. */
+	void evalAllInto0(uintptr_t us, size_t num, uintptr_t points,
+		size_t capacity) const
+	{
+		evalAllInto(reinterpret_cast<const real *>(us), num,
+			reinterpret_cast<real *>(points), capacity);
+	}
+	size_t sampleInto0(uintptr_t points, size_t capacity,
+		size_t num) const
+	{
+		return sampleInto(reinterpret_cast<real *>(points), capacity,
+			num);
+	}
+#endif
+};
+
+class TINYSPLINECXX_API Evaluator {
+public:
+	/* Constructors & Destructors */
+	explicit Evaluator(const BSpline &spline);
+	Evaluator(const Evaluator &other);
+
+	/* Operators */
+	Evaluator & operator=(const Evaluator &other);
+	const DeBoorNet & operator()(real u);
+
+	/* Accessors */
+	const BSpline & spline() const;
+
+	/* Query */
+	const DeBoorNet & eval(real u);
+
+private:
+	BSpline bspline;
+	DeBoorNet net;
+};
+
+class TINYSPLINECXX_API SamplingPlan {
+public:
+	/* Constructors & Destructors */
+	SamplingPlan(const BSpline &spline, const std_real_vector_in us);
+	SamplingPlan(const SamplingPlan &other);
+	~SamplingPlan();
+
+	/* Operators */
+	SamplingPlan & operator=(const SamplingPlan &other);
+
+	/* Accessors */
+	size_t numPoints() const;
+
+	/* Query */
+	std_real_vector_out eval(const BSpline &spline) const;
+	void evalInto(const BSpline &spline, std::vector<real> &points) const;
+
+private:
+	tsSamplingPlan plan;
+};
+
+class TINYSPLINECXX_API CompiledSpline {
+public:
+	/* Constructors & Destructors */
+	explicit CompiledSpline(const BSpline &spline);
+	CompiledSpline(const CompiledSpline &other);
+	~CompiledSpline();
+
+	/* Operators */
+	CompiledSpline & operator=(const CompiledSpline &other);
+
+	/* Accessors */
+	size_t dimension() const;
+	Domain domain() const;
+
+	/* Query */
+	bool isUpToDate(const BSpline &spline) const;
+	std_real_vector_out evalAll(const std_real_vector_in us) const;
+	std_real_vector_out sample(size_t num = 0) const;
+
+private:
+	tsCompiledSpline compiled;
+};
+
+class TINYSPLINECXX_API SplinePool {
+public:
+	/* Constructors & Destructors */
+	SplinePool(const BSpline &spline, size_t num);
+#ifndef SWIG
+	explicit SplinePool(const std::vector<BSpline> &splines);
 #endif
+	SplinePool(const SplinePool &other);
+	~SplinePool();
+
+	/* Operators */
+	SplinePool & operator=(const SplinePool &other);
+
+	/* Accessors */
+	size_t numSplines() const;
+	size_t dimension() const;
+	bool sharesKnots() const;
+	BSpline splineAt(size_t index) const;
+	void setSplineAt(size_t index, const BSpline &spline);
+
+	/* Query */
+	std_real_vector_out eval(real u) const;
+	void evalInto(real u, std::vector<real> &points) const;
+	std_real_vector_out sample(size_t num = 0) const;
+
+private:
+	tsSplinePool pool;
+};
+
+class TINYSPLINECXX_API BSplineSurface {
+public:
+	/* Constructors & Destructors */
+	BSplineSurface(size_t numU, size_t numV, size_t dimension = 3,
+		size_t degreeU = 3, size_t degreeV = 3,
+		tinyspline::BSpline::type typeU = TS_CLAMPED,
+		tinyspline::BSpline::type typeV = TS_CLAMPED);
+	BSplineSurface(const BSplineSurface &other);
+	~BSplineSurface();
+
+	/* Operators */
+	BSplineSurface & operator=(const BSplineSurface &other);
+
+	/* Accessors */
+	size_t degreeU() const;
+	size_t degreeV() const;
+	size_t numControlPointsU() const;
+	size_t numControlPointsV() const;
+	size_t dimension() const;
+	Domain domainU() const;
+	Domain domainV() const;
+	std::vector<real> controlPoints() const;
+	std::vector<real> knotsU() const;
+	std::vector<real> knotsV() const;
+
+	/* Modifications */
+	void setControlPoints(const std::vector<real> &ctrlp);
+	void setKnots(const std::vector<real> &knotsU,
+		const std::vector<real> &knotsV);
+
+	/* Query */
+	std_real_vector_out eval(real u, real v) const;
+	std_real_vector_out evalGrid(const std_real_vector_in us,
+		const std_real_vector_in vs) const;
+
+private:
+	tsBSplineSurface surface;
+};
+
+class TINYSPLINECXX_API MonotoneIndex {
+public:
+	/* Constructors & Destructors */
+	explicit MonotoneIndex(const BSpline &spline, size_t index = 0,
+		bool ascending = true, size_t numSamples = 0);
+	MonotoneIndex(const MonotoneIndex &other);
+	~MonotoneIndex();
+
+	/* Operators */
+	MonotoneIndex & operator=(const MonotoneIndex &other);
+
+	/* Accessors */
+	size_t numSamples() const;
+
+	/* Query */
+	real solve(real value, real epsilon = TS_CONTROL_POINT_EPSILON,
+		bool persnickety = false, size_t maxIter = 30) const;
+	std_real_vector_out solveAll(const std_real_vector_in values,
+		real epsilon = TS_CONTROL_POINT_EPSILON,
+		bool persnickety = false, size_t maxIter = 30) const;
+
+private:
+	tsMonotoneIndex index;
+};
+
+class TINYSPLINECXX_API Projector {
+public:
+	/* Constructors & Destructors */
+	explicit Projector(const BSpline &spline);
+	Projector(const Projector &other);
+	~Projector();
+
+	/* Operators */
+	Projector & operator=(const Projector &other);
+
+	/* Accessors */
+	size_t dimension() const;
+
+	/* Query */
+	real project(const std_real_vector_in point) const;
+	std_real_vector_out projectAll(const std_real_vector_in points) const;
+	std_real_vector_out closestPoint(const std_real_vector_in point) const;
+
+private:
+	tsProjector projector;
+};
+
+class TINYSPLINECXX_API ArcLength {
+public:
+	/* Constructors & Destructors */
+	explicit ArcLength(const BSpline &spline, size_t numSteps = 0);
+	ArcLength(const ArcLength &other);
+	~ArcLength();
+
+	/* Operators */
+	ArcLength & operator=(const ArcLength &other);
+
+	/* Accessors */
+	size_t dimension() const;
+	real length() const;
+
+	/* Query */
+	real uAt(real length) const;
+	std_real_vector_out uAtAll(const std_real_vector_in lengths) const;
+	std_real_vector_out sample(size_t num = 0) const;
+
+private:
+	tsArcLength table;
+};
+
+class TINYSPLINECXX_API CatmullRomFitter {
+public:
+	/* Constructors & Destructors */
+	explicit CatmullRomFitter(size_t dimension,
+		tsReal alpha = (tsReal) 0.5f,
+		std::vector<tinyspline::real> *first = NULL,
+		tsReal epsilon = TS_CONTROL_POINT_EPSILON);
+	CatmullRomFitter(const CatmullRomFitter &other);
+	~CatmullRomFitter();
+
+	/* Operators */
+	CatmullRomFitter & operator=(const CatmullRomFitter &other);
+
+	/* Accessors */
+	size_t dimension() const;
+	size_t numPoints() const;
+	size_t numFinished() const;
+
+	/* Modifications */
+	void push(const std_real_vector_in points);
+	BSpline take();
+
+	/* Query */
+	BSpline spline(std::vector<tinyspline::real> *last = NULL) const;
+
+private:
+	tsCatmullRomFitter fitter;
+};
+
+class TINYSPLINECXX_API SplineArchive {
+public:
+	/* Constructors & Destructors */
+	SplineArchive(std::string path);
+	~SplineArchive();
+
+	/* Accessors */
+	size_t numSplines() const;
+	size_t idAt(size_t index);
+
+	/* Query */
+	BSpline load(size_t id);
+	BSpline loadAt(size_t index);
+
+	/* Modifications */
+	void append(size_t id, const BSpline &spline);
+	void flush();
+
+private:
+	tsArchive archive;
+
+	/* Archives are not copyable. */
+	SplineArchive(const SplineArchive &other);
+	SplineArchive & operator=(const SplineArchive &other);
 };
 
+#ifdef TINYSPLINECXX_PMR
+/* Serves all allocations of TinySpline from `resource` (see
+ * ts_set_allocator) for the lifetime of the scope. Objects allocated within
+ * the scope must be destroyed before the scope ends. */
+class TINYSPLINECXX_API MemoryResourceScope {
+public:
+	/* Constructors & Destructors */
+	explicit MemoryResourceScope(std::pmr::memory_resource &resource);
+	~MemoryResourceScope();
+
+private:
+	tsAllocator previous;
+
+	/* Scopes are not copyable. */
+	MemoryResourceScope(const MemoryResourceScope &other);
+	MemoryResourceScope & operator=(const MemoryResourceScope &other);
+};
+#endif
+
 class TINYSPLINECXX_API Morphism {
 public:
 	/* Constructors & Destructors */
 	Morphism(const BSpline &start, const BSpline &end,
 		real epsilon = TS_CONTROL_POINT_EPSILON);
+	Morphism(const Morphism &other);
+	~Morphism();
+
+	/* Operators */
+	Morphism & operator=(const Morphism &other);
+	BSpline operator()(real t) const;
+
+	/* Modifications */
+	void update(const BSpline &start, const BSpline &end);
+
+	/* Query */
+	BSpline eval(real t) const;
+	void evalInto(real t, BSpline &out) const;
+#ifndef SWIG
+	void evalAllInto(const std::vector<real> &ts,
+		std::vector<BSpline> &outs) const;
+#endif
+
+private:
+	tsMorphism morphism;
+};
+
+#ifndef SWIG
+/* A copy of a spline whose degree and dimension are fixed at compile time.
+ * Since all loop bounds of De Boor's algorithm are constants, compilers
+ * unroll the recurrence completely and keep the net on the stack. Optionally,
+ * the control points and knots are converted to a different floating point
+ * type (e.g., float). Header-only because of the template parameters. */
+template <size_t Degree, size_t Dim, typename Real = real>
+class StaticBSpline {
+public:
+	/* Constructors & Destructors */
+	explicit StaticBSpline(const BSpline &spline);
+
+	/* Operators */
+	std::vector<Real> operator()(Real u) const;
+
+	/* Accessors */
+	size_t numControlPoints() const;
+	const std::vector<Real> & controlPoints() const;
+	const std::vector<Real> & knots() const;
+
+	/* Query */
+	std::vector<Real> eval(Real u) const;
+	void evalInto(Real u, Real *point) const;
+	void evalAllInto(const std::vector<Real> &us,
+		std::vector<Real> &points) const;
+
+	/* Evaluates the spline defined by numControlPoints * Dim control
+	 * points and numControlPoints + Degree + 1 knots at u. */
+	static void deBoor(const Real *knots, size_t numControlPoints,
+		const Real *ctrlp, Real u, Real *point);
 
-	BSpline eval(real t);
-	BSpline operator()(real t);
 private:
-	BSpline start, end;
-	real epsilon;
-	BSpline startAligned, endAligned;
-	BSpline buffer;
+	std::vector<Real> _knots;
+	std::vector<Real> _ctrlp;
 };
 
+template <size_t Degree, size_t Dim, typename Real>
+StaticBSpline<Degree, Dim, Real>::StaticBSpline(const BSpline &spline)
+{
+	if (spline.degree() != Degree)
+		throw std::runtime_error("degree(spline) != Degree");
+	if (spline.dimension() != Dim)
+		throw std::runtime_error("dimension(spline) != Dim");
+	RealView knots = spline.knotsView();
+	RealView ctrlp = spline.controlPointsView();
+	_knots.assign(knots.begin(), knots.end());
+	_ctrlp.assign(ctrlp.begin(), ctrlp.end());
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+std::vector<Real> StaticBSpline<Degree, Dim, Real>::operator()(Real u) const
+{
+	return eval(u);
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+size_t StaticBSpline<Degree, Dim, Real>::numControlPoints() const
+{
+	return _ctrlp.size() / Dim;
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+const std::vector<Real> &
+StaticBSpline<Degree, Dim, Real>::controlPoints() const
+{
+	return _ctrlp;
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+const std::vector<Real> & StaticBSpline<Degree, Dim, Real>::knots() const
+{
+	return _knots;
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+std::vector<Real> StaticBSpline<Degree, Dim, Real>::eval(Real u) const
+{
+	std::vector<Real> point(Dim);
+	evalInto(u, &point[0]);
+	return point;
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+void StaticBSpline<Degree, Dim, Real>::evalInto(Real u, Real *point) const
+{
+	deBoor(&_knots[0], numControlPoints(), &_ctrlp[0], u, point);
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+void StaticBSpline<Degree, Dim, Real>::evalAllInto(
+	const std::vector<Real> &us, std::vector<Real> &points) const
+{
+	const size_t n = numControlPoints();
+	points.resize(us.size() * Dim);
+	for (size_t i = 0; i < us.size(); i++)
+		deBoor(&_knots[0], n, &_ctrlp[0], us[i], &points[i * Dim]);
+}
+
+template <size_t Degree, size_t Dim, typename Real>
+void StaticBSpline<Degree, Dim, Real>::deBoor(const Real *knots,
+	size_t numControlPoints, const Real *ctrlp, Real u, Real *point)
+{
+	const Real min = knots[Degree];
+	const Real max = knots[numControlPoints];
+	if (u < min || u > max) {
+		if (ts_knots_equal((tsReal) u, (tsReal) min))
+			u = min;
+		else if (ts_knots_equal((tsReal) u, (tsReal) max))
+			u = max;
+		else
+			throw std::runtime_error("u is not within domain");
+	}
+	/* Index of the last knot <= u (knots[k] < knots[k+1]). Like
+	 * ts_bspline_eval, u is snapped to knots closer than TS_KNOT_EPSILON
+	 * first, so that u slightly below a knot is evaluated in the span
+	 * starting at this knot. Note that knots[numControlPoints] == max. */
+	const Real *next = std::upper_bound(knots + Degree + 1,
+		knots + numControlPoints, u);
+	if (ts_knots_equal((tsReal) u, (tsReal) *next)) {
+		u = *next;
+		next = std::upper_bound(next, knots + numControlPoints, u);
+	} else if (ts_knots_equal((tsReal) u, (tsReal) next[-1])) {
+		u = next[-1];
+	}
+	const size_t k = next - knots - 1;
+	if (k > Degree && !(knots[k - Degree] < u)) {
+		/* u is a knot of multiplicity order, i.e., the spline is
+		 * discontinuous at u. Like ts_bspline_eval, yields the end of
+		 * the segment left of u. */
+		std::copy(ctrlp + (k - Degree - 1) * Dim,
+			ctrlp + (k - Degree) * Dim, point);
+		return;
+	}
+	Real net[(Degree + 1) * Dim];
+	std::copy(ctrlp + (k - Degree) * Dim, ctrlp + (k + 1) * Dim, net);
+	for (size_t r = 1; r <= Degree; r++) {
+		for (size_t j = Degree; j >= r; j--) {
+			const size_t i = k - Degree + j;
+			const Real a = (u - knots[i]) /
+				(knots[i + Degree + 1 - r] - knots[i]);
+			for (size_t d = 0; d < Dim; d++) {
+				net[j * Dim + d] = (1 - a) *
+					net[(j - 1) * Dim + d] +
+					a * net[j * Dim + d];
+			}
+		}
+	}
+	std::copy(net + Degree * Dim, net + (Degree + 1) * Dim, point);
+}
+
+/* Evaluates spline at u with StaticBSpline::deBoor without copying the
+ * control points and knots of spline. */
+template <size_t Degree, size_t Dim>
+void evaluate(const BSpline &spline, real u, real *point)
+{
+	if (spline.degree() != Degree)
+		throw std::runtime_error("degree(spline) != Degree");
+	if (spline.dimension() != Dim)
+		throw std::runtime_error("dimension(spline) != Dim");
+	StaticBSpline<Degree, Dim, real>::deBoor(spline.knotsView().data(),
+		spline.numControlPoints(), spline.controlPointsView().data(),
+		u, point);
+}
+#endif
+
 class TINYSPLINECXX_API Utils {
 public:
 	static bool knotsEqual(real x, real y);
@@ -262,6 +903,7 @@ EMSCRIPTEN_BINDINGS(tinyspline) {
 	        .class_function("interpolateCatmullRom",
 			&BSpline::interpolateCatmullRom,
 			allow_raw_pointers())
+	        .class_function("approximate", &BSpline::approximate)
 	        .class_function("parseJson", &BSpline::parseJson)
 
 	        .property("degree", &BSpline::degree)
@@ -271,17 +913,36 @@ EMSCRIPTEN_BINDINGS(tinyspline) {
 			&BSpline::setControlPoints)
 	        .property("knots", &BSpline::knots, &BSpline::setKnots)
 	        .property("domain", &BSpline::domain)
+	        .function("controlPointsView", &BSpline::controlPointsView0)
+	        .function("knotsView", &BSpline::knotsView0)
 
 	        /* Property by index */
 	        .function("controlPointAt", &BSpline::controlPointAt)
 	        .function("setControlPointAt", &BSpline::setControlPointAt)
 	        .function("knotAt", &BSpline::knotAt)
 	        .function("setKnotAt", &BSpline::setKnotAt)
+	        .function("reserve", &BSpline::reserve)
+	        .function("shrinkToFit", &BSpline::shrinkToFit)
 
 	        /* Query */
 	        .function("numControlPoints", &BSpline::numControlPoints)
+	        .function("capacity", &BSpline::capacity)
 	        .function("eval", &BSpline::eval)
-	        .function("evalAll", &BSpline::evalAll)
+	        .function("evalAll",
+			select_overload<std_real_vector_out(
+			const std_real_vector_in) const>
+			(&BSpline::evalAll0))
+	        .function("evalAll",
+			select_overload<std_real_vector_out(
+			const std_real_vector_in, size_t) const>
+			(&BSpline::evalAll1))
+	        .function("evalAll",
+			select_overload<std_real_vector_out(
+			const std_real_vector_in, size_t, size_t) const>
+			(&BSpline::evalAll))
+	        .function("evalDerivs", &BSpline::evalDerivs)
+	        .function("evalDerivsAll", &BSpline::evalDerivsAll)
+	        .function("evalDerivative", &BSpline::evalDerivative)
 	        .function("sample",
 			select_overload<std_real_vector_out() const>
 			(&BSpline::sample0))
@@ -289,15 +950,25 @@ EMSCRIPTEN_BINDINGS(tinyspline) {
 			select_overload<std_real_vector_out(size_t) const>
 			(&BSpline::sample1))
 	        .function("sample", &BSpline::sample)
+	        .function("sampleFast", &BSpline::sampleFast0)
+	        .function("sampleFast", &BSpline::sampleFast)
+	        .function("evalAllInto", &BSpline::evalAllInto0)
+	        .function("sampleInto", &BSpline::sampleInto0)
+	        .function("sampleAdaptive", &BSpline::sampleAdaptive)
 	        .function("bisect", &BSpline::bisect)
+	        .function("solve", &BSpline::solve)
+	        .function("solveAll", &BSpline::solveAll)
 	        .function("isClosed", &BSpline::isClosed)
 
 		/* Serialization */
 	        .function("toJson", &BSpline::toJson)
+	        .function("toCompactJson", &BSpline::toCompactJson)
 
 	        /* Transformations */
 	        .function("insertKnot", &BSpline::insertKnot)
 	        .function("split", &BSpline::split)
+	        .function("refineKnots", &BSpline::refineKnots)
+	        .function("removeKnots", &BSpline::removeKnots)
 	        .function("tension", &BSpline::tension)
 	        .function("toBeziers", &BSpline::toBeziers)
 	        .function("derive",
@@ -323,6 +994,10 @@ EMSCRIPTEN_BINDINGS(tinyspline) {
 
 // Map: std::vector <--> JS array
 // https://github.com/emscripten-core/emscripten/issues/11070#issuecomment-717675128
+//
+// Vectors of numbers are read from JS arrays and typed arrays (e.g.,
+// Float64Array) with a single bulk copy (convertJSArrayToNumberVector) rather
+// than element by element.
 namespace emscripten {
 namespace internal {
 	template <typename T, typename Allocator>
@@ -336,8 +1011,19 @@ namespace internal {
 		}
 
 		static std::vector<T, Allocator> fromWireType(WireType value) {
-			return vecFromJSArray<T>(
-				ValBinding::fromWireType(value));
+			return fromVal(ValBinding::fromWireType(value),
+				std::is_arithmetic<T>());
+		}
+
+	private:
+		static std::vector<T, Allocator> fromVal(const val &value,
+				std::true_type) {
+			return convertJSArrayToNumberVector<T>(value);
+		}
+
+		static std::vector<T, Allocator> fromVal(const val &value,
+				std::false_type) {
+			return vecFromJSArray<T>(value);
 		}
 	};
 
@@ -238,6 +238,170 @@ void align_elevated_with_more_control_points(CuTest *tc)
 	ts_bspline_free(&less_control_points_copy);
 }
 
+void assert_equal_splines(CuTest *tc, tsBSpline *s1, tsBSpline *s2)
+{
+	size_t i;
+	assert_compatible(tc, s1, s2);
+	CuAssertIntEquals(tc,
+		(int) ts_bspline_dimension(s1),
+		(int) ts_bspline_dimension(s2));
+	for (i = 0; i < ts_bspline_num_knots(s1); i++) {
+		CuAssertDblEquals(tc,
+			ts_bspline_knots_ptr(s1)[i],
+			ts_bspline_knots_ptr(s2)[i], TS_KNOT_EPSILON);
+	}
+	for (i = 0; i < ts_bspline_len_control_points(s1); i++) {
+		CuAssertDblEquals(tc,
+			ts_bspline_control_points_ptr(s1)[i],
+			ts_bspline_control_points_ptr(s2)[i], POINT_EPSILON);
+	}
+}
+
+/* Sets the control points of `spline' to some arbitrary values. */
+void align_set_geometry(CuTest *tc, tsBSpline *spline, size_t seed)
+{
+	___SETUP___
+	tsReal *ctrlp = NULL;
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_control_points(spline, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(spline); i++)
+		ctrlp[i] = (tsReal) ((i * i * 7 + i * seed) % 23) / 3;
+	C(ts_bspline_set_control_points(spline, ctrlp, &status))
+
+	___TEARDOWN___
+	free(ctrlp);
+}
+
+void align_plan_equals_align(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline s1 = ts_bspline_init(), s2 = ts_bspline_init();
+	tsBSpline e1 = ts_bspline_init(), e2 = ts_bspline_init();
+	tsBSpline a1 = ts_bspline_init(), a2 = ts_bspline_init();
+	tsAlignmentPlan plan = ts_alignment_plan_init();
+	tsAlignmentPlan copy = ts_alignment_plan_init();
+	struct tsBSplineImpl *impl1, *impl2;
+	/* Number of control points, degree, and type of s1 and s2. The
+	 * number of control points exceeds the number of channels of the
+	 * identity spline computing the plan. */
+	const size_t setups[4][6] = {
+		{ 40, 1, TS_CLAMPED, 13, 3, TS_CLAMPED },
+		{ 25, 3, TS_OPENED, 30, 3, TS_CLAMPED },
+		{ 9, 4, TS_CLAMPED, 51, 2, TS_BEZIERS },
+		{ 60, 2, TS_BEZIERS, 4, 0, TS_CLAMPED }
+	};
+	size_t i;
+
+	___GIVEN___
+	for (i = 0; i < 4; i++) {
+		C(ts_bspline_new(setups[i][0], 2, setups[i][1],
+			(tsBSplineType) setups[i][2], &s1, &status))
+		C(ts_bspline_new(setups[i][3], 3, setups[i][4],
+			(tsBSplineType) setups[i][5], &s2, &status))
+		align_set_geometry(tc, &s1, 3);
+		align_set_geometry(tc, &s2, 5);
+		C(ts_alignment_plan_new(&s1, &s2, POINT_EPSILON, &plan,
+			&status))
+		C(ts_alignment_plan_copy(&plan, &copy, &status))
+		ts_alignment_plan_free(&plan);
+
+		___WHEN___
+		C(ts_bspline_align(&s1, &s2, POINT_EPSILON, &e1, &e2,
+			&status))
+		C(ts_alignment_plan_apply(&copy, &s1, &s2, &a1, &a2,
+			&status))
+
+		___THEN___
+		assert_equal_splines(tc, &e1, &a1);
+		assert_equal_splines(tc, &e2, &a2);
+
+		___WHEN___
+		/* New geometry, same topology. */
+		ts_bspline_free(&e1);
+		ts_bspline_free(&e2);
+		align_set_geometry(tc, &s1, 11);
+		align_set_geometry(tc, &s2, 2);
+		impl1 = a1.pImpl;
+		impl2 = a2.pImpl;
+		C(ts_bspline_align(&s1, &s2, POINT_EPSILON, &e1, &e2,
+			&status))
+		C(ts_alignment_plan_apply(&copy, &s1, &s2, &a1, &a2,
+			&status))
+
+		___THEN___
+		CuAssertPtrEquals(tc, impl1, a1.pImpl);
+		CuAssertPtrEquals(tc, impl2, a2.pImpl);
+		assert_equal_splines(tc, &e1, &a1);
+		assert_equal_splines(tc, &e2, &a2);
+
+		___WHEN___
+		/* In place. */
+		C(ts_alignment_plan_apply(&copy, &s1, &s2, &s2, &s1,
+			&status))
+
+		___THEN___
+		assert_equal_splines(tc, &e1, &s2);
+		assert_equal_splines(tc, &e2, &s1);
+
+		ts_bspline_free(&s1);
+		ts_bspline_free(&s2);
+		ts_bspline_free(&e1);
+		ts_bspline_free(&e2);
+		ts_alignment_plan_free(&copy);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&s1);
+	ts_bspline_free(&s2);
+	ts_bspline_free(&e1);
+	ts_bspline_free(&e2);
+	ts_bspline_free(&a1);
+	ts_bspline_free(&a2);
+	ts_alignment_plan_free(&plan);
+	ts_alignment_plan_free(&copy);
+}
+
+void align_plan_incompatible(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline s1 = ts_bspline_init(), s2 = ts_bspline_init();
+	tsBSpline other = ts_bspline_init();
+	tsBSpline a1 = ts_bspline_init(), a2 = ts_bspline_init();
+	tsAlignmentPlan plan = ts_alignment_plan_init();
+
+	___GIVEN___
+	C(ts_bspline_new(10, 2, 3, TS_CLAMPED, &s1, &status))
+	C(ts_bspline_new(7, 2, 2, TS_CLAMPED, &s2, &status))
+	C(ts_alignment_plan_new(&s1, &s2, POINT_EPSILON, &plan, &status))
+
+	___WHEN___ /* Different knots. */
+	C(ts_bspline_new(10, 2, 3, TS_OPENED, &other, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_alignment_plan_apply(&plan,
+		&other, &s2, &a1, &a2, NULL));
+	CuAssertPtrEquals(tc, NULL, a1.pImpl);
+	ts_bspline_free(&other);
+
+	___WHEN___ /* Different degree. */
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &other, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_alignment_plan_apply(&plan,
+		&s1, &other, &a1, &a2, NULL));
+	CuAssertPtrEquals(tc, NULL, a2.pImpl);
+
+	___TEARDOWN___
+	ts_bspline_free(&s1);
+	ts_bspline_free(&s2);
+	ts_bspline_free(&other);
+	ts_bspline_free(&a1);
+	ts_bspline_free(&a2);
+	ts_alignment_plan_free(&plan);
+}
+
 CuSuite* get_align_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -245,5 +409,7 @@ CuSuite* get_align_suite()
 	SUITE_ADD_TEST(suite, align_point_with_spline);
 	SUITE_ADD_TEST(suite, align_spline_to_itself);
 	SUITE_ADD_TEST(suite, align_elevated_with_more_control_points);
+	SUITE_ADD_TEST(suite, align_plan_equals_align);
+	SUITE_ADD_TEST(suite, align_plan_incompatible);
 	return suite;
 }
@@ -0,0 +1,203 @@
+#include <testutils.h>
+#include <string.h>
+
+#define ARENA_ALIGN 16
+
+/* A bump allocator storing the size of each block in front of it. */
+struct arena {
+	double memory[1 << 15];
+	size_t used;
+	size_t num_allocs;
+	size_t num_frees;
+};
+
+void *arena_allocate(void *data, size_t size)
+{
+	struct arena *arena = (struct arena *) data;
+	char *block = (char *) arena->memory + arena->used;
+	const size_t len = ARENA_ALIGN +
+		(size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+	if (arena->used + len > sizeof(arena->memory))
+		return NULL;
+	*((size_t *) block) = size;
+	arena->used += len;
+	arena->num_allocs++;
+	return block + ARENA_ALIGN;
+}
+
+void *arena_reallocate(void *data, void *ptr, size_t size)
+{
+	size_t old;
+	void *block = arena_allocate(data, size);
+	if (block && ptr) {
+		old = *((size_t *) ((char *) ptr - ARENA_ALIGN));
+		memcpy(block, ptr, old < size ? old : size);
+	}
+	return block;
+}
+
+void arena_deallocate(void *data, void *ptr)
+{
+	if (ptr)
+		((struct arena *) data)->num_frees++;
+}
+
+void *null_allocate(void *data, size_t size)
+{
+	(void) data;
+	(void) size;
+	return NULL;
+}
+
+void *null_reallocate(void *data, void *ptr, size_t size)
+{
+	(void) data;
+	(void) ptr;
+	(void) size;
+	return NULL;
+}
+
+struct arena ARENA;
+
+void allocator_arena(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline split = ts_bspline_init();
+	tsBSpline deriv = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsBSpline parsed = ts_bspline_init();
+	tsReal *points = NULL;
+	char *json = NULL;
+	size_t k, num, used;
+	tsAllocator previous, arena = {
+		arena_allocate, arena_reallocate, arena_deallocate, &ARENA
+	};
+
+	___GIVEN___
+	memset(&ARENA, 0, sizeof(struct arena));
+	ts_get_allocator(&previous);
+	ts_set_allocator(&arena);
+
+	___WHEN___
+	/* A frame of spline work served from the arena. */
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_split(&spline, (tsReal) 0.4, &split, &k, &status))
+	C(ts_bspline_derive(&split, 1, TS_CONTROL_POINT_EPSILON, &deriv,
+		&status))
+	C(ts_bspline_to_beziers(&deriv, &beziers, &status))
+	C(ts_bspline_sample(&beziers, 50, &points, &num, &status))
+	C(ts_bspline_to_json(&beziers, &json, &status))
+	C(ts_bspline_parse_json(json, &parsed, &status))
+	used = ARENA.used;
+	/* Nothing is freed; the arena is reset in one go. */
+	ts_set_allocator(&previous);
+
+	___THEN___
+	CuAssertIntEquals(tc, 50, (int) num);
+	CuAssertTrue(tc, ARENA.num_allocs >= 8);
+	CuAssertTrue(tc, used > 0);
+	CuAssertTrue(tc, (char *) spline.pImpl >= (char *) ARENA.memory);
+	CuAssertTrue(tc, (char *) points < (char *) ARENA.memory + used);
+	CuAssertTrue(tc, (char *) json < (char *) ARENA.memory + used);
+	CuAssertIntEquals(tc, (int) ts_bspline_num_control_points(&beziers),
+		(int) ts_bspline_num_control_points(&parsed));
+
+	___TEARDOWN___
+	ts_set_allocator(&previous);
+}
+
+void allocator_free(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	size_t num_frees;
+	tsAllocator previous, arena = {
+		arena_allocate, arena_reallocate, arena_deallocate, &ARENA
+	};
+
+	___GIVEN___
+	memset(&ARENA, 0, sizeof(struct arena));
+	ts_get_allocator(&previous);
+	ts_set_allocator(&arena);
+
+	___WHEN___
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	ts_free(ctrlp);
+	ts_bspline_free(&spline);
+	num_frees = ARENA.num_frees;
+	ts_set_allocator(&previous);
+
+	___THEN___
+	CuAssertIntEquals(tc, 2, (int) ARENA.num_allocs);
+	CuAssertIntEquals(tc, 2, (int) num_frees);
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+
+	___TEARDOWN___
+	ts_set_allocator(&previous);
+}
+
+void allocator_out_of_memory(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsError err;
+	tsAllocator previous, none = {
+		null_allocate, null_reallocate, arena_deallocate, &ARENA
+	};
+
+	___GIVEN___
+	ts_get_allocator(&previous);
+	ts_set_allocator(&none);
+
+	___WHEN___
+	err = ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, NULL);
+	ts_set_allocator(&previous);
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_MALLOC, err);
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+
+	___TEARDOWN___
+	ts_set_allocator(&previous);
+}
+
+void allocator_default(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsAllocator allocator, arena = {
+		arena_allocate, arena_reallocate, arena_deallocate, &ARENA
+	};
+	void *ptr;
+
+	___GIVEN___
+	ts_set_allocator(&arena);
+	ts_set_allocator(NULL);
+
+	___WHEN___
+	ts_get_allocator(&allocator);
+	ptr = allocator.allocate(allocator.data, 16);
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+
+	___THEN___
+	CuAssertPtrNotNull(tc, ptr);
+	CuAssertTrue(tc, allocator.allocate != arena_allocate);
+	CuAssertPtrEquals(tc, NULL, allocator.data);
+
+	___TEARDOWN___
+	ts_free(ptr);
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_allocator_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, allocator_arena);
+	SUITE_ADD_TEST(suite, allocator_free);
+	SUITE_ADD_TEST(suite, allocator_out_of_memory);
+	SUITE_ADD_TEST(suite, allocator_default);
+	return suite;
+}
@@ -0,0 +1,186 @@
+#include <testutils.h>
+#include <math.h>
+
+/* Points on a sine wave. */
+void approximate_points(tsReal *points, size_t num)
+{
+	size_t i;
+	for (i = 0; i < num; i++) {
+		points[i*2]     = (tsReal) (i * 0.1);
+		points[i*2 + 1] = (tsReal) sin(i * 0.1);
+	}
+}
+
+/* Chord length parameters (as used by ts_bspline_approximate). */
+void approximate_params(const tsReal *points, size_t num, tsReal *params)
+{
+	size_t i;
+	params[0] = 0;
+	for (i = 1; i < num; i++) {
+		params[i] = params[i-1] + ts_distance(points + (i-1) * 2,
+			points + i * 2, 2);
+	}
+	for (i = 1; i < num; i++)
+		params[i] /= params[num - 1];
+}
+
+/* Stores the squared distances between `points' and `spline' in `sse' and
+ * returns the maximum distance. */
+tsReal approximate_error(const tsBSpline *spline, const tsReal *points,
+	const tsReal *params, size_t num, tsReal *sse)
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal dist, max = 0;
+	size_t i;
+	*sse = 0;
+	for (i = 0; i < num; i++) {
+		ts_bspline_eval(spline, params[i], &net, NULL);
+		dist = ts_distance(ts_deboornet_result_ptr(&net),
+			points + i * 2, 2);
+		*sse += dist * dist;
+		if (dist > max)
+			max = dist;
+		ts_deboornet_free(&net);
+	}
+	return max;
+}
+
+void approximate_line(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[100], params[50], sse;
+	size_t i;
+
+	___GIVEN___
+	for (i = 0; i < 50; i++) {
+		points[i*2]     = (tsReal) i;
+		points[i*2 + 1] = (tsReal) (2.0 * i + 1.0);
+	}
+	approximate_params(points, 50, params);
+
+	___WHEN___
+	C(ts_bspline_approximate(points, 50, 2, 8, 3, 0, &spline, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 8, (int) ts_bspline_num_control_points(&spline));
+	CuAssertIntEquals(tc, 3, (int) ts_bspline_degree(&spline));
+	/* A line is reproduced exactly. */
+	CuAssertDblEquals(tc, 0, approximate_error(&spline, points, params,
+		50, &sse), POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void approximate_least_squares(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[200], params[100], *ctrlp = NULL, sse, perturbed;
+	const tsReal delta = (tsReal) 0.01;
+	size_t i, n;
+
+	___GIVEN___
+	approximate_points(points, 100);
+	approximate_params(points, 100, params);
+
+	___WHEN___
+	C(ts_bspline_approximate(points, 100, 2, 12, 3, 0, &spline, &status))
+
+	___THEN___
+	n = ts_bspline_len_control_points(&spline);
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	/* The spline starts and ends at the given points. */
+	CuAssertDblEquals(tc, points[0], ctrlp[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, points[1], ctrlp[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, points[198], ctrlp[n - 2], POINT_EPSILON);
+	CuAssertDblEquals(tc, points[199], ctrlp[n - 1], POINT_EPSILON);
+	CuAssertTrue(tc, approximate_error(&spline, points, params, 100,
+		&sse) < 0.05);
+	/* Moving an inner control point increases the error. */
+	for (i = 2; i < n - 2; i++) {
+		ctrlp[i] += delta;
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		approximate_error(&spline, points, params, 100, &perturbed);
+		CuAssertTrue(tc, perturbed > sse);
+		ctrlp[i] -= 2 * delta;
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		approximate_error(&spline, points, params, 100, &perturbed);
+		CuAssertTrue(tc, perturbed > sse);
+		ctrlp[i] += delta;
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	if (ctrlp)
+		free(ctrlp);
+}
+
+void approximate_error_driven(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[400], params[200], sse;
+
+	___GIVEN___
+	approximate_points(points, 200);
+	approximate_params(points, 200, params);
+
+	___WHEN___
+	C(ts_bspline_approximate(points, 200, 2, 100, 3, (tsReal) 0.001,
+		&spline, &status))
+
+	___THEN___
+	CuAssertTrue(tc, ts_bspline_num_control_points(&spline) < 100);
+	CuAssertTrue(tc, approximate_error(&spline, points, params, 200,
+		&sse) <= 0.001);
+	ts_bspline_free(&spline);
+
+	___WHEN___
+	/* The budget is exhausted before the tolerance is met. */
+	C(ts_bspline_approximate(points, 200, 2, 8, 3, (tsReal) 1e-9,
+		&spline, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 8, (int) ts_bspline_num_control_points(&spline));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void approximate_invalid_input(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[20];
+
+	___GIVEN___
+	approximate_points(points, 10);
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bspline_approximate(points, 10,
+		0, 4, 3, 0, &spline, NULL));
+	CuAssertIntEquals(tc, TS_DEG_GE_NCTRLP, ts_bspline_approximate(
+		points, 10, 2, 4, 4, 0, &spline, NULL));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_approximate(points,
+		10, 2, 1, 0, 0, &spline, NULL));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_approximate(points,
+		10, 2, 11, 3, 0, &spline, NULL));
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+	/* As many control points as points. */
+	C(ts_bspline_approximate(points, 10, 2, 10, 3, 0, &spline, &status))
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_approximate_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, approximate_line);
+	SUITE_ADD_TEST(suite, approximate_least_squares);
+	SUITE_ADD_TEST(suite, approximate_error_driven);
+	SUITE_ADD_TEST(suite, approximate_invalid_input);
+	return suite;
+}
@@ -0,0 +1,169 @@
+#include <testutils.h>
+#include <math.h>
+
+/* Returns the length of the polyline of `num` points. */
+tsReal polyline_length(const tsReal *points, size_t num, size_t dim)
+{
+	tsReal length = 0.f, dist, v;
+	size_t i, d;
+	for (i = 1; i < num; i++) {
+		for (dist = 0.f, d = 0; d < dim; d++) {
+			v = points[i * dim + d] - points[(i - 1) * dim + d];
+			dist += v * v;
+		}
+		length += (tsReal) sqrt((double) dist);
+	}
+	return length;
+}
+
+void arc_length_line(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsArcLength table = ts_arc_length_init();
+	tsReal ctrlp[6] = { 0, 0, 10, 0, 30, 0 };
+	tsReal lengths[4] = { 5, 20, -1, 100 }, us[4];
+
+	___GIVEN___
+	C(ts_bspline_new(3, 2, 1, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_arc_length_new(&spline, 0, &table, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 2, (int) ts_arc_length_dimension(&table));
+	CuAssertDblEquals(tc, 30, ts_arc_length_length(&table),
+		POINT_EPSILON);
+	C(ts_arc_length_u_at_all(&table, lengths, 4, us, &status))
+	CuAssertDblEquals(tc, 0.25, us[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0.75, us[1], POINT_EPSILON);
+	/* Lengths are clamped. */
+	CuAssertDblEquals(tc, 0, us[2], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1, us[3], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_arc_length_free(&table);
+}
+
+void arc_length_compare_with_polyline(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsArcLength table = ts_arc_length_init();
+	tsArcLength copy = ts_arc_length_init();
+	tsReal ctrlp[14] = { 120, 100, 270, 40, 370, 490, 590, 40,
+		570, 490, 420, 480, 220, 500 };
+	tsReal *samples = NULL, *result = NULL, length, u;
+	size_t num, i;
+
+	___GIVEN___
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	C(ts_bspline_sample(&spline, 20001, &samples, &num, &status))
+
+	___WHEN___
+	C(ts_arc_length_new(&spline, 8, &table, &status))
+	C(ts_arc_length_copy(&table, &copy, &status))
+
+	___THEN___
+	length = polyline_length(samples, 20001, 2);
+	CuAssertDblEquals(tc, length, ts_arc_length_length(&copy),
+		length * 1e-4);
+	/* The polyline up to the sample at u has the length at u. */
+	for (i = 1; i < 10; i++) {
+		length = polyline_length(samples, i * 2000 + 1, 2);
+		C(ts_arc_length_u_at(&copy, length, &u, &status))
+		CuAssertDblEquals(tc, (tsReal) i / 10, u, 1e-4);
+	}
+	C(ts_bspline_eval_all(&spline, &u, 1, &result, &status))
+	CuAssertDblEquals(tc, samples[18000 * 2], result[0], 0.1);
+	CuAssertDblEquals(tc, samples[18000 * 2 + 1], result[1], 0.1);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_arc_length_free(&table);
+	ts_arc_length_free(&copy);
+	free(samples);
+	free(result);
+}
+
+void arc_length_sample_equidistant(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsArcLength table = ts_arc_length_init();
+	tsReal ctrlp[12] = { 0, 0, 0, 1, 0, 0, 1, 10, 0, 1, 10, 50 };
+	tsReal points[51 * 3], step, chord;
+	size_t num, i;
+
+	___GIVEN___
+	/* A spline whose speed changes a lot. */
+	C(ts_bspline_new(4, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	C(ts_arc_length_new(&spline, 0, &table, &status))
+
+	___WHEN___
+	C(ts_arc_length_sample(&table, 51, points, 51 * 3, &num, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 51, (int) num);
+	CuAssertDblEquals(tc, 0, points[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 50, points[50 * 3 + 2], POINT_EPSILON);
+	step = ts_arc_length_length(&table) / 50;
+	for (i = 1; i < 51; i++) {
+		/* Chords are shorter than arcs, especially at the corner
+		 * of the control polygon. */
+		chord = polyline_length(points + (i - 1) * 3, 2, 3);
+		CuAssertTrue(tc, chord <= step + POINT_EPSILON);
+		CuAssertTrue(tc, chord >= step * (tsReal) 0.9);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_arc_length_free(&table);
+}
+
+void arc_length_stationary(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsArcLength table = ts_arc_length_init();
+	tsReal ctrlp[6] = { 1, 2, 1, 2, 1, 2 };
+	tsReal points[4], u;
+	size_t num;
+
+	___GIVEN___
+	C(ts_bspline_new(3, 2, 2, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_arc_length_new(&spline, 0, &table, &status))
+
+	___THEN___
+	CuAssertDblEquals(tc, 0, ts_arc_length_length(&table),
+		POINT_EPSILON);
+	C(ts_arc_length_u_at(&table, 0, &u, &status))
+	CuAssertDblEquals(tc, 0, u, POINT_EPSILON);
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_arc_length_sample(&table,
+		3, points, 4, &num, &status));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, status.code);
+	C(ts_arc_length_sample(&table, 2, points, 4, &num, &status))
+	CuAssertDblEquals(tc, 1, points[2], POINT_EPSILON);
+	CuAssertDblEquals(tc, 2, points[3], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_arc_length_free(&table);
+}
+
+CuSuite* get_arc_length_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, arc_length_line);
+	SUITE_ADD_TEST(suite, arc_length_compare_with_polyline);
+	SUITE_ADD_TEST(suite, arc_length_sample_equidistant);
+	SUITE_ADD_TEST(suite, arc_length_stationary);
+	return suite;
+}
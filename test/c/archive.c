@@ -0,0 +1,208 @@
+#include <testutils.h>
+#include <string.h>
+
+/* Creates a spline whose control points depend on `id`. */
+void create_spline(CuTest *tc, size_t id, tsBSpline *spline)
+{
+	___SETUP___
+	tsReal *ctrlp = NULL;
+	size_t i;
+
+	___GIVEN___ ___WHEN___
+	C(ts_bspline_new(4 + id % 5, 2, 3, TS_CLAMPED, spline, &status))
+	C(ts_bspline_control_points(spline, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(spline); i++)
+		ctrlp[i] = (tsReal) (id * 10 + i);
+	C(ts_bspline_set_control_points(spline, ctrlp, &status))
+
+	___THEN___ ___TEARDOWN___
+	free(ctrlp);
+}
+
+/* Asserts that `actual` is the spline created by create_spline(id). */
+void assert_archived(CuTest *tc, size_t id, const tsBSpline *actual)
+{
+	___SETUP___
+	tsBSpline expected = ts_bspline_init();
+	unsigned char *bin_expected = NULL, *bin_actual = NULL;
+	size_t size_expected, size_actual;
+
+	___GIVEN___
+	create_spline(tc, id, &expected);
+
+	___WHEN___
+	C(ts_bspline_to_binary(&expected, &bin_expected, &size_expected,
+		&status))
+	C(ts_bspline_to_binary(actual, &bin_actual, &size_actual, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, (int) size_expected, (int) size_actual);
+	CuAssertTrue(tc, memcmp(bin_expected, bin_actual, size_actual) == 0);
+
+	___TEARDOWN___
+	ts_bspline_free(&expected);
+	free(bin_expected);
+	free(bin_actual);
+}
+
+void archive_append_load(CuTest *tc)
+{
+	___SETUP___
+	tsArchive archive = ts_archive_init();
+	tsBSpline spline = ts_bspline_init();
+	const size_t ids[5] = { 30, 10, 20, 50, 40 };
+	char *file = "archive_append_load.tsa";
+	size_t i, id;
+
+	___GIVEN___
+	remove(file);
+	C(ts_archive_open(file, &archive, &status))
+	CuAssertIntEquals(tc, 0, (int) ts_archive_num_splines(&archive));
+
+	___WHEN___
+	for (i = 0; i < 5; i++) {
+		create_spline(tc, ids[i], &spline);
+		C(ts_archive_append(&archive, ids[i], &spline, &status))
+		ts_bspline_free(&spline);
+	}
+	C(ts_archive_flush(&archive, &status))
+	ts_archive_free(&archive);
+
+	___THEN___
+	C(ts_archive_open(file, &archive, &status))
+	CuAssertIntEquals(tc, 5, (int) ts_archive_num_splines(&archive));
+	/* Random access. */
+	for (i = 0; i < 5; i++) {
+		C(ts_archive_load(&archive, ids[i], &spline, &status))
+		assert_archived(tc, ids[i], &spline);
+		ts_bspline_free(&spline);
+	}
+	/* Iteration in order of ids. */
+	for (i = 0; i < 5; i++) {
+		C(ts_archive_id_at(&archive, i, &id, &status))
+		CuAssertIntEquals(tc, (int) (i + 1) * 10, (int) id);
+		C(ts_archive_load_at(&archive, i, &spline, &status))
+		assert_archived(tc, id, &spline);
+		ts_bspline_free(&spline);
+	}
+
+	/* Append to an existing archive (flushed by ts_archive_free). */
+	create_spline(tc, 5, &spline);
+	C(ts_archive_append(&archive, 5, &spline, &status))
+	ts_bspline_free(&spline);
+	ts_archive_free(&archive);
+	C(ts_archive_open(file, &archive, &status))
+	CuAssertIntEquals(tc, 6, (int) ts_archive_num_splines(&archive));
+	C(ts_archive_id_at(&archive, 0, &id, &status))
+	CuAssertIntEquals(tc, 5, (int) id);
+	for (i = 0; i < 5; i++) {
+		C(ts_archive_load(&archive, ids[i], &spline, &status))
+		assert_archived(tc, ids[i], &spline);
+		ts_bspline_free(&spline);
+	}
+
+	___TEARDOWN___
+	ts_archive_free(&archive);
+	ts_bspline_free(&spline);
+	remove(file);
+}
+
+void archive_view(CuTest *tc)
+{
+	___SETUP___
+	const unsigned int one = 1;
+	tsArchive archive = ts_archive_init();
+	tsBSpline spline = ts_bspline_init();
+	tsBSplineView view;
+	char *file = "archive_view.tsa";
+	unsigned char *data = NULL;
+	FILE *fp = NULL;
+	long size;
+	size_t i;
+
+	___GIVEN___
+	/* Views require a 64-bit little endian machine. */
+	if (sizeof(size_t) != 8 || *((const unsigned char *) &one) != 1)
+		return;
+	remove(file);
+	C(ts_archive_open(file, &archive, &status))
+	for (i = 0; i < 100; i++) {
+		create_spline(tc, i * 3, &spline);
+		C(ts_archive_append(&archive, i * 3, &spline, &status))
+		ts_bspline_free(&spline);
+	}
+	ts_archive_free(&archive);
+	/* Read the whole archive (like mmap). */
+	fp = fopen(file, "rb");
+	CuAssertPtrNotNull(tc, fp);
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	data = (unsigned char *) malloc((size_t) size);
+	CuAssertPtrNotNull(tc, data);
+	CuAssertIntEquals(tc, (int) size,
+		(int) fread(data, 1, (size_t) size, fp));
+
+	___WHEN___ ___THEN___
+	for (i = 0; i < 100; i++) {
+		C(ts_archive_view(data, (size_t) size, i * 3, &view, &status))
+		assert_archived(tc, i * 3, ts_bspline_view_spline(&view));
+	}
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_archive_view(data, (size_t) size, 4, &view, NULL));
+
+	___TEARDOWN___
+	ts_archive_free(&archive);
+	ts_bspline_free(&spline);
+	if (fp)
+		fclose(fp);
+	free(data);
+	remove(file);
+}
+
+void archive_errors(CuTest *tc)
+{
+	___SETUP___
+	tsArchive archive = ts_archive_init();
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline loaded = ts_bspline_init();
+	char *file = "archive_errors.tsa";
+
+	___GIVEN___
+	remove(file);
+	C(ts_archive_open(file, &archive, &status))
+	create_spline(tc, 1, &spline);
+	C(ts_archive_append(&archive, 1, &spline, &status))
+
+	___WHEN___ ___THEN___
+	/* Unknown id. */
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_archive_load(&archive, 2, &loaded, NULL));
+	CuAssertPtrEquals(tc, NULL, loaded.pImpl);
+
+	/* Duplicate id. */
+	C(ts_archive_append(&archive, 1, &spline, &status))
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_archive_flush(&archive, NULL));
+	ts_archive_free(&archive);
+
+	/* Not an archive. */
+	C(ts_bspline_save(&spline, file, &status))
+	CuAssertIntEquals(tc, TS_PARSE_ERROR,
+		ts_archive_open(file, &archive, NULL));
+	CuAssertPtrEquals(tc, NULL, archive.pImpl);
+
+	___TEARDOWN___
+	ts_archive_free(&archive);
+	ts_bspline_free(&spline);
+	remove(file);
+}
+
+CuSuite* get_archive_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, archive_append_load);
+	SUITE_ADD_TEST(suite, archive_view);
+	SUITE_ADD_TEST(suite, archive_errors);
+	return suite;
+}
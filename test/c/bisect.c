@@ -357,6 +357,163 @@ void bisect_persnickety(CuTest *tc)
 	ts_deboornet_free(&net);
 }
 
+/* Evaluates `spline` at 1000 knots and compares the knots with the knots
+ * found by ts_bspline_solve_all and ts_bspline_solve. */
+void assert_solve_eval_equal(CuTest *tc, const tsBSpline *spline, size_t idx,
+	int asc)
+{
+	___SETUP___
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal knots[1000], values[1000], us[1000], *points = NULL;
+	tsReal min, max, point[3], dist;
+	size_t i;
+
+	___GIVEN___
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < 1000; i++)
+		knots[i] = min + (max - min) * (tsReal) i / 999;
+	C(ts_bspline_eval_all(spline, knots, 1000, &points, &status))
+	for (i = 0; i < 1000; i++)
+		values[i] = points[i * ts_bspline_dimension(spline) + idx];
+
+	___WHEN___
+	C(ts_bspline_solve_all(spline, values, 1000, (tsReal) 0.0, 0, idx,
+		asc, 50, us, &status))
+
+	___THEN___
+	for (i = 0; i < 1000; i++) {
+		CuAssertDblEquals(tc, knots[i], us[i], TS_KNOT_EPSILON);
+		if (i % 100 != 0)
+			continue;
+		C(ts_bspline_solve(spline, values[i], (tsReal) 0.0, 0, idx,
+			asc, 50, &net, &status))
+		CuAssertDblEquals(tc, knots[i], ts_deboornet_knot(&net),
+			TS_KNOT_EPSILON);
+		C(ts_bspline_eval_point(spline, knots[i], point, &status))
+		dist = ts_distance(point, ts_deboornet_result_ptr(&net),
+			ts_bspline_dimension(spline));
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+		ts_deboornet_free(&net);
+	}
+
+	___TEARDOWN___
+	ts_deboornet_free(&net);
+	free(points);
+}
+
+void solve_compare_with_eval(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		6, 3, 3, TS_OPENED, &spline, &status,
+		1.0,  9.0,  0.3,  /* P1 */
+		2.0,  8.5, -1.6,  /* P2 */
+		4.0,  5.4, -2.9,  /* P3 */
+		4.5,  0.0, -1.0,  /* P4 */
+		4.9, -3.6,  1.3,  /* P5 */
+		6.8, -6.3,  2.6)) /* P6 */
+
+	___WHEN___ ___THEN___
+	assert_solve_eval_equal(tc, &spline, 0, 1);
+	assert_solve_eval_equal(tc, &spline, 1, 0);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void solve_many_spans(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	size_t i;
+
+	___GIVEN___
+	/* A time series with uneven steps. */
+	C(ts_bspline_new(500, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < 500; i++) {
+		ctrlp[i * 2] = (tsReal) (i * 10 + (i * 7) % 5);
+		ctrlp[i * 2 + 1] = (tsReal) ((i * 13) % 11);
+	}
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___ ___THEN___
+	assert_solve_eval_equal(tc, &spline, 0, 1);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+void solve_out_of_range(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal values[2] = { 0.0, 1300.0 }, us[2], min, max;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		5, 2, 2, TS_CLAMPED, &spline, &status,
+		100.0,  200.0,  /* P1 */
+		200.0,  300.0,  /* P2 */
+		400.0,  600.0,  /* P3 */
+		800.0,  450.0,  /* P4 */
+		1200.0, 120.0)) /* P5 */
+	ts_bspline_domain(&spline, &min, &max);
+
+	___WHEN___
+	C(ts_bspline_solve_all(&spline, values, 2, (tsReal) 0.01, 0, 0, 1, 10,
+		us, &status))
+
+	___THEN___
+	CuAssertDblEquals(tc, min, us[0], TS_KNOT_EPSILON);
+	CuAssertDblEquals(tc, max, us[1], TS_KNOT_EPSILON);
+	CuAssertIntEquals(tc, TS_NO_RESULT,
+		ts_bspline_solve(&spline, values[1], (tsReal) 0.01, 1, 0, 1,
+			10, &net, NULL));
+	CuAssertPtrEquals(tc, NULL, net.pImpl);
+	CuAssertIntEquals(tc, TS_NO_RESULT,
+		ts_bspline_solve_all(&spline, values, 2, (tsReal) 0.01, 1, 0,
+			1, 10, us, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_deboornet_free(&net);
+}
+
+void solve_invalid_arguments(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal value = (tsReal) 0.5, u;
+
+	___GIVEN___
+	C(ts_bspline_new(16, 3, 3, TS_OPENED, &spline, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_bspline_solve(&spline, value, (tsReal) 0.0, 0, 3, 1, 50,
+			&net, NULL));
+	CuAssertPtrEquals(tc, NULL, net.pImpl);
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_bspline_solve_all(&spline, &value, 1, (tsReal) 0.0, 0, 3,
+			1, 50, &u, NULL));
+	CuAssertIntEquals(tc, TS_NO_RESULT,
+		ts_bspline_solve(&spline, value, (tsReal) 0.0, 0, 0, 1, 0,
+			&net, NULL));
+	CuAssertPtrEquals(tc, NULL, net.pImpl);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_deboornet_free(&net);
+}
+
 CuSuite* get_bisect_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -369,5 +526,9 @@ CuSuite* get_bisect_suite()
 	SUITE_ADD_TEST(suite, bisect_max_iter_0);
 	SUITE_ADD_TEST(suite, bisect_descending_compare_with_eval);
 	SUITE_ADD_TEST(suite, bisect_persnickety);
+	SUITE_ADD_TEST(suite, solve_compare_with_eval);
+	SUITE_ADD_TEST(suite, solve_many_spans);
+	SUITE_ADD_TEST(suite, solve_out_of_range);
+	SUITE_ADD_TEST(suite, solve_invalid_arguments);
 	return suite;
 }
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <testutils.h>
+#include <math.h>
+
+/* Points on a spiral with duplicates at every seventh point. */
+void catmull_rom_fitter_points(tsReal *points, size_t num)
+{
+	size_t i, j;
+	for (i = 0, j = 0; i < num; i++) {
+		if (i % 7 == 6) {
+			points[i*2]     = points[(i-1)*2];
+			points[i*2 + 1] = points[(i-1)*2 + 1];
+			continue;
+		}
+		points[i*2]     = (tsReal) (cos(j * 0.5) * (10.0 + j));
+		points[i*2 + 1] = (tsReal) (sin(j * 0.5) * (10.0 + j));
+		j++;
+	}
+}
+
+void catmull_rom_fitter_compare_with_interpolate(CuTest *tc)
+{
+	___SETUP___
+	tsCatmullRomFitter fitter = ts_catmull_rom_fitter_init();
+	tsBSpline expected = ts_bspline_init();
+	tsBSpline actual = ts_bspline_init();
+	tsReal points[40], first[2] = { -20.0, 5.0 }, last[2] = { 0.0, 0.0 };
+	size_t n, i;
+
+	___GIVEN___
+	catmull_rom_fitter_points(points, 20);
+
+	for (n = 1; n <= 20; n++) {
+		___WHEN___
+		C(ts_catmull_rom_fitter_new(2, (tsReal) 0.5,
+			n % 2 ? first : NULL, POINT_EPSILON, &fitter,
+			&status))
+		/* Push the first point separately. */
+		C(ts_catmull_rom_fitter_push(&fitter, points, 1, &status))
+		C(ts_catmull_rom_fitter_push(&fitter, points + 2, n - 1,
+			&status))
+		C(ts_catmull_rom_fitter_spline(&fitter, n % 3 ? last : NULL,
+			&actual, &status))
+		C(ts_bspline_interpolate_catmull_rom(points, n, 2,
+			(tsReal) 0.5, n % 2 ? first : NULL,
+			n % 3 ? last : NULL, POINT_EPSILON, &expected,
+			&status))
+
+		___THEN___
+		CuAssertIntEquals(tc,
+			(int) ts_bspline_num_control_points(&expected),
+			(int) ts_bspline_num_control_points(&actual));
+		if (ts_catmull_rom_fitter_num_points(&fitter) >= 2) {
+			CuAssertIntEquals(tc, (int)
+				ts_catmull_rom_fitter_num_points(&fitter) - 2,
+				(int) ts_catmull_rom_fitter_num_finished(
+				&fitter));
+		}
+		for (i = 0; i < ts_bspline_len_control_points(&actual); i++) {
+			CuAssertDblEquals(tc,
+				ts_bspline_control_points_ptr(&expected)[i],
+				ts_bspline_control_points_ptr(&actual)[i],
+				POINT_EPSILON);
+		}
+		ts_catmull_rom_fitter_free(&fitter);
+		ts_bspline_free(&expected);
+		ts_bspline_free(&actual);
+	}
+
+	___TEARDOWN___
+	ts_catmull_rom_fitter_free(&fitter);
+	ts_bspline_free(&expected);
+	ts_bspline_free(&actual);
+}
+
+void catmull_rom_fitter_take_segments(CuTest *tc)
+{
+	___SETUP___
+	tsCatmullRomFitter fitter = ts_catmull_rom_fitter_init();
+	tsCatmullRomFitter copy = ts_catmull_rom_fitter_init();
+	tsBSpline expected = ts_bspline_init();
+	tsBSpline segments = ts_bspline_init();
+	tsBSpline none = ts_bspline_init();
+	tsReal points[200];
+	const tsReal *ctrlp;
+	size_t i, j, offset = 0;
+
+	___GIVEN___
+	catmull_rom_fitter_points(points, 100);
+	C(ts_bspline_interpolate_catmull_rom(points, 100, 2, (tsReal) 1.0,
+		NULL, NULL, POINT_EPSILON, &expected, &status))
+	C(ts_catmull_rom_fitter_new(2, (tsReal) 1.0, NULL, POINT_EPSILON,
+		&fitter, &status))
+
+	___WHEN___
+	/* Push chunks of 10 points and take the finished segments. */
+	for (i = 0; i < 100; i += 10) {
+		C(ts_catmull_rom_fitter_push(&fitter, points + i * 2, 10,
+			&status))
+		C(ts_catmull_rom_fitter_take(&fitter, &segments, &status))
+		CuAssertIntEquals(tc, 0, (int)
+			ts_catmull_rom_fitter_num_finished(&fitter));
+		ctrlp = ts_bspline_control_points_ptr(&segments);
+		for (j = 0; j < ts_bspline_len_control_points(&segments);
+				j++) {
+			CuAssertDblEquals(tc,
+				ts_bspline_control_points_ptr(&expected)
+				[offset + j], ctrlp[j], POINT_EPSILON);
+		}
+		offset += ts_bspline_len_control_points(&segments);
+		ts_bspline_free(&segments);
+	}
+	C(ts_catmull_rom_fitter_copy(&fitter, &copy, &status))
+	C(ts_catmull_rom_fitter_spline(&copy, NULL, &segments, &status))
+
+	___THEN___
+	/* The unfinished segment completes the spline. */
+	CuAssertIntEquals(tc, (int) ts_bspline_len_control_points(&expected),
+		(int) (offset + ts_bspline_len_control_points(&segments)));
+	ctrlp = ts_bspline_control_points_ptr(&segments);
+	for (j = 0; j < ts_bspline_len_control_points(&segments); j++) {
+		CuAssertDblEquals(tc,
+			ts_bspline_control_points_ptr(&expected)[offset + j],
+			ctrlp[j], POINT_EPSILON);
+	}
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_catmull_rom_fitter_take(&fitter, &none, NULL));
+	CuAssertPtrEquals(tc, NULL, none.pImpl);
+
+	___TEARDOWN___
+	ts_catmull_rom_fitter_free(&fitter);
+	ts_catmull_rom_fitter_free(&copy);
+	ts_bspline_free(&expected);
+	ts_bspline_free(&segments);
+}
+
+void catmull_rom_fitter_invalid_input(CuTest *tc)
+{
+	___SETUP___
+	tsCatmullRomFitter fitter = ts_catmull_rom_fitter_init();
+	tsBSpline spline = ts_bspline_init();
+
+	___GIVEN___
+	/* Nothing to do here. */
+
+	___WHEN___
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_catmull_rom_fitter_new(0,
+		(tsReal) 0.5, NULL, POINT_EPSILON, &fitter, NULL));
+	CuAssertPtrEquals(tc, NULL, fitter.pImpl);
+	C(ts_catmull_rom_fitter_new(3, (tsReal) 0.5, NULL, POINT_EPSILON,
+		&fitter, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 3,
+		(int) ts_catmull_rom_fitter_dimension(&fitter));
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_catmull_rom_fitter_spline(&fitter, NULL, &spline, NULL));
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+
+	___TEARDOWN___
+	ts_catmull_rom_fitter_free(&fitter);
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_catmull_rom_fitter_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, catmull_rom_fitter_compare_with_interpolate);
+	SUITE_ADD_TEST(suite, catmull_rom_fitter_take_segments);
+	SUITE_ADD_TEST(suite, catmull_rom_fitter_invalid_input);
+	return suite;
+}
@@ -0,0 +1,366 @@
+#include <testutils.h>
+
+/* Compares ts_compiled_spline_eval_all with ts_bspline_eval_all_into at
+ * unsorted knots including the domain boundaries and the knots of
+ * `spline`. */
+void assert_compiled_equals_eval(CuTest *tc, const tsBSpline *spline)
+{
+	___SETUP___
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const tsReal *knots = ts_bspline_knots_ptr(spline);
+	tsReal us[64], expected[64 * 4], points[64 * 4], min, max;
+	size_t i, num = 0;
+
+	___GIVEN___
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < 41; i++)
+		us[num++] = min + (max - min) * (tsReal) ((i * 17) % 41) / 40;
+	for (i = 0; i < num_knots && num < 64; i++) {
+		if (knots[i] >= min && knots[i] <= max)
+			us[num++] = knots[i];
+	}
+	C(ts_compiled_spline_new(spline, &compiled, &status))
+
+	___WHEN___
+	C(ts_bspline_eval_all_into(spline, us, num, expected, num * dim,
+		&status))
+	C(ts_compiled_spline_eval_all(&compiled, us, num, points, num * dim,
+		&status))
+
+	___THEN___
+	for (i = 0; i < num; i++) {
+		CuAssertDblEquals(tc, 0, ts_distance(expected + i * dim,
+			points + i * dim, dim), POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	ts_compiled_spline_free(&compiled);
+}
+
+void compiled_equals_eval(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSplineType types[3] = { TS_CLAMPED, TS_OPENED, TS_BEZIERS };
+	size_t num_ctrlp[3] = { 10, 9, 12 }, degs[3] = { 3, 2, 3 };
+	tsReal *ctrlp = NULL;
+	size_t t, i;
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	for (t = 0; t < 3; t++) {
+		C(ts_bspline_new(num_ctrlp[t], 3, degs[t], types[t], &spline,
+			&status))
+		C(ts_bspline_control_points(&spline, &ctrlp, &status))
+		for (i = 0; i < num_ctrlp[t] * 3; i++)
+			ctrlp[i] = (tsReal) ((i * 7 + 3) % 11) - 5;
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		assert_compiled_equals_eval(tc, &spline);
+		free(ctrlp);
+		ctrlp = NULL;
+		ts_bspline_free(&spline);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+void compiled_sample(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	tsReal *expected = NULL, points[150 * 2];
+	size_t i, num;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		6, 2, 3, TS_CLAMPED, &spline, &status,
+		-2.0, 1.0,
+		-1.0, 3.0,
+		 0.5, -1.0,
+		 2.0, 0.0,
+		 3.5, 4.0,
+		 5.0, 1.0))
+	C(ts_compiled_spline_new(&spline, &compiled, &status))
+
+	___WHEN___
+	C(ts_bspline_sample(&spline, 0, &expected, &num, &status))
+	CuAssertIntEquals(tc, 90, (int) num);
+	C(ts_compiled_spline_sample(&compiled, 0, points, 150 * 2, &num,
+		&status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 90, (int) num);
+	for (i = 0; i < num; i++) {
+		CuAssertDblEquals(tc, 0, ts_distance(expected + i * 2,
+			points + i * 2, 2), POINT_EPSILON);
+	}
+	/* The first point is exact. */
+	CuAssertDblEquals(tc, -2.0, points[0], 0);
+	CuAssertDblEquals(tc, 1.0, points[1], 0);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_compiled_spline_free(&compiled);
+	free(expected);
+}
+
+void compiled_discontinuous(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	tsReal expected[5], points[5];
+	size_t i, num;
+
+	___GIVEN___
+	/* The spline is discontinuous at 0.5. */
+	C(ts_bspline_new_with_control_points(
+		6, 1, 2, TS_CLAMPED, &spline, &status,
+		0.0, 1.0, 2.0, 10.0, 11.0, 12.0))
+	C(ts_bspline_set_knots_varargs(&spline, &status,
+		(tsReal) 0.0, 0.0, 0.0, 0.5, 0.5, 0.5, 1.0, 1.0, 1.0))
+
+	C(ts_compiled_spline_new(&spline, &compiled, &status))
+
+	___WHEN___ ___THEN___
+	/* Takes the first of the two points at 0.5 (like ts_bspline_eval). */
+	assert_compiled_equals_eval(tc, &spline);
+	/* Sampling does the same (the third knot is 0.5). */
+	C(ts_bspline_sample_into(&spline, 5, expected, 5, &num, &status))
+	C(ts_compiled_spline_sample(&compiled, 5, points, 5, &num, &status))
+	for (i = 0; i < 5; i++)
+		CuAssertDblEquals(tc, expected[i], points[i], POINT_EPSILON);
+	CuAssertDblEquals(tc, 2, points[2], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_compiled_spline_free(&compiled);
+}
+
+void compiled_near_knots(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	const tsReal offset = TS_KNOT_EPSILON / 2;
+	tsReal us[6], expected[6], points[6];
+	size_t i;
+
+	___GIVEN___
+	/* Steep, so that not snapping a knot to its breakpoint is visible. */
+	C(ts_bspline_new_with_control_points(
+		5, 1, 3, TS_CLAMPED, &spline, &status,
+		0.0, 1000.0, -1000.0, 1000.0, 0.0))
+	C(ts_compiled_spline_new(&spline, &compiled, &status))
+	us[0] = offset;
+	us[1] = (tsReal) 0.5 - offset;
+	us[2] = (tsReal) 0.5 + offset;
+	us[3] = 1 - offset;
+	us[4] = -offset;
+	us[5] = 1 + offset;
+
+	___WHEN___
+	C(ts_bspline_eval_all_into(&spline, us, 6, expected, 6, &status))
+	C(ts_compiled_spline_eval_all(&compiled, us, 6, points, 6, &status))
+
+	___THEN___
+	/* Like De Boor's algorithm, knots within TS_KNOT_EPSILON of a
+	 * breakpoint are evaluated at the breakpoint. */
+	for (i = 0; i < 6; i++)
+		CuAssertDblEquals(tc, expected[i], points[i], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_compiled_spline_free(&compiled);
+}
+
+void compiled_snapshot(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	tsCompiledSpline copy = ts_compiled_spline_init();
+	tsCompiledSpline moved = ts_compiled_spline_init();
+	tsReal point[2] = { 5, 5 }, expected[2], actual[2], min, max;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		4, 2, 2, TS_CLAMPED, &spline, &status,
+		0.0, 0.0,
+		1.0, 2.0,
+		2.0, -1.0,
+		3.0, 0.0))
+	C(ts_bspline_eval_point(&spline, (tsReal) 0.3, expected, &status))
+	C(ts_compiled_spline_new(&spline, &compiled, &status))
+
+	___WHEN___
+	C(ts_bspline_set_control_point_at(&spline, 1, point, &status))
+	C(ts_compiled_spline_copy(&compiled, &copy, &status))
+	ts_compiled_spline_move(&copy, &moved);
+	ts_bspline_free(&spline);
+
+	___THEN___
+	/* Modifying or freeing the spline does not affect the compiled
+	 * spline. */
+	CuAssertIntEquals(tc, 2, (int) ts_compiled_spline_dimension(&moved));
+	ts_compiled_spline_domain(&moved, &min, &max);
+	CuAssertDblEquals(tc, 0, min, 0);
+	CuAssertDblEquals(tc, 1, max, 0);
+	C(ts_compiled_spline_eval(&moved, (tsReal) 0.3, actual, &status))
+	CuAssertDblEquals(tc, 0, ts_distance(expected, actual, 2),
+		POINT_EPSILON);
+	CuAssertPtrEquals(tc, NULL, copy.pImpl);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_compiled_spline_free(&compiled);
+	ts_compiled_spline_free(&copy);
+	ts_compiled_spline_free(&moved);
+}
+
+void compiled_check(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline other = ts_bspline_init();
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	tsReal point[2] = { 5, 5 }, knot;
+	tsStatus actual;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		4, 2, 2, TS_CLAMPED, &spline, &status,
+		0.0, 0.0,
+		1.0, 2.0,
+		2.0, -1.0,
+		3.0, 0.0))
+	C(ts_compiled_spline_new(&spline, &compiled, &status))
+
+	___WHEN___ ___THEN___
+	C(ts_compiled_spline_check(&compiled, &spline, &status))
+	/* A copy of the spline is compatible. */
+	C(ts_bspline_copy(&spline, &other, &status))
+	C(ts_compiled_spline_check(&compiled, &other, &status))
+
+	/* Knots within TS_KNOT_EPSILON are equal. */
+	C(ts_bspline_knot_at(&other, 3, &knot, &status))
+	C(ts_bspline_set_knot_at(&other, 3,
+		knot + (tsReal) TS_KNOT_EPSILON / 2, &status))
+	C(ts_compiled_spline_check(&compiled, &other, &status))
+
+	/* Different knots. */
+	C(ts_bspline_set_knot_at(&other, 3, (tsReal) 0.75, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_compiled_spline_check(
+		&compiled, &other, &actual));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, actual.code);
+
+	/* Modified control point. */
+	C(ts_bspline_set_control_point_at(&spline, 1, point, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_compiled_spline_check(
+		&compiled, &spline, NULL));
+
+	/* Different degree and number of control points. */
+	ts_bspline_free(&other);
+	C(ts_bspline_new(4, 2, 3, TS_CLAMPED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_compiled_spline_check(
+		&compiled, &other, NULL));
+	ts_bspline_free(&other);
+	C(ts_bspline_new(5, 2, 2, TS_CLAMPED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_compiled_spline_check(
+		&compiled, &other, NULL));
+
+	/* Different dimension. */
+	ts_bspline_free(&other);
+	C(ts_bspline_new(4, 3, 2, TS_CLAMPED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_compiled_spline_check(
+		&compiled, &other, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&other);
+	ts_compiled_spline_free(&compiled);
+}
+
+void compiled_view(CuTest *tc)
+{
+	___SETUP___
+	const unsigned int one = 1;
+	tsBSpline spline = ts_bspline_init();
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	tsBSplineView view;
+	unsigned char *binary = NULL;
+	size_t size;
+
+	___GIVEN___
+	/* Views require a 64-bit little endian machine. */
+	if (sizeof(size_t) != 8 || *((const unsigned char *) &one) != 1)
+		return;
+	C(ts_bspline_new_with_control_points(
+		5, 2, 3, TS_CLAMPED, &spline, &status,
+		0.0, 0.0,
+		1.0, 3.0,
+		2.0, -2.0,
+		4.0, 1.0,
+		5.0, 0.0))
+	C(ts_bspline_to_binary(&spline, &binary, &size, &status))
+	C(ts_bspline_view_binary(binary, size, &view, &status))
+
+	___WHEN___ ___THEN___
+	/* The spline of a view has no header to store state in. */
+	assert_compiled_equals_eval(tc, ts_bspline_view_spline(&view));
+	C(ts_compiled_spline_new(ts_bspline_view_spline(&view), &compiled,
+		&status))
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_compiled_spline_free(&compiled);
+	free(binary);
+}
+
+void compiled_errors(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsCompiledSpline compiled = ts_compiled_spline_init();
+	tsStatus actual;
+	tsReal us[2] = { 0, 2 }, points[6];
+	size_t num;
+
+	___GIVEN___
+	C(ts_bspline_new(5, 3, 2, TS_CLAMPED, &spline, &status))
+	C(ts_compiled_spline_new(&spline, &compiled, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_compiled_spline_eval_all(
+		&compiled, us, 2, points, 5, NULL));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_compiled_spline_eval_all(
+		&compiled, us, 2, points, 6, &actual));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, actual.code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_compiled_spline_eval(
+		&compiled, -1, points, NULL));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_compiled_spline_sample(
+		&compiled, 3, points, 6, &num, NULL));
+	CuAssertIntEquals(tc, 3, (int) num);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_compiled_spline_free(&compiled);
+}
+
+CuSuite* get_compiled_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, compiled_equals_eval);
+	SUITE_ADD_TEST(suite, compiled_sample);
+	SUITE_ADD_TEST(suite, compiled_discontinuous);
+	SUITE_ADD_TEST(suite, compiled_near_knots);
+	SUITE_ADD_TEST(suite, compiled_snapshot);
+	SUITE_ADD_TEST(suite, compiled_check);
+	SUITE_ADD_TEST(suite, compiled_view);
+	SUITE_ADD_TEST(suite, compiled_errors);
+	return suite;
+}
@@ -473,6 +473,166 @@ void derive_compare_third_derivative_with_three_times(CuTest *tc)
 	ts_bspline_free(&three);
 }
 
+void derive_many_beziers(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal *ctrlp = NULL, *result = NULL;
+	const size_t num_beziers = 2000;
+	size_t i, j;
+
+	___GIVEN___
+	/* A straight line made of many cubic bezier curves. */
+	C(ts_bspline_new(num_beziers * 4, 2, 3, TS_BEZIERS, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < num_beziers; i++) {
+		for (j = 0; j < 4; j++) {
+			ctrlp[(i*4 + j) * 2] = (tsReal) i + (tsReal) j / 3;
+			ctrlp[(i*4 + j) * 2 + 1] = (tsReal) 1.0;
+		}
+	}
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_bspline_derive(&spline, 1, POINT_EPSILON, &spline, &status))
+
+	___THEN___
+	/* All but one of the duplicate control points have been removed. */
+	CuAssertIntEquals(tc, 2, (int) ts_bspline_degree(&spline));
+	CuAssertIntEquals(tc, (int) (num_beziers * 3),
+		(int) ts_bspline_num_control_points(&spline));
+	/* The knots of the segments are rounded, which skews the slope of
+	 * each segment by a fraction of a percent. */
+	for (i = 0; i <= 10; i++) {
+		C(ts_bspline_eval(&spline, (tsReal) i / 10, &net, &status))
+		C(ts_deboornet_result(&net, &result, &status))
+		CuAssertDblEquals(tc, (tsReal) num_beziers, result[0],
+			(tsReal) num_beziers * 1e-3);
+		CuAssertDblEquals(tc, 0, result[1], POINT_EPSILON);
+		ts_deboornet_free(&net);
+		free(result);
+		result = NULL;
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_deboornet_free(&net);
+	free(ctrlp);
+	free(result);
+}
+
+void derive_cached_compare_with_derive(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline second = ts_bspline_init();
+	const tsBSpline *cached = NULL, *first = NULL, *again = NULL;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		5, 2, 3, TS_CLAMPED, &spline, &status,
+		1.0, 1.0,  /* P1 */
+		2.0, 4.0,  /* P2 */
+		3.0, 3.0,  /* P3 */
+		4.0, 0.0,  /* P4 */
+		6.0, 2.0)) /* P5 */
+	C(ts_bspline_derive(&spline, 2, POINT_EPSILON, &second, &status))
+
+	___WHEN___
+	C(ts_bspline_cached_derivative(&spline, 0, POINT_EPSILON, &cached,
+		&status))
+	CuAssertPtrEquals(tc, &spline, (void *) cached);
+	C(ts_bspline_cached_derivative(&spline, 1, POINT_EPSILON, &first,
+		&status))
+	C(ts_bspline_cached_derivative(&spline, 2, POINT_EPSILON, &cached,
+		&status))
+	C(ts_bspline_cached_derivative(&spline, 2, POINT_EPSILON, &again,
+		&status))
+
+	___THEN___
+	/* Repeated calls return the cached derivative. */
+	CuAssertPtrEquals(tc, (void *) cached, (void *) again);
+	C(ts_bspline_cached_derivative(&spline, 1, POINT_EPSILON, &again,
+		&status))
+	CuAssertIntEquals(tc, 2, (int) ts_bspline_degree(again));
+	assert_equal_shape(tc, (tsBSpline *) cached, &second);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&second);
+}
+
+void derive_cached_invalidated_by_modification(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline expected = ts_bspline_init();
+	const tsBSpline *cached = NULL;
+	tsReal ctrlp[2] = { 5.0, -3.0 };
+	tsReal *knots = NULL;
+	size_t k;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		4, 2, 2, TS_CLAMPED, &spline, &status,
+		1.0, 1.0,  /* P1 */
+		2.0, 4.0,  /* P2 */
+		3.0, 3.0,  /* P3 */
+		4.0, 0.0)) /* P4 */
+	C(ts_bspline_cached_derivative(&spline, 1, POINT_EPSILON, &cached,
+		&status))
+
+	___WHEN___
+	C(ts_bspline_set_control_point_at(&spline, 1, ctrlp, &status))
+
+	___THEN___
+	C(ts_bspline_cached_derivative(&spline, 1, POINT_EPSILON, &cached,
+		&status))
+	C(ts_bspline_derive(&spline, 1, POINT_EPSILON, &expected, &status))
+	assert_equal_shape(tc, (tsBSpline *) cached, &expected);
+	ts_bspline_free(&expected);
+
+	___WHEN___
+	C(ts_bspline_knots(&spline, &knots, &status))
+	knots[3] = (tsReal) 0.25;
+	C(ts_bspline_set_knots(&spline, knots, &status))
+
+	___THEN___
+	C(ts_bspline_cached_derivative(&spline, 1, POINT_EPSILON, &cached,
+		&status))
+	C(ts_bspline_derive(&spline, 1, POINT_EPSILON, &expected, &status))
+	assert_equal_shape(tc, (tsBSpline *) cached, &expected);
+	ts_bspline_free(&expected);
+
+	___WHEN___
+	C(ts_bspline_tension(&spline, (tsReal) 0.5, &spline, &status))
+
+	___THEN___
+	C(ts_bspline_cached_derivative(&spline, 2, POINT_EPSILON, &cached,
+		&status))
+	C(ts_bspline_derive(&spline, 2, POINT_EPSILON, &expected, &status))
+	assert_equal_shape(tc, (tsBSpline *) cached, &expected);
+	ts_bspline_free(&expected);
+
+	___WHEN___
+	C(ts_bspline_insert_knot(&spline, (tsReal) 0.5, 1, &spline, &k,
+		&status))
+	ts_bspline_clear_cache(&spline);
+	ts_bspline_clear_cache(&spline);
+
+	___THEN___
+	C(ts_bspline_cached_derivative(&spline, 1, (tsReal) -1.0, &cached,
+		&status))
+	C(ts_bspline_derive(&spline, 1, (tsReal) -1.0, &expected, &status))
+	assert_equal_shape(tc, (tsBSpline *) cached, &expected);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&expected);
+	free(knots);
+}
+
 CuSuite* get_derive_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -487,5 +647,8 @@ CuSuite* get_derive_suite()
 	SUITE_ADD_TEST(suite, derive_continuous_spline);
 	SUITE_ADD_TEST(suite, derive_continuous_spline_with_custom_knots);
 	SUITE_ADD_TEST(suite, derive_compare_third_derivative_with_three_times);
+	SUITE_ADD_TEST(suite, derive_many_beziers);
+	SUITE_ADD_TEST(suite, derive_cached_compare_with_derive);
+	SUITE_ADD_TEST(suite, derive_cached_invalidated_by_modification);
 	return suite;
 }
\ No newline at end of file
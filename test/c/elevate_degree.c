@@ -172,6 +172,145 @@ void elevate_degree_bspline(CuTest *tc)
 	ts_bspline_free(&elevated);
 }
 
+/* Runs the tasks in reverse order and counts the number of calls. */
+void elevate_reverse_executor(void *data, size_t num_tasks, tsTask task,
+	void *context)
+{
+	size_t *num_calls = (size_t *) data;
+	while (num_tasks > 0)
+		task(context, --num_tasks);
+	(*num_calls)++;
+}
+
+void elevate_degree_parallel(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline expected = ts_bspline_init();
+	tsBSpline actual = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	size_t grain_sizes[4] = { 0, 1, 3, 100 };
+	size_t i, j, k, num_calls = 0;
+	tsBSplineType types[2] = { TS_CLAMPED, TS_BEZIERS };
+
+	___GIVEN___
+	for (k = 0; k < 2; k++) {
+		C(ts_bspline_new(36, 2, 3, types[k], &spline, &status))
+		C(ts_bspline_control_points(&spline, &ctrlp, &status))
+		for (i = 0; i < 72; i++)
+			ctrlp[i] = (tsReal) ((i * i * 7 + i) % 13);
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		free(ctrlp);
+		ctrlp = NULL;
+
+		for (i = 1; i <= 3; i++) {
+			C(ts_bspline_elevate_degree(&spline, i, POINT_EPSILON,
+				&expected, &status))
+			for (j = 0; j < 4; j++) {
+				___WHEN___
+				C(ts_bspline_elevate_degree_parallel(&spline,
+					i, POINT_EPSILON, &actual,
+					grain_sizes[j],
+					elevate_reverse_executor, &num_calls,
+					&status))
+
+				___THEN___
+				assert_equal_shape(tc, &spline, &actual);
+				CuAssertIntEquals(tc, (int)
+					ts_bspline_num_control_points(
+						&expected), (int)
+					ts_bspline_num_control_points(
+						&actual));
+				assert_equal_shape(tc, &expected, &actual);
+				ts_bspline_free(&actual);
+			}
+			ts_bspline_free(&expected);
+		}
+		if (types[k] == TS_BEZIERS) {
+			/* The segments of `spline' are discontinuous. */
+			C(ts_bspline_elevate_degree(&spline, 2, POINT_EPSILON,
+				&expected, &status))
+			CuAssertIntEquals(tc, 9 * 6, (int)
+				ts_bspline_num_control_points(&expected));
+			ts_bspline_free(&expected);
+		}
+		ts_bspline_free(&spline);
+	}
+	CuAssertIntEquals(tc, 2 * 3 * 4, (int) num_calls);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&expected);
+	ts_bspline_free(&actual);
+	free(ctrlp);
+}
+
+void elevate_to_common_degree(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[3], elevated[3], copies[3];
+	size_t i, num_calls = 0;
+
+	for (i = 0; i < 3; i++) {
+		splines[i] = ts_bspline_init();
+		elevated[i] = ts_bspline_init();
+		copies[i] = ts_bspline_init();
+	}
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		3, 2, 1, TS_CLAMPED, &splines[0], &status,
+		0.0, 0.0,   /* P1 */
+		10.0, 5.0,  /* P2 */
+		20.0, 0.0)) /* P3 */
+	C(ts_bspline_new_with_control_points(
+		5, 2, 4, TS_CLAMPED, &splines[1], &status,
+		60.0, 150.0,   /* P1 */
+		200.0, 300.0,  /* P2 */
+		370.0, 490.0,  /* P3 */
+		590.0, 40.0,   /* P4 */
+		570.0, 490.0)) /* P5 */
+	C(ts_bspline_new_with_control_points(
+		6, 2, 2, TS_OPENED, &splines[2], &status,
+		1.7, 7.9,    /* P1 */
+		-9.2, -3.1,  /* P2 */
+		-0.1, 0.5,   /* P3 */
+		4.0, 2.0,    /* P4 */
+		8.0, 3.0,    /* P5 */
+		10.0, 15.0)) /* P6 */
+	for (i = 0; i < 3; i++)
+		C(ts_bspline_copy(&splines[i], &copies[i], &status))
+
+	___WHEN___
+	C(ts_bspline_elevate_to_common_degree(splines, 3, POINT_EPSILON,
+		elevated, 0, elevate_reverse_executor, &num_calls, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 1, (int) num_calls);
+	for (i = 0; i < 3; i++) {
+		CuAssertIntEquals(tc, 4, (int) ts_bspline_degree(&elevated[i]));
+		assert_equal_shape(tc, &splines[i], &elevated[i]);
+	}
+
+	___WHEN___
+	/* In place. */
+	C(ts_bspline_elevate_to_common_degree(splines, 3, POINT_EPSILON,
+		splines, 2, NULL, NULL, &status))
+
+	___THEN___
+	for (i = 0; i < 3; i++) {
+		CuAssertIntEquals(tc, 4, (int) ts_bspline_degree(&splines[i]));
+		assert_equal_shape(tc, &copies[i], &splines[i]);
+	}
+
+	___TEARDOWN___
+	for (i = 0; i < 3; i++) {
+		ts_bspline_free(&splines[i]);
+		ts_bspline_free(&elevated[i]);
+		ts_bspline_free(&copies[i]);
+	}
+}
+
 CuSuite* get_elevate_degree_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -179,5 +318,7 @@ CuSuite* get_elevate_degree_suite()
 	SUITE_ADD_TEST(suite, elevate_degree_line);
 	SUITE_ADD_TEST(suite, elevate_degree_bezier_curve);
 	SUITE_ADD_TEST(suite, elevate_degree_bspline);
+	SUITE_ADD_TEST(suite, elevate_degree_parallel);
+	SUITE_ADD_TEST(suite, elevate_to_common_degree);
 	return suite;
 }
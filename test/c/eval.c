@@ -1,4 +1,5 @@
 #include <testutils.h>
+#include <math.h>
 
 void eval_domain_min(CuTest *tc)
 {
@@ -300,6 +301,607 @@ void eval_near_miss_knot(CuTest *tc)
 	ts_deboornet_free(&net);
 }
 
+void eval_near_miss_domain_min(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal min, max, dist, point[2], *result = NULL;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		4, 2, 3, TS_CLAMPED, &spline, &status,
+		1.0, 2.0,  /* P1 */
+		2.0, 3.0,  /* P2 */
+		3.0, 1.0,  /* P3 */
+		4.0, 2.0)) /* P4 */
+	ts_bspline_domain(&spline, &min, &max);
+
+	___WHEN___
+	/* Used to loop forever. */
+	C(ts_bspline_eval(&spline, min - (tsReal) TS_KNOT_EPSILON / 2, &net,
+		&status))
+	C(ts_bspline_eval_point(&spline, min - (tsReal) TS_KNOT_EPSILON / 2,
+		point, &status))
+
+	___THEN___
+	C(ts_deboornet_result(&net, &result, &status))
+	dist = ts_distance_varargs(tc, 2, result, 1.0, 2.0);
+	CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+	dist = ts_distance_varargs(tc, 2, point, 1.0, 2.0);
+	CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_deboornet_free(&net);
+	free(result);
+}
+
+void eval_into_reuses_net(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsDeBoorNet expected = ts_deboornet_init();
+	tsReal dist, *result = NULL, *expected_result = NULL;
+	struct tsDeBoorNetImpl *impl;
+	size_t i;
+	tsError err;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		7, 2, 3, TS_CLAMPED, &spline, &status,
+		-1.75, -1.0,  /* P1 */
+		-1.5,  -0.5,  /* P2 */
+		-1.5,   0.0,  /* P3 */
+		-1.25,  0.5,  /* P4 */
+		-0.75,  0.75, /* P5 */
+		 0.0,   0.5,  /* P6 */
+		 0.5,   0.0)) /* P7 */
+	C(ts_bspline_to_beziers(&spline, &beziers, &status))
+	C(ts_bspline_eval_into(&spline, (tsReal) 0.0, &net, &status))
+	impl = net.pImpl;
+
+	for (i = 0; i <= 10; i++) {
+		___WHEN___
+		C(ts_bspline_eval_into(i % 2 ? &spline : &beziers,
+			(tsReal) i / 10, &net, &status))
+		C(ts_bspline_eval(i % 2 ? &spline : &beziers,
+			(tsReal) i / 10, &expected, &status))
+
+		___THEN___
+		CuAssertPtrEquals(tc, impl, net.pImpl);
+		CuAssertIntEquals(tc,
+			(int) ts_deboornet_num_points(&expected),
+			(int) ts_deboornet_num_points(&net));
+		C(ts_deboornet_result(&net, &result, &status))
+		C(ts_deboornet_result(&expected, &expected_result, &status))
+		dist = ts_distance(result, expected_result, 2);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+
+		ts_deboornet_free(&expected);
+		free(result);
+		free(expected_result);
+		result = expected_result = NULL;
+	}
+
+	___WHEN___
+	/* Undefined knots must not modify the net. */
+	err = ts_bspline_eval_into(&spline, (tsReal) 2.0, &net, NULL);
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, err);
+	CuAssertPtrEquals(tc, impl, net.pImpl);
+	CuAssertDblEquals(tc, 1.0, ts_deboornet_knot(&net), TS_KNOT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&beziers);
+	ts_deboornet_free(&net);
+	ts_deboornet_free(&expected);
+	free(result);
+	free(expected_result);
+}
+
+void assert_eval_point_equals_eval(CuTest *tc, tsBSpline *spline)
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal *point = NULL, *result = NULL;
+	tsReal min, max, u, dist;
+	const size_t dim = ts_bspline_dimension(spline);
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		point = (tsReal *) malloc(dim * sizeof(tsReal));
+		if (!point)
+			TS_THROW_0(try, status.code, &status, TS_MALLOC,
+				"out of memory")
+		ts_bspline_domain(spline, &min, &max);
+		for (i = 0; i <= 100; i++) {
+			u = min + (max - min) * ((tsReal) i / 100);
+			TS_CALL(try, status.code, ts_bspline_eval_point(
+				spline, u, point, &status))
+			TS_CALL(try, status.code, ts_bspline_eval(
+				spline, u, &net, &status))
+			TS_CALL(try, status.code, ts_deboornet_result(
+				&net, &result, &status))
+			dist = ts_distance(point, result, dim);
+			CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+			ts_deboornet_free(&net);
+			free(result);
+			result = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_deboornet_free(&net);
+		free(point);
+		free(result);
+	TS_END_TRY
+}
+
+void eval_point(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsBSpline large = ts_bspline_init();
+	tsBSpline linear = ts_bspline_init();
+	tsBSpline constant = ts_bspline_init();
+	tsReal *ctrlp;
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		7, 2, 3, TS_CLAMPED, &spline, &status,
+		-1.75, -1.0,  /* P1 */
+		-1.5,  -0.5,  /* P2 */
+		-1.5,   0.0,  /* P3 */
+		-1.25,  0.5,  /* P4 */
+		-0.75,  0.75, /* P5 */
+		 0.0,   0.5,  /* P6 */
+		 0.5,   0.0)) /* P7 */
+	C(ts_bspline_to_beziers(&spline, &beziers, &status))
+	/* Exceeds the stack buffer of the workspace. */
+	C(ts_bspline_new(20, 50, 5, TS_OPENED, &large, &status))
+	C(ts_bspline_control_points(&large, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&large); i++)
+		ctrlp[i] = (tsReal) ((i * 7) % 13);
+	C(ts_bspline_set_control_points(&large, ctrlp, &status))
+	free(ctrlp);
+	C(ts_bspline_new_with_control_points(
+		3, 2, 1, TS_CLAMPED, &linear, &status,
+		0.0, 0.0,
+		1.0, 3.0,
+		2.0, 0.0))
+	C(ts_bspline_new_with_control_points(
+		3, 1, 0, TS_CLAMPED, &constant, &status,
+		1.0, 2.0, 3.0))
+
+	___WHEN___
+	___THEN___
+	assert_eval_point_equals_eval(tc, &spline);
+	assert_eval_point_equals_eval(tc, &beziers);
+	assert_eval_point_equals_eval(tc, &large);
+	assert_eval_point_equals_eval(tc, &linear);
+	assert_eval_point_equals_eval(tc, &constant);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&beziers);
+	ts_bspline_free(&large);
+	ts_bspline_free(&linear);
+	ts_bspline_free(&constant);
+}
+
+void eval_all_sorted_and_unsorted(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[300], *points = NULL, *ctrlp = NULL, point[3], dist;
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new(200, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&spline); i++)
+		ctrlp[i] = (tsReal) ((i * 7) % 11);
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	/* Ascending, then descending, then jumping back and forth. */
+	for (i = 0; i < 100; i++) {
+		us[i] = (tsReal) i / 99;
+		us[100 + i] = (tsReal) 1.0 - us[i];
+		us[200 + i] = (tsReal) ((i * 37) % 100) / 99;
+	}
+
+	___WHEN___
+	C(ts_bspline_eval_all(&spline, us, 300, &points, &status))
+
+	___THEN___
+	for (i = 0; i < 300; i++) {
+		C(ts_bspline_eval_point(&spline, us[i], point, &status))
+		dist = ts_distance(point, points + i * 3, 3);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(points);
+	free(ctrlp);
+}
+
+/* Evaluates `spline` at ascending knots (lanes sharing a span), knots close
+ * to the breakpoints, and jumping knots (lanes with different spans) and
+ * compares the results of ts_bspline_eval_all with ts_bspline_eval_point. */
+void assert_eval_all_equals_eval_point(CuTest *tc, const tsBSpline *spline)
+{
+	___SETUP___
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const tsReal *knots = ts_bspline_knots_ptr(spline);
+	tsReal us[240], *points = NULL, point[16], min, max, dist;
+	size_t i;
+
+	___GIVEN___
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < 80; i++) {
+		us[i] = min + (max - min) * (tsReal) i / 79;
+		us[80 + i] = knots[deg + (i / 4) % (num_knots - 2 * deg)];
+		if (i % 4 == 1)
+			us[80 + i] += TS_KNOT_EPSILON / 2;
+		else if (i % 4 == 2)
+			us[80 + i] += TS_KNOT_EPSILON * 2;
+		else if (i % 4 == 3)
+			us[80 + i] -= TS_KNOT_EPSILON / 2;
+		if (us[80 + i] < min)
+			us[80 + i] = min;
+		if (us[80 + i] > max)
+			us[80 + i] = max;
+		us[160 + i] = min + (max - min) * (tsReal) ((i * 37) % 80) / 79;
+	}
+
+	___WHEN___
+	C(ts_bspline_eval_all(spline, us, 240, &points, &status))
+
+	___THEN___
+	for (i = 0; i < 240; i++) {
+		C(ts_bspline_eval_point(spline, us[i], point, &status))
+		dist = ts_distance(point, points + i * dim, dim);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	free(points);
+}
+
+void eval_all_lanes_equal_eval_point(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	size_t deg, dim, i;
+
+	___GIVEN___
+	for (deg = 0; deg <= 5; deg++) {
+		/* Dimensions that are smaller than, equal to, and not a
+		 * multiple of the width of the SIMD registers. */
+		for (dim = 1; dim <= 9; dim++) {
+			C(ts_bspline_new(12, dim, deg, TS_CLAMPED, &spline,
+				&status))
+			C(ts_bspline_control_points(&spline, &ctrlp, &status))
+			for (i = 0; i < 12 * dim; i++)
+				ctrlp[i] = (tsReal) ((i * 7) % 11) - 5;
+			C(ts_bspline_set_control_points(&spline, ctrlp,
+				&status))
+			assert_eval_all_equals_eval_point(tc, &spline);
+			free(ctrlp);
+			ctrlp = NULL;
+			ts_bspline_free(&spline);
+		}
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+/* Runs the tasks in reverse order to make sure that the result does not
+ * depend on the order in which tasks are processed. */
+void reverse_executor(void *data, size_t num_tasks, tsTask task,
+	void *context)
+{
+	size_t *num_calls = (size_t *) data;
+	while (num_tasks > 0)
+		task(context, --num_tasks);
+	(*num_calls)++;
+}
+
+void eval_all_parallel(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[1000], expected[3000], points[3000], *ctrlp = NULL;
+	size_t grain_sizes[5] = { 0, 1, 7, 64, 5000 };
+	size_t i, j, num_calls = 0;
+
+	___GIVEN___
+	C(ts_bspline_new(50, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&spline); i++)
+		ctrlp[i] = (tsReal) ((i * 7) % 11);
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	for (i = 0; i < 1000; i++)
+		us[i] = (tsReal) ((i * 37) % 1000) / 999;
+	C(ts_bspline_eval_all_into(&spline, us, 1000, expected, 3000,
+		&status))
+
+	for (i = 0; i < 5; i++) {
+		___WHEN___
+		C(ts_bspline_eval_all_parallel(&spline, us, 1000, points,
+			3000, grain_sizes[i], reverse_executor, &num_calls,
+			&status))
+
+		___THEN___
+		CuAssertIntEquals(tc, (int) (i + 1), (int) num_calls);
+		for (j = 0; j < 3000; j++) {
+			CuAssertDblEquals(tc, expected[j], points[j],
+				POINT_EPSILON);
+		}
+	}
+
+	/* Without executor. */
+	C(ts_bspline_eval_all_parallel(&spline, us, 1000, points, 3000, 3,
+		NULL, NULL, &status))
+	for (j = 0; j < 3000; j++)
+		CuAssertDblEquals(tc, expected[j], points[j], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+void eval_all_parallel_errors(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsStatus expected, actual;
+	tsReal us[100], points[300];
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new(7, 3, 3, TS_CLAMPED, &spline, &status))
+	for (i = 0; i < 100; i++)
+		us[i] = (tsReal) i / 99;
+	/* Undefined knot in the 4th and the 6th task. */
+	us[35] = (tsReal) 2.0;
+	us[55] = (tsReal) -1.0;
+	ts_bspline_eval_point(&spline, us[35], points, &expected);
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_bspline_eval_all_parallel(&spline, us, 100, points, 299,
+			10, NULL, NULL, NULL));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED,
+		ts_bspline_eval_all_parallel(&spline, us, 100, points, 300,
+			10, NULL, NULL, &actual));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, actual.code);
+	/* The error of the 4th task is reported. */
+	CuAssertStrEquals(tc, expected.message, actual.message);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void eval_all_f_and_d(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init(), split = ts_bspline_init();
+	tsReal us[1000], expected[3000], *ctrlp = NULL;
+	float usf[1000], pointsf[3000];
+	double usd[1000], pointsd[3000];
+	size_t i, j, k;
+
+	___GIVEN___
+	C(ts_bspline_new(50, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&spline); i++)
+		ctrlp[i] = (tsReal) ((i * 7) % 11);
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	/* Knots with multiplicity 1, 2, and 3 (and order at the ends). */
+	C(ts_bspline_insert_knot(&spline, (tsReal) 0.5, 1, &split, &k,
+		&status))
+	C(ts_bspline_insert_knot(&split, (tsReal) 0.75, 2, &split, &k,
+		&status))
+	for (i = 0; i < 1000; i++)
+		us[i] = (tsReal) ((i * 37) % 1000) / 999;
+	us[0] = (tsReal) 0.5;
+	us[1] = (tsReal) 0.75;
+	us[2] = (tsReal) 0.0;
+	us[3] = (tsReal) 1.0;
+	for (i = 0; i < 1000; i++) {
+		usf[i] = (float) us[i];
+		usd[i] = (double) us[i];
+	}
+
+	for (i = 0; i < 2; i++) {
+		___WHEN___
+		C(ts_bspline_eval_all_into(i ? &split : &spline, us, 1000,
+			expected, 3000, &status))
+		C(ts_bspline_eval_all_f(i ? &split : &spline, usf, 1000,
+			pointsf, 3000, &status))
+		C(ts_bspline_eval_all_d(i ? &split : &spline, usd, 1000,
+			pointsd, 3000, &status))
+
+		___THEN___
+		/* Float has about 7 significant digits. */
+		for (j = 0; j < 3000; j++) {
+			CuAssertDblEquals(tc, expected[j], pointsf[j],
+				(tsReal) 1e-4);
+			CuAssertDblEquals(tc, expected[j], pointsd[j],
+				POINT_EPSILON);
+		}
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&split);
+	free(ctrlp);
+}
+
+void eval_all_f_and_d_large_nets(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[21], expected[21 * 6], *ctrlp = NULL;
+	float usf[21], pointsf[21 * 6];
+	double usd[21], pointsd[21 * 6];
+	size_t i;
+
+	___GIVEN___
+	/* order * dimension > 64, so that the nets do not fit on the stack. */
+	C(ts_bspline_new(20, 6, 13, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&spline); i++)
+		ctrlp[i] = (tsReal) ((i * 5) % 13) / 13;
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	for (i = 0; i < 21; i++) {
+		us[i] = (tsReal) i / 20;
+		usf[i] = (float) us[i];
+		usd[i] = (double) us[i];
+	}
+
+	___WHEN___
+	C(ts_bspline_eval_all_into(&spline, us, 21, expected, 21 * 6,
+		&status))
+	C(ts_bspline_eval_all_f(&spline, usf, 21, pointsf, 21 * 6, &status))
+	C(ts_bspline_eval_all_d(&spline, usd, 21, pointsd, 21 * 6, &status))
+
+	___THEN___
+	for (i = 0; i < 21 * 6; i++) {
+		CuAssertDblEquals(tc, expected[i], pointsf[i], (tsReal) 1e-4);
+		CuAssertDblEquals(tc, expected[i], pointsd[i], POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+void eval_all_f_errors(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsStatus actual;
+	float us[2], points[6];
+
+	___GIVEN___
+	C(ts_bspline_new(7, 3, 3, TS_CLAMPED, &spline, &status))
+	us[0] = 0.25f;
+	us[1] = 2.f;
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_bspline_eval_all_f(&spline, us, 2, points, 5, NULL));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED,
+		ts_bspline_eval_all_f(&spline, us, 2, points, 6, &actual));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, actual.code);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void eval_derivs_compare_with_derive(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline deriv = ts_bspline_init();
+	tsReal *ctrlp = NULL, us[101], derivs[101 * 6 * 3], point[3];
+	tsReal min, max, scale;
+	tsBSplineType types[2] = { TS_CLAMPED, TS_OPENED };
+	size_t t, i, j, d;
+
+	for (t = 0; t < 2; t++) {
+		___GIVEN___
+		C(ts_bspline_new(12, 3, 4, types[t], &spline, &status))
+		C(ts_bspline_control_points(&spline, &ctrlp, &status))
+		for (i = 0; i < ts_bspline_len_control_points(&spline); i++)
+			ctrlp[i] = (tsReal) ((i * 7) % 11);
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		free(ctrlp);
+		ctrlp = NULL;
+		/* Includes the knots of the spline and the ends of its
+		 * domain. */
+		ts_bspline_domain(&spline, &min, &max);
+		for (i = 0; i < 101; i++)
+			us[i] = min + (max - min) * (tsReal) i / 100;
+
+		___WHEN___
+		C(ts_bspline_eval_derivs_all(&spline, us, 101, 5, derivs,
+			&status))
+
+		___THEN___
+		C(ts_bspline_copy(&spline, &deriv, &status))
+		for (j = 0; j <= 5; j++) {
+			for (i = 0; i < 101; i++) {
+				C(ts_bspline_eval_point(&deriv, us[i], point,
+					&status))
+				/* Higher derivatives have large values. */
+				for (scale = 1, d = 0; d < 3; d++) {
+					if (fabs(point[d]) > scale)
+						scale = (tsReal) fabs(point[d]);
+				}
+				for (d = 0; d < 3; d++) {
+					CuAssertDblEquals(tc, point[d],
+						derivs[(i * 6 + j) * 3 + d],
+						POINT_EPSILON * scale);
+				}
+			}
+			if (j < 5) {
+				C(ts_bspline_derive(&deriv, 1, -1, &deriv,
+					&status))
+			}
+		}
+		C(ts_bspline_eval_derivs(&spline, us[37], 2, derivs,
+			&status))
+		C(ts_bspline_eval_point(&spline, us[37], point, &status))
+		for (d = 0; d < 3; d++) {
+			CuAssertDblEquals(tc, point[d], derivs[d],
+				POINT_EPSILON);
+		}
+		ts_bspline_free(&spline);
+		ts_bspline_free(&deriv);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&deriv);
+	free(ctrlp);
+}
+
+void eval_derivs_undefined_knot(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[3] = { 0, 0.5, 1.5 }, derivs[3 * 3 * 2];
+	tsStatus actual;
+
+	___GIVEN___
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_derivs(
+		&spline, (tsReal) -0.5, 2, derivs, &actual));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, actual.code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_derivs_all(
+		&spline, us, 3, 2, derivs, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
 CuSuite* get_eval_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -311,5 +913,17 @@ CuSuite* get_eval_suite()
 	SUITE_ADD_TEST(suite, eval_two_points);
 	SUITE_ADD_TEST(suite, eval_undefined_knot);
 	SUITE_ADD_TEST(suite, eval_near_miss_knot);
+	SUITE_ADD_TEST(suite, eval_near_miss_domain_min);
+	SUITE_ADD_TEST(suite, eval_into_reuses_net);
+	SUITE_ADD_TEST(suite, eval_point);
+	SUITE_ADD_TEST(suite, eval_all_sorted_and_unsorted);
+	SUITE_ADD_TEST(suite, eval_all_lanes_equal_eval_point);
+	SUITE_ADD_TEST(suite, eval_all_parallel);
+	SUITE_ADD_TEST(suite, eval_all_parallel_errors);
+	SUITE_ADD_TEST(suite, eval_all_f_and_d);
+	SUITE_ADD_TEST(suite, eval_all_f_and_d_large_nets);
+	SUITE_ADD_TEST(suite, eval_all_f_errors);
+	SUITE_ADD_TEST(suite, eval_derivs_compare_with_derive);
+	SUITE_ADD_TEST(suite, eval_derivs_undefined_knot);
 	return suite;
 }
\ No newline at end of file
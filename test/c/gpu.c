@@ -0,0 +1,150 @@
+#include <testutils.h>
+
+void gpu_eval_all(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsGpu gpu = ts_gpu_init();
+	tsReal us[101], expected[202], points[202], min, max;
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		6, 2, 2, TS_BEZIERS, &spline, &status,
+		0.0, 0.0,   /* P1 */
+		1.0, 2.0,   /* P2 */
+		2.0, 0.0,   /* P3 */
+		3.0, 1.0,   /* P4 */
+		4.0, -3.0,  /* P5 */
+		5.0, 2.0))  /* P6 */
+	ts_bspline_domain(&spline, &min, &max);
+	for (i = 0; i < 101; i++)
+		us[i] = min + (max - min) * (tsReal) i / (tsReal) 100;
+	C(ts_bspline_eval_all_into(&spline, us, 101, expected, 202, &status))
+	C(ts_gpu_new(&gpu, &status))
+
+	___WHEN___
+	C(ts_gpu_eval_all(&gpu, &spline, us, 101, points, 202, &status))
+
+	___THEN___
+	/* Includes the gap at 0.5, which yields the first of the two
+	 * results. */
+	for (i = 0; i < 202; i++)
+		CuAssertDblEquals(tc, expected[i], points[i], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_gpu_free(&gpu);
+}
+
+void gpu_pool_eval_all(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[3];
+	tsSplinePool pool = ts_spline_pool_init();
+	tsGpu gpu = ts_gpu_init();
+	tsReal us[11], expected[66], points[66];
+	size_t i, j;
+
+	for (i = 0; i < 3; i++)
+		splines[i] = ts_bspline_init();
+
+	___GIVEN___
+	for (i = 0; i < 3; i++) {
+		C(ts_bspline_new_with_control_points(
+			4, 2, 3, TS_CLAMPED, &splines[i], &status,
+			0.0, (double) i,  /* P1 */
+			1.0, 2.0,         /* P2 */
+			2.0, -1.0,        /* P3 */
+			3.0, -(double) i)) /* P4 */
+	}
+	/* The third spline does not share the knots of the others. */
+	C(ts_bspline_set_knots_varargs(&splines[2], &status,
+		-0.5, -0.5, -0.5, -0.5, 1.5, 1.5, 1.5, 1.5))
+	for (i = 0; i < 11; i++)
+		us[i] = (tsReal) i / (tsReal) 10;
+	for (i = 0; i < 11; i++) {
+		for (j = 0; j < 3; j++) {
+			C(ts_bspline_eval_point(&splines[j], us[i],
+				expected + (i * 3 + j) * 2, &status))
+		}
+	}
+	C(ts_spline_pool_new(splines, 3, &pool, &status))
+	C(ts_gpu_new(&gpu, &status))
+
+	___WHEN___
+	C(ts_gpu_pool_eval_all(&gpu, &pool, us, 11, points, 66, &status))
+
+	___THEN___
+	for (i = 0; i < 66; i++)
+		CuAssertDblEquals(tc, expected[i], points[i], POINT_EPSILON);
+
+	___TEARDOWN___
+	for (i = 0; i < 3; i++)
+		ts_bspline_free(&splines[i]);
+	ts_spline_pool_free(&pool);
+	ts_gpu_free(&gpu);
+}
+
+void gpu_errors(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsGpu gpu = ts_gpu_init();
+	tsReal us[2], points[6];
+	tsStatus actual;
+
+	___GIVEN___
+	C(ts_bspline_new(4, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_gpu_new(&gpu, &status))
+	us[0] = (tsReal) 0.5;
+	us[1] = (tsReal) 1.5;
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_gpu_eval_all(&gpu, &spline,
+		us, 2, points, 6, &actual));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, actual.code);
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_gpu_eval_all(&gpu, &spline,
+		us, 2, points, 5, &actual));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, actual.code);
+	if (!ts_gpu_has_device(&gpu)) {
+		CuAssertIntEquals(tc, TS_DEVICE_ERROR,
+			ts_gpu_eval_all_device(&gpu, &spline, us, 1, NULL,
+			&actual));
+		CuAssertIntEquals(tc, TS_DEVICE_ERROR, actual.code);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_gpu_free(&gpu);
+}
+
+void gpu_has_device(CuTest *tc)
+{
+	___SETUP___
+	tsGpu gpu = ts_gpu_init();
+	const char *required = getenv("TINYSPLINE_TEST_GPU_DEVICE");
+
+	___GIVEN___
+	C(ts_gpu_new(&gpu, &status))
+
+	___WHEN___ ___THEN___
+	/* Set by CI jobs providing a device (e.g., PoCL with
+	 * TINYSPLINE_GPU_ALLOW_CPU), so that the tests above do not silently
+	 * test the fallback to the CPU. */
+	if (required && *required)
+		CuAssertTrue(tc, ts_gpu_has_device(&gpu));
+
+	___TEARDOWN___
+	ts_gpu_free(&gpu);
+}
+
+CuSuite* get_gpu_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, gpu_eval_all);
+	SUITE_ADD_TEST(suite, gpu_pool_eval_all);
+	SUITE_ADD_TEST(suite, gpu_errors);
+	SUITE_ADD_TEST(suite, gpu_has_device);
+	return suite;
+}
@@ -246,6 +246,232 @@ void insert_knot_way_too_many(CuTest *tc)
 	ts_bspline_free(&result);
 }
 
+void insert_knot_in_place_reserved(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	const tsReal *ctrlp;
+	size_t i, k;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		7, 2, 3, TS_CLAMPED, &spline, &status,
+		-1.75, -1.0,  /* P1 */
+		-1.5,  -0.5,  /* P2 */
+		-1.5,   0.0,  /* P3 */
+		-1.25,  0.5,  /* P4 */
+		-0.75,  0.75, /* P5 */
+		 0.0,   0.5,  /* P6 */
+		 0.5,   0.0)) /* P7 */
+	C(ts_bspline_copy(&spline, &result, &status))
+	CuAssertIntEquals(tc, 7, (int) ts_bspline_capacity(&result));
+	C(ts_bspline_reserve(&result, 37, &status))
+	CuAssertIntEquals(tc, 37, (int) ts_bspline_capacity(&result));
+	ctrlp = ts_bspline_control_points_ptr(&result);
+
+	___WHEN___
+	for (i = 1; i <= 30; i++) {
+		C(ts_bspline_insert_knot(&result, (tsReal) i / 31, 1,
+			&result, &k, &status))
+	}
+
+	___THEN___
+	CuAssertIntEquals(tc, 37,
+		(int) ts_bspline_num_control_points(&result));
+	/* The reserved memory has been used. */
+	CuAssertPtrEquals(tc, (void *) ctrlp,
+		(void *) ts_bspline_control_points_ptr(&result));
+	/* Evaluation snaps to the (many) inserted knots within
+	 * TS_KNOT_EPSILON. */
+	assert_equal_shape_eps(tc, &spline, &result, 1e-3);
+	C(ts_bspline_reserve(&result, 10, &status))
+	CuAssertIntEquals(tc, 37, (int) ts_bspline_capacity(&result));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&result);
+}
+
+void insert_knot_in_place_grows(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline copy = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal *knots = NULL, *expected = NULL;
+	size_t i, k;
+
+	___GIVEN___
+	C(ts_bspline_new(10, 3, 2, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_copy(&spline, &copy, &status))
+
+	___WHEN___
+	for (i = 1; i <= 40; i++) {
+		C(ts_bspline_insert_knot(&copy, (tsReal) i / 41, 1,
+			&result, &k, &status))
+		ts_bspline_free(&copy);
+		ts_bspline_move(&result, &copy);
+		C(ts_bspline_insert_knot(&spline, (tsReal) i / 41, 1,
+			&spline, &k, &status))
+	}
+
+	___THEN___
+	/* The capacity is grown geometrically. */
+	CuAssertTrue(tc, ts_bspline_capacity(&spline) >
+		ts_bspline_num_control_points(&spline));
+	CuAssertIntEquals(tc, 50,
+		(int) ts_bspline_num_control_points(&spline));
+	assert_equal_shape(tc, &spline, &copy);
+	C(ts_bspline_knots(&spline, &knots, &status))
+	C(ts_bspline_knots(&copy, &expected, &status))
+	for (i = 0; i < ts_bspline_num_knots(&spline); i++)
+		CuAssertDblEquals(tc, expected[i], knots[i], TS_KNOT_EPSILON);
+
+	___WHEN___
+	C(ts_bspline_shrink_to_fit(&spline, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 50, (int) ts_bspline_capacity(&spline));
+	assert_equal_shape(tc, &spline, &copy);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&copy);
+	ts_bspline_free(&result);
+	free(knots);
+	free(expected);
+}
+
+void insert_knot_refine_compare_with_insert(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline expected = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal *knots = NULL, *ctrlp = NULL;
+	tsReal *exp_knots = NULL, *exp_ctrlp = NULL;
+	/* Relative to the domain: unsorted, with duplicates, existing knots
+	 * (clamped), and the max of the domain (opened). */
+	const tsReal rel[7] = { (tsReal) 0.7, (tsReal) 0.1, (tsReal) 0.5,
+		(tsReal) 0.7, (tsReal) 0.25, (tsReal) 0.95, (tsReal) 1.0 };
+	tsReal insert[7], min, max;
+	size_t i, k, deg, num;
+
+	___GIVEN___
+	for (deg = 1; deg <= 3; deg++) {
+		C(ts_bspline_new(8, 3, deg, deg == 2 ? TS_OPENED : TS_CLAMPED,
+			&spline, &status))
+		C(ts_bspline_control_points(&spline, &ctrlp, &status))
+		for (i = 0; i < 24; i++)
+			ctrlp[i] = (tsReal) ((i * 37) % 11) - 5;
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		free(ctrlp);
+		ctrlp = NULL;
+		ts_bspline_domain(&spline, &min, &max);
+		for (i = 0; i < 7; i++)
+			insert[i] = min + (max - min) * rel[i];
+		num = deg == 2 ? 7 : 6;
+		C(ts_bspline_copy(&spline, &expected, &status))
+		for (i = 0; i < num; i++) {
+			C(ts_bspline_insert_knot(&expected, insert[i], 1,
+				&expected, &k, &status))
+		}
+
+		___WHEN___
+		C(ts_bspline_refine_knots(&spline, insert, num, &result,
+			&status))
+
+		___THEN___
+		CuAssertIntEquals(tc,
+			(int) ts_bspline_num_control_points(&expected),
+			(int) ts_bspline_num_control_points(&result));
+		C(ts_bspline_knots(&expected, &exp_knots, &status))
+		C(ts_bspline_knots(&result, &knots, &status))
+		for (i = 0; i < ts_bspline_num_knots(&result); i++) {
+			CuAssertDblEquals(tc, exp_knots[i], knots[i],
+				TS_KNOT_EPSILON);
+		}
+		C(ts_bspline_control_points(&expected, &exp_ctrlp, &status))
+		C(ts_bspline_control_points(&result, &ctrlp, &status))
+		for (i = 0; i < ts_bspline_len_control_points(&result); i++) {
+			CuAssertDblEquals(tc, exp_ctrlp[i], ctrlp[i],
+				POINT_EPSILON);
+		}
+		/* Knots within TS_KNOT_EPSILON of an inserted knot are
+		 * snapped to it by ts_bspline_eval, which is noticeable with
+		 * these steep control points. */
+		assert_equal_shape_eps(tc, &spline, &result, 0.01);
+
+		___WHEN___
+		/* In place. */
+		C(ts_bspline_refine_knots(&spline, insert, num, &spline,
+			&status))
+
+		___THEN___
+		assert_equal_shape(tc, &spline, &result);
+
+		ts_bspline_free(&spline);
+		ts_bspline_free(&expected);
+		ts_bspline_free(&result);
+		free(knots);
+		free(ctrlp);
+		free(exp_knots);
+		free(exp_ctrlp);
+		knots = ctrlp = exp_knots = exp_ctrlp = NULL;
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&expected);
+	ts_bspline_free(&result);
+	free(knots);
+	free(ctrlp);
+	free(exp_knots);
+	free(exp_ctrlp);
+}
+
+void insert_knot_refine_invalid(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal outside[2] = { (tsReal) 0.5, (tsReal) 1.5 };
+	tsReal too_many[4] = { (tsReal) 0.4, (tsReal) 0.4, (tsReal) 0.25,
+		(tsReal) 0.4 };
+	tsReal *ctrlp = NULL;
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new(7, 2, 2, TS_CLAMPED, &spline, &status))
+	/* The control points of new splines are not initialized. */
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < 14; i++)
+		ctrlp[i] = (tsReal) i / 10;
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_refine_knots(
+		&spline, outside, 2, &result, NULL));
+	CuAssertPtrEquals(tc, NULL, result.pImpl);
+	/* 0.4 is a knot of spline already. */
+	CuAssertIntEquals(tc, TS_MULTIPLICITY, ts_bspline_refine_knots(
+		&spline, too_many, 4, &result, NULL));
+	CuAssertPtrEquals(tc, NULL, result.pImpl);
+	C(ts_bspline_refine_knots(&spline, too_many, 3, &result, &status))
+	CuAssertIntEquals(tc, 10,
+		(int) ts_bspline_num_control_points(&result));
+	assert_equal_shape(tc, &spline, &result);
+	ts_bspline_free(&result);
+	C(ts_bspline_refine_knots(&spline, NULL, 0, &result, &status))
+	assert_equal_shape(tc, &spline, &result);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&result);
+	free(ctrlp);
+}
+
 CuSuite* get_insert_knot_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -254,5 +480,9 @@ CuSuite* get_insert_knot_suite()
 	SUITE_ADD_TEST(suite, insert_knot_three_times);
 	SUITE_ADD_TEST(suite, insert_knot_too_many);
 	SUITE_ADD_TEST(suite, insert_knot_way_too_many);
+	SUITE_ADD_TEST(suite, insert_knot_in_place_reserved);
+	SUITE_ADD_TEST(suite, insert_knot_in_place_grows);
+	SUITE_ADD_TEST(suite, insert_knot_refine_compare_with_insert);
+	SUITE_ADD_TEST(suite, insert_knot_refine_invalid);
 	return suite;
 }
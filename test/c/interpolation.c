@@ -1,4 +1,5 @@
 #include <testutils.h>
+#include <math.h>
 
 void interpolation_cubic_natural(CuTest *tc)
 {
@@ -155,10 +156,108 @@ void interpolation_issue32(CuTest *tc)
 	free(knots);
 }
 
+/* Runs the tasks in order and counts the number of tasks. */
+void counting_executor(void *data, size_t num_tasks, tsTask task,
+	void *context)
+{
+	size_t *count = (size_t *) data;
+	size_t i;
+	for (i = 0; i < num_tasks; i++)
+		task(context, i);
+	*count += num_tasks;
+}
+
+void interpolation_cubic_natural_columns(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[10], columns[10], solved[10], beziers[32];
+	tsReal *ctrlp = NULL;
+	size_t i, j, num_tasks = 0;
+
+	___GIVEN___
+	points[0] =  1.0; points[1] = -1.0;
+	points[2] = -1.0; points[3] =  2.0;
+	points[4] =  1.0; points[5] =  4.0;
+	points[6] =  4.0; points[7] =  3.0;
+	points[8] =  7.0; points[9] =  5.0;
+	for (i = 0; i < 5; i++) {
+		for (j = 0; j < 2; j++)
+			columns[j * 5 + i] = points[i * 2 + j];
+	}
+	C(ts_bspline_interpolate_cubic_natural(points, 5, 2, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+
+	___WHEN___
+	C(ts_cubic_natural_solve_columns(columns, 5, 2, solved, 1,
+		counting_executor, &num_tasks, &status))
+	C(ts_cubic_natural_to_beziers(solved, 5, 2, 0, 4, beziers, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 2, (int) num_tasks);
+	for (i = 0; i < 32; i++)
+		CuAssertDblEquals(tc, ctrlp[i], beziers[i], POINT_EPSILON);
+
+	___WHEN___
+	/* In place and a window of two segments. */
+	C(ts_cubic_natural_solve_columns(columns, 5, 2, columns, 0,
+		NULL, NULL, &status))
+	C(ts_cubic_natural_to_beziers(columns, 5, 2, 1, 2, beziers, &status))
+
+	___THEN___
+	for (i = 0; i < 16; i++)
+		CuAssertDblEquals(tc, ctrlp[8 + i], beziers[i], POINT_EPSILON);
+	CuAssertIntEquals(tc, TS_INDEX_ERROR, ts_cubic_natural_to_beziers(
+		columns, 5, 2, 2, 3, beziers, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+void interpolation_cubic_natural_columns_large(CuTest *tc)
+{
+	___SETUP___
+	const size_t num = 200000;
+	tsReal *points = NULL, *ctrlp = NULL, beziers[8];
+	size_t i;
+
+	___GIVEN___
+	/* Exceeds TS_MAX_NUM_KNOTS by far. */
+	points = (tsReal *) malloc(num * sizeof(tsReal));
+	ctrlp = (tsReal *) malloc(num * sizeof(tsReal));
+	CuAssertPtrNotNull(tc, points);
+	CuAssertPtrNotNull(tc, ctrlp);
+	for (i = 0; i < num; i++)
+		points[i] = (tsReal) sin((double) i * 0.01) * 100;
+
+	___WHEN___
+	C(ts_cubic_natural_solve_columns(points, num, 1, ctrlp, 0,
+		NULL, NULL, &status))
+
+	___THEN___
+	/* The segments start and end at the interpolated points. */
+	for (i = 0; i < num - 1; i += 997) {
+		C(ts_cubic_natural_to_beziers(ctrlp, num, 1, i, 1, beziers,
+			&status))
+		CuAssertDblEquals(tc, points[i], beziers[0], POINT_EPSILON);
+		CuAssertDblEquals(tc, points[i+1], beziers[3], POINT_EPSILON);
+	}
+	C(ts_cubic_natural_to_beziers(ctrlp, num, 1, num - 3, 2, beziers,
+		&status))
+	CuAssertDblEquals(tc, points[num-1], beziers[7], POINT_EPSILON);
+
+	___TEARDOWN___
+	free(points);
+	free(ctrlp);
+}
+
 CuSuite* get_interpolation_suite()
 {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, interpolation_cubic_natural);
 	SUITE_ADD_TEST(suite, interpolation_issue32);
+	SUITE_ADD_TEST(suite, interpolation_cubic_natural_columns);
+	SUITE_ADD_TEST(suite, interpolation_cubic_natural_columns_large);
 	return suite;
 }
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include <testutils.h>
+
+void map_reverse_executor(void *data, size_t num_tasks, tsTask task,
+	void *context)
+{
+	size_t *num_calls = (size_t *) data;
+	while (num_tasks > 0)
+		task(context, --num_tasks);
+	(*num_calls)++;
+}
+
+void map_setup(CuTest *tc, tsBSpline *splines)
+{
+	___SETUP___
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		3, 2, 1, TS_CLAMPED, &splines[0], &status,
+		0.0, 0.0,   /* P1 */
+		10.0, 5.0,  /* P2 */
+		20.0, 0.0)) /* P3 */
+	C(ts_bspline_new_with_control_points(
+		5, 2, 3, TS_CLAMPED, &splines[1], &status,
+		60.0, 150.0,   /* P1 */
+		200.0, 300.0,  /* P2 */
+		370.0, 490.0,  /* P3 */
+		590.0, 40.0,   /* P4 */
+		570.0, 490.0)) /* P5 */
+	C(ts_bspline_new_with_control_points(
+		6, 3, 2, TS_OPENED, &splines[2], &status,
+		1.7, 7.9, 1.0,    /* P1 */
+		-9.2, -3.1, 2.0,  /* P2 */
+		-0.1, 0.5, 3.0,   /* P3 */
+		4.0, 2.0, 4.0,    /* P4 */
+		8.0, 3.0, 5.0,    /* P5 */
+		10.0, 15.0, 6.0)) /* P6 */
+	C(ts_bspline_new_with_control_points(
+		6, 2, 2, TS_BEZIERS, &splines[3], &status,
+		0.0, 0.0,   /* P1 */
+		1.0, 2.0,   /* P2 */
+		2.0, 0.0,   /* P3 */
+		2.0, 0.0,   /* P4 */
+		4.0, -3.0,  /* P5 */
+		5.0, 2.0))  /* P6 */
+
+	___TEARDOWN___
+}
+
+void map_derive(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[4], results[4], expected = ts_bspline_init();
+	tsStatus statuses[4];
+	tsBSplineOpArgs args;
+	size_t i, num_calls = 0;
+
+	for (i = 0; i < 4; i++) {
+		splines[i] = ts_bspline_init();
+		results[i] = ts_bspline_init();
+	}
+
+	___GIVEN___
+	map_setup(tc, splines);
+	args.n = 1;
+	args.value = 0;
+	args.epsilon = POINT_EPSILON;
+
+	___WHEN___
+	C(ts_bspline_map(splines, 4, ts_bspline_op_derive, &args, results,
+		statuses, 3, map_reverse_executor, &num_calls, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 1, (int) num_calls);
+	for (i = 0; i < 4; i++) {
+		CuAssertIntEquals(tc, TS_SUCCESS, statuses[i].code);
+		C(ts_bspline_derive(&splines[i], 1, POINT_EPSILON, &expected,
+			&status))
+		CuAssertIntEquals(tc,
+			(int) ts_bspline_num_control_points(&expected),
+			(int) ts_bspline_num_control_points(&results[i]));
+		assert_equal_shape(tc, &expected, &results[i]);
+		ts_bspline_free(&expected);
+	}
+
+	___TEARDOWN___
+	for (i = 0; i < 4; i++) {
+		ts_bspline_free(&splines[i]);
+		ts_bspline_free(&results[i]);
+	}
+	ts_bspline_free(&expected);
+}
+
+void map_partial_failure(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[4], results[4];
+	tsStatus statuses[4], batch;
+	tsBSplineOpArgs args;
+	tsReal min, max;
+	size_t i;
+
+	for (i = 0; i < 4; i++) {
+		splines[i] = ts_bspline_init();
+		results[i] = ts_bspline_init();
+	}
+
+	___GIVEN___
+	map_setup(tc, splines);
+	/* Splines 1 and 2 are not defined at 0.5. */
+	C(ts_bspline_set_knots_varargs(&splines[1], &status,
+		2.0, 2.0, 2.0, 2.0, 2.5, 3.0, 3.0, 3.0, 3.0))
+	C(ts_bspline_set_knots_varargs(&splines[2], &status,
+		2.0, 2.1, 2.2, 2.3, 2.4, 2.5, 2.6, 2.7, 2.8))
+	args.n = 0;
+	args.value = (tsReal) 0.5;
+	args.epsilon = 0;
+
+	___WHEN___
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_map(splines, 4,
+		ts_bspline_op_split, &args, results, statuses, 0, NULL, NULL,
+		&batch));
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, batch.code);
+	CuAssertIntEquals(tc, TS_SUCCESS, statuses[0].code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, statuses[1].code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, statuses[2].code);
+	CuAssertIntEquals(tc, TS_SUCCESS, statuses[3].code);
+	CuAssertPtrEquals(tc, NULL, results[1].pImpl);
+	CuAssertPtrEquals(tc, NULL, results[2].pImpl);
+	assert_equal_shape(tc, &splines[0], &results[0]);
+	assert_equal_shape(tc, &splines[3], &results[3]);
+	ts_bspline_domain(&results[3], &min, &max);
+	CuAssertDblEquals(tc, 0.0, min, POINT_EPSILON);
+	CuAssertDblEquals(tc, 1.0, max, POINT_EPSILON);
+
+	___WHEN___
+	/* Without per-spline statuses. */
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_map(splines, 4,
+		ts_bspline_op_split, &args, splines, NULL, 0, NULL, NULL,
+		&batch));
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, batch.code);
+	assert_equal_shape(tc, &results[0], &splines[0]);
+	assert_equal_shape(tc, &results[3], &splines[3]);
+
+	___TEARDOWN___
+	for (i = 0; i < 4; i++) {
+		ts_bspline_free(&splines[i]);
+		ts_bspline_free(&results[i]);
+	}
+}
+
+void map_in_place(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[4], copies[4];
+	tsBSplineOpArgs args;
+	size_t i;
+
+	for (i = 0; i < 4; i++) {
+		splines[i] = ts_bspline_init();
+		copies[i] = ts_bspline_init();
+	}
+
+	___GIVEN___
+	map_setup(tc, splines);
+	for (i = 0; i < 4; i++)
+		C(ts_bspline_copy(&splines[i], &copies[i], &status))
+	args.n = 2;
+	args.value = 0;
+	args.epsilon = POINT_EPSILON;
+
+	___WHEN___
+	C(ts_bspline_map(splines, 4, ts_bspline_op_to_beziers, NULL,
+		splines, NULL, 2, NULL, NULL, &status))
+	C(ts_bspline_map(splines, 4, ts_bspline_op_elevate_degree, &args,
+		splines, NULL, 0, NULL, NULL, &status))
+
+	___THEN___
+	for (i = 0; i < 4; i++) {
+		CuAssertIntEquals(tc,
+			(int) ts_bspline_degree(&copies[i]) + 2,
+			(int) ts_bspline_degree(&splines[i]));
+		assert_equal_shape(tc, &copies[i], &splines[i]);
+	}
+
+	___TEARDOWN___
+	for (i = 0; i < 4; i++) {
+		ts_bspline_free(&splines[i]);
+		ts_bspline_free(&copies[i]);
+	}
+}
+
+CuSuite* get_map_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, map_derive);
+	SUITE_ADD_TEST(suite, map_partial_failure);
+	SUITE_ADD_TEST(suite, map_in_place);
+	return suite;
+}
@@ -0,0 +1,199 @@
+#include <testutils.h>
+
+/* Creates a time series with uneven steps whose first component is
+ * ascending and whose second component is descending. */
+void create_time_series(CuTest *tc, tsBSpline *spline)
+{
+	___SETUP___
+	tsReal *ctrlp = NULL;
+	size_t i;
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	C(ts_bspline_new(200, 3, 3, TS_CLAMPED, spline, &status))
+	C(ts_bspline_control_points(spline, &ctrlp, &status))
+	for (i = 0; i < 200; i++) {
+		ctrlp[i * 3] = (tsReal) (i * 10 + (i * 7) % 5);
+		ctrlp[i * 3 + 1] = (tsReal) -1.0 * (tsReal) (i * i);
+		ctrlp[i * 3 + 2] = (tsReal) ((i * 13) % 11);
+	}
+	C(ts_bspline_set_control_points(spline, ctrlp, &status))
+
+	___TEARDOWN___
+	free(ctrlp);
+}
+
+/* Evaluates `spline` at `num` knots (in reverse order if `reverse` is set)
+ * and compares the knots with the knots found by `index`. */
+void assert_index_equals_eval(CuTest *tc, const tsBSpline *spline,
+	const tsMonotoneIndex *index, size_t idx, int reverse)
+{
+	___SETUP___
+	tsReal knots[500], values[500], us[500], *points = NULL, min, max;
+	size_t i;
+
+	___GIVEN___
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < 500; i++) {
+		knots[reverse ? 499 - i : i] =
+			min + (max - min) * (tsReal) i / 499;
+	}
+	C(ts_bspline_eval_all(spline, knots, 500, &points, &status))
+	for (i = 0; i < 500; i++)
+		values[i] = points[i * ts_bspline_dimension(spline) + idx];
+
+	___WHEN___
+	C(ts_monotone_index_solve_all(index, values, 500, (tsReal) 0.0, 0,
+		30, us, &status))
+
+	___THEN___
+	for (i = 0; i < 500; i++)
+		CuAssertDblEquals(tc, knots[i], us[i], TS_KNOT_EPSILON);
+	C(ts_monotone_index_solve(index, values[250], (tsReal) 0.0, 0, 30,
+		us, &status))
+	CuAssertDblEquals(tc, knots[250], us[0], TS_KNOT_EPSILON);
+
+	___TEARDOWN___
+	free(points);
+}
+
+void monotone_index_ascending(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsMonotoneIndex index = ts_monotone_index_init();
+
+	___GIVEN___
+	create_time_series(tc, &spline);
+
+	___WHEN___
+	C(ts_monotone_index_new(&spline, 0, 1, 0, &index, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 197 * 4,
+		(int) ts_monotone_index_num_samples(&index));
+	assert_index_equals_eval(tc, &spline, &index, 0, 0);
+	assert_index_equals_eval(tc, &spline, &index, 0, 1);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_monotone_index_free(&index);
+}
+
+void monotone_index_descending(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsMonotoneIndex index = ts_monotone_index_init();
+	tsMonotoneIndex copy = ts_monotone_index_init();
+
+	___GIVEN___
+	create_time_series(tc, &spline);
+
+	___WHEN___
+	/* Few samples require more iterations. */
+	C(ts_monotone_index_new(&spline, 1, 0, 2, &index, &status))
+	C(ts_monotone_index_copy(&index, &copy, &status))
+	ts_monotone_index_free(&index);
+	/* The index does not depend on the spline. */
+	ts_bspline_free(&spline);
+	create_time_series(tc, &spline);
+
+	___THEN___
+	assert_index_equals_eval(tc, &spline, &copy, 1, 0);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_monotone_index_free(&index);
+	ts_monotone_index_free(&copy);
+}
+
+void monotone_index_even_degree(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsMonotoneIndex index = ts_monotone_index_init();
+	tsMonotoneIndex copy = ts_monotone_index_init();
+
+	___GIVEN___
+	/* An odd number of control points and knots. With float precision,
+	 * the buckets following them must be padded (see the sanitizer build
+	 * in BUILD.md). */
+	C(ts_bspline_new_with_control_points(
+		4, 1, 2, TS_CLAMPED, &spline, &status,
+		0.0, 1.0, 2.0, 4.0))
+
+	___WHEN___
+	C(ts_monotone_index_new(&spline, 0, 1, 7, &index, &status))
+	C(ts_monotone_index_copy(&index, &copy, &status))
+
+	___THEN___
+	assert_index_equals_eval(tc, &spline, &index, 0, 0);
+	assert_index_equals_eval(tc, &spline, &copy, 0, 1);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_monotone_index_free(&index);
+	ts_monotone_index_free(&copy);
+}
+
+void monotone_index_out_of_range(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsMonotoneIndex index = ts_monotone_index_init();
+	tsReal values[3] = { -10.0, 5000.0, -20.0 }, us[3], min, max;
+
+	___GIVEN___
+	create_time_series(tc, &spline);
+	ts_bspline_domain(&spline, &min, &max);
+	C(ts_monotone_index_new(&spline, 0, 1, 0, &index, &status))
+
+	___WHEN___
+	C(ts_monotone_index_solve_all(&index, values, 3, (tsReal) 0.01, 0,
+		30, us, &status))
+
+	___THEN___
+	CuAssertDblEquals(tc, min, us[0], TS_KNOT_EPSILON);
+	CuAssertDblEquals(tc, max, us[1], TS_KNOT_EPSILON);
+	CuAssertDblEquals(tc, min, us[2], TS_KNOT_EPSILON);
+	CuAssertIntEquals(tc, TS_NO_RESULT,
+		ts_monotone_index_solve(&index, values[1], (tsReal) 0.01, 1,
+			30, us, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_monotone_index_free(&index);
+}
+
+void monotone_index_invalid_arguments(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsMonotoneIndex index = ts_monotone_index_init();
+
+	___GIVEN___
+	C(ts_bspline_new(16, 3, 3, TS_OPENED, &spline, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_monotone_index_new(&spline, 3, 1, 0, &index, NULL));
+	CuAssertPtrEquals(tc, NULL, index.pImpl);
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_monotone_index_new(&spline, 0, 1, 1, &index, NULL));
+	CuAssertPtrEquals(tc, NULL, index.pImpl);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_monotone_index_free(&index);
+}
+
+CuSuite* get_monotone_index_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, monotone_index_ascending);
+	SUITE_ADD_TEST(suite, monotone_index_descending);
+	SUITE_ADD_TEST(suite, monotone_index_even_degree);
+	SUITE_ADD_TEST(suite, monotone_index_out_of_range);
+	SUITE_ADD_TEST(suite, monotone_index_invalid_arguments);
+	return suite;
+}
@@ -0,0 +1,325 @@
+#include <testutils.h>
+
+void create_start_and_end(CuTest *tc, tsBSpline *start, tsBSpline *end)
+{
+	___SETUP___
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		7, 2, 3, TS_CLAMPED, start, &status,
+		120.0, 100.0,  /* P1 */
+		270.0, 40.0,   /* P2 */
+		370.0, 490.0,  /* P3 */
+		590.0, 40.0,   /* P4 */
+		570.0, 490.0,  /* P5 */
+		420.0, 480.0,  /* P6 */
+		220.0, 500.0)) /* P7 */
+	C(ts_bspline_new_with_control_points(
+		5, 2, 4, TS_CLAMPED, end, &status,
+		60.0, 150.0,   /* P1 */
+		200.0, 300.0,  /* P2 */
+		370.0, 490.0,  /* P3 */
+		590.0, 40.0,   /* P4 */
+		570.0, 490.0)) /* P5 */
+
+	___TEARDOWN___
+}
+
+void morph_equals_bspline_morph(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline start = ts_bspline_init(), end = ts_bspline_init();
+	tsBSpline expected = ts_bspline_init(), actual = ts_bspline_init();
+	tsMorphism morphism = ts_morphism_init();
+	tsReal t;
+
+	___GIVEN___
+	create_start_and_end(tc, &start, &end);
+	C(ts_morphism_new(&start, &end, POINT_EPSILON, &morphism, &status))
+
+	___WHEN___ ___THEN___
+	for (t = (tsReal) 0.0; t <= (tsReal) 1.0; t += (tsReal) 0.125) {
+		C(ts_bspline_morph(&start, &end, t, POINT_EPSILON, &expected,
+			&status))
+		C(ts_morphism_eval(&morphism, t, &actual, &status))
+		assert_equal_shape(tc, &expected, &actual);
+	}
+	/* `t' is limited to [0, 1]. */
+	C(ts_morphism_eval(&morphism, (tsReal) 0.0, &expected, &status))
+	C(ts_morphism_eval(&morphism, (tsReal) -1.0, &actual, &status))
+	assert_equal_shape(tc, &expected, &actual);
+	assert_equal_shape(tc, &start, &actual);
+	C(ts_morphism_eval(&morphism, (tsReal) 1.0, &expected, &status))
+	C(ts_morphism_eval(&morphism, (tsReal) 2.0, &actual, &status))
+	assert_equal_shape(tc, &expected, &actual);
+
+	___TEARDOWN___
+	ts_bspline_free(&start);
+	ts_bspline_free(&end);
+	ts_bspline_free(&expected);
+	ts_bspline_free(&actual);
+	ts_morphism_free(&morphism);
+}
+
+void morph_reuses_output(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline start = ts_bspline_init(), end = ts_bspline_init();
+	tsBSpline out = ts_bspline_init();
+	tsMorphism morphism = ts_morphism_init();
+	tsMorphism copy = ts_morphism_init();
+	struct tsBSplineImpl *impl;
+
+	___GIVEN___
+	create_start_and_end(tc, &start, &end);
+	C(ts_morphism_new(&start, &end, POINT_EPSILON, &morphism, &status))
+	C(ts_morphism_copy(&morphism, &copy, &status))
+	ts_morphism_free(&morphism);
+
+	___WHEN___
+	C(ts_morphism_eval(&copy, (tsReal) 0.25, &out, &status))
+	impl = out.pImpl;
+	C(ts_morphism_eval(&copy, (tsReal) 0.75, &out, &status))
+
+	___THEN___
+	CuAssertPtrEquals(tc, impl, out.pImpl);
+	CuAssertPtrEquals(tc, NULL, morphism.pImpl);
+
+	___TEARDOWN___
+	ts_bspline_free(&start);
+	ts_bspline_free(&end);
+	ts_bspline_free(&out);
+	ts_morphism_free(&morphism);
+	ts_morphism_free(&copy);
+}
+
+void morph_incompatible_output(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline start = ts_bspline_init(), end = ts_bspline_init();
+	tsBSpline out = ts_bspline_init(), expected = ts_bspline_init();
+
+	___GIVEN___
+	create_start_and_end(tc, &start, &end);
+	/* Too small to store the interpolated spline. */
+	C(ts_bspline_new(2, 1, 1, TS_CLAMPED, &out, &status))
+
+	___WHEN___
+	C(ts_bspline_morph(&start, &end, (tsReal) 0.5, POINT_EPSILON, &out,
+		&status))
+	C(ts_bspline_morph(&start, &end, (tsReal) 0.5, POINT_EPSILON,
+		&expected, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&out));
+	CuAssertIntEquals(tc, (int) ts_bspline_num_control_points(&expected),
+		(int) ts_bspline_num_control_points(&out));
+	assert_equal_shape(tc, &expected, &out);
+
+	___WHEN___
+	/* Morph into one of the inputs. */
+	C(ts_bspline_morph(&start, &end, (tsReal) 0.5, POINT_EPSILON, &start,
+		&status))
+
+	___THEN___
+	assert_equal_shape(tc, &expected, &start);
+
+	___TEARDOWN___
+	ts_bspline_free(&start);
+	ts_bspline_free(&end);
+	ts_bspline_free(&out);
+	ts_bspline_free(&expected);
+}
+
+void morph_different_dimensions(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline start = ts_bspline_init(), end = ts_bspline_init();
+	tsBSpline out = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		2, 3, 1, TS_CLAMPED, &start, &status,
+		0.0, 0.0, 5.0,    /* P1 */
+		10.0, 10.0, 5.0)) /* P2 */
+	C(ts_bspline_new_with_control_points(
+		2, 2, 1, TS_CLAMPED, &end, &status,
+		20.0, 0.0,   /* P1 */
+		30.0, 10.0)) /* P2 */
+
+	___WHEN___
+	C(ts_bspline_morph(&start, &end, (tsReal) 0.5, POINT_EPSILON, &out,
+		&status))
+	C(ts_bspline_control_points(&out, &ctrlp, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&out));
+	CuAssertDblEquals(tc, 10.0, ctrlp[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0.0, ctrlp[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, 20.0, ctrlp[2], POINT_EPSILON);
+	CuAssertDblEquals(tc, 10.0, ctrlp[3], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&start);
+	ts_bspline_free(&end);
+	ts_bspline_free(&out);
+	free(ctrlp);
+}
+
+void morph_different_dimensions_equals_projection(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline start = ts_bspline_init(), end = ts_bspline_init();
+	tsBSpline end3 = ts_bspline_init();
+	tsBSpline expected = ts_bspline_init(), actual = ts_bspline_init();
+	tsMorphism morphism = ts_morphism_init();
+	tsReal t;
+
+	___GIVEN___
+	/* `end' with a third component. Since `start' and `end' differ in
+	 * degree and number of knots, they must be aligned. */
+	create_start_and_end(tc, &start, &end);
+	C(ts_bspline_new_with_control_points(
+		5, 3, 4, TS_CLAMPED, &end3, &status,
+		60.0, 150.0, -1.0,   /* P1 */
+		200.0, 300.0, 2.0,   /* P2 */
+		370.0, 490.0, -3.0,  /* P3 */
+		590.0, 40.0, 4.0,    /* P4 */
+		570.0, 490.0, -5.0)) /* P5 */
+	C(ts_morphism_new(&start, &end3, POINT_EPSILON, &morphism, &status))
+
+	___WHEN___ ___THEN___
+	/* The third component of `end3' must be ignored. */
+	for (t = (tsReal) 0.0; t <= (tsReal) 1.0; t += (tsReal) 0.25) {
+		C(ts_bspline_morph(&start, &end, t, POINT_EPSILON, &expected,
+			&status))
+		C(ts_bspline_morph(&start, &end3, t, POINT_EPSILON, &actual,
+			&status))
+		CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&actual));
+		assert_equal_shape(tc, &expected, &actual);
+		C(ts_morphism_eval(&morphism, t, &actual, &status))
+		CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&actual));
+		assert_equal_shape(tc, &expected, &actual);
+		/* The order of the dimensions does not matter. */
+		C(ts_bspline_morph(&end, &start, t, POINT_EPSILON, &expected,
+			&status))
+		C(ts_bspline_morph(&end3, &start, t, POINT_EPSILON, &actual,
+			&status))
+		CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&actual));
+		assert_equal_shape(tc, &expected, &actual);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&start);
+	ts_bspline_free(&end);
+	ts_bspline_free(&end3);
+	ts_bspline_free(&expected);
+	ts_bspline_free(&actual);
+	ts_morphism_free(&morphism);
+}
+
+void morph_eval_all(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline start = ts_bspline_init(), end = ts_bspline_init();
+	tsBSpline frames[5], expected = ts_bspline_init();
+	tsMorphism morphism = ts_morphism_init();
+	tsReal ts[5] = { 0.0, 0.1, 0.5, 0.9, 1.0 };
+	size_t i;
+
+	for (i = 0; i < 5; i++)
+		frames[i] = ts_bspline_init();
+
+	___GIVEN___
+	create_start_and_end(tc, &start, &end);
+	C(ts_morphism_new(&start, &end, POINT_EPSILON, &morphism, &status))
+
+	___WHEN___
+	C(ts_morphism_eval_all(&morphism, ts, 5, frames, &status))
+
+	___THEN___
+	for (i = 0; i < 5; i++) {
+		C(ts_morphism_eval(&morphism, ts[i], &expected, &status))
+		assert_equal_shape(tc, &expected, frames + i);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&start);
+	ts_bspline_free(&end);
+	ts_bspline_free(&expected);
+	for (i = 0; i < 5; i++)
+		ts_bspline_free(frames + i);
+	ts_morphism_free(&morphism);
+}
+
+void morph_update(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline start = ts_bspline_init(), end = ts_bspline_init();
+	tsBSpline expected = ts_bspline_init(), actual = ts_bspline_init();
+	tsMorphism morphism = ts_morphism_init();
+	tsMorphism copy = ts_morphism_init();
+	tsReal *ctrlp = NULL, t;
+	size_t i;
+
+	___GIVEN___
+	create_start_and_end(tc, &start, &end);
+	C(ts_morphism_new(&start, &end, POINT_EPSILON, &morphism, &status))
+
+	___WHEN___
+	/* Creates the alignment plan. */
+	C(ts_morphism_update(&morphism, &start, &end, &status))
+	C(ts_morphism_copy(&morphism, &copy, &status))
+	/* Change the geometry of `start' and `end'. */
+	C(ts_bspline_control_points(&start, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&start); i++)
+		ctrlp[i] = ctrlp[i] * (tsReal) 0.5 + (tsReal) i;
+	C(ts_bspline_set_control_points(&start, ctrlp, &status))
+	free(ctrlp);
+	ctrlp = NULL;
+	C(ts_bspline_control_points(&end, &ctrlp, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&end); i++)
+		ctrlp[i] = -ctrlp[i];
+	C(ts_bspline_set_control_points(&end, ctrlp, &status))
+	C(ts_morphism_update(&copy, &start, &end, &status))
+
+	___THEN___
+	for (t = (tsReal) 0.0; t <= (tsReal) 1.0; t += (tsReal) 0.25) {
+		C(ts_bspline_morph(&start, &end, t, POINT_EPSILON, &expected,
+			&status))
+		C(ts_morphism_eval(&copy, t, &actual, &status))
+		assert_equal_shape(tc, &expected, &actual);
+	}
+
+	___WHEN___
+	/* Different topology. */
+	ts_bspline_free(&end);
+	C(ts_bspline_new(6, 2, 2, TS_CLAMPED, &end, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_morphism_update(&copy,
+		&start, &end, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&start);
+	ts_bspline_free(&end);
+	ts_bspline_free(&expected);
+	ts_bspline_free(&actual);
+	ts_morphism_free(&morphism);
+	ts_morphism_free(&copy);
+	free(ctrlp);
+}
+
+CuSuite* get_morph_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, morph_equals_bspline_morph);
+	SUITE_ADD_TEST(suite, morph_reuses_output);
+	SUITE_ADD_TEST(suite, morph_incompatible_output);
+	SUITE_ADD_TEST(suite, morph_different_dimensions);
+	SUITE_ADD_TEST(suite, morph_different_dimensions_equals_projection);
+	SUITE_ADD_TEST(suite, morph_eval_all);
+	SUITE_ADD_TEST(suite, morph_update);
+	return suite;
+}
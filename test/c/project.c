@@ -0,0 +1,171 @@
+#include <testutils.h>
+#include <math.h>
+
+/* Returns the squared distance between `a` and `b`. */
+tsReal dist2(const tsReal *a, const tsReal *b, size_t dim)
+{
+	tsReal dist = 0.f;
+	size_t d;
+	for (d = 0; d < dim; d++)
+		dist += (a[d] - b[d]) * (a[d] - b[d]);
+	return dist;
+}
+
+void project_compare_with_sampling(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsProjector projector = ts_projector_init();
+	tsReal ctrlp[14] = { 120, 100, 270, 40, 370, 490, 590, 40,
+		570, 490, 420, 480, 220, 500 };
+	tsReal *samples = NULL, *result = NULL, point[2], closest[2];
+	tsReal u, min, max, best, dist;
+	size_t x, y, i;
+
+	___GIVEN___
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	C(ts_bspline_sample(&spline, 5000, &samples, &i, &status))
+
+	___WHEN___
+	C(ts_projector_new(&spline, &projector, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 2, (int) ts_projector_dimension(&projector));
+	for (x = 0; x <= 10; x++) {
+		for (y = 0; y <= 10; y++) {
+			point[0] = (tsReal) (x * 70);
+			point[1] = (tsReal) (y * 60);
+			C(ts_projector_project(&projector, point, &u,
+				closest, &status))
+			ts_bspline_domain(&spline, &min, &max);
+			CuAssertTrue(tc, u >= min && u <= max);
+			best = dist2(samples, point, 2);
+			for (i = 1; i < 5000; i++) {
+				dist = dist2(samples + i * 2, point, 2);
+				best = dist < best ? dist : best;
+			}
+			/* Never worse than dense sampling. */
+			dist = dist2(closest, point, 2);
+			CuAssertTrue(tc, dist <= best + (tsReal) 0.01);
+			C(ts_bspline_eval_all(&spline, &u, 1, &result,
+				&status))
+			CuAssertDblEquals(tc, result[0], closest[0],
+				POINT_EPSILON);
+			CuAssertDblEquals(tc, result[1], closest[1],
+				POINT_EPSILON);
+			free(result);
+			result = NULL;
+		}
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_projector_free(&projector);
+	free(samples);
+	free(result);
+}
+
+void project_points_on_spline(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsProjector projector = ts_projector_init();
+	tsProjector copy = ts_projector_init();
+	tsReal *ctrlp = NULL, *points = NULL, knots[200], us[200], u;
+	size_t i;
+
+	___GIVEN___
+	/* A helix, i.e., the spline does not intersect itself. */
+	C(ts_bspline_new(40, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < 40; i++) {
+		ctrlp[i * 3] = (tsReal) cos((double) i / 2);
+		ctrlp[i * 3 + 1] = (tsReal) sin((double) i / 2);
+		ctrlp[i * 3 + 2] = (tsReal) i / 10;
+	}
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	for (i = 0; i < 200; i++)
+		knots[i] = (tsReal) i / 199;
+	C(ts_bspline_eval_all(&spline, knots, 200, &points, &status))
+	C(ts_projector_new(&spline, &projector, &status))
+
+	___WHEN___
+	C(ts_projector_copy(&projector, &copy, &status))
+	C(ts_projector_project_all(&copy, points, 200, us, &status))
+
+	___THEN___
+	for (i = 0; i < 200; i++)
+		CuAssertDblEquals(tc, knots[i], us[i], POINT_EPSILON);
+	C(ts_projector_project(&projector, points + 3 * 150, &u, NULL,
+		&status))
+	CuAssertDblEquals(tc, knots[150], u, POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_projector_free(&projector);
+	ts_projector_free(&copy);
+	free(ctrlp);
+	free(points);
+}
+
+void project_line(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal ctrlp[6] = { 0, 0, 10, 0, 10, 10 };
+	tsReal points[6] = { 4, -3, 12, 5, -1, -1 };
+	tsReal closest[2], us[3], u;
+
+	___GIVEN___
+	C(ts_bspline_new(3, 2, 1, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_bspline_project_point(&spline, points, &u, closest, &status))
+
+	___THEN___
+	CuAssertDblEquals(tc, 0.2, u, POINT_EPSILON);
+	CuAssertDblEquals(tc, 4, closest[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0, closest[1], POINT_EPSILON);
+	C(ts_bspline_project_points(&spline, points, 3, us, &status))
+	CuAssertDblEquals(tc, 0.2, us[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0.75, us[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0, us[2], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void project_single_point(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal ctrlp[3] = { 1, 2, 3 };
+	tsReal point[3] = { -5, 5, 0 }, closest[3], u;
+
+	___GIVEN___
+	C(ts_bspline_new(1, 3, 0, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_bspline_project_point(&spline, point, &u, closest, &status))
+
+	___THEN___
+	CuAssertDblEquals(tc, 1, closest[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 2, closest[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, 3, closest[2], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_project_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, project_compare_with_sampling);
+	SUITE_ADD_TEST(suite, project_points_on_spline);
+	SUITE_ADD_TEST(suite, project_line);
+	SUITE_ADD_TEST(suite, project_single_point);
+	return suite;
+}
@@ -0,0 +1,200 @@
+#include <testutils.h>
+#include <math.h>
+
+/* Creates a NURBS describing the unit circle (with homogeneous control
+ * points in 2D). */
+void create_circle(CuTest *tc, tsBSpline *spline)
+{
+	___SETUP___
+	const tsReal w = (tsReal) (sqrt(2.0) / 2.0);
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	C(ts_bspline_new_with_control_points(
+		9, 3, 2, TS_CLAMPED, spline, &status,
+		 1.0, 0.0, 1.0,
+		   w,   w,   w,
+		 0.0, 1.0, 1.0,
+		  -w,   w,   w,
+		-1.0, 0.0, 1.0,
+		  -w,  -w,   w,
+		 0.0,-1.0, 1.0,
+		   w,  -w,   w,
+		 1.0, 0.0, 1.0))
+	C(ts_bspline_set_knots_varargs(spline, &status,
+		(tsReal) 0.0, 0.0, 0.0, 0.25, 0.25, 0.5, 0.5, 0.75, 0.75,
+		1.0, 1.0, 1.0))
+
+	___TEARDOWN___
+}
+
+void rational_circle(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[101], points[101 * 2], sampled[101 * 2], point[2], hom[3];
+	size_t i, num;
+
+	___GIVEN___
+	create_circle(tc, &spline);
+	for (i = 0; i < 101; i++)
+		us[i] = (tsReal) ((i * 37) % 101) / 100;
+
+	___WHEN___
+	C(ts_bspline_eval_rational_all(&spline, us, 101, points, 202,
+		&status))
+	C(ts_bspline_sample_rational(&spline, 101, sampled, 202, &num,
+		&status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 101, (int) num);
+	for (i = 0; i < 101; i++) {
+		CuAssertDblEquals(tc, 0, ts_distance(points + i * 2,
+			sampled + ((i * 37) % 101) * 2, 2), POINT_EPSILON);
+		CuAssertDblEquals(tc, 1, sqrt(points[i * 2] * points[i * 2] +
+			points[i * 2 + 1] * points[i * 2 + 1]), POINT_EPSILON);
+		C(ts_bspline_eval_rational_point(&spline, us[i], point,
+			&status))
+		C(ts_bspline_eval_point(&spline, us[i], hom, &status))
+		CuAssertDblEquals(tc, hom[0] / hom[2], point[0],
+			POINT_EPSILON);
+		CuAssertDblEquals(tc, hom[1] / hom[2], point[1],
+			POINT_EPSILON);
+		CuAssertDblEquals(tc, point[0], points[i * 2],
+			POINT_EPSILON);
+		CuAssertDblEquals(tc, point[1], points[i * 2 + 1],
+			POINT_EPSILON);
+	}
+	/* The first and the last point are exact. */
+	CuAssertDblEquals(tc, 1, sampled[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0, sampled[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1, sampled[200], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0, sampled[201], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void rational_derivs_circle(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[40], derivs[40 * 3 * 2], point[2], *c, *d1, *d2;
+	size_t i;
+
+	___GIVEN___
+	create_circle(tc, &spline);
+	for (i = 0; i < 40; i++)
+		us[i] = (tsReal) i / 39;
+
+	___WHEN___
+	C(ts_bspline_eval_rational_derivs_all(&spline, us, 40, 2, derivs,
+		&status))
+
+	___THEN___
+	for (i = 0; i < 40; i++) {
+		c = derivs + i * 6;
+		d1 = c + 2;
+		d2 = c + 4;
+		C(ts_bspline_eval_rational_point(&spline, us[i], point,
+			&status))
+		CuAssertDblEquals(tc, point[0], c[0], POINT_EPSILON);
+		CuAssertDblEquals(tc, point[1], c[1], POINT_EPSILON);
+		/* |C| == 1 implies C * C' == 0 and C * C'' == -C' * C'. */
+		CuAssertDblEquals(tc, 0, c[0] * d1[0] + c[1] * d1[1],
+			POINT_EPSILON);
+		CuAssertTrue(tc, d1[0] * d1[0] + d1[1] * d1[1] > 1);
+		CuAssertDblEquals(tc, -(d1[0] * d1[0] + d1[1] * d1[1]),
+			c[0] * d2[0] + c[1] * d2[1], (tsReal) 1e-3);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void rational_derivs_unit_weights(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL, us[7], expected[7 * 4 * 3], derivs[7 * 4 * 2];
+	size_t i, j;
+
+	___GIVEN___
+	C(ts_bspline_new(8, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < 8; i++) {
+		ctrlp[i * 3] = (tsReal) ((i * 7) % 5);
+		ctrlp[i * 3 + 1] = (tsReal) ((i * 3) % 4);
+		ctrlp[i * 3 + 2] = 1;
+	}
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	for (i = 0; i < 7; i++)
+		us[i] = (tsReal) i / 6;
+
+	___WHEN___
+	C(ts_bspline_eval_derivs_all(&spline, us, 7, 3, expected, &status))
+	C(ts_bspline_eval_rational_derivs_all(&spline, us, 7, 3, derivs,
+		&status))
+
+	___THEN___
+	/* Constant weights yield the derivatives of the homogeneous curve. */
+	for (i = 0; i < 7 * 4; i++) {
+		for (j = 0; j < 2; j++) {
+			CuAssertDblEquals(tc, expected[i * 3 + j],
+				derivs[i * 2 + j], POINT_EPSILON);
+		}
+	}
+	C(ts_bspline_eval_rational_derivs(&spline, us[3], 3, derivs,
+		&status))
+	for (i = 0; i < 4 * 2; i++) {
+		CuAssertDblEquals(tc, expected[(3 * 4 + i / 2) * 3 + i % 2],
+			derivs[i], POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+void rational_errors(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init(), line = ts_bspline_init();
+	tsStatus actual;
+	tsReal us[2] = { 0, 2 }, points[6];
+	size_t num;
+
+	___GIVEN___
+	create_circle(tc, &spline);
+	C(ts_bspline_new(2, 1, 1, TS_CLAMPED, &line, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_eval_rational_all(
+		&spline, us, 2, points, 3, NULL));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_rational_all(
+		&spline, us, 2, points, 4, &actual));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, actual.code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_rational_derivs(
+		&spline, us[1], 1, points, NULL));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_sample_rational(
+		&spline, 4, points, 6, &num, NULL));
+	CuAssertIntEquals(tc, 4, (int) num);
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bspline_eval_rational_point(
+		&line, 0, points, &actual));
+	CuAssertIntEquals(tc, TS_DIM_ZERO, actual.code);
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bspline_eval_rational_derivs(
+		&line, 0, 1, points, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&line);
+}
+
+CuSuite* get_rational_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, rational_circle);
+	SUITE_ADD_TEST(suite, rational_derivs_circle);
+	SUITE_ADD_TEST(suite, rational_derivs_unit_weights);
+	SUITE_ADD_TEST(suite, rational_errors);
+	return suite;
+}
@@ -0,0 +1,149 @@
+#include <testutils.h>
+#include <math.h>
+#include <string.h>
+
+/* Returns the maximum distance between `a' and `b' at the same knots. */
+tsReal remove_knots_deviation(const tsBSpline *a, const tsBSpline *b)
+{
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal min, max, u, pa[3], dist, dev = 0;
+	size_t i;
+	ts_bspline_domain(a, &min, &max);
+	for (i = 0; i <= 1000; i++) {
+		u = min + (max - min) * (tsReal) i / 1000;
+		ts_bspline_eval(a, u, &net, NULL);
+		memcpy(pa, ts_deboornet_result_ptr(&net),
+			ts_bspline_dimension(a) * sizeof(tsReal));
+		ts_deboornet_free(&net);
+		ts_bspline_eval(b, u, &net, NULL);
+		dist = ts_distance(pa, ts_deboornet_result_ptr(&net),
+			ts_bspline_dimension(a));
+		ts_deboornet_free(&net);
+		if (dist > dev)
+			dev = dist;
+	}
+	return dev;
+}
+
+void remove_knots_redundant(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline refined = ts_bspline_init();
+	tsBSpline simplified = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsReal insert[5] = { (tsReal) 0.1, (tsReal) 0.3, (tsReal) 0.3,
+		(tsReal) 0.55, (tsReal) 0.9 }, *ctrlp = NULL;
+	size_t i, deg;
+
+	___GIVEN___
+	for (deg = 1; deg <= 3; deg++) {
+		C(ts_bspline_new(8, 3, deg, TS_CLAMPED, &spline, &status))
+		C(ts_bspline_control_points(&spline, &ctrlp, &status))
+		for (i = 0; i < 24; i++)
+			ctrlp[i] = (tsReal) ((i * i * 7 + i) % 13);
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		free(ctrlp);
+		ctrlp = NULL;
+		C(ts_bspline_refine_knots(&spline, insert, 5, &refined,
+			&status))
+
+		___WHEN___
+		C(ts_bspline_remove_knots(&refined, POINT_EPSILON,
+			&simplified, &status))
+
+		___THEN___
+		/* The inserted knots are removed again. */
+		CuAssertIntEquals(tc, 8, (int)
+			ts_bspline_num_control_points(&simplified));
+		for (i = 0; i < ts_bspline_num_knots(&spline); i++) {
+			CuAssertDblEquals(tc,
+				ts_bspline_knots_ptr(&spline)[i],
+				ts_bspline_knots_ptr(&simplified)[i],
+				TS_KNOT_EPSILON);
+		}
+		for (i = 0; i < 24; i++) {
+			CuAssertDblEquals(tc,
+				ts_bspline_control_points_ptr(&spline)[i],
+				ts_bspline_control_points_ptr(&simplified)[i],
+				POINT_EPSILON);
+		}
+
+		___WHEN___
+		/* Bezier decomposition (multiplicity == order). */
+		C(ts_bspline_to_beziers(&spline, &beziers, &status))
+		C(ts_bspline_remove_knots(&beziers, POINT_EPSILON, &beziers,
+			&status))
+
+		___THEN___
+		CuAssertIntEquals(tc, 8, (int)
+			ts_bspline_num_control_points(&beziers));
+		assert_equal_shape(tc, &spline, &beziers);
+
+		ts_bspline_free(&spline);
+		ts_bspline_free(&refined);
+		ts_bspline_free(&simplified);
+		ts_bspline_free(&beziers);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&refined);
+	ts_bspline_free(&simplified);
+	ts_bspline_free(&beziers);
+	free(ctrlp);
+}
+
+void remove_knots_tolerance(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline simplified = ts_bspline_init();
+	tsBSpline coarse = ts_bspline_init();
+	tsReal points[200];
+	size_t i;
+
+	___GIVEN___
+	for (i = 0; i < 100; i++) {
+		points[i * 2] = (tsReal) (i * 0.1);
+		points[i * 2 + 1] = (tsReal) sin(i * 0.1);
+	}
+	C(ts_bspline_interpolate_cubic_natural(points, 100, 2, &spline,
+		&status))
+	C(ts_bspline_to_beziers(&spline, &spline, &status))
+
+	___WHEN___
+	C(ts_bspline_remove_knots(&spline, (tsReal) 0.01, &simplified,
+		&status))
+	C(ts_bspline_remove_knots(&spline, (tsReal) 0.1, &coarse, &status))
+
+	___THEN___
+	CuAssertTrue(tc, ts_bspline_num_control_points(&simplified) <
+		ts_bspline_num_control_points(&spline) / 4);
+	CuAssertTrue(tc, ts_bspline_num_control_points(&coarse) <
+		ts_bspline_num_control_points(&simplified));
+	CuAssertTrue(tc, remove_knots_deviation(&spline, &simplified) <=
+		0.01);
+	CuAssertTrue(tc, remove_knots_deviation(&spline, &coarse) <= 0.1);
+
+	___WHEN___
+	/* Negative tolerance. */
+	C(ts_bspline_remove_knots(&spline, -1, &spline, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 4 * 99,
+		(int) ts_bspline_num_control_points(&spline));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&simplified);
+	ts_bspline_free(&coarse);
+}
+
+CuSuite* get_remove_knots_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, remove_knots_redundant);
+	SUITE_ADD_TEST(suite, remove_knots_tolerance);
+	return suite;
+}
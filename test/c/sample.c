@@ -165,6 +165,336 @@ void sample_default_num(CuTest *tc)
 	free(points);
 }
 
+void sample_into_equals_sample(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal buffer[300], *points = NULL;
+	size_t i, num, num_into;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		7, 2, 3, TS_CLAMPED, &spline, &status,
+		-1.75, -1.0,  /* P1 */
+		-1.5,  -0.5,  /* P2 */
+		-1.3,   0.0,  /* P3 */
+		-1.25,  0.5,  /* P4 */
+		-0.75,  0.75, /* P5 */
+		 0.0,   0.5,  /* P6 */
+		 0.5,   0.0)) /* P7 */
+
+	___WHEN___
+	C(ts_bspline_sample(&spline, 0, &points, &num, &status))
+	C(ts_bspline_sample_into(&spline, 0, buffer,
+		sizeof(buffer) / sizeof(tsReal), &num_into, &status))
+
+	___THEN___
+	CuAssertTrue(tc, num == num_into);
+	for (i = 0; i < num * 2; i++)
+		CuAssertDblEquals(tc, points[i], buffer[i], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(points);
+}
+
+void sample_into_insufficient_capacity(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal buffer[10], us[2];
+	size_t num = 0;
+	tsError err;
+
+	___GIVEN___
+	C(ts_bspline_new(4, 3, 3, TS_CLAMPED, &spline, &status))
+	us[0] = (tsReal) 0.25;
+	us[1] = (tsReal) 0.75;
+
+	___WHEN___ /* 1 */
+	err = ts_bspline_sample_into(&spline, 4, buffer, 10, &num, NULL);
+
+	___THEN___ /* 1 */
+	CuAssertIntEquals(tc, TS_NUM_POINTS, err);
+	CuAssertTrue(tc, num == 4);
+
+	___WHEN___ /* 2 */
+	err = ts_bspline_eval_all_into(&spline, us, 2, buffer, 5, &status);
+
+	___THEN___ /* 2 */
+	CuAssertIntEquals(tc, TS_NUM_POINTS, err);
+	CuAssertIntEquals(tc, TS_NUM_POINTS, status.code);
+
+	___WHEN___ /* 3 */
+	C(ts_bspline_eval_all_into(&spline, us, 2, buffer, 6, &status))
+
+	___THEN___ /* 3 */
+	CuAssertIntEquals(tc, TS_SUCCESS, status.code);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void sample_f_and_d_equal_sample_into(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal buffer[300];
+	float bufferf[300];
+	double bufferd[300];
+	size_t i, num, num_f, num_d;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		7, 2, 3, TS_OPENED, &spline, &status,
+		-1.75, -1.0,  /* P1 */
+		-1.5,  -0.5,  /* P2 */
+		-1.3,   0.0,  /* P3 */
+		-1.25,  0.5,  /* P4 */
+		-0.75,  0.75, /* P5 */
+		 0.0,   0.5,  /* P6 */
+		 0.5,   0.0)) /* P7 */
+
+	___WHEN___
+	C(ts_bspline_sample_into(&spline, 0, buffer, 300, &num, &status))
+	C(ts_bspline_sample_f(&spline, 0, bufferf, 300, &num_f, &status))
+	C(ts_bspline_sample_d(&spline, 0, bufferd, 300, &num_d, &status))
+
+	___THEN___
+	CuAssertTrue(tc, num == num_f);
+	CuAssertTrue(tc, num == num_d);
+	for (i = 0; i < num * 2; i++) {
+		CuAssertDblEquals(tc, buffer[i], bufferf[i], (tsReal) 1e-4);
+		CuAssertDblEquals(tc, buffer[i], bufferd[i], POINT_EPSILON);
+	}
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_sample_f(&spline,
+		200, bufferf, 300, &num_f, NULL));
+	CuAssertTrue(tc, num_f == 200);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void sample_knots_of_beziers(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsReal dist, point[2], *points = NULL;
+	size_t i, num;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		7, 2, 3, TS_CLAMPED, &spline, &status,
+		-1.75, -1.0,  /* P1 */
+		-1.5,  -0.5,  /* P2 */
+		-1.3,   0.0,  /* P3 */
+		-1.25,  0.5,  /* P4 */
+		-0.75,  0.75, /* P5 */
+		 0.0,   0.5,  /* P6 */
+		 0.5,   0.0)) /* P7 */
+	C(ts_bspline_to_beziers(&spline, &beziers, &status))
+
+	___WHEN___
+	/* Samples the (discontinuous) knots of `beziers` exactly. */
+	C(ts_bspline_sample(&beziers, 41, &points, &num, &status))
+
+	___THEN___
+	CuAssertTrue(tc, num == 41);
+	for (i = 0; i < num; i++) {
+		C(ts_bspline_eval_point(&beziers, (tsReal) i / 40, point,
+			&status))
+		dist = ts_distance(point, points + i * 2, 2);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&beziers);
+	free(points);
+}
+
+void sample_fast_equals_sample(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal *expected = NULL, *points = NULL, *ctrlp = NULL, error, dist;
+	size_t actual_num, i, j, k, n;
+	const size_t degrees[5] = { 0, 1, 2, 3, 5 };
+	const tsBSplineType types[3] = { TS_OPENED, TS_CLAMPED, TS_BEZIERS };
+	const size_t nums[5] = { 1, 2, 7, 0, 1001 };
+
+	___GIVEN___
+	expected = (tsReal *) malloc(1001 * 3 * sizeof(tsReal));
+	points = (tsReal *) malloc(1001 * 3 * sizeof(tsReal));
+	CuAssertPtrNotNull(tc, expected);
+	CuAssertPtrNotNull(tc, points);
+
+	___WHEN___ ___THEN___
+	for (i = 0; i < 5; i++) {
+		for (j = 0; j < 3; j++) {
+			C(ts_bspline_new(12, 3, degrees[i], types[j],
+				&spline, &status))
+			C(ts_bspline_control_points(&spline, &ctrlp,
+				&status))
+			for (k = 0; k < 36; k++)
+				ctrlp[k] = (tsReal) ((k * 7 + i) % 11) - 5;
+			C(ts_bspline_set_control_points(&spline, ctrlp,
+				&status))
+			for (k = 0; k < 5; k++) {
+				C(ts_bspline_sample_into(&spline, nums[k],
+					expected, 1001 * 3, &actual_num,
+					&status))
+				C(ts_bspline_sample_fast(&spline, nums[k],
+					points, 1001 * 3, &n, &error,
+					&status))
+				CuAssertTrue(tc, n == actual_num);
+				CuAssertDblEquals(tc, 0, error,
+					POINT_EPSILON);
+				for (n = 0; n < actual_num; n++) {
+					dist = ts_distance(expected + n * 3,
+						points + n * 3, 3);
+					CuAssertDblEquals(tc, 0, dist,
+						POINT_EPSILON);
+				}
+			}
+			ts_bspline_free(&spline);
+			free(ctrlp);
+			ctrlp = NULL;
+		}
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(expected);
+	free(points);
+	free(ctrlp);
+}
+
+void sample_fast_insufficient_capacity(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal buffer[12];
+	size_t num = 0;
+
+	___GIVEN___
+	C(ts_bspline_new(4, 3, 3, TS_CLAMPED, &spline, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_sample_fast(
+		&spline, 5, buffer, 12, &num, NULL, NULL));
+	CuAssertTrue(tc, num == 5);
+	C(ts_bspline_sample_fast(&spline, 4, buffer, 12, &num, NULL,
+		&status))
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+/* Returns the distance of `point` to the polyline `points` (2D). */
+tsReal distance_to_polyline(const tsReal *point, const tsReal *points,
+	size_t num)
+{
+	tsReal min = ts_distance(point, points, 2), len2, t, q[2], dist;
+	const tsReal *a, *b;
+	size_t i;
+	for (i = 1; i < num; i++) {
+		a = points + (i - 1) * 2;
+		b = points + i * 2;
+		len2 = (b[0] - a[0]) * (b[0] - a[0]) +
+			(b[1] - a[1]) * (b[1] - a[1]);
+		t = 0;
+		if (len2 > 0) {
+			t = ((point[0] - a[0]) * (b[0] - a[0]) +
+				(point[1] - a[1]) * (b[1] - a[1])) / len2;
+			t = t < 0 ? 0 : t > 1 ? 1 : t;
+		}
+		q[0] = a[0] + t * (b[0] - a[0]);
+		q[1] = a[1] + t * (b[1] - a[1]);
+		dist = ts_distance(point, q, 2);
+		min = dist < min ? dist : min;
+	}
+	return min;
+}
+
+void sample_adaptive_tolerance(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal ctrlp[14] = { 120, 100, 270, 40, 370, 490, 590, 40,
+		570, 490, 420, 480, 220, 500 };
+	const tsReal tolerances[3] = { 10.0, 1.0, 0.1 };
+	tsReal *points = NULL, point[2], min, max, dist;
+	size_t capacity = 0, num, prev_num = 0, i, j;
+
+	___GIVEN___
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	ts_bspline_domain(&spline, &min, &max);
+
+	___WHEN___ ___THEN___
+	for (i = 0; i < 3; i++) {
+		/* Reuses (and grows) `points`. */
+		C(ts_bspline_sample_adaptive(&spline, tolerances[i], &points,
+			&capacity, &num, &status))
+		CuAssertTrue(tc, num * 2 <= capacity);
+		/* Tighter tolerances yield more points. */
+		CuAssertTrue(tc, num > prev_num);
+		prev_num = num;
+
+		/* The first and the last point are exact. */
+		C(ts_bspline_eval_point(&spline, min, point, &status))
+		dist = ts_distance(point, points, 2);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+		C(ts_bspline_eval_point(&spline, max, point, &status))
+		dist = ts_distance(point, points + (num - 1) * 2, 2);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+
+		/* The spline is within the tolerance of the polyline. */
+		for (j = 0; j <= 500; j++) {
+			C(ts_bspline_eval_point(&spline,
+				min + (max - min) * (tsReal) j / 500,
+				point, &status))
+			dist = distance_to_polyline(point, points, num);
+			CuAssertTrue(tc, dist <= tolerances[i] +
+				POINT_EPSILON);
+		}
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(points);
+}
+
+void sample_adaptive_line(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal ctrlp[8] = { 0, 0, 1, 1, 2, 2, 3, 3 };
+	tsReal *points = NULL;
+	size_t capacity = 0, num;
+
+	___GIVEN___
+	C(ts_bspline_new(4, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_bspline_sample_adaptive(&spline, (tsReal) 0.001, &points,
+		&capacity, &num, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 2, (int) num);
+	CuAssertDblEquals(tc, 0, points[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0, points[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, 3, points[2], POINT_EPSILON);
+	CuAssertDblEquals(tc, 3, points[3], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(points);
+}
+
 CuSuite* get_sample_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -173,5 +503,13 @@ CuSuite* get_sample_suite()
 	SUITE_ADD_TEST(suite, sample_num_3);
 	SUITE_ADD_TEST(suite, sample_compare_with_bisect);
 	SUITE_ADD_TEST(suite, sample_default_num);
+	SUITE_ADD_TEST(suite, sample_into_equals_sample);
+	SUITE_ADD_TEST(suite, sample_into_insufficient_capacity);
+	SUITE_ADD_TEST(suite, sample_f_and_d_equal_sample_into);
+	SUITE_ADD_TEST(suite, sample_knots_of_beziers);
+	SUITE_ADD_TEST(suite, sample_fast_equals_sample);
+	SUITE_ADD_TEST(suite, sample_fast_insufficient_capacity);
+	SUITE_ADD_TEST(suite, sample_adaptive_tolerance);
+	SUITE_ADD_TEST(suite, sample_adaptive_line);
 	return suite;
 }
\ No newline at end of file
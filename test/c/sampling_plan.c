@@ -0,0 +1,183 @@
+#include <testutils.h>
+
+/* Applies a plan, created at `num` knots distributed in the domain of
+ * `spline` (including its interior knots), and compares the resultant points
+ * with ts_bspline_eval_point. */
+void assert_plan_equals_eval(CuTest *tc, const tsBSpline *spline)
+{
+	___SETUP___
+	tsSamplingPlan plan = ts_sampling_plan_init();
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const size_t num = 51 + num_knots;
+	tsReal us[100], points[100 * 5], point[5], min, max, dist;
+	size_t i;
+
+	___GIVEN___
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < 51; i++)
+		us[i] = min + (max - min) * (tsReal) i / 50;
+	for (i = 0; i < num_knots; i++) {
+		C(ts_bspline_knot_at(spline, i, us + 51 + i, &status))
+		/* Knots outside of the domain are clamped. */
+		if (us[51 + i] < min)
+			us[51 + i] = min;
+		if (us[51 + i] > max)
+			us[51 + i] = max;
+	}
+
+	___WHEN___
+	C(ts_sampling_plan_new(spline, us, num, &plan, &status))
+	C(ts_sampling_plan_eval(&plan, spline, points, num * dim, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, (int) num,
+		(int) ts_sampling_plan_num_points(&plan));
+	for (i = 0; i < num; i++) {
+		C(ts_bspline_eval_point(spline, us[i], point, &status))
+		dist = ts_distance(point, points + i * dim, dim);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	ts_sampling_plan_free(&plan);
+}
+
+void sampling_plan_equals_eval(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	tsReal knots[10] = { 0.0, 0.1, 0.2, 0.3, 0.5, 0.7, 0.8, 0.8, 0.9,
+		1.0 };
+	size_t i, j;
+	const size_t degrees[5] = { 0, 1, 2, 3, 5 };
+	const tsBSplineType types[3] = { TS_OPENED, TS_CLAMPED, TS_BEZIERS };
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	for (i = 0; i < 5; i++) {
+		for (j = 0; j < 3; j++) {
+			C(ts_bspline_new(12, 3, degrees[i], types[j],
+				&spline, &status))
+			C(ts_bspline_control_points(&spline, &ctrlp,
+				&status))
+			ctrlp[(i * 7 + j) % 36] = (tsReal) 5.0;
+			ctrlp[(i * 11 + j * 5) % 36] = (tsReal) -3.0;
+			C(ts_bspline_set_control_points(&spline, ctrlp,
+				&status))
+			assert_plan_equals_eval(tc, &spline);
+			ts_bspline_free(&spline);
+			free(ctrlp);
+			ctrlp = NULL;
+		}
+	}
+
+	/* The maximum of the domain is a multiple knot, but the last knot
+	 * has a different value. */
+	C(ts_bspline_new(6, 2, 3, TS_OPENED, &spline, &status))
+	C(ts_bspline_set_knots(&spline, knots, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < 12; i++)
+		ctrlp[i] = (tsReal) ((i * 7) % 5);
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	assert_plan_equals_eval(tc, &spline);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(ctrlp);
+}
+
+void sampling_plan_other_spline(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init(), other = ts_bspline_init();
+	tsSamplingPlan plan = ts_sampling_plan_init();
+	tsSamplingPlan copy = ts_sampling_plan_init();
+	tsReal us[20], points[20 * 4], point[4], *ctrlp = NULL, dist;
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new(9, 2, 3, TS_CLAMPED, &spline, &status))
+	/* Same knots, but different dimension and control points. */
+	C(ts_bspline_new(9, 4, 3, TS_CLAMPED, &other, &status))
+	C(ts_bspline_control_points(&other, &ctrlp, &status))
+	for (i = 0; i < 36; i++)
+		ctrlp[i] = (tsReal) ((i * 13) % 7) - 3;
+	C(ts_bspline_set_control_points(&other, ctrlp, &status))
+	for (i = 0; i < 20; i++)
+		us[i] = (tsReal) i / 19;
+	C(ts_sampling_plan_new(&spline, us, 20, &plan, &status))
+
+	___WHEN___
+	C(ts_sampling_plan_copy(&plan, &copy, &status))
+	ts_sampling_plan_free(&plan);
+	C(ts_sampling_plan_eval(&copy, &other, points, 80, &status))
+
+	___THEN___
+	for (i = 0; i < 20; i++) {
+		C(ts_bspline_eval_point(&other, us[i], point, &status))
+		dist = ts_distance(point, points + i * 4, 4);
+		CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+	}
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&other);
+	ts_sampling_plan_free(&plan);
+	ts_sampling_plan_free(&copy);
+	free(ctrlp);
+}
+
+void sampling_plan_incompatible(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init(), other = ts_bspline_init();
+	tsSamplingPlan plan = ts_sampling_plan_init();
+	tsReal us[3] = { 0.0, 0.5, 1.0 }, points[9];
+
+	___GIVEN___
+	C(ts_bspline_new(7, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_sampling_plan_new(&spline, us, 3, &plan, &status))
+
+	___WHEN___ ___THEN___
+	/* Different degree. */
+	C(ts_bspline_new(7, 3, 2, TS_CLAMPED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_sampling_plan_eval(&plan, &other, points, 9, NULL));
+	ts_bspline_free(&other);
+
+	/* Different number of knots. */
+	C(ts_bspline_new(8, 3, 3, TS_CLAMPED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_sampling_plan_eval(&plan, &other, points, 9, NULL));
+	ts_bspline_free(&other);
+
+	/* Different knots. */
+	C(ts_bspline_new(7, 3, 3, TS_OPENED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_sampling_plan_eval(&plan, &other, points, 9, NULL));
+
+	/* Insufficient capacity. */
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_sampling_plan_eval(&plan, &spline, points, 8, NULL));
+
+	/* Undefined knot. */
+	ts_sampling_plan_free(&plan);
+	us[1] = (tsReal) 2.0;
+	CuAssertIntEquals(tc, TS_U_UNDEFINED,
+		ts_sampling_plan_new(&spline, us, 3, &plan, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&other);
+	ts_sampling_plan_free(&plan);
+}
+
+CuSuite* get_sampling_plan_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, sampling_plan_equals_eval);
+	SUITE_ADD_TEST(suite, sampling_plan_other_spline);
+	SUITE_ADD_TEST(suite, sampling_plan_incompatible);
+	return suite;
+}
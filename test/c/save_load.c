@@ -1,4 +1,7 @@
 #include <testutils.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
 
 /* This epsilon environment can be chosen smaller than usual because the loss
  * of significance should be very small when serializing/deserializing floating
@@ -76,9 +79,668 @@ void save_load_load_equals_save(CuTest *tc)
 	remove(file);
 }
 
+/* Asserts that `a` and `b` have the same degree, dimension, and (bitwise)
+ * equal control points and knots. */
+void assert_identical(CuTest *tc, const tsBSpline *a, const tsBSpline *b)
+{
+	___SETUP___
+	tsReal *actrlp = NULL, *bctrlp = NULL, *aknots = NULL, *bknots = NULL;
+
+	___GIVEN___ ___WHEN___
+	C(ts_bspline_control_points(a, &actrlp, &status))
+	C(ts_bspline_control_points(b, &bctrlp, &status))
+	C(ts_bspline_knots(a, &aknots, &status))
+	C(ts_bspline_knots(b, &bknots, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, (int) ts_bspline_degree(a),
+		(int) ts_bspline_degree(b));
+	CuAssertIntEquals(tc, (int) ts_bspline_dimension(a),
+		(int) ts_bspline_dimension(b));
+	CuAssertIntEquals(tc, (int) ts_bspline_len_control_points(a),
+		(int) ts_bspline_len_control_points(b));
+	CuAssertTrue(tc, memcmp(actrlp, bctrlp,
+		ts_bspline_sof_control_points(a)) == 0);
+	CuAssertTrue(tc, memcmp(aknots, bknots,
+		ts_bspline_sof_knots(a)) == 0);
+
+	___TEARDOWN___
+	free(actrlp);
+	free(bctrlp);
+	free(aknots);
+	free(bknots);
+}
+
+void save_load_binary_equals_save(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline save = ts_bspline_init();
+	tsBSpline load = ts_bspline_init();
+	tsBSpline parse = ts_bspline_init();
+	unsigned char *binary = NULL;
+	size_t size;
+	char *file = "save_load_binary_test_file.bin";
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		6, 2, 5, TS_OPENED, &save, &status,
+		 100.0,    0.0,   /* P1 */
+		 200.0,  -10.7,   /* P2 */
+		 500.5,   40.0,   /* P3 */
+		-300.0, -260.0,   /* P4 */
+		-50.1,   200.0,   /* P5 */
+		-80.0,   130.24)) /* P6 */
+
+	___WHEN___
+	C(ts_bspline_save_binary(&save, file, &status))
+	C(ts_bspline_load_binary(file, &load, &status))
+	C(ts_bspline_to_binary(&save, &binary, &size, &status))
+	C(ts_bspline_parse_binary(binary, size, &parse, &status))
+
+	___THEN___
+	/* Header, control points, and knots. */
+	CuAssertIntEquals(tc, 40 + 24 * (int) sizeof(tsReal), (int) size);
+	CuAssertTrue(tc, memcmp(binary, "TSBS", 4) == 0);
+	/* The values are copied verbatim, i.e., the splines are equal. */
+	CuAssertTrue(tc, save.pImpl != load.pImpl);
+	assert_identical(tc, &save, &load);
+	assert_identical(tc, &save, &parse);
+
+	___TEARDOWN___
+	ts_bspline_free(&save);
+	ts_bspline_free(&load);
+	ts_bspline_free(&parse);
+	free(binary);
+	remove(file);
+}
+
+void save_load_binary_foreign_format(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline parse = ts_bspline_init();
+	unsigned char *binary = NULL, foreign[40 + 24 * 8], bytes[8];
+	size_t size, i, j, prec, num_values = 0;
+	const tsReal *values;
+	tsReal *ctrlp = NULL, *knots = NULL;
+	float f;
+	double d;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		6, 2, 5, TS_OPENED, &spline, &status,
+		 100.0,    0.0,   /* P1 */
+		 200.0,  -10.7,   /* P2 */
+		 500.5,   40.0,   /* P3 */
+		-300.0, -260.0,   /* P4 */
+		-50.1,   200.0,   /* P5 */
+		-80.0,   130.24)) /* P6 */
+	C(ts_bspline_to_binary(&spline, &binary, &size, &status))
+	/* Store the values with the other precision and byte order. */
+	prec = sizeof(tsReal) == sizeof(float) ? sizeof(double)
+		: sizeof(float);
+	memcpy(foreign, binary, 40);
+	foreign[5] = (unsigned char) prec;
+	foreign[6] = binary[6] == 1 ? 2 : 1;
+	values = (const tsReal *) (binary + 40);
+	num_values = (size - 40) / sizeof(tsReal);
+	for (i = 0; i < num_values; i++) {
+		if (prec == sizeof(float)) {
+			f = (float) values[i];
+			memcpy(bytes, &f, sizeof(float));
+		} else {
+			d = (double) values[i];
+			memcpy(bytes, &d, sizeof(double));
+		}
+		for (j = 0; j < prec; j++)
+			foreign[40 + i * prec + j] = bytes[prec - 1 - j];
+	}
+
+	___WHEN___
+	C(ts_bspline_parse_binary(foreign, 40 + num_values * prec,
+		&parse, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 5, (int) ts_bspline_degree(&parse));
+	CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&parse));
+	CuAssertIntEquals(tc, 6, (int) ts_bspline_num_control_points(&parse));
+	C(ts_bspline_control_points(&parse, &ctrlp, &status))
+	C(ts_bspline_knots(&parse, &knots, &status))
+	for (i = 0; i < 12; i++)
+		CuAssertDblEquals(tc, values[i], ctrlp[i], POINT_EPSILON);
+	for (i = 0; i < 12; i++)
+		CuAssertDblEquals(tc, values[12 + i], knots[i], TS_KNOT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&parse);
+	free(binary);
+	free(ctrlp);
+	free(knots);
+}
+
+void save_load_binary_invalid(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline parse = ts_bspline_init();
+	unsigned char *binary = NULL;
+	tsReal *knots;
+	size_t size;
+
+	___GIVEN___
+	C(ts_bspline_new(7, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_to_binary(&spline, &binary, &size, &status))
+
+	___WHEN___ ___THEN___
+	/* Too short. */
+	CuAssertIntEquals(tc, TS_PARSE_ERROR,
+		ts_bspline_parse_binary(binary, 39, &parse, NULL));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR,
+		ts_bspline_parse_binary(binary, size - 1, &parse, NULL));
+	CuAssertPtrEquals(tc, NULL, parse.pImpl);
+
+	/* Unsupported version. */
+	binary[4] = 2;
+	CuAssertIntEquals(tc, TS_PARSE_ERROR,
+		ts_bspline_parse_binary(binary, size, &parse, NULL));
+	binary[4] = 1;
+
+	/* Unexpected number of knots. */
+	binary[32]--;
+	CuAssertIntEquals(tc, TS_NUM_KNOTS,
+		ts_bspline_parse_binary(binary, size, &parse, NULL));
+	binary[32]++;
+
+	/* Decreasing knots. */
+	knots = (tsReal *) (binary + 40 + 21 * sizeof(tsReal));
+	knots[5] = (tsReal) -1.0;
+	CuAssertIntEquals(tc, TS_KNOTS_DECR,
+		ts_bspline_parse_binary(binary, size, &parse, NULL));
+	CuAssertPtrEquals(tc, NULL, parse.pImpl);
+
+	/* Invalid magic number. */
+	binary[0] = 'J';
+	CuAssertIntEquals(tc, TS_PARSE_ERROR,
+		ts_bspline_parse_binary(binary, size, &parse, NULL));
+
+	/* Missing file. */
+	CuAssertIntEquals(tc, TS_IO_ERROR, ts_bspline_load_binary(
+		"save_load_missing_file.bin", &parse, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&parse);
+	free(binary);
+}
+
+void save_load_write_json_compact(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	char buf[128];
+	size_t len;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		2, 1, 1, TS_CLAMPED, &spline, &status,
+		0.1, -2.0))
+
+	___WHEN___
+	C(ts_bspline_write_json_buffer(&spline, buf, sizeof(buf), 0, &len,
+		&status))
+
+	___THEN___
+	CuAssertStrEquals(tc, "{\"degree\":1,\"dimension\":1,"
+		"\"control_points\":[0.1,-2],\"knots\":[0,0,1,1]}", buf);
+	CuAssertIntEquals(tc, (int) strlen(buf), (int) len);
+
+	___WHEN___
+	/* Truncated output. */
+	C(ts_bspline_write_json_buffer(&spline, buf, 11, 0, &len, &status))
+
+	___THEN___
+	CuAssertStrEquals(tc, "{\"degree\":", buf);
+	CuAssertIntEquals(tc, 70, (int) len);
+
+	___WHEN___
+	/* Query the length only. */
+	C(ts_bspline_write_json_buffer(&spline, NULL, 0, 1, &len, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 159, (int) len);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void save_load_write_json_shortest(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	/* Smallest positive subnormal tsReal. */
+	const tsReal sub = sizeof(tsReal) == sizeof(float)
+		? (tsReal) FLT_MIN * (tsReal) FLT_EPSILON
+		: (tsReal) DBL_MIN * (tsReal) DBL_EPSILON;
+	const char *expected = sizeof(tsReal) == sizeof(float)
+		? "\"control_points\":[0.1,14410,0.33333334,1e-45,4e-45]"
+		: "\"control_points\":[0.1,14410,0.3333333333333333,5e-324,"
+			"1.5e-323]";
+	tsReal ctrlp[5];
+	char buf[256];
+	size_t len;
+
+	___GIVEN___
+	ctrlp[0] = (tsReal) 0.1;
+	ctrlp[1] = (tsReal) 14410;
+	ctrlp[2] = (tsReal) 1 / (tsReal) 3;
+	ctrlp[3] = sub;
+	ctrlp[4] = sub * 3;
+	C(ts_bspline_new(5, 1, 0, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_bspline_write_json_buffer(&spline, buf, sizeof(buf), 0, &len,
+		&status))
+
+	___THEN___
+	CuAssertPtrNotNull(tc, strstr(buf, expected));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void save_load_write_json_notation(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal ctrlp[6];
+	char buf[256];
+	size_t len;
+
+	___GIVEN___
+	ctrlp[0] = (tsReal) 1e-5;
+	ctrlp[1] = (tsReal) -0.00042;
+	ctrlp[2] = (tsReal) 1234.5;
+	ctrlp[3] = (tsReal) 1e20;
+	/* The shortest digits of 1e23 (double) cannot be found with Grisu3. */
+	ctrlp[4] = (tsReal) 1e23;
+	ctrlp[5] = (tsReal) -1e30;
+	C(ts_bspline_new(6, 1, 0, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_bspline_write_json_buffer(&spline, buf, sizeof(buf), 0, &len,
+		&status))
+
+	___THEN___
+	/* Like %g. */
+	CuAssertPtrNotNull(tc, strstr(buf, "\"control_points\":[1e-05,"
+		"-0.00042,1234.5,1e+20,1e+23,-1e+30]"));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void save_load_write_json_round_trip(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline compact = ts_bspline_init();
+	tsBSpline pretty = ts_bspline_init();
+	tsBSpline stream = ts_bspline_init();
+	tsReal *ctrlp = NULL, scale = 1;
+	char *json = NULL, *buf = NULL, *file = "save_load_write_test_file.json";
+	FILE *fp = NULL;
+	size_t i, len;
+	int eof;
+
+	___GIVEN___
+	C(ts_bspline_new(100, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < 300; i++) {
+		ctrlp[i] = (i % 2 ? -scale : scale) / (tsReal) (i + 3);
+		scale *= i < 150 ? (tsReal) 10 : (tsReal) 0.1;
+		if (i % 30 == 29)
+			scale = 1;
+	}
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+
+	___WHEN___
+	C(ts_bspline_write_json_buffer(&spline, NULL, 0, 0, &len, &status))
+	buf = (char *) malloc(len + 1);
+	CuAssertPtrNotNull(tc, buf);
+	C(ts_bspline_write_json_buffer(&spline, buf, len + 1, 0, &len,
+		&status))
+	C(ts_bspline_read_json(buf, &compact, NULL, &status))
+	C(ts_bspline_to_json(&spline, &json, &status))
+	C(ts_bspline_parse_json(json, &pretty, &status))
+	fp = fopen(file, "w");
+	CuAssertPtrNotNull(tc, fp);
+	C(ts_bspline_write_json(&spline, fp, 0, &status))
+	fclose(fp);
+	fp = fopen(file, "r");
+	CuAssertPtrNotNull(tc, fp);
+	C(ts_bspline_read_json_file(fp, &stream, &eof, &status))
+
+	___THEN___
+	assert_identical(tc, &spline, &compact);
+	assert_identical(tc, &spline, &pretty);
+	assert_identical(tc, &spline, &stream);
+	CuAssertIntEquals(tc, (int) strlen(buf), (int) len);
+	CuAssertPtrEquals(tc, NULL, strchr(buf, ' '));
+	CuAssertTrue(tc, strlen(json) > len);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&compact);
+	ts_bspline_free(&pretty);
+	ts_bspline_free(&stream);
+	free(ctrlp);
+	free(json);
+	free(buf);
+	if (fp)
+		fclose(fp);
+	remove(file);
+}
+
+void save_load_write_json_non_finite(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	char *json = NULL, buf[128];
+	size_t len;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		2, 1, 1, TS_CLAMPED, &spline, &status,
+		(tsReal) HUGE_VAL, 1.0))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_to_json(
+		&spline, &json, NULL));
+	CuAssertPtrEquals(tc, NULL, json);
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_write_json_buffer(
+		&spline, buf, sizeof(buf), 0, &len, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void save_load_read_json_equals_parse_json(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline parse = ts_bspline_init();
+	tsBSpline read = ts_bspline_init();
+	char *json = NULL;
+	const char *end;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		6, 2, 5, TS_OPENED, &spline, &status,
+		 100.0,    0.0,   /* P1 */
+		 200.0,  -10.7,   /* P2 */
+		 500.5,   40.0,   /* P3 */
+		-300.0, -260.0,   /* P4 */
+		-50.1,   200.0,   /* P5 */
+		-80.0,   130.24)) /* P6 */
+	C(ts_bspline_to_json(&spline, &json, &status))
+
+	___WHEN___
+	C(ts_bspline_parse_json(json, &parse, &status))
+	C(ts_bspline_read_json(json, &read, &end, &status))
+
+	___THEN___
+	assert_identical(tc, &parse, &read);
+	CuAssertTrue(tc, *end == '\0');
+	CuAssertTrue(tc, end[-1] == '}');
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&parse);
+	ts_bspline_free(&read);
+	free(json);
+}
+
+void save_load_read_json_any_order(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline expected = ts_bspline_init();
+	tsBSpline read = ts_bspline_init();
+	/* Knots first, unknown keys, and a trailing object. */
+	const char *json = "{ \"knots\": [0, 0, 0.5, 1, 1e0],\n"
+		"\"name\": {\"tags\": [\"a\\\"]\", true, null], \"x\": -1.5},"
+		"\"control_points\": [1, 2, 3, 4, 5, 6],"
+		" \"degree\": 1, \"dimension\": 2 }{\"degree\": 0}";
+	const char *end;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		3, 2, 1, TS_CLAMPED, &expected, &status,
+		1.0, 2.0, 3.0, 4.0, 5.0, 6.0))
+	C(ts_bspline_set_knots_varargs(&expected, &status,
+		0.0, 0.0, 0.5, 1.0, 1.0))
+
+	___WHEN___
+	C(ts_bspline_read_json(json, &read, &end, &status))
+
+	___THEN___
+	assert_identical(tc, &expected, &read);
+	CuAssertStrEquals(tc, "{\"degree\": 0}", end);
+
+	___TEARDOWN___
+	ts_bspline_free(&expected);
+	ts_bspline_free(&read);
+}
+
+void save_load_read_json_file_stream(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline read = ts_bspline_init();
+	char *json = NULL, *file = "save_load_stream_test_file.ndjson";
+	FILE *fp = NULL;
+	size_t i, num = 0;
+	int eof = 0;
+
+	___GIVEN___
+	fp = fopen(file, "w");
+	CuAssertPtrNotNull(tc, fp);
+	for (i = 0; i < 3; i++) {
+		C(ts_bspline_new(4 + i, 3, 2 + i, TS_CLAMPED, &spline,
+			&status))
+		C(ts_bspline_to_json(&spline, &json, &status))
+		fprintf(fp, "%s\n", json);
+		ts_bspline_free(&spline);
+		free(json);
+		json = NULL;
+	}
+	/* Compact objects. */
+	fprintf(fp, "{\"degree\":0,\"dimension\":1,\"control_points\":[7],"
+		"\"knots\":[0,1]}{\"degree\":0,\"dimension\":1,"
+		"\"control_points\":[8],\"knots\":[0,1]}\n\n");
+	fclose(fp);
+	fp = fopen(file, "r");
+	CuAssertPtrNotNull(tc, fp);
+
+	___WHEN___
+	for (;;) {
+		C(ts_bspline_read_json_file(fp, &read, &eof, &status))
+		if (eof)
+			break;
+		if (num < 3) {
+			CuAssertIntEquals(tc, (int) num + 2,
+				(int) ts_bspline_degree(&read));
+		} else {
+			CuAssertIntEquals(tc, 0,
+				(int) ts_bspline_degree(&read));
+		}
+		ts_bspline_free(&read);
+		num++;
+	}
+
+	___THEN___
+	CuAssertIntEquals(tc, 5, (int) num);
+	CuAssertPtrEquals(tc, NULL, read.pImpl);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&read);
+	free(json);
+	if (fp)
+		fclose(fp);
+	remove(file);
+}
+
+void save_load_read_json_invalid(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_read_json(
+		"{\"degree\": 1, \"dimension\": 1, \"control_points\": [1, 2]}",
+		&spline, NULL, NULL));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_read_json(
+		"{\"degree\": 1, \"dimension\": 1, \"knots\": [0, 0, 1, 1], "
+		"\"control_points\": [1, 2", &spline, NULL, NULL));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_read_json(
+		"{\"degree\": 1, \"dimension\": 2, \"knots\": [0, 0, 1, 1], "
+		"\"control_points\": [1, 2, 3]}", &spline, NULL, NULL));
+	CuAssertIntEquals(tc, TS_NUM_KNOTS, ts_bspline_read_json(
+		"{\"degree\": 1, \"dimension\": 1, \"knots\": [0, 0, 1], "
+		"\"control_points\": [1, 2]}", &spline, NULL, NULL));
+	CuAssertIntEquals(tc, TS_KNOTS_DECR, ts_bspline_read_json(
+		"{\"degree\": 1, \"dimension\": 1, \"knots\": [0, 0, 1, 0], "
+		"\"control_points\": [1, 2]}", &spline, NULL, NULL));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_read_json(
+		"[1, 2]", &spline, NULL, NULL));
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+/* Views require a 64-bit little endian machine (cf. ts_bspline_view_binary). */
+int views_supported()
+{
+	const unsigned int one = 1;
+	return sizeof(size_t) == 8 && *((const unsigned char *) &one) == 1;
+}
+
+void save_load_view_equals_parse(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline copy = ts_bspline_init();
+	tsBSplineView view;
+	const tsBSpline *viewed;
+	unsigned char *binary = NULL;
+	tsReal *ctrlp = NULL, u, p1[3], p2[3];
+	size_t size, i;
+
+	___GIVEN___
+	if (!views_supported())
+		return;
+	C(ts_bspline_new(9, 3, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	for (i = 0; i < 27; i++)
+		ctrlp[i] = (tsReal) ((i * 7) % 11) - 5;
+	C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+	C(ts_bspline_to_binary(&spline, &binary, &size, &status))
+
+	___WHEN___
+	C(ts_bspline_view_binary(binary, size, &view, &status))
+	viewed = ts_bspline_view_spline(&view);
+
+	___THEN___
+	/* Points into `binary`. */
+	CuAssertTrue(tc, (const unsigned char *) viewed->pImpl > binary);
+	CuAssertTrue(tc, (const unsigned char *) viewed->pImpl <
+		binary + size);
+	CuAssertIntEquals(tc, 3, (int) ts_bspline_degree(viewed));
+	CuAssertIntEquals(tc, 3, (int) ts_bspline_dimension(viewed));
+	CuAssertIntEquals(tc, 9, (int) ts_bspline_num_control_points(viewed));
+	for (i = 0; i <= 20; i++) {
+		u = (tsReal) i / 20;
+		C(ts_bspline_eval_point(&spline, u, p1, &status))
+		C(ts_bspline_eval_point(viewed, u, p2, &status))
+		CuAssertDblEquals(tc, 0, ts_distance(p1, p2, 3), 0);
+	}
+	/* A copy is a modifiable spline. */
+	C(ts_bspline_copy(viewed, &copy, &status))
+	C(ts_bspline_set_control_point_at(&copy, 0, p1, &status))
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&copy);
+	free(binary);
+	free(ctrlp);
+}
+
+void save_load_view_incompatible(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSplineView view;
+	unsigned char *binary = NULL, *shifted = NULL;
+	size_t size;
+
+	___GIVEN___
+	if (!views_supported())
+		return;
+	C(ts_bspline_new(7, 2, 3, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_to_binary(&spline, &binary, &size, &status))
+	shifted = (unsigned char *) malloc(size + 1);
+	CuAssertPtrNotNull(tc, shifted);
+	memcpy(shifted + 1, binary, size);
+
+	___WHEN___ ___THEN___
+	/* Misaligned. */
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_bspline_view_binary(shifted + 1, size, &view, NULL));
+	CuAssertPtrEquals(tc, NULL, view.spline.pImpl);
+
+	/* Foreign byte order. */
+	binary[6] = 2;
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_bspline_view_binary(binary, size, &view, NULL));
+	binary[6] = 1;
+
+	/* Decreasing knots. */
+	((tsReal *) (binary + 40))[14 + 5] = (tsReal) -1.0;
+	CuAssertIntEquals(tc, TS_KNOTS_DECR,
+		ts_bspline_view_binary(binary, size, &view, NULL));
+	CuAssertPtrEquals(tc, NULL, view.spline.pImpl);
+
+	/* Too short. */
+	CuAssertIntEquals(tc, TS_PARSE_ERROR,
+		ts_bspline_view_binary(binary, size - 1, &view, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(binary);
+	free(shifted);
+}
+
 CuSuite* get_save_load_suite()
 {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, save_load_load_equals_save);
+	SUITE_ADD_TEST(suite, save_load_binary_equals_save);
+	SUITE_ADD_TEST(suite, save_load_binary_foreign_format);
+	SUITE_ADD_TEST(suite, save_load_binary_invalid);
+	SUITE_ADD_TEST(suite, save_load_write_json_compact);
+	SUITE_ADD_TEST(suite, save_load_write_json_shortest);
+	SUITE_ADD_TEST(suite, save_load_write_json_notation);
+	SUITE_ADD_TEST(suite, save_load_write_json_round_trip);
+	SUITE_ADD_TEST(suite, save_load_write_json_non_finite);
+	SUITE_ADD_TEST(suite, save_load_read_json_equals_parse_json);
+	SUITE_ADD_TEST(suite, save_load_read_json_any_order);
+	SUITE_ADD_TEST(suite, save_load_read_json_file_stream);
+	SUITE_ADD_TEST(suite, save_load_read_json_invalid);
+	SUITE_ADD_TEST(suite, save_load_view_equals_parse);
+	SUITE_ADD_TEST(suite, save_load_view_incompatible);
 	return suite;
 }
\ No newline at end of file
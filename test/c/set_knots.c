@@ -159,6 +159,99 @@ void set_knots_exceeding_multiplicity(CuTest *tc)
 	free(result);
 }
 
+void set_knots_exceeding_interior_multiplicity(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal knots[8], *before = NULL, *after = NULL;
+	size_t i;
+	tsError err = TS_SUCCESS;
+
+	___GIVEN___
+	C(ts_bspline_new(5, 2, 2, TS_CLAMPED, &spline, &status))
+	C(ts_bspline_knots(&spline, &before, &status))
+	knots[0] = (tsReal) 0.0;
+	knots[1] = (tsReal) 0.0;
+	knots[2] = (tsReal) 0.0;
+	/* Four after a knot change, but order is only three. */
+	knots[3] = (tsReal) 0.5;
+	knots[4] = (tsReal) 0.5;
+	knots[5] = (tsReal) 0.5;
+	knots[6] = (tsReal) 0.5;
+	knots[7] = (tsReal) 1.0;
+
+	___WHEN___
+	err = ts_bspline_set_knots(&spline, knots, NULL);
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_MULTIPLICITY, err);
+	/* Check if knots changed. */
+	C(ts_bspline_knots(&spline, &after, &status))
+	for (i = 0; i < 8; i++)
+		CuAssertDblEquals(tc, before[i], after[i], TS_KNOT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	free(before);
+	free(after);
+}
+
+void set_knots_exceeding_last_multiplicity(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal knots[8];
+	tsError err = TS_SUCCESS;
+
+	___GIVEN___
+	C(ts_bspline_new(5, 2, 2, TS_CLAMPED, &spline, &status))
+	knots[0] = (tsReal) 0.0;
+	knots[1] = (tsReal) 0.0;
+	knots[2] = (tsReal) 0.0;
+	knots[3] = (tsReal) 0.5;
+	knots[4] = (tsReal) 1.0;
+	knots[5] = (tsReal) 1.0;
+	knots[6] = (tsReal) 1.0;
+	knots[7] = (tsReal) 1.0;
+
+	___WHEN___
+	err = ts_bspline_set_knots(&spline, knots, NULL);
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_MULTIPLICITY, err);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
+void set_knots_interior_multiplicity_of_order(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsReal knots[8], knot;
+
+	___GIVEN___
+	C(ts_bspline_new(5, 2, 2, TS_CLAMPED, &spline, &status))
+	knots[0] = (tsReal) 0.0;
+	knots[1] = (tsReal) 0.0;
+	knots[2] = (tsReal) 0.0;
+	knots[3] = (tsReal) 0.5;
+	knots[4] = (tsReal) 0.5;
+	knots[5] = (tsReal) 0.5;
+	knots[6] = (tsReal) 1.0;
+	knots[7] = (tsReal) 1.0;
+
+	___WHEN___
+	C(ts_bspline_set_knots(&spline, knots, &status))
+
+	___THEN___
+	C(ts_bspline_knot_at(&spline, 5, &knot, &status))
+	CuAssertDblEquals(tc, 0.5, knot, TS_KNOT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+}
+
 void set_knot_at(CuTest *tc)
 {
 	___SETUP___
@@ -284,6 +377,9 @@ CuSuite* get_set_knots_suite()
 	SUITE_ADD_TEST(suite, set_knots_custom_interval);
 	SUITE_ADD_TEST(suite, set_knots_decreasing_knot_vector);
 	SUITE_ADD_TEST(suite, set_knots_exceeding_multiplicity);
+	SUITE_ADD_TEST(suite, set_knots_exceeding_interior_multiplicity);
+	SUITE_ADD_TEST(suite, set_knots_exceeding_last_multiplicity);
+	SUITE_ADD_TEST(suite, set_knots_interior_multiplicity_of_order);
 	SUITE_ADD_TEST(suite, set_knot_at);
 	SUITE_ADD_TEST(suite, set_knot_at_invalid_index);
 	SUITE_ADD_TEST(suite, set_knot_at_decreasing_knot_vector);
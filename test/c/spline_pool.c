@@ -0,0 +1,245 @@
+#include <testutils.h>
+
+/* Creates `num` cubic splines with 7 control points in 3D whose control
+ * points depend on the index of the spline. If `opened` is set, every second
+ * spline has an opened instead of a clamped knot vector. */
+void create_splines(CuTest *tc, tsBSpline *splines, size_t num, int opened)
+{
+	___SETUP___
+	tsReal *ctrlp = NULL;
+	size_t i, j;
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	for (i = 0; i < num; i++) {
+		C(ts_bspline_new(7, 3, 3, opened && i % 2 ? TS_OPENED :
+			TS_CLAMPED, splines + i, &status))
+		C(ts_bspline_control_points(splines + i, &ctrlp, &status))
+		for (j = 0; j < 21; j++)
+			ctrlp[j] = (tsReal) ((i * 7 + j * 13) % 11) - 5;
+		C(ts_bspline_set_control_points(splines + i, ctrlp, &status))
+		free(ctrlp);
+		ctrlp = NULL;
+	}
+
+	___TEARDOWN___
+	free(ctrlp);
+}
+
+/* Evaluates `pool` at several knots (within the domain of opened and clamped
+ * knot vectors) and compares the resultant points with
+ * ts_bspline_eval_point on `splines`. */
+void assert_pool_equals_eval(CuTest *tc, const tsSplinePool *pool,
+	const tsBSpline *splines, size_t num)
+{
+	___SETUP___
+	tsReal points[20 * 3], point[3], u, dist;
+	size_t i, j;
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	for (i = 0; i <= 10; i++) {
+		u = (tsReal) 0.3 + (tsReal) 0.4 * (tsReal) i / 10;
+		C(ts_spline_pool_eval(pool, u, points, num * 3, &status))
+		for (j = 0; j < num; j++) {
+			C(ts_bspline_eval_point(splines + j, u, point,
+				&status))
+			dist = ts_distance(point, points + j * 3, 3);
+			CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+		}
+	}
+
+	___TEARDOWN___
+}
+
+void spline_pool_shared_knots(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[20];
+	tsSplinePool pool = ts_spline_pool_init();
+	size_t i;
+
+	___GIVEN___
+	for (i = 0; i < 20; i++)
+		splines[i] = ts_bspline_init();
+	create_splines(tc, splines, 20, 0);
+
+	___WHEN___
+	C(ts_spline_pool_new(splines, 20, &pool, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 20, (int) ts_spline_pool_num_splines(&pool));
+	CuAssertIntEquals(tc, 3, (int) ts_spline_pool_dimension(&pool));
+	CuAssertIntEquals(tc, 1, ts_spline_pool_shares_knots(&pool));
+	assert_pool_equals_eval(tc, &pool, splines, 20);
+
+	___TEARDOWN___
+	for (i = 0; i < 20; i++)
+		ts_bspline_free(splines + i);
+	ts_spline_pool_free(&pool);
+}
+
+void spline_pool_different_knots(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[20];
+	tsSplinePool pool = ts_spline_pool_init();
+	tsSplinePool copy = ts_spline_pool_init();
+	size_t i;
+
+	___GIVEN___
+	for (i = 0; i < 20; i++)
+		splines[i] = ts_bspline_init();
+	create_splines(tc, splines, 20, 1);
+
+	___WHEN___
+	C(ts_spline_pool_new(splines, 20, &pool, &status))
+	C(ts_spline_pool_copy(&pool, &copy, &status))
+	ts_spline_pool_free(&pool);
+
+	___THEN___
+	CuAssertIntEquals(tc, 0, ts_spline_pool_shares_knots(&copy));
+	assert_pool_equals_eval(tc, &copy, splines, 20);
+
+	___TEARDOWN___
+	for (i = 0; i < 20; i++)
+		ts_bspline_free(splines + i);
+	ts_spline_pool_free(&pool);
+	ts_spline_pool_free(&copy);
+}
+
+void spline_pool_get_set(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[4], expected_splines[3], spline = ts_bspline_init();
+	tsSplinePool pool = ts_spline_pool_init();
+	char *expected = NULL, *actual = NULL;
+	size_t i;
+
+	___GIVEN___
+	for (i = 0; i < 4; i++)
+		splines[i] = ts_bspline_init();
+	create_splines(tc, splines, 4, 1);
+	C(ts_spline_pool_new(splines, 3, &pool, &status))
+	CuAssertIntEquals(tc, 0, ts_spline_pool_shares_knots(&pool));
+
+	___WHEN___
+	/* Replaces the only spline with an opened knot vector. */
+	C(ts_spline_pool_set(&pool, 1, splines + 2, &status))
+	C(ts_spline_pool_get(&pool, 1, &spline, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 1, ts_spline_pool_shares_knots(&pool));
+	C(ts_bspline_to_json(splines + 2, &expected, &status))
+	C(ts_bspline_to_json(&spline, &actual, &status))
+	CuAssertStrEquals(tc, expected, actual);
+	expected_splines[0] = splines[0];
+	expected_splines[1] = splines[2];
+	expected_splines[2] = splines[2];
+	assert_pool_equals_eval(tc, &pool, expected_splines, 3);
+
+	___TEARDOWN___
+	for (i = 0; i < 4; i++)
+		ts_bspline_free(splines + i);
+	ts_bspline_free(&spline);
+	ts_spline_pool_free(&pool);
+	free(expected);
+	free(actual);
+}
+
+void spline_pool_sample(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[6];
+	tsSplinePool pool = ts_spline_pool_init();
+	tsReal points[6 * 25 * 3], *expected = NULL, dist;
+	size_t i, j, num;
+
+	___GIVEN___
+	for (i = 0; i < 6; i++)
+		splines[i] = ts_bspline_init();
+	create_splines(tc, splines, 6, 1);
+	C(ts_spline_pool_new(splines, 6, &pool, &status))
+
+	___WHEN___
+	C(ts_spline_pool_sample(&pool, 25, points, 6 * 25 * 3, &num,
+		&status))
+
+	___THEN___
+	CuAssertIntEquals(tc, 25, (int) num);
+	for (i = 0; i < 6; i++) {
+		C(ts_bspline_sample(splines + i, 25, &expected, &num, &status))
+		for (j = 0; j < 25; j++) {
+			dist = ts_distance(expected + j * 3,
+				points + (i * 25 + j) * 3, 3);
+			CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+		}
+		free(expected);
+		expected = NULL;
+	}
+
+	___TEARDOWN___
+	for (i = 0; i < 6; i++)
+		ts_bspline_free(splines + i);
+	ts_spline_pool_free(&pool);
+	free(expected);
+}
+
+void spline_pool_errors(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline splines[2], mixed[2], other = ts_bspline_init();
+	tsSplinePool pool = ts_spline_pool_init();
+	tsSplinePool invalid = ts_spline_pool_init();
+	tsReal points[6];
+	size_t num;
+
+	___GIVEN___
+	splines[0] = ts_bspline_init();
+	splines[1] = ts_bspline_init();
+	create_splines(tc, splines, 2, 0);
+	C(ts_spline_pool_new(splines, 2, &pool, &status))
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_spline_pool_new(splines, 0, &invalid, NULL));
+	CuAssertIntEquals(tc, TS_INDEX_ERROR,
+		ts_spline_pool_get(&pool, 2, &other, NULL));
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_spline_pool_eval(&pool, 0, points, 5, NULL));
+	CuAssertIntEquals(tc, TS_NUM_POINTS,
+		ts_spline_pool_sample(&pool, 2, points, 6, &num, NULL));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED,
+		ts_spline_pool_eval(&pool, 2, points, 6, NULL));
+
+	/* Different degree. */
+	C(ts_bspline_new(7, 3, 2, TS_CLAMPED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_spline_pool_set(&pool, 0, &other, NULL));
+	ts_bspline_free(&other);
+
+	/* Different number of control points. */
+	C(ts_bspline_new(8, 3, 3, TS_CLAMPED, &other, &status))
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_spline_pool_set(&pool, 0, &other, NULL));
+	mixed[0] = splines[0];
+	mixed[1] = other;
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE,
+		ts_spline_pool_new(mixed, 2, &invalid, NULL));
+
+	___TEARDOWN___
+	ts_bspline_free(splines);
+	ts_bspline_free(splines + 1);
+	ts_bspline_free(&other);
+	ts_spline_pool_free(&pool);
+	ts_spline_pool_free(&invalid);
+}
+
+CuSuite* get_spline_pool_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, spline_pool_shared_knots);
+	SUITE_ADD_TEST(suite, spline_pool_different_knots);
+	SUITE_ADD_TEST(suite, spline_pool_get_set);
+	SUITE_ADD_TEST(suite, spline_pool_sample);
+	SUITE_ADD_TEST(suite, spline_pool_errors);
+	return suite;
+}
@@ -0,0 +1,158 @@
+#include <testutils.h>
+
+struct stats_trace
+{
+	size_t begins, ends;
+	double time;
+};
+
+void stats_begin(void *data, const char *name)
+{
+	(void) name;
+	((struct stats_trace *) data)->begins++;
+}
+
+void stats_end(void *data, const char *name)
+{
+	(void) name;
+	((struct stats_trace *) data)->ends++;
+}
+
+double stats_clock(void *data)
+{
+	/* Each traced call takes exactly one second. */
+	return ((struct stats_trace *) data)->time += 1;
+}
+
+void stats_snapshot(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline derivative = ts_bspline_init();
+	tsBSpline parsed = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal us[3] = { 0.1f, 0.5f, 0.9f };
+	tsReal *points = NULL, *samples = NULL;
+	char *json = NULL;
+	tsStats stats;
+	tsStatsCounters *eval;
+	size_t i, num;
+
+	___GIVEN___
+	C(ts_bspline_new(20, 2, 3, TS_CLAMPED, &spline, &status))
+	ts_stats_reset();
+
+	___WHEN___
+	for (i = 0; i < 3; i++) {
+		C(ts_bspline_eval(&spline, us[i], &net, &status))
+		ts_deboornet_free(&net);
+	}
+	/* Calls ts_bspline_eval_all_into internally. */
+	C(ts_bspline_eval_all(&spline, us, 3, &points, &status))
+	C(ts_bspline_sample(&spline, 10, &samples, &num, &status))
+	C(ts_bspline_derive(&spline, 1, POINT_EPSILON, &derivative, &status))
+	C(ts_bspline_to_json(&spline, &json, &status))
+	C(ts_bspline_parse_json(json, &parsed, &status))
+	ts_stats_snapshot(&stats);
+
+	___THEN___
+	eval = stats.functions + TS_STATS_EVAL;
+	if (ts_stats_enabled()) {
+		CuAssertIntEquals(tc, 4, (int) eval->calls);
+		CuAssertTrue(tc, eval->bytes > 0);
+		CuAssertTrue(tc, eval->knot_searches > 0);
+		CuAssertTrue(tc, eval->seconds >= 0);
+		CuAssertIntEquals(tc, 1, (int)
+			stats.functions[TS_STATS_SAMPLE].calls);
+		CuAssertIntEquals(tc, 1, (int)
+			stats.functions[TS_STATS_DERIVE].calls);
+		CuAssertIntEquals(tc, 1, (int)
+			stats.functions[TS_STATS_JSON_WRITE].calls);
+		CuAssertIntEquals(tc, 1, (int)
+			stats.functions[TS_STATS_JSON_READ].calls);
+		CuAssertIntEquals(tc, 0, (int)
+			stats.functions[TS_STATS_BISECT].calls);
+		CuAssertTrue(tc, stats.bytes >= eval->bytes);
+		CuAssertTrue(tc, stats.allocations > 0);
+		CuAssertTrue(tc, stats.knot_searches >= eval->knot_searches);
+	} else {
+		CuAssertIntEquals(tc, 0, (int) eval->calls);
+		CuAssertIntEquals(tc, 0, (int) stats.bytes);
+		CuAssertIntEquals(tc, 0, (int) stats.allocations);
+	}
+
+	___WHEN___
+	ts_stats_reset();
+	ts_stats_snapshot(&stats);
+
+	___THEN___
+	CuAssertIntEquals(tc, 0, (int) stats.functions[TS_STATS_EVAL].calls);
+	CuAssertIntEquals(tc, 0, (int) stats.bytes);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&derivative);
+	ts_bspline_free(&parsed);
+	ts_deboornet_free(&net);
+	free(points);
+	free(samples);
+	free(json);
+}
+
+void stats_hooks(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	struct stats_trace trace;
+	tsStatsHooks hooks;
+	tsStats stats;
+	tsReal *points = NULL;
+	tsReal us[2] = { 0.25f, 0.75f };
+
+	___GIVEN___
+	C(ts_bspline_new(7, 3, 2, TS_OPENED, &spline, &status))
+	trace.begins = trace.ends = 0;
+	trace.time = 0;
+	hooks.begin = stats_begin;
+	hooks.end = stats_end;
+	hooks.clock = stats_clock;
+	hooks.data = &trace;
+	ts_stats_reset();
+	ts_set_stats_hooks(&hooks);
+
+	___WHEN___
+	C(ts_bspline_eval(&spline, 0.5f, &net, &status))
+	C(ts_bspline_eval_all(&spline, us, 2, &points, &status))
+	ts_set_stats_hooks(NULL);
+	C(ts_bspline_eval_into(&spline, 0.5f, &net, &status))
+	ts_stats_snapshot(&stats);
+
+	___THEN___
+	if (ts_stats_enabled()) {
+		/* Nested calls are not traced. */
+		CuAssertIntEquals(tc, 2, (int) trace.begins);
+		CuAssertIntEquals(tc, 2, (int) trace.ends);
+		CuAssertIntEquals(tc, 3, (int)
+			stats.functions[TS_STATS_EVAL].calls);
+		/* The last call is timed with the default clock. */
+		CuAssertTrue(tc, stats.functions[TS_STATS_EVAL].seconds >= 2);
+	} else {
+		CuAssertIntEquals(tc, 0, (int) trace.begins);
+		CuAssertIntEquals(tc, 0, (int) trace.ends);
+	}
+
+	___TEARDOWN___
+	ts_set_stats_hooks(NULL);
+	ts_bspline_free(&spline);
+	ts_deboornet_free(&net);
+	free(points);
+}
+
+CuSuite* get_stats_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, stats_snapshot);
+	SUITE_ADD_TEST(suite, stats_hooks);
+	return suite;
+}
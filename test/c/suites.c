@@ -0,0 +1,78 @@
+#include <testutils.h>
+
+CuSuite* get_arr_fill_suite();
+CuSuite* get_free_suite();
+CuSuite* get_new_suite();
+CuSuite* get_move_suite();
+CuSuite* get_eval_suite();
+CuSuite* get_set_knots_suite();
+CuSuite* get_insert_knot_suite();
+CuSuite* get_remove_knots_suite();
+CuSuite* get_tension_suite();
+CuSuite* get_sample_suite();
+CuSuite* get_sampling_plan_suite();
+CuSuite* get_spline_pool_suite();
+CuSuite* get_to_beziers_suite();
+CuSuite* get_interpolation_suite();
+CuSuite* get_approximate_suite();
+CuSuite* get_derive_suite();
+CuSuite* get_bisect_suite();
+CuSuite* get_monotone_index_suite();
+CuSuite* get_project_suite();
+CuSuite* get_arc_length_suite();
+CuSuite* get_catmull_rom_fitter_suite();
+CuSuite* get_save_load_suite();
+CuSuite* get_archive_suite();
+CuSuite* get_elevate_degree_suite();
+CuSuite* get_align_suite();
+CuSuite* get_morph_suite();
+CuSuite* get_map_suite();
+CuSuite* get_stats_suite();
+CuSuite* get_gpu_suite();
+CuSuite* get_surface_suite();
+CuSuite* get_rational_suite();
+CuSuite* get_compiled_suite();
+CuSuite* get_allocator_suite();
+
+/* Returns a suite containing the tests of all suites above. Shared by the
+ * test runner (tests.c) and the benchmark suite timing the tests
+ * (bench/benchtests.c). */
+CuSuite* get_all_suites()
+{
+	CuSuite* suite = CuSuiteNew();
+
+	CuSuiteAddSuite(suite, get_arr_fill_suite());
+	CuSuiteAddSuite(suite, get_free_suite());
+	CuSuiteAddSuite(suite, get_new_suite());
+	CuSuiteAddSuite(suite, get_move_suite());
+	CuSuiteAddSuite(suite, get_eval_suite());
+	CuSuiteAddSuite(suite, get_set_knots_suite());
+	CuSuiteAddSuite(suite, get_insert_knot_suite());
+	CuSuiteAddSuite(suite, get_remove_knots_suite());
+	CuSuiteAddSuite(suite, get_tension_suite());
+	CuSuiteAddSuite(suite, get_sample_suite());
+	CuSuiteAddSuite(suite, get_sampling_plan_suite());
+	CuSuiteAddSuite(suite, get_spline_pool_suite());
+	CuSuiteAddSuite(suite, get_to_beziers_suite());
+	CuSuiteAddSuite(suite, get_interpolation_suite());
+	CuSuiteAddSuite(suite, get_approximate_suite());
+	CuSuiteAddSuite(suite, get_derive_suite());
+	CuSuiteAddSuite(suite, get_bisect_suite());
+	CuSuiteAddSuite(suite, get_monotone_index_suite());
+	CuSuiteAddSuite(suite, get_project_suite());
+	CuSuiteAddSuite(suite, get_arc_length_suite());
+	CuSuiteAddSuite(suite, get_catmull_rom_fitter_suite());
+	CuSuiteAddSuite(suite, get_save_load_suite());
+	CuSuiteAddSuite(suite, get_archive_suite());
+	CuSuiteAddSuite(suite, get_elevate_degree_suite());
+	CuSuiteAddSuite(suite, get_align_suite());
+	CuSuiteAddSuite(suite, get_morph_suite());
+	CuSuiteAddSuite(suite, get_map_suite());
+	CuSuiteAddSuite(suite, get_stats_suite());
+	CuSuiteAddSuite(suite, get_gpu_suite());
+	CuSuiteAddSuite(suite, get_surface_suite());
+	CuSuiteAddSuite(suite, get_rational_suite());
+	CuSuiteAddSuite(suite, get_compiled_suite());
+	CuSuiteAddSuite(suite, get_allocator_suite());
+	return suite;
+}
@@ -0,0 +1,226 @@
+#include <testutils.h>
+
+/* Creates a surface with 6 x 5 control points in 3D whose control points
+ * depend on their index. The knot vector of direction u is clamped, the one
+ * of direction v is opened. */
+void create_surface(CuTest *tc, tsBSplineSurface *surface)
+{
+	___SETUP___
+	tsReal ctrlp[6 * 5 * 3];
+	size_t i;
+
+	___GIVEN___ ___WHEN___ ___THEN___
+	C(ts_bspline_surface_new(6, 5, 3, 3, 2, TS_CLAMPED, TS_OPENED,
+		surface, &status))
+	for (i = 0; i < 6 * 5 * 3; i++)
+		ctrlp[i] = (tsReal) ((i * 7 + 3) % 11) - 5;
+	C(ts_bspline_surface_set_control_points(surface, ctrlp, &status))
+
+	___TEARDOWN___
+}
+
+/* Evaluates `surface` at (u, v) by evaluating each row of control points at
+ * v and the resultant curve at u. */
+void eval_nested(CuTest *tc, const tsBSplineSurface *surface, tsReal u,
+	tsReal v, tsReal *point)
+{
+	___SETUP___
+	const size_t n_u = ts_bspline_surface_num_control_points_u(surface);
+	const size_t n_v = ts_bspline_surface_num_control_points_v(surface);
+	const size_t dim = ts_bspline_surface_dimension(surface);
+	const tsReal *ctrlp = ts_bspline_surface_control_points_ptr(surface);
+	tsBSpline row = ts_bspline_init(), column = ts_bspline_init();
+	tsReal points[16 * 3];
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new(n_v, dim, ts_bspline_surface_degree_v(surface),
+		TS_OPENED, &row, &status))
+	C(ts_bspline_set_knots(&row, ts_bspline_surface_knots_v_ptr(surface),
+		&status))
+	C(ts_bspline_new(n_u, dim, ts_bspline_surface_degree_u(surface),
+		TS_OPENED, &column, &status))
+	C(ts_bspline_set_knots(&column,
+		ts_bspline_surface_knots_u_ptr(surface), &status))
+
+	___WHEN___
+	for (i = 0; i < n_u; i++) {
+		C(ts_bspline_set_control_points(&row, ctrlp + i * n_v * dim,
+			&status))
+		C(ts_bspline_eval_point(&row, v, points + i * dim, &status))
+	}
+	C(ts_bspline_set_control_points(&column, points, &status))
+	C(ts_bspline_eval_point(&column, u, point, &status))
+
+	___THEN___
+	___TEARDOWN___
+	ts_bspline_free(&row);
+	ts_bspline_free(&column);
+}
+
+void surface_eval_grid_equals_nested(CuTest *tc)
+{
+	___SETUP___
+	tsBSplineSurface surface = ts_bspline_surface_init();
+	tsReal us[9], vs[7], points[9 * 7 * 3], point[3], expected[3], dist;
+	tsReal min_u, max_u, min_v, max_v;
+	size_t i, j;
+
+	___GIVEN___
+	create_surface(tc, &surface);
+	ts_bspline_surface_domain(&surface, &min_u, &max_u, &min_v, &max_v);
+	CuAssertDblEquals(tc, 0, min_u, POINT_EPSILON);
+	CuAssertDblEquals(tc, 1, max_u, POINT_EPSILON);
+	for (i = 0; i < 9; i++)
+		us[i] = min_u + (max_u - min_u) * (tsReal) i / 8;
+	/* Unsorted, including the domain boundaries and knots. */
+	for (j = 0; j < 7; j++)
+		vs[j] = min_v + (max_v - min_v) * (tsReal) ((j * 5) % 7) / 6;
+
+	___WHEN___
+	C(ts_bspline_surface_eval_grid(&surface, us, 9, vs, 7, points,
+		9 * 7 * 3, &status))
+
+	___THEN___
+	for (i = 0; i < 9; i++) {
+		for (j = 0; j < 7; j++) {
+			eval_nested(tc, &surface, us[i], vs[j], expected);
+			dist = ts_distance(expected,
+				points + (i * 7 + j) * 3, 3);
+			CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+			C(ts_bspline_surface_eval(&surface, us[i], vs[j],
+				point, &status))
+			dist = ts_distance(expected, point, 3);
+			CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+		}
+	}
+
+	___TEARDOWN___
+	ts_bspline_surface_free(&surface);
+}
+
+void surface_bilinear(CuTest *tc)
+{
+	___SETUP___
+	tsBSplineSurface surface = ts_bspline_surface_init();
+	tsReal ctrlp[4] = { 0, 1, 2, 4 }, us[2], vs[3], points[6];
+
+	___GIVEN___
+	C(ts_bspline_surface_new(2, 2, 1, 1, 1, TS_CLAMPED, TS_CLAMPED,
+		&surface, &status))
+	C(ts_bspline_surface_set_control_points(&surface, ctrlp, &status))
+	us[0] = (tsReal) 0.0;
+	us[1] = (tsReal) 0.5;
+	vs[0] = (tsReal) 0.0;
+	vs[1] = (tsReal) 0.25;
+	vs[2] = (tsReal) 1.0;
+
+	___WHEN___
+	C(ts_bspline_surface_eval_grid(&surface, us, 2, vs, 3, points, 6,
+		&status))
+
+	___THEN___
+	CuAssertDblEquals(tc, 0.0, points[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0.25, points[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1.0, points[2], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1.0, points[3], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1.375, points[4], POINT_EPSILON);
+	CuAssertDblEquals(tc, 2.5, points[5], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_surface_free(&surface);
+}
+
+void surface_copy_set_knots(CuTest *tc)
+{
+	___SETUP___
+	tsBSplineSurface surface = ts_bspline_surface_init();
+	tsBSplineSurface copy = ts_bspline_surface_init();
+	tsStatus actual;
+	tsReal knots_u[10], knots_v[8], point[3], expected[3], dist;
+	size_t i;
+
+	___GIVEN___
+	create_surface(tc, &surface);
+	C(ts_bspline_surface_copy(&surface, &copy, &status))
+	/* Non-uniform knots with a double knot in direction u. */
+	for (i = 0; i < 10; i++)
+		knots_u[i] = i < 4 ? 0 : i > 5 ? 1 : (tsReal) 0.4;
+	for (i = 0; i < 8; i++)
+		knots_v[i] = (tsReal) (i * i);
+
+	___WHEN___
+	C(ts_bspline_surface_set_knots(&copy, knots_u, knots_v, &status))
+
+	___THEN___
+	for (i = 0; i < 10; i++) {
+		CuAssertDblEquals(tc, knots_u[i],
+			ts_bspline_surface_knots_u_ptr(&copy)[i], 0);
+	}
+	CuAssertDblEquals(tc, 1.0 / 3.0,
+		ts_bspline_surface_knots_u_ptr(&surface)[4], POINT_EPSILON);
+	C(ts_bspline_surface_eval(&copy, (tsReal) 0.4, (tsReal) 12.5, point,
+		&status))
+	eval_nested(tc, &copy, (tsReal) 0.4, (tsReal) 12.5, expected);
+	dist = ts_distance(expected, point, 3);
+	CuAssertDblEquals(tc, 0, dist, POINT_EPSILON);
+
+	/* Invalid knots do not modify the surface, not even the knots of the
+	 * other direction. */
+	knots_u[0] = 2;
+	knots_v[0] = -1;
+	CuAssertIntEquals(tc, TS_KNOTS_DECR, ts_bspline_surface_set_knots(
+		&surface, knots_u, NULL, NULL));
+	CuAssertIntEquals(tc, TS_KNOTS_DECR, ts_bspline_surface_set_knots(
+		&copy, knots_u, knots_v, &actual));
+	CuAssertIntEquals(tc, TS_KNOTS_DECR, actual.code);
+	CuAssertDblEquals(tc, 0,
+		ts_bspline_surface_knots_u_ptr(&copy)[0], 0);
+	CuAssertDblEquals(tc, 0,
+		ts_bspline_surface_knots_v_ptr(&copy)[0], 0);
+
+	___TEARDOWN___
+	ts_bspline_surface_free(&surface);
+	ts_bspline_surface_free(&copy);
+}
+
+void surface_errors(CuTest *tc)
+{
+	___SETUP___
+	tsBSplineSurface surface = ts_bspline_surface_init();
+	tsStatus actual;
+	tsReal us[2] = { 0, 2 }, points[12];
+
+	___GIVEN___
+	create_surface(tc, &surface);
+
+	___WHEN___ ___THEN___
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_surface_eval_grid(
+		&surface, us, 2, us, 2, points, 11, NULL));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_surface_eval_grid(
+		&surface, us, 2, us, 1, points, 12, &actual));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, actual.code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_surface_eval(
+		&surface, 0, 2, points, NULL));
+	ts_bspline_surface_free(&surface);
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bspline_surface_new(3, 3, 0, 1,
+		1, TS_CLAMPED, TS_CLAMPED, &surface, NULL));
+	CuAssertIntEquals(tc, TS_DEG_GE_NCTRLP, ts_bspline_surface_new(3, 3,
+		2, 1, 3, TS_CLAMPED, TS_CLAMPED, &surface, &actual));
+	CuAssertTrue(tc, surface.pImpl == NULL);
+	CuAssertIntEquals(tc, TS_NUM_KNOTS, ts_bspline_surface_new(3, 4, 2,
+		1, 2, TS_CLAMPED, TS_BEZIERS, &surface, NULL));
+
+	___TEARDOWN___
+	ts_bspline_surface_free(&surface);
+}
+
+CuSuite* get_surface_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, surface_eval_grid_equals_nested);
+	SUITE_ADD_TEST(suite, surface_bilinear);
+	SUITE_ADD_TEST(suite, surface_copy_set_knots);
+	SUITE_ADD_TEST(suite, surface_errors);
+	return suite;
+}
@@ -0,0 +1,78 @@
+#include <testutils.h>
+
+void tension_straightens_control_points(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		4, 2, 3, TS_CLAMPED, &spline, &status,
+		0.0, 0.0,  /* P1 */
+		1.0, 3.0,  /* P2 */
+		2.0, 3.0,  /* P3 */
+		3.0, 0.0)) /* P4 */
+
+	___WHEN___
+	C(ts_bspline_tension(&spline, (tsReal) 0.5, &result, &status))
+
+	___THEN___
+	C(ts_bspline_control_points(&result, &ctrlp, &status))
+	CuAssertDblEquals(tc, 0.0, ctrlp[0], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0.0, ctrlp[1], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1.0, ctrlp[2], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1.5, ctrlp[3], POINT_EPSILON);
+	CuAssertDblEquals(tc, 2.0, ctrlp[4], POINT_EPSILON);
+	CuAssertDblEquals(tc, 1.5, ctrlp[5], POINT_EPSILON);
+	CuAssertDblEquals(tc, 3.0, ctrlp[6], POINT_EPSILON);
+	CuAssertDblEquals(tc, 0.0, ctrlp[7], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&result);
+	free(ctrlp);
+}
+
+void tension_in_place(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal *ctrlp = NULL, *expected = NULL;
+	size_t i;
+
+	___GIVEN___
+	C(ts_bspline_new_with_control_points(
+		5, 3, 2, TS_CLAMPED, &spline, &status,
+		 1.0, 2.0, -1.0,  /* P1 */
+		 2.0, 0.5,  4.0,  /* P2 */
+		-3.0, 1.0,  2.0,  /* P3 */
+		 0.5, 6.0, -2.0,  /* P4 */
+		 4.0, 3.0,  1.0)) /* P5 */
+	C(ts_bspline_tension(&spline, (tsReal) 0.25, &result, &status))
+
+	___WHEN___
+	C(ts_bspline_tension(&spline, (tsReal) 0.25, &spline, &status))
+
+	___THEN___
+	C(ts_bspline_control_points(&spline, &ctrlp, &status))
+	C(ts_bspline_control_points(&result, &expected, &status))
+	for (i = 0; i < ts_bspline_len_control_points(&spline); i++)
+		CuAssertDblEquals(tc, expected[i], ctrlp[i], POINT_EPSILON);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&result);
+	free(ctrlp);
+	free(expected);
+}
+
+CuSuite* get_tension_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, tension_straightens_control_points);
+	SUITE_ADD_TEST(suite, tension_in_place);
+	return suite;
+}
@@ -200,11 +200,112 @@ void to_beziers_opened(CuTest *tc)
 	free(knots);
 }
 
+/* Compares the segments with the control points and knots of a
+ * decomposition. */
+struct to_beziers_stream_sink {
+	CuTest *tc;
+	const tsBSpline *beziers;
+	size_t num;
+};
+
+tsError to_beziers_stream_compare(void *data, size_t index, tsReal min,
+	tsReal max, const tsReal *ctrlp, tsStatus *status)
+{
+	struct to_beziers_stream_sink *sink =
+		(struct to_beziers_stream_sink *) data;
+	const size_t order = ts_bspline_order(sink->beziers);
+	const size_t len = order * ts_bspline_dimension(sink->beziers);
+	const tsReal *expected = ts_bspline_control_points_ptr(sink->beziers)
+		+ index * len;
+	const tsReal *knots = ts_bspline_knots_ptr(sink->beziers);
+	size_t i;
+	(void) status;
+	CuAssertIntEquals(sink->tc, (int) sink->num, (int) index);
+	CuAssertDblEquals(sink->tc, knots[index * order], min,
+		TS_KNOT_EPSILON);
+	CuAssertDblEquals(sink->tc, knots[(index + 1) * order], max,
+		TS_KNOT_EPSILON);
+	for (i = 0; i < len; i++)
+		CuAssertDblEquals(sink->tc, expected[i], ctrlp[i], 1e-3);
+	sink->num++;
+	return TS_SUCCESS;
+}
+
+tsError to_beziers_stream_stop(void *data, size_t index, tsReal min,
+	tsReal max, const tsReal *ctrlp, tsStatus *status)
+{
+	(void) min;
+	(void) max;
+	(void) ctrlp;
+	*((size_t *) data) = index;
+	if (index == 2)
+		TS_RETURN_0(status, TS_NO_RESULT, "stop")
+	return TS_SUCCESS;
+}
+
+void to_beziers_stream(CuTest *tc)
+{
+	___SETUP___
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	struct to_beziers_stream_sink sink;
+	tsReal *ctrlp = NULL;
+	size_t i, deg, last = 0;
+
+	___GIVEN___
+	for (deg = 0; deg <= 4; deg++) {
+		C(ts_bspline_new(12, 3, deg, deg % 2 ? TS_OPENED : TS_CLAMPED,
+			&spline, &status))
+		C(ts_bspline_control_points(&spline, &ctrlp, &status))
+		for (i = 0; i < 36; i++)
+			ctrlp[i] = (tsReal) ((i * 37) % 11) * 10;
+		C(ts_bspline_set_control_points(&spline, ctrlp, &status))
+		free(ctrlp);
+		ctrlp = NULL;
+		C(ts_bspline_to_beziers(&spline, &beziers, &status))
+
+		___WHEN___
+		sink.tc = tc;
+		sink.beziers = &beziers;
+		sink.num = 0;
+		C(ts_bspline_to_beziers_stream(&spline,
+			to_beziers_stream_compare, &sink, &status))
+
+		___THEN___
+		CuAssertIntEquals(tc, (int) (ts_bspline_num_control_points(
+			&beziers) / (deg + 1)), (int) sink.num);
+		assert_equal_shape(tc, &spline, &beziers);
+
+		___WHEN___
+		/* In place. */
+		C(ts_bspline_to_beziers(&spline, &spline, &status))
+
+		___THEN___
+		assert_equal_shape(tc, &spline, &beziers);
+		ts_bspline_free(&spline);
+		ts_bspline_free(&beziers);
+	}
+
+	___WHEN___
+	C(ts_bspline_new(7, 2, 2, TS_CLAMPED, &spline, &status))
+
+	___THEN___
+	CuAssertIntEquals(tc, TS_NO_RESULT, ts_bspline_to_beziers_stream(
+		&spline, to_beziers_stream_stop, &last, NULL));
+	CuAssertIntEquals(tc, 2, (int) last);
+
+	___TEARDOWN___
+	ts_bspline_free(&spline);
+	ts_bspline_free(&beziers);
+	free(ctrlp);
+}
+
 CuSuite* get_to_beziers_suite()
 {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, to_beziers_issue143);
 	SUITE_ADD_TEST(suite, to_beziers_clamped);
 	SUITE_ADD_TEST(suite, to_beziers_opened);
+	SUITE_ADD_TEST(suite, to_beziers_stream);
 	return suite;
 }
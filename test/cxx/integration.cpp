@@ -1,9 +1,37 @@
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <utility>
 #include <testutils.h>
 #include <tinysplinecxx.h>
 
 using namespace tinyspline;
 
+#ifdef TINYSPLINECXX_PMR
+struct CountingResource : public std::pmr::memory_resource {
+	size_t allocated = 0;
+
+	void *do_allocate(size_t bytes, size_t alignment) override
+	{
+		allocated += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes,
+			alignment);
+	}
+
+	void do_deallocate(void *p, size_t bytes, size_t alignment) override
+	{
+		allocated -= bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource &other)
+		const noexcept override
+	{
+		return this == &other;
+	}
+};
+#endif
+
 void run()
 {
 	BSpline start(7);
@@ -38,6 +66,339 @@ void run()
 		assert(morph((tsReal) 0.314).result().size() == 2);
 		morph = BSpline(BSpline::parseJson(json));
 		assert(morph.sample(100).size() == 200);
+		std::vector<unsigned char> binary = morph.toBinary();
+		assert(BSpline::fromBinary(binary).toJson() == morph.toJson());
+		assert(BSpline::parseJson(morph.toCompactJson()).toJson() ==
+			morph.toJson());
+	}
+
+	BSpline frame;
+	morphism.evalInto((real) 0.5, frame);
+	assert(frame.toJson() == morphism((real) 0.5).toJson());
+	std::vector<real> ts(3);
+	ts[0] = 0; ts[1] = (real) 0.5; ts[2] = 1;
+	std::vector<BSpline> frames;
+	morphism.evalAllInto(ts, frames);
+	assert(frames.size() == 3);
+	assert(frames[1].toJson() == frame.toJson());
+	std::vector<BSpline> keyframes;
+	keyframes.push_back(start);
+	keyframes.push_back(end);
+	keyframes = BSpline::elevateToCommonDegree(keyframes);
+	assert(keyframes[0].degree() == end.degree());
+	assert(keyframes[1].degree() == end.degree());
+	assert(start.elevateDegree(1, TS_CONTROL_POINT_EPSILON, 1)
+		.numControlPoints() ==
+		start.elevateDegree(1).numControlPoints());
+	tsBSplineOpArgs args;
+	args.n = 0;
+	args.value = (real) 0.5;
+	args.epsilon = 0;
+	std::vector<BSpline> halves = BSpline::map(keyframes,
+		ts_bspline_op_split, &args);
+	assert(halves.size() == 2);
+	assert(halves[0].numControlPoints() >
+		keyframes[0].numControlPoints());
+	args.value = (real) 2;
+	std::vector<std::string> errors;
+	halves = BSpline::map(keyframes, ts_bspline_op_split, &args, &errors);
+	assert(errors.size() == 2 && !errors[0].empty());
+	assert(halves[1].numControlPoints() == 1);
+	Morphism copy = morphism;
+	assert(copy.eval((real) 0.5).toJson() == frame.toJson());
+	copy.update(start, end);
+	assert(copy.eval((real) 0.5).numControlPoints() ==
+		frame.numControlPoints());
+	BSpline shifted = start;
+	ctrlp = shifted.controlPoints();
+	for (size_t i = 0; i < ctrlp.size(); i++)
+		ctrlp[i] += 1;
+	shifted.setControlPoints(ctrlp);
+	copy.update(shifted, end);
+	assert(copy.eval(0).numControlPoints() == frame.numControlPoints());
+
+	std::vector<real> points;
+	assert(start.sampleInto(points, 100) == 100);
+	assert(points.size() == 200);
+	assert(start.sampleFast(100).size() == 200);
+	assert(start.sampleAdaptive(1).size() <
+		start.sampleAdaptive((real) 0.1).size());
+	std::vector<real> us(2);
+	us[0] = (real) 0.25; us[1] = (real) 0.5;
+	start.evalAllInto(us, points);
+	assert(points.size() == 4);
+	assert(points == start.evalAll(us));
+	/* Interprets the second component as weight. */
+	assert(start.evalRationalAll(us).size() == 2);
+	assert(start.evalRationalDerivsAll(us, 1).size() == 2 * 2);
+	assert(start.sampleRational(10).size() == 10);
+	CompiledSpline compiled(start);
+	assert(compiled.dimension() == 2);
+	assert(compiled.evalAll(us).size() == 4);
+	assert(compiled.sample(10).size() == 20);
+	CompiledSpline compiledCopy = compiled;
+	assert(compiledCopy.domain().max() == start.domain().max());
+	assert(compiledCopy.isUpToDate(start));
+	assert(!compiledCopy.isUpToDate(shifted));
+	assert(!compiledCopy.isUpToDate(end));
+	us.resize(1000);
+	for (size_t i = 0; i < us.size(); i++)
+		us[i] = (real) i / (us.size() - 1);
+	// Chunks of 64 knots match the lanes of the serial evaluation.
+	assert(start.evalAll(us, 64, 4) == start.evalAll(us));
+	assert(start.evalAll(us, 64) == start.evalAll(us));
+
+	us.resize(11);
+	for (size_t i = 0; i < us.size(); i++)
+		us[i] = (real) i / 10;
+	SamplingPlan plan(start, us);
+	assert(plan.numPoints() == 11);
+	plan.evalInto(start, points);
+	assert(points.size() == 22);
+	assert(plan.eval(start) == points);
+
+	remove("integration.tsa");
+	{
+		SplineArchive archive("integration.tsa");
+		archive.append(7, start);
+		archive.append(3, end);
+		assert(archive.numSplines() == 2);
+		assert(archive.idAt(0) == 3);
+	}
+	{
+		SplineArchive archive("integration.tsa");
+		assert(archive.numSplines() == 2);
+		assert(archive.load(7).toJson() == start.toJson());
+		assert(archive.loadAt(0).toJson() == end.toJson());
+	}
+	remove("integration.tsa");
+
+#ifdef TINYSPLINECXX_PMR
+	CountingResource resource;
+	{
+		MemoryResourceScope scope(resource);
+		BSpline beziers = start.derive().toBeziers();
+		assert(resource.allocated > 0);
+		assert(beziers.sample(10).size() == 20);
+	}
+	assert(resource.allocated == 0);
+#endif
+
+	RealView knots = start.knotsView();
+	assert(knots.size() == start.knots().size());
+	assert(knots.toVector() == start.knots());
+	assert(start.controlPointsView().toVector() == start.controlPoints());
+	DeBoorNet net = start((real) 0.5);
+	assert(net.resultView().toVector() == net.result());
+	assert(net.pointsView().size() == net.points().size());
+#ifdef TINYSPLINECXX_MOVE
+	BSpline moved = start;
+	const real *data = moved.controlPointsView().data();
+	BSpline target(std::move(moved));
+	assert(target.controlPointsView().data() == data);
+	moved = std::move(target);
+	assert(moved.controlPointsView().data() == data);
+	DeBoorNet movedNet(std::move(net));
+	assert(movedNet.resultView().toVector() == start((real) 0.5).result());
+#endif
+
+	BSpline refined = start;
+	refined.reserve(20);
+	assert(refined.capacity() == 20);
+	for (size_t i = 1; i <= 13; i++)
+		refined.insertKnotInPlace((real) i / 14, 1);
+	assert(refined.numControlPoints() == 20);
+	assert(refined.capacity() == 20);
+	std::vector<real> inserted(13);
+	for (size_t i = 0; i < inserted.size(); i++)
+		inserted[i] = (real) (i + 1) / 14;
+	BSpline refinedAll = start.refineKnots(inserted);
+	assert(refinedAll.numControlPoints() == 20);
+	for (size_t i = 0; i < refinedAll.knots().size(); i++) {
+		assert(std::fabs(refinedAll.knots()[i] - refined.knots()[i]) <=
+			TS_KNOT_EPSILON);
+	}
+	refinedAll = start;
+	refinedAll.refineKnotsInPlace(inserted);
+	assert(refinedAll.numControlPoints() == 20);
+	assert(refinedAll.removeKnots().numControlPoints() ==
+		start.numControlPoints());
+	refinedAll.removeKnotsInPlace();
+	assert(refinedAll.numControlPoints() == start.numControlPoints());
+	refined.deriveInPlace();
+	assert(refined.degree() == start.degree() - 1);
+	refined.shrinkToFit();
+	assert(refined.capacity() == refined.numControlPoints());
+	BSpline tensed = start;
+	tensed.tensionInPlace((real) 0.5);
+	assert(tensed.toJson() == start.tension((real) 0.5).toJson());
+
+	std::vector<BSpline> splines(3, start);
+	splines[1] = tensed;
+	SplinePool pool(splines);
+	assert(pool.numSplines() == 3);
+	assert(pool.sharesKnots());
+	pool.evalInto((real) 0.5, points);
+	assert(points.size() == 6);
+	assert(pool.splineAt(1).toJson() == tensed.toJson());
+	pool.setSplineAt(0, tensed);
+	assert(pool.splineAt(0).toJson() == tensed.toJson());
+	assert(SplinePool(end, 4).sample(10).size() == 4 * 10 * 2);
+
+	BSplineSurface surface(4, 3, 2, 2, 1);
+	ctrlp = surface.controlPoints();
+	assert(ctrlp.size() == 4 * 3 * 2);
+	for (size_t i = 0; i < ctrlp.size(); i++)
+		ctrlp[i] = (real) (i % 5);
+	surface.setControlPoints(ctrlp);
+	BSplineSurface surfaceCopy = surface;
+	std::vector<real> rows(2, (real) 0.25), columns(3, (real) 0.75);
+	std::vector<real> grid = surfaceCopy.evalGrid(rows, columns);
+	assert(grid.size() == 2 * 3 * 2);
+	assert(std::fabs(grid[4] - surface.eval(rows[1], columns[2])[0]) <
+		1e-5);
+	assert(surface.knotsU().size() == 4 + 2 + 1);
+	assert(surface.domainV().max() == (real) 1);
+
+	BSpline series(4);
+	ctrlp = series.controlPoints();
+	for (size_t i = 0; i < ctrlp.size(); i++)
+		ctrlp[i] = (real) (i % 2 ? i : i * 100);
+	series.setControlPoints(ctrlp);
+	std::vector<real> xs(3);
+	xs[0] = 50; xs[1] = 300; xs[2] = 550;
+	std::vector<real> solved = series.solveAll(xs, (real) 0.01);
+	assert(solved.size() == 3);
+	assert(std::fabs(series.solve(xs[1], (real) 0.01).result()[0] -
+		xs[1]) <= (real) 0.01);
+	assert(std::fabs(series(solved[2]).result()[0] - xs[2]) <=
+		(real) 0.01);
+
+	MonotoneIndex index(series);
+	MonotoneIndex indexCopy = index;
+	assert(indexCopy.solveAll(xs, (real) 0.01) == index.solveAll(xs,
+		(real) 0.01));
+	assert(std::fabs(series(index.solve(xs[0], (real) 0.01)).result()[0]
+		- xs[0]) <= (real) 0.01);
+
+	std::vector<real> derivs = start.evalDerivs((real) 0.3, 2);
+	assert(derivs.size() == 6);
+	std::vector<real> tangent = start.derive()((real) 0.3).result();
+	assert(std::fabs(derivs[2] - tangent[0]) <= (real) 0.01);
+	assert(std::fabs(derivs[3] - tangent[1]) <= (real) 0.01);
+	assert(start.evalDerivsAll(us, 1).size() == us.size() * 4);
+	BSpline cached = start;
+	std::vector<real> velocity = cached.evalDerivative((real) 0.3);
+	assert(velocity == cached.evalDerivative((real) 0.3));
+	assert(std::fabs(velocity[0] - tangent[0]) <= (real) 0.01);
+	BSpline tensedStart = start.tension((real) 0.5);
+	cached.setControlPoints(tensedStart.controlPoints());
+	velocity = cached.evalDerivative((real) 0.3, 2);
+	tangent = tensedStart.derive(2)((real) 0.3).result();
+	assert(std::fabs(velocity[0] - tangent[0]) <= (real) 0.01);
+	assert(std::fabs(velocity[1] - tangent[1]) <= (real) 0.01);
+
+	Projector projector(start);
+	std::vector<real> point = start((real) 0.3).result();
+	assert(std::fabs(projector.project(point) - (real) 0.3) <=
+		(real) 0.001);
+	assert(projector.closestPoint(point).size() == 2);
+	point.push_back(start((real) 0.8).result()[0]);
+	point.push_back(start((real) 0.8).result()[1]);
+	std::vector<real> projected = Projector(projector).projectAll(point);
+	assert(projected.size() == 2);
+	assert(std::fabs(projected[1] - (real) 0.8) <= (real) 0.001);
+
+	ArcLength arcLength(start);
+	assert(arcLength.length() > 0);
+	assert(arcLength.uAt(0) == start.domain().min());
+	assert(std::fabs(arcLength.uAt(arcLength.length()) -
+		start.domain().max()) <= (real) 0.001);
+	assert(arcLength.uAtAll(us).size() == us.size());
+	assert(ArcLength(arcLength).sample(10).size() == 20);
+	assert(arcLength.sample().size() % 2 == 0);
+
+	ctrlp = start.controlPoints();
+	CatmullRomFitter fitter(2);
+	std::vector<real> chunk(ctrlp.begin(), ctrlp.begin() + 6);
+	fitter.push(chunk);
+	assert(fitter.numFinished() == 1);
+	BSpline finished = fitter.take();
+	assert(finished.numControlPoints() == 4);
+	chunk.assign(ctrlp.begin() + 6, ctrlp.end());
+	CatmullRomFitter(fitter).push(chunk);
+	fitter.push(chunk);
+	assert(fitter.numPoints() == start.numControlPoints());
+	BSpline batch = BSpline::interpolateCatmullRom(ctrlp, 2);
+	assert(finished.numControlPoints() + fitter.spline().numControlPoints()
+		== batch.numControlPoints());
+
+	points = start.sample(100);
+	BSpline approximated = BSpline::approximate(points, 2, 10);
+	assert(approximated.numControlPoints() == 10);
+	assert(approximated(approximated.domain().min()).result()[0] ==
+		points[0]);
+	assert(BSpline::approximate(points, 2, 50, 3, 1).numControlPoints() <
+		50);
+
+	StaticBSpline<3, 2> fixed(start);
+	StaticBSpline<3, 2, float> fixedFloat(start);
+	std::vector<real> fixedPoints;
+	fixed.evalAllInto(us, fixedPoints);
+	assert(fixedPoints.size() == us.size() * 2);
+	for (size_t i = 0; i < us.size(); i++) {
+		std::vector<real> expected = start(us[i]).result();
+		real spanned[2];
+		evaluate<3, 2>(start, us[i], spanned);
+		std::vector<float> single = fixedFloat((float) us[i]);
+		for (size_t d = 0; d < 2; d++) {
+			assert(std::fabs(fixedPoints[i * 2 + d] - expected[d]) <=
+				(real) 1e-4);
+			assert(std::fabs(spanned[d] - expected[d]) <=
+				(real) 1e-4);
+			assert(std::fabs(single[d] - expected[d]) <= 1e-2);
+		}
+	}
+	try {
+		StaticBSpline<2, 2> wrong(start);
+		assert(false);
+	} catch (std::runtime_error &) {}
+
+	/* Near a C0 knot (multiplicity degree) and a discontinuous knot
+	 * (multiplicity order), StaticBSpline must snap u to the knot and
+	 * pick the segment like the C API. */
+	for (size_t mult = 2; mult <= 3; mult++) {
+		BSpline kinked(3 + mult, 2, 2);
+		std::vector<real> kinkedCtrlp(kinked.controlPoints());
+		for (size_t i = 0; i < kinkedCtrlp.size(); i++)
+			kinkedCtrlp[i] = (real) (i * i % 7);
+		kinked.setControlPoints(kinkedCtrlp);
+		std::vector<real> kinkedKnots(kinked.knots());
+		for (size_t i = 3; i < 3 + mult; i++)
+			kinkedKnots[i] = (real) 0.5;
+		kinked.setKnots(kinkedKnots);
+		StaticBSpline<2, 2> fixedKinked(kinked);
+		const real eps = (real) TS_KNOT_EPSILON / 2;
+		const real around[] = { (real) 0.5 - eps, (real) 0.5,
+			(real) 0.5 + eps, (real) 1 - eps };
+		for (size_t i = 0; i < 4; i++) {
+			std::vector<real> expected = kinked(around[i]).result();
+			std::vector<real> actual = fixedKinked(around[i]);
+			real spanned[2];
+			evaluate<2, 2>(kinked, around[i], spanned);
+			for (size_t d = 0; d < 2; d++) {
+				assert(std::fabs(actual[d] - expected[d]) <=
+					(real) 1e-4);
+				assert(std::fabs(spanned[d] - expected[d]) <=
+					(real) 1e-4);
+			}
+		}
+	}
+
+	Evaluator evaluator(start);
+	for (size_t i = 0; i <= 10; i++) {
+		real u = (real) i / 10;
+		assert(evaluator(u).result() == start(u).result());
 	}
 }
 
@@ -0,0 +1,105 @@
+// Smoke tests of the JavaScript binding. Checks the typed array views of
+// BSpline (controlPointsView, knotsView) and the raw pointer variants of
+// BSpline.evalAllInto and BSpline.sampleInto. Usage:
+//
+//     node tests.js <path to tinyspline.js>
+var assert = require('assert');
+var path = require('path');
+var Module = require(path.resolve(process.argv[2]));
+
+function assertPointsEqual(expected, actual) {
+	assert.strictEqual(actual.length, expected.length);
+	for (var i = 0; i < expected.length; i++)
+		assert.ok(Math.abs(expected[i] - actual[i]) < 1e-5,
+			`points differ at ${i}: ${expected[i]} != ${actual[i]}`);
+}
+
+function makeSpline() {
+	var spline = new Module.BSpline(7);
+	spline.controlPoints = [
+		-1.75, -1.0, -1.5, -0.5, -1.5, 0.0, -1.25, 0.5,
+		-0.75, 0.75, 0.0, 0.5, 0.5, 0.0
+	];
+	return spline;
+}
+
+// Module.HEAPF32 if the binding has been compiled with
+// TINYSPLINE_FLOAT_PRECISION. Must be queried after each call that may grow
+// the WASM memory.
+function heap(spline) {
+	return spline.knotsView() instanceof Float32Array
+		? Module.HEAPF32 : Module.HEAPF64;
+}
+
+var tests = {
+	viewsEqualProperties: function(spline) {
+		var view = spline.controlPointsView();
+		assertPointsEqual(spline.controlPoints, view);
+		view = spline.knotsView();
+		assertPointsEqual(spline.knots, view);
+	},
+
+	evalAllAcceptsTypedArray: function(spline) {
+		var us = [0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0];
+		assertPointsEqual(spline.evalAll(us),
+			spline.evalAll(new Float64Array(us)));
+	},
+
+	evalAllInto: function(spline) {
+		var us = [0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0];
+		var expected = spline.evalAll(us);
+		var bytes = heap(spline).BYTES_PER_ELEMENT;
+		var usPtr = Module._malloc(us.length * bytes);
+		var pointsPtr = Module._malloc(expected.length * bytes);
+		try {
+			heap(spline).set(us, usPtr / bytes);
+			spline.evalAllInto(usPtr, us.length,
+				pointsPtr, expected.length);
+			assertPointsEqual(expected, heap(spline).subarray(
+				pointsPtr / bytes,
+				pointsPtr / bytes + expected.length));
+		} finally {
+			Module._free(usPtr);
+			Module._free(pointsPtr);
+		}
+	},
+
+	sampleInto: function(spline) {
+		var expected = spline.sample(100);
+		var bytes = heap(spline).BYTES_PER_ELEMENT;
+		var pointsPtr = Module._malloc(expected.length * bytes);
+		try {
+			assert.strictEqual(spline.sampleInto(pointsPtr,
+				expected.length, 100), 100);
+			assertPointsEqual(expected, heap(spline).subarray(
+				pointsPtr / bytes,
+				pointsPtr / bytes + expected.length));
+		} finally {
+			Module._free(pointsPtr);
+		}
+	}
+};
+
+function run() {
+	var failed = 0;
+	for (var name in tests) {
+		var spline = makeSpline();
+		try {
+			tests[name](spline);
+			console.log(`${name}: passed`);
+		} catch (e) {
+			failed++;
+			console.log(`${name}: failed: ${e.stack || e}`);
+		} finally {
+			spline.delete();
+		}
+	}
+	process.exit(failed ? 1 : 0);
+}
+
+// The runtime is initialized asynchronously (the WASM module is compiled
+// after loading tinyspline.js).
+if (Module.BSpline)
+	run();
+else
+	Module.onRuntimeInitialized = run;
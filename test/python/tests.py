@@ -0,0 +1,95 @@
+# Smoke tests of the Python binding. Checks the buffer protocol typemaps of
+# src/swig/tinysplinepython.i, i.e., that BSpline.eval_all accepts buffers and
+# that BSpline.eval_all_into and BSpline.sample_into write into the memory of
+# the given buffers. Expects the directory containing the generated module
+# (tinyspline.py) in PYTHONPATH. Requires Python 3 (array.array does not
+# implement the buffer protocol in Python 2).
+import array
+import unittest
+
+from tinyspline import *
+
+def make_spline():
+	spline = BSpline(7)
+	spline.control_points = [
+		-1.75, -1.0, -1.5, -0.5, -1.5, 0.0, -1.25, 0.5,
+		-0.75, 0.75, 0.0, 0.5, 0.5, 0.0
+	]
+	return spline
+
+# Returns `value' rounded to the precision of tinyspline::real.
+def make_real(value):
+	spline = BSpline(1, 1, 0)
+	spline.control_points = [value]
+	return spline.control_points[0]
+
+class BufferTest(unittest.TestCase):
+
+	def setUp(self):
+		self.spline = make_spline()
+		# 'f' if the binding has been compiled with
+		# TINYSPLINE_FLOAT_PRECISION.
+		self.typecode = 'd' if make_real(0.1) == 0.1 else 'f'
+		self.us = [0.0, 0.1, 0.25, 0.5, 0.75, 0.9, 1.0]
+
+	def assertPointsEqual(self, expected, actual):
+		self.assertEqual(len(expected), len(actual))
+		for e, a in zip(expected, actual):
+			self.assertAlmostEqual(e, a, places=5)
+
+	def test_eval_all_accepts_buffer(self):
+		expected = self.spline.eval_all(self.us)
+		us = array.array(self.typecode, self.us)
+		self.assertPointsEqual(expected, self.spline.eval_all(us))
+
+	def test_eval_all_into(self):
+		expected = self.spline.eval_all(self.us)
+		us = array.array(self.typecode, self.us)
+		points = array.array(self.typecode, [0.0] * len(expected))
+		self.spline.eval_all_into(us, points)
+		self.assertPointsEqual(expected, points)
+
+	def test_eval_all_into_memoryview(self):
+		expected = self.spline.eval_all(self.us)
+		us = array.array(self.typecode, self.us)
+		points = array.array(self.typecode, [0.0] * len(expected))
+		self.spline.eval_all_into(memoryview(us), memoryview(points))
+		self.assertPointsEqual(expected, points)
+
+	def test_eval_all_into_capacity_too_small(self):
+		us = array.array(self.typecode, self.us)
+		points = array.array(self.typecode, [0.0])
+		self.assertRaises(RuntimeError,
+			self.spline.eval_all_into, us, points)
+
+	def test_sample_into(self):
+		expected = self.spline.sample(100)
+		points = array.array(self.typecode, [0.0] * len(expected))
+		num = self.spline.sample_into(points, 100)
+		self.assertEqual(100, num)
+		self.assertPointsEqual(expected, points)
+
+	def test_sample_into_default_num(self):
+		expected = self.spline.sample()
+		points = array.array(self.typecode, [0.0] * len(expected))
+		num = self.spline.sample_into(points)
+		self.assertEqual(len(expected) // self.spline.dimension, num)
+		self.assertPointsEqual(expected, points)
+
+	def test_rejects_buffer_of_wrong_type(self):
+		us = array.array('i', [0, 1])
+		points = array.array('i', [0] * 4)
+		self.assertRaises(TypeError,
+			self.spline.eval_all_into, us, points)
+		points = array.array('b', [0] * 1000)
+		self.assertRaises(TypeError, self.spline.sample_into, points)
+
+	def test_rejects_read_only_buffer(self):
+		if not hasattr(memoryview, 'toreadonly'):
+			self.skipTest('requires Python 3.8 or later')
+		points = array.array(self.typecode, [0.0] * 1000)
+		readonly = memoryview(points).toreadonly()
+		self.assertRaises(BufferError, self.spline.sample_into, readonly)
+
+if __name__ == '__main__':
+	unittest.main()
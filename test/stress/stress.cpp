@@ -0,0 +1,234 @@
+/*
+ * Concurrent stress test of TinySpline. A set of splines (and the objects
+ * derived from them) is shared by several threads, each of which repeatedly
+ * calls the const functions of the C interface and compares the results with
+ * those computed serially in advance. Since the results do not depend on the
+ * calling thread, they must be bitwise identical. Build with
+ * -fsanitize=thread (see tinyspline_stress_tsan) to detect data races.
+ *
+ * Usage:
+ *
+ *     tinyspline_stress [num_threads [num_rounds]]
+ */
+#include "tinyspline.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+const size_t NUM_CTRLP = 64;
+const size_t DIM = 3;
+const size_t DEG = 3;
+const size_t NUM_KNOTS = 257;
+const size_t NUM_DERIVS = 2;
+
+/* The objects shared by all threads and the reference results. */
+struct Shared {
+	tsBSpline spline;
+	tsBSpline splines[2]; /* `spline' and its tensioned version. */
+	tsSamplingPlan plan;
+	tsSplinePool pool;
+	tsProjector projector;
+	tsArcLength table;
+	tsCompiledSpline compiled_spline;
+	std::vector<tsReal> us;
+	std::vector<tsReal> points;  /* ts_bspline_eval_all_into */
+	std::vector<tsReal> derivs;  /* ts_bspline_eval_derivs_all */
+	std::vector<tsReal> planned; /* ts_sampling_plan_eval */
+	std::vector<tsReal> pooled;  /* ts_spline_pool_eval (per knot) */
+	std::vector<tsReal> closest; /* ts_projector_project */
+	std::vector<tsReal> lengths; /* ts_arc_length_u_at */
+	std::vector<tsReal> derived; /* ts_bspline_derive */
+	std::vector<tsReal> compiled; /* ts_compiled_spline_eval_all */
+};
+
+std::atomic<size_t> failures(0);
+
+void check(tsError err, const tsStatus &status)
+{
+	if (err) {
+		std::fprintf(stderr, "error %d: %s\n", (int) err,
+			status.message);
+		std::exit(EXIT_FAILURE);
+	}
+}
+
+void expect(bool condition, const char *what)
+{
+	if (!condition && failures++ == 0)
+		std::fprintf(stderr, "mismatch: %s\n", what);
+}
+
+bool equal(const std::vector<tsReal> &a, const std::vector<tsReal> &b)
+{
+	return a.size() == b.size() && (a.empty() ||
+		std::memcmp(&a[0], &b[0], a.size() * sizeof(tsReal)) == 0);
+}
+
+void derive(const tsBSpline *spline, std::vector<tsReal> &ctrlp,
+	tsStatus &status)
+{
+	tsBSpline deriv = ts_bspline_init();
+	check(ts_bspline_derive(spline, 1, TS_CONTROL_POINT_EPSILON, &deriv,
+		&status), status);
+	const tsReal *values = ts_bspline_control_points_ptr(&deriv);
+	ctrlp.assign(values, values + ts_bspline_len_control_points(&deriv));
+	ts_bspline_free(&deriv);
+}
+
+/* Computes all results of `s' with `status' and stores them in `out'. */
+void compute(const Shared &s, Shared &out, tsStatus &status)
+{
+	const size_t n = s.us.size();
+	const size_t num_splines = ts_spline_pool_num_splines(&s.pool);
+	size_t i;
+
+	out.points.resize(n * DIM);
+	check(ts_bspline_eval_all_into(&s.spline, &s.us[0], n,
+		&out.points[0], out.points.size(), &status), status);
+	out.derivs.resize(n * (NUM_DERIVS + 1) * DIM);
+	check(ts_bspline_eval_derivs_all(&s.spline, &s.us[0], n, NUM_DERIVS,
+		&out.derivs[0], &status), status);
+	out.planned.resize(n * DIM);
+	check(ts_sampling_plan_eval(&s.plan, &s.splines[1],
+		&out.planned[0], out.planned.size(), &status), status);
+	out.pooled.resize(n * num_splines * DIM);
+	for (i = 0; i < n; i++) {
+		check(ts_spline_pool_eval(&s.pool, s.us[i],
+			&out.pooled[i * num_splines * DIM],
+			num_splines * DIM, &status), status);
+	}
+	out.closest.resize(n * (DIM + 1));
+	for (i = 0; i < n; i++) {
+		/* Project points next to the spline. */
+		tsReal query[DIM];
+		size_t j;
+		for (j = 0; j < DIM; j++)
+			query[j] = s.points[i * DIM + j] + (tsReal) 0.25;
+		check(ts_projector_project(&s.projector, query,
+			&out.closest[i * (DIM + 1)],
+			&out.closest[i * (DIM + 1) + 1], &status), status);
+	}
+	out.lengths.resize(n);
+	for (i = 0; i < n; i++) {
+		check(ts_arc_length_u_at(&s.table,
+			(tsReal) i / (tsReal) (n - 1) *
+			ts_arc_length_length(&s.table),
+			&out.lengths[i], &status), status);
+	}
+	derive(&s.spline, out.derived, status);
+	out.compiled.resize(n * DIM);
+	check(ts_compiled_spline_eval_all(&s.compiled_spline, &s.us[0], n,
+		&out.compiled[0], out.compiled.size(), &status), status);
+}
+
+void worker(const Shared *shared, size_t num_rounds)
+{
+	Shared actual;
+	tsDeBoorNet net = ts_deboornet_init();
+	tsStatus status;
+	tsReal min, max;
+	size_t round;
+
+	ts_bspline_domain(&shared->spline, &min, &max);
+	for (round = 0; round < num_rounds; round++) {
+		compute(*shared, actual, status);
+		expect(equal(actual.points, shared->points), "eval_all");
+		expect(equal(actual.derivs, shared->derivs), "eval_derivs");
+		expect(equal(actual.planned, shared->planned), "plan");
+		expect(equal(actual.pooled, shared->pooled), "pool");
+		expect(equal(actual.closest, shared->closest), "project");
+		expect(equal(actual.lengths, shared->lengths), "arc_length");
+		expect(equal(actual.derived, shared->derived), "derive");
+		expect(equal(actual.compiled, shared->compiled), "compiled");
+		/* Errors are reported with thread-local tsStatus objects. */
+		expect(ts_bspline_eval(&shared->spline, max + 1, &net,
+			&status) == TS_U_UNDEFINED, "error code");
+		expect(status.code == TS_U_UNDEFINED, "status code");
+#ifndef TINYSPLINE_NO_MESSAGES
+		expect(std::strstr(status.message, "max(domain)") != NULL,
+			"status message");
+#endif
+	}
+	ts_deboornet_free(&net);
+}
+}
+
+int main(int argc, char **argv)
+{
+	size_t num_threads = argc > 1 ? (size_t) std::atoi(argv[1]) : 8;
+	size_t num_rounds = argc > 2 ? (size_t) std::atoi(argv[2]) : 20;
+	Shared shared;
+	tsStatus status;
+	tsReal min, max, *ctrlp;
+	size_t i;
+
+	shared.spline = ts_bspline_init();
+	shared.splines[0] = ts_bspline_init();
+	shared.splines[1] = ts_bspline_init();
+	shared.plan = ts_sampling_plan_init();
+	shared.pool = ts_spline_pool_init();
+	shared.projector = ts_projector_init();
+	shared.table = ts_arc_length_init();
+	shared.compiled_spline = ts_compiled_spline_init();
+
+	check(ts_bspline_new(NUM_CTRLP, DIM, DEG, TS_CLAMPED, &shared.spline,
+		&status), status);
+	check(ts_bspline_control_points(&shared.spline, &ctrlp, &status),
+		status);
+	for (i = 0; i < NUM_CTRLP * DIM; i++)
+		ctrlp[i] = (tsReal) ((i * 7919) % 2001) / (tsReal) 100.0;
+	check(ts_bspline_set_control_points(&shared.spline, ctrlp, &status),
+		status);
+	ts_free(ctrlp);
+	check(ts_bspline_copy(&shared.spline, &shared.splines[0], &status),
+		status);
+	check(ts_bspline_tension(&shared.spline, (tsReal) 0.5,
+		&shared.splines[1], &status), status);
+
+	ts_bspline_domain(&shared.spline, &min, &max);
+	for (i = 0; i < NUM_KNOTS; i++) {
+		shared.us.push_back(min + (max - min) *
+			(tsReal) i / (tsReal) (NUM_KNOTS - 1));
+	}
+	check(ts_sampling_plan_new(&shared.spline, &shared.us[0], NUM_KNOTS,
+		&shared.plan, &status), status);
+	check(ts_spline_pool_new(shared.splines, 2, &shared.pool, &status),
+		status);
+	check(ts_projector_new(&shared.spline, &shared.projector, &status),
+		status);
+	check(ts_arc_length_new(&shared.spline, 512, &shared.table, &status),
+		status);
+	check(ts_compiled_spline_new(&shared.spline, &shared.compiled_spline,
+		&status), status);
+
+	/* Reference results. */
+	compute(shared, shared, status);
+
+	std::vector<std::thread> threads;
+	for (i = 0; i < num_threads; i++)
+		threads.push_back(std::thread(worker, &shared, num_rounds));
+	for (i = 0; i < threads.size(); i++)
+		threads[i].join();
+
+	ts_bspline_free(&shared.spline);
+	ts_bspline_free(&shared.splines[0]);
+	ts_bspline_free(&shared.splines[1]);
+	ts_sampling_plan_free(&shared.plan);
+	ts_spline_pool_free(&shared.pool);
+	ts_projector_free(&shared.projector);
+	ts_arc_length_free(&shared.table);
+	ts_compiled_spline_free(&shared.compiled_spline);
+
+	if (failures > 0) {
+		std::fprintf(stderr, "%lu mismatches\n",
+			(unsigned long) failures.load());
+		return EXIT_FAILURE;
+	}
+	std::printf("OK (%lu threads, %lu rounds)\n",
+		(unsigned long) num_threads, (unsigned long) num_rounds);
+	return EXIT_SUCCESS;
+}